@@ -0,0 +1,26 @@
+@REM @file
+@REM This script will exec LzmaCompress tool with --chunked option that splits
+@REM the data into chunks that are compressed independently, on all processors.
+@REM
+@REM Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+@REM SPDX-License-Identifier: BSD-2-Clause-Patent
+@REM
+
+@echo off
+@setlocal
+
+:Begin
+if "%1"=="" goto End
+if "%1"=="-e" (
+  set FLAG=--chunked --threads %NUMBER_OF_PROCESSORS%
+)
+if "%1"=="-d" (
+  set FLAG=--chunked --threads %NUMBER_OF_PROCESSORS%
+)
+set ARGS=%ARGS% %1
+shift
+goto Begin
+
+:End
+LzmaCompress %ARGS% %FLAG%
+@echo on
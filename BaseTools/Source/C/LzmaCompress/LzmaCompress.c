@@ -22,11 +22,23 @@
 #include "Sdk/C/LzmaDec.h"
 #include "Sdk/C/LzmaEnc.h"
 #include "Sdk/C/Bra.h"
+#include "Sdk/C/Threads.h"
 #include "CommonLib.h"
 #include "ParseInf.h"
 
 #define LZMA_HEADER_SIZE (LZMA_PROPS_SIZE + 8)
 
+//
+// Chunked format, see LZMA_CHUNKED_HEADER in MdeModulePkg/Include/Guid/LzmaDecompress.h.
+// The data starts with a 16 byte header (Signature "LZMC", ChunkCount, ChunkSize,
+// UncompressedSize), followed by an (Offset, Size) pair for each chunk and
+// the chunks. Each chunk is compressed independently with the LZMA header above.
+//
+#define LZMA_CHUNKED_HEADER_SIZE  16
+#define LZMA_CHUNK_ENTRY_SIZE     8
+#define LZMA_DEFAULT_CHUNK_SIZE   0x100000
+#define LZMA_MAX_ENCODE_THREADS   64
+
 typedef enum {
   NoConverter,
   X86Converter,
@@ -44,6 +56,9 @@ static CONVERTER_TYPE mConType = NoConverter;
 
 UINT64 mDictionarySize = 28;
 UINT64 mCompressionMode = 2;
+UINT64 mNumThreads = 1;
+static BoolInt mChunked = False;
+UINT64 mChunkSize = LZMA_DEFAULT_CHUNK_SIZE;
 
 #define UTILITY_NAME "LzmaCompress"
 #define UTILITY_MAJOR_VERSION 0
@@ -65,6 +80,10 @@ void PrintHelp(char *buffer)
              "  --debug [0-9]: set debug level\n"
              "  -a: set compression mode 0 = fast, 1 = normal, default: 1 (normal)\n"
              "  d: sets Dictionary size - [0, 27], default: 24 (16MB)\n"
+             "  --threads N: use the multithreaded match finder if N > 1, default: 1\n"
+             "               with --chunked, compress N chunks at the same time\n"
+             "  --chunked: split the data into chunks that are compressed independently\n"
+             "  --chunk-size N: set the uncompressed size of a chunk, default: 1048576\n"
              "  --version: display the program version and exit\n"
              "  -h, --help: display this help text\n"
              );
@@ -94,6 +113,247 @@ void PrintVersion(char *buffer)
   sprintf (buffer, "%s Version %d.%d %s ", UTILITY_NAME, UTILITY_MAJOR_VERSION, UTILITY_MINOR_VERSION, __BUILD_VERSION);
 }
 
+static void WriteUInt32(Byte *buffer, UInt32 value)
+{
+  int i;
+  for (i = 0; i < 4; i++)
+    buffer[i] = (Byte)(value >> (8 * i));
+}
+
+static UInt32 ReadUInt32(const Byte *buffer)
+{
+  return (UInt32)buffer[0] | ((UInt32)buffer[1] << 8) | ((UInt32)buffer[2] << 16) | ((UInt32)buffer[3] << 24);
+}
+
+typedef struct {
+  const Byte *inBuffer;
+  size_t inSize;
+  size_t chunkSize;
+  UInt32 numChunks;
+  const CLzmaEncProps *props;
+  Byte **chunks;
+  size_t *chunkSizes;
+  UInt32 nextChunk;
+  SRes res;
+  CCriticalSection cs;
+} CChunkedEncoder;
+
+static SRes EncodeChunk(CChunkedEncoder *p, UInt32 index)
+{
+  const Byte *src = p->inBuffer + (size_t)index * p->chunkSize;
+  size_t srcSize = p->inSize - (size_t)index * p->chunkSize;
+  size_t outSize;
+  size_t outSizeProcessed;
+  size_t outPropsSize = LZMA_PROPS_SIZE;
+  Byte *outBuffer;
+  SRes res;
+  int i;
+
+  if (srcSize > p->chunkSize)
+    srcSize = p->chunkSize;
+
+  outSize = LZMA_HEADER_SIZE + srcSize / 20 * 21 + (1 << 16);
+  outBuffer = (Byte *)MyAlloc(outSize);
+  if (outBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  for (i = 0; i < 8; i++)
+    outBuffer[i + LZMA_PROPS_SIZE] = (Byte)((UInt64)srcSize >> (8 * i));
+
+  outSizeProcessed = outSize - LZMA_HEADER_SIZE;
+  res = LzmaEncode(outBuffer + LZMA_HEADER_SIZE, &outSizeProcessed,
+      src, srcSize, p->props, outBuffer, &outPropsSize, 0,
+      NULL, &g_Alloc, &g_Alloc);
+  if (res != SZ_OK) {
+    MyFree(outBuffer);
+    return res;
+  }
+
+  p->chunks[index] = outBuffer;
+  p->chunkSizes[index] = LZMA_HEADER_SIZE + outSizeProcessed;
+  return SZ_OK;
+}
+
+static THREAD_FUNC_DECL EncodeChunkThread(void *param)
+{
+  CChunkedEncoder *p = (CChunkedEncoder *)param;
+  UInt32 index;
+  SRes res;
+
+  for (;;) {
+    CriticalSection_Enter(&p->cs);
+    index = p->nextChunk;
+    if (p->res == SZ_OK && index < p->numChunks)
+      p->nextChunk++;
+    else
+      index = p->numChunks;
+    CriticalSection_Leave(&p->cs);
+
+    if (index == p->numChunks)
+      break;
+
+    res = EncodeChunk(p, index);
+    if (res != SZ_OK) {
+      CriticalSection_Enter(&p->cs);
+      p->res = res;
+      CriticalSection_Leave(&p->cs);
+    }
+  }
+  return 0;
+}
+
+static SRes EncodeChunked(ISeqOutStream *outStream, const Byte *inBuffer, size_t inSize, const CLzmaEncProps *props)
+{
+  CChunkedEncoder p;
+  CLzmaEncProps chunkProps;
+  CThread threads[LZMA_MAX_ENCODE_THREADS];
+  UInt32 numThreads;
+  UInt32 i;
+  UInt64 offset;
+  size_t tableSize;
+  Byte *table = 0;
+  SRes res;
+
+  if (inSize > 0xFFFFFFFF)
+    return SZ_ERROR_PARAM;
+
+  memset(&p, 0, sizeof(p));
+  p.inBuffer = inBuffer;
+  p.inSize = inSize;
+  p.chunkSize = (size_t)mChunkSize;
+  p.numChunks = (UInt32)((inSize + p.chunkSize - 1) / p.chunkSize);
+  p.res = SZ_OK;
+
+  //
+  // The chunks are compressed on separate threads instead of running
+  // the match finder of each chunk on its own thread.
+  //
+  chunkProps = *props;
+  chunkProps.numThreads = 1;
+  p.props = &chunkProps;
+
+  p.chunks = (Byte **)MyAlloc(p.numChunks * sizeof(Byte *));
+  p.chunkSizes = (size_t *)MyAlloc(p.numChunks * sizeof(size_t));
+  tableSize = LZMA_CHUNKED_HEADER_SIZE + (size_t)p.numChunks * LZMA_CHUNK_ENTRY_SIZE;
+  table = (Byte *)MyAlloc(tableSize);
+  if (p.chunks == 0 || p.chunkSizes == 0 || table == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+  memset(p.chunks, 0, p.numChunks * sizeof(Byte *));
+
+  numThreads = (UInt32)mNumThreads;
+  if (mNumThreads > LZMA_MAX_ENCODE_THREADS)
+    numThreads = LZMA_MAX_ENCODE_THREADS;
+  if (numThreads > p.numChunks)
+    numThreads = p.numChunks;
+
+  if (CriticalSection_Init(&p.cs) != 0) {
+    res = SZ_ERROR_THREAD;
+    goto Done;
+  }
+
+  //
+  // This thread compresses chunks too
+  //
+  for (i = 1; i < numThreads; i++) {
+    Thread_Construct(&threads[i]);
+    if (Thread_Create(&threads[i], EncodeChunkThread, &p) != 0)
+      break;
+  }
+  numThreads = i;
+  EncodeChunkThread(&p);
+  for (i = 1; i < numThreads; i++) {
+    Thread_Wait(&threads[i]);
+    Thread_Close(&threads[i]);
+  }
+  CriticalSection_Delete(&p.cs);
+
+  res = p.res;
+  if (res != SZ_OK)
+    goto Done;
+
+  WriteUInt32(table, ReadUInt32((const Byte *)"LZMC"));
+  WriteUInt32(table + 4, p.numChunks);
+  WriteUInt32(table + 8, (UInt32)p.chunkSize);
+  WriteUInt32(table + 12, (UInt32)inSize);
+  offset = tableSize;
+  for (i = 0; i < p.numChunks; i++) {
+    if (offset + p.chunkSizes[i] > 0xFFFFFFFF) {
+      res = SZ_ERROR_OUTPUT_EOF;
+      goto Done;
+    }
+    WriteUInt32(table + LZMA_CHUNKED_HEADER_SIZE + i * LZMA_CHUNK_ENTRY_SIZE, (UInt32)offset);
+    WriteUInt32(table + LZMA_CHUNKED_HEADER_SIZE + i * LZMA_CHUNK_ENTRY_SIZE + 4, (UInt32)p.chunkSizes[i]);
+    offset += p.chunkSizes[i];
+  }
+
+  if (outStream->Write(outStream, table, tableSize) != tableSize) {
+    res = SZ_ERROR_WRITE;
+    goto Done;
+  }
+  for (i = 0; i < p.numChunks; i++) {
+    if (outStream->Write(outStream, p.chunks[i], p.chunkSizes[i]) != p.chunkSizes[i]) {
+      res = SZ_ERROR_WRITE;
+      goto Done;
+    }
+  }
+
+Done:
+  if (p.chunks != 0) {
+    for (i = 0; i < p.numChunks; i++)
+      MyFree(p.chunks[i]);
+  }
+  MyFree(p.chunks);
+  MyFree(p.chunkSizes);
+  MyFree(table);
+
+  return res;
+}
+
+static SRes DecodeChunked(Byte *outBuffer, size_t outSize, const Byte *inBuffer, size_t inSize)
+{
+  UInt32 numChunks;
+  UInt32 chunkSize;
+  UInt32 i;
+  UInt32 offset;
+  UInt32 size;
+  size_t expected;
+  size_t outPos = 0;
+  size_t inSizePure;
+  size_t outSizeProcessed;
+  ELzmaStatus status;
+  SRes res;
+
+  numChunks = ReadUInt32(inBuffer + 4);
+  chunkSize = ReadUInt32(inBuffer + 8);
+  if (numChunks == 0 || chunkSize == 0 ||
+      (inSize - LZMA_CHUNKED_HEADER_SIZE) / LZMA_CHUNK_ENTRY_SIZE < numChunks)
+    return SZ_ERROR_DATA;
+
+  for (i = 0; i < numChunks; i++) {
+    offset = ReadUInt32(inBuffer + LZMA_CHUNKED_HEADER_SIZE + i * LZMA_CHUNK_ENTRY_SIZE);
+    size = ReadUInt32(inBuffer + LZMA_CHUNKED_HEADER_SIZE + i * LZMA_CHUNK_ENTRY_SIZE + 4);
+    expected = outSize - outPos;
+    if (expected > chunkSize)
+      expected = chunkSize;
+    if (expected == 0 || size < LZMA_HEADER_SIZE || offset > inSize || size > inSize - offset)
+      return SZ_ERROR_DATA;
+
+    outSizeProcessed = expected;
+    inSizePure = size - LZMA_HEADER_SIZE;
+    res = LzmaDecode(outBuffer + outPos, &outSizeProcessed, inBuffer + offset + LZMA_HEADER_SIZE, &inSizePure,
+        inBuffer + offset, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+    if (res != SZ_OK)
+      return res;
+    if (outSizeProcessed != expected)
+      return SZ_ERROR_DATA;
+    outPos += expected;
+  }
+
+  return (outPos == outSize) ? SZ_OK : SZ_ERROR_DATA;
+}
+
 static SRes Encode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize, CLzmaEncProps *props)
 {
   SRes res;
@@ -116,6 +376,11 @@ static SRes Encode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 file
     goto Done;
   }
 
+  if (mChunked) {
+    res = EncodeChunked(outStream, inBuffer, inSize, props);
+    goto Done;
+  }
+
   // we allocate 105% of original size + 64KB for output buffer
   outSize = (size_t)fileSize / 20 * 21 + (1 << 16);
   outBuffer = (Byte *)MyAlloc(outSize);
@@ -199,8 +464,16 @@ static SRes Decode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 file
     goto Done;
   }
 
-  for (i = 0; i < 8; i++)
-    outSize64 += ((UInt64)inBuffer[LZMA_PROPS_SIZE + i]) << (i * 8);
+  if (mChunked) {
+    if (inSize < LZMA_CHUNKED_HEADER_SIZE || memcmp(inBuffer, "LZMC", 4) != 0) {
+      res = SZ_ERROR_DATA;
+      goto Done;
+    }
+    outSize64 = ReadUInt32(inBuffer + 12);
+  } else {
+    for (i = 0; i < 8; i++)
+      outSize64 += ((UInt64)inBuffer[LZMA_PROPS_SIZE + i]) << (i * 8);
+  }
 
   outSize = (size_t)outSize64;
   if (outSize != 0) {
@@ -214,9 +487,13 @@ static SRes Decode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 file
     goto Done;
   }
 
-  inSizePure = inSize - LZMA_HEADER_SIZE;
-  res = LzmaDecode(outBuffer, &outSize, inBuffer + LZMA_HEADER_SIZE, &inSizePure,
-      inBuffer, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+  if (mChunked) {
+    res = DecodeChunked(outBuffer, outSize, inBuffer, inSize);
+  } else {
+    inSizePure = inSize - LZMA_HEADER_SIZE;
+    res = LzmaDecode(outBuffer, &outSize, inBuffer + LZMA_HEADER_SIZE, &inSizePure,
+        inBuffer, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+  }
 
   if (res != SZ_OK)
     goto Done;
@@ -253,6 +530,10 @@ int main2(int numArgs, const char *args[], char *rs)
 
   LzmaEncProps_Init(&props);
   LzmaEncProps_Normalize(&props);
+  //
+  // Encode on a single thread unless --threads is given
+  //
+  props.numThreads = 1;
 
   FileSeqInStream_CreateVTable(&inStream);
   File_Construct(&inStream.file);
@@ -309,6 +590,31 @@ int main2(int numArgs, const char *args[], char *rs)
       } else {
         return PrintError(rs, kInvalidParamValMessage);
       }
+    } else if (strcmp(args[param], "--threads") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      AsciiStringToUint64(args[param + 1],FALSE,&mNumThreads);
+      if (mNumThreads == 0) {
+        return PrintError(rs, kInvalidParamValMessage);
+      }
+      //
+      // The LZMA encoder runs the match finder on at most one extra thread.
+      // The output does not depend on the number of threads.
+      //
+      props.numThreads = (mNumThreads > 1) ? 2 : 1;
+      param++;
+    } else if (strcmp(args[param], "--chunked") == 0) {
+      mChunked = True;
+    } else if (strcmp(args[param], "--chunk-size") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      AsciiStringToUint64(args[param + 1],FALSE,&mChunkSize);
+      if ((mChunkSize == 0) || (mChunkSize > 0x80000000)) {
+        return PrintError(rs, kInvalidParamValMessage);
+      }
+      param++;
     } else if (
                 strcmp(args[param], "-h") == 0 ||
                 strcmp(args[param], "--help") == 0
@@ -342,6 +648,13 @@ int main2(int numArgs, const char *args[], char *rs)
     return PrintUserError(rs);
   }
 
+  if (mChunked && (mConType != NoConverter)) {
+    //
+    // The chunked decompressor does not undo the x86 converter
+    //
+    return PrintUserError(rs);
+  }
+
   {
     size_t t4 = sizeof(UInt32);
     size_t t8 = sizeof(UInt64);
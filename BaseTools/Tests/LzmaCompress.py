@@ -0,0 +1,143 @@
+## @file
+# Unit tests for LzmaCompress utility
+#
+#  Copyright (c) 2008, Intel Corporation. All rights reserved.<BR>
+#
+#  SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import print_function
+import os
+import sys
+import time
+import unittest
+
+import TestTools
+
+class Tests(TestTools.BaseToolsTest):
+
+    def setUp(self):
+        TestTools.BaseToolsTest.setUp(self)
+        self.toolName = 'LzmaCompress'
+
+    def testHelp(self):
+        result = self.RunTool('--help', logFile='help')
+        #self.DisplayFile('help')
+        self.assertTrue(result == 0)
+
+    def compress(self, input, output, threads):
+        result = self.RunTool(
+            '-e', '-q',
+            '--threads', str(threads),
+            '-o', self.GetTmpFilePath(output),
+            self.GetTmpFilePath(input)
+            )
+        self.assertTrue(result == 0)
+
+    def compressionTestCycle(self, data, threads):
+        self.WriteTmpFile('input', data)
+        self.compress('input', 'output1', threads)
+        result = self.RunTool(
+            '-d', '-q',
+            '-o', self.GetTmpFilePath('output2'),
+            self.GetTmpFilePath('output1')
+            )
+        self.assertTrue(result == 0)
+        start = self.ReadTmpFile('input')
+        finish = self.ReadTmpFile('output2')
+        startEqualsFinish = start == finish
+        if not startEqualsFinish:
+            print()
+            print('Original data did not match decompress(compress(data))')
+            self.DisplayBinaryData('original data', start)
+            self.DisplayBinaryData('after compression', self.ReadTmpFile('output1'))
+            self.DisplayBinaryData('after decompression', finish)
+        self.assertTrue(startEqualsFinish)
+
+    def testRandomDataCycles(self):
+        for threads in (1, 2):
+            for i in range(8):
+                data = self.GetRandomString(1024, 2048)
+                self.compressionTestCycle(data, threads)
+                self.CleanUpTmpDir()
+
+    def testThreadsProduceSameOutput(self):
+        #
+        # The multithreaded match finder must not change the encoded stream,
+        # so images stay reproducible whatever --threads is set to.
+        #
+        data = self.GetRandomString(1 << 16, 1 << 17) * 4
+        self.WriteTmpFile('input', data)
+        self.compress('input', 'output1', 1)
+        self.compress('input', 'output2', 2)
+        with open(self.GetTmpFilePath('output1'), 'rb') as f:
+            output1 = f.read()
+        with open(self.GetTmpFilePath('output2'), 'rb') as f:
+            output2 = f.read()
+        self.assertTrue(output1 == output2)
+
+    def testChunkedCycles(self):
+        #
+        # Use small chunks so the data spans several of them, and check the
+        # output does not depend on how many chunks are compressed at once.
+        #
+        data = self.GetRandomString(1 << 14, 1 << 15) * 4
+        self.WriteTmpFile('input', data)
+        for threads in (1, 4):
+            result = self.RunTool(
+                '-e', '-q', '--chunked', '--chunk-size', '20000',
+                '--threads', str(threads),
+                '-o', self.GetTmpFilePath('output%d' % threads),
+                self.GetTmpFilePath('input')
+                )
+            self.assertTrue(result == 0)
+        with open(self.GetTmpFilePath('output1'), 'rb') as f:
+            output1 = f.read()
+        with open(self.GetTmpFilePath('output4'), 'rb') as f:
+            output4 = f.read()
+        self.assertTrue(output1 == output4)
+        self.assertTrue(output1[:4] == b'LZMC')
+        result = self.RunTool(
+            '-d', '-q', '--chunked',
+            '-o', self.GetTmpFilePath('output2'),
+            self.GetTmpFilePath('output1')
+            )
+        self.assertTrue(result == 0)
+        self.assertTrue(self.ReadTmpFile('input') == self.ReadTmpFile('output2'))
+
+TheTestSuite = TestTools.MakeTheTestSuite(locals())
+
+##
+# Compare encoding time and compression ratio with and without --threads on
+# the files given on the command line, for example FV images from a build.
+#
+def Benchmark(files):
+    tool = Tests('testHelp')
+    tool.setUp()
+    for path in files:
+        size = os.path.getsize(path)
+        for threads in (1, 2):
+            output = tool.GetTmpFilePath('output')
+            start = time.time()
+            result = tool.RunTool('-e', '-q', '--threads', str(threads), '-o', output, path)
+            elapsed = time.time() - start
+            if result != 0:
+                print('%s: LzmaCompress failed' % path)
+                break
+            print(
+                '%s: --threads %d: %.2f s, %.1f MB/s, ratio %.1f%%' % (
+                path, threads, elapsed, size / elapsed / 1000000,
+                100.0 * os.path.getsize(output) / size)
+                )
+    tool.tearDown()
+
+if __name__ == '__main__':
+    if len(sys.argv) > 1:
+        Benchmark(sys.argv[1:])
+    else:
+        allTests = TheTestSuite()
+        unittest.TextTestRunner().run(allTests)
+
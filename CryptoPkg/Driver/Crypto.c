@@ -4290,6 +4290,29 @@ CryptoServiceTlsGetSessionId (
   return CALL_BASECRYPTLIB (TlsGet.Services.SessionId, TlsGetSessionId, (Tls, SessionId, SessionIdLen), EFI_UNSUPPORTED);
 }
 
+/**
+  Checks whether the specified TLS connection resumed a previous session.
+
+  This function returns whether the last handshake on the specified TLS
+  connection was an abbreviated handshake, in which the server accepted the
+  session offered for resumption.
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE     The TLS connection resumed a previous session.
+  @retval  FALSE    The TLS connection did a full handshake or no handshake
+                    yet, or Tls is invalid.
+
+**/
+BOOLEAN
+EFIAPI
+CryptoServiceTlsSessionReused (
+  IN     VOID                     *Tls
+  )
+{
+  return CALL_BASECRYPTLIB (TlsGet.Services.SessionReused, TlsSessionReused, (Tls), FALSE);
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -4663,5 +4686,10 @@ const EDKII_CRYPTO_PROTOCOL mEdkiiCrypto = {
   CryptoServiceTlsGetCaCertificate,
   CryptoServiceTlsGetHostPublicCert,
   CryptoServiceTlsGetHostPrivateKey,
-  CryptoServiceTlsGetCertRevocationList
+  CryptoServiceTlsGetCertRevocationList,
+  /// RSA PSS, not provided by this driver
+  NULL,
+  NULL,
+  /// TLS Get (continued)
+  CryptoServiceTlsSessionReused
 };
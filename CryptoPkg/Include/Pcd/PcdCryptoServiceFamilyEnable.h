@@ -285,6 +285,7 @@ typedef struct {
       UINT8  HostPublicCert:1;
       UINT8  HostPrivateKey:1;
       UINT8  CertRevocationList:1;
+      UINT8  SessionReused:1;
     } Services;
     UINT32    Family;
   } TlsGet;
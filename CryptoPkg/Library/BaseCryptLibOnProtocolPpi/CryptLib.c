@@ -3397,6 +3397,29 @@ TlsGetSessionId (
   CALL_CRYPTO_SERVICE (TlsGetSessionId, (Tls, SessionId, SessionIdLen), EFI_UNSUPPORTED);
 }
 
+/**
+  Checks whether the specified TLS connection resumed a previous session.
+
+  This function returns whether the last handshake on the specified TLS
+  connection was an abbreviated handshake, in which the server accepted the
+  session offered for resumption.
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE     The TLS connection resumed a previous session.
+  @retval  FALSE    The TLS connection did a full handshake or no handshake
+                    yet, or Tls is invalid.
+
+**/
+BOOLEAN
+EFIAPI
+TlsSessionReused (
+  IN     VOID                     *Tls
+  )
+{
+  CALL_CRYPTO_SERVICE (TlsSessionReused, (Tls), FALSE);
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -37,5 +37,26 @@ typedef struct {
   BIO                             *OutBio;
 } TLS_CONNECTION;
 
+//
+// Maximum number of client sessions a TLS context keeps for resumption.
+//
+#define TLS_SESSION_CACHE_SIZE            16
+
+//
+// Client session cache attached to a SSL_CTX object, see TlsSetSessionId().
+//
+typedef struct {
+  SSL_SESSION                     *Sessions[TLS_SESSION_CACHE_SIZE];
+  //
+  // Index of the entry to be replaced by the next new session.
+  //
+  UINTN                           Next;
+} TLS_SESSION_CACHE;
+
+//
+// The SSL_CTX ex_data index of the TLS_SESSION_CACHE.
+//
+extern INT32                      mTlsSessionCacheIndex;
+
 #endif
 
@@ -553,11 +553,64 @@ TlsSetVerifyHost (
   return (ParamStatus == 1) ? EFI_SUCCESS : EFI_ABORTED;
 }
 
+/**
+  Look up a client session by ID in the session cache of the TLS context.
+
+  @param[in]  Ctx             Pointer to the SSL_CTX object.
+  @param[in]  SessionId       Session ID data to look up.
+  @param[in]  SessionIdLen    Length of Session ID in bytes.
+
+  @return  The cached session, which is still owned by the cache, if it's
+           found and still resumable, NULL otherwise.
+
+**/
+STATIC
+SSL_SESSION *
+TlsLookupSession (
+  IN     SSL_CTX                  *Ctx,
+  IN     UINT8                    *SessionId,
+  IN     UINT16                   SessionIdLen
+  )
+{
+  TLS_SESSION_CACHE         *Cache;
+  SSL_SESSION               *Session;
+  CONST UINT8               *CachedId;
+  UINT32                    CachedIdLen;
+  UINTN                     Index;
+
+  if (mTlsSessionCacheIndex < 0) {
+    return NULL;
+  }
+
+  Cache = SSL_CTX_get_ex_data (Ctx, mTlsSessionCacheIndex);
+  if (Cache == NULL) {
+    return NULL;
+  }
+
+  for (Index = 0; Index < TLS_SESSION_CACHE_SIZE; Index++) {
+    Session = Cache->Sessions[Index];
+    if (Session == NULL || SSL_SESSION_is_resumable (Session) != 1) {
+      continue;
+    }
+
+    CachedId = SSL_SESSION_get_id (Session, &CachedIdLen);
+    if (CachedIdLen == SessionIdLen &&
+        CompareMem (CachedId, SessionId, SessionIdLen) == 0 &&
+        time (NULL) - SSL_SESSION_get_time (Session) <= SSL_SESSION_get_timeout (Session)) {
+      return Session;
+    }
+  }
+
+  return NULL;
+}
+
 /**
   Sets a TLS/SSL session ID to be used during TLS/SSL connect.
 
   This function sets a session ID to be used when the TLS/SSL connection is
-  to be established.
+  to be established. If it is called before the handshake and the session
+  with this ID is still in the session cache of the TLS context, that session
+  is offered to the server for resumption.
 
   @param[in]  Tls             Pointer to the TLS object.
   @param[in]  SessionId       Session ID data used for session resumption.
@@ -566,6 +619,7 @@ TlsSetVerifyHost (
   @retval  EFI_SUCCESS           Session ID was set successfully.
   @retval  EFI_INVALID_PARAMETER The parameter is invalid.
   @retval  EFI_UNSUPPORTED       No available session for ID setting.
+  @retval  EFI_ABORTED           The cached session could not be offered.
 
 **/
 EFI_STATUS
@@ -586,6 +640,16 @@ TlsSetSessionId (
     return EFI_INVALID_PARAMETER;
   }
 
+  //
+  // Before the handshake, resume the cached session with this ID if any.
+  //
+  if (SSL_in_before (TlsConn->Ssl)) {
+    Session = TlsLookupSession (SSL_get_SSL_CTX (TlsConn->Ssl), SessionId, SessionIdLen);
+    if (Session != NULL) {
+      return (SSL_set_session (TlsConn->Ssl, Session) == 1) ? EFI_SUCCESS : EFI_ABORTED;
+    }
+  }
+
   Session = SSL_get_session (TlsConn->Ssl);
   if (Session == NULL) {
     return EFI_UNSUPPORTED;
@@ -1033,6 +1097,37 @@ TlsGetSessionId (
   return EFI_SUCCESS;
 }
 
+/**
+  Checks whether the specified TLS connection resumed a previous session.
+
+  This function returns whether the last handshake on the specified TLS
+  connection was an abbreviated handshake, in which the server accepted the
+  session offered for resumption.
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE     The TLS connection resumed a previous session.
+  @retval  FALSE    The TLS connection did a full handshake or no handshake
+                    yet, or Tls is invalid.
+
+**/
+BOOLEAN
+EFIAPI
+TlsSessionReused (
+  IN     VOID                     *Tls
+  )
+{
+  TLS_CONNECTION  *TlsConn;
+
+  TlsConn = (TLS_CONNECTION *) Tls;
+
+  if (TlsConn == NULL || TlsConn->Ssl == NULL) {
+    return FALSE;
+  }
+
+  return (BOOLEAN) (SSL_session_reused (TlsConn->Ssl) == 1);
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -9,6 +9,48 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "InternalTlsLib.h"
 
+INT32  mTlsSessionCacheIndex = -1;
+
+/**
+  Remember a new client session in the session cache of its TLS context.
+
+  OpenSSL calls this function when a client session is established, or a new
+  session ticket is received from the server.
+
+  @param[in]  Ssl        Pointer to the SSL object of the connection.
+  @param[in]  Session    Pointer to the new session, with a reference taken
+                         for this function.
+
+  @retval 1  The cache keeps the reference to Session.
+  @retval 0  The session isn't cached.
+
+**/
+STATIC
+int
+TlsNewSessionCallback (
+  IN     SSL                      *Ssl,
+  IN     SSL_SESSION              *Session
+  )
+{
+  TLS_SESSION_CACHE  *Cache;
+
+  Cache = SSL_CTX_get_ex_data (SSL_get_SSL_CTX (Ssl), mTlsSessionCacheIndex);
+  if (Cache == NULL) {
+    return 0;
+  }
+
+  //
+  // Replace the oldest session once the cache is full.
+  //
+  if (Cache->Sessions[Cache->Next] != NULL) {
+    SSL_SESSION_free (Cache->Sessions[Cache->Next]);
+  }
+  Cache->Sessions[Cache->Next] = Session;
+  Cache->Next = (Cache->Next + 1) % TLS_SESSION_CACHE_SIZE;
+
+  return 1;
+}
+
 /**
   Initializes the OpenSSL library.
 
@@ -58,13 +100,30 @@ TlsCtxFree (
   IN   VOID                  *TlsCtx
   )
 {
+  TLS_SESSION_CACHE  *Cache;
+  UINTN              Index;
+
   if (TlsCtx == NULL) {
     return;
   }
 
+  Cache = NULL;
+  if (mTlsSessionCacheIndex >= 0) {
+    Cache = SSL_CTX_get_ex_data ((SSL_CTX *) (TlsCtx), mTlsSessionCacheIndex);
+  }
+
   if (TlsCtx != NULL) {
     SSL_CTX_free ((SSL_CTX *) (TlsCtx));
   }
+
+  if (Cache != NULL) {
+    for (Index = 0; Index < TLS_SESSION_CACHE_SIZE; Index++) {
+      if (Cache->Sessions[Index] != NULL) {
+        SSL_SESSION_free (Cache->Sessions[Index]);
+      }
+    }
+    FreePool (Cache);
+  }
 }
 
 /**
@@ -85,8 +144,9 @@ TlsCtxNew (
   IN     UINT8                    MinorVer
   )
 {
-  SSL_CTX  *TlsCtx;
-  UINT16   ProtoVersion;
+  SSL_CTX            *TlsCtx;
+  UINT16             ProtoVersion;
+  TLS_SESSION_CACHE  *Cache;
 
   ProtoVersion = (MajorVer << 8) | MinorVer;
 
@@ -106,6 +166,24 @@ TlsCtxNew (
   //
   SSL_CTX_set_min_proto_version (TlsCtx, ProtoVersion);
 
+  //
+  // Keep the established client sessions in a cache attached to the context,
+  // so that a later connection can resume one by its session ID (see
+  // TlsSetSessionId). Resumption is optional, the context works without it.
+  //
+  if (mTlsSessionCacheIndex < 0) {
+    mTlsSessionCacheIndex = SSL_CTX_get_ex_new_index (0, NULL, NULL, NULL, NULL);
+  }
+
+  Cache = AllocateZeroPool (sizeof (TLS_SESSION_CACHE));
+  if (Cache != NULL && mTlsSessionCacheIndex >= 0 &&
+      SSL_CTX_set_ex_data (TlsCtx, mTlsSessionCacheIndex, Cache) == 1) {
+    SSL_CTX_set_session_cache_mode (TlsCtx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb (TlsCtx, TlsNewSessionCallback);
+  } else if (Cache != NULL) {
+    FreePool (Cache);
+  }
+
   return (VOID *) TlsCtx;
 }
 
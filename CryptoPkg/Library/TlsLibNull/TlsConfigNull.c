@@ -161,7 +161,9 @@ TlsSetVerifyHost (
   Sets a TLS/SSL session ID to be used during TLS/SSL connect.
 
   This function sets a session ID to be used when the TLS/SSL connection is
-  to be established.
+  to be established. If it is called before the handshake and the session
+  with this ID is still in the session cache of the TLS context, that session
+  is offered to the server for resumption.
 
   @param[in]  Tls             Pointer to the TLS object.
   @param[in]  SessionId       Session ID data used for session resumption.
@@ -170,6 +172,7 @@ TlsSetVerifyHost (
   @retval  EFI_SUCCESS           Session ID was set successfully.
   @retval  EFI_INVALID_PARAMETER The parameter is invalid.
   @retval  EFI_UNSUPPORTED       No available session for ID setting.
+  @retval  EFI_ABORTED           The cached session could not be offered.
 
 **/
 EFI_STATUS
@@ -443,6 +446,30 @@ TlsGetSessionId (
   return EFI_UNSUPPORTED;
 }
 
+/**
+  Checks whether the specified TLS connection resumed a previous session.
+
+  This function returns whether the last handshake on the specified TLS
+  connection was an abbreviated handshake, in which the server accepted the
+  session offered for resumption.
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE     The TLS connection resumed a previous session.
+  @retval  FALSE    The TLS connection did a full handshake or no handshake
+                    yet, or Tls is invalid.
+
+**/
+BOOLEAN
+EFIAPI
+TlsSessionReused (
+  IN     VOID                     *Tls
+  )
+{
+  ASSERT(FALSE);
+  return FALSE;
+}
+
 /**
   Gets the client random data used in the specified TLS connection.
 
@@ -21,7 +21,7 @@
 /// the EDK II Crypto Protocol is extended, this version define must be
 /// increased.
 ///
-#define EDKII_CRYPTO_VERSION 7
+#define EDKII_CRYPTO_VERSION 8
 
 ///
 /// EDK II Crypto Protocol forward declaration
@@ -3482,7 +3482,25 @@ BOOLEAN
   IN  UINT16       SaltLen
   );
 
+/**
+  Checks whether the specified TLS connection resumed a previous session.
+
+  This function returns whether the last handshake on the specified TLS
+  connection was an abbreviated handshake, in which the server accepted the
+  session offered for resumption.
+
+  @param[in]  Tls    Pointer to the TLS object.
+
+  @retval  TRUE     The TLS connection resumed a previous session.
+  @retval  FALSE    The TLS connection did a full handshake or no handshake
+                    yet, or Tls is invalid.
 
+**/
+typedef
+BOOLEAN
+(EFIAPI* EDKII_CRYPTO_TLS_SESSION_REUSED)(
+  IN     VOID                     *Tls
+  );
 
 ///
 /// EDK II Crypto Protocol
@@ -3671,6 +3689,8 @@ struct _EDKII_CRYPTO_PROTOCOL {
   /// RSA PSS
   EDKII_CRYPTO_RSA_PSS_SIGN                       RsaPssSign;
   EDKII_CRYPTO_RSA_PSS_VERIFY                     RsaPssVerify;
+  /// TLS Get (continued)
+  EDKII_CRYPTO_TLS_SESSION_REUSED                 TlsSessionReused;
 };
 
 extern GUID gEdkiiCryptoProtocolGuid;
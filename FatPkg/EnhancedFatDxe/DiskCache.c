@@ -152,6 +152,296 @@ FatExchangeCachePage (
   return EFI_SUCCESS;
 }
 
+/**
+
+  Write back the dirty pages in a range of cache groups. Dirty pages that
+  follow each other both in the cache and on the disk are written with one
+  disk access.
+
+  @param  Volume                - FAT file system volume.
+  @param  DataType              - Indicate the cache type.
+  @param  StartGroupNo          - The first cache group to write back.
+  @param  GroupCount            - The number of cache groups to write back.
+  @param  Task                    point to task instance.
+
+  @retval EFI_SUCCESS           - The dirty pages are written back.
+  @return Others                - An error occurred when writing the pages.
+
+**/
+STATIC
+EFI_STATUS
+FatWriteBackCachePages (
+  IN FAT_VOLUME         *Volume,
+  IN CACHE_DATA_TYPE    DataType,
+  IN UINTN              StartGroupNo,
+  IN UINTN              GroupCount,
+  IN FAT_TASK           *Task
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+  UINTN       GroupNo;
+  UINTN       EndGroupNo;
+  UINTN       RunCount;
+  UINTN       Index;
+  UINTN       WriteCount;
+  UINTN       WriteSize;
+  UINT64      EntryPos;
+  UINT8       PageAlignment;
+
+  DiskCache     = &Volume->DiskCache[DataType];
+  PageAlignment = DiskCache->PageAlignment;
+  EndGroupNo    = StartGroupNo + GroupCount;
+
+  for (GroupNo = StartGroupNo; GroupNo < EndGroupNo; GroupNo += RunCount) {
+    CacheTag = &DiskCache->CacheTag[GroupNo];
+    RunCount = 1;
+    if (CacheTag->RealSize == 0 || !CacheTag->Dirty) {
+      continue;
+    }
+
+    //
+    // Extend the run while the next page is dirty, and is the next page on
+    // the disk after a full page
+    //
+    while (GroupNo + RunCount < EndGroupNo &&
+           CacheTag[RunCount].RealSize > 0 &&
+           CacheTag[RunCount].Dirty &&
+           CacheTag[RunCount].PageNo == CacheTag[RunCount - 1].PageNo + 1 &&
+           CacheTag[RunCount - 1].RealSize == ((UINTN)1 << PageAlignment)) {
+      RunCount++;
+    }
+
+    EntryPos   = DiskCache->BaseAddress + LShiftU64 (CacheTag->PageNo, PageAlignment);
+    WriteSize  = ((RunCount - 1) << PageAlignment) + CacheTag[RunCount - 1].RealSize;
+    WriteCount = 1;
+    if (DataType == CacheFat) {
+      WriteCount = Volume->NumFats;
+    }
+
+    do {
+      //
+      // Only fat table writing will execute more than once
+      //
+      Status = FatDiskIo (
+                 Volume,
+                 WriteDisk,
+                 EntryPos,
+                 WriteSize,
+                 DiskCache->CacheBase + (GroupNo << PageAlignment),
+                 Task
+                 );
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      EntryPos += Volume->FatSize;
+    } while (--WriteCount > 0);
+
+    for (Index = 0; Index < RunCount; Index++) {
+      CacheTag[Index].Dirty = FALSE;
+    }
+
+    DiskCache->Statistics.PagesWritten  += RunCount;
+    DiskCache->Statistics.WriteRequests += 1;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Notification function of the read-ahead token, called when the read-ahead
+  of the data cache completes.
+
+  @param  Event                 - Event whose notification function is being invoked.
+  @param  Context               - The data cache.
+
+**/
+STATIC
+VOID
+EFIAPI
+FatOnReadAheadComplete (
+  IN  EFI_EVENT                Event,
+  IN  VOID                     *Context
+  )
+{
+  DISK_CACHE  *DiskCache;
+
+  DiskCache                   = (DISK_CACHE *) Context;
+  DiskCache->ReadAheadPending = FALSE;
+}
+
+/**
+
+  Wait for the outstanding read-ahead of the data cache to complete. If the
+  read-ahead failed, the pages it was loading are dropped from the cache.
+
+  @param  DiskCache             - The data cache.
+
+**/
+STATIC
+VOID
+FatWaitReadAhead (
+  IN DISK_CACHE         *DiskCache
+  )
+{
+  CACHE_TAG   *CacheTag;
+  UINTN       Index;
+
+  if (DiskCache->ReadAheadPageCount == 0) {
+    return;
+  }
+
+  while (DiskCache->ReadAheadPending) {
+    CpuPause ();
+  }
+
+  if (EFI_ERROR (DiskCache->ReadAheadToken.TransactionStatus)) {
+    CacheTag = &DiskCache->CacheTag[DiskCache->ReadAheadPageNo & DiskCache->GroupMask];
+    for (Index = 0; Index < DiskCache->ReadAheadPageCount; Index++) {
+      CacheTag[Index].RealSize = 0;
+    }
+  }
+
+  DiskCache->ReadAheadPageCount = 0;
+}
+
+/**
+
+  Read data cache pages ahead of a sequential read. The pages are read with
+  one disk access, through DiskIo2 when it is available so that the read
+  overlaps with the processing of the data already returned.
+
+  The read-ahead window starts at one page and doubles with every read-ahead
+  up to DiskCache->MaxReadAheadPages. It stops at the end of the cache
+  buffer, at the last whole page of the disk run of the file being read, at
+  the end of the volume and at the first page already cached. It is skipped
+  when a non-blocking write to the pages has not completed yet, as the disk
+  could still return the data the write replaces.
+
+  @param  Volume                - FAT file system volume.
+  @param  PageNo                - The first page to read ahead.
+
+**/
+STATIC
+VOID
+FatReadAheadDataCache (
+  IN FAT_VOLUME         *Volume,
+  IN UINTN              PageNo
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+  UINTN       GroupNo;
+  UINTN       PageCount;
+  UINTN       Index;
+  UINTN       ReadSize;
+  UINT64      EntryPos;
+  UINT8       *Buffer;
+  UINT8       PageAlignment;
+
+  DiskCache     = &Volume->DiskCache[CacheData];
+  PageAlignment = DiskCache->PageAlignment;
+  GroupNo       = PageNo & DiskCache->GroupMask;
+  CacheTag      = &DiskCache->CacheTag[GroupNo];
+  EntryPos      = DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment);
+  if (EntryPos >= DiskCache->LimitAddress || EntryPos >= DiskCache->ReadAheadLimit) {
+    return;
+  }
+
+  PageCount = DiskCache->ReadAheadPages * 2;
+  if (PageCount == 0) {
+    PageCount = 1;
+  }
+
+  if (PageCount > DiskCache->MaxReadAheadPages) {
+    PageCount = DiskCache->MaxReadAheadPages;
+  }
+
+  if (PageCount > DiskCache->GroupMask + 1 - GroupNo) {
+    PageCount = DiskCache->GroupMask + 1 - GroupNo;
+  }
+
+  //
+  // The pages after the run may belong to another file, and a page only
+  // partly read would be taken as a valid page of it
+  //
+  if (PageCount > RShiftU64 (DiskCache->ReadAheadLimit - EntryPos, PageAlignment)) {
+    PageCount = (UINTN) RShiftU64 (DiskCache->ReadAheadLimit - EntryPos, PageAlignment);
+  }
+
+  for (Index = 0; Index < PageCount; Index++) {
+    if (CacheTag[Index].RealSize > 0 && CacheTag[Index].PageNo == PageNo + Index) {
+      break;
+    }
+  }
+
+  PageCount = Index;
+  if (PageCount == 0) {
+    return;
+  }
+
+  ReadSize = PageCount << PageAlignment;
+  if (DiskCache->LimitAddress - EntryPos < ReadSize) {
+    ReadSize  = (UINTN) (DiskCache->LimitAddress - EntryPos);
+    PageCount = (ReadSize + ((UINTN)1 << PageAlignment) - 1) >> PageAlignment;
+  }
+
+  if (FatIsWritePending (Volume, EntryPos, ReadSize)) {
+    return;
+  }
+
+  //
+  // Make room for the pages
+  //
+  Status = FatWriteBackCachePages (Volume, CacheData, GroupNo, PageCount, NULL);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  for (Index = 0; Index < PageCount; Index++) {
+    CacheTag[Index].PageNo    = PageNo + Index;
+    CacheTag[Index].RealSize  = (UINTN)1 << PageAlignment;
+  }
+
+  CacheTag[PageCount - 1].RealSize = ReadSize - ((PageCount - 1) << PageAlignment);
+
+  DiskCache->ReadAheadPages             = PageCount;
+  DiskCache->ReadAheadPageNo            = PageNo;
+  DiskCache->ReadAheadPageCount         = PageCount;
+  DiskCache->Statistics.BytesPrefetched += ReadSize;
+  Buffer                                = DiskCache->CacheBase + (GroupNo << PageAlignment);
+
+  DiskCache->ReadAheadToken.TransactionStatus = EFI_SUCCESS;
+  if (DiskCache->ReadAheadToken.Event != NULL) {
+    DiskCache->ReadAheadPending = TRUE;
+    Status = Volume->DiskIo2->ReadDiskEx (
+                                Volume->DiskIo2,
+                                Volume->MediaId,
+                                EntryPos,
+                                &DiskCache->ReadAheadToken,
+                                ReadSize,
+                                Buffer
+                                );
+    if (EFI_ERROR (Status)) {
+      DiskCache->ReadAheadPending = FALSE;
+    }
+  } else {
+    Status = FatDiskIo (Volume, ReadDisk, EntryPos, ReadSize, Buffer, NULL);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DiskCache->ReadAheadToken.TransactionStatus = Status;
+  }
+
+  if (!DiskCache->ReadAheadPending) {
+    FatWaitReadAhead (DiskCache);
+  }
+}
+
 /**
 
   Get one cache page by specified PageNo.
@@ -176,20 +466,25 @@ FatGetCachePage (
 {
   EFI_STATUS  Status;
   UINTN       OldPageNo;
+  DISK_CACHE  *DiskCache;
 
+  DiskCache = &Volume->DiskCache[CacheDataType];
   OldPageNo = CacheTag->PageNo;
   if (CacheTag->RealSize > 0 && OldPageNo == PageNo) {
     //
     // Cache Hit occurred
     //
+    DiskCache->Statistics.Hits++;
     return EFI_SUCCESS;
   }
 
+  DiskCache->Statistics.Misses++;
+
   //
   // Write dirty cache page back to disk
   //
   if (CacheTag->RealSize > 0 && CacheTag->Dirty) {
-    Status = FatExchangeCachePage (Volume, CacheDataType, WriteDisk, CacheTag, NULL);
+    Status = FatWriteBackCachePages (Volume, CacheDataType, OldPageNo & DiskCache->GroupMask, 1, NULL);
     if (EFI_ERROR (Status)) {
       return Status;
     }
@@ -308,9 +603,11 @@ FatAccessCache (
   UINTN       PageNo;
   UINTN       AlignedPageCount;
   UINTN       OverRunPageNo;
+  UINTN       LastPageNo;
   DISK_CACHE  *DiskCache;
   UINT64      EntryPos;
   UINT8       PageAlignment;
+  BOOLEAN     Sequential;
 
   ASSERT (Volume->CacheBuffer != NULL);
 
@@ -322,6 +619,27 @@ FatAccessCache (
   PageNo        = (UINTN) RShiftU64 (EntryPos, PageAlignment);
   UnderRun      = ((UINTN) EntryPos) & (PageSize - 1);
 
+  //
+  // A read smaller than a page that starts where the previous access ended
+  // is part of a sequential read, which the data cache reads ahead of.
+  // Larger reads go to the disk directly and need no read-ahead
+  //
+  Sequential = FALSE;
+  LastPageNo = PageNo;
+  if (CacheDataType == CacheData) {
+    FatWaitReadAhead (DiskCache);
+    if (IoMode == ReadDisk && BufferSize > 0 && BufferSize < PageSize) {
+      Sequential = (BOOLEAN) (Offset == DiskCache->NextOffset);
+      if (!Sequential) {
+        DiskCache->ReadAheadPages = 0;
+      }
+
+      LastPageNo = (UINTN) RShiftU64 (EntryPos + BufferSize - 1, PageAlignment);
+    }
+
+    DiskCache->NextOffset = Offset + BufferSize;
+  }
+
   if (UnderRun > 0) {
     Length = PageSize - UnderRun;
     if (Length > BufferSize) {
@@ -374,6 +692,10 @@ FatAccessCache (
     Status = FatAccessUnalignedCachePage (Volume, CacheDataType, IoMode, OverRunPageNo, 0, OverRun, Buffer);
   }
 
+  if (Sequential && !EFI_ERROR (Status) && DiskCache->MaxReadAheadPages > 0) {
+    FatReadAheadDataCache (Volume, LastPageNo + 1);
+  }
+
   return Status;
 }
 
@@ -396,10 +718,9 @@ FatVolumeFlushCache (
 {
   EFI_STATUS      Status;
   CACHE_DATA_TYPE CacheDataType;
-  UINTN           GroupIndex;
-  UINTN           GroupMask;
   DISK_CACHE      *DiskCache;
-  CACHE_TAG       *CacheTag;
+
+  FatWaitReadAhead (&Volume->DiskCache[CacheData]);
 
   for (CacheDataType = (CACHE_DATA_TYPE) 0; CacheDataType < CacheMaxType; CacheDataType++) {
     DiskCache = &Volume->DiskCache[CacheDataType];
@@ -407,18 +728,12 @@ FatVolumeFlushCache (
       //
       // Data cache or fat cache is dirty, write the dirty data back
       //
-      GroupMask = DiskCache->GroupMask;
-      for (GroupIndex = 0; GroupIndex <= GroupMask; GroupIndex++) {
-        CacheTag = &DiskCache->CacheTag[GroupIndex];
-        if (CacheTag->RealSize > 0 && CacheTag->Dirty) {
-          //
-          // Write back all Dirty Data Cache Page to disk
-          //
-          Status = FatExchangeCachePage (Volume, CacheDataType, WriteDisk, CacheTag, Task);
-          if (EFI_ERROR (Status)) {
-            return Status;
-          }
-        }
+      //
+      // Write back all Dirty Data Cache Page to disk
+      //
+      Status = FatWriteBackCachePages (Volume, CacheDataType, 0, DiskCache->GroupMask + 1, Task);
+      if (EFI_ERROR (Status)) {
+        return Status;
       }
 
       DiskCache->Dirty = FALSE;
@@ -435,6 +750,9 @@ FatVolumeFlushCache (
 
   Initialize the disk cache according to Volume's FatType.
 
+  The number of data cache pages and the read-ahead limit come from
+  PcdFatDataCachePageCount and PcdFatReadAheadMaxPageCount.
+
   @param  Volume                - FAT file system volume.
 
   @retval EFI_SUCCESS           - The disk cache is successfully initialized.
@@ -446,11 +764,14 @@ FatInitializeDiskCache (
   IN FAT_VOLUME         *Volume
   )
 {
+  EFI_STATUS  Status;
   DISK_CACHE  *DiskCache;
   UINTN       FatCacheGroupCount;
+  UINTN       DataCacheGroupCount;
   UINTN       DataCacheSize;
   UINTN       FatCacheSize;
   UINT8       *CacheBuffer;
+  CACHE_TAG   *CacheTag;
 
   DiskCache = Volume->DiskCache;
   //
@@ -466,24 +787,99 @@ FatInitializeDiskCache (
     DiskCache[CacheData].PageAlignment = FAT_DATACACHE_PAGE_MAX_ALIGNMENT;
   }
 
-  DiskCache[CacheData].GroupMask     = FAT_DATACACHE_GROUP_COUNT - 1;
+  DataCacheGroupCount = PcdGet32 (PcdFatDataCachePageCount);
+  if (DataCacheGroupCount < FAT_DATACACHE_GROUP_MIN_COUNT) {
+    DataCacheGroupCount = FAT_DATACACHE_GROUP_MIN_COUNT;
+  }
+
+  DataCacheGroupCount = GetPowerOfTwo32 ((UINT32) DataCacheGroupCount);
+
+  DiskCache[CacheData].GroupMask     = DataCacheGroupCount - 1;
   DiskCache[CacheData].BaseAddress   = Volume->RootPos;
   DiskCache[CacheData].LimitAddress  = Volume->VolumeSize;
   DiskCache[CacheFat].GroupMask      = FatCacheGroupCount - 1;
   DiskCache[CacheFat].BaseAddress    = Volume->FatPos;
   DiskCache[CacheFat].LimitAddress   = Volume->FatPos + Volume->FatSize;
   FatCacheSize                        = FatCacheGroupCount << DiskCache[CacheFat].PageAlignment;
-  DataCacheSize                       = FAT_DATACACHE_GROUP_COUNT << DiskCache[CacheData].PageAlignment;
+  DataCacheSize                       = DataCacheGroupCount << DiskCache[CacheData].PageAlignment;
+
   //
-  // Allocate the Fat Cache buffer
+  // Read ahead into at most half of the data cache
   //
-  CacheBuffer = AllocateZeroPool (FatCacheSize + DataCacheSize);
+  DiskCache[CacheData].MaxReadAheadPages = MIN (PcdGet32 (PcdFatReadAheadMaxPageCount), DataCacheGroupCount / 2);
+  //
+  // Allocate the Fat Cache buffer, followed by the cache tags
+  //
+  CacheBuffer = AllocateZeroPool (
+                  FatCacheSize + DataCacheSize +
+                  (FatCacheGroupCount + DataCacheGroupCount) * sizeof (CACHE_TAG)
+                  );
   if (CacheBuffer == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
 
+  CacheTag                        = (CACHE_TAG *) (CacheBuffer + FatCacheSize + DataCacheSize);
   Volume->CacheBuffer             = CacheBuffer;
   DiskCache[CacheFat].CacheBase  = CacheBuffer;
+  DiskCache[CacheFat].CacheTag   = CacheTag;
   DiskCache[CacheData].CacheBase = CacheBuffer + FatCacheSize;
+  DiskCache[CacheData].CacheTag  = CacheTag + FatCacheGroupCount;
+
+  //
+  // Read-ahead is asynchronous when the device has DiskIo2
+  //
+  if (Volume->DiskIo2 != NULL && DiskCache[CacheData].MaxReadAheadPages > 0) {
+    Status = gBS->CreateEvent (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_NOTIFY,
+                    FatOnReadAheadComplete,
+                    &DiskCache[CacheData],
+                    &DiskCache[CacheData].ReadAheadToken.Event
+                    );
+    if (EFI_ERROR (Status)) {
+      DiskCache[CacheData].ReadAheadToken.Event = NULL;
+    }
+  }
+
   return EFI_SUCCESS;
 }
+
+/**
+
+  Wait for the outstanding read-ahead, report the cache counters and free
+  the disk cache.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatFreeDiskCache (
+  IN FAT_VOLUME         *Volume
+  )
+{
+  DISK_CACHE_STATISTICS *Statistics;
+
+  if (Volume->CacheBuffer == NULL) {
+    return;
+  }
+
+  FatWaitReadAhead (&Volume->DiskCache[CacheData]);
+  if (Volume->DiskCache[CacheData].ReadAheadToken.Event != NULL) {
+    gBS->CloseEvent (Volume->DiskCache[CacheData].ReadAheadToken.Event);
+  }
+
+  Statistics = &Volume->DiskCache[CacheData].Statistics;
+  DEBUG ((
+    DEBUG_INFO,
+    "FatFreeDiskCache: data cache %Ld hits, %Ld misses, %Ld bytes read ahead, "
+    "%Ld pages written in %Ld writes\n",
+    Statistics->Hits,
+    Statistics->Misses,
+    Statistics->BytesPrefetched,
+    Statistics->PagesWritten,
+    Statistics->WriteRequests
+    ));
+
+  FreePool (Volume->CacheBuffer);
+  Volume->CacheBuffer = NULL;
+}
@@ -80,10 +80,27 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define FAT_FATCACHE_PAGE_MAX_ALIGNMENT   15
 #define FAT_DATACACHE_PAGE_MIN_ALIGNMENT  13
 #define FAT_DATACACHE_PAGE_MAX_ALIGNMENT  16
-#define FAT_DATACACHE_GROUP_COUNT         64
+#define FAT_DATACACHE_GROUP_MIN_COUNT     2
 #define FAT_FATCACHE_GROUP_MIN_COUNT      1
 #define FAT_FATCACHE_GROUP_MAX_COUNT      16
 
+//
+// The free cluster bitmap is split in blocks covering this many clusters each,
+// which are only built from the FAT when first used
+//
+#define FAT_FREE_BITMAP_BLOCK_CLUSTERS    0x8000
+
+//
+// The free cluster bitmap blocks are built from the FAT read in chunks of this size
+//
+#define FAT_FREE_BITMAP_READ_SIZE         0x4000
+
+//
+// The extent map of an OFile holds at most this many runs of clusters; more
+// fragmented files fall back to walking the cluster chain
+//
+#define FAT_EXTENT_MAP_MAX_COUNT          0x1000
+
 //
 // Used in 8.3 generation algorithm
 //
@@ -149,6 +166,17 @@ typedef struct {
   BOOLEAN Dirty;
 } CACHE_TAG;
 
+//
+// Disk cache counters
+//
+typedef struct {
+  UINT64    Hits;               // Page lookups satisfied from the cache
+  UINT64    Misses;             // Page lookups that loaded the page from the disk
+  UINT64    BytesPrefetched;    // Bytes read ahead of sequential reads
+  UINT64    PagesWritten;       // Dirty pages written back
+  UINT64    WriteRequests;      // Disk writes issued to write back dirty pages
+} DISK_CACHE_STATISTICS;
+
 typedef struct {
   UINT64    BaseAddress;
   UINT64    LimitAddress;
@@ -156,7 +184,23 @@ typedef struct {
   BOOLEAN   Dirty;
   UINT8     PageAlignment;
   UINTN     GroupMask;
-  CACHE_TAG CacheTag[FAT_DATACACHE_GROUP_COUNT];
+  CACHE_TAG *CacheTag;
+  //
+  // Sequential read detection and read-ahead, used by the data cache only.
+  // At most one read-ahead is outstanding; its pages have valid cache tags
+  // but must not be accessed until ReadAheadPending is cleared.
+  // ReadAheadLimit is the end of the disk run of the file being read; the
+  // read-ahead does not go past it
+  //
+  UINT64                NextOffset;
+  UINT64                ReadAheadLimit;
+  UINTN                 ReadAheadPages;
+  UINTN                 MaxReadAheadPages;
+  EFI_DISK_IO2_TOKEN    ReadAheadToken;
+  UINTN                 ReadAheadPageNo;
+  UINTN                 ReadAheadPageCount;
+  volatile BOOLEAN      ReadAheadPending;
+  DISK_CACHE_STATISTICS Statistics;
 } DISK_CACHE;
 
 //
@@ -227,8 +271,18 @@ typedef struct {
   VOID                *Buffer;
   UINTN               BufferSize;
   LIST_ENTRY          Link;
+  LIST_ENTRY          WriteLink;              // Link to the in-flight writes of the volume
 } FAT_SUBTASK;
 
+//
+// FAT_EXTENT - A run of consecutive clusters of an opened file
+//
+typedef struct {
+  UINTN               FileIndex;  // Index of the first cluster of the run within the file
+  UINTN               Cluster;    // First cluster of the run on the volume
+  UINTN               Length;     // Number of clusters in the run
+} FAT_EXTENT;
+
 //
 // FAT_OFILE - Each opened file
 //
@@ -272,6 +326,18 @@ struct _FAT_OFILE {
   UINT64              PosDisk;  // on the disk
   UINTN               PosRem;   // remaining in this disk run
   //
+  // The extent map of the file's cluster chain, sorted by FileIndex.
+  // It is built by the first OFile SetPosition and kept up to date
+  // when the file grows or shrinks; if ExtentMapValid is FALSE the
+  // cluster chain is walked instead. ExtentMapDisabled is set when
+  // the chain does not fit in the map, until the file is shrunk
+  //
+  FAT_EXTENT          *Extents;
+  UINTN               ExtentCount;
+  UINTN               ExtentMax;
+  BOOLEAN             ExtentMapValid;
+  BOOLEAN             ExtentMapDisabled;
+  //
   // The opened parent, full path length and currently opened child files
   //
   FAT_OFILE           *Parent;
@@ -335,6 +401,9 @@ struct _FAT_VOLUME {
   FAT_INFO_SECTOR                 FatInfoSector;  // Free cluster info
   UINTN                           FreeInfoPos;    // Pos with the free cluster info
   BOOLEAN                         FreeInfoValid;  // If free cluster info is valid
+  UINT8                           **FreeBitmap;   // Free cluster bitmap blocks, NULL until loaded; one bit per cluster, set if free
+  UINTN                           FreeBitmapBlocks; // Number of blocks of the free cluster bitmap
+  UINTN                           FreeRunLimit;   // Upper bound of the longest run of free clusters
   //
   // Unpacked Fat BPB info
   //
@@ -370,6 +439,12 @@ struct _FAT_VOLUME {
   LIST_ENTRY                      DirCacheList;
   UINTN                           DirCacheCount;
 
+  //
+  // Non-blocking writes that are not completed yet, so that the data cache
+  // does not read ahead stale data from the disk
+  //
+  LIST_ENTRY                      WriteSubtasks;
+
   //
   // Disk Cache for this volume
   //
@@ -711,6 +786,19 @@ FatInitializeDiskCache (
   IN FAT_VOLUME              *Volume
   );
 
+/**
+
+  Wait for the outstanding read-ahead, report the cache counters and free
+  the disk cache.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatFreeDiskCache (
+  IN FAT_VOLUME              *Volume
+  );
+
 /**
 
   Read BufferSize bytes from the position of Offset into Buffer,
@@ -1134,6 +1222,26 @@ FatDiskIo (
   IN FAT_TASK           *Task
   );
 
+/**
+
+  Check whether a non-blocking write to a range of the disk has been issued
+  and has not completed yet.
+
+  @param  Volume                - FAT file system volume.
+  @param  Offset                - The starting byte offset of the range.
+  @param  BufferSize            - The size in bytes of the range.
+
+  @retval TRUE                  - A write to the range is in flight.
+  @retval FALSE                 - No write to the range is in flight.
+
+**/
+BOOLEAN
+FatIsWritePending (
+  IN FAT_VOLUME         *Volume,
+  IN UINT64             Offset,
+  IN UINTN              BufferSize
+  );
+
 /**
 
   Lock the volume.
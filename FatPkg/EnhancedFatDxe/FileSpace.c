@@ -10,6 +10,15 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Fat.h"
 
+//
+// Access to the bits of a block of the free cluster bitmap. Bit is the index of
+// the cluster within the block.
+//
+#define FAT_FREE_BITMAP_BLOCK_SIZE          (FAT_FREE_BITMAP_BLOCK_CLUSTERS / 8)
+#define FAT_FREE_BITMAP_TEST(Bitmap, Bit)   (((Bitmap)[(Bit) >> 3] & (1 << ((Bit) & 7))) != 0)
+#define FAT_FREE_BITMAP_SET(Bitmap, Bit)    ((Bitmap)[(Bit) >> 3] |= (UINT8) (1 << ((Bit) & 7)))
+#define FAT_FREE_BITMAP_CLEAR(Bitmap, Bit)  ((Bitmap)[(Bit) >> 3] &= (UINT8) ~(1 << ((Bit) & 7)))
+
 
 /**
 
@@ -160,10 +169,19 @@ FatSetFatEntry (
     if (Index < Volume->FatInfoSector.FreeInfo.NextCluster) {
       Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32) Index;
     }
+    if (Volume->FreeBitmap != NULL && Index <= Volume->MaxCluster + 1 &&
+        Volume->FreeBitmap[Index / FAT_FREE_BITMAP_BLOCK_CLUSTERS] != NULL) {
+      FAT_FREE_BITMAP_SET (Volume->FreeBitmap[Index / FAT_FREE_BITMAP_BLOCK_CLUSTERS], Index % FAT_FREE_BITMAP_BLOCK_CLUSTERS);
+    }
+    Volume->FreeRunLimit = MAX_UINTN;
   } else if (Value != FAT_CLUSTER_FREE && OriginalVal == FAT_CLUSTER_FREE) {
     if (Volume->FatInfoSector.FreeInfo.ClusterCount != 0) {
       Volume->FatInfoSector.FreeInfo.ClusterCount -= 1;
     }
+    if (Volume->FreeBitmap != NULL && Index <= Volume->MaxCluster + 1 &&
+        Volume->FreeBitmap[Index / FAT_FREE_BITMAP_BLOCK_CLUSTERS] != NULL) {
+      FAT_FREE_BITMAP_CLEAR (Volume->FreeBitmap[Index / FAT_FREE_BITMAP_BLOCK_CLUSTERS], Index % FAT_FREE_BITMAP_BLOCK_CLUSTERS);
+    }
   }
   //
   // Make sure the entry is in memory
@@ -256,11 +274,424 @@ FatFreeClusters (
   return EFI_SUCCESS;
 }
 
+/**
+
+  Build one block of the free cluster bitmap of the volume from the FAT.
+
+  The FAT is read in chunks of FAT_FREE_BITMAP_READ_SIZE bytes instead of one
+  entry at a time.
+
+  @param  Volume                - FAT file system volume.
+  @param  Block                 - The index of the block of the bitmap.
+  @param  Bitmap                - The FAT_FREE_BITMAP_BLOCK_SIZE bytes buffer that
+                                  receives the block.
+
+  @retval EFI_SUCCESS           - The block is built.
+  @retval EFI_OUT_OF_RESOURCES  - There is not enough memory to read the FAT.
+  @return other                 - An error occurred when reading the FAT.
+
+**/
+STATIC
+EFI_STATUS
+FatReadFreeBitmapBlock (
+  IN  FAT_VOLUME  *Volume,
+  IN  UINTN       Block,
+  OUT UINT8       *Bitmap
+  )
+{
+  VOID        *Buffer;
+  UINTN       EntrySize;
+  UINTN       EntryCount;
+  UINTN       First;
+  UINTN       End;
+  UINTN       Cluster;
+  UINTN       Index;
+  BOOLEAN     Free;
+  EFI_STATUS  Status;
+
+  ZeroMem (Bitmap, FAT_FREE_BITMAP_BLOCK_SIZE);
+  First = Block * FAT_FREE_BITMAP_BLOCK_CLUSTERS;
+  End   = MIN (First + FAT_FREE_BITMAP_BLOCK_CLUSTERS, Volume->MaxCluster + 2);
+
+  if (Volume->FatType == Fat12) {
+    //
+    // A FAT12 volume has at most 4084 clusters, and its entries straddle bytes.
+    //
+    for (Cluster = MAX (First, FAT_MIN_CLUSTER); Cluster < End; Cluster++) {
+      if (FatGetFatEntry (Volume, Cluster) == FAT_CLUSTER_FREE) {
+        FAT_FREE_BITMAP_SET (Bitmap, Cluster - First);
+      }
+    }
+
+    return Volume->DiskError ? EFI_DEVICE_ERROR : EFI_SUCCESS;
+  }
+
+  Buffer = AllocatePool (FAT_FREE_BITMAP_READ_SIZE);
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status    = EFI_SUCCESS;
+  EntrySize = (Volume->FatType == Fat16) ? sizeof (UINT16) : sizeof (UINT32);
+  for (Cluster = First; Cluster < End; Cluster += EntryCount) {
+    EntryCount = MIN (FAT_FREE_BITMAP_READ_SIZE / EntrySize, End - Cluster);
+    Status = FatDiskIo (
+               Volume,
+               ReadFat,
+               Volume->FatPos + Cluster * EntrySize,
+               EntryCount * EntrySize,
+               Buffer,
+               NULL
+               );
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    for (Index = 0; Index < EntryCount; Index++) {
+      if (Volume->FatType == Fat16) {
+        Free = (BOOLEAN) (((UINT16 *) Buffer)[Index] == FAT_CLUSTER_FREE);
+      } else {
+        Free = (BOOLEAN) ((((UINT32 *) Buffer)[Index] & FAT_CLUSTER_MASK_FAT32) == FAT_CLUSTER_FREE);
+      }
+
+      if (Free && Cluster + Index >= FAT_MIN_CLUSTER) {
+        FAT_FREE_BITMAP_SET (Bitmap, Cluster + Index - First);
+      }
+    }
+  }
+
+  FreePool (Buffer);
+
+  if (!EFI_ERROR (Status) && Volume->DiskError) {
+    Status = EFI_DEVICE_ERROR;
+  }
+
+  return Status;
+}
+
+/**
+
+  Get a block of the free cluster bitmap of the volume, building it from the
+  FAT if it is not loaded yet. The block is kept up to date by FatSetFatEntry ()
+  afterwards.
+
+  Blocks are only loaded when a search goes through them, so the memory used
+  by the bitmap follows the part of the volume the allocations touch rather
+  than the size of the volume.
+
+  @param  Volume                - FAT file system volume, whose FreeBitmap array
+                                  of blocks is allocated.
+  @param  Block                 - The index of the block of the bitmap.
+
+  @return The block of the bitmap, or NULL if it could not be built, because
+          of a lack of memory or a disk error.
+
+**/
+STATIC
+UINT8 *
+FatGetFreeBitmapBlock (
+  IN FAT_VOLUME   *Volume,
+  IN UINTN        Block
+  )
+{
+  UINT8  *Bitmap;
+
+  if (Volume->FreeBitmap[Block] == NULL) {
+    Bitmap = AllocatePool (FAT_FREE_BITMAP_BLOCK_SIZE);
+    if (Bitmap == NULL) {
+      return NULL;
+    }
+
+    if (EFI_ERROR (FatReadFreeBitmapBlock (Volume, Block, Bitmap))) {
+      FreePool (Bitmap);
+      return NULL;
+    }
+
+    Volume->FreeBitmap[Block] = Bitmap;
+  }
+
+  return Volume->FreeBitmap[Block];
+}
+
+/**
+
+  Find the first run of free clusters in a range of the volume that is at least
+  ClusterCount clusters long, and keep track of the longest run seen.
+
+  @param  Volume                - FAT file system volume.
+  @param  Start                 - The first cluster of the range.
+  @param  End                   - The cluster after the last one of the range.
+  @param  ClusterCount          - The number of clusters wanted.
+  @param  RunStart              - The first cluster of the run, or FAT_CLUSTER_FREE
+                                  if no run is long enough.
+  @param  BestStart             - The first cluster of the longest run seen so far.
+  @param  BestLength            - The length of the longest run seen so far.
+
+  @retval EFI_SUCCESS           - The range was searched.
+  @retval EFI_OUT_OF_RESOURCES  - A block of the free cluster bitmap could not be
+                                  built.
+
+**/
+STATIC
+EFI_STATUS
+FatFindFreeRun (
+  IN     FAT_VOLUME   *Volume,
+  IN     UINTN        Start,
+  IN     UINTN        End,
+  IN     UINTN        ClusterCount,
+  OUT    UINTN        *RunStart,
+  IN OUT UINTN        *BestStart,
+  IN OUT UINTN        *BestLength
+  )
+{
+  UINT8   *Bitmap;
+  UINTN   Cluster;
+  UINTN   Bit;
+  UINTN   Step;
+  UINTN   Run;
+  BOOLEAN Free;
+
+  Bitmap = NULL;
+  Run    = FAT_CLUSTER_FREE;
+  for (Cluster = Start; Cluster < End; Cluster += Step) {
+    Bit = Cluster % FAT_FREE_BITMAP_BLOCK_CLUSTERS;
+    if (Bitmap == NULL || Bit == 0) {
+      Bitmap = FatGetFreeBitmapBlock (Volume, Cluster / FAT_FREE_BITMAP_BLOCK_CLUSTERS);
+      if (Bitmap == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+    }
+
+    //
+    // Go through the bitmap a byte at a time when all its clusters agree
+    //
+    if ((Bit & 7) == 0 && Cluster + 8 <= End && (Bitmap[Bit >> 3] == 0 || Bitmap[Bit >> 3] == 0xFF)) {
+      Step = 8;
+      Free = (BOOLEAN) (Bitmap[Bit >> 3] == 0xFF);
+    } else {
+      Step = 1;
+      Free = FAT_FREE_BITMAP_TEST (Bitmap, Bit);
+    }
+
+    if (Free) {
+      if (Run == FAT_CLUSTER_FREE) {
+        Run = Cluster;
+      }
+
+      if (Cluster + Step - Run >= ClusterCount) {
+        *RunStart = Run;
+        return EFI_SUCCESS;
+      }
+    } else if (Run != FAT_CLUSTER_FREE) {
+      if (Cluster - Run > *BestLength) {
+        *BestStart  = Run;
+        *BestLength = Cluster - Run;
+      }
+
+      Run = FAT_CLUSTER_FREE;
+    }
+  }
+
+  if (Run != FAT_CLUSTER_FREE && End - Run > *BestLength) {
+    *BestStart  = Run;
+    *BestLength = End - Run;
+  }
+
+  *RunStart = FAT_CLUSTER_FREE;
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Allocate a free cluster using the free cluster bitmap.
+
+  See FatAllocateCluster () for how the cluster is chosen.
+
+  @param  Volume                - FAT file system volume.
+  @param  LastCluster           - The last cluster of the file being grown, or
+                                  FAT_CLUSTER_FREE if it has no cluster yet.
+  @param  ClusterCount          - The number of clusters the file still needs.
+  @param  Cluster               - The index of the free cluster, or
+                                  FAT_CLUSTER_LAST if the volume is full.
+
+  @retval EFI_SUCCESS           - Cluster is set.
+  @retval EFI_OUT_OF_RESOURCES  - The bitmap could not be used, because of a lack
+                                  of memory or a disk error. The caller falls
+                                  back to scanning the FAT.
+
+**/
+STATIC
+EFI_STATUS
+FatAllocateFromFreeBitmap (
+  IN  FAT_VOLUME  *Volume,
+  IN  UINTN       LastCluster,
+  IN  UINTN       ClusterCount,
+  OUT UINTN       *Cluster
+  )
+{
+  UINT8       *Bitmap;
+  UINTN       Hint;
+  UINTN       BestStart;
+  UINTN       BestLength;
+  EFI_STATUS  Status;
+
+  if (Volume->FreeBitmap == NULL) {
+    Volume->FreeBitmapBlocks = (Volume->MaxCluster + 2 + FAT_FREE_BITMAP_BLOCK_CLUSTERS - 1) / FAT_FREE_BITMAP_BLOCK_CLUSTERS;
+    Volume->FreeBitmap       = AllocateZeroPool (Volume->FreeBitmapBlocks * sizeof (UINT8 *));
+    if (Volume->FreeBitmap == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Volume->FreeRunLimit = MAX_UINTN;
+  }
+
+  *Cluster = LastCluster + 1;
+  Bitmap   = NULL;
+  if (LastCluster != FAT_CLUSTER_FREE && *Cluster <= Volume->MaxCluster + 1) {
+    Bitmap = FatGetFreeBitmapBlock (Volume, *Cluster / FAT_FREE_BITMAP_BLOCK_CLUSTERS);
+    if (Bitmap == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  if (Bitmap == NULL || !FAT_FREE_BITMAP_TEST (Bitmap, *Cluster % FAT_FREE_BITMAP_BLOCK_CLUSTERS)) {
+    Hint = Volume->FatInfoSector.FreeInfo.NextCluster;
+    if (Hint < FAT_MIN_CLUSTER || Hint > Volume->MaxCluster + 1) {
+      Hint = FAT_MIN_CLUSTER;
+    }
+
+    if (ClusterCount > Volume->FreeRunLimit) {
+      ClusterCount = 1;
+    }
+
+    BestStart  = FAT_CLUSTER_FREE;
+    BestLength = 0;
+    Status     = FatFindFreeRun (Volume, Hint, Volume->MaxCluster + 2, ClusterCount, Cluster, &BestStart, &BestLength);
+    if (!EFI_ERROR (Status) && *Cluster == FAT_CLUSTER_FREE) {
+      Status = FatFindFreeRun (Volume, FAT_MIN_CLUSTER, Hint, ClusterCount, Cluster, &BestStart, &BestLength);
+    }
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (*Cluster == FAT_CLUSTER_FREE) {
+      //
+      // Allocating clusters only shortens the runs, so no run can be longer
+      // than this one until some clusters are freed.
+      //
+      Volume->FreeRunLimit = BestLength;
+      *Cluster             = BestStart;
+    }
+
+    if (*Cluster == FAT_CLUSTER_FREE) {
+      *Cluster = (UINTN) FAT_CLUSTER_LAST;
+      return EFI_SUCCESS;
+    }
+  }
+
+  if (*Cluster >= Volume->FatInfoSector.FreeInfo.NextCluster) {
+    Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32) (*Cluster + 1);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Count the free clusters of the volume a block of the free cluster bitmap at a
+  time, and set the free cluster info of FatInfoSector from the count.
+
+  The blocks that are not loaded are built in a temporary buffer and dropped
+  once counted, so this does not load the whole bitmap.
+
+  @param  Volume                - FAT file system volume.
+
+  @retval TRUE                  - The free cluster info is set.
+  @retval FALSE                 - The FAT could not be read in blocks, because of
+                                  a lack of memory or a disk error.
+
+**/
+STATIC
+BOOLEAN
+FatCountFreeClusters (
+  IN FAT_VOLUME   *Volume
+  )
+{
+  UINT8   *Buffer;
+  UINT8   *Bitmap;
+  UINTN   Blocks;
+  UINTN   Block;
+  UINTN   Index;
+  UINTN   Bit;
+  UINTN   Count;
+  UINTN   First;
+  UINT8   Value;
+
+  Buffer = AllocatePool (FAT_FREE_BITMAP_BLOCK_SIZE);
+  if (Buffer == NULL) {
+    return FALSE;
+  }
+
+  Count  = 0;
+  First  = FAT_CLUSTER_FREE;
+  Blocks = (Volume->MaxCluster + 2 + FAT_FREE_BITMAP_BLOCK_CLUSTERS - 1) / FAT_FREE_BITMAP_BLOCK_CLUSTERS;
+  for (Block = 0; Block < Blocks; Block++) {
+    if (Volume->FreeBitmap != NULL && Volume->FreeBitmap[Block] != NULL) {
+      Bitmap = Volume->FreeBitmap[Block];
+    } else {
+      if (EFI_ERROR (FatReadFreeBitmapBlock (Volume, Block, Buffer))) {
+        FreePool (Buffer);
+        return FALSE;
+      }
+
+      Bitmap = Buffer;
+    }
+
+    for (Index = 0; Index < FAT_FREE_BITMAP_BLOCK_SIZE; Index++) {
+      if (Bitmap[Index] == 0) {
+        continue;
+      }
+
+      if (First == FAT_CLUSTER_FREE) {
+        for (Bit = 0; !FAT_FREE_BITMAP_TEST (Bitmap, Index * 8 + Bit); Bit++) {
+        }
+
+        First = Block * FAT_FREE_BITMAP_BLOCK_CLUSTERS + Index * 8 + Bit;
+      }
+
+      for (Value = Bitmap[Index]; Value != 0; Value &= Value - 1) {
+        Count++;
+      }
+    }
+  }
+
+  FreePool (Buffer);
+
+  Volume->FatInfoSector.FreeInfo.ClusterCount = (UINT32) Count;
+  if (First != FAT_CLUSTER_FREE) {
+    Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32) First;
+  }
+
+  return TRUE;
+}
+
 /**
 
   Allocate a free cluster and return the cluster index.
 
+  When the free cluster bitmap can be used, the cluster following LastCluster
+  is taken if it is free, so the file keeps growing contiguously. Otherwise a
+  new extent is started at the first run of free clusters, from the free
+  cluster hint on, that can hold the ClusterCount clusters still needed, or at
+  the longest run if none can. Once no run is known to be long enough, the
+  following extents start at the next free cluster, so filling up a fragmented
+  volume does not scan the whole bitmap for every extent.
+
   @param  Volume                - FAT file system volume.
+  @param  LastCluster           - The last cluster of the file being grown, or
+                                  FAT_CLUSTER_FREE if it has no cluster yet.
+  @param  ClusterCount          - The number of clusters the file still needs.
 
   @return The index of the free cluster
 
@@ -268,7 +699,9 @@ FatFreeClusters (
 STATIC
 UINTN
 FatAllocateCluster (
-  IN FAT_VOLUME   *Volume
+  IN FAT_VOLUME   *Volume,
+  IN UINTN        LastCluster,
+  IN UINTN        ClusterCount
   )
 {
   UINTN Cluster;
@@ -280,6 +713,10 @@ FatAllocateCluster (
     return (UINTN) FAT_CLUSTER_LAST;
   }
 
+  if (!EFI_ERROR (FatAllocateFromFreeBitmap (Volume, LastCluster, ClusterCount, &Cluster))) {
+    return Cluster;
+  }
+
   for (;;) {
     //
     // If the end of the list, return no available cluster
@@ -337,6 +774,215 @@ FatSizeToClusters (
   return Clusters;
 }
 
+/**
+
+  Discard the extent map of the open file, so that its cluster chain is
+  walked instead.
+
+  @param  OFile                 - The open file.
+
+**/
+STATIC
+VOID
+FatDiscardExtentMap (
+  IN FAT_OFILE            *OFile
+  )
+{
+  if (OFile->Extents != NULL) {
+    FreePool (OFile->Extents);
+    OFile->Extents = NULL;
+  }
+
+  OFile->ExtentCount    = 0;
+  OFile->ExtentMax      = 0;
+  OFile->ExtentMapValid = FALSE;
+}
+
+/**
+
+  Append a cluster to the end of the extent map of the open file. The cluster
+  extends the last extent if it follows it on the disk.
+
+  @param  OFile                 - The open file.
+  @param  Cluster               - The cluster appended to the file.
+
+  @retval TRUE                  - The cluster is added to the extent map.
+  @retval FALSE                 - The extent map is full or out of resources.
+
+**/
+STATIC
+BOOLEAN
+FatAppendExtent (
+  IN FAT_OFILE            *OFile,
+  IN UINTN                Cluster
+  )
+{
+  FAT_EXTENT  *Extent;
+  FAT_EXTENT  *NewExtents;
+  UINTN       NewMax;
+  UINTN       FileIndex;
+
+  FileIndex = 0;
+  if (OFile->ExtentCount != 0) {
+    Extent = &OFile->Extents[OFile->ExtentCount - 1];
+    if (Extent->Cluster + Extent->Length == Cluster) {
+      Extent->Length += 1;
+      return TRUE;
+    }
+
+    FileIndex = Extent->FileIndex + Extent->Length;
+  }
+
+  if (OFile->ExtentCount == OFile->ExtentMax) {
+    if (OFile->ExtentMax == FAT_EXTENT_MAP_MAX_COUNT) {
+      return FALSE;
+    }
+
+    NewMax = OFile->ExtentMax == 0 ? 8 : OFile->ExtentMax * 2;
+    if (NewMax > FAT_EXTENT_MAP_MAX_COUNT) {
+      NewMax = FAT_EXTENT_MAP_MAX_COUNT;
+    }
+
+    NewExtents = ReallocatePool (
+                   OFile->ExtentMax * sizeof (FAT_EXTENT),
+                   NewMax * sizeof (FAT_EXTENT),
+                   OFile->Extents
+                   );
+    if (NewExtents == NULL) {
+      return FALSE;
+    }
+
+    OFile->Extents   = NewExtents;
+    OFile->ExtentMax = NewMax;
+  }
+
+  Extent            = &OFile->Extents[OFile->ExtentCount];
+  Extent->FileIndex = FileIndex;
+  Extent->Cluster   = Cluster;
+  Extent->Length    = 1;
+  OFile->ExtentCount++;
+  return TRUE;
+}
+
+/**
+
+  Build the extent map of the open file by walking its cluster chain once.
+  The map is not built if the chain is corrupt, or too fragmented to fit in
+  FAT_EXTENT_MAP_MAX_COUNT extents.
+
+  @param  OFile                 - The open file.
+
+  @retval TRUE                  - The extent map is built.
+  @retval FALSE                 - The extent map can not be used.
+
+**/
+STATIC
+BOOLEAN
+FatBuildExtentMap (
+  IN FAT_OFILE            *OFile
+  )
+{
+  FAT_VOLUME  *Volume;
+  UINTN       Cluster;
+  UINTN       ClusterCount;
+
+  Volume = OFile->Volume;
+  FatDiscardExtentMap (OFile);
+
+  Cluster       = OFile->FileCluster;
+  ClusterCount  = 0;
+  while (!FAT_END_OF_FAT_CHAIN (Cluster)) {
+    //
+    // A chain longer than the volume has clusters must loop
+    //
+    if (Cluster < FAT_MIN_CLUSTER || Cluster > Volume->MaxCluster + 1 ||
+        ClusterCount > Volume->MaxCluster ||
+        !FatAppendExtent (OFile, Cluster)) {
+      FatDiscardExtentMap (OFile);
+      OFile->ExtentMapDisabled = TRUE;
+      return FALSE;
+    }
+
+    ClusterCount++;
+    Cluster = FatGetFatEntry (Volume, Cluster);
+  }
+
+  OFile->ExtentMapValid = TRUE;
+  return TRUE;
+}
+
+/**
+
+  Find the extent of the open file that holds the cluster with the given
+  index within the file.
+
+  @param  OFile                 - The open file.
+  @param  FileIndex             - The index of the cluster within the file.
+
+  @return The extent that holds the cluster, or NULL if the cluster is beyond
+          the end of the file's cluster chain.
+
+**/
+STATIC
+FAT_EXTENT *
+FatLookupExtent (
+  IN FAT_OFILE            *OFile,
+  IN UINTN                FileIndex
+  )
+{
+  FAT_EXTENT  *Extent;
+  UINTN       Low;
+  UINTN       High;
+  UINTN       Middle;
+
+  Low   = 0;
+  High  = OFile->ExtentCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    Extent = &OFile->Extents[Middle];
+    if (FileIndex < Extent->FileIndex) {
+      High = Middle;
+    } else if (FileIndex >= Extent->FileIndex + Extent->Length) {
+      Low = Middle + 1;
+    } else {
+      return Extent;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+
+  Trim the extent map of the open file to the given number of clusters.
+
+  @param  OFile                 - The open file.
+  @param  ClusterCount          - The number of clusters left in the file.
+
+**/
+STATIC
+VOID
+FatTruncateExtentMap (
+  IN FAT_OFILE            *OFile,
+  IN UINTN                ClusterCount
+  )
+{
+  FAT_EXTENT  *Extent;
+
+  while (OFile->ExtentCount != 0) {
+    Extent = &OFile->Extents[OFile->ExtentCount - 1];
+    if (Extent->FileIndex < ClusterCount) {
+      if (Extent->FileIndex + Extent->Length > ClusterCount) {
+        Extent->Length = ClusterCount - Extent->FileIndex;
+      }
+
+      break;
+    }
+
+    OFile->ExtentCount--;
+  }
+}
+
 /**
 
   Shrink the end of the open file base on the file size.
@@ -396,6 +1042,16 @@ FatShrinkEof (
     //
     OFile->FileCluster      = FAT_CLUSTER_FREE;
   }
+  //
+  // Trim the extent map, or let the next seek try to build it again now
+  // that the file may fit
+  //
+  if (OFile->ExtentMapValid) {
+    FatTruncateExtentMap (OFile, NewSize);
+  } else {
+    OFile->ExtentMapDisabled = FALSE;
+  }
+
   //
   // Set CurrentCluster == FileCluster
   // to force a recalculation of Position related stuffs
@@ -436,6 +1092,7 @@ FatGrowEof (
   UINTN       LastCluster;
   UINTN       NewCluster;
   UINTN       ClusterCount;
+  FAT_EXTENT  *Extent;
 
   //
   // For FAT file system, the max file is 4GB.
@@ -454,8 +1111,24 @@ FatGrowEof (
 
   if (CurSize < NewSize) {
     //
-    // If we haven't found the files last cluster do it now
+    // If we haven't found the files last cluster, take it from the
+    // extent map or run the cluster chain
     //
+    if ((OFile->FileCluster != 0) && (OFile->FileLastCluster == 0) &&
+        OFile->ExtentMapValid && (OFile->ExtentCount != 0)) {
+      Extent = &OFile->Extents[OFile->ExtentCount - 1];
+      if (Extent->FileIndex + Extent->Length != CurSize) {
+        DEBUG (
+          (EFI_D_INIT | EFI_D_ERROR,
+          "FatGrowEof: cluster chain size does not match file size\n")
+          );
+        Status = EFI_VOLUME_CORRUPTED;
+        goto Done;
+      }
+
+      OFile->FileLastCluster = Extent->Cluster + Extent->Length - 1;
+    }
+
     if ((OFile->FileCluster != 0) && (OFile->FileLastCluster == 0)) {
       Cluster       = OFile->FileCluster;
       ClusterCount  = 0;
@@ -492,7 +1165,7 @@ FatGrowEof (
     LastCluster = OFile->FileLastCluster;
 
     while (CurSize < NewSize) {
-      NewCluster = FatAllocateCluster (Volume);
+      NewCluster = FatAllocateCluster (Volume, LastCluster, NewSize - CurSize);
       if (FAT_END_OF_FAT_CHAIN (NewCluster)) {
         if (LastCluster != FAT_CLUSTER_FREE) {
           FatSetFatEntry (Volume, LastCluster, (UINTN) FAT_CLUSTER_LAST);
@@ -518,6 +1191,11 @@ FatGrowEof (
       LastCluster = NewCluster;
       CurSize += 1;
 
+      if (OFile->ExtentMapValid && !FatAppendExtent (OFile, NewCluster)) {
+        FatDiscardExtentMap (OFile);
+        OFile->ExtentMapDisabled = TRUE;
+      }
+
       //
       // Terminate the cluster list
       //
@@ -568,6 +1246,9 @@ FatOFilePosition (
   UINTN       Cluster;
   UINTN       StartPos;
   UINTN       Run;
+  UINT64      RunLength;
+  UINTN       Index;
+  FAT_EXTENT  *Extent;
 
   Volume      = OFile->Volume;
   ClusterSize = Volume->ClusterSize;
@@ -581,6 +1262,30 @@ FatOFilePosition (
   if (OFile->IsFixedRootDir) {
     OFile->PosDisk  = Volume->RootPos + Position;
     Run             = OFile->FileSize - Position;
+  } else if (OFile->ExtentMapValid ||
+             (!OFile->ExtentMapDisabled && FatBuildExtentMap (OFile))) {
+    //
+    // Look up the extent holding the position, and access up to its end
+    //
+    Index   = Position >> Volume->ClusterAlignment;
+    Extent  = FatLookupExtent (OFile, Index);
+    if (Extent == NULL) {
+      DEBUG ((EFI_D_INIT | EFI_D_ERROR, "FatOFilePosition:"" cluster chain corrupt\n"));
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    Cluster   = Extent->Cluster + (Index - Extent->FileIndex);
+    StartPos  = Index << Volume->ClusterAlignment;
+
+    OFile->PosDisk            = Volume->FirstClusterPos +
+                                LShiftU64 (Cluster - FAT_MIN_CLUSTER, Volume->ClusterAlignment) +
+                                Position - StartPos;
+    OFile->FileCurrentCluster = Cluster;
+    OFile->Position           = StartPos;
+
+    RunLength = LShiftU64 (Extent->FileIndex + Extent->Length - Index, Volume->ClusterAlignment) -
+                (Position - StartPos);
+    Run       = (UINTN) MIN (RunLength, MAX_UINTN);
   } else {
     //
     // Run the file's cluster chain to find the current position
@@ -726,14 +1431,16 @@ FatComputeFreeInfo (
 
     Volume->FreeInfoValid                        = TRUE;
     Volume->FatInfoSector.FreeInfo.ClusterCount  = 0;
-    for (Index = Volume->MaxCluster + 1; Index >= FAT_MIN_CLUSTER; Index--) {
-      if (Volume->DiskError) {
-        break;
-      }
+    if (!FatCountFreeClusters (Volume)) {
+      for (Index = Volume->MaxCluster + 1; Index >= FAT_MIN_CLUSTER; Index--) {
+        if (Volume->DiskError) {
+          break;
+        }
 
-      if (FatGetFatEntry (Volume, Index) == FAT_CLUSTER_FREE) {
-        Volume->FatInfoSector.FreeInfo.ClusterCount += 1;
-        Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32) Index;
+        if (FatGetFatEntry (Volume, Index) == FAT_CLUSTER_FREE) {
+          Volume->FatInfoSector.FreeInfo.ClusterCount += 1;
+          Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32) Index;
+        }
       }
     }
 
@@ -54,11 +54,13 @@ FatDestroyTask (
   LIST_ENTRY          *Link;
   FAT_SUBTASK         *Subtask;
 
+  EfiAcquireLock (&FatTaskLock);
   Link = GetFirstNode (&Task->Subtasks);
   while (!IsNull (&Task->Subtasks, Link)) {
     Subtask = CR (Link, FAT_SUBTASK, Link, FAT_SUBTASK_SIGNATURE);
     Link = FatDestroySubtask (Subtask);
   }
+  EfiReleaseLock (&FatTaskLock);
   FreePool (Task);
 }
 
@@ -85,7 +87,8 @@ FatWaitNonblockingTask (
 
 /**
 
-  Remove the subtask from subtask list.
+  Remove the subtask from subtask list, and a write subtask from the in-flight
+  writes of the volume. Called at the TPL of FatTaskLock.
 
   @param  Subtask               - The subtask to be removed.
 
@@ -101,6 +104,10 @@ FatDestroySubtask (
 
   gBS->CloseEvent (Subtask->DiskIo2Token.Event);
 
+  if (Subtask->Write) {
+    RemoveEntryList (&Subtask->WriteLink);
+  }
+
   Link = RemoveEntryList (&Subtask->Link);
   FreePool (Subtask);
 
@@ -367,6 +374,11 @@ FatDiskIo (
                           );
           if (!EFI_ERROR (Status)) {
             InsertTailList (&Task->Subtasks, &Subtask->Link);
+            if (Subtask->Write) {
+              EfiAcquireLock (&FatTaskLock);
+              InsertTailList (&Volume->WriteSubtasks, &Subtask->WriteLink);
+              EfiReleaseLock (&FatTaskLock);
+            }
           } else {
             FreePool (Subtask);
           }
@@ -383,6 +395,44 @@ FatDiskIo (
   return Status;
 }
 
+/**
+
+  Check whether a non-blocking write to a range of the disk has been issued
+  and has not completed yet.
+
+  @param  Volume                - FAT file system volume.
+  @param  Offset                - The starting byte offset of the range.
+  @param  BufferSize            - The size in bytes of the range.
+
+  @retval TRUE                  - A write to the range is in flight.
+  @retval FALSE                 - No write to the range is in flight.
+
+**/
+BOOLEAN
+FatIsWritePending (
+  IN FAT_VOLUME         *Volume,
+  IN UINT64             Offset,
+  IN UINTN              BufferSize
+  )
+{
+  LIST_ENTRY          *Link;
+  FAT_SUBTASK         *Subtask;
+  BOOLEAN             Pending;
+
+  Pending = FALSE;
+  EfiAcquireLock (&FatTaskLock);
+  for (Link = GetFirstNode (&Volume->WriteSubtasks); !IsNull (&Volume->WriteSubtasks, Link); Link = GetNextNode (&Volume->WriteSubtasks, Link)) {
+    Subtask = CR (Link, FAT_SUBTASK, WriteLink, FAT_SUBTASK_SIGNATURE);
+    if (Subtask->Offset < Offset + BufferSize && Offset < Subtask->Offset + Subtask->BufferSize) {
+      Pending = TRUE;
+      break;
+    }
+  }
+
+  EfiReleaseLock (&FatTaskLock);
+  return Pending;
+}
+
 /**
 
   Lock the volume.
@@ -458,11 +508,23 @@ FatFreeVolume (
   IN FAT_VOLUME       *Volume
   )
 {
+  UINTN Index;
+
   //
   // Free disk cache
   //
-  if (Volume->CacheBuffer != NULL) {
-    FreePool (Volume->CacheBuffer);
+  FatFreeDiskCache (Volume);
+  //
+  // Free the free cluster bitmap
+  //
+  if (Volume->FreeBitmap != NULL) {
+    for (Index = 0; Index < Volume->FreeBitmapBlocks; Index++) {
+      if (Volume->FreeBitmap[Index] != NULL) {
+        FreePool (Volume->FreeBitmap[Index]);
+      }
+    }
+
+    FreePool (Volume->FreeBitmap);
   }
   //
   // Free directory cache
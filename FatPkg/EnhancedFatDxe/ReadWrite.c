@@ -484,10 +484,19 @@ FatAccessOFile (
     //
     Len = BufferSize > OFile->PosRem ? OFile->PosRem : BufferSize;
 
+    //
+    // Let the data cache read ahead up to the end of the block run, but not
+    // past the end of the file
+    //
+    if (IoMode == ReadData) {
+      Volume->DiskCache[CacheData].ReadAheadLimit = OFile->PosDisk + MIN (OFile->PosRem, OFile->FileSize - Position);
+    }
+
     //
     // Write the data
     //
     Status = FatDiskIo (Volume, IoMode, OFile->PosDisk, Len, UserBuffer, Task);
+    Volume->DiskCache[CacheData].ReadAheadLimit = 0;
     if (EFI_ERROR (Status)) {
       break;
     }
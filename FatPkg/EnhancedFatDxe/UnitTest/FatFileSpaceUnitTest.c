@@ -0,0 +1,750 @@
+/** @file
+  Host-based unit tests of the FAT free cluster bitmap.
+
+  The file space routines run on a fragmented FAT32 volume whose FAT is kept in
+  host memory. The tests check that the free cluster info computed from the
+  bitmap matches the FAT, that files grown through the bitmap get few extents
+  and seek correctly, that the loaded bitmap blocks follow the FAT as clusters
+  are freed, that the allocator falls back to scanning the FAT when the bitmap
+  can not be built, and compare the cost of both allocators.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../Fat.h"
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME          "FAT File Space Unit Tests"
+#define UNIT_TEST_APP_VERSION       "1.0"
+
+#define FAT_TEST_CLUSTERS           1000000
+#define FAT_TEST_CLUSTER_SIZE       4096
+#define FAT_TEST_FREE_AREA          40000
+#define FAT_TEST_GROW_CLUSTERS      30000
+#define FAT_TEST_SHRINK_CLUSTERS    100
+#define FAT_TEST_SEEKS              500
+#define FAT_TEST_FULL_CLUSTERS      2000
+
+EFI_LOCK  FatFsLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_CALLBACK);
+
+STATIC FAT_VOLUME  mVolume;
+STATIC FAT_OFILE   mOFile;
+STATIC UINT32      *mFat;
+STATIC BOOLEAN     mFailBitmapReads;
+STATIC UINT32      mSeed;
+
+/**
+  Returns the next value of a deterministic pseudo random sequence, so that a
+  failing run can be reproduced.
+
+  @return A pseudo random 31-bit value.
+
+**/
+STATIC
+UINT32
+FatTestRandom (
+  VOID
+  )
+{
+  //
+  // xorshift32, the seed must not be zero.
+  //
+  mSeed ^= mSeed << 13;
+  mSeed ^= mSeed >> 17;
+  mSeed ^= mSeed << 5;
+  return mSeed & 0x7FFFFFFF;
+}
+
+/**
+  Reads or writes the FAT of the test volume, which is kept in host memory.
+
+  Reads of more than one FAT entry are only done to build the free cluster
+  bitmap, and fail while mFailBitmapReads is set.
+
+  @param  Volume                - FAT file system volume.
+  @param  IoMode                - The access mode, only ReadFat and WriteFat.
+  @param  Offset                - The starting byte offset in the FAT.
+  @param  BufferSize            - Size of Buffer.
+  @param  Buffer                - Buffer containing read data.
+  @param  Task                  - Unused.
+
+  @retval EFI_SUCCESS           - The operation is performed successfully.
+  @retval EFI_DEVICE_ERROR      - The read was made to fail.
+
+**/
+EFI_STATUS
+FatDiskIo (
+  IN FAT_VOLUME         *Volume,
+  IN IO_MODE            IoMode,
+  IN UINT64             Offset,
+  IN UINTN              BufferSize,
+  IN OUT VOID           *Buffer,
+  IN FAT_TASK           *Task
+  )
+{
+  ASSERT (Offset + BufferSize <= (Volume->MaxCluster + 2) * sizeof (UINT32));
+
+  if (IoMode == ReadFat) {
+    if (mFailBitmapReads && BufferSize > Volume->FatEntrySize) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    CopyMem (Buffer, (UINT8 *) mFat + Offset, BufferSize);
+  } else {
+    ASSERT (IoMode == WriteFat);
+    CopyMem ((UINT8 *) mFat + Offset, Buffer, BufferSize);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  The volume dirty flag is not tracked by the test volume.
+
+  @param  Volume                - FAT file system volume.
+  @param  IoMode                - The access mode.
+  @param  DirtyValue            - Set to Dirty or Clean.
+
+  @retval EFI_SUCCESS           - Always.
+
+**/
+EFI_STATUS
+FatAccessVolumeDirty (
+  IN FAT_VOLUME         *Volume,
+  IN IO_MODE            IoMode,
+  IN VOID               *DirtyValue
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Returns the entry of a cluster in the FAT of the test volume.
+
+  @param  Cluster               - The cluster.
+
+  @return The FAT entry.
+
+**/
+STATIC
+UINTN
+FatTestEntry (
+  IN UINTN  Cluster
+  )
+{
+  return mFat[Cluster] & FAT_CLUSTER_MASK_FAT32;
+}
+
+/**
+  Counts the free clusters in the FAT of the test volume.
+
+  @param  First                 - Returns the lowest free cluster.
+
+  @return The number of free clusters.
+
+**/
+STATIC
+UINTN
+FatTestCountFree (
+  OUT UINTN  *First
+  )
+{
+  UINTN  Cluster;
+  UINTN  Count;
+
+  Count  = 0;
+  *First = 0;
+  for (Cluster = FAT_MIN_CLUSTER; Cluster < mVolume.MaxCluster + 2; Cluster++) {
+    if (FatTestEntry (Cluster) == FAT_CLUSTER_FREE) {
+      if (Count == 0) {
+        *First = Cluster;
+      }
+
+      Count++;
+    }
+  }
+
+  return Count;
+}
+
+/**
+  Counts the extents of the cluster chain of the test file.
+
+  @param  Length                - Returns the number of clusters of the chain.
+
+  @return The number of runs of consecutive clusters in the chain.
+
+**/
+STATIC
+UINTN
+FatTestCountExtents (
+  OUT UINTN  *Length
+  )
+{
+  UINTN  Cluster;
+  UINTN  Next;
+  UINTN  Extents;
+
+  *Length = 0;
+  Extents = 0;
+  if (mOFile.FileCluster == 0) {
+    return 0;
+  }
+
+  Extents = 1;
+  for (Cluster = mOFile.FileCluster; ; Cluster = Next) {
+    *Length += 1;
+    Next     = FatTestEntry (Cluster);
+    if (Next >= FAT_CLUSTER_SPECIAL_FAT32) {
+      break;
+    }
+
+    if (Next != Cluster + 1) {
+      Extents++;
+    }
+  }
+
+  return Extents;
+}
+
+/**
+  Returns the number of blocks of the free cluster bitmap that are loaded.
+
+  @return The number of loaded blocks.
+
+**/
+STATIC
+UINTN
+FatTestLoadedBlocks (
+  VOID
+  )
+{
+  UINTN  Block;
+  UINTN  Loaded;
+
+  Loaded = 0;
+  if (mVolume.FreeBitmap != NULL) {
+    for (Block = 0; Block < mVolume.FreeBitmapBlocks; Block++) {
+      if (mVolume.FreeBitmap[Block] != NULL) {
+        Loaded++;
+      }
+    }
+  }
+
+  return Loaded;
+}
+
+/**
+  Checks that the loaded blocks of the free cluster bitmap match the FAT.
+
+  @return TRUE if every bit of the loaded blocks is set exactly when the
+          cluster is free.
+
+**/
+STATIC
+BOOLEAN
+FatTestBitmapMatchesFat (
+  VOID
+  )
+{
+  UINTN  Cluster;
+  UINTN  Bit;
+  UINT8  *Bitmap;
+
+  if (mVolume.FreeBitmap == NULL) {
+    return TRUE;
+  }
+
+  for (Cluster = FAT_MIN_CLUSTER; Cluster < mVolume.MaxCluster + 2; Cluster++) {
+    Bitmap = mVolume.FreeBitmap[Cluster / FAT_FREE_BITMAP_BLOCK_CLUSTERS];
+    if (Bitmap == NULL) {
+      continue;
+    }
+
+    Bit = Cluster % FAT_FREE_BITMAP_BLOCK_CLUSTERS;
+    if (((Bitmap[Bit >> 3] & (1 << (Bit & 7))) != 0) != (FatTestEntry (Cluster) == FAT_CLUSTER_FREE)) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Seeks the test file to random positions and checks the disk position and the
+  number of consecutive bytes returned by FatOFilePosition() against the
+  cluster chain.
+
+  @param  Clusters              - The number of clusters of the file.
+
+  @return TRUE if every position matches the cluster chain.
+
+**/
+STATIC
+BOOLEAN
+FatTestSeeks (
+  IN UINTN  Clusters
+  )
+{
+  UINTN  Seek;
+  UINTN  Position;
+  UINTN  Cluster;
+  UINTN  Index;
+  UINTN  Run;
+
+  for (Seek = 0; Seek < FAT_TEST_SEEKS; Seek++) {
+    Position = FatTestRandom () % (Clusters * FAT_TEST_CLUSTER_SIZE);
+    Cluster  = mOFile.FileCluster;
+    for (Index = 0; Index < Position / FAT_TEST_CLUSTER_SIZE; Index++) {
+      Cluster = FatTestEntry (Cluster);
+    }
+
+    Run = FAT_TEST_CLUSTER_SIZE - Position % FAT_TEST_CLUSTER_SIZE;
+    while (FatTestEntry (Cluster) == Cluster + 1) {
+      Run += FAT_TEST_CLUSTER_SIZE;
+      Cluster++;
+    }
+
+    if (EFI_ERROR (FatOFilePosition (&mOFile, Position, MAX_UINTN)) ||
+        (mOFile.PosRem != Run) ||
+        (mOFile.PosDisk + Run != (UINT64) (Cluster - FAT_MIN_CLUSTER + 1) * FAT_TEST_CLUSTER_SIZE))
+    {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Builds a fragmented FAT32 test volume: used runs of 1 to 8 clusters separated
+  by holes of up to 5 free clusters, with a single large free area at three
+  quarters of the volume. The test file is empty.
+
+  @param[in]  Context   Unused.
+
+  @retval  UNIT_TEST_PASSED                The volume was built.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  The FAT could not be allocated.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FatTestCreateVolume (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Cluster;
+  UINTN  Used;
+  UINTN  Hole;
+  UINTN  FreeArea;
+
+  ZeroMem (&mVolume, sizeof (mVolume));
+  mVolume.FatType          = Fat32;
+  mVolume.MaxCluster       = FAT_TEST_CLUSTERS;
+  mVolume.ClusterSize      = FAT_TEST_CLUSTER_SIZE;
+  mVolume.ClusterAlignment = 12;
+  mVolume.FatEntrySize     = sizeof (UINT32);
+
+  mFat = AllocateZeroPool ((FAT_TEST_CLUSTERS + 2) * sizeof (UINT32));
+  if (mFat == NULL) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  mFat[0]  = 0x0FFFFFF8;
+  mFat[1]  = 0x0FFFFFFF;
+  mSeed    = 0x6C078965;
+  FreeArea = FAT_TEST_CLUSTERS / 4 * 3;
+  for (Cluster = FAT_MIN_CLUSTER; Cluster < FAT_TEST_CLUSTERS + 2; ) {
+    if ((Cluster >= FreeArea) && (Cluster < FreeArea + FAT_TEST_FREE_AREA)) {
+      Cluster++;
+      continue;
+    }
+
+    Used = 1 + FatTestRandom () % 8;
+    Hole = FatTestRandom () % 6;
+    while (Used-- != 0 && Cluster < FAT_TEST_CLUSTERS + 2) {
+      mFat[Cluster++] = 0x0FFFFFFF;
+    }
+
+    Cluster += Hole;
+  }
+
+  mVolume.FatInfoSector.FreeInfo.NextCluster = FAT_MIN_CLUSTER;
+
+  ZeroMem (&mOFile, sizeof (mOFile));
+  mOFile.Volume         = &mVolume;
+  mOFile.ExtentMapValid = TRUE;
+  mFailBitmapReads      = FALSE;
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Frees the test volume and the test file.
+
+  @param[in]  Context   Unused.
+
+**/
+STATIC
+VOID
+EFIAPI
+FatTestFreeVolume (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Block;
+
+  if (mOFile.Extents != NULL) {
+    FreePool (mOFile.Extents);
+  }
+
+  if (mVolume.FreeBitmap != NULL) {
+    for (Block = 0; Block < mVolume.FreeBitmapBlocks; Block++) {
+      if (mVolume.FreeBitmap[Block] != NULL) {
+        FreePool (mVolume.FreeBitmap[Block]);
+      }
+    }
+
+    FreePool (mVolume.FreeBitmap);
+  }
+
+  FreePool (mFat);
+  mFat = NULL;
+}
+
+/**
+  Checks that the free cluster info counted from the bitmap matches the FAT,
+  and that counting does not keep any block of the bitmap.
+
+  @param[in]  Context   Unused.
+
+  @retval  UNIT_TEST_PASSED             The free cluster info matches.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  Otherwise.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FatTestFreeInfo (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Free;
+  UINTN  First;
+
+  Free = FatTestCountFree (&First);
+  FatComputeFreeInfo (&mVolume);
+
+  UT_ASSERT_TRUE (mVolume.FreeInfoValid);
+  UT_ASSERT_EQUAL (mVolume.FatInfoSector.FreeInfo.ClusterCount, Free);
+  UT_ASSERT_EQUAL (mVolume.FatInfoSector.FreeInfo.NextCluster, First);
+  UT_ASSERT_EQUAL (FatTestLoadedBlocks (), 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Grows a file through the free cluster bitmap, and checks that it fits in a
+  few extents, that only the blocks of the bitmap it went through are loaded,
+  and that seeking in the file follows its cluster chain.
+
+  @param[in]  Context   Unused.
+
+  @retval  UNIT_TEST_PASSED             The file is laid out as expected.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  Otherwise.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FatTestGrow (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Free;
+  UINTN  First;
+  UINTN  Length;
+
+  FatComputeFreeInfo (&mVolume);
+  Free = mVolume.FatInfoSector.FreeInfo.ClusterCount;
+
+  UT_ASSERT_NOT_EFI_ERROR (FatGrowEof (&mOFile, FAT_TEST_GROW_CLUSTERS * FAT_TEST_CLUSTER_SIZE));
+  UT_ASSERT_TRUE (FatTestCountExtents (&Length) <= 3);
+  UT_ASSERT_EQUAL (Length, FAT_TEST_GROW_CLUSTERS);
+  UT_ASSERT_EQUAL (mVolume.FatInfoSector.FreeInfo.ClusterCount, Free - FAT_TEST_GROW_CLUSTERS);
+  UT_ASSERT_EQUAL (FatTestCountFree (&First), Free - FAT_TEST_GROW_CLUSTERS);
+
+  UT_ASSERT_TRUE (FatTestLoadedBlocks () > 0);
+  UT_ASSERT_TRUE (FatTestLoadedBlocks () < mVolume.FreeBitmapBlocks);
+  UT_ASSERT_TRUE (FatTestBitmapMatchesFat ());
+
+  UT_ASSERT_TRUE (mOFile.ExtentMapValid);
+  UT_ASSERT_TRUE (FatTestSeeks (FAT_TEST_GROW_CLUSTERS));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Shrinks and grows the file again, and checks that the loaded blocks of the
+  free cluster bitmap and the free cluster count follow the FAT.
+
+  @param[in]  Context   Unused.
+
+  @retval  UNIT_TEST_PASSED             The bitmap matches the FAT.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  Otherwise.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FatTestShrink (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  First;
+  UINTN  Length;
+
+  FatComputeFreeInfo (&mVolume);
+  UT_ASSERT_NOT_EFI_ERROR (FatGrowEof (&mOFile, FAT_TEST_GROW_CLUSTERS * FAT_TEST_CLUSTER_SIZE));
+
+  mOFile.FileSize = FAT_TEST_SHRINK_CLUSTERS * FAT_TEST_CLUSTER_SIZE;
+  UT_ASSERT_NOT_EFI_ERROR (FatShrinkEof (&mOFile));
+  FatTestCountExtents (&Length);
+  UT_ASSERT_EQUAL (Length, FAT_TEST_SHRINK_CLUSTERS);
+  UT_ASSERT_EQUAL (mVolume.FatInfoSector.FreeInfo.ClusterCount, FatTestCountFree (&First));
+  UT_ASSERT_TRUE (FatTestBitmapMatchesFat ());
+  UT_ASSERT_TRUE (FatTestSeeks (FAT_TEST_SHRINK_CLUSTERS));
+
+  //
+  // The clusters just freed follow the end of the file, so growing it again
+  // must not start a new extent.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (FatGrowEof (&mOFile, FAT_TEST_GROW_CLUSTERS * FAT_TEST_CLUSTER_SIZE));
+  UT_ASSERT_TRUE (FatTestCountExtents (&Length) <= 3);
+  UT_ASSERT_EQUAL (mVolume.FatInfoSector.FreeInfo.ClusterCount, FatTestCountFree (&First));
+  UT_ASSERT_TRUE (FatTestBitmapMatchesFat ());
+  UT_ASSERT_TRUE (FatTestSeeks (FAT_TEST_GROW_CLUSTERS));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Makes every read of the FAT that builds the free cluster bitmap fail, and
+  checks that the free cluster info and the allocation fall back to reading the
+  FAT an entry at a time.
+
+  @param[in]  Context   Unused.
+
+  @retval  UNIT_TEST_PASSED             The file was grown without the bitmap.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  Otherwise.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FatTestFallback (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Free;
+  UINTN  First;
+  UINTN  Length;
+
+  mFailBitmapReads = TRUE;
+  Free             = FatTestCountFree (&First);
+  FatComputeFreeInfo (&mVolume);
+  UT_ASSERT_EQUAL (mVolume.FatInfoSector.FreeInfo.ClusterCount, Free);
+
+  UT_ASSERT_NOT_EFI_ERROR (FatGrowEof (&mOFile, FAT_TEST_GROW_CLUSTERS * FAT_TEST_CLUSTER_SIZE));
+  FatTestCountExtents (&Length);
+  UT_ASSERT_EQUAL (Length, FAT_TEST_GROW_CLUSTERS);
+  UT_ASSERT_EQUAL (mVolume.FatInfoSector.FreeInfo.ClusterCount, Free - FAT_TEST_GROW_CLUSTERS);
+  UT_ASSERT_EQUAL (FatTestLoadedBlocks (), 0);
+  UT_ASSERT_TRUE (FatTestSeeks (FAT_TEST_GROW_CLUSTERS));
+
+  //
+  // Once the FAT can be read again, the bitmap is used and matches the FAT
+  // the fallback allocator left behind.
+  //
+  mFailBitmapReads = FALSE;
+  UT_ASSERT_NOT_EFI_ERROR (FatGrowEof (&mOFile, (FAT_TEST_GROW_CLUSTERS + FAT_TEST_SHRINK_CLUSTERS) * FAT_TEST_CLUSTER_SIZE));
+  UT_ASSERT_TRUE (FatTestLoadedBlocks () > 0);
+  UT_ASSERT_TRUE (FatTestBitmapMatchesFat ());
+  UT_ASSERT_EQUAL (mVolume.FatInfoSector.FreeInfo.ClusterCount, FatTestCountFree (&First));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Fills a small volume, and checks that growing a file past the free space
+  fails with EFI_VOLUME_FULL and gives its clusters back.
+
+  @param[in]  Context   Unused.
+
+  @retval  UNIT_TEST_PASSED             The volume full case is handled.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  Otherwise.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FatTestVolumeFull (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Free;
+  UINTN  First;
+  UINTN  Length;
+
+  mVolume.MaxCluster = FAT_TEST_FULL_CLUSTERS;
+  Free               = FatTestCountFree (&First);
+  FatComputeFreeInfo (&mVolume);
+
+  UT_ASSERT_STATUS_EQUAL (FatGrowEof (&mOFile, (Free + 1) * FAT_TEST_CLUSTER_SIZE), EFI_VOLUME_FULL);
+  UT_ASSERT_EQUAL (mOFile.FileCluster, 0);
+  UT_ASSERT_EQUAL (FatTestCountFree (&First), Free);
+  UT_ASSERT_EQUAL (mVolume.FatInfoSector.FreeInfo.ClusterCount, Free);
+  UT_ASSERT_TRUE (FatTestBitmapMatchesFat ());
+
+  UT_ASSERT_NOT_EFI_ERROR (FatGrowEof (&mOFile, Free * FAT_TEST_CLUSTER_SIZE));
+  FatTestCountExtents (&Length);
+  UT_ASSERT_EQUAL (Length, Free);
+  UT_ASSERT_EQUAL (FatTestCountFree (&First), 0);
+  UT_ASSERT_EQUAL (mVolume.FatInfoSector.FreeInfo.ClusterCount, 0);
+  UT_ASSERT_TRUE (FatTestSeeks (Free));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Compares the extents and the time taken to grow a file through the free
+  cluster bitmap and through the linear scan of the FAT.
+
+  @param[in]  Context   Unused.
+
+  @retval  UNIT_TEST_PASSED             Both files were grown.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  Otherwise.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FatTestBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT64  Start;
+  UINT64  BitmapTime;
+  UINT64  ScanTime;
+  UINTN   BitmapExtents;
+  UINTN   ScanExtents;
+  UINTN   Length;
+
+  FatComputeFreeInfo (&mVolume);
+  Start = (UINT64) clock ();
+  UT_ASSERT_NOT_EFI_ERROR (FatGrowEof (&mOFile, FAT_TEST_GROW_CLUSTERS * FAT_TEST_CLUSTER_SIZE));
+  BitmapTime    = ((UINT64) clock () - Start) * 1000000000ULL / CLOCKS_PER_SEC;
+  BitmapExtents = FatTestCountExtents (&Length);
+  UT_ASSERT_EQUAL (Length, FAT_TEST_GROW_CLUSTERS);
+
+  FatTestFreeVolume (NULL);
+  UT_ASSERT_EQUAL (FatTestCreateVolume (NULL), UNIT_TEST_PASSED);
+
+  mFailBitmapReads = TRUE;
+  FatComputeFreeInfo (&mVolume);
+  Start = (UINT64) clock ();
+  UT_ASSERT_NOT_EFI_ERROR (FatGrowEof (&mOFile, FAT_TEST_GROW_CLUSTERS * FAT_TEST_CLUSTER_SIZE));
+  ScanTime    = ((UINT64) clock () - Start) * 1000000000ULL / CLOCKS_PER_SEC;
+  ScanExtents = FatTestCountExtents (&Length);
+  UT_ASSERT_EQUAL (Length, FAT_TEST_GROW_CLUSTERS);
+
+  UT_LOG_INFO (
+    "%u clusters grown: bitmap %u extents in %u us, FAT scan %u extents in %u us\n",
+    FAT_TEST_GROW_CLUSTERS,
+    (UINT32) BitmapExtents,
+    (UINT32) (BitmapTime / 1000),
+    (UINT32) ScanExtents,
+    (UINT32) (ScanTime / 1000)
+    );
+  UT_ASSERT_TRUE (BitmapExtents < ScanExtents);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialze the unit test framework, suite, and unit tests for the free cluster
+  bitmap and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      SpaceTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  FatFsLock.Lock = EfiLockAcquired;
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&SpaceTests, Framework, "FAT File Space Tests", "Fat.FileSpace", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for SpaceTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-------Description-----------------------------------------------Name-----------Function-----------Pre------------------Post---------------Context-----------
+  //
+  AddTestCase (SpaceTests, "The free cluster info counted from the bitmap matches the FAT", "FreeInfo",    FatTestFreeInfo,   FatTestCreateVolume, FatTestFreeVolume, NULL);
+  AddTestCase (SpaceTests, "Files grow in few extents and only load the bitmap they use",   "Grow",        FatTestGrow,       FatTestCreateVolume, FatTestFreeVolume, NULL);
+  AddTestCase (SpaceTests, "The loaded bitmap follows the FAT when clusters are freed",     "Shrink",      FatTestShrink,     FatTestCreateVolume, FatTestFreeVolume, NULL);
+  AddTestCase (SpaceTests, "The FAT is scanned when the bitmap can not be built",           "Fallback",    FatTestFallback,   FatTestCreateVolume, FatTestFreeVolume, NULL);
+  AddTestCase (SpaceTests, "Growing a file past the free space fails and frees it",         "VolumeFull",  FatTestVolumeFull, FatTestCreateVolume, FatTestFreeVolume, NULL);
+  AddTestCase (SpaceTests, "Bitmap allocation and FAT scan benchmark",                      "Benchmark",   FatTestBenchmark,  FatTestCreateVolume, FatTestFreeVolume, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int argc,
+  char *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -504,6 +504,21 @@ UnregisterNvmeNamespace (
     FreeUnicodeStringTable (Device->ControllerNameTable);
   }
 
+  DEBUG ((
+    DEBUG_INFO,
+    "%a: NSID %d: Read %Ld cmds/%Ld blocks, Write %Ld cmds/%Ld blocks, "
+    "Flush %Ld, Pipelined %Ld, Errors %Ld\n",
+    __FUNCTION__,
+    Device->NamespaceId,
+    Device->Statistics.ReadCommands,
+    Device->Statistics.ReadBlocks,
+    Device->Statistics.WriteCommands,
+    Device->Statistics.WriteBlocks,
+    Device->Statistics.FlushCommands,
+    Device->Statistics.PipelinedTransfers,
+    Device->Statistics.Errors
+    ));
+
   FreePool (Device);
 
   return EFI_SUCCESS;
@@ -648,15 +663,8 @@ ProcessAsyncTaskList (
         if (AsyncRequest->MapMeta != NULL) {
           PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
         }
-        if (AsyncRequest->MapPrpList != NULL) {
-          PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
-        }
-        if (AsyncRequest->PrpListHost != NULL) {
-          PciIo->FreeBuffer (
-                   PciIo,
-                   AsyncRequest->PrpListNo,
-                   AsyncRequest->PrpListHost
-                   );
+        if (AsyncRequest->PrpList != NULL) {
+          NvmeReleasePrpList (Private, AsyncRequest->PrpList);
         }
 
         RemoveEntryList (Link);
@@ -949,6 +957,8 @@ NvmExpressDriverBindingStart (
       goto Exit;
     }
 
+    InitializeListHead (&Private->FreePrpLists);
+
     //
     // 6 x 4kB aligned buffers will be carved out of this buffer.
     // 1st 4kB boundary is the start of the admin submission queue.
@@ -1088,6 +1098,10 @@ NvmExpressDriverBindingStart (
   return EFI_SUCCESS;
 
 Exit:
+  if (Private != NULL) {
+    NvmeFreePrpListCache (Private);
+  }
+
   if ((Private != NULL) && (Private->Mapping != NULL)) {
     PciIo->Unmap (PciIo, Private->Mapping);
   }
@@ -1211,6 +1225,8 @@ NvmExpressDriverBindingStop (
         gBS->CloseEvent (Private->TimerEvent);
       }
 
+      NvmeFreePrpListCache (Private);
+
       if (Private->Mapping != NULL) {
         Private->PciIo->Unmap (Private->PciIo, Private->Mapping);
       }
@@ -87,6 +87,12 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gNvmExpressDriverSupportedEfiV
 //
 #define NVME_HC_ASYNC_TIMER                       EFI_TIMER_PERIOD_MILLISECONDS (1)
 
+//
+// Maximum number of released PRP lists kept for reuse by each controller,
+// enough for a full asynchronous I/O submission queue plus a blocking command.
+//
+#define NVME_PRP_LIST_CACHE_SIZE                  (NVME_ASYNC_CSQ_SIZE + 2)
+
 //
 // Unique signature for private data structure.
 //
@@ -163,6 +169,12 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   EFI_EVENT                           TimerEvent;
   LIST_ENTRY                          AsyncPassThruQueue;
   LIST_ENTRY                          UnsubmittedSubtasks;
+
+  //
+  // Released PRP lists, kept mapped for reuse by later commands.
+  //
+  LIST_ENTRY                          FreePrpLists;
+  UINTN                               FreePrpListCount;
 };
 
 #define NVME_CONTROLLER_PRIVATE_DATA_FROM_PASS_THRU(a) \
@@ -172,6 +184,23 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
       NVME_CONTROLLER_PRIVATE_DATA_SIGNATURE \
       )
 
+//
+// Per-namespace I/O statistics, reported when the namespace is unregistered.
+//
+typedef struct {
+  UINT64                                   ReadCommands;
+  UINT64                                   WriteCommands;
+  UINT64                                   FlushCommands;
+  UINT64                                   ReadBlocks;
+  UINT64                                   WriteBlocks;
+  //
+  // Blocking transfers larger than MDTS, pipelined through the asynchronous
+  // I/O queue.
+  //
+  UINT64                                   PipelinedTransfers;
+  UINT64                                   Errors;
+} NVME_IO_STATISTICS;
+
 //
 // Unique signature for private data structure.
 //
@@ -209,6 +238,8 @@ struct _NVME_DEVICE_PRIVATE_DATA {
 
   NVME_CONTROLLER_PRIVATE_DATA             *Controller;
 
+  NVME_IO_STATISTICS                       Statistics;
+
 };
 
 //
@@ -252,6 +283,7 @@ typedef struct {
   LIST_ENTRY                               Link;
 
   EFI_BLOCK_IO2_TOKEN                      *Token;
+  NVME_DEVICE_PRIVATE_DATA                 *Device;
   UINTN                                    UnsubmittedSubtaskNum;
   BOOLEAN                                  LastSubtaskSubmitted;
   //
@@ -282,6 +314,24 @@ typedef struct {
 #define NVME_BLKIO2_SUBTASK_FROM_LINK(a) \
   CR (a, NVME_BLKIO2_SUBTASK, Link, NVME_BLKIO2_SUBTASK_SIGNATURE)
 
+//
+// A mapped PRP list buffer.
+//
+#define NVME_PRP_LIST_SIGNATURE            SIGNATURE_32 ('N', 'P', 'R', 'L')
+
+typedef struct {
+  UINT32                                   Signature;
+  LIST_ENTRY                               Link;      // in FreePrpLists
+
+  VOID                                     *Host;
+  UINTN                                    Pages;
+  EFI_PHYSICAL_ADDRESS                     DeviceAddress;
+  VOID                                     *Mapping;
+} NVME_PRP_LIST;
+
+#define NVME_PRP_LIST_FROM_LINK(a) \
+  CR (a, NVME_PRP_LIST, Link, NVME_PRP_LIST_SIGNATURE)
+
 //
 // Nvme asynchronous passthru request.
 //
@@ -293,9 +343,7 @@ typedef struct {
 
   EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET *Packet;
   UINT16                                   CommandId;
-  VOID                                     *MapPrpList;
-  UINTN                                    PrpListNo;
-  VOID                                     *PrpListHost;
+  NVME_PRP_LIST                            *PrpList;
   VOID                                     *MapData;
   VOID                                     *MapMeta;
   EFI_EVENT                                CallerEvent;
@@ -722,6 +770,66 @@ NvmeDumpStatus (
   IN NVME_CQ             *Cq
   );
 
+/**
+  Return a PRP list to the controller's cache of mapped PRP lists, or release
+  it when the cache is full.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+  @param[in] PrpList        The PRP list returned by NvmeCreatePrpList().
+
+**/
+VOID
+NvmeReleasePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA    *Private,
+  IN NVME_PRP_LIST                   *PrpList
+  );
+
+/**
+  Unmap and free the PRP lists cached by the controller.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+
+**/
+VOID
+NvmeFreePrpListCache (
+  IN NVME_CONTROLLER_PRIVATE_DATA    *Private
+  );
+
+/**
+  Aborts the asynchronous PassThru requests.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+
+  @retval EFI_SUCCESS       The asynchronous PassThru requests have been aborted.
+  @return EFI_DEVICE_ERROR  Fail to abort all the asynchronous PassThru requests.
+
+**/
+EFI_STATUS
+AbortAsyncPassThruTasks (
+  IN NVME_CONTROLLER_PRIVATE_DATA    *Private
+  );
+
+/**
+  Submit the pending asynchronous subtasks and process the completed ones.
+
+  This is the notification function of the controller's periodic timer event.
+  Blocking transfers that are pipelined through the asynchronous I/O queue
+  call it directly, at TPL_NOTIFY, to avoid waiting for the timer.
+
+  @param[in]  Event    The Event this notify function registered to.
+  @param[in]  Context  Pointer to the NVME_CONTROLLER_PRIVATE_DATA.
+
+**/
+VOID
+EFIAPI
+ProcessAsyncTaskList (
+  IN EFI_EVENT                    Event,
+  IN VOID*                        Context
+  );
+
 /**
   Register the shutdown notification through the ResetNotification protocol.
 
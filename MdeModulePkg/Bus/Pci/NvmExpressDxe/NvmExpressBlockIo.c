@@ -62,6 +62,9 @@ ReadSectors (
 
   CommandPacket.NvmeCmd->Flags = CDW10_VALID | CDW11_VALID | CDW12_VALID;
 
+  Device->Statistics.ReadCommands++;
+  Device->Statistics.ReadBlocks += Blocks;
+
   Status = Private->Passthru.PassThru (
                                &Private->Passthru,
                                Device->NamespaceId,
@@ -131,6 +134,9 @@ WriteSectors (
 
   CommandPacket.NvmeCmd->Flags = CDW10_VALID | CDW11_VALID | CDW12_VALID;
 
+  Device->Statistics.WriteCommands++;
+  Device->Statistics.WriteBlocks += Blocks;
+
   Status = Private->Passthru.PassThru (
                                &Private->Passthru,
                                Device->NamespaceId,
@@ -195,26 +201,22 @@ NvmeRead (
     MaxTransferBlocks = 1024;
   }
 
-  while (Blocks > 0) {
-    if (Blocks > MaxTransferBlocks) {
-      Status = ReadSectors (Device, (UINT64)(UINTN)Buffer, Lba, MaxTransferBlocks);
-
-      Blocks -= MaxTransferBlocks;
-      Buffer  = (VOID *)(UINTN)((UINT64)(UINTN)Buffer + MaxTransferBlocks * BlockSize);
-      Lba    += MaxTransferBlocks;
-    } else {
-      Status = ReadSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
-      Blocks = 0;
-    }
-
-    if (EFI_ERROR(Status)) {
-      break;
+  if (Blocks > MaxTransferBlocks) {
+    //
+    // Keep several commands in flight on the asynchronous I/O queue, rather
+    // than issuing MDTS-sized commands one after another.
+    //
+    Status = NvmeBlockingPipelinedIo (Device, Buffer, Lba, Blocks, FALSE);
+  } else {
+    Status = ReadSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
+    if (EFI_ERROR (Status)) {
+      Device->Statistics.Errors++;
     }
   }
 
   DEBUG ((DEBUG_BLKIO, "%a: Lba = 0x%08Lx, Original = 0x%08Lx, "
-    "Remaining = 0x%08Lx, BlockSize = 0x%x, Status = %r\n", __FUNCTION__, Lba,
-    (UINT64)OrginalBlocks, (UINT64)Blocks, BlockSize, Status));
+    "BlockSize = 0x%x, Status = %r\n", __FUNCTION__, Lba,
+    (UINT64)OrginalBlocks, BlockSize, Status));
 
   return Status;
 }
@@ -273,26 +275,22 @@ NvmeWrite (
     MaxTransferBlocks = 1024;
   }
 
-  while (Blocks > 0) {
-    if (Blocks > MaxTransferBlocks) {
-      Status = WriteSectors (Device, (UINT64)(UINTN)Buffer, Lba, MaxTransferBlocks);
-
-      Blocks -= MaxTransferBlocks;
-      Buffer  = (VOID *)(UINTN)((UINT64)(UINTN)Buffer + MaxTransferBlocks * BlockSize);
-      Lba    += MaxTransferBlocks;
-    } else {
-      Status = WriteSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
-      Blocks = 0;
-    }
-
-    if (EFI_ERROR(Status)) {
-      break;
+  if (Blocks > MaxTransferBlocks) {
+    //
+    // Keep several commands in flight on the asynchronous I/O queue, rather
+    // than issuing MDTS-sized commands one after another.
+    //
+    Status = NvmeBlockingPipelinedIo (Device, Buffer, Lba, Blocks, TRUE);
+  } else {
+    Status = WriteSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
+    if (EFI_ERROR (Status)) {
+      Device->Statistics.Errors++;
     }
   }
 
   DEBUG ((DEBUG_BLKIO, "%a: Lba = 0x%08Lx, Original = 0x%08Lx, "
-    "Remaining = 0x%08Lx, BlockSize = 0x%x, Status = %r\n", __FUNCTION__, Lba,
-    (UINT64)OrginalBlocks, (UINT64)Blocks, BlockSize, Status));
+    "BlockSize = 0x%x, Status = %r\n", __FUNCTION__, Lba,
+    (UINT64)OrginalBlocks, BlockSize, Status));
 
   return Status;
 }
@@ -331,12 +329,17 @@ NvmeFlush (
   CommandPacket.CommandTimeout = NVME_GENERIC_TIMEOUT;
   CommandPacket.QueueType      = NVME_IO_QUEUE;
 
+  Device->Statistics.FlushCommands++;
+
   Status = Private->Passthru.PassThru (
                                &Private->Passthru,
                                Device->NamespaceId,
                                &CommandPacket,
                                NULL
                                );
+  if (EFI_ERROR (Status)) {
+    Device->Statistics.Errors++;
+  }
 
   return Status;
 }
@@ -375,6 +378,7 @@ AsyncIoCallback (
     //
     if ((Completion->Sct != 0) || (Completion->Sc != 0)) {
       Token->TransactionStatus = EFI_DEVICE_ERROR;
+      Request->Device->Statistics.Errors++;
 
       //
       // Dump completion entry status for debugging.
@@ -510,6 +514,8 @@ AsyncReadSectors (
   CommandPacket->NvmeCmd->Flags = CDW10_VALID | CDW11_VALID | CDW12_VALID;
 
   OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  Device->Statistics.ReadCommands++;
+  Device->Statistics.ReadBlocks += Blocks;
   InsertTailList (&Private->UnsubmittedSubtasks, &Subtask->Link);
   Request->UnsubmittedSubtaskNum++;
   gBS->RestoreTPL (OldTpl);
@@ -652,6 +658,8 @@ AsyncWriteSectors (
   CommandPacket->NvmeCmd->Flags = CDW10_VALID | CDW11_VALID | CDW12_VALID;
 
   OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  Device->Statistics.WriteCommands++;
+  Device->Statistics.WriteBlocks += Blocks;
   InsertTailList (&Private->UnsubmittedSubtasks, &Subtask->Link);
   Request->UnsubmittedSubtaskNum++;
   gBS->RestoreTPL (OldTpl);
@@ -728,6 +736,7 @@ NvmeAsyncRead (
 
   BlkIo2Req->Signature = NVME_BLKIO2_REQUEST_SIGNATURE;
   BlkIo2Req->Token     = Token;
+  BlkIo2Req->Device    = Device;
 
   OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
   InsertTailList (&Device->AsyncQueue, &BlkIo2Req->Link);
@@ -847,6 +856,7 @@ NvmeAsyncWrite (
 
   BlkIo2Req->Signature = NVME_BLKIO2_REQUEST_SIGNATURE;
   BlkIo2Req->Token     = Token;
+  BlkIo2Req->Device    = Device;
 
   OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
   InsertTailList (&Device->AsyncQueue, &BlkIo2Req->Link);
@@ -923,6 +933,129 @@ NvmeAsyncWrite (
   return Status;
 }
 
+/**
+  Read or write some blocks in a blocking manner, keeping several commands in
+  flight.
+
+  The transfer is split into MDTS-sized subtasks that are queued on the
+  asynchronous I/O queue, exactly like a non-blocking BlockIo2 request. The
+  asynchronous queue is then driven directly, rather than from the periodic
+  timer, until all the subtasks have completed.
+
+  If no command completes for NVME_GENERIC_TIMEOUT, the controller is reset and
+  the outstanding commands are aborted, like for a timed out blocking command.
+
+  @param  Device        The pointer to the NVME_DEVICE_PRIVATE_DATA data
+                        structure.
+  @param  Buffer        The buffer to transfer the data to or from.
+  @param  Lba           The start block number.
+  @param  Blocks        Total block number to be transferred.
+  @param  IsWrite       TRUE to write the blocks, FALSE to read them.
+
+  @retval EFI_SUCCESS   The data are transferred.
+  @retval Others        Fail to transfer all the data.
+
+**/
+EFI_STATUS
+NvmeBlockingPipelinedIo (
+  IN     NVME_DEVICE_PRIVATE_DATA       *Device,
+  IN OUT VOID                           *Buffer,
+  IN     UINT64                         Lba,
+  IN     UINTN                          Blocks,
+  IN     BOOLEAN                        IsWrite
+  )
+{
+  NVME_CONTROLLER_PRIVATE_DATA     *Private;
+  EFI_BLOCK_IO2_TOKEN              Token;
+  EFI_EVENT                        TimerEvent;
+  UINT16                           LastCqh;
+  BOOLEAN                          Progress;
+  EFI_STATUS                       Status;
+  EFI_TPL                          OldTpl;
+
+  Private    = Device->Controller;
+  TimerEvent = NULL;
+
+  //
+  // The token event is never waited on; it is only checked for being
+  // signaled, so it needs no notification function.
+  //
+  Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &Token.Event);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &TimerEvent);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  Token.TransactionStatus = EFI_SUCCESS;
+  if (IsWrite) {
+    Status = NvmeAsyncWrite (Device, Buffer, Lba, Blocks, &Token);
+  } else {
+    Status = NvmeAsyncRead (Device, Buffer, Lba, Blocks, &Token);
+  }
+  if (EFI_ERROR (Status)) {
+    Device->Statistics.Errors++;
+    goto Exit;
+  }
+
+  Device->Statistics.PipelinedTransfers++;
+
+  LastCqh = Private->CqHdbl[2].Cqh;
+  gBS->SetTimer (TimerEvent, TimerRelative, NVME_GENERIC_TIMEOUT);
+
+  while (EFI_ERROR (gBS->CheckEvent (Token.Event))) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    ProcessAsyncTaskList (Private->TimerEvent, Private);
+    Progress = (BOOLEAN) (Private->CqHdbl[2].Cqh != LastCqh);
+    LastCqh  = Private->CqHdbl[2].Cqh;
+    gBS->RestoreTPL (OldTpl);
+
+    if (Progress) {
+      gBS->SetTimer (TimerEvent, TimerRelative, NVME_GENERIC_TIMEOUT);
+    } else if (!EFI_ERROR (gBS->CheckEvent (TimerEvent))) {
+      //
+      // Timeout occurs. Reset the NVMe controller to abort the outstanding
+      // commands; the request completes once they are aborted.
+      //
+      DEBUG ((DEBUG_ERROR, "%a: Timeout occurs for an NVMe command.\n", __FUNCTION__));
+
+      OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+      Token.TransactionStatus = EFI_TIMEOUT;
+      gBS->RestoreTPL (OldTpl);
+
+      gBS->SetTimer (Private->TimerEvent, TimerCancel, 0);
+      Status = NvmeControllerInit (Private);
+      if (!EFI_ERROR (Status)) {
+        Status = AbortAsyncPassThruTasks (Private);
+      }
+      gBS->SetTimer (Private->TimerEvent, TimerPeriodic, NVME_HC_ASYNC_TIMER);
+      if (EFI_ERROR (Status)) {
+        //
+        // The outstanding subtasks still reference Token; wait for them
+        // rather than leave them with a dangling pointer.
+        //
+        DEBUG ((DEBUG_ERROR, "%a: Fail to abort the outstanding commands.\n", __FUNCTION__));
+      }
+      gBS->SetTimer (TimerEvent, TimerRelative, NVME_GENERIC_TIMEOUT);
+    }
+  }
+
+  Status = Token.TransactionStatus;
+  if (EFI_ERROR (Status)) {
+    Device->Statistics.Errors++;
+  }
+
+Exit:
+  if (TimerEvent != NULL) {
+    gBS->CloseEvent (TimerEvent);
+  }
+  gBS->CloseEvent (Token.Event);
+  return Status;
+}
+
 /**
   Reset the Block Device.
 
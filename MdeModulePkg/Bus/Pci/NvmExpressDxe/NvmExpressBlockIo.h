@@ -9,6 +9,30 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef _EFI_NVME_BLOCKIO_H_
 #define _EFI_NVME_BLOCKIO_H_
 
+/**
+  Read or write some blocks in a blocking manner, keeping several commands in
+  flight.
+
+  @param  Device        The pointer to the NVME_DEVICE_PRIVATE_DATA data
+                        structure.
+  @param  Buffer        The buffer to transfer the data to or from.
+  @param  Lba           The start block number.
+  @param  Blocks        Total block number to be transferred.
+  @param  IsWrite       TRUE to write the blocks, FALSE to read them.
+
+  @retval EFI_SUCCESS   The data are transferred.
+  @retval Others        Fail to transfer all the data.
+
+**/
+EFI_STATUS
+NvmeBlockingPipelinedIo (
+  IN     NVME_DEVICE_PRIVATE_DATA       *Device,
+  IN OUT VOID                           *Buffer,
+  IN     UINT64                         Lba,
+  IN     UINTN                          Blocks,
+  IN     BOOLEAN                        IsWrite
+  );
+
 /**
   Reset the Block Device.
 
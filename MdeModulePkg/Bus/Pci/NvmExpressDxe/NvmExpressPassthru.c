@@ -196,26 +196,30 @@ NvmeDumpStatus (
   Create PRP lists for data transfer which is larger than 2 memory pages.
   Note here we calcuate the number of required PRP lists and allocate them at one time.
 
-  @param[in]     PciIo               A pointer to the EFI_PCI_IO_PROTOCOL instance.
+  The PRP list pages are taken from the controller's cache of released PRP
+  lists when one is large enough, so that steady streams of large transfers
+  do not allocate and map PRP list pages for every command.
+
+  @param[in]     Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
   @param[in]     PhysicalAddr        The physical base address of data buffer.
   @param[in]     Pages               The number of pages to be transfered.
-  @param[out]    PrpListHost         The host base address of PRP lists.
-  @param[in,out] PrpListNo           The number of PRP List.
-  @param[out]    Mapping             The mapping value returned from PciIo.Map().
+  @param[out]    PrpList             The PRP list, to be released with NvmeReleasePrpList().
 
   @retval The pointer to the first PRP List of the PRP lists.
 
 **/
 VOID*
 NvmeCreatePrpList (
-  IN     EFI_PCI_IO_PROTOCOL          *PciIo,
+  IN     NVME_CONTROLLER_PRIVATE_DATA *Private,
   IN     EFI_PHYSICAL_ADDRESS         PhysicalAddr,
   IN     UINTN                        Pages,
-     OUT VOID                         **PrpListHost,
-  IN OUT UINTN                        *PrpListNo,
-     OUT VOID                         **Mapping
+     OUT NVME_PRP_LIST                **PrpList
   )
 {
+  EFI_PCI_IO_PROTOCOL         *PciIo;
+  NVME_PRP_LIST               *List;
+  LIST_ENTRY                  *Link;
+  UINTN                       PrpListNo;
   UINTN                       PrpEntryNo;
   UINT64                      PrpListBase;
   UINTN                       PrpListIndex;
@@ -224,6 +228,9 @@ NvmeCreatePrpList (
   EFI_PHYSICAL_ADDRESS        PrpListPhyAddr;
   UINTN                       Bytes;
   EFI_STATUS                  Status;
+  EFI_TPL                     OldTpl;
+
+  PciIo = Private->PciIo;
 
   //
   // The number of Prp Entry in a memory page.
@@ -233,50 +240,81 @@ NvmeCreatePrpList (
   //
   // Calculate total PrpList number.
   //
-  *PrpListNo = (UINTN)DivU64x64Remainder ((UINT64)Pages, (UINT64)PrpEntryNo - 1, &Remainder);
-  if (*PrpListNo == 0) {
-    *PrpListNo = 1;
+  PrpListNo = (UINTN)DivU64x64Remainder ((UINT64)Pages, (UINT64)PrpEntryNo - 1, &Remainder);
+  if (PrpListNo == 0) {
+    PrpListNo = 1;
   } else if ((Remainder != 0) && (Remainder != 1)) {
-    *PrpListNo += 1;
+    PrpListNo += 1;
   } else if (Remainder == 1) {
     Remainder = PrpEntryNo;
   } else if (Remainder == 0) {
     Remainder = PrpEntryNo - 1;
   }
 
-  Status = PciIo->AllocateBuffer (
-                    PciIo,
-                    AllocateAnyPages,
-                    EfiBootServicesData,
-                    *PrpListNo,
-                    PrpListHost,
-                    0
-                    );
-
-  if (EFI_ERROR (Status)) {
-    return NULL;
+  //
+  // Reuse a cached PRP list that is large enough.
+  //
+  List   = NULL;
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  for (Link = GetFirstNode (&Private->FreePrpLists);
+       !IsNull (&Private->FreePrpLists, Link);
+       Link = GetNextNode (&Private->FreePrpLists, Link)) {
+    List = NVME_PRP_LIST_FROM_LINK (Link);
+    if (List->Pages >= PrpListNo) {
+      RemoveEntryList (Link);
+      Private->FreePrpListCount--;
+      break;
+    }
+    List = NULL;
   }
+  gBS->RestoreTPL (OldTpl);
 
-  Bytes = EFI_PAGES_TO_SIZE (*PrpListNo);
-  Status = PciIo->Map (
-                    PciIo,
-                    EfiPciIoOperationBusMasterCommonBuffer,
-                    *PrpListHost,
-                    &Bytes,
-                    &PrpListPhyAddr,
-                    Mapping
-                    );
-
-  if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (*PrpListNo))) {
-    DEBUG ((EFI_D_ERROR, "NvmeCreatePrpList: create PrpList failure!\n"));
-    goto EXIT;
+  if (List == NULL) {
+    List = AllocateZeroPool (sizeof (NVME_PRP_LIST));
+    if (List == NULL) {
+      return NULL;
+    }
+    List->Signature = NVME_PRP_LIST_SIGNATURE;
+    List->Pages     = PrpListNo;
+
+    Status = PciIo->AllocateBuffer (
+                      PciIo,
+                      AllocateAnyPages,
+                      EfiBootServicesData,
+                      List->Pages,
+                      &List->Host,
+                      0
+                      );
+
+    if (EFI_ERROR (Status)) {
+      FreePool (List);
+      return NULL;
+    }
+
+    Bytes = EFI_PAGES_TO_SIZE (List->Pages);
+    Status = PciIo->Map (
+                      PciIo,
+                      EfiPciIoOperationBusMasterCommonBuffer,
+                      List->Host,
+                      &Bytes,
+                      &List->DeviceAddress,
+                      &List->Mapping
+                      );
+
+    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (List->Pages))) {
+      DEBUG ((EFI_D_ERROR, "NvmeCreatePrpList: create PrpList failure!\n"));
+      goto EXIT;
+    }
   }
+
+  PrpListPhyAddr = List->DeviceAddress;
+
   //
   // Fill all PRP lists except of last one.
   //
-  ZeroMem (*PrpListHost, Bytes);
-  for (PrpListIndex = 0; PrpListIndex < *PrpListNo - 1; ++PrpListIndex) {
-    PrpListBase = *(UINT64*)PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
+  ZeroMem (List->Host, EFI_PAGES_TO_SIZE (PrpListNo));
+  for (PrpListIndex = 0; PrpListIndex < PrpListNo - 1; ++PrpListIndex) {
+    PrpListBase = (UINT64)(UINTN)List->Host + PrpListIndex * EFI_PAGE_SIZE;
 
     for (PrpEntryIndex = 0; PrpEntryIndex < PrpEntryNo; ++PrpEntryIndex) {
       if (PrpEntryIndex != PrpEntryNo - 1) {
@@ -296,19 +334,77 @@ NvmeCreatePrpList (
   //
   // Fill last PRP list.
   //
-  PrpListBase = *(UINT64*)PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
+  PrpListBase = (UINT64)(UINTN)List->Host + PrpListIndex * EFI_PAGE_SIZE;
   for (PrpEntryIndex = 0; PrpEntryIndex < Remainder; ++PrpEntryIndex) {
     *((UINT64*)(UINTN)PrpListBase + PrpEntryIndex) = PhysicalAddr;
     PhysicalAddr += EFI_PAGE_SIZE;
   }
 
+  *PrpList = List;
   return (VOID*)(UINTN)PrpListPhyAddr;
 
 EXIT:
-  PciIo->FreeBuffer (PciIo, *PrpListNo, *PrpListHost);
+  PciIo->FreeBuffer (PciIo, List->Pages, List->Host);
+  FreePool (List);
   return NULL;
 }
 
+/**
+  Return a PRP list to the controller's cache of mapped PRP lists, or release
+  it when the cache is full.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+  @param[in] PrpList        The PRP list returned by NvmeCreatePrpList().
+
+**/
+VOID
+NvmeReleasePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA    *Private,
+  IN NVME_PRP_LIST                   *PrpList
+  )
+{
+  EFI_TPL                            OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (Private->FreePrpListCount < NVME_PRP_LIST_CACHE_SIZE) {
+    InsertHeadList (&Private->FreePrpLists, &PrpList->Link);
+    Private->FreePrpListCount++;
+    PrpList = NULL;
+  }
+  gBS->RestoreTPL (OldTpl);
+
+  if (PrpList != NULL) {
+    Private->PciIo->Unmap (Private->PciIo, PrpList->Mapping);
+    Private->PciIo->FreeBuffer (Private->PciIo, PrpList->Pages, PrpList->Host);
+    FreePool (PrpList);
+  }
+}
+
+/**
+  Unmap and free the PRP lists cached by the controller.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+
+**/
+VOID
+NvmeFreePrpListCache (
+  IN NVME_CONTROLLER_PRIVATE_DATA    *Private
+  )
+{
+  NVME_PRP_LIST                      *PrpList;
+
+  while (!IsListEmpty (&Private->FreePrpLists)) {
+    PrpList = NVME_PRP_LIST_FROM_LINK (GetFirstNode (&Private->FreePrpLists));
+    RemoveEntryList (&PrpList->Link);
+    Private->PciIo->Unmap (Private->PciIo, PrpList->Mapping);
+    Private->PciIo->FreeBuffer (Private->PciIo, PrpList->Pages, PrpList->Host);
+    FreePool (PrpList);
+  }
+  Private->FreePrpListCount = 0;
+}
+
 
 /**
   Aborts the asynchronous PassThru requests.
@@ -375,15 +471,8 @@ AbortAsyncPassThruTasks (
     if (AsyncRequest->MapMeta != NULL) {
       PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
     }
-    if (AsyncRequest->MapPrpList != NULL) {
-      PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
-    }
-    if (AsyncRequest->PrpListHost != NULL) {
-      PciIo->FreeBuffer (
-               PciIo,
-               AsyncRequest->PrpListNo,
-               AsyncRequest->PrpListHost
-               );
+    if (AsyncRequest->PrpList != NULL) {
+      NvmeReleasePrpList (Private, AsyncRequest->PrpList);
     }
 
     RemoveEntryList (Link);
@@ -460,11 +549,9 @@ NvmExpressPassThru (
   EFI_PHYSICAL_ADDRESS           PhyAddr;
   VOID                           *MapData;
   VOID                           *MapMeta;
-  VOID                           *MapPrpList;
   UINTN                          MapLength;
   UINT64                         *Prp;
-  VOID                           *PrpListHost;
-  UINTN                          PrpListNo;
+  NVME_PRP_LIST                  *PrpList;
   UINT32                         Attributes;
   UINT32                         IoAlign;
   UINT32                         MaxTransLen;
@@ -535,9 +622,7 @@ NvmExpressPassThru (
   PciIo       = Private->PciIo;
   MapData     = NULL;
   MapMeta     = NULL;
-  MapPrpList  = NULL;
-  PrpListHost = NULL;
-  PrpListNo   = 0;
+  PrpList     = NULL;
   Prp         = NULL;
   TimerEvent  = NULL;
   Status      = EFI_SUCCESS;
@@ -662,7 +747,7 @@ NvmExpressPassThru (
     // Create PrpList for remaining data buffer.
     //
     PhyAddr = (Sq->Prp[0] + EFI_PAGE_SIZE) & ~(EFI_PAGE_SIZE - 1);
-    Prp = NvmeCreatePrpList (PciIo, PhyAddr, EFI_SIZE_TO_PAGES(Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
+    Prp = NvmeCreatePrpList (Private, PhyAddr, EFI_SIZE_TO_PAGES(Offset + Bytes) - 1, &PrpList);
     if (Prp == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       goto EXIT;
@@ -738,9 +823,7 @@ NvmExpressPassThru (
     AsyncRequest->CallerEvent   = Event;
     AsyncRequest->MapData       = MapData;
     AsyncRequest->MapMeta       = MapMeta;
-    AsyncRequest->MapPrpList    = MapPrpList;
-    AsyncRequest->PrpListNo     = PrpListNo;
-    AsyncRequest->PrpListHost   = PrpListHost;
+    AsyncRequest->PrpList       = PrpList;
 
     OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
     InsertTailList (&Private->AsyncPassThruQueue, &AsyncRequest->Link);
@@ -878,15 +961,8 @@ EXIT:
              );
   }
 
-  if (MapPrpList != NULL) {
-    PciIo->Unmap (
-             PciIo,
-             MapPrpList
-             );
-  }
-
-  if (Prp != NULL) {
-    PciIo->FreeBuffer (PciIo, PrpListNo, PrpListHost);
+  if (PrpList != NULL) {
+    NvmeReleasePrpList (Private, PrpList);
   }
 
   if (TimerEvent != NULL) {
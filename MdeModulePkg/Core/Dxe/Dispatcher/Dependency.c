@@ -19,6 +19,13 @@ BOOLEAN *mDepexEvaluationStack        = NULL;
 BOOLEAN *mDepexEvaluationStackEnd     = NULL;
 BOOLEAN *mDepexEvaluationStackPointer = NULL;
 
+//
+// Reverse map from protocol GUID to the compiled Depex that push it
+//
+#define DEPEX_GUID_HASH_BUCKETS  64
+
+DEPEX_GUID_REFERENCE  *mDepexGuidHashTable[DEPEX_GUID_HASH_BUCKETS];
+
 //
 // Worker functions
 //
@@ -148,6 +155,271 @@ PopBool (
 
 
 
+/**
+  Computes the reverse map bucket of a protocol GUID.
+
+  @param  Guid                  The protocol GUID, possibly unaligned.
+
+  @return The bucket index
+
+**/
+UINTN
+DepexGuidHashBucket (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  UINT32  Hash;
+
+  Hash = ReadUnaligned32 ((CONST UINT32 *)Guid) ^
+         ReadUnaligned32 ((CONST UINT32 *)Guid + 1) ^
+         ReadUnaligned32 ((CONST UINT32 *)Guid + 2) ^
+         ReadUnaligned32 ((CONST UINT32 *)Guid + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+  return Hash & (DEPEX_GUID_HASH_BUCKETS - 1);
+}
+
+
+
+/**
+  Compile the Depex of DriverEntry into a program that references its
+  protocol GUIDs by index, and register every GUID in the reverse map.
+  The Depex is left to the interpreter if it is malformed, or too large
+  for the compiled form.
+
+  @param  DriverEntry           DriverEntry element to update.
+
+**/
+VOID
+CoreCompileDepex (
+  IN  EFI_CORE_DRIVER_ENTRY   *DriverEntry
+  )
+{
+  UINT8                 *Depex;
+  UINTN                 Index;
+  UINTN                 Depth;
+  UINTN                 GuidCount;
+  UINTN                 ProgramSize;
+  BOOLEAN               EndFound;
+  DEPEX_GUID_REFERENCE  *Guids;
+  UINT8                 *Program;
+  UINTN                 Bucket;
+
+  Depex       = DriverEntry->Depex;
+  Depth       = 0;
+  GuidCount   = 0;
+  ProgramSize = 0;
+  EndFound    = FALSE;
+
+  //
+  // Validate the expression and size the program. Only well-formed
+  // expressions are compiled, so the program needs no checks at runtime.
+  //
+  for (Index = 0; Index < DriverEntry->DepexSize && !EndFound; ) {
+    switch (Depex[Index]) {
+    case EFI_DEP_SOR:
+      if (Index != 0) {
+        return;
+      }
+      Index++;
+      continue;
+
+    case EFI_DEP_PUSH:
+    case EFI_DEP_REPLACE_TRUE:
+      if (DriverEntry->DepexSize - Index < 1 + sizeof (EFI_GUID)) {
+        return;
+      }
+      Depth++;
+      GuidCount++;
+      ProgramSize += 2;
+      Index       += 1 + sizeof (EFI_GUID);
+      break;
+
+    case EFI_DEP_AND:
+    case EFI_DEP_OR:
+      if (Depth < 2) {
+        return;
+      }
+      Depth--;
+      ProgramSize++;
+      Index++;
+      break;
+
+    case EFI_DEP_NOT:
+      if (Depth < 1) {
+        return;
+      }
+      ProgramSize++;
+      Index++;
+      break;
+
+    case EFI_DEP_TRUE:
+    case EFI_DEP_FALSE:
+      Depth++;
+      ProgramSize++;
+      Index++;
+      break;
+
+    case EFI_DEP_END:
+      if (Depth != 1) {
+        return;
+      }
+      ProgramSize++;
+      EndFound = TRUE;
+      break;
+
+    default:
+      return;
+    }
+
+    if ((Depth > DEPEX_PROGRAM_MAX_DEPTH) || (GuidCount > DEPEX_PROGRAM_MAX_GUIDS)) {
+      return;
+    }
+  }
+
+  if (!EndFound) {
+    return;
+  }
+
+  Guids = AllocateZeroPool (GuidCount * sizeof (DEPEX_GUID_REFERENCE) + ProgramSize);
+  if (Guids == NULL) {
+    return;
+  }
+  Program = (UINT8 *)(Guids + GuidCount);
+
+  GuidCount   = 0;
+  ProgramSize = 0;
+  for (Index = 0; Depex[Index] != EFI_DEP_END; ) {
+    switch (Depex[Index]) {
+    case EFI_DEP_SOR:
+      Index++;
+      break;
+
+    case EFI_DEP_PUSH:
+    case EFI_DEP_REPLACE_TRUE:
+      CopyMem (&Guids[GuidCount].Guid, &Depex[Index + 1], sizeof (EFI_GUID));
+      Guids[GuidCount].ReplaceTrue = (BOOLEAN)(Depex[Index] == EFI_DEP_REPLACE_TRUE);
+      Guids[GuidCount].DriverEntry = DriverEntry;
+
+      Bucket = DepexGuidHashBucket (&Guids[GuidCount].Guid);
+      Guids[GuidCount].HashNext    = mDepexGuidHashTable[Bucket];
+      mDepexGuidHashTable[Bucket]  = &Guids[GuidCount];
+
+      Program[ProgramSize++] = EFI_DEP_PUSH;
+      Program[ProgramSize++] = (UINT8)GuidCount;
+      GuidCount++;
+      Index += 1 + sizeof (EFI_GUID);
+      break;
+
+    default:
+      Program[ProgramSize++] = Depex[Index];
+      Index++;
+      break;
+    }
+  }
+  Program[ProgramSize] = EFI_DEP_END;
+
+  DriverEntry->DepexGuids   = Guids;
+  DriverEntry->DepexProgram = Program;
+}
+
+
+
+/**
+  Invalidate the Depex evaluation of every driver with a compiled Depex that
+  pushes Protocol. Called when an instance of Protocol is installed.
+
+  @param  Protocol              The protocol GUID that was installed.
+
+**/
+VOID
+CoreNotifyDepexProtocolInstalled (
+  IN  EFI_GUID                *Protocol
+  )
+{
+  DEPEX_GUID_REFERENCE  *Reference;
+
+  for (Reference = mDepexGuidHashTable[DepexGuidHashBucket (Protocol)];
+       Reference != NULL;
+       Reference = Reference->HashNext) {
+    if (CompareGuid (&Reference->Guid, Protocol)) {
+      Reference->DriverEntry->DepexEvaluated = FALSE;
+    }
+  }
+}
+
+
+
+/**
+  Evaluate the compiled form of the Depex of DriverEntry. Like the
+  interpreter, which replaces a PUSH with EFI_DEP_REPLACE_TRUE once its
+  protocol is found, a GUID is only looked up until it has been found.
+
+  @param  DriverEntry           DriverEntry element with a compiled Depex.
+
+  @retval TRUE                  If driver is ready to run.
+  @retval FALSE                 If driver is not ready to run.
+
+**/
+BOOLEAN
+CoreEvaluateDepexProgram (
+  IN  EFI_CORE_DRIVER_ENTRY   *DriverEntry
+  )
+{
+  UINT8                 *Program;
+  DEPEX_GUID_REFERENCE  *Reference;
+  BOOLEAN               Stack[DEPEX_PROGRAM_MAX_DEPTH];
+  UINTN                 Depth;
+  VOID                  *Interface;
+
+  Depth = 0;
+  for (Program = DriverEntry->DepexProgram; ; Program++) {
+    switch (*Program) {
+    case EFI_DEP_PUSH:
+      Program++;
+      Reference = &DriverEntry->DepexGuids[*Program];
+      if (!Reference->ReplaceTrue &&
+          !EFI_ERROR (CoreLocateProtocol (&Reference->Guid, NULL, &Interface))) {
+        Reference->ReplaceTrue = TRUE;
+      }
+      DEBUG ((DEBUG_DISPATCH, "  PUSH GUID(%g) = %a\n", &Reference->Guid, Reference->ReplaceTrue ? "TRUE" : "FALSE"));
+      Stack[Depth++] = Reference->ReplaceTrue;
+      break;
+
+    case EFI_DEP_AND:
+      DEBUG ((DEBUG_DISPATCH, "  AND\n"));
+      Depth--;
+      Stack[Depth - 1] = (BOOLEAN)(Stack[Depth - 1] && Stack[Depth]);
+      break;
+
+    case EFI_DEP_OR:
+      DEBUG ((DEBUG_DISPATCH, "  OR\n"));
+      Depth--;
+      Stack[Depth - 1] = (BOOLEAN)(Stack[Depth - 1] || Stack[Depth]);
+      break;
+
+    case EFI_DEP_NOT:
+      DEBUG ((DEBUG_DISPATCH, "  NOT\n"));
+      Stack[Depth - 1] = (BOOLEAN)!Stack[Depth - 1];
+      break;
+
+    case EFI_DEP_TRUE:
+    case EFI_DEP_FALSE:
+      DEBUG ((DEBUG_DISPATCH, "  %a\n", (*Program == EFI_DEP_TRUE) ? "TRUE" : "FALSE"));
+      Stack[Depth++] = (BOOLEAN)(*Program == EFI_DEP_TRUE);
+      break;
+
+    default:
+      ASSERT (*Program == EFI_DEP_END);
+      DEBUG ((DEBUG_DISPATCH, "  END\n"));
+      DEBUG ((DEBUG_DISPATCH, "  RESULT = %a\n", Stack[0] ? "TRUE" : "FALSE"));
+      return Stack[0];
+    }
+  }
+}
+
+
+
 /**
   Preprocess dependency expression and update DriverEntry to reflect the
   state of  Before, After, and SOR dependencies. If DriverEntry->Before
@@ -182,6 +454,8 @@ CorePreProcessDepex (
 
   if (DriverEntry->Before || DriverEntry->After) {
     CopyMem (&DriverEntry->BeforeAfterGuid, Iterator + 1, sizeof (EFI_GUID));
+  } else {
+    CoreCompileDepex (DriverEntry);
   }
 
   return EFI_SUCCESS;
@@ -241,6 +515,10 @@ CoreIsSchedulable (
     return TRUE;
   }
 
+  if (DriverEntry->DepexProgram != NULL) {
+    return CoreEvaluateDepexProgram (DriverEntry);
+  }
+
   //
   // Clean out memory leaks in Depex Boolean stack. Leaks are only caused by
   // incorrectly formed DEPEX expressions
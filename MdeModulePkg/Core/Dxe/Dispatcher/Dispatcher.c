@@ -11,7 +11,10 @@
   Step #2 - Dispatch. Remove driver from the mScheduledQueue and load and
             start it. After mScheduledQueue is drained check the
             mDiscoveredList to see if any item has a Depex that is ready to
-            be placed on the mScheduledQueue.
+            be placed on the mScheduledQueue. A Depex that evaluated to FALSE
+            is not evaluated again until a protocol is installed, reinstalled
+            or uninstalled, or for a compiled Depex, until one of the
+            protocols it pushes is installed.
 
   Step #3 - Adding to the mScheduledQueue requires that you process Before
             and After dependencies. This is done recursively as the call to add
@@ -61,6 +64,13 @@ EFI_LOCK  mDispatcherLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
 //
 BOOLEAN  gDispatcherRunning = FALSE;
 
+//
+// The most recently started driver whose entry point installed, reinstalled or
+// uninstalled a protocol. Used to attribute newly satisfied Depex to a
+// predecessor driver.
+//
+EFI_CORE_DRIVER_ENTRY  *mLastProtocolDatabaseModifier = NULL;
+
 //
 // Module globals to manage the FwVol registration notification event
 //
@@ -385,6 +395,67 @@ CoreTrust (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Return the current time for the dispatch timing. The timing needs a TimerLib
+  instance that can convert performance counter ticks to time, so it is only
+  taken when PcdDxeCoreDispatchTimingEnable is set.
+
+  @return The current time in nanoseconds, or 0 if the timing is disabled.
+
+**/
+STATIC
+UINT64
+CoreGetDispatchTime (
+  VOID
+  )
+{
+  if (!FeaturePcdGet (PcdDxeCoreDispatchTimingEnable)) {
+    return 0;
+  }
+
+  return GetTimeInNanoSecond (GetPerformanceCounter ());
+}
+
+/**
+  Print the chain of drivers that ends with the last driver to finish, where
+  each driver is followed by the driver that enabled its Depex. This is the
+  critical path of the dispatch so far.
+
+**/
+VOID
+CoreDumpDispatchCriticalPath (
+  VOID
+  )
+{
+  LIST_ENTRY             *Link;
+  EFI_CORE_DRIVER_ENTRY  *DriverEntry;
+  EFI_CORE_DRIVER_ENTRY  *Last;
+
+  if (!FeaturePcdGet (PcdDxeCoreDispatchTimingEnable) ||
+      !DebugPrintLevelEnabled (DEBUG_DISPATCH)) {
+    return;
+  }
+
+  Last = NULL;
+  for (Link = mDiscoveredList.ForwardLink; Link != &mDiscoveredList; Link = Link->ForwardLink) {
+    DriverEntry = CR (Link, EFI_CORE_DRIVER_ENTRY, Link, EFI_CORE_DRIVER_ENTRY_SIGNATURE);
+    if (DriverEntry->Initialized && ((Last == NULL) || (DriverEntry->EndTime > Last->EndTime))) {
+      Last = DriverEntry;
+    }
+  }
+
+  DEBUG ((DEBUG_DISPATCH, "DXE dispatch critical path:\n"));
+  for (DriverEntry = Last; DriverEntry != NULL; DriverEntry = DriverEntry->EnabledBy) {
+    DEBUG ((
+      DEBUG_DISPATCH,
+      "  FFS(%g) ran %ld us, ended at %ld us\n",
+      &DriverEntry->FileName,
+      DivU64x32 (DriverEntry->EndTime - DriverEntry->StartTime, 1000),
+      DivU64x32 (DriverEntry->EndTime, 1000)
+      ));
+  }
+}
+
 /**
   This is the main Dispatcher for DXE and it exits when there are no more
   drivers to run. Drain the mScheduledQueue and load and start a PE
@@ -411,6 +482,7 @@ CoreDispatcher (
   EFI_CORE_DRIVER_ENTRY           *DriverEntry;
   BOOLEAN                         ReadyToRun;
   EFI_EVENT                       DxeDispatchEvent;
+  UINT64                          ProtocolDatabaseGeneration;
 
   PERF_FUNCTION_BEGIN ();
 
@@ -506,6 +578,9 @@ CoreDispatcher (
       CoreReleaseDispatcherLock ();
 
 
+      ProtocolDatabaseGeneration = CoreGetProtocolDatabaseGeneration ();
+      DriverEntry->StartTime     = CoreGetDispatchTime ();
+
       if (DriverEntry->IsFvImage) {
         //
         // Produce a firmware volume block protocol for FvImage so it gets dispatched from.
@@ -530,6 +605,21 @@ CoreDispatcher (
           );
       }
 
+      DriverEntry->EndTime = CoreGetDispatchTime ();
+      if (CoreGetProtocolDatabaseGeneration () != ProtocolDatabaseGeneration) {
+        mLastProtocolDatabaseModifier = DriverEntry;
+      }
+
+      if (FeaturePcdGet (PcdDxeCoreDispatchTimingEnable)) {
+        DEBUG ((
+          DEBUG_DISPATCH,
+          "Dispatched FFS(%g) in %ld us, waited %ld us on the queue\n",
+          &DriverEntry->FileName,
+          DivU64x32 (DriverEntry->EndTime - DriverEntry->StartTime, 1000),
+          DriverEntry->ReadyTime == 0 ? 0 : DivU64x32 (DriverEntry->StartTime - DriverEntry->ReadyTime, 1000)
+          ));
+      }
+
       ReturnStatus = EFI_SUCCESS;
     }
 
@@ -554,10 +644,33 @@ CoreDispatcher (
         // If Section Extraction Protocol did not let the Depex be read before retry the read
         //
         Status = CoreGetDepexSectionAndPreProccess (DriverEntry);
+        DriverEntry->DepexEvaluated = FALSE;
       }
 
       if (DriverEntry->Dependent) {
+        //
+        // A Depex can only change state when a protocol is installed,
+        // reinstalled or uninstalled. Skip drivers whose Depex evaluated
+        // to FALSE against the current protocol database. A compiled Depex
+        // is only invalidated by installing one of the protocols it pushes.
+        //
+        if (DriverEntry->DepexEvaluated &&
+            ((DriverEntry->DepexProgram != NULL) ||
+             (DriverEntry->DepexEvaluatedGeneration == CoreGetProtocolDatabaseGeneration ()))) {
+          continue;
+        }
+
+        //
+        // Mark the Depex evaluated before evaluating it, so a protocol
+        // installed by an event notification during the evaluation
+        // invalidates the result.
+        //
+        DriverEntry->DepexEvaluated           = TRUE;
+        DriverEntry->DepexEvaluatedGeneration = CoreGetProtocolDatabaseGeneration ();
         if (CoreIsSchedulable (DriverEntry)) {
+          DriverEntry->DepexEvaluated = FALSE;
+          DriverEntry->ReadyTime      = CoreGetDispatchTime ();
+          DriverEntry->EnabledBy      = mLastProtocolDatabaseModifier;
           CoreInsertOnScheduledQueueWhileProcessingBeforeAndAfter (DriverEntry);
           ReadyToRun = TRUE;
         }
@@ -571,6 +684,14 @@ CoreDispatcher (
     }
   } while (ReadyToRun);
 
+  DEBUG_CODE_BEGIN ();
+  if (!EFI_ERROR (ReturnStatus)) {
+    CoreDumpDispatchCriticalPath ();
+    FwVolDumpStatistics ();
+    SectionCacheDumpStatistics ();
+  }
+  DEBUG_CODE_END ();
+
   //
   // Close DXE dispatch Event
   //
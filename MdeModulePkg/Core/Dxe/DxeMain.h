@@ -86,6 +86,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DxeServicesLib.h>
 #include <Library/DebugAgentLib.h>
 #include <Library/CpuExceptionHandlerLib.h>
+#include <Library/TimerLib.h>
 
 
 //
@@ -138,7 +139,34 @@ typedef struct {
 
 
 #define EFI_CORE_DRIVER_ENTRY_SIGNATURE SIGNATURE_32('d','r','v','r')
-typedef struct {
+typedef struct _EFI_CORE_DRIVER_ENTRY EFI_CORE_DRIVER_ENTRY;
+
+///
+/// Maximum number of distinct protocol GUIDs and the maximum stack depth
+/// of a Depex that can be compiled. Larger Depex are interpreted.
+///
+#define DEPEX_PROGRAM_MAX_GUIDS     0xFF
+#define DEPEX_PROGRAM_MAX_DEPTH     64
+
+///
+/// A protocol GUID referenced by a compiled Depex. Each reference is linked
+/// into a hash table keyed by GUID, so installing a protocol only has to
+/// invalidate the drivers whose Depex pushes that GUID.
+///
+typedef struct _DEPEX_GUID_REFERENCE DEPEX_GUID_REFERENCE;
+struct _DEPEX_GUID_REFERENCE {
+  EFI_GUID                        Guid;
+  ///
+  /// TRUE if the Depex already had EFI_DEP_REPLACE_TRUE for this GUID, or
+  /// once the protocol is found. The interpreter rewrites such a PUSH to
+  /// EFI_DEP_REPLACE_TRUE, so it stays TRUE after an uninstall in both.
+  ///
+  BOOLEAN                         ReplaceTrue;
+  EFI_CORE_DRIVER_ENTRY           *DriverEntry;
+  DEPEX_GUID_REFERENCE            *HashNext;
+};
+
+struct _EFI_CORE_DRIVER_ENTRY {
   UINTN                           Signature;
   LIST_ENTRY                      Link;             // mDriverList
 
@@ -166,7 +194,34 @@ typedef struct {
   EFI_HANDLE                      ImageHandle;
   BOOLEAN                         IsFvImage;
 
-} EFI_CORE_DRIVER_ENTRY;
+  ///
+  /// TRUE if the Depex has been evaluated to FALSE while the protocol
+  /// database was at DepexEvaluatedGeneration. The Depex cannot change state
+  /// until a protocol is installed, reinstalled or uninstalled, so the
+  /// dispatcher skips it until then.
+  ///
+  BOOLEAN                         DepexEvaluated;
+  UINT64                          DepexEvaluatedGeneration;
+
+  ///
+  /// Compiled form of Depex, or NULL if Depex is interpreted. The program
+  /// uses the EFI_DEP_* opcodes with each EFI_DEP_PUSH followed by a one
+  /// byte index into DepexGuids instead of a GUID. Installing one of the
+  /// DepexGuids protocols clears DepexEvaluated.
+  ///
+  UINT8                           *DepexProgram;
+  DEPEX_GUID_REFERENCE            *DepexGuids;
+
+  ///
+  /// Dispatch timing in nanoseconds, used to report the critical path.
+  /// EnabledBy is the last driver that modified the handle database before
+  /// this driver's Depex became TRUE.
+  ///
+  UINT64                          ReadyTime;
+  UINT64                          StartTime;
+  UINT64                          EndTime;
+  EFI_CORE_DRIVER_ENTRY           *EnabledBy;
+};
 
 //
 //The data structure of GCD memory map entry
@@ -502,6 +557,19 @@ CoreIsSchedulable (
   );
 
 
+/**
+  Invalidate the Depex evaluation of every driver with a compiled Depex that
+  pushes Protocol. Called when an instance of Protocol is installed.
+
+  @param  Protocol              The protocol GUID that was installed.
+
+**/
+VOID
+CoreNotifyDepexProtocolInstalled (
+  IN  EFI_GUID                *Protocol
+  );
+
+
 /**
   Preprocess dependency expression and update DriverEntry to reflect the
   state of  Before, After, and SOR dependencies. If DriverEntry->Before
@@ -1138,6 +1206,20 @@ CoreGetHandleDatabaseKey (
   );
 
 
+/**
+  return protocol database generation. Unlike the handle database key, it
+  also changes when a protocol is installed on an existing handle.
+
+
+  @return Protocol database generation.
+
+**/
+UINT64
+CoreGetProtocolDatabaseGeneration (
+  VOID
+  );
+
+
 /**
   Go connect any handles that were created or modified while a image executed.
 
@@ -2101,6 +2183,26 @@ FwVolDriverInit (
   );
 
 
+/**
+  Print the file lookup and cache counters of all firmware volumes.
+
+**/
+VOID
+FwVolDumpStatistics (
+  VOID
+  );
+
+
+/**
+  Print the decompressed section cache counters.
+
+**/
+VOID
+SectionCacheDumpStatistics (
+  VOID
+  );
+
+
 /**
   Entry point of the section extraction code. Initializes an instance of the
   section extraction interface and installs it on a new handle.
@@ -18,6 +18,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 VOID          *gEfiFwVolBlockNotifyReg;
 EFI_EVENT     gEfiFwVolBlockEvent;
 
+//
+// File lookup and cache counters
+//
+FV_STATISTICS mFvStatistics;
+
 FV_DEVICE mFvDevice = {
   FV2_DEVICE_SIGNATURE,
   NULL,
@@ -242,6 +247,117 @@ GetFwVolHeader (
 
 
 
+/**
+  Computes the FileHash bucket of a file name.
+
+  @param  Name           The file name.
+
+  @return The bucket index
+
+**/
+UINTN
+FvFileHashBucket (
+  IN CONST EFI_GUID       *Name
+  )
+{
+  UINT32  Hash;
+
+  Hash = ReadUnaligned32 ((CONST UINT32 *)Name) ^
+         ReadUnaligned32 ((CONST UINT32 *)Name + 1) ^
+         ReadUnaligned32 ((CONST UINT32 *)Name + 2) ^
+         ReadUnaligned32 ((CONST UINT32 *)Name + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+  return Hash & (FV_FILE_HASH_BUCKETS - 1);
+}
+
+
+/**
+  Find the first non-pad file with a given name in the FV.
+
+  @param  FvDevice       The FV to search.
+  @param  Name           The file name.
+
+  @return The file list entry, or NULL if the FV has no such file.
+
+**/
+FFS_FILE_LIST_ENTRY *
+FvFindFile (
+  IN FV_DEVICE            *FvDevice,
+  IN CONST EFI_GUID       *Name
+  )
+{
+  FFS_FILE_LIST_ENTRY  *FfsFileEntry;
+
+  for (FfsFileEntry = FvDevice->FileHash[FvFileHashBucket (Name)];
+       FfsFileEntry != NULL;
+       FfsFileEntry = FfsFileEntry->HashNext) {
+    if (CompareGuid (&FfsFileEntry->FfsHeader->Name, Name)) {
+      return FfsFileEntry;
+    }
+  }
+
+  return NULL;
+}
+
+
+/**
+  Add a file to the FileHash index of the FV, unless it is a pad file or a
+  file with the same name is already indexed.
+
+  @param  FvDevice       The FV the file belongs to.
+  @param  FfsFileEntry   The file list entry to index.
+
+**/
+VOID
+FvIndexFile (
+  IN FV_DEVICE            *FvDevice,
+  IN FFS_FILE_LIST_ENTRY  *FfsFileEntry
+  )
+{
+  FFS_FILE_LIST_ENTRY  **Link;
+
+  if (FfsFileEntry->FfsHeader->Type == EFI_FV_FILETYPE_FFS_PAD) {
+    return;
+  }
+
+  //
+  // Append to the bucket so that lookups keep returning the first file in
+  // the FV, as a linear search of FfsFileListHeader would.
+  //
+  for (Link = &FvDevice->FileHash[FvFileHashBucket (&FfsFileEntry->FfsHeader->Name)];
+       *Link != NULL;
+       Link = &(*Link)->HashNext) {
+    if (CompareGuid (&(*Link)->FfsHeader->Name, &FfsFileEntry->FfsHeader->Name)) {
+      return;
+    }
+  }
+
+  *Link = FfsFileEntry;
+}
+
+
+/**
+  Print the file lookup and cache counters of all firmware volumes.
+
+**/
+VOID
+FwVolDumpStatistics (
+  VOID
+  )
+{
+  DEBUG ((
+    DEBUG_VERBOSE,
+    "FwVol: %d file lookups (%d not found), %d cached file hits, %d section streams opened, %d reused\n",
+    mFvStatistics.FileLookups,
+    mFvStatistics.FileLookupMisses,
+    mFvStatistics.FileCacheHits,
+    mFvStatistics.StreamOpens,
+    mFvStatistics.StreamHits
+    ));
+}
+
+
 /**
   Free FvDevice resource when error happens
 
@@ -537,6 +653,7 @@ FvCheck (
       FfsFileEntry->FileCached = FileCached;
       FileCached = FALSE;
       InsertTailList (&FvDevice->FfsFileListHeader, &FfsFileEntry->Link);
+      FvIndexFile (FvDevice, FfsFileEntry);
     }
 
     if (IS_FFS_FILE2 (CacheFfsHeader)) {
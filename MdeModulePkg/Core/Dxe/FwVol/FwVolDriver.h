@@ -13,15 +13,38 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define FV2_DEVICE_SIGNATURE SIGNATURE_32 ('_', 'F', 'V', '2')
 
+//
+// Number of buckets in the per-FV file name index
+//
+#define FV_FILE_HASH_BUCKETS  64
+
 //
 // Used to track all non-deleted files
 //
-typedef struct {
+typedef struct _FFS_FILE_LIST_ENTRY FFS_FILE_LIST_ENTRY;
+struct _FFS_FILE_LIST_ENTRY {
   LIST_ENTRY                      Link;
   EFI_FFS_FILE_HEADER             *FfsHeader;
   UINTN                           StreamHandle;
   BOOLEAN                         FileCached;
-} FFS_FILE_LIST_ENTRY;
+  //
+  // Next file in the same FileHash bucket of the FV_DEVICE
+  //
+  FFS_FILE_LIST_ENTRY             *HashNext;
+};
+
+//
+// File lookup and cache counters, shared by all FVs
+//
+typedef struct {
+  UINTN                           FileLookups;
+  UINTN                           FileLookupMisses;
+  UINTN                           FileCacheHits;
+  UINTN                           StreamOpens;
+  UINTN                           StreamHits;
+} FV_STATISTICS;
+
+extern FV_STATISTICS  mFvStatistics;
 
 typedef struct {
   UINTN                                   Signature;
@@ -41,6 +64,12 @@ typedef struct {
   UINT8                                   ErasePolarity;
   BOOLEAN                                 IsFfs3Fv;
   BOOLEAN                                 IsMemoryMapped;
+
+  //
+  // Index of FfsFileListHeader by file name. Pad files are not indexed, and
+  // only the first file with a given name is.
+  //
+  FFS_FILE_LIST_ENTRY                     *FileHash[FV_FILE_HASH_BUCKETS];
 } FV_DEVICE;
 
 #define FV_DEVICE_FROM_THIS(a) CR(a, FV_DEVICE, Fv, FV2_DEVICE_SIGNATURE)
@@ -399,4 +428,34 @@ IsValidFfsFile (
   IN EFI_FFS_FILE_HEADER  *FfsHeader
   );
 
+
+/**
+  Computes the FileHash bucket of a file name.
+
+  @param  Name           The file name.
+
+  @return The bucket index
+
+**/
+UINTN
+FvFileHashBucket (
+  IN CONST EFI_GUID       *Name
+  );
+
+
+/**
+  Find the first non-pad file with a given name in the FV.
+
+  @param  FvDevice       The FV to search.
+  @param  Name           The file name.
+
+  @return The file list entry, or NULL if the FV has no such file.
+
+**/
+FFS_FILE_LIST_ENTRY *
+FvFindFile (
+  IN FV_DEVICE            *FvDevice,
+  IN CONST EFI_GUID       *Name
+  );
+
 #endif
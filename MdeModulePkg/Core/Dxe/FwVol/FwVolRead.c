@@ -280,9 +280,8 @@ FvReadFile (
 {
   EFI_STATUS                        Status;
   FV_DEVICE                         *FvDevice;
-  EFI_GUID                          SearchNameGuid;
-  EFI_FV_FILETYPE                   LocalFoundType;
-  EFI_FV_FILE_ATTRIBUTES            LocalAttributes;
+  EFI_FV_ATTRIBUTES                 FvAttributes;
+  FFS_FILE_LIST_ENTRY               *FfsFileEntry;
   UINTN                             FileSize;
   UINT8                             *SrcPtr;
   EFI_FFS_FILE_HEADER               *FfsHeader;
@@ -296,35 +295,44 @@ FvReadFile (
   FvDevice = FV_DEVICE_FROM_THIS (This);
 
 
+  mFvStatistics.FileLookups++;
+
+  //
+  // Check if read operation is enabled
+  //
+  Status = FvGetVolumeAttributes (This, &FvAttributes);
+  if (EFI_ERROR (Status) || ((FvAttributes & EFI_FV2_READ_STATUS) == 0)) {
+    return EFI_NOT_FOUND;
+  }
+
   //
-  // Keep looking until we find the matching NameGuid.
+  // Look up the matching NameGuid in the file index.
   // The Key is really a FfsFileEntry
   //
-  FvDevice->LastKey = 0;
-  do {
-    LocalFoundType = 0;
-    Status = FvGetNextFile (
-              This,
-              &FvDevice->LastKey,
-              &LocalFoundType,
-              &SearchNameGuid,
-              &LocalAttributes,
-              &FileSize
-              );
-    if (EFI_ERROR (Status)) {
-      return EFI_NOT_FOUND;
-    }
-  } while (!CompareGuid (&SearchNameGuid, NameGuid));
+  FfsFileEntry = FvFindFile (FvDevice, NameGuid);
+  if (FfsFileEntry == NULL) {
+    mFvStatistics.FileLookupMisses++;
+    return EFI_NOT_FOUND;
+  }
+  FvDevice->LastKey = FfsFileEntry;
 
   //
   // Get a pointer to the header
   //
   FfsHeader = FvDevice->LastKey->FfsHeader;
+  if (IS_FFS_FILE2 (FfsHeader)) {
+    FileSize = FFS_FILE2_SIZE (FfsHeader) - sizeof (EFI_FFS_FILE_HEADER2);
+  } else {
+    FileSize = FFS_FILE_SIZE (FfsHeader) - sizeof (EFI_FFS_FILE_HEADER);
+  }
+
   if (FvDevice->IsMemoryMapped) {
     //
     // Memory mapped FV has not been cached, so here is to cache by file.
     //
-    if (!FvDevice->LastKey->FileCached) {
+    if (FvDevice->LastKey->FileCached) {
+      mFvStatistics.FileCacheHits++;
+    } else {
       //
       // Cache FFS file to memory buffer.
       //
@@ -502,6 +510,9 @@ FvReadFileSection (
     if (EFI_ERROR (Status)) {
       goto Done;
     }
+    mFvStatistics.StreamOpens++;
+  } else {
+    mFvStatistics.StreamHits++;
   }
 
   //
@@ -12,14 +12,117 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 //
 // mProtocolDatabase     - A list of all protocols in the system.  (simple list for now)
+// mProtocolHashTable    - The protocols in mProtocolDatabase, hashed by protocol GUID
 // gHandleList           - A list of all the handles in the system
+// mHandleHashTable      - The handles in gHandleList, hashed by handle address
 // gProtocolDatabaseLock - Lock to protect the mProtocolDatabase
 // gHandleDatabaseKey    -  The Key to show that the handle has been created/modified
+// gProtocolDatabaseGeneration - Incremented on every protocol install, reinstall and uninstall
 //
 LIST_ENTRY      mProtocolDatabase     = INITIALIZE_LIST_HEAD_VARIABLE (mProtocolDatabase);
 LIST_ENTRY      gHandleList           = INITIALIZE_LIST_HEAD_VARIABLE (gHandleList);
 EFI_LOCK        gProtocolDatabaseLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 UINT64          gHandleDatabaseKey    = 0;
+UINT64          gProtocolDatabaseGeneration = 0;
+
+#define PROTOCOL_HASH_BUCKETS   128
+#define HANDLE_HASH_BUCKETS     512
+
+PROTOCOL_ENTRY  *mProtocolHashTable[PROTOCOL_HASH_BUCKETS];
+IHANDLE         *mHandleHashTable[HANDLE_HASH_BUCKETS];
+
+/**
+  Computes the protocol hash table bucket of a protocol GUID.
+
+  @param  Protocol               The ID of the protocol
+
+  @return The bucket index
+
+**/
+STATIC
+UINTN
+ProtocolHashBucket (
+  IN EFI_GUID   *Protocol
+  )
+{
+  UINT32  Hash;
+
+  Hash = ReadUnaligned32 ((UINT32 *)Protocol) ^
+         ReadUnaligned32 ((UINT32 *)Protocol + 1) ^
+         ReadUnaligned32 ((UINT32 *)Protocol + 2) ^
+         ReadUnaligned32 ((UINT32 *)Protocol + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+  return Hash & (PROTOCOL_HASH_BUCKETS - 1);
+}
+
+/**
+  Computes the handle hash table bucket of a handle. Handles are pool
+  allocations, so the low bits of the address carry no information.
+
+  @param  Handle                 The handle
+
+  @return The bucket index
+
+**/
+STATIC
+UINTN
+HandleHashBucket (
+  IN EFI_HANDLE   Handle
+  )
+{
+  UINTN  Hash;
+
+  Hash = (UINTN)Handle >> 3;
+  Hash ^= Hash >> 9;
+  return Hash & (HANDLE_HASH_BUCKETS - 1);
+}
+
+/**
+  Adds a handle to the handle hash table.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle to add
+
+**/
+STATIC
+VOID
+CoreInsertHandleHash (
+  IN IHANDLE    *Handle
+  )
+{
+  UINTN  Bucket;
+
+  Bucket = HandleHashBucket (Handle);
+  Handle->HashNext = mHandleHashTable[Bucket];
+  mHandleHashTable[Bucket] = Handle;
+}
+
+/**
+  Removes a handle from the handle hash table.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle to remove
+
+**/
+STATIC
+VOID
+CoreRemoveHandleHash (
+  IN IHANDLE    *Handle
+  )
+{
+  IHANDLE  **Link;
+
+  for (Link = &mHandleHashTable[HandleHashBucket (Handle)]; *Link != NULL; Link = &(*Link)->HashNext) {
+    if (*Link == Handle) {
+      *Link = Handle->HashNext;
+      Handle->HashNext = NULL;
+      return;
+    }
+  }
+
+  ASSERT (FALSE);
+}
 
 
 
@@ -66,14 +169,16 @@ CoreValidateHandle (
   )
 {
   IHANDLE             *Handle;
-  LIST_ENTRY          *Link;
 
   if (UserHandle == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
-  for (Link = gHandleList.BackLink; Link != &gHandleList; Link = Link->BackLink) {
-    Handle = CR (Link, IHANDLE, AllHandles, EFI_HANDLE_SIGNATURE);
+  //
+  // Only the addresses in the hash chain are compared, so a stale or bogus
+  // UserHandle is never dereferenced.
+  //
+  for (Handle = mHandleHashTable[HandleHashBucket (UserHandle)]; Handle != NULL; Handle = Handle->HashNext) {
     if (Handle == (IHANDLE *) UserHandle) {
       return EFI_SUCCESS;
     }
@@ -100,9 +205,9 @@ CoreFindProtocolEntry (
   IN BOOLEAN    Create
   )
 {
-  LIST_ENTRY          *Link;
   PROTOCOL_ENTRY      *Item;
   PROTOCOL_ENTRY      *ProtEntry;
+  UINTN               Bucket;
 
   ASSERT_LOCKED(&gProtocolDatabaseLock);
 
@@ -111,11 +216,10 @@ CoreFindProtocolEntry (
   //
 
   ProtEntry = NULL;
-  for (Link = mProtocolDatabase.ForwardLink;
-       Link != &mProtocolDatabase;
-       Link = Link->ForwardLink) {
+  Bucket = ProtocolHashBucket (Protocol);
+  for (Item = mProtocolHashTable[Bucket]; Item != NULL; Item = Item->HashNext) {
 
-    Item = CR(Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
+    ASSERT (Item->Signature == PROTOCOL_ENTRY_SIGNATURE);
     if (CompareGuid (&Item->ProtocolID, Protocol)) {
 
       //
@@ -147,6 +251,8 @@ CoreFindProtocolEntry (
       // Add it to protocol database
       //
       InsertTailList (&mProtocolDatabase, &ProtEntry->AllEntries);
+      ProtEntry->HashNext = mProtocolHashTable[Bucket];
+      mProtocolHashTable[Bucket] = ProtEntry;
     }
   }
 
@@ -427,6 +533,7 @@ CoreInstallProtocolInterfaceNotify (
     // in the system
     //
     InsertTailList (&gHandleList, &Handle->AllHandles);
+    CoreInsertHandleHash (Handle);
   } else {
     Status = CoreValidateHandle (Handle);
     if (EFI_ERROR (Status)) {
@@ -465,6 +572,12 @@ CoreInstallProtocolInterfaceNotify (
   // protocol entry
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
+  gProtocolDatabaseGeneration++;
+
+  //
+  // Let the dispatcher re-evaluate drivers that depend on this protocol
+  //
+  CoreNotifyDepexProtocolInstalled (Protocol);
 
   //
   // Notify the notification list for this protocol
@@ -769,6 +882,7 @@ CoreUninstallProtocolInterface (
     //
     gHandleDatabaseKey++;
     Handle->Key = gHandleDatabaseKey;
+    gProtocolDatabaseGeneration++;
 
     //
     // Remove the protocol interface from the handle
@@ -789,6 +903,7 @@ CoreUninstallProtocolInterface (
   if (IsListEmpty (&Handle->Protocols)) {
     Handle->Signature = 0;
     RemoveEntryList (&Handle->AllHandles);
+    CoreRemoveHandleHash (Handle);
     CoreFreePool (Handle);
   }
 
@@ -1517,6 +1632,24 @@ CoreGetHandleDatabaseKey (
 
 
 
+/**
+  return protocol database generation. Unlike the handle database key, it
+  also changes when a protocol is installed on an existing handle.
+
+
+  @return Protocol database generation.
+
+**/
+UINT64
+CoreGetProtocolDatabaseGeneration (
+  VOID
+  )
+{
+  return gProtocolDatabaseGeneration;
+}
+
+
+
 /**
   Go connect any handles that were created or modified while a image executed.
 
@@ -15,7 +15,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 ///
 /// IHANDLE - contains a list of protocol handles
 ///
-typedef struct {
+typedef struct _IHANDLE IHANDLE;
+struct _IHANDLE {
   UINTN               Signature;
   /// All handles list of IHANDLE
   LIST_ENTRY          AllHandles;
@@ -24,7 +25,9 @@ typedef struct {
   UINTN               LocateRequest;
   /// The Handle Database Key value when this handle was last created or modified
   UINT64              Key;
-} IHANDLE;
+  /// Next handle in the same bucket of the handle hash table
+  IHANDLE             *HashNext;
+};
 
 #define ASSERT_IS_HANDLE(a)  ASSERT((a)->Signature == EFI_HANDLE_SIGNATURE)
 
@@ -35,7 +38,8 @@ typedef struct {
 /// database.  Each handler that supports this protocol is listed, along
 /// with a list of registered notifies.
 ///
-typedef struct {
+typedef struct _PROTOCOL_ENTRY PROTOCOL_ENTRY;
+struct _PROTOCOL_ENTRY {
   UINTN               Signature;
   /// Link Entry inserted to mProtocolDatabase
   LIST_ENTRY          AllEntries;
@@ -45,7 +49,9 @@ typedef struct {
   LIST_ENTRY          Protocols;
   /// Registerd notification handlers
   LIST_ENTRY          Notify;
-} PROTOCOL_ENTRY;
+  /// Next protocol entry in the same bucket of the protocol hash table
+  PROTOCOL_ENTRY      *HashNext;
+};
 
 
 #define PROTOCOL_INTERFACE_SIGNATURE  SIGNATURE_32('p','i','f','c')
@@ -260,5 +266,6 @@ CoreValidateHandle (
 extern EFI_LOCK         gProtocolDatabaseLock;
 extern LIST_ENTRY       gHandleList;
 extern UINT64           gHandleDatabaseKey;
+extern UINT64           gProtocolDatabaseGeneration;
 
 #endif
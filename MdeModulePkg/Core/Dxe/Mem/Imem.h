@@ -30,7 +30,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 
 #define MEMORY_MAP_SIGNATURE   SIGNATURE_32('m','m','a','p')
-typedef struct {
+typedef struct _MEMORY_MAP MEMORY_MAP;
+struct _MEMORY_MAP {
   UINTN           Signature;
   LIST_ENTRY      Link;
   BOOLEAN         FromPages;
@@ -41,7 +42,17 @@ typedef struct {
 
   UINT64          VirtualStart;
   UINT64          Attribute;
-} MEMORY_MAP;
+
+  //
+  // Node of the address ordered AVL tree that indexes gMemoryMap. MaxFree is
+  // the size in bytes of the largest EfiConventionalMemory entry in the
+  // subtree rooted at this entry.
+  //
+  MEMORY_MAP      *Left;
+  MEMORY_MAP      *Right;
+  UINTN           Height;
+  UINT64          MaxFree;
+};
 
 //
 // Internal prototypes
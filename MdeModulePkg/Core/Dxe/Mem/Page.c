@@ -44,6 +44,10 @@ UINTN         mFreeMapStack = 0;
 ///
 LIST_ENTRY   mFreeMemoryMapEntryList = INITIALIZE_LIST_HEAD_VARIABLE (mFreeMemoryMapEntryList);
 BOOLEAN      mMemoryTypeInformationInitialized = FALSE;
+///
+/// Root of the AVL tree that indexes the entries of gMemoryMap by address
+///
+MEMORY_MAP   *mMemoryMapIndex = NULL;
 
 EFI_MEMORY_TYPE_STATISTICS mMemoryTypeStatistics[EfiMaxMemoryType + 1] = {
   { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, TRUE,  FALSE },  // EfiReservedMemoryType
@@ -121,6 +125,379 @@ CoreReleaseMemoryLock (
 
 
 
+/**
+  Internal function.  Returns the height of a memory map index subtree.
+
+  @param  Node                   The root of the subtree, or NULL
+
+  @return The height of the subtree
+
+**/
+STATIC
+UINTN
+MemoryMapIndexHeight (
+  IN MEMORY_MAP  *Node
+  )
+{
+  return (Node == NULL) ? 0 : Node->Height;
+}
+
+/**
+  Internal function.  Returns the size of the largest free entry in a memory
+  map index subtree.
+
+  @param  Node                   The root of the subtree, or NULL
+
+  @return The size in bytes of the largest EfiConventionalMemory entry
+
+**/
+STATIC
+UINT64
+MemoryMapIndexMaxFree (
+  IN MEMORY_MAP  *Node
+  )
+{
+  return (Node == NULL) ? 0 : Node->MaxFree;
+}
+
+/**
+  Internal function.  Recomputes the height and the largest free entry of a
+  memory map index node from its own range and its children.
+
+  @param  Node                   The node to update
+
+**/
+STATIC
+VOID
+MemoryMapIndexUpdate (
+  IN OUT MEMORY_MAP  *Node
+  )
+{
+  UINT64  Free;
+
+  Node->Height = MAX (MemoryMapIndexHeight (Node->Left), MemoryMapIndexHeight (Node->Right)) + 1;
+
+  Free = 0;
+  if (Node->Type == EfiConventionalMemory && Node->End >= Node->Start) {
+    Free = Node->End - Node->Start + 1;
+  }
+  Free = MAX (Free, MemoryMapIndexMaxFree (Node->Left));
+  Node->MaxFree = MAX (Free, MemoryMapIndexMaxFree (Node->Right));
+}
+
+/**
+  Internal function.  Compares two memory map entries by their position in
+  the memory map index. Entries do not overlap, so they are ordered by start
+  address. An entry that was clipped to empty keeps its place in front of the
+  entry that starts where it used to end, which the end address takes care of.
+
+  @param  Entry1                 The first entry
+  @param  Entry2                 The second entry
+
+  @retval <0                     Entry1 is ordered before Entry2
+  @retval 0                      Entry1 and Entry2 are the same entry
+  @retval >0                     Entry1 is ordered after Entry2
+
+**/
+STATIC
+INTN
+MemoryMapIndexCompare (
+  IN MEMORY_MAP  *Entry1,
+  IN MEMORY_MAP  *Entry2
+  )
+{
+  if (Entry1->Start != Entry2->Start) {
+    return (Entry1->Start < Entry2->Start) ? -1 : 1;
+  }
+  if (Entry1->End != Entry2->End) {
+    return (Entry1->End < Entry2->End) ? -1 : 1;
+  }
+  if (Entry1 != Entry2) {
+    return ((UINTN)Entry1 < (UINTN)Entry2) ? -1 : 1;
+  }
+  return 0;
+}
+
+/**
+  Internal function.  Restores the AVL balance of a memory map index subtree
+  whose children differ in height by at most two.
+
+  @param  Node                   The root of the subtree
+
+  @return The new root of the subtree
+
+**/
+STATIC
+MEMORY_MAP *
+MemoryMapIndexBalance (
+  IN OUT MEMORY_MAP  *Node
+  )
+{
+  MEMORY_MAP  *Pivot;
+
+  MemoryMapIndexUpdate (Node);
+
+  if (MemoryMapIndexHeight (Node->Left) > MemoryMapIndexHeight (Node->Right) + 1) {
+    Pivot = Node->Left;
+    if (MemoryMapIndexHeight (Pivot->Right) > MemoryMapIndexHeight (Pivot->Left)) {
+      //
+      // Rotate the left child left first
+      //
+      Node->Left   = Pivot->Right;
+      Pivot->Right = Node->Left->Left;
+      Node->Left->Left = Pivot;
+      MemoryMapIndexUpdate (Pivot);
+      Pivot = Node->Left;
+    }
+    Node->Left   = Pivot->Right;
+    Pivot->Right = Node;
+    MemoryMapIndexUpdate (Node);
+    MemoryMapIndexUpdate (Pivot);
+    return Pivot;
+  }
+
+  if (MemoryMapIndexHeight (Node->Right) > MemoryMapIndexHeight (Node->Left) + 1) {
+    Pivot = Node->Right;
+    if (MemoryMapIndexHeight (Pivot->Left) > MemoryMapIndexHeight (Pivot->Right)) {
+      //
+      // Rotate the right child right first
+      //
+      Node->Right  = Pivot->Left;
+      Pivot->Left  = Node->Right->Right;
+      Node->Right->Right = Pivot;
+      MemoryMapIndexUpdate (Pivot);
+      Pivot = Node->Right;
+    }
+    Node->Right = Pivot->Left;
+    Pivot->Left = Node;
+    MemoryMapIndexUpdate (Node);
+    MemoryMapIndexUpdate (Pivot);
+    return Pivot;
+  }
+
+  return Node;
+}
+
+/**
+  Internal function.  Inserts an entry into a memory map index subtree.
+
+  @param  Root                   The root of the subtree, or NULL
+  @param  Entry                  The entry to insert
+
+  @return The new root of the subtree
+
+**/
+STATIC
+MEMORY_MAP *
+MemoryMapIndexInsert (
+  IN MEMORY_MAP  *Root,
+  IN MEMORY_MAP  *Entry
+  )
+{
+  if (Root == NULL) {
+    Entry->Left  = NULL;
+    Entry->Right = NULL;
+    MemoryMapIndexUpdate (Entry);
+    return Entry;
+  }
+
+  if (MemoryMapIndexCompare (Entry, Root) < 0) {
+    Root->Left = MemoryMapIndexInsert (Root->Left, Entry);
+  } else {
+    Root->Right = MemoryMapIndexInsert (Root->Right, Entry);
+  }
+  return MemoryMapIndexBalance (Root);
+}
+
+/**
+  Internal function.  Detaches the lowest entry of a memory map index subtree.
+
+  @param  Root                   The root of the subtree
+  @param  Lowest                 Returns the detached entry
+
+  @return The new root of the subtree
+
+**/
+STATIC
+MEMORY_MAP *
+MemoryMapIndexRemoveLowest (
+  IN  MEMORY_MAP  *Root,
+  OUT MEMORY_MAP  **Lowest
+  )
+{
+  if (Root->Left == NULL) {
+    *Lowest = Root;
+    return Root->Right;
+  }
+
+  Root->Left = MemoryMapIndexRemoveLowest (Root->Left, Lowest);
+  return MemoryMapIndexBalance (Root);
+}
+
+/**
+  Internal function.  Removes an entry from a memory map index subtree.
+
+  @param  Root                   The root of the subtree
+  @param  Entry                  The entry to remove
+
+  @return The new root of the subtree
+
+**/
+STATIC
+MEMORY_MAP *
+MemoryMapIndexRemove (
+  IN MEMORY_MAP  *Root,
+  IN MEMORY_MAP  *Entry
+  )
+{
+  INTN        Result;
+  MEMORY_MAP  *Successor;
+
+  ASSERT (Root != NULL);
+  if (Root == NULL) {
+    return NULL;
+  }
+
+  Result = MemoryMapIndexCompare (Entry, Root);
+  if (Result < 0) {
+    Root->Left = MemoryMapIndexRemove (Root->Left, Entry);
+  } else if (Result > 0) {
+    Root->Right = MemoryMapIndexRemove (Root->Right, Entry);
+  } else {
+    if (Root->Left == NULL) {
+      return Root->Right;
+    }
+    if (Root->Right == NULL) {
+      return Root->Left;
+    }
+    Successor = NULL;
+    Root->Right = MemoryMapIndexRemoveLowest (Root->Right, &Successor);
+    Successor->Left  = Root->Left;
+    Successor->Right = Root->Right;
+    Root = Successor;
+  }
+  return MemoryMapIndexBalance (Root);
+}
+
+/**
+  Internal function.  Recomputes the largest free entry along the path from
+  the root of a memory map index subtree to an entry whose range or type was
+  changed in place. The change must not move the entry relative to the other
+  entries.
+
+  @param  Root                   The root of the subtree
+  @param  Entry                  The entry that changed
+
+**/
+STATIC
+VOID
+MemoryMapIndexRefresh (
+  IN MEMORY_MAP  *Root,
+  IN MEMORY_MAP  *Entry
+  )
+{
+  INTN  Result;
+
+  ASSERT (Root != NULL);
+  if (Root == NULL) {
+    return;
+  }
+
+  Result = MemoryMapIndexCompare (Entry, Root);
+  if (Result < 0) {
+    MemoryMapIndexRefresh (Root->Left, Entry);
+  } else if (Result > 0) {
+    MemoryMapIndexRefresh (Root->Right, Entry);
+  }
+  MemoryMapIndexUpdate (Root);
+}
+
+/**
+  Internal function.  Finds the memory map entry that contains an address.
+
+  @param  Address                The address to look up
+
+  @return The entry that contains Address, or NULL if there is none
+
+**/
+STATIC
+MEMORY_MAP *
+MemoryMapIndexLookup (
+  IN UINT64  Address
+  )
+{
+  MEMORY_MAP  *Node;
+
+  Node = mMemoryMapIndex;
+  while (Node != NULL) {
+    if (Address < Node->Start) {
+      Node = Node->Left;
+    } else if (Address > Node->End) {
+      Node = Node->Right;
+    } else {
+      return Node;
+    }
+  }
+  return NULL;
+}
+
+/**
+  Internal function.  Finds the lowest memory map entry that was moved to
+  general memory and starts above an address.
+
+  @param  Address                The address to look above
+
+  @return The entry, or NULL if there is none
+
+**/
+STATIC
+MEMORY_MAP *
+MemoryMapIndexNextFromPages (
+  IN UINT64  Address
+  )
+{
+  MEMORY_MAP  *Node;
+  MEMORY_MAP  *Next;
+
+  do {
+    Next = NULL;
+    Node = mMemoryMapIndex;
+    while (Node != NULL) {
+      if (Node->Start > Address) {
+        Next = Node;
+        Node = Node->Left;
+      } else {
+        Node = Node->Right;
+      }
+    }
+
+    //
+    // Skip the few entries that still live on the descriptor stack
+    //
+    if (Next != NULL) {
+      Address = Next->Start;
+    }
+  } while (Next != NULL && !Next->FromPages);
+
+  return Next;
+}
+
+/**
+  Internal function.  Adds a descriptor entry to the memory map.
+
+  @param  Entry                  The entry to add
+
+**/
+STATIC
+VOID
+InsertMemoryMapEntry (
+  IN OUT MEMORY_MAP      *Entry
+  )
+{
+  InsertTailList (&gMemoryMap, &Entry->Link);
+  mMemoryMapIndex = MemoryMapIndexInsert (mMemoryMapIndex, Entry);
+}
+
 /**
   Internal function.  Removes a descriptor entry.
 
@@ -134,6 +511,7 @@ RemoveMemoryMapEntry (
 {
   RemoveEntryList (&Entry->Link);
   Entry->Link.ForwardLink = NULL;
+  mMemoryMapIndex = MemoryMapIndexRemove (mMemoryMapIndex, Entry);
 
   if (Entry->FromPages) {
     //
@@ -163,7 +541,6 @@ CoreAddRange (
   IN UINT64                   Attribute
   )
 {
-  LIST_ENTRY        *Link;
   MEMORY_MAP        *Entry;
 
   ASSERT ((Start & EFI_PAGE_MASK) == 0);
@@ -212,29 +589,26 @@ CoreAddRange (
   // and the same Attribute
   //
 
-  Link = gMemoryMap.ForwardLink;
-  while (Link != &gMemoryMap) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-    Link  = Link->ForwardLink;
-
-    if (Entry->Type != Type) {
-      continue;
-    }
-
-    if (Entry->Attribute != Attribute) {
-      continue;
+  while (Start != 0) {
+    Entry = MemoryMapIndexLookup (Start - 1);
+    if (Entry == NULL || Entry->Type != Type || Entry->Attribute != Attribute) {
+      break;
     }
 
-    if (Entry->End + 1 == Start) {
-
-      Start = Entry->Start;
-      RemoveMemoryMapEntry (Entry);
-
-    } else if (Entry->Start == End + 1) {
+    ASSERT (Entry->End + 1 == Start);
+    Start = Entry->Start;
+    RemoveMemoryMapEntry (Entry);
+  }
 
-      End = Entry->End;
-      RemoveMemoryMapEntry (Entry);
+  while (End != MAX_UINT64) {
+    Entry = MemoryMapIndexLookup (End + 1);
+    if (Entry == NULL || Entry->Type != Type || Entry->Attribute != Attribute) {
+      break;
     }
+
+    ASSERT (Entry->Start == End + 1);
+    End = Entry->End;
+    RemoveMemoryMapEntry (Entry);
   }
 
   //
@@ -248,7 +622,7 @@ CoreAddRange (
   mMapStack[mMapDepth].End           = End;
   mMapStack[mMapDepth].VirtualStart  = 0;
   mMapStack[mMapDepth].Attribute     = Attribute;
-  InsertTailList (&gMemoryMap, &mMapStack[mMapDepth].Link);
+  InsertMemoryMapEntry (&mMapStack[mMapDepth]);
 
   mMapDepth += 1;
   ASSERT (mMapDepth < MAX_MAP_DEPTH);
@@ -358,21 +732,20 @@ CoreFreeMemoryMapStack (
       //
       RemoveEntryList (&mMapStack[mMapDepth].Link);
       mMapStack[mMapDepth].Link.ForwardLink = NULL;
+      mMemoryMapIndex = MemoryMapIndexRemove (mMemoryMapIndex, &mMapStack[mMapDepth]);
 
       CopyMem (Entry , &mMapStack[mMapDepth], sizeof (MEMORY_MAP));
       Entry->FromPages = TRUE;
 
       //
-      // Find insertion location
+      // Find insertion location. The entries in general memory are kept in
+      // address order in gMemoryMap.
       //
-      for (Link2 = gMemoryMap.ForwardLink; Link2 != &gMemoryMap; Link2 = Link2->ForwardLink) {
-        Entry2 = CR (Link2, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-        if (Entry2->FromPages && Entry2->Start > Entry->Start) {
-          break;
-        }
-      }
+      Entry2 = MemoryMapIndexNextFromPages (Entry->Start);
+      Link2  = (Entry2 != NULL) ? &Entry2->Link : &gMemoryMap;
 
       InsertTailList (Link2, &Entry->Link);
+      mMemoryMapIndex = MemoryMapIndexInsert (mMemoryMapIndex, Entry);
 
     } else {
       //
@@ -736,7 +1109,6 @@ CoreConvertPagesEx (
   UINT64          RangeEnd;
   UINT64          Attribute;
   EFI_MEMORY_TYPE MemType;
-  LIST_ENTRY      *Link;
   MEMORY_MAP      *Entry;
 
   Entry = NULL;
@@ -762,15 +1134,9 @@ CoreConvertPagesEx (
     //
     // Find the entry that the covers the range
     //
-    for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-      Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
+    Entry = MemoryMapIndexLookup (Start);
 
-      if (Entry->Start <= Start && Entry->End > Start) {
-        break;
-      }
-    }
-
-    if (Link == &gMemoryMap) {
+    if (Entry == NULL) {
       DEBUG ((DEBUG_ERROR | DEBUG_PAGE, "ConvertPages: failed to find range %lx - %lx\n", Start, End));
       return EFI_NOT_FOUND;
     }
@@ -852,6 +1218,7 @@ CoreConvertPagesEx (
       // Clip start
       //
       Entry->Start = RangeEnd + 1;
+      MemoryMapIndexRefresh (mMemoryMapIndex, Entry);
 
     } else if (Entry->End == RangeEnd) {
 
@@ -859,6 +1226,7 @@ CoreConvertPagesEx (
       // Clip end
       //
       Entry->End = Start - 1;
+      MemoryMapIndexRefresh (mMemoryMapIndex, Entry);
 
     } else {
 
@@ -882,9 +1250,10 @@ CoreConvertPagesEx (
 
       Entry->End = Start - 1;
       ASSERT (Entry->Start < Entry->End);
+      MemoryMapIndexRefresh (mMemoryMapIndex, Entry);
 
       Entry = &mMapStack[mMapDepth];
-      InsertTailList (&gMemoryMap, &Entry->Link);
+      InsertMemoryMapEntry (Entry);
 
       mMapDepth += 1;
       ASSERT (mMapDepth < MAX_MAP_DEPTH);
@@ -1008,6 +1377,108 @@ CoreUpdateMemoryAttributes (
 }
 
 
+/**
+  Internal function. Searches a memory map index subtree for the highest
+  free range that satisfies an allocation request.
+
+  @param  Node                   The root of the subtree to search
+  @param  MaxAddress             The address that the range must be below
+  @param  MinAddress             The address that the range must be above
+  @param  NumberOfBytes          Number of bytes needed
+  @param  Alignment              Bits to align with
+  @param  NeedGuard              Flag to indicate Guard page is needed or not
+
+  @return The last address of the range, or 0 if the range was not found
+
+**/
+STATIC
+UINT64
+CoreFindFreePagesInIndex (
+  IN MEMORY_MAP       *Node,
+  IN UINT64           MaxAddress,
+  IN UINT64           MinAddress,
+  IN UINT64           NumberOfBytes,
+  IN UINTN            Alignment,
+  IN BOOLEAN          NeedGuard
+  )
+{
+  UINT64          Target;
+  UINT64          DescStart;
+  UINT64          DescEnd;
+  UINT64          DescNumberOfBytes;
+
+  //
+  // Skip subtrees without a free entry that is large enough, and entries that
+  // lie entirely outside of the allowed range. Higher entries are visited
+  // first, so the first range found is the highest one.
+  //
+  while (Node != NULL && Node->MaxFree >= NumberOfBytes) {
+    if (Node->Start >= MaxAddress) {
+      Node = Node->Left;
+      continue;
+    }
+
+    if (Node->End < MinAddress) {
+      Node = Node->Right;
+      continue;
+    }
+
+    Target = CoreFindFreePagesInIndex (
+               Node->Right,
+               MaxAddress,
+               MinAddress,
+               NumberOfBytes,
+               Alignment,
+               NeedGuard
+               );
+    if (Target != 0) {
+      return Target;
+    }
+
+    if (Node->Type == EfiConventionalMemory) {
+      DescStart = Node->Start;
+      DescEnd   = Node->End;
+
+      //
+      // If desc ends past max allowed address, clip the end
+      //
+      if (DescEnd >= MaxAddress) {
+        DescEnd = MaxAddress;
+      }
+
+      DescEnd = ((DescEnd + 1) & (~(Alignment - 1))) - 1;
+
+      //
+      // Compute the number of bytes we can used from this
+      // descriptor, and see it's enough to satisfy the request.
+      // Skip it if DescEnd is less than DescStart after alignment
+      // clipping, or if the start of the allocated range is below
+      // the min address allowed.
+      //
+      if (DescEnd >= DescStart) {
+        DescNumberOfBytes = DescEnd - DescStart + 1;
+        if (DescNumberOfBytes >= NumberOfBytes &&
+            (DescEnd - NumberOfBytes + 1) >= MinAddress) {
+          if (NeedGuard) {
+            DescEnd = AdjustMemoryS (
+                        DescEnd + 1 - DescNumberOfBytes,
+                        DescNumberOfBytes,
+                        NumberOfBytes
+                        );
+          }
+          if (DescEnd != 0) {
+            return DescEnd;
+          }
+        }
+      }
+    }
+
+    Node = Node->Left;
+  }
+
+  return 0;
+}
+
 /**
   Internal function. Finds a consecutive free page range below
   the requested address.
@@ -1035,11 +1506,6 @@ CoreFindFreePagesI (
 {
   UINT64          NumberOfBytes;
   UINT64          Target;
-  UINT64          DescStart;
-  UINT64          DescEnd;
-  UINT64          DescNumberOfBytes;
-  LIST_ENTRY      *Link;
-  MEMORY_MAP      *Entry;
 
   if ((MaxAddress < EFI_PAGE_MASK) ||(NumberOfPages == 0)) {
     return 0;
@@ -1068,75 +1534,15 @@ CoreFindFreePagesI (
   }
 
   NumberOfBytes = LShiftU64 (NumberOfPages, EFI_PAGE_SHIFT);
-  Target = 0;
-
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-
-    //
-    // If it's not a free entry, don't bother with it
-    //
-    if (Entry->Type != EfiConventionalMemory) {
-      continue;
-    }
 
-    DescStart = Entry->Start;
-    DescEnd = Entry->End;
-
-    //
-    // If desc is past max allowed address or below min allowed address, skip it
-    //
-    if ((DescStart >= MaxAddress) || (DescEnd < MinAddress)) {
-      continue;
-    }
-
-    //
-    // If desc ends past max allowed address, clip the end
-    //
-    if (DescEnd >= MaxAddress) {
-      DescEnd = MaxAddress;
-    }
-
-    DescEnd = ((DescEnd + 1) & (~(Alignment - 1))) - 1;
-
-    // Skip if DescEnd is less than DescStart after alignment clipping
-    if (DescEnd < DescStart) {
-      continue;
-    }
-
-    //
-    // Compute the number of bytes we can used from this
-    // descriptor, and see it's enough to satisfy the request
-    //
-    DescNumberOfBytes = DescEnd - DescStart + 1;
-
-    if (DescNumberOfBytes >= NumberOfBytes) {
-      //
-      // If the start of the allocated range is below the min address allowed, skip it
-      //
-      if ((DescEnd - NumberOfBytes + 1) < MinAddress) {
-        continue;
-      }
-
-      //
-      // If this is the best match so far remember it
-      //
-      if (DescEnd > Target) {
-        if (NeedGuard) {
-          DescEnd = AdjustMemoryS (
-                      DescEnd + 1 - DescNumberOfBytes,
-                      DescNumberOfBytes,
-                      NumberOfBytes
-                      );
-          if (DescEnd == 0) {
-            continue;
-          }
-        }
-
-        Target = DescEnd;
-      }
-    }
-  }
+  Target = CoreFindFreePagesInIndex (
+             mMemoryMapIndex,
+             MaxAddress,
+             MinAddress,
+             NumberOfBytes,
+             Alignment,
+             NeedGuard
+             );
 
   //
   // If this is a grow down, adjust target to be the allocation base
@@ -1477,7 +1883,6 @@ CoreInternalFreePages (
   )
 {
   EFI_STATUS      Status;
-  LIST_ENTRY      *Link;
   MEMORY_MAP      *Entry;
   UINTN           Alignment;
   BOOLEAN         IsGuarded;
@@ -1491,14 +1896,8 @@ CoreInternalFreePages (
   // Find the entry that the covers the range
   //
   IsGuarded = FALSE;
-  Entry = NULL;
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR(Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-    if (Entry->Start <= Memory && Entry->End > Memory) {
-        break;
-    }
-  }
-  if (Link == &gMemoryMap) {
+  Entry = MemoryMapIndexLookup (Memory);
+  if (Entry == NULL) {
     Status = EFI_NOT_FOUND;
     goto Done;
   }
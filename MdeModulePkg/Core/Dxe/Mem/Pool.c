@@ -22,6 +22,7 @@ typedef struct {
 
 #define POOL_HEAD_SIGNATURE       SIGNATURE_32('p','h','d','0')
 #define POOLPAGE_HEAD_SIGNATURE   SIGNATURE_32('p','h','d','1')
+#define POOLSLAB_HEAD_SIGNATURE   SIGNATURE_32('p','h','d','2')
 typedef struct {
   UINT32          Signature;
   UINT32          Reserved;
@@ -60,6 +61,57 @@ STATIC CONST UINT16 mPoolSizeTable[] = {
 
 #define MAX_POOL_SIZE     (MAX_ADDRESS - POOL_OVERHEAD)
 
+//
+// Size classes of the slab allocator, including pool head and tail overhead.
+// All of them are multiples of 16 bytes so that a request size can be mapped
+// to its size class with a single table lookup.
+//
+STATIC CONST UINT16 mPoolSlabSizeTable[] = {
+  48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512, 640, 768,
+  896, 1024
+};
+
+#define POOL_SLAB_GRANULE     16
+#define MAX_SLAB_LIST         (ARRAY_SIZE (mPoolSlabSizeTable))
+#define MAX_SLAB_OBJECT_SIZE  (mPoolSlabSizeTable[MAX_SLAB_LIST - 1])
+
+//
+// Maps ((Size - 1) / POOL_SLAB_GRANULE) to the smallest size class that can
+// hold Size bytes. Filled in by CoreInitializePool().
+//
+STATIC UINT8  mPoolSlabIndex[1024 / POOL_SLAB_GRANULE];
+
+#define SIZE_TO_SLAB_LIST(a)  (mPoolSlabIndex[((a) - 1) / POOL_SLAB_GRANULE])
+#define SLAB_LIST_TO_SIZE(a)  (mPoolSlabSizeTable[a])
+
+//
+// A freed slab object. It reuses the signature of the free pool blocks so that
+// a double free is caught by the pool head signature check.
+//
+typedef struct _POOL_SLAB_FREE {
+  UINT32                  Signature;
+  UINT32                  Reserved;
+  struct _POOL_SLAB_FREE  *Next;
+} POOL_SLAB_FREE;
+
+//
+// Header at the start of each slab. A slab is a Granularity sized, Granularity
+// aligned block of pages that is carved into objects of a single size class,
+// so the slab owning an object is found by rounding the object address down.
+//
+#define POOL_SLAB_SIGNATURE   SIGNATURE_32('p','s','l','b')
+typedef struct {
+  UINT32          Signature;
+  UINT32          Index;
+  UINTN           InUse;
+  UINTN           Capacity;
+  UINTN           Carved;
+  POOL_SLAB_FREE  *FreeList;
+  LIST_ENTRY      Link;
+} POOL_SLAB;
+
+#define SIZE_OF_POOL_SLAB ALIGN_VALUE (sizeof (POOL_SLAB), POOL_SLAB_GRANULE)
+
 //
 // Globals
 //
@@ -70,6 +122,7 @@ typedef struct {
     UINTN            Used;
     EFI_MEMORY_TYPE  MemoryType;
     LIST_ENTRY       FreeList[MAX_POOL_LIST];
+    LIST_ENTRY       SlabList[MAX_SLAB_LIST];
     LIST_ENTRY       Link;
 } POOL;
 
@@ -118,6 +171,7 @@ CoreInitializePool (
 {
   UINTN  Type;
   UINTN  Index;
+  UINTN  SlabIndex;
 
   for (Type=0; Type < EfiMaxMemoryType; Type++) {
     mPoolHead[Type].Signature  = 0;
@@ -126,6 +180,18 @@ CoreInitializePool (
     for (Index=0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&mPoolHead[Type].FreeList[Index]);
     }
+    for (Index=0; Index < MAX_SLAB_LIST; Index++) {
+      InitializeListHead (&mPoolHead[Type].SlabList[Index]);
+    }
+  }
+
+  ASSERT (MAX_SLAB_OBJECT_SIZE == ARRAY_SIZE (mPoolSlabIndex) * POOL_SLAB_GRANULE);
+  SlabIndex = 0;
+  for (Index = 0; Index < ARRAY_SIZE (mPoolSlabIndex); Index++) {
+    while (SLAB_LIST_TO_SIZE (SlabIndex) < (Index + 1) * POOL_SLAB_GRANULE) {
+      SlabIndex++;
+    }
+    mPoolSlabIndex[Index] = (UINT8)SlabIndex;
   }
 }
 
@@ -176,6 +242,9 @@ LookupPoolHead (
     for (Index=0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&Pool->FreeList[Index]);
     }
+    for (Index=0; Index < MAX_SLAB_LIST; Index++) {
+      InitializeListHead (&Pool->SlabList[Index]);
+    }
 
     InsertHeadList (&mPoolHeadList, &Pool->Link);
 
@@ -332,6 +401,78 @@ CoreAllocatePoolPagesI (
   return Buffer;
 }
 
+/**
+  Internal function.  Allocates an object from the slab of the size class
+  that fits Size, getting a new slab from CoreAllocatePoolPagesI() if all
+  slabs of that size class are full.
+
+  @param  Pool                   Pool head of the memory type to allocate from
+  @param  Size                   The size of the object, including pool overhead
+  @param  Granularity            The size and alignment of a slab
+
+  @return The allocated object, or NULL
+
+**/
+STATIC
+POOL_HEAD *
+CoreAllocatePoolSlabI (
+  IN POOL   *Pool,
+  IN UINTN  Size,
+  IN UINTN  Granularity
+  )
+{
+  POOL_SLAB       *Slab;
+  POOL_SLAB_FREE  *Free;
+  VOID            *Object;
+  UINTN           Index;
+
+  Index = SIZE_TO_SLAB_LIST (Size);
+
+  if (IsListEmpty (&Pool->SlabList[Index])) {
+    Slab = CoreAllocatePoolPagesI (Pool->MemoryType, EFI_SIZE_TO_PAGES (Granularity),
+                                   Granularity, FALSE);
+    if (Slab == NULL) {
+      return NULL;
+    }
+
+    Slab->Signature = POOL_SLAB_SIGNATURE;
+    Slab->Index     = (UINT32)Index;
+    Slab->InUse     = 0;
+    Slab->Capacity  = (Granularity - SIZE_OF_POOL_SLAB) / SLAB_LIST_TO_SIZE (Index);
+    Slab->Carved    = 0;
+    Slab->FreeList  = NULL;
+    InsertHeadList (&Pool->SlabList[Index], &Slab->Link);
+  } else {
+    Slab = CR (Pool->SlabList[Index].ForwardLink, POOL_SLAB, Link, POOL_SLAB_SIGNATURE);
+  }
+
+  //
+  // Prefer recently freed objects, and carve a new object from the untouched
+  // tail of the slab only when there are none.
+  //
+  if (Slab->FreeList != NULL) {
+    Free = Slab->FreeList;
+    ASSERT (Free->Signature == POOL_FREE_SIGNATURE);
+    Slab->FreeList = Free->Next;
+    Object = Free;
+  } else {
+    ASSERT (Slab->Carved < Slab->Capacity);
+    Object = (CHAR8 *)Slab + SIZE_OF_POOL_SLAB + Slab->Carved * SLAB_LIST_TO_SIZE (Index);
+    Slab->Carved++;
+  }
+
+  //
+  // Full slabs are taken off the list so that the head of the list always has
+  // room.
+  //
+  Slab->InUse++;
+  if (Slab->InUse == Slab->Capacity) {
+    RemoveEntryList (&Slab->Link);
+  }
+
+  return (POOL_HEAD *)Object;
+}
+
 /**
   Internal function to allocate pool of a particular type.
   Caller must have the memory lock held
@@ -363,6 +504,7 @@ CoreAllocatePoolI (
   UINTN       Granularity;
   BOOLEAN     HasPoolTail;
   BOOLEAN     PageAsPool;
+  BOOLEAN     SlabObject;
 
   ASSERT_LOCKED (&mPoolMemoryLock);
 
@@ -398,6 +540,18 @@ CoreAllocatePoolI (
     return NULL;
   }
   Head = NULL;
+  SlabObject = FALSE;
+
+  //
+  // Small requests are served from the slab of their size class when the slab
+  // allocator is enabled.
+  //
+  if (FeaturePcdGet (PcdDxeCorePoolSlabEnable) &&
+      Size <= MAX_SLAB_OBJECT_SIZE && !NeedGuard && !PageAsPool) {
+    Head = CoreAllocatePoolSlabI (Pool, Size, Granularity);
+    SlabObject = TRUE;
+    goto Done;
+  }
 
   //
   // If allocation is over max size, just allocate pages for the request
@@ -495,7 +649,13 @@ Done:
     //
     // If we have a pool buffer, fill in the header & tail info
     //
-    Head->Signature = (PageAsPool) ? POOLPAGE_HEAD_SIGNATURE : POOL_HEAD_SIGNATURE;
+    if (PageAsPool) {
+      Head->Signature = POOLPAGE_HEAD_SIGNATURE;
+    } else if (SlabObject) {
+      Head->Signature = POOLSLAB_HEAD_SIGNATURE;
+    } else {
+      Head->Signature = POOL_HEAD_SIGNATURE;
+    }
     Head->Size      = Size;
     Head->Type      = (EFI_MEMORY_TYPE) PoolType;
     Buffer          = Head->Data;
@@ -653,6 +813,86 @@ CoreFreePoolPagesWithGuard (
   }
 }
 
+/**
+  Internal function.  Returns the slab a slab object was allocated from.
+
+  @param  Head                   The slab object
+  @param  Granularity            The size and alignment of a slab
+
+  @return The slab of the object, or NULL if Head is not part of a slab with
+          objects in use.
+
+**/
+STATIC
+POOL_SLAB *
+CoreGetPoolSlabI (
+  IN POOL_HEAD  *Head,
+  IN UINTN      Granularity
+  )
+{
+  POOL_SLAB       *Slab;
+
+  Slab = (POOL_SLAB *)((UINTN)Head & ~(Granularity - 1));
+  if (Slab->Signature != POOL_SLAB_SIGNATURE || Slab->InUse == 0) {
+    ASSERT (Slab->Signature == POOL_SLAB_SIGNATURE);
+    ASSERT (Slab->InUse != 0);
+    return NULL;
+  }
+
+  return Slab;
+}
+
+/**
+  Internal function.  Returns an object to the slab it was allocated from.
+  The slab is given back to free memory once it becomes empty, unless it is
+  the last slab with free room in its size class.
+
+  @param  Pool                   Pool head of the memory type of the object
+  @param  Slab                   The slab of the object
+  @param  Head                   The object to free
+  @param  Granularity            The size and alignment of a slab
+
+**/
+STATIC
+VOID
+CoreFreePoolSlabI (
+  IN POOL       *Pool,
+  IN POOL_SLAB  *Slab,
+  IN POOL_HEAD  *Head,
+  IN UINTN      Granularity
+  )
+{
+  POOL_SLAB_FREE  *Free;
+  LIST_ENTRY      *SlabList;
+
+  SlabList = &Pool->SlabList[Slab->Index];
+
+  Free = (POOL_SLAB_FREE *)Head;
+  Free->Signature = POOL_FREE_SIGNATURE;
+  Free->Next      = Slab->FreeList;
+  Slab->FreeList  = Free;
+
+  if (Slab->InUse == Slab->Capacity) {
+    InsertHeadList (SlabList, &Slab->Link);
+  }
+  Slab->InUse--;
+
+  //
+  // Keep one empty slab around for the standard memory types so that
+  // alternating allocate/free of a single object does not churn the memory
+  // map. OS/OEM memory types release their slabs eagerly because the pool
+  // head for them goes away once it is no longer used.
+  //
+  if (Slab->InUse == 0 &&
+      (Slab->Link.ForwardLink != SlabList || Slab->Link.BackLink != SlabList ||
+       (UINT32)Pool->MemoryType >= MEMORY_TYPE_OEM_RESERVED_MIN)) {
+    RemoveEntryList (&Slab->Link);
+    Slab->Signature = 0;
+    CoreFreePoolPagesI (Pool->MemoryType, (EFI_PHYSICAL_ADDRESS)(UINTN)Slab,
+      EFI_SIZE_TO_PAGES (Granularity));
+  }
+}
+
 /**
   Internal function to free a pool entry.
   Caller must have the memory lock held
@@ -684,6 +924,8 @@ CoreFreePoolI (
   BOOLEAN     IsGuarded;
   BOOLEAN     HasPoolTail;
   BOOLEAN     PageAsPool;
+  BOOLEAN     SlabObject;
+  POOL_SLAB   *Slab;
 
   ASSERT(Buffer != NULL);
   //
@@ -693,9 +935,11 @@ CoreFreePoolI (
   ASSERT(Head != NULL);
 
   if (Head->Signature != POOL_HEAD_SIGNATURE &&
-      Head->Signature != POOLPAGE_HEAD_SIGNATURE) {
+      Head->Signature != POOLPAGE_HEAD_SIGNATURE &&
+      Head->Signature != POOLSLAB_HEAD_SIGNATURE) {
     ASSERT (Head->Signature == POOL_HEAD_SIGNATURE ||
-            Head->Signature == POOLPAGE_HEAD_SIGNATURE);
+            Head->Signature == POOLPAGE_HEAD_SIGNATURE ||
+            Head->Signature == POOLSLAB_HEAD_SIGNATURE);
     return EFI_INVALID_PARAMETER;
   }
 
@@ -704,6 +948,7 @@ CoreFreePoolI (
   HasPoolTail = !(IsGuarded &&
                   ((PcdGet8 (PcdHeapGuardPropertyMask) & BIT7) == 0));
   PageAsPool = (Head->Signature == POOLPAGE_HEAD_SIGNATURE);
+  SlabObject = (Head->Signature == POOLSLAB_HEAD_SIGNATURE);
 
   if (HasPoolTail) {
     Tail = HEAD_TO_TAIL (Head);
@@ -734,8 +979,6 @@ CoreFreePoolI (
   if (Pool == NULL) {
     return EFI_INVALID_PARAMETER;
   }
-  Pool->Used -= Size;
-  DEBUG ((DEBUG_POOL, "FreePool: %p (len %lx) %,ld\n", Head->Data, (UINT64)(Head->Size - POOL_OVERHEAD), (UINT64) Pool->Used));
 
   if  (Head->Type == EfiACPIReclaimMemory   ||
        Head->Type == EfiACPIMemoryNVS       ||
@@ -747,6 +990,20 @@ CoreFreePoolI (
     Granularity = DEFAULT_PAGE_ALLOCATION_GRANULARITY;
   }
 
+  //
+  // Check that a slab object belongs to a slab before the pool is touched
+  //
+  Slab = NULL;
+  if (SlabObject) {
+    Slab = CoreGetPoolSlabI (Head, Granularity);
+    if (Slab == NULL) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  Pool->Used -= Size;
+  DEBUG ((DEBUG_POOL, "FreePool: %p (len %lx) %,ld\n", Head->Data, (UINT64)(Head->Size - POOL_OVERHEAD), (UINT64) Pool->Used));
+
   if (PoolType != NULL) {
     *PoolType = Head->Type;
   }
@@ -757,12 +1014,15 @@ CoreFreePoolI (
   Index = SIZE_TO_LIST(Size);
   DEBUG_CLEAR_MEMORY (Head, Size);
 
-  //
-  // If it's not on the list, it must be pool pages
-  //
-  if (Index >= SIZE_TO_LIST (Granularity) || IsGuarded || PageAsPool) {
+  if (SlabObject) {
+    //
+    // Slab objects go back to the slab they were carved from
+    //
+    CoreFreePoolSlabI (Pool, Slab, Head, Granularity);
 
+  } else if (Index >= SIZE_TO_LIST (Granularity) || IsGuarded || PageAsPool) {
     //
+    // If it's not on the list, it must be pool pages.
     // Return the memory pages back to free memory
     //
     NoPages = EFI_SIZE_TO_PAGES (Size) + EFI_SIZE_TO_PAGES (Granularity) - 1;
@@ -27,6 +27,13 @@
   3) A support protocol is not found, and the data is not available to be read
      without it.  This results in EFI_PROTOCOL_ERROR.
 
+  Decompressed section data is kept in a reference counted cache keyed by the
+  content of the encapsulation section, so identical sections share one copy
+  and reopening a stream does not decompress the data again. The cache holds
+  at most PcdDxeCoreSectionCacheSize bytes and is disabled by default.
+  Unreferenced entries are evicted least recently used first to make room for
+  new ones, or when an allocation fails.
+
 Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -67,6 +74,31 @@ typedef struct {
   EFI_EVENT                   Event;
 } CORE_SECTION_CHILD_NODE;
 
+#define CORE_SECTION_CACHE_SIGNATURE  SIGNATURE_32('S','X','C','E')
+#define CACHE_ENTRY_FROM_LINK(Node) \
+  CR (Node, CORE_SECTION_CACHE_ENTRY, Link, CORE_SECTION_CACHE_SIGNATURE)
+
+typedef struct {
+  UINT32                      Signature;
+  //
+  // Link in mSectionCache, least recently used first.
+  //
+  LIST_ENTRY                  Link;
+  //
+  // Copy of the encapsulation section the data was extracted from. Lookups
+  // match the CRC first and then compare the whole section.
+  //
+  UINT32                      Crc32;
+  UINTN                       SourceSize;
+  VOID                        *Source;
+  VOID                        *Buffer;
+  UINTN                       BufferSize;
+  //
+  // Number of section streams using Buffer.
+  //
+  UINTN                       RefCount;
+} CORE_SECTION_CACHE_ENTRY;
+
 #define CORE_SECTION_STREAM_SIGNATURE SIGNATURE_32('S','X','S','S')
 #define STREAM_NODE_FROM_LINK(Node) \
   CR (Node, CORE_SECTION_STREAM_NODE, Link, CORE_SECTION_STREAM_SIGNATURE)
@@ -82,6 +114,10 @@ typedef struct {
   // Authentication status is from GUIDed encapsulations.
   //
   UINT32                      AuthenticationStatus;
+  //
+  // If not NULL, StreamBuffer is owned by this cache entry.
+  //
+  CORE_SECTION_CACHE_ENTRY    *CacheEntry;
 } CORE_SECTION_STREAM_NODE;
 
 #define NULL_STREAM_HANDLE    0
@@ -191,6 +227,11 @@ CustomGuidedSectionExtract (
 //
 LIST_ENTRY mStreamRoot = INITIALIZE_LIST_HEAD_VARIABLE (mStreamRoot);
 
+LIST_ENTRY mSectionCache = INITIALIZE_LIST_HEAD_VARIABLE (mSectionCache);
+UINTN      mSectionCacheSize = 0;
+UINTN      mSectionCacheHits = 0;
+UINTN      mSectionCacheMisses = 0;
+
 EFI_HANDLE mSectionExtractionHandle = NULL;
 
 EFI_GUIDED_SECTION_EXTRACTION_PROTOCOL mCustomGuidedSectionExtractionProtocol = {
@@ -243,6 +284,203 @@ InitializeSectionExtraction (
 }
 
 
+/**
+  Evict unreferenced entries from the section cache, least recently used
+  first, until the cache holds no more than Limit bytes.
+
+  @param  Limit                  The number of bytes the cache may keep.
+
+**/
+VOID
+SectionCacheTrim (
+  IN UINTN                       Limit
+  )
+{
+  LIST_ENTRY                     *Link;
+  CORE_SECTION_CACHE_ENTRY       *Entry;
+
+  Link = GetFirstNode (&mSectionCache);
+  while (!IsNull (&mSectionCache, Link) && (mSectionCacheSize > Limit)) {
+    Entry = CACHE_ENTRY_FROM_LINK (Link);
+    Link  = GetNextNode (&mSectionCache, Link);
+    if (Entry->RefCount != 0) {
+      continue;
+    }
+
+    RemoveEntryList (&Entry->Link);
+    mSectionCacheSize -= Entry->SourceSize + Entry->BufferSize;
+    CoreFreePool (Entry->Buffer);
+    CoreFreePool (Entry);
+  }
+}
+
+
+/**
+  Check if the section cache can ever hold an entry of Size bytes.
+
+  @param  Size                   The size of the encapsulation section plus
+                                 the size of the data extracted from it, if
+                                 known.
+
+  @retval TRUE                   The entry fits in PcdDxeCoreSectionCacheSize.
+  @retval FALSE                  The entry is too large, or the cache is
+                                 disabled.
+
+**/
+BOOLEAN
+SectionCacheFits (
+  IN UINTN                       Size
+  )
+{
+  return (BOOLEAN)((Size != 0) && (Size <= PcdGet32 (PcdDxeCoreSectionCacheSize)));
+}
+
+
+/**
+  Find the data extracted from an encapsulation section in the section cache
+  and take a reference to it. Callers first check with SectionCacheFits() that
+  the section could be cached, so no CRC is computed for sections that can
+  never be.
+
+  @param  Section                The encapsulation section.
+  @param  SectionSize            The size of Section in bytes.
+  @param  Crc32                  Returns the CRC of Section, to be passed to
+                                 SectionCacheInsert() on a miss.
+
+  @return The cache entry, or NULL if the data is not cached.
+
+**/
+CORE_SECTION_CACHE_ENTRY *
+SectionCacheLookup (
+  IN  VOID                       *Section,
+  IN  UINTN                      SectionSize,
+  OUT UINT32                     *Crc32
+  )
+{
+  LIST_ENTRY                     *Link;
+  CORE_SECTION_CACHE_ENTRY       *Entry;
+
+  *Crc32 = CalculateCrc32 (Section, SectionSize);
+  for (Link = GetFirstNode (&mSectionCache); !IsNull (&mSectionCache, Link); Link = GetNextNode (&mSectionCache, Link)) {
+    Entry = CACHE_ENTRY_FROM_LINK (Link);
+    if ((Entry->Crc32 == *Crc32) &&
+        (Entry->SourceSize == SectionSize) &&
+        (CompareMem (Entry->Source, Section, SectionSize) == 0)) {
+      //
+      // Move to the most recently used end
+      //
+      RemoveEntryList (&Entry->Link);
+      InsertTailList (&mSectionCache, &Entry->Link);
+      Entry->RefCount++;
+      mSectionCacheHits++;
+      return Entry;
+    }
+  }
+
+  mSectionCacheMisses++;
+  return NULL;
+}
+
+
+/**
+  Add the data extracted from an encapsulation section to the section cache,
+  with one reference held by the caller. Least recently used entries are
+  evicted to make room; if the entries still in use leave no room, the data
+  is not cached. On success the cache owns Buffer.
+
+  @param  Section                The encapsulation section.
+  @param  SectionSize            The size of Section in bytes.
+  @param  Crc32                  The CRC of Section from SectionCacheLookup().
+  @param  Buffer                 The pool buffer holding the extracted data.
+  @param  BufferSize             The size of Buffer in bytes.
+
+  @return The cache entry, or NULL if the data was not added to the cache.
+
+**/
+CORE_SECTION_CACHE_ENTRY *
+SectionCacheInsert (
+  IN VOID                        *Section,
+  IN UINTN                       SectionSize,
+  IN UINT32                      Crc32,
+  IN VOID                        *Buffer,
+  IN UINTN                       BufferSize
+  )
+{
+  CORE_SECTION_CACHE_ENTRY       *Entry;
+  UINTN                          Size;
+  UINTN                          Limit;
+
+  Size  = SectionSize + BufferSize;
+  Limit = PcdGet32 (PcdDxeCoreSectionCacheSize);
+  if (!SectionCacheFits (Size)) {
+    return NULL;
+  }
+
+  SectionCacheTrim (Limit - Size);
+  if (mSectionCacheSize + Size > Limit) {
+    return NULL;
+  }
+
+  Entry = AllocatePool (sizeof (CORE_SECTION_CACHE_ENTRY) + SectionSize);
+  if (Entry == NULL) {
+    return NULL;
+  }
+
+  Entry->Signature  = CORE_SECTION_CACHE_SIGNATURE;
+  Entry->Crc32      = Crc32;
+  Entry->SourceSize = SectionSize;
+  Entry->Source     = Entry + 1;
+  Entry->Buffer     = Buffer;
+  Entry->BufferSize = BufferSize;
+  Entry->RefCount   = 1;
+  CopyMem (Entry->Source, Section, SectionSize);
+
+  InsertTailList (&mSectionCache, &Entry->Link);
+  mSectionCacheSize += Size;
+
+  return Entry;
+}
+
+
+/**
+  Drop a reference to a section cache entry. The data stays cached until it
+  is evicted.
+
+  @param  Entry                  The cache entry.
+
+**/
+VOID
+SectionCacheRelease (
+  IN CORE_SECTION_CACHE_ENTRY    *Entry
+  )
+{
+  ASSERT (Entry->RefCount > 0);
+  Entry->RefCount--;
+  if (Entry->RefCount == 0) {
+    SectionCacheTrim (PcdGet32 (PcdDxeCoreSectionCacheSize));
+  }
+}
+
+
+/**
+  Print the decompressed section cache counters.
+
+**/
+VOID
+SectionCacheDumpStatistics (
+  VOID
+  )
+{
+  DEBUG ((
+    DEBUG_VERBOSE,
+    "SectionCache: %d hits, %d misses, %d bytes cached\n",
+    mSectionCacheHits,
+    mSectionCacheMisses,
+    mSectionCacheSize
+    ));
+}
+
+
 /**
   Check if a stream is valid.
 
@@ -387,6 +625,7 @@ OpenSectionStreamEx (
   NewStream->StreamLength = SectionStreamLength;
   InitializeListHead (&NewStream->Children);
   NewStream->AuthenticationStatus = AuthenticationStatus;
+  NewStream->CacheEntry = NULL;
 
   //
   // Add new stream to stream list
@@ -685,6 +924,9 @@ CreateChildNode (
   UINT32                                       UncompressedLength;
   UINT8                                        CompressionType;
   UINT16                                       GuidedSectionAttributes;
+  CORE_SECTION_CACHE_ENTRY                     *CacheEntry;
+  BOOLEAN                                      Cacheable;
+  UINT32                                       Crc32;
 
   CORE_SECTION_CHILD_NODE                      *Node;
 
@@ -712,6 +954,8 @@ CreateChildNode (
   Node->OffsetInStream = ChildOffset;
   Node->EncapsulatedStreamHandle = NULL_STREAM_HANDLE;
   Node->EncapsulationGuid = NULL;
+  CacheEntry = NULL;
+  Crc32 = 0;
 
   //
   // If it's an encapsulating section, then create the new section stream also
@@ -743,9 +987,25 @@ CreateChildNode (
       //
       // Allocate space for the new stream
       //
-      if (UncompressedLength > 0) {
+      Cacheable = (BOOLEAN)((CompressionType == EFI_STANDARD_COMPRESSION) &&
+                            SectionCacheFits (Node->Size + UncompressedLength));
+      if (Cacheable) {
+        CacheEntry = SectionCacheLookup (SectionHeader, Node->Size, &Crc32);
+      }
+
+      if (CacheEntry != NULL) {
+        NewStreamBuffer = CacheEntry->Buffer;
+        NewStreamBufferSize = CacheEntry->BufferSize;
+      } else if (UncompressedLength > 0) {
         NewStreamBufferSize = UncompressedLength;
         NewStreamBuffer = AllocatePool (NewStreamBufferSize);
+        if ((NewStreamBuffer == NULL) && (mSectionCacheSize > 0)) {
+          //
+          // Give the memory held by unused cache entries back and retry
+          //
+          SectionCacheTrim (0);
+          NewStreamBuffer = AllocatePool (NewStreamBufferSize);
+        }
         if (NewStreamBuffer == NULL) {
           CoreFreePool (Node);
           return EFI_OUT_OF_RESOURCES;
@@ -791,6 +1051,7 @@ CreateChildNode (
             return EFI_OUT_OF_RESOURCES;
           }
 
+          PERF_INMODULE_BEGIN ("DecodeSection");
           Status = Decompress->Decompress (
                                  Decompress,
                                  CompressionSource,
@@ -800,12 +1061,23 @@ CreateChildNode (
                                  ScratchBuffer,
                                  ScratchSize
                                  );
+          PERF_INMODULE_END ("DecodeSection");
           CoreFreePool (ScratchBuffer);
           if (EFI_ERROR (Status)) {
             CoreFreePool (Node);
             CoreFreePool (NewStreamBuffer);
             return Status;
           }
+
+          if (Cacheable) {
+            CacheEntry = SectionCacheInsert (
+                           SectionHeader,
+                           Node->Size,
+                           Crc32,
+                           NewStreamBuffer,
+                           NewStreamBufferSize
+                           );
+          }
         }
       } else {
         NewStreamBuffer = NULL;
@@ -821,9 +1093,17 @@ CreateChildNode (
                  );
       if (EFI_ERROR (Status)) {
         CoreFreePool (Node);
-        CoreFreePool (NewStreamBuffer);
+        if (CacheEntry != NULL) {
+          SectionCacheRelease (CacheEntry);
+        } else if (NewStreamBuffer != NULL) {
+          CoreFreePool (NewStreamBuffer);
+        }
         return Status;
       }
+      //
+      // The new stream borrows the cached data; closing it drops the reference.
+      //
+      ((CORE_SECTION_STREAM_NODE *) Node->EncapsulatedStreamHandle)->CacheEntry = CacheEntry;
       break;
 
     case EFI_SECTION_GUID_DEFINED:
@@ -837,19 +1117,62 @@ CreateChildNode (
       }
       if (VerifyGuidedSectionGuid (Node->EncapsulationGuid, &GuidedExtraction)) {
         //
-        // NewStreamBuffer is always allocated by ExtractSection... No caller
-        // allocation here.
+        // Only sections that contribute no authentication status are cached,
+        // as their stream status is inherited from the parent below. The size
+        // of the extracted data is not known yet, so only the section itself
+        // is checked against the cache size here.
         //
-        Status = GuidedExtraction->ExtractSection (
-                                     GuidedExtraction,
-                                     GuidedHeader,
-                                     &NewStreamBuffer,
-                                     &NewStreamBufferSize,
-                                     &AuthenticationStatus
-                                     );
-        if (EFI_ERROR (Status)) {
-          CoreFreePool (*ChildNode);
-          return EFI_PROTOCOL_ERROR;
+        Cacheable = (BOOLEAN)(((GuidedSectionAttributes & EFI_GUIDED_SECTION_AUTH_STATUS_VALID) == 0) &&
+                              SectionCacheFits (Node->Size));
+        if (Cacheable) {
+          CacheEntry = SectionCacheLookup (SectionHeader, Node->Size, &Crc32);
+        }
+
+        if (CacheEntry != NULL) {
+          NewStreamBuffer = CacheEntry->Buffer;
+          NewStreamBufferSize = CacheEntry->BufferSize;
+          AuthenticationStatus = 0;
+        } else {
+          //
+          // NewStreamBuffer is always allocated by ExtractSection... No caller
+          // allocation here.
+          //
+          PERF_INMODULE_BEGIN ("DecodeSection");
+          Status = GuidedExtraction->ExtractSection (
+                                       GuidedExtraction,
+                                       GuidedHeader,
+                                       &NewStreamBuffer,
+                                       &NewStreamBufferSize,
+                                       &AuthenticationStatus
+                                       );
+          if ((Status == EFI_OUT_OF_RESOURCES) && (mSectionCacheSize > 0)) {
+            //
+            // Give the memory held by unused cache entries back and retry
+            //
+            SectionCacheTrim (0);
+            Status = GuidedExtraction->ExtractSection (
+                                         GuidedExtraction,
+                                         GuidedHeader,
+                                         &NewStreamBuffer,
+                                         &NewStreamBufferSize,
+                                         &AuthenticationStatus
+                                         );
+          }
+          PERF_INMODULE_END ("DecodeSection");
+          if (EFI_ERROR (Status)) {
+            CoreFreePool (*ChildNode);
+            return EFI_PROTOCOL_ERROR;
+          }
+
+          if (Cacheable) {
+            CacheEntry = SectionCacheInsert (
+                           SectionHeader,
+                           Node->Size,
+                           Crc32,
+                           NewStreamBuffer,
+                           NewStreamBufferSize
+                           );
+          }
         }
 
         //
@@ -878,9 +1201,14 @@ CreateChildNode (
                    );
         if (EFI_ERROR (Status)) {
           CoreFreePool (*ChildNode);
-          CoreFreePool (NewStreamBuffer);
+          if (CacheEntry != NULL) {
+            SectionCacheRelease (CacheEntry);
+          } else {
+            CoreFreePool (NewStreamBuffer);
+          }
           return Status;
         }
+        ((CORE_SECTION_STREAM_NODE *) Node->EncapsulatedStreamHandle)->CacheEntry = CacheEntry;
       } else {
         //
         // There's no GUIDed section extraction protocol available.
@@ -1434,7 +1762,9 @@ CloseSectionStream (
       ChildNode = CHILD_SECTION_NODE_FROM_LINK (Link);
       FreeChildNode (ChildNode);
     }
-    if (FreeStreamBuffer) {
+    if (StreamNode->CacheEntry != NULL) {
+      SectionCacheRelease (StreamNode->CacheEntry);
+    } else if (FreeStreamBuffer) {
       CoreFreePool (StreamNode->StreamBuffer);
     }
     CoreFreePool (StreamNode);
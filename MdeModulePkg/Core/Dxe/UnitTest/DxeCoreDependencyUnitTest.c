@@ -0,0 +1,619 @@
+/** @file
+  Host-based unit tests of the DXE Core dependency evaluator.
+
+  Random dependency expressions, well-formed and malformed, are evaluated
+  with the compiled evaluator of Dependency.c against random sets of
+  installed protocols, and checked against the POSTFIX interpreter it
+  replaced for the same expression and protocols. The tests also check the
+  handling of BEFORE, AFTER and SOR, and that both evaluators keep a PUSH
+  TRUE once its protocol was found, even after the protocol is uninstalled.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeCoreUnitTest.h"
+
+#define UNIT_TEST_APP_NAME          "DXE Core Dependency Unit Tests"
+#define UNIT_TEST_APP_VERSION       "1.0"
+
+#define DEPEX_TEST_GUIDS            8
+#define DEPEX_TEST_EXPRESSIONS      20000
+#define DEPEX_TEST_SETS             16
+#define DEPEX_TEST_MAX_TREE_DEPTH   6
+#define DEPEX_TEST_MAX_SIZE         2048
+
+//
+// The size of the reverse map in Dependency.c.
+//
+#define DEPEX_TEST_HASH_BUCKETS     64
+
+extern DEPEX_GUID_REFERENCE  *mDepexGuidHashTable[DEPEX_TEST_HASH_BUCKETS];
+
+STATIC EFI_GUID  mGuids[DEPEX_TEST_GUIDS];
+
+//
+// Bit N is set if mGuids[N] is installed.
+//
+STATIC UINT32    mInstalled;
+
+/**
+  Returns the first instance of a protocol in the test set of installed
+  protocols.
+
+  @param  Protocol               The protocol to search for
+  @param  Registration           Unused.
+  @param  Interface              Return the Protocol interface (instance).
+
+  @retval EFI_SUCCESS            If a valid Interface is returned
+  @retval EFI_NOT_FOUND          Protocol interface not found
+
+**/
+EFI_STATUS
+EFIAPI
+CoreLocateProtocol (
+  IN  EFI_GUID  *Protocol,
+  IN  VOID      *Registration OPTIONAL,
+  OUT VOID      **Interface
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < DEPEX_TEST_GUIDS; Index++) {
+    if (((mInstalled & (1U << Index)) != 0) && CompareGuid (Protocol, &mGuids[Index])) {
+      *Interface = &mGuids[Index];
+      return EFI_SUCCESS;
+    }
+  }
+
+  *Interface = NULL;
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Return TRUE if all AP services are available. The tests always give the
+  drivers a Depex.
+
+  @retval EFI_NOT_FOUND  At least one AP service is not available
+
+**/
+EFI_STATUS
+CoreAllEfiServicesAvailable (
+  VOID
+  )
+{
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Appends a random well-formed postfix expression to Buffer.
+
+  @param[in, out]  Seed      The state of the pseudo random sequence.
+  @param[out]      Buffer    The expression buffer.
+  @param[in, out]  Size      The size of the expression in Buffer.
+  @param[in]       Depth     The remaining depth of the expression tree.
+
+**/
+STATIC
+VOID
+DepexTestAppendExpression (
+  IN OUT UINT32  *Seed,
+  OUT    UINT8   *Buffer,
+  IN OUT UINTN   *Size,
+  IN     UINTN   Depth
+  )
+{
+  UINT32  Choice;
+
+  Choice = DxeCoreUnitTestRandom (Seed) % ((Depth == 0) ? 4 : 8);
+  switch (Choice) {
+    case 0:
+    case 1:
+      Buffer[(*Size)++] = EFI_DEP_PUSH;
+      CopyGuid ((EFI_GUID *)&Buffer[*Size], &mGuids[DxeCoreUnitTestRandom (Seed) % DEPEX_TEST_GUIDS]);
+      *Size += sizeof (EFI_GUID);
+      break;
+
+    case 2:
+      //
+      // Mostly TRUE or FALSE, sometimes a PUSH the interpreter has already
+      // replaced with EFI_DEP_REPLACE_TRUE.
+      //
+      if (DxeCoreUnitTestRandom (Seed) % 4 == 0) {
+        Buffer[(*Size)++] = EFI_DEP_REPLACE_TRUE;
+        CopyGuid ((EFI_GUID *)&Buffer[*Size], &mGuids[DxeCoreUnitTestRandom (Seed) % DEPEX_TEST_GUIDS]);
+        *Size += sizeof (EFI_GUID);
+      } else {
+        Buffer[(*Size)++] = EFI_DEP_TRUE;
+      }
+
+      break;
+
+    case 3:
+      Buffer[(*Size)++] = EFI_DEP_FALSE;
+      break;
+
+    case 4:
+      DepexTestAppendExpression (Seed, Buffer, Size, Depth - 1);
+      Buffer[(*Size)++] = EFI_DEP_NOT;
+      break;
+
+    default:
+      DepexTestAppendExpression (Seed, Buffer, Size, Depth - 1);
+      DepexTestAppendExpression (Seed, Buffer, Size, Depth - 1);
+      Buffer[(*Size)++] = (UINT8)((Choice & 1) ? EFI_DEP_AND : EFI_DEP_OR);
+      break;
+  }
+}
+
+/**
+  Builds a random dependency expression. About one in four is malformed: an
+  opcode is replaced, or the expression is truncated. BEFORE and AFTER are
+  only valid as the first opcode and are tested separately.
+
+  @param[in, out]  Seed      The state of the pseudo random sequence.
+  @param[out]      Buffer    The expression buffer.
+
+  @return The size of the expression.
+
+**/
+STATIC
+UINTN
+DepexTestBuildExpression (
+  IN OUT UINT32  *Seed,
+  OUT    UINT8   *Buffer
+  )
+{
+  STATIC CONST UINT8  BadOpcodes[] = { EFI_DEP_AND, EFI_DEP_OR, EFI_DEP_NOT, EFI_DEP_SOR, EFI_DEP_END, 0x42 };
+  UINTN               Size;
+  UINTN               Index;
+
+  Size = 0;
+  if (DxeCoreUnitTestRandom (Seed) % 4 == 0) {
+    Buffer[Size++] = EFI_DEP_SOR;
+  }
+
+  DepexTestAppendExpression (Seed, Buffer, &Size, DxeCoreUnitTestRandom (Seed) % (DEPEX_TEST_MAX_TREE_DEPTH + 1));
+  Buffer[Size++] = EFI_DEP_END;
+  ASSERT (Size <= DEPEX_TEST_MAX_SIZE);
+
+  switch (DxeCoreUnitTestRandom (Seed) % 8) {
+    case 0:
+      //
+      // Replace an opcode other than PUSH, so the GUIDs are never read as
+      // opcodes: the interpreter asserts on a BEFORE or AFTER that is not
+      // the first opcode.
+      //
+      for (Index = 0; ; ) {
+        if ((Buffer[Index] == EFI_DEP_PUSH) || (Buffer[Index] == EFI_DEP_REPLACE_TRUE)) {
+          Index += sizeof (EFI_GUID);
+        } else if (DxeCoreUnitTestRandom (Seed) % 4 == 0) {
+          Buffer[Index] = BadOpcodes[DxeCoreUnitTestRandom (Seed) % ARRAY_SIZE (BadOpcodes)];
+          break;
+        }
+
+        Index = (Index + 1) % Size;
+      }
+
+      break;
+
+    case 1:
+      Size = 1 + DxeCoreUnitTestRandom (Seed) % Size;
+      break;
+
+    default:
+      break;
+  }
+
+  return Size;
+}
+
+/**
+  Initializes a driver entry with a copy of a dependency expression and
+  preprocesses it, compiling it when it can be compiled.
+
+  @param[out]  DriverEntry   The driver entry to initialize.
+  @param[in]   Depex         The dependency expression.
+  @param[in]   DepexSize     The size of the dependency expression.
+
+**/
+STATIC
+VOID
+DepexTestInitDriver (
+  OUT EFI_CORE_DRIVER_ENTRY  *DriverEntry,
+  IN  CONST UINT8            *Depex,
+  IN  UINTN                  DepexSize
+  )
+{
+  ZeroMem (DriverEntry, sizeof (*DriverEntry));
+  DriverEntry->Signature = EFI_CORE_DRIVER_ENTRY_SIGNATURE;
+  DriverEntry->Depex     = AllocateCopyPool (DepexSize, Depex);
+  DriverEntry->DepexSize = DepexSize;
+  ASSERT (DriverEntry->Depex != NULL);
+  CorePreProcessDepex (DriverEntry);
+}
+
+/**
+  Releases the Depex and the compiled program of a driver entry.
+
+  @param[in, out]  DriverEntry   The driver entry.
+
+**/
+STATIC
+VOID
+DepexTestFreeDriver (
+  IN OUT EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  if (DriverEntry->DepexGuids != NULL) {
+    FreePool (DriverEntry->DepexGuids);
+  }
+
+  FreePool (DriverEntry->Depex);
+  ZeroMem (DriverEntry, sizeof (*DriverEntry));
+}
+
+/**
+  Initializes a driver entry with a copy of a dependency expression that is
+  left to the interpreter. The interpreter rewrites the copy as it finds
+  protocols, so the entry is kept for all the evaluations of the expression,
+  as the dispatcher keeps the Depex of a driver.
+
+  @param[out]  DriverEntry   The driver entry to initialize.
+  @param[in]   Depex         The dependency expression.
+  @param[in]   DepexSize     The size of the dependency expression.
+
+**/
+STATIC
+VOID
+DepexTestInitInterpreted (
+  OUT EFI_CORE_DRIVER_ENTRY  *DriverEntry,
+  IN  CONST UINT8            *Depex,
+  IN  UINTN                  DepexSize
+  )
+{
+  ZeroMem (DriverEntry, sizeof (*DriverEntry));
+  DriverEntry->Signature = EFI_CORE_DRIVER_ENTRY_SIGNATURE;
+  DriverEntry->Depex     = AllocateCopyPool (DepexSize, Depex);
+  DriverEntry->DepexSize = DepexSize;
+  ASSERT (DriverEntry->Depex != NULL);
+}
+
+/**
+  Creates the protocol GUIDs and empties the reverse map before each test.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED    Always.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DepexTestPrerequisite (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32  Seed;
+  UINTN   Index;
+
+  Seed = 0x2545F491;
+  for (Index = 0; Index < DEPEX_TEST_GUIDS; Index++) {
+    mGuids[Index].Data1 = DxeCoreUnitTestRandom (&Seed);
+    mGuids[Index].Data2 = (UINT16)DxeCoreUnitTestRandom (&Seed);
+    mGuids[Index].Data3 = (UINT16)Index;
+    WriteUnaligned64 ((UINT64 *)mGuids[Index].Data4, LShiftU64 (DxeCoreUnitTestRandom (&Seed), 32) | DxeCoreUnitTestRandom (&Seed));
+  }
+
+  mInstalled = 0;
+  ZeroMem (mDepexGuidHashTable, sizeof (mDepexGuidHashTable));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that the compiled evaluator returns what the interpreter returns
+  for random expressions of PUSH, AND, OR, NOT, TRUE, FALSE and SOR, on
+  random sets of installed protocols. The same driver entries are evaluated
+  for every set, so protocols are both installed and uninstalled between
+  their evaluations, and the interpreter runs on the Depex it rewrote in the
+  earlier evaluations.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             Both evaluators agreed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The evaluators returned different
+                                        results.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DepexTestCompiledMatchesInterpreter (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC UINT8           Depex[DEPEX_TEST_MAX_SIZE];
+  EFI_CORE_DRIVER_ENTRY  DriverEntry;
+  EFI_CORE_DRIVER_ENTRY  Interpreted;
+  UINTN                  DepexSize;
+  UINT32                 Seed;
+  UINTN                  Expression;
+  UINTN                  Set;
+  UINTN                  CompiledCount;
+  UINTN                  InterpretedCount;
+
+  CompiledCount    = 0;
+  InterpretedCount = 0;
+  Seed        = 0x3C6EF372;
+  for (Expression = 0; Expression < DEPEX_TEST_EXPRESSIONS; Expression++) {
+    DepexSize = DepexTestBuildExpression (&Seed, Depex);
+    DepexTestInitDriver (&DriverEntry, Depex, DepexSize);
+    DepexTestInitInterpreted (&Interpreted, Depex, DepexSize);
+    UT_ASSERT_FALSE (DriverEntry.Before || DriverEntry.After);
+    UT_ASSERT_EQUAL (DriverEntry.Unrequested, Depex[0] == EFI_DEP_SOR);
+    if (DriverEntry.DepexProgram != NULL) {
+      CompiledCount++;
+    } else {
+      InterpretedCount++;
+    }
+
+    for (Set = 0; Set < DEPEX_TEST_SETS; Set++) {
+      mInstalled = DxeCoreUnitTestRandom (&Seed) & ((1U << DEPEX_TEST_GUIDS) - 1);
+      UT_ASSERT_EQUAL (CoreIsSchedulable (&DriverEntry), CoreIsSchedulable (&Interpreted));
+    }
+
+    DepexTestFreeDriver (&DriverEntry);
+    DepexTestFreeDriver (&Interpreted);
+    ZeroMem (mDepexGuidHashTable, sizeof (mDepexGuidHashTable));
+  }
+
+  UT_LOG_INFO (
+    "%u expressions: %u compiled, %u interpreted\n",
+    DEPEX_TEST_EXPRESSIONS,
+    (UINT32)CompiledCount,
+    (UINT32)InterpretedCount
+    );
+  UT_ASSERT_NOT_EQUAL (CompiledCount, 0);
+  UT_ASSERT_NOT_EQUAL (InterpretedCount, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that BEFORE and AFTER are not compiled, are left to the dispatcher
+  and record the GUID they refer to.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             BEFORE and AFTER were preprocessed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  BEFORE or AFTER was mishandled.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DepexTestBeforeAfter (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8                  Depex[2 + sizeof (EFI_GUID)];
+  EFI_CORE_DRIVER_ENTRY  DriverEntry;
+  UINTN                  Opcode;
+
+  for (Opcode = EFI_DEP_BEFORE; Opcode <= EFI_DEP_AFTER; Opcode++) {
+    Depex[0] = (UINT8)Opcode;
+    CopyGuid ((EFI_GUID *)&Depex[1], &mGuids[Opcode]);
+    Depex[1 + sizeof (EFI_GUID)] = EFI_DEP_END;
+
+    DepexTestInitDriver (&DriverEntry, Depex, sizeof (Depex));
+    UT_ASSERT_EQUAL (DriverEntry.Before, Opcode == EFI_DEP_BEFORE);
+    UT_ASSERT_EQUAL (DriverEntry.After, Opcode == EFI_DEP_AFTER);
+    UT_ASSERT_TRUE (DriverEntry.Dependent);
+    UT_ASSERT_EQUAL (DriverEntry.DepexProgram, NULL);
+    UT_ASSERT_TRUE (CompareGuid (&DriverEntry.BeforeAfterGuid, &mGuids[Opcode]));
+
+    mInstalled = (1U << DEPEX_TEST_GUIDS) - 1;
+    UT_ASSERT_FALSE (CoreIsSchedulable (&DriverEntry));
+    DepexTestFreeDriver (&DriverEntry);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that a protocol install only invalidates the drivers with a compiled
+  Depex that pushes the protocol.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The right drivers were invalidated.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A driver was missed or invalidated
+                                        for nothing.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DepexTestNotify (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8                  Depex[2 * (1 + sizeof (EFI_GUID)) + 2];
+  EFI_CORE_DRIVER_ENTRY  DriverEntries[DEPEX_TEST_GUIDS];
+  UINTN                  Index;
+  UINTN                  Installed;
+
+  //
+  // Driver N pushes the protocols N and N + 1.
+  //
+  for (Index = 0; Index < DEPEX_TEST_GUIDS; Index++) {
+    Depex[0] = EFI_DEP_PUSH;
+    CopyGuid ((EFI_GUID *)&Depex[1], &mGuids[Index]);
+    Depex[1 + sizeof (EFI_GUID)] = EFI_DEP_PUSH;
+    CopyGuid ((EFI_GUID *)&Depex[2 + sizeof (EFI_GUID)], &mGuids[(Index + 1) % DEPEX_TEST_GUIDS]);
+    Depex[2 * (1 + sizeof (EFI_GUID))]     = EFI_DEP_AND;
+    Depex[2 * (1 + sizeof (EFI_GUID)) + 1] = EFI_DEP_END;
+    DepexTestInitDriver (&DriverEntries[Index], Depex, sizeof (Depex));
+    UT_ASSERT_NOT_NULL (DriverEntries[Index].DepexProgram);
+  }
+
+  for (Installed = 0; Installed < DEPEX_TEST_GUIDS; Installed++) {
+    for (Index = 0; Index < DEPEX_TEST_GUIDS; Index++) {
+      DriverEntries[Index].DepexEvaluated = TRUE;
+    }
+
+    CoreNotifyDepexProtocolInstalled (&mGuids[Installed]);
+    for (Index = 0; Index < DEPEX_TEST_GUIDS; Index++) {
+      UT_ASSERT_EQUAL (
+        DriverEntries[Index].DepexEvaluated,
+        (Index != Installed) && ((Index + 1) % DEPEX_TEST_GUIDS != Installed)
+        );
+    }
+  }
+
+  for (Index = 0; Index < DEPEX_TEST_GUIDS; Index++) {
+    DepexTestFreeDriver (&DriverEntries[Index]);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that both evaluators keep a protocol that was found as installed
+  after it is uninstalled: a driver held back by another protocol is
+  scheduled once that protocol is installed, and NOT PUSH stays FALSE.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             Both evaluators kept the protocol.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  An evaluator lost the protocol.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DepexTestUninstall (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8                  Depex[4 + 2 * sizeof (EFI_GUID)];
+  EFI_CORE_DRIVER_ENTRY  Compiled[2];
+  EFI_CORE_DRIVER_ENTRY  Interpreted[2];
+  UINTN                  Index;
+
+  //
+  // Entry 0 is PUSH 0 PUSH 1 AND, entry 1 is PUSH 0 NOT.
+  //
+  Depex[0] = EFI_DEP_PUSH;
+  CopyGuid ((EFI_GUID *)&Depex[1], &mGuids[0]);
+  Depex[1 + sizeof (EFI_GUID)] = EFI_DEP_PUSH;
+  CopyGuid ((EFI_GUID *)&Depex[2 + sizeof (EFI_GUID)], &mGuids[1]);
+  Depex[2 + 2 * sizeof (EFI_GUID)] = EFI_DEP_AND;
+  Depex[3 + 2 * sizeof (EFI_GUID)] = EFI_DEP_END;
+  DepexTestInitDriver (&Compiled[0], Depex, sizeof (Depex));
+  DepexTestInitInterpreted (&Interpreted[0], Depex, sizeof (Depex));
+
+  Depex[1 + sizeof (EFI_GUID)] = EFI_DEP_NOT;
+  Depex[2 + sizeof (EFI_GUID)] = EFI_DEP_END;
+  DepexTestInitDriver (&Compiled[1], Depex, 3 + sizeof (EFI_GUID));
+  DepexTestInitInterpreted (&Interpreted[1], Depex, 3 + sizeof (EFI_GUID));
+
+  UT_ASSERT_NOT_NULL (Compiled[0].DepexProgram);
+  UT_ASSERT_NOT_NULL (Compiled[1].DepexProgram);
+
+  //
+  // Protocol 0 is installed, the first driver is held back by protocol 1.
+  //
+  mInstalled = BIT0;
+  for (Index = 0; Index < 2; Index++) {
+    UT_ASSERT_FALSE (CoreIsSchedulable (&Compiled[Index]));
+    UT_ASSERT_FALSE (CoreIsSchedulable (&Interpreted[Index]));
+  }
+
+  //
+  // Protocol 0 is uninstalled, then protocol 1 is installed.
+  //
+  mInstalled = 0;
+  for (Index = 0; Index < 2; Index++) {
+    UT_ASSERT_FALSE (CoreIsSchedulable (&Compiled[Index]));
+    UT_ASSERT_FALSE (CoreIsSchedulable (&Interpreted[Index]));
+  }
+
+  mInstalled = BIT1;
+  Compiled[0].DepexEvaluated = TRUE;
+  CoreNotifyDepexProtocolInstalled (&mGuids[1]);
+  UT_ASSERT_FALSE (Compiled[0].DepexEvaluated);
+  UT_ASSERT_TRUE (CoreIsSchedulable (&Compiled[0]));
+  UT_ASSERT_TRUE (CoreIsSchedulable (&Interpreted[0]));
+  UT_ASSERT_FALSE (CoreIsSchedulable (&Compiled[1]));
+  UT_ASSERT_FALSE (CoreIsSchedulable (&Interpreted[1]));
+
+  for (Index = 0; Index < 2; Index++) {
+    DepexTestFreeDriver (&Compiled[Index]);
+    DepexTestFreeDriver (&Interpreted[Index]);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialze the unit test framework, suite, and unit tests for the
+  dependency evaluator and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      DepexTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&DepexTests, Framework, "DXE Core Dependency Tests", "DxeCore.Dependency", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for DepexTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite--------Description------------------------------------------------Name-----------------Function------------------------------Pre--------------------Post---Context-----------
+  //
+  AddTestCase (DepexTests, "The compiled evaluator matches the interpreter",          "CompiledMatches",   DepexTestCompiledMatchesInterpreter, DepexTestPrerequisite, NULL, NULL);
+  AddTestCase (DepexTests, "BEFORE and AFTER are left to the dispatcher",             "BeforeAfter",       DepexTestBeforeAfter,                DepexTestPrerequisite, NULL, NULL);
+  AddTestCase (DepexTests, "A protocol install invalidates the drivers that push it", "Notify",            DepexTestNotify,                     DepexTestPrerequisite, NULL, NULL);
+  AddTestCase (DepexTests, "A protocol found stays found after an uninstall",         "Uninstall",         DepexTestUninstall,                  DepexTestPrerequisite, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int argc,
+  char *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -0,0 +1,686 @@
+/** @file
+  Host-based unit tests of the DXE Core handle database.
+
+  A handle database of several thousand handles, each carrying a few of
+  several hundred protocols, is built with the real Handle.c. The tests check
+  that protocol lookups and handle validation through the hash tables return
+  what the linear walks of mProtocolDatabase and gHandleList they replaced
+  return, that the hash tables follow installs and uninstalls, and compare the
+  cost of both.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeCoreUnitTest.h"
+#include "Hand/Handle.h"
+
+#define UNIT_TEST_APP_NAME          "DXE Core Handle Unit Tests"
+#define UNIT_TEST_APP_VERSION       "1.0"
+
+#define HANDLE_TEST_HANDLES         4096
+#define HANDLE_TEST_PROTOCOLS       512
+#define HANDLE_TEST_PER_HANDLE      8
+#define HANDLE_BENCHMARK_LOOKUPS    1000000
+
+//
+// The sizes of the hash tables in Handle.c.
+//
+#define HANDLE_TEST_PROTOCOL_BUCKETS  128
+#define HANDLE_TEST_HANDLE_BUCKETS    512
+
+typedef struct {
+  EFI_HANDLE  Handle;
+  UINTN       Count;
+  UINT16      Protocols[HANDLE_TEST_PER_HANDLE];
+} HANDLE_TEST_SLOT;
+
+STATIC HANDLE_TEST_SLOT  mSlots[HANDLE_TEST_HANDLES];
+STATIC EFI_GUID          mProtocols[HANDLE_TEST_PROTOCOLS];
+
+extern LIST_ENTRY      mProtocolDatabase;
+extern PROTOCOL_ENTRY  *mProtocolHashTable[HANDLE_TEST_PROTOCOL_BUCKETS];
+extern IHANDLE         *mHandleHashTable[HANDLE_TEST_HANDLE_BUCKETS];
+
+/**
+  Frees pool memory allocated by the host MemoryAllocationLib, which serves
+  the AllocatePool() calls of Handle.c in this test.
+
+  @param  Buffer                 The allocated pool entry to free
+
+  @retval EFI_SUCCESS            Pool successfully freed.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreFreePool (
+  IN VOID  *Buffer
+  )
+{
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+/**
+  Connects a controller to a driver. No driver is loaded in this test.
+
+  @param  ControllerHandle                      Handle of the controller.
+  @param  DriverImageHandle                     Ordered list of driver images.
+  @param  RemainingDevicePath                   The remaining device path.
+  @param  Recursive                             Connect child controllers.
+
+  @retval EFI_NOT_FOUND                         No driver was connected.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreConnectController (
+  IN  EFI_HANDLE                ControllerHandle,
+  IN  EFI_HANDLE                *DriverImageHandle    OPTIONAL,
+  IN  EFI_DEVICE_PATH_PROTOCOL  *RemainingDevicePath  OPTIONAL,
+  IN  BOOLEAN                   Recursive
+  )
+{
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Disconnects a controller from its drivers. No driver is loaded in this test.
+
+  @param  ControllerHandle                      Handle of the controller.
+  @param  DriverImageHandle                     The driver to disconnect.
+  @param  ChildHandle                           The child to destroy.
+
+  @retval EFI_SUCCESS                           No driver was connected.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreDisconnectController (
+  IN  EFI_HANDLE  ControllerHandle,
+  IN  EFI_HANDLE  DriverImageHandle  OPTIONAL,
+  IN  EFI_HANDLE  ChildHandle        OPTIONAL
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Locates the handle that supports a device path. The test installs no
+  device paths.
+
+  @param  Protocol              The protocol to search for.
+  @param  DevicePath            The device path.
+  @param  Device                The handle of the device.
+
+  @retval EFI_NOT_FOUND         No handle supports the device path.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreLocateDevicePath (
+  IN     EFI_GUID                  *Protocol,
+  IN OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath,
+  OUT    EFI_HANDLE                *Device
+  )
+{
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Determines if a device path node is an end node of an entire device path.
+  Handle.c only calls it to validate device paths being installed, which the
+  test doesn't install, so DevicePathLib isn't linked.
+
+  @param  Node      A pointer to a device path node data structure.
+
+  @retval TRUE      The device path node is the end of the device path.
+  @retval FALSE     The device path node is not the end of the device path.
+
+**/
+BOOLEAN
+EFIAPI
+IsDevicePathEnd (
+  IN CONST VOID  *Node
+  )
+{
+  CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath;
+
+  DevicePath = Node;
+  return (BOOLEAN)((DevicePath->Type == END_DEVICE_PATH_TYPE) &&
+                   (DevicePath->SubType == END_ENTIRE_DEVICE_PATH_SUBTYPE));
+}
+
+/**
+  Tells the dispatcher that a protocol was installed. There is no dispatcher
+  in this test.
+
+  @param  Protocol              The protocol that was installed.
+
+**/
+VOID
+CoreNotifyDepexProtocolInstalled (
+  IN  EFI_GUID  *Protocol
+  )
+{
+}
+
+/**
+  Signals the notification events of a protocol entry. The test registers no
+  protocol notifications.
+
+  @param  ProtEntry             The protocol entry.
+
+**/
+VOID
+CoreNotifyProtocolEntry (
+  IN PROTOCOL_ENTRY  *ProtEntry
+  )
+{
+}
+
+/**
+  Removes a protocol interface from its protocol entry.
+
+  @param  Handle                Handle of the interface.
+  @param  Protocol              The protocol of the interface.
+  @param  Interface             The interface to remove.
+
+  @return The protocol interface removed, or NULL if it was not found.
+
+**/
+PROTOCOL_INTERFACE *
+CoreRemoveInterfaceFromProtocol (
+  IN IHANDLE   *Handle,
+  IN EFI_GUID  *Protocol,
+  IN VOID      *Interface
+  )
+{
+  PROTOCOL_INTERFACE  *Prot;
+
+  Prot = CoreFindProtocolInterface (Handle, Protocol, Interface);
+  if (Prot != NULL) {
+    RemoveEntryList (&Prot->ByProtocol);
+  }
+
+  return Prot;
+}
+
+/**
+  Returns the interface installed for a protocol of a handle in this test.
+
+  @param[in]  Slot        The handle.
+  @param[in]  Protocol    The index of the protocol.
+
+  @return The interface.
+
+**/
+STATIC
+VOID *
+HandleTestInterface (
+  IN UINTN  Slot,
+  IN UINTN  Protocol
+  )
+{
+  return (VOID *)(UINTN)((Slot + 1) * HANDLE_TEST_PROTOCOLS + Protocol);
+}
+
+/**
+  Finds a protocol entry with the linear walk of mProtocolDatabase that
+  CoreFindProtocolEntry() used before the protocol hash table.
+
+  @param  Protocol               The ID of the protocol
+
+  @return Protocol entry, or NULL if the protocol has none
+
+**/
+STATIC
+PROTOCOL_ENTRY *
+HandleTestFindProtocolEntryInList (
+  IN EFI_GUID  *Protocol
+  )
+{
+  LIST_ENTRY      *Link;
+  PROTOCOL_ENTRY  *Item;
+
+  for (Link = mProtocolDatabase.ForwardLink; Link != &mProtocolDatabase; Link = Link->ForwardLink) {
+    Item = CR (Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
+    if (CompareGuid (&Item->ProtocolID, Protocol)) {
+      return Item;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Validates a handle with the linear walk of gHandleList that
+  CoreValidateHandle() used before the handle hash table.
+
+  @param  UserHandle             The handle to check
+
+  @retval EFI_INVALID_PARAMETER  The handle is NULL or not a valid EFI_HANDLE.
+  @retval EFI_SUCCESS            The handle is valid EFI_HANDLE.
+
+**/
+STATIC
+EFI_STATUS
+HandleTestValidateHandleInList (
+  IN EFI_HANDLE  UserHandle
+  )
+{
+  LIST_ENTRY  *Link;
+  IHANDLE     *Handle;
+
+  if (UserHandle == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Link = gHandleList.BackLink; Link != &gHandleList; Link = Link->BackLink) {
+    Handle = CR (Link, IHANDLE, AllHandles, EFI_HANDLE_SIGNATURE);
+    if (Handle == (IHANDLE *)UserHandle) {
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_INVALID_PARAMETER;
+}
+
+/**
+  Checks that the hash tables hold exactly the handles of gHandleList and the
+  protocol entries of mProtocolDatabase.
+
+  @retval TRUE    The hash tables are consistent.
+  @retval FALSE   A hash table is missing an entry or holds a stale one.
+
+**/
+STATIC
+BOOLEAN
+HandleTestHashTablesAreValid (
+  VOID
+  )
+{
+  LIST_ENTRY      *Link;
+  IHANDLE         *Handle;
+  PROTOCOL_ENTRY  *ProtEntry;
+  UINTN           ListCount;
+  UINTN           HashCount;
+  UINTN           Bucket;
+
+  ListCount = 0;
+  for (Link = gHandleList.ForwardLink; Link != &gHandleList; Link = Link->ForwardLink) {
+    if (CoreValidateHandle (CR (Link, IHANDLE, AllHandles, EFI_HANDLE_SIGNATURE)) != EFI_SUCCESS) {
+      return FALSE;
+    }
+
+    ListCount++;
+  }
+
+  HashCount = 0;
+  for (Bucket = 0; Bucket < HANDLE_TEST_HANDLE_BUCKETS; Bucket++) {
+    for (Handle = mHandleHashTable[Bucket]; Handle != NULL; Handle = Handle->HashNext) {
+      HashCount++;
+    }
+  }
+
+  if (ListCount != HashCount) {
+    return FALSE;
+  }
+
+  ListCount = 0;
+  CoreAcquireProtocolLock ();
+  for (Link = mProtocolDatabase.ForwardLink; Link != &mProtocolDatabase; Link = Link->ForwardLink) {
+    ProtEntry = CR (Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
+    if (CoreFindProtocolEntry (&ProtEntry->ProtocolID, FALSE) != ProtEntry) {
+      break;
+    }
+
+    ListCount++;
+  }
+
+  CoreReleaseProtocolLock ();
+  if (Link != &mProtocolDatabase) {
+    return FALSE;
+  }
+
+  HashCount = 0;
+  for (Bucket = 0; Bucket < HANDLE_TEST_PROTOCOL_BUCKETS; Bucket++) {
+    for (ProtEntry = mProtocolHashTable[Bucket]; ProtEntry != NULL; ProtEntry = ProtEntry->HashNext) {
+      HashCount++;
+    }
+  }
+
+  return ListCount == HashCount;
+}
+
+/**
+  Builds the handle database: every handle gets a few random protocols, and
+  handles are created in the order of their first protocol install.
+
+**/
+STATIC
+VOID
+EFIAPI
+HandleTestSetup (
+  VOID
+  )
+{
+  HANDLE_TEST_SLOT  *Slot;
+  UINT32            Seed;
+  UINTN             Index;
+  UINTN             Protocol;
+  EFI_STATUS        Status;
+
+  Seed = 0x7FEB352D;
+  for (Index = 0; Index < HANDLE_TEST_PROTOCOLS; Index++) {
+    mProtocols[Index].Data1 = DxeCoreUnitTestRandom (&Seed);
+    mProtocols[Index].Data2 = (UINT16)DxeCoreUnitTestRandom (&Seed);
+    mProtocols[Index].Data3 = (UINT16)Index;
+    WriteUnaligned64 ((UINT64 *)mProtocols[Index].Data4, LShiftU64 (DxeCoreUnitTestRandom (&Seed), 32) | DxeCoreUnitTestRandom (&Seed));
+  }
+
+  for (Index = 0; Index < HANDLE_TEST_HANDLES; Index++) {
+    Slot         = &mSlots[Index];
+    Slot->Handle = NULL;
+    Slot->Count  = 1 + DxeCoreUnitTestRandom (&Seed) % HANDLE_TEST_PER_HANDLE;
+    for (Protocol = 0; Protocol < Slot->Count; Protocol++) {
+      //
+      // Draw the protocols of a handle from distinct eighths of the protocol
+      // space, so that a handle never gets the same protocol twice.
+      //
+      Slot->Protocols[Protocol] = (UINT16)(Protocol * (HANDLE_TEST_PROTOCOLS / HANDLE_TEST_PER_HANDLE) +
+                                           DxeCoreUnitTestRandom (&Seed) % (HANDLE_TEST_PROTOCOLS / HANDLE_TEST_PER_HANDLE));
+      Status = CoreInstallProtocolInterface (
+                 &Slot->Handle,
+                 &mProtocols[Slot->Protocols[Protocol]],
+                 EFI_NATIVE_INTERFACE,
+                 HandleTestInterface (Index, Slot->Protocols[Protocol])
+                 );
+      ASSERT_EFI_ERROR (Status);
+    }
+  }
+}
+
+/**
+  Checks that every handle returns the interfaces installed on it, and no
+  interface for the other protocols.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The lookups returned the interfaces.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A lookup failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+HandleTestHandleProtocol (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  HANDLE_TEST_SLOT  *Slot;
+  UINTN             Index;
+  UINTN             Protocol;
+  UINTN             Other;
+  VOID              *Interface;
+  EFI_STATUS        Status;
+
+  UT_ASSERT_TRUE (HandleTestHashTablesAreValid ());
+
+  for (Index = 0; Index < HANDLE_TEST_HANDLES; Index++) {
+    Slot = &mSlots[Index];
+    UT_ASSERT_NOT_NULL (Slot->Handle);
+    for (Protocol = 0; Protocol < Slot->Count; Protocol++) {
+      Status = CoreHandleProtocol (Slot->Handle, &mProtocols[Slot->Protocols[Protocol]], &Interface);
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+      UT_ASSERT_EQUAL (Interface, HandleTestInterface (Index, Slot->Protocols[Protocol]));
+
+      //
+      // A protocol from the same eighth, which the handle doesn't carry.
+      //
+      Other  = Slot->Protocols[Protocol] ^ 1;
+      Status = CoreHandleProtocol (Slot->Handle, &mProtocols[Other], &Interface);
+      UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that handle validation and protocol entry lookups through the hash
+  tables return what the linear walks return, for valid and bogus handles and
+  for known and unknown protocols.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             Both lookups agreed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The lookups returned different results.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+HandleTestLookups (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_HANDLE  Handle;
+  EFI_GUID    Unknown;
+  UINTN       Index;
+
+  for (Index = 0; Index < HANDLE_TEST_HANDLES; Index++) {
+    Handle = mSlots[Index].Handle;
+    UT_ASSERT_STATUS_EQUAL (CoreValidateHandle (Handle), EFI_SUCCESS);
+    UT_ASSERT_STATUS_EQUAL (CoreValidateHandle ((UINT8 *)Handle + sizeof (UINT64)), EFI_INVALID_PARAMETER);
+    UT_ASSERT_STATUS_EQUAL (CoreValidateHandle ((UINT8 *)Handle - sizeof (UINT64)), EFI_INVALID_PARAMETER);
+    UT_ASSERT_STATUS_EQUAL (HandleTestValidateHandleInList ((UINT8 *)Handle + sizeof (UINT64)), EFI_INVALID_PARAMETER);
+  }
+
+  UT_ASSERT_STATUS_EQUAL (CoreValidateHandle (NULL), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (CoreValidateHandle (&Handle), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (CoreValidateHandle (mSlots), EFI_INVALID_PARAMETER);
+
+  CoreAcquireProtocolLock ();
+  for (Index = 0; Index < HANDLE_TEST_PROTOCOLS; Index++) {
+    UT_ASSERT_NOT_NULL (CoreFindProtocolEntry (&mProtocols[Index], FALSE));
+    UT_ASSERT_EQUAL (CoreFindProtocolEntry (&mProtocols[Index], FALSE), HandleTestFindProtocolEntryInList (&mProtocols[Index]));
+
+    CopyGuid (&Unknown, &mProtocols[Index]);
+    Unknown.Data3 = (UINT16)(Index + HANDLE_TEST_PROTOCOLS);
+    UT_ASSERT_EQUAL (CoreFindProtocolEntry (&Unknown, FALSE), NULL);
+    UT_ASSERT_EQUAL (HandleTestFindProtocolEntryInList (&Unknown), NULL);
+  }
+
+  CoreReleaseProtocolLock ();
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measures the cost of validating a handle and looking up a protocol entry
+  through the hash tables and with the linear walks.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The benchmark ran.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+HandleTestBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  HANDLE_TEST_SLOT  *Slot;
+  UINT32            Seed;
+  UINTN             Lookup;
+  UINTN             Found;
+  UINT64            Start;
+  UINT64            HashTime;
+  UINT64            ListTime;
+
+  CoreAcquireProtocolLock ();
+
+  Found = 0;
+  Seed  = 0x61C88647;
+  Start = DxeCoreUnitTestTimerStart ();
+  for (Lookup = 0; Lookup < HANDLE_BENCHMARK_LOOKUPS; Lookup++) {
+    Slot = &mSlots[DxeCoreUnitTestRandom (&Seed) % HANDLE_TEST_HANDLES];
+    if ((CoreValidateHandle (Slot->Handle) == EFI_SUCCESS) &&
+        (CoreFindProtocolEntry (&mProtocols[Slot->Protocols[0]], FALSE) != NULL))
+    {
+      Found++;
+    }
+  }
+
+  HashTime = DxeCoreUnitTestElapsedNanoSeconds (Start);
+
+  Seed  = 0x61C88647;
+  Start = DxeCoreUnitTestTimerStart ();
+  for (Lookup = 0; Lookup < HANDLE_BENCHMARK_LOOKUPS; Lookup++) {
+    Slot = &mSlots[DxeCoreUnitTestRandom (&Seed) % HANDLE_TEST_HANDLES];
+    if ((HandleTestValidateHandleInList (Slot->Handle) == EFI_SUCCESS) &&
+        (HandleTestFindProtocolEntryInList (&mProtocols[Slot->Protocols[0]]) != NULL))
+    {
+      Found--;
+    }
+  }
+
+  ListTime = DxeCoreUnitTestElapsedNanoSeconds (Start);
+
+  CoreReleaseProtocolLock ();
+
+  UT_LOG_INFO (
+    "%u handles, %u protocols, %u lookups: hash tables %u ns, linear walks %u ns per lookup\n",
+    HANDLE_TEST_HANDLES,
+    HANDLE_TEST_PROTOCOLS,
+    HANDLE_BENCHMARK_LOOKUPS,
+    (UINT32)(HashTime / HANDLE_BENCHMARK_LOOKUPS),
+    (UINT32)(ListTime / HANDLE_BENCHMARK_LOOKUPS)
+    );
+  UT_ASSERT_EQUAL (Found, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Uninstalls every protocol of half of the handles, which frees those handles,
+  and checks that they are no longer valid and that the hash tables dropped
+  them.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The handles were removed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A freed handle is still valid.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+HandleTestUninstall (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  HANDLE_TEST_SLOT  *Slot;
+  UINTN             Index;
+  UINTN             Protocol;
+  VOID              *Interface;
+  EFI_STATUS        Status;
+
+  for (Index = 0; Index < HANDLE_TEST_HANDLES; Index += 2) {
+    Slot = &mSlots[Index];
+    for (Protocol = 0; Protocol < Slot->Count; Protocol++) {
+      Status = CoreUninstallProtocolInterface (
+                 Slot->Handle,
+                 &mProtocols[Slot->Protocols[Protocol]],
+                 HandleTestInterface (Index, Slot->Protocols[Protocol])
+                 );
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+    }
+  }
+
+  //
+  // The freed handles are only compared by address, never dereferenced.
+  //
+  for (Index = 0; Index < HANDLE_TEST_HANDLES; Index++) {
+    Slot = &mSlots[Index];
+    if ((Index % 2) == 0) {
+      UT_ASSERT_STATUS_EQUAL (CoreValidateHandle (Slot->Handle), EFI_INVALID_PARAMETER);
+      UT_ASSERT_STATUS_EQUAL (HandleTestValidateHandleInList (Slot->Handle), EFI_INVALID_PARAMETER);
+    } else {
+      UT_ASSERT_STATUS_EQUAL (CoreValidateHandle (Slot->Handle), EFI_SUCCESS);
+      Status = CoreHandleProtocol (Slot->Handle, &mProtocols[Slot->Protocols[0]], &Interface);
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+      UT_ASSERT_EQUAL (Interface, HandleTestInterface (Index, Slot->Protocols[0]));
+    }
+  }
+
+  UT_ASSERT_TRUE (HandleTestHashTablesAreValid ());
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialze the unit test framework, suite, and unit tests for the handle
+  database and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      HandleTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&HandleTests, Framework, "DXE Core Handle Tests", "DxeCore.Handle", HandleTestSetup, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for HandleTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite--------Description------------------------------------------------Name-------------Function------------------Pre---Post---Context-----------
+  //
+  AddTestCase (HandleTests, "Handles return the interfaces installed on them",         "HandleProtocol", HandleTestHandleProtocol, NULL, NULL, NULL);
+  AddTestCase (HandleTests, "Hashed lookups match the linear walks",                   "Lookups",        HandleTestLookups,        NULL, NULL, NULL);
+  AddTestCase (HandleTests, "Hashed lookup and linear walk benchmark",                 "Benchmark",      HandleTestBenchmark,      NULL, NULL, NULL);
+  AddTestCase (HandleTests, "Uninstalling the last protocol removes the handle",       "Uninstall",      HandleTestUninstall,      NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int argc,
+  char *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
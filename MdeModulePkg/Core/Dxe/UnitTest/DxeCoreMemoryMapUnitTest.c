@@ -0,0 +1,648 @@
+/** @file
+  Host-based unit tests of the DXE Core memory map index.
+
+  The page allocator runs on a fragmented memory map built from several blocks
+  of host memory. The tests check the AVL invariants of the memory map index
+  after every change of the map, check that the indexed free page search
+  returns the same range as the linear scan of gMemoryMap it replaced, and
+  compare the cost of both searches.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeCoreUnitTest.h"
+#include "Mem/Imem.h"
+
+#define UNIT_TEST_APP_NAME          "DXE Core Memory Map Unit Tests"
+#define UNIT_TEST_APP_VERSION       "1.0"
+
+#define MAP_TEST_BLOCKS             8
+#define MAP_TEST_BLOCK_PAGES        (SIZE_32MB / EFI_PAGE_SIZE)
+#define MAP_TEST_SLOTS              2048
+#define MAP_TEST_OPERATIONS         20000
+#define MAP_TEST_QUERIES            20000
+#define MAP_BENCHMARK_QUERIES       200000
+
+typedef struct {
+  EFI_PHYSICAL_ADDRESS  Memory;
+  UINTN                 NumberOfPages;
+} MAP_TEST_SLOT;
+
+STATIC MAP_TEST_SLOT         mSlots[MAP_TEST_SLOTS];
+STATIC EFI_PHYSICAL_ADDRESS  mBlocks[MAP_TEST_BLOCKS];
+STATIC EFI_PHYSICAL_ADDRESS  mLowest;
+STATIC EFI_PHYSICAL_ADDRESS  mHighest;
+
+STATIC CONST EFI_MEMORY_TYPE  mMapTestTypes[] = {
+  EfiBootServicesData,
+  EfiBootServicesCode,
+  EfiLoaderData,
+  EfiRuntimeServicesData,
+  EfiACPIMemoryNVS
+};
+
+STATIC CONST UINTN  mMapTestAlignments[] = {
+  EFI_PAGE_SIZE,
+  EFI_PAGE_SIZE,
+  SIZE_64KB,
+  SIZE_2MB
+};
+
+extern MEMORY_MAP  *mMemoryMapIndex;
+
+UINT64
+CoreFindFreePagesI (
+  IN UINT64           MaxAddress,
+  IN UINT64           MinAddress,
+  IN UINT64           NumberOfPages,
+  IN EFI_MEMORY_TYPE  NewType,
+  IN UINTN            Alignment,
+  IN BOOLEAN          NeedGuard
+  );
+
+EFI_STATUS
+EFIAPI
+CoreInternalFreePages (
+  IN EFI_PHYSICAL_ADDRESS  Memory,
+  IN UINTN                 NumberOfPages,
+  OUT EFI_MEMORY_TYPE      *MemoryType OPTIONAL
+  );
+
+/**
+  Finds a consecutive free page range below the requested address with the
+  linear scan of gMemoryMap that CoreFindFreePagesI() used before the memory
+  map was indexed. It is the reference the indexed search is checked against.
+
+  @param  MaxAddress             The address that the range must be below
+  @param  MinAddress             The address that the range must be above
+  @param  NumberOfPages          Number of pages needed
+  @param  Alignment              Bits to align with
+
+  @return The base address of the range, or 0 if the range was not found
+
+**/
+STATIC
+UINT64
+MapTestFindFreePagesInList (
+  IN UINT64  MaxAddress,
+  IN UINT64  MinAddress,
+  IN UINT64  NumberOfPages,
+  IN UINTN   Alignment
+  )
+{
+  UINT64      NumberOfBytes;
+  UINT64      Target;
+  UINT64      DescStart;
+  UINT64      DescEnd;
+  UINT64      DescNumberOfBytes;
+  LIST_ENTRY  *Link;
+  MEMORY_MAP  *Entry;
+
+  if ((MaxAddress < EFI_PAGE_MASK) || (NumberOfPages == 0)) {
+    return 0;
+  }
+
+  if ((MaxAddress & EFI_PAGE_MASK) != EFI_PAGE_MASK) {
+    MaxAddress -= (EFI_PAGE_MASK + 1);
+    MaxAddress &= ~(UINT64)EFI_PAGE_MASK;
+    MaxAddress |= EFI_PAGE_MASK;
+  }
+
+  NumberOfBytes = LShiftU64 (NumberOfPages, EFI_PAGE_SHIFT);
+  Target        = 0;
+
+  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
+    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
+    if (Entry->Type != EfiConventionalMemory) {
+      continue;
+    }
+
+    DescStart = Entry->Start;
+    DescEnd   = Entry->End;
+    if ((DescStart >= MaxAddress) || (DescEnd < MinAddress)) {
+      continue;
+    }
+
+    if (DescEnd >= MaxAddress) {
+      DescEnd = MaxAddress;
+    }
+
+    DescEnd = ((DescEnd + 1) & (~(Alignment - 1))) - 1;
+    if (DescEnd < DescStart) {
+      continue;
+    }
+
+    DescNumberOfBytes = DescEnd - DescStart + 1;
+    if ((DescNumberOfBytes >= NumberOfBytes) &&
+        ((DescEnd - NumberOfBytes + 1) >= MinAddress) &&
+        (DescEnd > Target))
+    {
+      Target = DescEnd;
+    }
+  }
+
+  Target -= NumberOfBytes - 1;
+  if ((Target & EFI_PAGE_MASK) != 0) {
+    return 0;
+  }
+
+  return Target;
+}
+
+/**
+  Checks the AVL invariants of a memory map index subtree: the entries are in
+  address order, the children differ in height by at most one, and the height
+  and the largest free entry of every node are up to date.
+
+  @param[in]      Node      The root of the subtree, or NULL.
+  @param[in, out] Previous  The entry ordered before the subtree, or NULL.
+                            Returns the last entry of the subtree.
+  @param[in, out] Count     Incremented by the number of entries checked.
+
+  @return The height of the subtree, or MAX_UINTN if an invariant is broken.
+
+**/
+STATIC
+UINTN
+MapTestCheckIndex (
+  IN     MEMORY_MAP  *Node,
+  IN OUT MEMORY_MAP  **Previous,
+  IN OUT UINTN       *Count
+  )
+{
+  UINTN   LeftHeight;
+  UINTN   RightHeight;
+  UINT64  MaxFree;
+
+  if (Node == NULL) {
+    return 0;
+  }
+
+  LeftHeight = MapTestCheckIndex (Node->Left, Previous, Count);
+  if (LeftHeight == MAX_UINTN) {
+    return MAX_UINTN;
+  }
+
+  if ((Node->Signature != MEMORY_MAP_SIGNATURE) || (Node->End < Node->Start)) {
+    return MAX_UINTN;
+  }
+
+  if ((*Previous != NULL) && ((*Previous)->End >= Node->Start)) {
+    return MAX_UINTN;
+  }
+
+  *Previous = Node;
+  (*Count)++;
+
+  RightHeight = MapTestCheckIndex (Node->Right, Previous, Count);
+  if (RightHeight == MAX_UINTN) {
+    return MAX_UINTN;
+  }
+
+  if ((LeftHeight > RightHeight + 1) || (RightHeight > LeftHeight + 1)) {
+    return MAX_UINTN;
+  }
+
+  if (Node->Height != MAX (LeftHeight, RightHeight) + 1) {
+    return MAX_UINTN;
+  }
+
+  MaxFree = 0;
+  if (Node->Type == EfiConventionalMemory) {
+    MaxFree = Node->End - Node->Start + 1;
+  }
+
+  if (Node->Left != NULL) {
+    MaxFree = MAX (MaxFree, Node->Left->MaxFree);
+  }
+
+  if (Node->Right != NULL) {
+    MaxFree = MAX (MaxFree, Node->Right->MaxFree);
+  }
+
+  if (Node->MaxFree != MaxFree) {
+    return MAX_UINTN;
+  }
+
+  return Node->Height;
+}
+
+/**
+  Checks that the memory map index is a valid AVL tree that holds exactly the
+  entries of gMemoryMap.
+
+  @retval TRUE    The index is consistent with gMemoryMap.
+  @retval FALSE   The index is broken.
+
+**/
+STATIC
+BOOLEAN
+MapTestIndexIsValid (
+  VOID
+  )
+{
+  LIST_ENTRY  *Link;
+  MEMORY_MAP  *Entry;
+  MEMORY_MAP  *Node;
+  MEMORY_MAP  *Previous;
+  UINTN       IndexCount;
+  UINTN       ListCount;
+
+  Previous   = NULL;
+  IndexCount = 0;
+  if (MapTestCheckIndex (mMemoryMapIndex, &Previous, &IndexCount) == MAX_UINTN) {
+    return FALSE;
+  }
+
+  ListCount = 0;
+  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
+    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
+    ListCount++;
+
+    Node = mMemoryMapIndex;
+    while (Node != NULL && Node != Entry) {
+      Node = (Entry->Start < Node->Start) ? Node->Left : Node->Right;
+    }
+
+    if (Node == NULL) {
+      return FALSE;
+    }
+  }
+
+  return ListCount == IndexCount;
+}
+
+/**
+  Frees every page range still held in mSlots.
+
+  @param[in]  Context    Unused.
+
+**/
+STATIC
+VOID
+EFIAPI
+MapTestFreeSlots (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < MAP_TEST_SLOTS; Index++) {
+    if (mSlots[Index].Memory != 0) {
+      CoreInternalFreePages (mSlots[Index].Memory, mSlots[Index].NumberOfPages, NULL);
+      mSlots[Index].Memory = 0;
+    }
+  }
+}
+
+/**
+  Allocates page ranges of random sizes and memory types, and frees a random
+  half of them, which leaves a memory map with many small entries.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The memory map was fragmented.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  An allocation failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+MapTestFragment (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32      Seed;
+  UINTN       Index;
+  EFI_STATUS  Status;
+
+  Seed = 0x6C078965;
+  for (Index = 0; Index < MAP_TEST_SLOTS; Index++) {
+    mSlots[Index].NumberOfPages = 1 + DxeCoreUnitTestRandom (&Seed) % 32;
+    Status = CoreInternalAllocatePages (
+               AllocateAnyPages,
+               mMapTestTypes[DxeCoreUnitTestRandom (&Seed) % ARRAY_SIZE (mMapTestTypes)],
+               mSlots[Index].NumberOfPages,
+               &mSlots[Index].Memory,
+               FALSE
+               );
+    if (EFI_ERROR (Status)) {
+      return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+    }
+  }
+
+  for (Index = 0; Index < MAP_TEST_SLOTS; Index++) {
+    if ((DxeCoreUnitTestRandom (&Seed) & 1) != 0) {
+      CoreInternalFreePages (mSlots[Index].Memory, mSlots[Index].NumberOfPages, NULL);
+      mSlots[Index].Memory = 0;
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Returns random search arguments that cover the whole test memory, ranges
+  within and across the blocks, and requests that can't be satisfied.
+
+  @param[in, out]  Seed           The state of the pseudo random sequence.
+  @param[out]      MaxAddress     The address that the range must be below.
+  @param[out]      MinAddress     The address that the range must be above.
+  @param[out]      NumberOfPages  The number of pages needed.
+  @param[out]      Alignment      The alignment of the range.
+
+**/
+STATIC
+VOID
+MapTestRandomQuery (
+  IN OUT UINT32  *Seed,
+  OUT    UINT64  *MaxAddress,
+  OUT    UINT64  *MinAddress,
+  OUT    UINT64  *NumberOfPages,
+  OUT    UINTN   *Alignment
+  )
+{
+  UINT64  Span;
+
+  Span = mHighest - mLowest;
+  switch (DxeCoreUnitTestRandom (Seed) & 3) {
+  case 0:
+    *MaxAddress = MAX_ADDRESS;
+    *MinAddress = 0;
+    break;
+  case 1:
+    *MaxAddress = mLowest + MultU64x32 (Span, DxeCoreUnitTestRandom (Seed) % 1024) / 1024;
+    *MinAddress = 0;
+    break;
+  default:
+    *MinAddress = mLowest + MultU64x32 (Span, DxeCoreUnitTestRandom (Seed) % 1024) / 1024;
+    *MaxAddress = *MinAddress + MultU64x32 (Span, DxeCoreUnitTestRandom (Seed) % 1024) / 1024;
+    break;
+  }
+
+  if ((DxeCoreUnitTestRandom (Seed) & 7) == 0) {
+    *NumberOfPages = 1 + DxeCoreUnitTestRandom (Seed) % MAP_TEST_BLOCK_PAGES;
+  } else {
+    *NumberOfPages = 1 + DxeCoreUnitTestRandom (Seed) % 64;
+  }
+
+  *Alignment = mMapTestAlignments[DxeCoreUnitTestRandom (Seed) % ARRAY_SIZE (mMapTestAlignments)];
+}
+
+/**
+  Allocates and frees page ranges of random sizes and memory types in random
+  order, at any address, below an address and at a fixed address, and checks
+  the memory map index after every change of the memory map.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The index stayed consistent.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The index was broken.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+MapTestInvariants (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MAP_TEST_SLOT         *Slot;
+  UINT32                Seed;
+  UINTN                 Operation;
+  EFI_ALLOCATE_TYPE     Type;
+  EFI_PHYSICAL_ADDRESS  Memory;
+  EFI_STATUS            Status;
+
+  UT_ASSERT_TRUE (MapTestIndexIsValid ());
+
+  Seed = 0x5851F42D;
+  for (Operation = 0; Operation < MAP_TEST_OPERATIONS; Operation++) {
+    Slot = &mSlots[DxeCoreUnitTestRandom (&Seed) % MAP_TEST_SLOTS];
+
+    if (Slot->Memory != 0) {
+      Status = CoreInternalFreePages (Slot->Memory, Slot->NumberOfPages, NULL);
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+      Slot->Memory = 0;
+    } else {
+      Slot->NumberOfPages = 1 + DxeCoreUnitTestRandom (&Seed) % 64;
+      Type                = (EFI_ALLOCATE_TYPE)(DxeCoreUnitTestRandom (&Seed) % 3);
+      switch (Type) {
+      case AllocateMaxAddress:
+        Memory = mBlocks[DxeCoreUnitTestRandom (&Seed) % MAP_TEST_BLOCKS] + SIZE_16MB;
+        break;
+      case AllocateAddress:
+        Memory = mBlocks[DxeCoreUnitTestRandom (&Seed) % MAP_TEST_BLOCKS] +
+                 EFI_PAGES_TO_SIZE (DxeCoreUnitTestRandom (&Seed) % (MAP_TEST_BLOCK_PAGES - 64));
+        break;
+      default:
+        Memory = 0;
+        break;
+      }
+
+      Status = CoreInternalAllocatePages (
+                 Type,
+                 mMapTestTypes[DxeCoreUnitTestRandom (&Seed) % ARRAY_SIZE (mMapTestTypes)],
+                 Slot->NumberOfPages,
+                 &Memory,
+                 FALSE
+                 );
+      if (!EFI_ERROR (Status)) {
+        Slot->Memory = Memory;
+      } else {
+        UT_ASSERT_TRUE (Type == AllocateAddress);
+      }
+    }
+
+    UT_ASSERT_TRUE (MapTestIndexIsValid ());
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that the indexed free page search returns the same range as the
+  linear scan of gMemoryMap on a fragmented memory map.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             Both searches agreed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The searches returned different ranges.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+MapTestFindFreePages (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32  Seed;
+  UINTN   Query;
+  UINT64  MaxAddress;
+  UINT64  MinAddress;
+  UINT64  NumberOfPages;
+  UINTN   Alignment;
+  UINTN   Found;
+
+  Seed  = 0x41C64E6D;
+  Found = 0;
+  for (Query = 0; Query < MAP_TEST_QUERIES; Query++) {
+    MapTestRandomQuery (&Seed, &MaxAddress, &MinAddress, &NumberOfPages, &Alignment);
+    UT_ASSERT_EQUAL (
+      CoreFindFreePagesI (MaxAddress, MinAddress, NumberOfPages, EfiBootServicesData, Alignment, FALSE),
+      MapTestFindFreePagesInList (MaxAddress, MinAddress, NumberOfPages, Alignment)
+      );
+    if (MapTestFindFreePagesInList (MaxAddress, MinAddress, NumberOfPages, Alignment) != 0) {
+      Found++;
+    }
+  }
+
+  UT_LOG_INFO ("%u of %u searches found a range\n", (UINT32)Found, MAP_TEST_QUERIES);
+  UT_ASSERT_NOT_EQUAL (Found, 0);
+  UT_ASSERT_NOT_EQUAL (Found, MAP_TEST_QUERIES);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measures the cost of the indexed free page search and of the linear scan of
+  gMemoryMap on a fragmented memory map.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The benchmark ran.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+MapTestBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  LIST_ENTRY  *Link;
+  UINTN       Entries;
+  UINT32      Seed;
+  UINTN       Query;
+  UINT64      MaxAddress;
+  UINT64      MinAddress;
+  UINT64      NumberOfPages;
+  UINTN       Alignment;
+  UINT64      Sum;
+  UINT64      Start;
+  UINT64      IndexTime;
+  UINT64      ListTime;
+
+  Entries = 0;
+  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
+    Entries++;
+  }
+
+  Sum   = 0;
+  Seed  = 0x2C1B3C6D;
+  Start = DxeCoreUnitTestTimerStart ();
+  for (Query = 0; Query < MAP_BENCHMARK_QUERIES; Query++) {
+    MapTestRandomQuery (&Seed, &MaxAddress, &MinAddress, &NumberOfPages, &Alignment);
+    Sum += CoreFindFreePagesI (MaxAddress, MinAddress, NumberOfPages, EfiBootServicesData, Alignment, FALSE);
+  }
+
+  IndexTime = DxeCoreUnitTestElapsedNanoSeconds (Start);
+
+  Seed  = 0x2C1B3C6D;
+  Start = DxeCoreUnitTestTimerStart ();
+  for (Query = 0; Query < MAP_BENCHMARK_QUERIES; Query++) {
+    MapTestRandomQuery (&Seed, &MaxAddress, &MinAddress, &NumberOfPages, &Alignment);
+    Sum -= MapTestFindFreePagesInList (MaxAddress, MinAddress, NumberOfPages, Alignment);
+  }
+
+  ListTime = DxeCoreUnitTestElapsedNanoSeconds (Start);
+
+  UT_LOG_INFO (
+    "%u memory map entries, %u searches: index %u ns, list scan %u ns per search\n",
+    (UINT32)Entries,
+    MAP_BENCHMARK_QUERIES,
+    (UINT32)(IndexTime / MAP_BENCHMARK_QUERIES),
+    (UINT32)(ListTime / MAP_BENCHMARK_QUERIES)
+    );
+  UT_ASSERT_EQUAL (Sum, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialze the unit test framework, suite, and unit tests for the memory map
+  index and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      MapTests;
+  UINTN                       Index;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  CoreInitializePool ();
+  mLowest  = MAX_ADDRESS;
+  mHighest = 0;
+  for (Index = 0; Index < MAP_TEST_BLOCKS; Index++) {
+    mBlocks[Index] = DxeCoreUnitTestAddMemory (MAP_TEST_BLOCK_PAGES);
+    if (mBlocks[Index] == 0) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    mLowest  = MIN (mLowest, mBlocks[Index]);
+    mHighest = MAX (mHighest, mBlocks[Index] + EFI_PAGES_TO_SIZE (MAP_TEST_BLOCK_PAGES));
+  }
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&MapTests, Framework, "DXE Core Memory Map Tests", "DxeCore.MemoryMap", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for MapTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----Description----------------------------------------Name-------------Function--------------Pre--------------Post--------------Context-----------
+  //
+  AddTestCase (MapTests, "The index stays a valid AVL tree of gMemoryMap", "Invariants",    MapTestInvariants,    NULL,            MapTestFreeSlots, NULL);
+  AddTestCase (MapTests, "The indexed search matches the linear scan",     "FindFreePages", MapTestFindFreePages, MapTestFragment, MapTestFreeSlots, NULL);
+  AddTestCase (MapTests, "Indexed search and linear scan benchmark",       "Benchmark",     MapTestBenchmark,     MapTestFragment, MapTestFreeSlots, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int argc,
+  char *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
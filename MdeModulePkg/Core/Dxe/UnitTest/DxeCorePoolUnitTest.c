@@ -0,0 +1,431 @@
+/** @file
+  Host-based unit tests of the DXE Core pool allocator.
+
+  The pool allocator runs on top of the real page allocator, which is given a
+  block of host memory. A randomized allocate/free workload checks that every
+  buffer is usable and intact until it is freed, repeated workloads check that
+  freed memory is reused, and a benchmark reports the cost of small
+  allocations. PcdDxeCorePoolSlabEnable selects whether small requests are
+  served by the slab allocator.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeCoreUnitTest.h"
+
+#define UNIT_TEST_APP_NAME        "DXE Core Pool Unit Tests"
+#define UNIT_TEST_APP_VERSION     "1.0"
+
+#define POOL_TEST_MEMORY_PAGES    (SIZE_256MB / EFI_PAGE_SIZE)
+#define POOL_TEST_SLOTS           4096
+#define POOL_TEST_OPERATIONS      200000
+#define POOL_TEST_ROUNDS          20
+#define POOL_TEST_SMALL_COUNT     1024
+#define POOL_BENCHMARK_PAIRS      2000000
+
+typedef struct {
+  UINT8            *Buffer;
+  UINTN            Size;
+  EFI_MEMORY_TYPE  Type;
+  UINT8            Fill;
+} POOL_TEST_SLOT;
+
+STATIC POOL_TEST_SLOT   mSlots[POOL_TEST_SLOTS];
+
+STATIC CONST EFI_MEMORY_TYPE  mPoolTestTypes[] = {
+  EfiBootServicesData,
+  EfiBootServicesData,
+  EfiBootServicesData,
+  EfiLoaderData,
+  EfiRuntimeServicesData,
+  EfiACPIReclaimMemory,
+  (EFI_MEMORY_TYPE)0x70000001,
+  (EFI_MEMORY_TYPE)0x80000001
+};
+
+/**
+  Returns a request size that mostly falls in the small sizes that dominate
+  the DXE phase, and sometimes in the range backed directly by pages.
+
+  @param[in, out]  Seed    The state of the pseudo random sequence.
+
+  @return The request size in bytes.
+
+**/
+STATIC
+UINTN
+PoolTestRandomSize (
+  IN OUT UINT32  *Seed
+  )
+{
+  UINT32  Value;
+
+  Value = DxeCoreUnitTestRandom (Seed);
+  switch (Value & 0xF) {
+  case 0:
+    return Value % (3 * SIZE_4KB);
+  case 1:
+  case 2:
+    return Value % SIZE_2KB;
+  default:
+    return Value % 256;
+  }
+}
+
+/**
+  Returns the number of pages that are not free in the memory map.
+
+  @return The number of allocated pages.
+
+**/
+STATIC
+UINT64
+PoolTestAllocatedPages (
+  VOID
+  )
+{
+  STATIC EFI_MEMORY_DESCRIPTOR  MemoryMap[2048];
+  EFI_MEMORY_DESCRIPTOR         *Descriptor;
+  UINTN                         MemoryMapSize;
+  UINTN                         MapKey;
+  UINTN                         DescriptorSize;
+  UINT32                        DescriptorVersion;
+  UINT64                        Pages;
+  UINTN                         Index;
+  EFI_STATUS                    Status;
+
+  MemoryMapSize = sizeof (MemoryMap);
+  Status = CoreGetMemoryMap (&MemoryMapSize, MemoryMap, &MapKey, &DescriptorSize, &DescriptorVersion);
+  ASSERT_EFI_ERROR (Status);
+
+  Pages = 0;
+  for (Index = 0; Index < MemoryMapSize / DescriptorSize; Index++) {
+    Descriptor = (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)MemoryMap + Index * DescriptorSize);
+    if (Descriptor->Type != EfiConventionalMemory) {
+      Pages += Descriptor->NumberOfPages;
+    }
+  }
+
+  return Pages;
+}
+
+/**
+  Checks that a buffer still holds the pattern it was filled with.
+
+  @param[in]  Slot     The slot of the buffer.
+
+  @retval TRUE    The buffer is intact.
+  @retval FALSE   The buffer was overwritten.
+
+**/
+STATIC
+BOOLEAN
+PoolTestCheckSlot (
+  IN POOL_TEST_SLOT  *Slot
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Slot->Size; Index++) {
+    if (Slot->Buffer[Index] != (UINT8)(Slot->Fill + Index)) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Frees every buffer still held in mSlots.
+
+  @param[in]  Context    Unused.
+
+**/
+STATIC
+VOID
+EFIAPI
+PoolTestFreeSlots (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < POOL_TEST_SLOTS; Index++) {
+    if (mSlots[Index].Buffer != NULL) {
+      CoreInternalFreePool (mSlots[Index].Buffer, NULL);
+      mSlots[Index].Buffer = NULL;
+    }
+  }
+}
+
+/**
+  Allocates and frees buffers of random sizes and memory types in random
+  order, and checks that each buffer is aligned, keeps its content until it is
+  freed, and is freed as the memory type it was allocated as.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The pool allocator behaved.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A check failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+PoolTestRandomWorkload (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  POOL_TEST_SLOT   *Slot;
+  UINT32           Seed;
+  UINTN            Operation;
+  UINTN            Index;
+  EFI_MEMORY_TYPE  Type;
+  EFI_STATUS       Status;
+
+  Seed = 0x2545F491;
+  for (Operation = 0; Operation < POOL_TEST_OPERATIONS; Operation++) {
+    Slot = &mSlots[DxeCoreUnitTestRandom (&Seed) % POOL_TEST_SLOTS];
+
+    if (Slot->Buffer != NULL) {
+      UT_ASSERT_TRUE (PoolTestCheckSlot (Slot));
+      Status = CoreInternalFreePool (Slot->Buffer, &Type);
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+      UT_ASSERT_EQUAL (Type, Slot->Type);
+      Slot->Buffer = NULL;
+      continue;
+    }
+
+    Slot->Size = PoolTestRandomSize (&Seed);
+    Slot->Type = mPoolTestTypes[DxeCoreUnitTestRandom (&Seed) % ARRAY_SIZE (mPoolTestTypes)];
+    Slot->Fill = (UINT8)Operation;
+    Status = CoreInternalAllocatePool (Slot->Type, Slot->Size, (VOID **)&Slot->Buffer);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_NOT_NULL (Slot->Buffer);
+    UT_ASSERT_EQUAL ((UINTN)Slot->Buffer & 7, 0);
+    for (Index = 0; Index < Slot->Size; Index++) {
+      Slot->Buffer[Index] = (UINT8)(Slot->Fill + Index);
+    }
+  }
+
+  for (Index = 0; Index < POOL_TEST_SLOTS; Index++) {
+    if (mSlots[Index].Buffer != NULL) {
+      UT_ASSERT_TRUE (PoolTestCheckSlot (&mSlots[Index]));
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Runs the same allocate/free workload several times, and checks that the
+  pool reuses the memory freed by the previous rounds instead of growing.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The memory was reused.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The pool grew.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+PoolTestReuse (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT64      Pages;
+  UINT64      FirstRoundPages;
+  UINT32      Seed;
+  UINTN       Round;
+  UINTN       Index;
+  EFI_STATUS  Status;
+
+  FirstRoundPages = 0;
+  for (Round = 0; Round < POOL_TEST_ROUNDS; Round++) {
+    Seed = 0x9E3779B9;
+    for (Index = 0; Index < POOL_TEST_SLOTS; Index++) {
+      mSlots[Index].Size = PoolTestRandomSize (&Seed);
+      Status = CoreInternalAllocatePool (EfiBootServicesData, mSlots[Index].Size, (VOID **)&mSlots[Index].Buffer);
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+    }
+
+    for (Index = 0; Index < POOL_TEST_SLOTS; Index += 2) {
+      CoreInternalFreePool (mSlots[Index].Buffer, NULL);
+      mSlots[Index].Buffer = NULL;
+    }
+    for (Index = 1; Index < POOL_TEST_SLOTS; Index += 2) {
+      CoreInternalFreePool (mSlots[Index].Buffer, NULL);
+      mSlots[Index].Buffer = NULL;
+    }
+
+    Pages = PoolTestAllocatedPages ();
+    if (Round == 0) {
+      FirstRoundPages = Pages;
+    }
+    UT_ASSERT_EQUAL (Pages, FirstRoundPages);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that small buffers are packed densely when the slab allocator is
+  enabled: the 128 byte minimum block of the pool free lists would need twice
+  as many pages as the 48 byte slab objects do.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The small buffers were packed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  Too many pages were used.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+PoolTestSmallObjects (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT64      PagesBefore;
+  UINT64      Pages;
+  UINTN       Index;
+  EFI_STATUS  Status;
+
+  PagesBefore = PoolTestAllocatedPages ();
+  for (Index = 0; Index < POOL_TEST_SMALL_COUNT; Index++) {
+    Status = CoreInternalAllocatePool (EfiLoaderData, 16, (VOID **)&mSlots[Index].Buffer);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL ((UINTN)mSlots[Index].Buffer & 7, 0);
+    if (Index > 0) {
+      UT_ASSERT_NOT_EQUAL (mSlots[Index].Buffer, mSlots[Index - 1].Buffer);
+    }
+  }
+
+  Pages = PoolTestAllocatedPages () - PagesBefore;
+  UT_LOG_INFO ("%u 16 byte buffers use %u pages\n", POOL_TEST_SMALL_COUNT, (UINT32)Pages);
+  if (FeaturePcdGet (PcdDxeCorePoolSlabEnable)) {
+    UT_ASSERT_TRUE (Pages <= EFI_SIZE_TO_PAGES (POOL_TEST_SMALL_COUNT * 64) + EFI_SIZE_TO_PAGES (DEFAULT_PAGE_ALLOCATION_GRANULARITY));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measures the cost of allocating and freeing small buffers while a working
+  set of other buffers is live.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The benchmark ran.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  An allocation failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+PoolTestBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  POOL_TEST_SLOT  *Slot;
+  UINT32          Seed;
+  UINTN           Pair;
+  UINT64          Start;
+  UINT64          Elapsed;
+  EFI_STATUS      Status;
+
+  Seed = 0x1B873593;
+  for (Pair = 0; Pair < POOL_TEST_SLOTS; Pair++) {
+    Status = CoreInternalAllocatePool (EfiBootServicesData, DxeCoreUnitTestRandom (&Seed) % 256, (VOID **)&mSlots[Pair].Buffer);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+  }
+
+  Start = DxeCoreUnitTestTimerStart ();
+  for (Pair = 0; Pair < POOL_BENCHMARK_PAIRS; Pair++) {
+    Slot = &mSlots[DxeCoreUnitTestRandom (&Seed) % POOL_TEST_SLOTS];
+    CoreInternalFreePool (Slot->Buffer, NULL);
+    Status = CoreInternalAllocatePool (EfiBootServicesData, DxeCoreUnitTestRandom (&Seed) % 256, (VOID **)&Slot->Buffer);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+  }
+  Elapsed = DxeCoreUnitTestElapsedNanoSeconds (Start);
+
+  UT_LOG_INFO (
+    "Slab %a: %u free/allocate pairs of up to 256 bytes, %u ns per pair, %u pages allocated\n",
+    FeaturePcdGet (PcdDxeCorePoolSlabEnable) ? "enabled" : "disabled",
+    POOL_BENCHMARK_PAIRS,
+    (UINT32)(Elapsed / POOL_BENCHMARK_PAIRS),
+    (UINT32)PoolTestAllocatedPages ()
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialze the unit test framework, suite, and unit tests for the pool
+  allocator and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      PoolTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  CoreInitializePool ();
+  if (DxeCoreUnitTestAddMemory (POOL_TEST_MEMORY_PAGES) == 0) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&PoolTests, Framework, "DXE Core Pool Tests", "DxeCore.Pool", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for PoolTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----Description------------------------------------------Name------------Function----------------Pre---Post---------------Context-----------
+  //
+  AddTestCase (PoolTests, "Random allocations keep their content until freed", "Random",       PoolTestRandomWorkload, NULL, PoolTestFreeSlots, NULL);
+  AddTestCase (PoolTests, "Freed pool memory is reused",                        "Reuse",        PoolTestReuse,          NULL, PoolTestFreeSlots, NULL);
+  AddTestCase (PoolTests, "Small buffers are packed densely",                   "SmallObjects", PoolTestSmallObjects,   NULL, PoolTestFreeSlots, NULL);
+  AddTestCase (PoolTests, "Small allocation benchmark",                         "Benchmark",    PoolTestBenchmark,      NULL, PoolTestFreeSlots, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int argc,
+  char *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
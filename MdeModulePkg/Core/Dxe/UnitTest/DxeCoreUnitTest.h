@@ -0,0 +1,77 @@
+/** @file
+  Common definitions of the host-based unit tests of the DXE Core.
+
+  The tests link the DXE Core sources under test with the replacements in
+  DxeCoreUnitTestSupport.c of the DXE Core services those sources call, so the
+  memory, handle and dispatcher services can be exercised from the host.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _DXE_CORE_UNIT_TEST_H_
+#define _DXE_CORE_UNIT_TEST_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "DxeMain.h"
+#include <Library/UnitTestLib.h>
+
+/**
+  Hands a block of host memory to the DXE Core memory services as
+  EfiConventionalMemory.
+
+  @param[in]  NumberOfPages   The number of pages to add.
+
+  @return The physical address of the first page added, or 0 if the host is
+          out of memory.
+
+**/
+EFI_PHYSICAL_ADDRESS
+DxeCoreUnitTestAddMemory (
+  IN UINTN  NumberOfPages
+  );
+
+/**
+  Returns the next value of a deterministic pseudo random sequence, so that a
+  failing run can be reproduced.
+
+  @param[in, out]  Seed    The state of the sequence.
+
+  @return A pseudo random 31-bit value.
+
+**/
+UINT32
+DxeCoreUnitTestRandom (
+  IN OUT UINT32  *Seed
+  );
+
+/**
+  Returns a timestamp for DxeCoreUnitTestElapsedNanoSeconds().
+
+  @return The current timestamp.
+
+**/
+UINT64
+DxeCoreUnitTestTimerStart (
+  VOID
+  );
+
+/**
+  Returns the time elapsed since a timestamp of DxeCoreUnitTestTimerStart().
+
+  @param[in]  Start   The timestamp returned by DxeCoreUnitTestTimerStart().
+
+  @return The elapsed time in nanoseconds.
+
+**/
+UINT64
+DxeCoreUnitTestElapsedNanoSeconds (
+  IN UINT64  Start
+  );
+
+#endif
@@ -0,0 +1,49 @@
+/** @file
+  Host memory for the host-based unit tests of the DXE Core memory services.
+
+  It is kept apart from DxeCoreUnitTestSupport.c so that the tests that don't
+  link the page allocator don't need it.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeCoreUnitTest.h"
+
+/**
+  Hands a block of host memory to the DXE Core memory services as
+  EfiConventionalMemory.
+
+  @param[in]  NumberOfPages   The number of pages to add.
+
+  @return The physical address of the first page added, or 0 if the host is
+          out of memory.
+
+**/
+EFI_PHYSICAL_ADDRESS
+DxeCoreUnitTestAddMemory (
+  IN UINTN  NumberOfPages
+  )
+{
+  VOID  *Memory;
+
+  //
+  // Pool and the page allocator work in DEFAULT_PAGE_ALLOCATION_GRANULARITY
+  // units, so the block is aligned to at least that much. The memory is
+  // never given back, since the DXE Core never returns memory either.
+  //
+  Memory = aligned_alloc (SIZE_64KB, EFI_PAGES_TO_SIZE (NumberOfPages));
+  if (Memory == NULL) {
+    return 0;
+  }
+
+  CoreAddMemoryDescriptor (
+    EfiConventionalMemory,
+    (EFI_PHYSICAL_ADDRESS)(UINTN)Memory,
+    NumberOfPages,
+    0
+    );
+
+  return (EFI_PHYSICAL_ADDRESS)(UINTN)Memory;
+}
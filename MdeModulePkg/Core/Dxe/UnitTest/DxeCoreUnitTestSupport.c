@@ -0,0 +1,501 @@
+/** @file
+  Host replacements of the DXE Core services that the sources under test call
+  but are not part of the test: TPL and locks, heap guard, memory protection,
+  memory profile and GCD.
+
+  None of the tests enables heap guard, memory protection or memory profile,
+  so those services do nothing. There is a single thread and no interrupts on
+  the host, so the locks only track their state to catch unbalanced use.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeCoreUnitTest.h"
+#include "Mem/HeapGuard.h"
+
+EFI_HANDLE                                 gDxeCoreImageHandle = NULL;
+EFI_LOAD_FIXED_ADDRESS_CONFIGURATION_TABLE gLoadModuleAtFixAddressConfigurationTable = { 0, 0 };
+LIST_ENTRY                                 mGcdMemorySpaceMap = INITIALIZE_LIST_HEAD_VARIABLE (mGcdMemorySpaceMap);
+BOOLEAN                                    mOnGuarding = FALSE;
+
+STATIC EFI_TPL                             mCurrentTpl = TPL_APPLICATION;
+
+/**
+  Raise the task priority level to the new level.
+
+  @param  NewTpl  New task priority level
+
+  @return The previous task priority level
+
+**/
+EFI_TPL
+EFIAPI
+CoreRaiseTpl (
+  IN EFI_TPL      NewTpl
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = mCurrentTpl;
+  ASSERT (OldTpl <= NewTpl);
+  mCurrentTpl = NewTpl;
+  return OldTpl;
+}
+
+/**
+  Lowers the task priority to the previous value.
+
+  @param  NewTpl  New, lower, task priority
+
+**/
+VOID
+EFIAPI
+CoreRestoreTpl (
+  IN EFI_TPL NewTpl
+  )
+{
+  ASSERT (NewTpl <= mCurrentTpl);
+  mCurrentTpl = NewTpl;
+}
+
+/**
+  Raising to the task priority level of the mutual exclusion
+  lock, and then acquires ownership of the lock.
+
+  @param  Lock               The lock to acquire
+
+**/
+VOID
+CoreAcquireLock (
+  IN EFI_LOCK  *Lock
+  )
+{
+  ASSERT (Lock != NULL);
+  ASSERT (Lock->Lock == EfiLockReleased);
+
+  Lock->OwnerTpl = CoreRaiseTpl (Lock->Tpl);
+  Lock->Lock     = EfiLockAcquired;
+}
+
+/**
+  Initialize a basic mutual exclusion lock.
+
+  @param  Lock               The EFI_LOCK structure to initialize
+
+  @retval EFI_SUCCESS        Lock Owned.
+  @retval EFI_ACCESS_DENIED  Reentrant Lock Acquisition, Lock not Owned.
+
+**/
+EFI_STATUS
+CoreAcquireLockOrFail (
+  IN EFI_LOCK  *Lock
+  )
+{
+  ASSERT (Lock != NULL);
+  ASSERT (Lock->Lock != EfiLockUninitialized);
+
+  if (Lock->Lock == EfiLockAcquired) {
+    return EFI_ACCESS_DENIED;
+  }
+
+  Lock->OwnerTpl = CoreRaiseTpl (Lock->Tpl);
+  Lock->Lock     = EfiLockAcquired;
+  return EFI_SUCCESS;
+}
+
+/**
+  Releases ownership of the mutual exclusion lock, and
+  restores the previous task priority level.
+
+  @param  Lock               The lock to release
+
+**/
+VOID
+CoreReleaseLock (
+  IN EFI_LOCK  *Lock
+  )
+{
+  ASSERT (Lock != NULL);
+  ASSERT (Lock->Lock == EfiLockAcquired);
+
+  Lock->Lock = EfiLockReleased;
+  CoreRestoreTpl (Lock->OwnerTpl);
+}
+
+/**
+  Acquire memory lock on mGcdMemorySpaceLock.
+
+**/
+VOID
+CoreAcquireGcdMemoryLock (
+  VOID
+  )
+{
+}
+
+/**
+  Release memory lock on mGcdMemorySpaceLock.
+
+**/
+VOID
+CoreReleaseGcdMemoryLock (
+  VOID
+  )
+{
+}
+
+/**
+  Retrieves the descriptor for a memory region containing a specified address.
+  The tests don't build a GCD memory space map.
+
+  @param  BaseAddress            Specified start address
+  @param  Descriptor             Specified length
+
+  @retval EFI_NOT_FOUND          There is no GCD memory space map.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreGetMemorySpaceDescriptor (
+  IN  EFI_PHYSICAL_ADDRESS             BaseAddress,
+  OUT EFI_GCD_MEMORY_SPACE_DESCRIPTOR  *Descriptor
+  )
+{
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Signals all events in the EventGroup. There are no events on the host.
+
+  @param  EventGroup             The list to signal
+
+**/
+VOID
+CoreNotifySignalList (
+  IN EFI_GUID     *EventGroup
+  )
+{
+}
+
+/**
+  Update memory profile information. Memory profile is disabled.
+
+  @retval EFI_UNSUPPORTED        Memory profile is unsupported.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreUpdateProfile (
+  IN EFI_PHYSICAL_ADDRESS   CallerAddress,
+  IN MEMORY_PROFILE_ACTION  Action,
+  IN EFI_MEMORY_TYPE        MemoryType,
+  IN UINTN                  Size,
+  IN VOID                   *Buffer,
+  IN CHAR8                  *ActionString OPTIONAL
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Manage memory permission attributes on a memory range. Memory protection is
+  disabled.
+
+  @retval EFI_SUCCESS       Nothing to do.
+
+**/
+EFI_STATUS
+EFIAPI
+ApplyMemoryProtectionPolicy (
+  IN  EFI_MEMORY_TYPE       OldType,
+  IN  EFI_MEMORY_TYPE       NewType,
+  IN  EFI_PHYSICAL_ADDRESS  Memory,
+  IN  UINT64                Length
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Install Memory Attributes Table on memory allocation. There is no system
+  table on the host.
+
+  @param[in] MemoryType    EFI memory type.
+
+**/
+VOID
+InstallMemoryAttributesTableOnMemoryAllocation (
+  IN EFI_MEMORY_TYPE    MemoryType
+  )
+{
+}
+
+/**
+  Merge continous memory map entries whose have same attributes. The tests
+  check the unmerged memory map.
+
+  @param  MemoryMap              A pointer to the buffer of the memory map.
+  @param  MemoryMapSize          The size of the memory map.
+  @param  DescriptorSize         Size, in bytes, of an individual descriptor.
+
+**/
+VOID
+MergeMemoryMap (
+  IN OUT EFI_MEMORY_DESCRIPTOR  *MemoryMap,
+  IN OUT UINTN                  *MemoryMapSize,
+  IN UINTN                      DescriptorSize
+  )
+{
+}
+
+/**
+  Check to see if the heap guard is enabled for page and/or pool allocation.
+
+  @return FALSE, heap guard is disabled.
+
+**/
+BOOLEAN
+IsHeapGuardEnabled (
+  UINT8           GuardType
+  )
+{
+  return FALSE;
+}
+
+/**
+  Check to see if the pool at the given address should be guarded or not.
+
+  @return FALSE, heap guard is disabled.
+
+**/
+BOOLEAN
+IsPoolTypeToGuard (
+  IN EFI_MEMORY_TYPE        MemoryType
+  )
+{
+  return FALSE;
+}
+
+/**
+  Check to see if the page at the given address should be guarded or not.
+
+  @return FALSE, heap guard is disabled.
+
+**/
+BOOLEAN
+IsPageTypeToGuard (
+  IN EFI_MEMORY_TYPE        MemoryType,
+  IN EFI_ALLOCATE_TYPE      AllocateType
+  )
+{
+  return FALSE;
+}
+
+/**
+  Check to see if the page at the given address is guarded or not.
+
+  @return FALSE, heap guard is disabled.
+
+**/
+BOOLEAN
+EFIAPI
+IsMemoryGuarded (
+  IN EFI_PHYSICAL_ADDRESS    Address
+  )
+{
+  return FALSE;
+}
+
+/**
+  Set head Guard and tail Guard for the given memory range.
+
+**/
+VOID
+SetGuardForMemory (
+  IN EFI_PHYSICAL_ADDRESS   Memory,
+  IN UINTN                  NumberOfPages
+  )
+{
+}
+
+/**
+  Unset head Guard and tail Guard for the given memory range.
+
+**/
+VOID
+UnsetGuardForMemory (
+  IN EFI_PHYSICAL_ADDRESS   Memory,
+  IN UINTN                  NumberOfPages
+  )
+{
+}
+
+/**
+  Adjust the base and number of pages to really allocate according to Guard.
+
+**/
+VOID
+AdjustMemoryF (
+  IN OUT EFI_PHYSICAL_ADDRESS    *Memory,
+  IN OUT UINTN                   *NumberOfPages
+  )
+{
+}
+
+/**
+  Adjust address of free memory according to existing and/or required Guard.
+
+  @return The end of the free memory, as there are no Guard pages.
+
+**/
+UINT64
+AdjustMemoryS (
+  IN UINT64                  Start,
+  IN UINT64                  Size,
+  IN UINT64                  SizeRequested
+  )
+{
+  return Start + Size - 1;
+}
+
+/**
+  Adjust the pool head position to make sure the Guard page is adjavent to
+  pool tail or pool head.
+
+  @return Address of pool head.
+
+**/
+VOID *
+AdjustPoolHeadA (
+  IN EFI_PHYSICAL_ADDRESS    Memory,
+  IN UINTN                   NoPages,
+  IN UINTN                   Size
+  )
+{
+  return (VOID *)(UINTN)Memory;
+}
+
+/**
+  Get the page base address according to pool head address.
+
+  @return Address of pool head.
+
+**/
+VOID *
+AdjustPoolHeadF (
+  IN EFI_PHYSICAL_ADDRESS    Memory
+  )
+{
+  return (VOID *)(UINTN)Memory;
+}
+
+/**
+  Record freed pages as well as mark them as not-present, if enabled.
+
+**/
+VOID
+EFIAPI
+GuardFreedPagesChecked (
+  IN  EFI_PHYSICAL_ADDRESS    BaseAddress,
+  IN  UINTN                   Pages
+  )
+{
+}
+
+/**
+  Convert memory range to the given type with guard pages.
+
+  @retval EFI_UNSUPPORTED   Heap guard is disabled.
+
+**/
+EFI_STATUS
+CoreConvertPagesWithGuard (
+  IN UINT64           Start,
+  IN UINTN            NumberOfPages,
+  IN EFI_MEMORY_TYPE  NewType
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Dump the guarded memory bit map.
+
+**/
+VOID
+EFIAPI
+DumpGuardedMemoryBitmap (
+  VOID
+  )
+{
+}
+
+/**
+  Put part of the guarded free pages back to free page pool.
+
+  @return FALSE, there are no guarded free pages.
+
+**/
+BOOLEAN
+PromoteGuardedFreePages (
+  OUT EFI_PHYSICAL_ADDRESS      *StartAddress,
+  OUT EFI_PHYSICAL_ADDRESS      *EndAddress
+  )
+{
+  return FALSE;
+}
+
+/**
+  Returns the next value of a deterministic pseudo random sequence, so that a
+  failing run can be reproduced.
+
+  @param[in, out]  Seed    The state of the sequence.
+
+  @return A pseudo random 31-bit value.
+
+**/
+UINT32
+DxeCoreUnitTestRandom (
+  IN OUT UINT32  *Seed
+  )
+{
+  //
+  // xorshift32, the seed must not be zero.
+  //
+  *Seed ^= *Seed << 13;
+  *Seed ^= *Seed >> 17;
+  *Seed ^= *Seed << 5;
+  return *Seed & 0x7FFFFFFF;
+}
+
+/**
+  Returns a timestamp for DxeCoreUnitTestElapsedNanoSeconds().
+
+  @return The current timestamp.
+
+**/
+UINT64
+DxeCoreUnitTestTimerStart (
+  VOID
+  )
+{
+  return (UINT64)clock ();
+}
+
+/**
+  Returns the time elapsed since a timestamp of DxeCoreUnitTestTimerStart().
+
+  @param[in]  Start   The timestamp returned by DxeCoreUnitTestTimerStart().
+
+  @return The elapsed time in nanoseconds.
+
+**/
+UINT64
+DxeCoreUnitTestElapsedNanoSeconds (
+  IN UINT64  Start
+  )
+{
+  return ((UINT64)clock () - Start) * 1000000000ULL / CLOCKS_PER_SEC;
+}
@@ -97,6 +97,7 @@ PeimDispatchReadiness (
   DEPENDENCY_EXPRESSION_OPERAND  *Iterator;
   EVAL_STACK_ENTRY               *StackPtr;
   EVAL_STACK_ENTRY               EvalStack[MAX_GRAMMAR_SIZE];
+  BOOLEAN                        Result;
 
   Iterator  = DependencyExpression;
 
@@ -188,8 +189,9 @@ PeimDispatchReadiness (
           DEBUG ((DEBUG_DISPATCH, "  RESULT = FALSE (Underflow Error)\n"));
           return FALSE;
         }
-        DEBUG ((DEBUG_DISPATCH, "  RESULT = %a\n", IsPpiInstalled (PeiServices, StackPtr) ? "TRUE" : "FALSE"));
-        return IsPpiInstalled (PeiServices, StackPtr);
+        Result = IsPpiInstalled (PeiServices, StackPtr);
+        DEBUG ((DEBUG_DISPATCH, "  RESULT = %a\n", Result ? "TRUE" : "FALSE"));
+        return Result;
 
       case (EFI_DEP_NOT):
         DEBUG ((DEBUG_DISPATCH, "  NOT\n"));
@@ -113,13 +113,16 @@ DiscoverPeimsAndOrderWithApriori (
   }
 
   //
-  // Record PeimCount, allocate buffer for PeimState and FvFileHandles.
+  // Record PeimCount, allocate buffer for PeimState, FvFileHandles and
+  // PeimDepexPpiCount.
   //
   CoreFileHandle->PeimCount = PeimCount;
   CoreFileHandle->PeimState = AllocateZeroPool (sizeof (UINT8) * PeimCount);
   ASSERT (CoreFileHandle->PeimState != NULL);
   CoreFileHandle->FvFileHandles = AllocateZeroPool (sizeof (EFI_PEI_FILE_HANDLE) * PeimCount);
   ASSERT (CoreFileHandle->FvFileHandles != NULL);
+  CoreFileHandle->PeimDepexPpiCount = AllocateZeroPool (sizeof (UINTN) * PeimCount);
+  ASSERT (CoreFileHandle->PeimDepexPpiCount != NULL);
 
   //
   // Get Apriori File handle
@@ -1413,6 +1416,7 @@ PeiDispatcher (
   EFI_PEI_FILE_HANDLE                 SaveCurrentFileHandle;
   EFI_FV_FILE_INFO                    FvFileInfo;
   PEI_CORE_FV_HANDLE                  *CoreFvHandle;
+  UINTN                               PpiCount;
 
   PeiServices = (CONST EFI_PEI_SERVICES **) &Private->Ps;
   PeimEntryPoint = NULL;
@@ -1525,7 +1529,15 @@ PeiDispatcher (
         PeimFileHandle = Private->CurrentFileHandle = Private->CurrentFvFileHandles[PeimCount];
 
         if (Private->Fv[FvCount].PeimState[PeimCount] == PEIM_STATE_NOT_DISPATCHED) {
-          if (!DepexSatisfied (Private, PeimFileHandle, PeimCount)) {
+          //
+          // Skip the DEPEX evaluation if no PPI was installed since the
+          // DEPEX last evaluated to FALSE.
+          //
+          PpiCount = Private->PpiData.PpiList.CurrentCount + 1;
+          if (Private->Fv[FvCount].PeimDepexPpiCount[PeimCount] == PpiCount) {
+            Private->PeimNeedingDispatch = TRUE;
+          } else if (!DepexSatisfied (Private, PeimFileHandle, PeimCount)) {
+            Private->Fv[FvCount].PeimDepexPpiCount[PeimCount] = PpiCount;
             Private->PeimNeedingDispatch = TRUE;
           } else {
             Status = CoreFvHandle->FvPpi->GetFileInfo (CoreFvHandle->FvPpi, PeimFileHandle, &FvFileInfo);
@@ -144,6 +144,13 @@ typedef struct {
   // Pointer to the buffer with the PeimCount number of Entries.
   //
   EFI_PEI_FILE_HANDLE                 *FvFileHandles;
+  //
+  // Pointer to the buffer with the PeimCount number of Entries. Each entry is
+  // one more than the PPI count when the DEPEX of the PEIM last evaluated to
+  // FALSE, or 0. PPIs are never uninstalled, so such a DEPEX cannot become
+  // TRUE until another PPI is installed.
+  //
+  UINTN                               *PeimDepexPpiCount;
   BOOLEAN                             ScanFv;
   UINT32                              AuthenticationStatus;
 } PEI_CORE_FV_HANDLE;
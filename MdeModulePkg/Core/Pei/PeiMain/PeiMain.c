@@ -228,6 +228,9 @@ PeiCore (
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *) ((UINT8 *) OldCoreData->Fv[Index].FvFileHandles + OldCoreData->HeapOffset);
           }
+          if (OldCoreData->Fv[Index].PeimDepexPpiCount != NULL) {
+            OldCoreData->Fv[Index].PeimDepexPpiCount = (UINTN *) ((UINT8 *) OldCoreData->Fv[Index].PeimDepexPpiCount + OldCoreData->HeapOffset);
+          }
         }
         OldCoreData->TempFileGuid         = (EFI_GUID *) ((UINT8 *) OldCoreData->TempFileGuid + OldCoreData->HeapOffset);
         OldCoreData->TempFileHandles      = (EFI_PEI_FILE_HANDLE *) ((UINT8 *) OldCoreData->TempFileHandles + OldCoreData->HeapOffset);
@@ -256,6 +259,9 @@ PeiCore (
           if (OldCoreData->Fv[Index].FvFileHandles != NULL) {
             OldCoreData->Fv[Index].FvFileHandles = (EFI_PEI_FILE_HANDLE *) ((UINT8 *) OldCoreData->Fv[Index].FvFileHandles - OldCoreData->HeapOffset);
           }
+          if (OldCoreData->Fv[Index].PeimDepexPpiCount != NULL) {
+            OldCoreData->Fv[Index].PeimDepexPpiCount = (UINTN *) ((UINT8 *) OldCoreData->Fv[Index].PeimDepexPpiCount - OldCoreData->HeapOffset);
+          }
         }
         OldCoreData->TempFileGuid         = (EFI_GUID *) ((UINT8 *) OldCoreData->TempFileGuid - OldCoreData->HeapOffset);
         OldCoreData->TempFileHandles      = (EFI_PEI_FILE_HANDLE *) ((UINT8 *) OldCoreData->TempFileHandles - OldCoreData->HeapOffset);
@@ -23,7 +23,42 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define LZMAF86_CUSTOM_DECOMPRESS_GUID  \
   { 0xD42AE6BD, 0x1352, 0x4bfb, { 0x90, 0x9A, 0xCA, 0x72, 0xA6, 0xEA, 0xE8, 0x89 } }
 
+///
+/// The Global ID used to identify a section of an FFS file of type
+/// EFI_SECTION_GUID_DEFINED, whose contents have been split into chunks that
+/// are compressed independently using LZMA, so they can be decompressed in
+/// parallel.
+///
+#define LZMA_CHUNKED_CUSTOM_DECOMPRESS_GUID  \
+  { 0x7A050661, 0xE91E, 0x4BA6, { 0x9F, 0x0D, 0xD3, 0xD7, 0x01, 0xB7, 0x6E, 0xF5 } }
+
+#define LZMA_CHUNKED_SIGNATURE  SIGNATURE_32 ('L', 'Z', 'M', 'C')
+
+///
+/// Describes one chunk of an LZMA chunked section. Offset is relative to the
+/// start of the LZMA_CHUNKED_HEADER. Each chunk is a complete LZMA stream
+/// with the same header as the data of an LZMA_CUSTOM_DECOMPRESS_GUID section.
+///
+typedef struct {
+  UINT32    Offset;
+  UINT32    Size;
+} LZMA_CHUNK_ENTRY;
+
+///
+/// The data of an LZMA chunked section starts with this header, followed by
+/// ChunkCount LZMA_CHUNK_ENTRY structures and the compressed chunks. Every
+/// chunk but the last one decompresses to exactly ChunkSize bytes.
+///
+typedef struct {
+  UINT32              Signature;
+  UINT32              ChunkCount;
+  UINT32              ChunkSize;
+  UINT32              UncompressedSize;
+//LZMA_CHUNK_ENTRY    Chunk[ChunkCount];
+} LZMA_CHUNKED_HEADER;
+
 extern GUID gLzmaCustomDecompressGuid;
 extern GUID gLzmaF86CustomDecompressGuid;
+extern GUID gLzmaChunkedCustomDecompressGuid;
 
 #endif
@@ -77,6 +77,10 @@ typedef struct {
 // The payload for this function is SMM_VARIABLE_COMMUNICATE_GET_RUNTIME_CACHE_INFO
 //
 #define SMM_VARIABLE_FUNCTION_GET_RUNTIME_CACHE_INFO                14
+//
+// The payload for this function is SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH.
+//
+#define SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH                    15
 
 ///
 /// Size of SMM communicate header, without including the payload.
@@ -99,6 +103,25 @@ typedef struct {
   CHAR16      Name[1];
 } SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE;
 
+///
+/// This structure is used to communicate with SMI handler by the batched SetVariable.
+/// It is followed by Count SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE entries, each of
+/// them starting at a UINTN aligned offset (see SMM_VARIABLE_BATCH_ENTRY_SIZE).
+/// The entries are applied in order until one fails. On return, Processed is the
+/// number of entries that were set, and ReturnStatus is the status of the entry
+/// that failed, if any.
+///
+typedef struct {
+  UINTN       Count;
+  UINTN       Processed;
+} SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH;
+
+///
+/// Size of one entry of a batched SetVariable, including the padding to the next entry.
+///
+#define SMM_VARIABLE_BATCH_ENTRY_SIZE(NameSize, DataSize) \
+  ALIGN_VALUE (OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE, Name) + (NameSize) + (DataSize), sizeof (UINTN))
+
 ///
 /// This structure is used to communicate with SMI handler by GetNextVariableName.
 ///
@@ -138,6 +161,12 @@ typedef struct {
   VARIABLE_STORE_HEADER   *RuntimeHobCache;
   VARIABLE_STORE_HEADER   *RuntimeNvCache;
   VARIABLE_STORE_HEADER   *RuntimeVolatileCache;
+  ///
+  /// Optional. Incremented by the SMM variable driver each time it writes the
+  /// runtime caches. May be NULL, or left out of the communicate buffer by
+  /// callers that predate it, in which case no count is kept.
+  ///
+  UINT32                  *UpdateCount;
 } SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT;
 
 typedef struct {
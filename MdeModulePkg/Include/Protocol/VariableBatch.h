@@ -0,0 +1,76 @@
+/** @file
+  Variable Batch Protocol is related to EDK II-specific implementation of variables
+  and intended for use as a means to set a number of variables with one call.
+  When the variable services are provided from SMM, the variables are handed to
+  SMM in as few SMIs as the communicate buffer allows.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __VARIABLE_BATCH_H__
+#define __VARIABLE_BATCH_H__
+
+#define EDKII_VARIABLE_BATCH_PROTOCOL_GUID \
+  { \
+    0xb4b4ffec, 0x7b7a, 0x4733, { 0xad, 0x8b, 0x4f, 0x2a, 0x5a, 0x4e, 0xfd, 0xa8 } \
+  }
+
+typedef struct _EDKII_VARIABLE_BATCH_PROTOCOL  EDKII_VARIABLE_BATCH_PROTOCOL;
+
+///
+/// One variable to set, with the same meaning for the fields as the parameters
+/// of the SetVariable() runtime service.
+///
+typedef struct {
+  CHAR16      *VariableName;
+  EFI_GUID    *VendorGuid;
+  UINT32      Attributes;
+  UINTN       DataSize;
+  VOID        *Data;
+  ///
+  /// Output: the status SetVariable() returned for this variable, or
+  /// EFI_NOT_STARTED if the variable was not set because an earlier one failed.
+  ///
+  EFI_STATUS  Status;
+} EDKII_VARIABLE_BATCH_ENTRY;
+
+/**
+  Set a number of variables, in order.
+
+  All the entries are checked before any variable is set, so malformed input
+  does not leave the batch half applied. The variables are then set in order,
+  and processing stops at the first variable that cannot be set.
+
+  @param[in]      This          The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in]      Count         The number of entries in Entries.
+  @param[in, out] Entries       The variables to set. The Status field of each
+                                entry is updated on return.
+
+  @retval EFI_SUCCESS           All the variables were set.
+  @retval EFI_INVALID_PARAMETER Entries is NULL while Count is not 0, or one of
+                                the entries has parameters SetVariable() would
+                                reject. No variable was set.
+  @retval Others                The status of the first variable that could not
+                                be set.
+**/
+typedef
+EFI_STATUS
+(EFIAPI * EDKII_VARIABLE_BATCH_SET_VARIABLES) (
+  IN CONST EDKII_VARIABLE_BATCH_PROTOCOL  *This,
+  IN       UINTN                          Count,
+  IN OUT   EDKII_VARIABLE_BATCH_ENTRY     *Entries
+  );
+
+///
+/// Variable Batch Protocol is related to EDK II-specific implementation of variables
+/// and intended for use as a means to set a number of variables with one call.
+///
+struct _EDKII_VARIABLE_BATCH_PROTOCOL {
+  EDKII_VARIABLE_BATCH_SET_VARIABLES  SetVariables;
+};
+
+extern EFI_GUID gEdkiiVariableBatchProtocolGuid;
+
+#endif
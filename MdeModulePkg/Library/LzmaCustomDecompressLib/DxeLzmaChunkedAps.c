@@ -0,0 +1,140 @@
+/** @file
+  LZMA chunked decompress on the application processors in DXE.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaDecompressLibInternal.h"
+#include <Protocol/MpService.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+/**
+  Register the LZMA and LZMA chunked GUIDed section handlers.
+
+  @param  ImageHandle   The firmware allocated handle for the EFI image.
+  @param  SystemTable   A pointer to the EFI System Table.
+
+  @retval  RETURN_SUCCESS            Register successfully.
+  @retval  RETURN_OUT_OF_RESOURCES   No enough memory to store this handler.
+**/
+EFI_STATUS
+EFIAPI
+DxeLzmaDecompressLibConstructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  return LzmaDecompressLibConstructor ();
+}
+
+/**
+  Close the event that MP services signal once all application processors
+  have finished a procedure started by LzmaChunkedStartupAllAps().
+
+  @param  Event           The event to close.
+  @param  Context         Unused.
+**/
+VOID
+EFIAPI
+LzmaChunkedApsDone (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  gBS->CloseEvent (Event);
+}
+
+/**
+  Return the number of processors that may decompress the chunks of one
+  section at the same time, including the calling processor.
+
+  @return The number of decoders, at least 1.
+**/
+UINT32
+LzmaChunkedGetMaxDecoders (
+  VOID
+  )
+{
+  return LZMA_CHUNKED_MAX_DECODERS;
+}
+
+/**
+  Start Procedure on all enabled application processors. Nothing is done if
+  MP services are not available.
+
+  The procedure is started in non-blocking mode, so the calling processor
+  decompresses chunks at the same time. The completion event of MP services
+  is not waited for: it may be serviced at a TPL that the caller is running
+  at, such as in the DXE Core. Procedure instead reports through Argument
+  when it is done.
+
+  Procedure must not use any PEI or boot services.
+
+  @param  Procedure       The procedure to run on the application processors.
+  @param  Argument        The argument passed to Procedure.
+
+  @return The number of application processors that are running Procedure.
+**/
+UINTN
+LzmaChunkedStartupAllAps (
+  IN EFI_AP_PROCEDURE  Procedure,
+  IN VOID              *Argument
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  UINTN                     NumberOfProcessors;
+  UINTN                     NumberOfEnabledProcessors;
+  EFI_EVENT                 Event;
+
+  if (gBS == NULL) {
+    return 0;
+  }
+
+  Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **) &MpServices);
+  if (EFI_ERROR (Status)) {
+    return 0;
+  }
+
+  Status = MpServices->GetNumberOfProcessors (
+                         MpServices,
+                         &NumberOfProcessors,
+                         &NumberOfEnabledProcessors
+                         );
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors < 2)) {
+    return 0;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  LzmaChunkedApsDone,
+                  NULL,
+                  &Event
+                  );
+  if (EFI_ERROR (Status)) {
+    return 0;
+  }
+
+  //
+  // EFI_NOT_READY is returned while the APs of a previous procedure have
+  // not been collected yet. The caller then decompresses every chunk.
+  //
+  Status = MpServices->StartupAllAPs (
+                         MpServices,
+                         Procedure,
+                         FALSE,
+                         Event,
+                         0,
+                         Argument,
+                         NULL
+                         );
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (Event);
+    return 0;
+  }
+
+  return NumberOfEnabledProcessors - 1;
+}
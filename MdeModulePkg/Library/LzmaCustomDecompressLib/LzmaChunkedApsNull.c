@@ -0,0 +1,47 @@
+/** @file
+  LZMA chunked decompress without MP services, for BASE modules.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaDecompressLibInternal.h"
+
+/**
+  Return the number of processors that may decompress the chunks of one
+  section at the same time, including the calling processor.
+
+  This instance does not use MP services, so the scratch buffer only needs
+  to hold the decoder state of the calling processor.
+
+  @return The number of decoders, at least 1.
+**/
+UINT32
+LzmaChunkedGetMaxDecoders (
+  VOID
+  )
+{
+  return 1;
+}
+
+/**
+  Start Procedure on all enabled application processors. Nothing is done if
+  MP services are not available.
+
+  This instance does not use MP services; the calling processor decompresses
+  all chunks.
+
+  @param  Procedure       The procedure to run on the application processors.
+  @param  Argument        The argument passed to Procedure.
+
+  @return 0, no application processor was started.
+**/
+UINTN
+LzmaChunkedStartupAllAps (
+  IN EFI_AP_PROCEDURE  Procedure,
+  IN VOID              *Argument
+  )
+{
+  return 0;
+}
@@ -0,0 +1,430 @@
+/** @file
+  LZMA chunked decompress interfaces and GUIDed section extraction handlers.
+
+  The data of an LZMA chunked section is split into chunks that are
+  compressed independently, so they can be decompressed on all processors
+  at the same time. Each chunk is decoded with LzmaUefiDecompress().
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaDecompressLibInternal.h"
+#include <Library/SynchronizationLib.h>
+#include "Sdk/C/7zTypes.h"
+#include "Sdk/C/LzmaDec.h"
+
+#define LZMA_HEADER_SIZE (LZMA_PROPS_SIZE + 8)
+
+typedef struct {
+  CONST UINT8             *Source;
+  CONST LZMA_CHUNK_ENTRY  *Chunks;
+  UINT32                  ChunkCount;
+  UINT32                  ChunkSize;
+  UINT8                   *Destination;
+  UINT8                   *Scratch;
+  UINT32                  DecoderScratchSize;
+  UINT32                  DecoderCount;
+  //
+  // Shared by all processors
+  //
+  volatile UINT32         NextDecoder;
+  volatile UINT32         NextChunk;
+  volatile UINT32         FinishedAps;
+  volatile BOOLEAN        Failed;
+} LZMA_CHUNKED_CONTEXT;
+
+/**
+  Check the chunk table of an LZMA chunked source buffer.
+
+  @param  Source              The source buffer containing the compressed data.
+  @param  SourceSize          The size, in bytes, of the source buffer.
+  @param  DecoderScratchSize  Returns the scratch buffer size needed to decode
+                              one chunk.
+
+  @return The header of the source buffer, or NULL if it is not valid.
+**/
+CONST LZMA_CHUNKED_HEADER *
+LzmaChunkedGetHeader (
+  IN  CONST VOID  *Source,
+  IN  UINTN       SourceSize,
+  OUT UINT32      *DecoderScratchSize
+  )
+{
+  CONST LZMA_CHUNKED_HEADER  *Header;
+  CONST LZMA_CHUNK_ENTRY     *Chunks;
+  UINT32                     Index;
+  UINT32                     ExpectedSize;
+  UINT32                     DecodedSize;
+  UINT64                     TableEnd;
+
+  Header = (CONST LZMA_CHUNKED_HEADER *) Source;
+  if ((SourceSize < sizeof (LZMA_CHUNKED_HEADER)) ||
+      (Header->Signature != LZMA_CHUNKED_SIGNATURE) ||
+      (Header->ChunkCount == 0) ||
+      (Header->ChunkSize == 0)) {
+    return NULL;
+  }
+
+  //
+  // Every chunk but the last one holds ChunkSize bytes
+  //
+  if ((MultU64x32 (Header->ChunkCount - 1, Header->ChunkSize) >= Header->UncompressedSize) ||
+      (MultU64x32 (Header->ChunkCount, Header->ChunkSize) < Header->UncompressedSize)) {
+    return NULL;
+  }
+
+  TableEnd = sizeof (LZMA_CHUNKED_HEADER) + MultU64x32 (Header->ChunkCount, sizeof (LZMA_CHUNK_ENTRY));
+  if (TableEnd > SourceSize) {
+    return NULL;
+  }
+
+  Chunks = (CONST LZMA_CHUNK_ENTRY *) (Header + 1);
+  *DecoderScratchSize = 0;
+  for (Index = 0; Index < Header->ChunkCount; Index++) {
+    if ((Chunks[Index].Offset < TableEnd) ||
+        (Chunks[Index].Size < LZMA_HEADER_SIZE) ||
+        ((UINT64) Chunks[Index].Offset + Chunks[Index].Size > SourceSize)) {
+      return NULL;
+    }
+
+    if (RETURN_ERROR (LzmaUefiDecompressGetInfo (
+                        (UINT8 *) Source + Chunks[Index].Offset,
+                        Chunks[Index].Size,
+                        &DecodedSize,
+                        DecoderScratchSize
+                        ))) {
+      return NULL;
+    }
+
+    ExpectedSize = Header->ChunkSize;
+    if (Index == Header->ChunkCount - 1) {
+      ExpectedSize = Header->UncompressedSize - (Header->ChunkCount - 1) * Header->ChunkSize;
+    }
+    if (DecodedSize != ExpectedSize) {
+      return NULL;
+    }
+  }
+
+  return Header;
+}
+
+/**
+  Decompress chunks until none are left, using one part of the scratch buffer.
+
+  @param  Context         The chunked section being decompressed.
+  @param  Decoder         The index of the scratch buffer part to use.
+**/
+VOID
+LzmaChunkedDecodeChunks (
+  IN LZMA_CHUNKED_CONTEXT  *Context,
+  IN UINT32                Decoder
+  )
+{
+  UINT8          *Scratch;
+  UINT32         Index;
+  RETURN_STATUS  Status;
+
+  Scratch = Context->Scratch + (UINTN) Decoder * Context->DecoderScratchSize;
+  while (!Context->Failed) {
+    Index = InterlockedIncrement (&Context->NextChunk) - 1;
+    if (Index >= Context->ChunkCount) {
+      break;
+    }
+
+    Status = LzmaUefiDecompress (
+               Context->Source + Context->Chunks[Index].Offset,
+               Context->Chunks[Index].Size,
+               Context->Destination + (UINTN) Index * Context->ChunkSize,
+               Scratch
+               );
+    if (RETURN_ERROR (Status)) {
+      Context->Failed = TRUE;
+    }
+  }
+}
+
+/**
+  Application processor procedure that helps decompress a chunked section.
+
+  @param  Buffer          The LZMA_CHUNKED_CONTEXT of the section.
+**/
+VOID
+EFIAPI
+LzmaChunkedApDecoder (
+  IN OUT VOID  *Buffer
+  )
+{
+  LZMA_CHUNKED_CONTEXT  *Context;
+  UINT32                Decoder;
+
+  Context = (LZMA_CHUNKED_CONTEXT *) Buffer;
+  Decoder = InterlockedIncrement (&Context->NextDecoder) - 1;
+  if (Decoder < Context->DecoderCount) {
+    LzmaChunkedDecodeChunks (Context, Decoder);
+  }
+
+  //
+  // Context lives on the stack of the calling processor, so this must be
+  // the last access to it.
+  //
+  InterlockedIncrement (&Context->FinishedAps);
+}
+
+/**
+  Given an LZMA chunked source buffer, this function retrieves the size of
+  the uncompressed buffer and the size of the scratch buffer required
+  to decompress the compressed source buffer.
+
+  The scratch buffer holds one LZMA decoder state for each processor that
+  may decompress chunks at the same time.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer
+                          that will be generated when the compressed buffer specified
+                          by Source and SourceSize is decompressed.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer that
+                          is required to decompress the compressed buffer specified
+                          by Source and SourceSize.
+
+  @retval  RETURN_SUCCESS           The size of the uncompressed data was returned
+                                    in DestinationSize and the size of the scratch
+                                    buffer was returned in ScratchSize.
+  @retval  RETURN_INVALID_PARAMETER The chunk table in Source is not valid.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedUefiDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  )
+{
+  CONST LZMA_CHUNKED_HEADER  *Header;
+  UINT32                     DecoderScratchSize;
+
+  Header = LzmaChunkedGetHeader (Source, SourceSize, &DecoderScratchSize);
+  if (Header == NULL) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *DestinationSize = Header->UncompressedSize;
+  *ScratchSize = DecoderScratchSize * MIN (Header->ChunkCount, LzmaChunkedGetMaxDecoders ());
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompresses an LZMA chunked source buffer.
+
+  The chunks are decompressed on the calling processor and, if MP services
+  are available, on all enabled application processors at the same time.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data
+  @param  Scratch     A temporary scratch buffer that is used to perform the decompression,
+                      of the size returned by LzmaChunkedUefiDecompressGetInfo().
+
+  @retval  RETURN_SUCCESS Decompression completed successfully, and
+                          the uncompressed buffer is returned in Destination.
+  @retval  RETURN_INVALID_PARAMETER
+                          The source buffer specified by Source is corrupted
+                          (not in a valid compressed format).
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedUefiDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  CONST LZMA_CHUNKED_HEADER  *Header;
+  LZMA_CHUNKED_CONTEXT       Context;
+  UINTN                      RunningAps;
+
+  Header = LzmaChunkedGetHeader (Source, SourceSize, &Context.DecoderScratchSize);
+  if (Header == NULL) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Context.Source       = Source;
+  Context.Chunks       = (CONST LZMA_CHUNK_ENTRY *) (Header + 1);
+  Context.ChunkCount   = Header->ChunkCount;
+  Context.ChunkSize    = Header->ChunkSize;
+  Context.Destination  = Destination;
+  Context.Scratch      = Scratch;
+  Context.DecoderCount = MIN (Header->ChunkCount, LzmaChunkedGetMaxDecoders ());
+  Context.NextChunk    = 0;
+  Context.FinishedAps  = 0;
+  Context.Failed       = FALSE;
+
+  //
+  // The first part of the scratch buffer is kept for this processor, which
+  // takes chunks alongside the application processors.
+  //
+  Context.NextDecoder  = 1;
+  RunningAps           = 0;
+  if (Context.DecoderCount > 1) {
+    RunningAps = LzmaChunkedStartupAllAps (LzmaChunkedApDecoder, &Context);
+  }
+  LzmaChunkedDecodeChunks (&Context, 0);
+
+  while (Context.FinishedAps < RunningAps) {
+    CpuPause ();
+  }
+
+  if (Context.Failed) {
+    return RETURN_INVALID_PARAMETER;
+  }
+  return RETURN_SUCCESS;
+}
+
+/**
+  Get the data of an LZMA chunked GUIDed section.
+
+  @param[in]  InputSection  A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] Data          Returns the data of the section.
+  @param[out] DataSize      Returns the size of the data, in bytes.
+
+  @retval  RETURN_SUCCESS            The data of InputSection was returned.
+  @retval  RETURN_INVALID_PARAMETER  The section is not an LZMA chunked section.
+**/
+RETURN_STATUS
+LzmaChunkedGetSectionData (
+  IN  CONST VOID  *InputSection,
+  OUT VOID        **Data,
+  OUT UINT32      *DataSize
+  )
+{
+  if (IS_SECTION2 (InputSection)) {
+    if (!CompareGuid (
+        &gLzmaChunkedCustomDecompressGuid,
+        &(((EFI_GUID_DEFINED_SECTION2 *) InputSection)->SectionDefinitionGuid))) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    *Data = (UINT8 *) InputSection + ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->DataOffset;
+    *DataSize = SECTION2_SIZE (InputSection) - ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->DataOffset;
+  } else {
+    if (!CompareGuid (
+        &gLzmaChunkedCustomDecompressGuid,
+        &(((EFI_GUID_DEFINED_SECTION *) InputSection)->SectionDefinitionGuid))) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    *Data = (UINT8 *) InputSection + ((EFI_GUID_DEFINED_SECTION *) InputSection)->DataOffset;
+    *DataSize = SECTION_SIZE (InputSection) - ((EFI_GUID_DEFINED_SECTION *) InputSection)->DataOffset;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Examines an LZMA chunked GUIDed section and returns the size of the decoded
+  buffer and the size of a scratch buffer required to actually decode the
+  data in the section.
+
+  If InputSection is NULL, then ASSERT().
+  If OutputBufferSize is NULL, then ASSERT().
+  If ScratchBufferSize is NULL, then ASSERT().
+  If SectionAttribute is NULL, then ASSERT().
+
+  @param[in]  InputSection       A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBufferSize   A pointer to the size, in bytes, of an output buffer required
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] ScratchBufferSize  A pointer to the size, in bytes, required as scratch space
+                                 if the buffer specified by InputSection were decoded.
+  @param[out] SectionAttribute   A pointer to the attributes of the GUIDed section. See the Attributes
+                                 field of EFI_GUID_DEFINED_SECTION in the PI Specification.
+
+  @retval  RETURN_SUCCESS            The information about InputSection was returned.
+  @retval  RETURN_INVALID_PARAMETER  The information can not be retrieved from the section specified by InputSection.
+
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedGuidedSectionGetInfo (
+  IN  CONST VOID  *InputSection,
+  OUT UINT32      *OutputBufferSize,
+  OUT UINT32      *ScratchBufferSize,
+  OUT UINT16      *SectionAttribute
+  )
+{
+  RETURN_STATUS  Status;
+  VOID           *Data;
+  UINT32         DataSize;
+
+  ASSERT (InputSection != NULL);
+  ASSERT (OutputBufferSize != NULL);
+  ASSERT (ScratchBufferSize != NULL);
+  ASSERT (SectionAttribute != NULL);
+
+  Status = LzmaChunkedGetSectionData (InputSection, &Data, &DataSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  if (IS_SECTION2 (InputSection)) {
+    *SectionAttribute = ((EFI_GUID_DEFINED_SECTION2 *) InputSection)->Attributes;
+  } else {
+    *SectionAttribute = ((EFI_GUID_DEFINED_SECTION *) InputSection)->Attributes;
+  }
+
+  return LzmaChunkedUefiDecompressGetInfo (Data, DataSize, OutputBufferSize, ScratchBufferSize);
+}
+
+/**
+  Decompress an LZMA chunked GUIDed section into a caller allocated output buffer.
+
+  If InputSection is NULL, then ASSERT().
+  If OutputBuffer is NULL, then ASSERT().
+  If ScratchBuffer is NULL and this decode operation requires a scratch buffer, then ASSERT().
+  If AuthenticationStatus is NULL, then ASSERT().
+
+  @param[in]  InputSection  A pointer to a GUIDed section of an FFS formatted file.
+  @param[out] OutputBuffer  A pointer to a buffer that contains the result of a decode operation.
+  @param[out] ScratchBuffer A caller allocated buffer that may be required by this function
+                            as a scratch buffer to perform the decode operation.
+  @param[out] AuthenticationStatus
+                            A pointer to the authentication status of the decoded output buffer.
+                            See the definition of authentication status in the EFI_PEI_GUIDED_SECTION_EXTRACTION_PPI
+                            section of the PI Specification. EFI_AUTH_STATUS_PLATFORM_OVERRIDE must
+                            never be set by this handler.
+
+  @retval  RETURN_SUCCESS            The buffer specified by InputSection was decoded.
+  @retval  RETURN_INVALID_PARAMETER  The section specified by InputSection can not be decoded.
+
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedGuidedSectionExtraction (
+  IN CONST  VOID    *InputSection,
+  OUT       VOID    **OutputBuffer,
+  OUT       VOID    *ScratchBuffer,        OPTIONAL
+  OUT       UINT32  *AuthenticationStatus
+  )
+{
+  RETURN_STATUS  Status;
+  VOID           *Data;
+  UINT32         DataSize;
+
+  ASSERT (OutputBuffer != NULL);
+  ASSERT (InputSection != NULL);
+
+  Status = LzmaChunkedGetSectionData (InputSection, &Data, &DataSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Authentication is set to Zero, which may be ignored.
+  //
+  *AuthenticationStatus = 0;
+
+  return LzmaChunkedUefiDecompress (Data, DataSize, *OutputBuffer, ScratchBuffer);
+}
@@ -0,0 +1,94 @@
+/** @file
+  LZMA chunked decompress on the application processors in PEI.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaDecompressLibInternal.h"
+#include <Ppi/MpServices.h>
+#include <Library/PeiServicesLib.h>
+#include <Library/PeiServicesTablePointerLib.h>
+
+/**
+  Register the LZMA and LZMA chunked GUIDed section handlers.
+
+  @param  FileHandle    The handle of the PEIM.
+  @param  PeiServices   The PEI services table.
+
+  @retval  RETURN_SUCCESS            Register successfully.
+  @retval  RETURN_OUT_OF_RESOURCES   No enough memory to store this handler.
+**/
+EFI_STATUS
+EFIAPI
+PeiLzmaDecompressLibConstructor (
+  IN EFI_PEI_FILE_HANDLE     FileHandle,
+  IN CONST EFI_PEI_SERVICES  **PeiServices
+  )
+{
+  return LzmaDecompressLibConstructor ();
+}
+
+/**
+  Return the number of processors that may decompress the chunks of one
+  section at the same time, including the calling processor.
+
+  @return The number of decoders, at least 1.
+**/
+UINT32
+LzmaChunkedGetMaxDecoders (
+  VOID
+  )
+{
+  return LZMA_CHUNKED_MAX_DECODERS;
+}
+
+/**
+  Start Procedure on all enabled application processors. Nothing is done if
+  MP services are not available.
+
+  The PI MP services PPI has no non-blocking mode, so this waits for the
+  application processors to finish, and the calling processor only takes
+  the chunks that are left.
+
+  Procedure must not use any PEI or boot services.
+
+  @param  Procedure       The procedure to run on the application processors.
+  @param  Argument        The argument passed to Procedure.
+
+  @return 0, the application processors are done when this function returns.
+**/
+UINTN
+LzmaChunkedStartupAllAps (
+  IN EFI_AP_PROCEDURE  Procedure,
+  IN VOID              *Argument
+  )
+{
+  EFI_STATUS               Status;
+  EFI_PEI_MP_SERVICES_PPI  *MpServices;
+
+  Status = PeiServicesLocatePpi (
+             &gEfiPeiMpServicesPpiGuid,
+             0,
+             NULL,
+             (VOID **) &MpServices
+             );
+  if (EFI_ERROR (Status)) {
+    return 0;
+  }
+
+  //
+  // EFI_NOT_STARTED is returned if there are no enabled APs. The caller
+  // decompresses whatever is left in any case.
+  //
+  MpServices->StartupAllAPs (
+                GetPeiServicesTablePointer (),
+                MpServices,
+                Procedure,
+                FALSE,
+                0,
+                Argument
+                );
+  return 0;
+}
@@ -91,9 +91,13 @@ GetLbaAndOffsetByAddress (
   This function writes a buffer to variable storage space into a firmware
   volume block device. The destination is specified by parameter
   VariableBase. Fault Tolerant Write protocol is used for writing.
+  Only the range that differs from the current content of the variable
+  storage space is written.
 
   @param  VariableBase   Base address of variable to write
   @param  VariableBuffer Point to the variable data buffer.
+  @param  BytesWritten   Optional pointer to return the number of bytes
+                         written through FTW.
 
   @retval EFI_SUCCESS    The function completed successfully.
   @retval EFI_NOT_FOUND  Fail to locate Fault Tolerant Write protocol.
@@ -103,7 +107,8 @@ GetLbaAndOffsetByAddress (
 EFI_STATUS
 FtwVariableSpace (
   IN EFI_PHYSICAL_ADDRESS   VariableBase,
-  IN VARIABLE_STORE_HEADER  *VariableBuffer
+  IN VARIABLE_STORE_HEADER  *VariableBuffer,
+  OUT UINTN                 *BytesWritten OPTIONAL
   )
 {
   EFI_STATUS                         Status;
@@ -111,8 +116,16 @@ FtwVariableSpace (
   EFI_LBA                            VarLba;
   UINTN                              VarOffset;
   UINTN                              FtwBufferSize;
+  UINTN                              Start;
+  UINTN                              End;
+  UINT8                              *Current;
+  UINT8                              *Buffer;
   EFI_FAULT_TOLERANT_WRITE_PROTOCOL  *FtwProtocol;
 
+  if (BytesWritten != NULL) {
+    *BytesWritten = 0;
+  }
+
   //
   // Locate fault tolerant write protocol.
   //
@@ -127,17 +140,34 @@ FtwVariableSpace (
   if (EFI_ERROR (Status)) {
     return Status;
   }
+
+  FtwBufferSize = ((VARIABLE_STORE_HEADER *) ((UINTN) VariableBase))->Size;
+  ASSERT (FtwBufferSize == VariableBuffer->Size);
+
+  //
+  // Reclaim keeps the leading valid variables in place and both the old and
+  // the new store end in erased space, so only the range in between has to
+  // go through FTW. This keeps the write, and the number of blocks the FTW
+  // has to spare and erase, proportional to what actually moved.
+  //
+  Current = (UINT8 *) (UINTN) VariableBase;
+  Buffer  = (UINT8 *) VariableBuffer;
+  for (Start = 0; Start < FtwBufferSize && Current[Start] == Buffer[Start]; Start++) {
+  }
+  if (Start == FtwBufferSize) {
+    return EFI_SUCCESS;
+  }
+  for (End = FtwBufferSize; Current[End - 1] == Buffer[End - 1]; End--) {
+  }
+
   //
   // Get LBA and Offset by address.
   //
-  Status = GetLbaAndOffsetByAddress (VariableBase, &VarLba, &VarOffset);
+  Status = GetLbaAndOffsetByAddress (VariableBase + Start, &VarLba, &VarOffset);
   if (EFI_ERROR (Status)) {
     return EFI_ABORTED;
   }
 
-  FtwBufferSize = ((VARIABLE_STORE_HEADER *) ((UINTN) VariableBase))->Size;
-  ASSERT (FtwBufferSize == VariableBuffer->Size);
-
   //
   // FTW write record.
   //
@@ -145,11 +175,14 @@ FtwVariableSpace (
                           FtwProtocol,
                           VarLba,         // LBA
                           VarOffset,      // Offset
-                          FtwBufferSize,  // NumBytes
+                          End - Start,    // NumBytes
                           NULL,           // PrivateData NULL
                           FvbHandle,      // Fvb Handle
-                          (VOID *) VariableBuffer // write buffer
+                          (VOID *) (Buffer + Start) // write buffer
                           );
+  if (!EFI_ERROR (Status) && (BytesWritten != NULL)) {
+    *BytesWritten = End - Start;
+  }
 
   return Status;
 }
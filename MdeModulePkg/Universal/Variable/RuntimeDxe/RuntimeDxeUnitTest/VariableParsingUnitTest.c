@@ -0,0 +1,737 @@
+/** @file
+  This is a host-based unit test for the variable store index used by
+  FindVariableEx () and VariableServiceGetNextVariableInternal ().
+
+  Every lookup is checked against the linear walk of the variable store, which
+  is what FindVariableEx () does for stores that are not indexed.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include "../VariableParsing.h"
+
+#include <Library/PrintLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_NAME        "Variable Store Index Unit Test"
+#define UNIT_TEST_VERSION     "1.0"
+
+#define TEST_STORE_SIZE       SIZE_1MB
+#define TEST_VARIABLE_COUNT   4000
+#define TEST_GUID_COUNT       4
+#define TEST_NAME_LENGTH      16
+
+//
+// Bit patterns applied to every Nth test variable to exercise the state
+// handling of the index.
+//
+#define TEST_DELETED_EVERY          7
+#define TEST_IN_DELETED_EVERY       11
+#define TEST_BOOT_SERVICE_EVERY     5
+
+EFI_GUID  mTestGuids[TEST_GUID_COUNT] = {
+  { 0x8BE4DF61, 0x93CA, 0x11D2, { 0xAA, 0x0D, 0x00, 0xE0, 0x98, 0x03, 0x2B, 0x8C } },
+  { 0xD719B2CB, 0x3D3A, 0x4596, { 0xA3, 0xBC, 0xDA, 0xD0, 0x0E, 0x67, 0x65, 0x6F } },
+  { 0x605DAB50, 0xE046, 0x4300, { 0xAB, 0xB6, 0x3D, 0xD8, 0x10, 0xDD, 0x8B, 0x23 } },
+  { 0x77FA9ABD, 0x0359, 0x4D32, { 0xBD, 0x60, 0x28, 0xF4, 0xE7, 0x8F, 0x78, 0x4B } }
+};
+
+BOOLEAN  mAtRuntime;
+
+typedef struct {
+  VARIABLE_STORE_HEADER  *Stores[VariableStoreTypeMax];
+  UINTN                  LastOffset[VariableStoreTypeMax];
+  ///
+  /// Unindexed copy of a store, searched by the linear walk for reference.
+  ///
+  VARIABLE_STORE_HEADER  *Reference;
+} VARIABLE_INDEX_TEST_CONTEXT;
+
+VARIABLE_INDEX_TEST_CONTEXT  mTestContext;
+
+///=== STUBS ======================================================================================
+
+/**
+  This function is a stub of the variable driver implementation.
+
+  @retval TRUE   The test currently simulates runtime.
+  @retval FALSE  The test currently simulates boot time.
+
+**/
+BOOLEAN
+AtRuntime (
+  VOID
+  )
+{
+  return mAtRuntime;
+}
+
+///=== HELPERS ====================================================================================
+
+/**
+  Allocates an empty authenticated variable store.
+
+  @return The variable store.
+
+**/
+STATIC
+VARIABLE_STORE_HEADER *
+CreateStore (
+  VOID
+  )
+{
+  VARIABLE_STORE_HEADER  *Store;
+
+  Store = AllocatePool (TEST_STORE_SIZE);
+  ASSERT (Store != NULL);
+  SetMem (Store, TEST_STORE_SIZE, 0xFF);
+  CopyGuid (&Store->Signature, &gEfiAuthenticatedVariableGuid);
+  Store->Size      = TEST_STORE_SIZE;
+  Store->Format    = VARIABLE_STORE_FORMATTED;
+  Store->State     = VARIABLE_STORE_HEALTHY;
+  Store->Reserved  = 0;
+  Store->Reserved1 = 0;
+  return Store;
+}
+
+/**
+  Appends a variable to a test store.
+
+  @param[in] StoreType   The store to append the variable to.
+  @param[in] Name        Name of the variable.
+  @param[in] Guid        Vendor GUID of the variable.
+  @param[in] Attributes  Attributes of the variable.
+  @param[in] State       State of the variable.
+
+  @return The header of the new variable.
+
+**/
+STATIC
+VARIABLE_HEADER *
+AppendVariable (
+  IN VARIABLE_STORE_TYPE  StoreType,
+  IN CHAR16               *Name,
+  IN EFI_GUID             *Guid,
+  IN UINT32               Attributes,
+  IN UINT8                State
+  )
+{
+  VARIABLE_HEADER  *Variable;
+  UINT32           Data;
+
+  Variable = (VARIABLE_HEADER *) ((UINTN) mTestContext.Stores[StoreType] + mTestContext.LastOffset[StoreType]);
+  ZeroMem (Variable, GetVariableHeaderSize (TRUE));
+  Variable->StartId    = VARIABLE_DATA;
+  Variable->State      = State;
+  Variable->Attributes = Attributes;
+  SetNameSizeOfVariable (Variable, StrSize (Name), TRUE);
+  SetDataSizeOfVariable (Variable, sizeof (Data), TRUE);
+  CopyGuid (GetVendorGuidPtr (Variable, TRUE), Guid);
+  CopyMem (GetVariableNamePtr (Variable, TRUE), Name, StrSize (Name));
+  Data = (UINT32) mTestContext.LastOffset[StoreType];
+  CopyMem (GetVariableDataPtr (Variable, TRUE), &Data, sizeof (Data));
+
+  mTestContext.LastOffset[StoreType] = (UINTN) GetNextVariablePtr (Variable, TRUE) - (UINTN) mTestContext.Stores[StoreType];
+  ASSERT (mTestContext.LastOffset[StoreType] < TEST_STORE_SIZE);
+  return Variable;
+}
+
+/**
+  Fills the NV store with TEST_VARIABLE_COUNT variables, some of which are
+  deleted, in delete transition, or not runtime accessible.
+
+**/
+STATIC
+VOID
+PopulateNvStore (
+  VOID
+  )
+{
+  CHAR16           Name[TEST_NAME_LENGTH];
+  UINTN            Index;
+  UINT32           Attributes;
+  VARIABLE_HEADER  *Variable;
+
+  for (Index = 0; Index < TEST_VARIABLE_COUNT; Index++) {
+    UnicodeSPrint (Name, sizeof (Name), L"Var%04d", (UINT32) Index);
+    Attributes = EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS;
+    if ((Index % TEST_BOOT_SERVICE_EVERY) != 0) {
+      Attributes |= EFI_VARIABLE_RUNTIME_ACCESS;
+    }
+
+    if ((Index % TEST_IN_DELETED_EVERY) == 0) {
+      //
+      // An interrupted update: the old copy is in delete transition and, for
+      // every other such variable, the new copy was added after it.
+      //
+      AppendVariable (VariableStoreTypeNv, Name, &mTestGuids[Index % TEST_GUID_COUNT], Attributes, VAR_IN_DELETED_TRANSITION & VAR_ADDED);
+      if ((Index % 2) == 0) {
+        AppendVariable (VariableStoreTypeNv, Name, &mTestGuids[Index % TEST_GUID_COUNT], Attributes, VAR_ADDED);
+      }
+      continue;
+    }
+
+    Variable = AppendVariable (VariableStoreTypeNv, Name, &mTestGuids[Index % TEST_GUID_COUNT], Attributes, VAR_ADDED);
+    if ((Index % TEST_DELETED_EVERY) == 0) {
+      Variable->State &= VAR_DELETED;
+      //
+      // Deleted variables are usually followed by their updated copy.
+      //
+      if ((Index % 2) == 0) {
+        AppendVariable (VariableStoreTypeNv, Name, &mTestGuids[Index % TEST_GUID_COUNT], Attributes, VAR_ADDED);
+      }
+    }
+  }
+}
+
+/**
+  Copies a test store to the reference store.
+
+  @param[in] StoreType  The store to copy.
+
+**/
+STATIC
+VOID
+SyncReferenceStore (
+  IN VARIABLE_STORE_TYPE  StoreType
+  )
+{
+  CopyMem (mTestContext.Reference, mTestContext.Stores[StoreType], TEST_STORE_SIZE);
+}
+
+/**
+  Returns the offset of a variable from the start of its store.
+
+  @param[in] Variable  The variable, or NULL.
+  @param[in] Store     The store holding Variable.
+
+  @return The offset of Variable, or MAX_UINTN if Variable is NULL.
+
+**/
+STATIC
+UINTN
+VariableOffset (
+  IN VARIABLE_HEADER        *Variable,
+  IN VARIABLE_STORE_HEADER  *Store
+  )
+{
+  return (Variable == NULL) ? MAX_UINTN : (UINTN) Variable - (UINTN) Store;
+}
+
+/**
+  Looks a variable up in an indexed test store and with the linear walk in the
+  reference copy of the store, and checks that both lookups agree.
+
+  @param[in] StoreType      The store to search. The reference store must hold
+                            a copy of it.
+  @param[in] Name           Name of the variable.
+  @param[in] Guid           Vendor GUID of the variable.
+  @param[in] IgnoreRtCheck  Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute check
+                            at runtime.
+
+  @retval TRUE   Both lookups returned the same result.
+  @retval FALSE  The lookups differ.
+
+**/
+STATIC
+BOOLEAN
+LookupsAgree (
+  IN VARIABLE_STORE_TYPE  StoreType,
+  IN CHAR16               *Name,
+  IN EFI_GUID             *Guid,
+  IN BOOLEAN              IgnoreRtCheck
+  )
+{
+  VARIABLE_STORE_HEADER   *Store;
+  VARIABLE_POINTER_TRACK  Indexed;
+  VARIABLE_POINTER_TRACK  Linear;
+  EFI_STATUS              IndexedStatus;
+  EFI_STATUS              LinearStatus;
+
+  Store = mTestContext.Stores[StoreType];
+  ZeroMem (&Indexed, sizeof (Indexed));
+  Indexed.StartPtr = GetStartPointer (Store);
+  Indexed.EndPtr   = GetEndPointer (Store);
+  ZeroMem (&Linear, sizeof (Linear));
+  Linear.StartPtr  = GetStartPointer (mTestContext.Reference);
+  Linear.EndPtr    = GetEndPointer (mTestContext.Reference);
+
+  IndexedStatus = FindVariableEx (Name, Guid, IgnoreRtCheck, &Indexed, TRUE);
+  LinearStatus  = FindVariableEx (Name, Guid, IgnoreRtCheck, &Linear, TRUE);
+
+  if ((IndexedStatus != LinearStatus) ||
+      (VariableOffset (Indexed.CurrPtr, Store) != VariableOffset (Linear.CurrPtr, mTestContext.Reference)) ||
+      (!EFI_ERROR (LinearStatus) &&
+       (VariableOffset (Indexed.InDeletedTransitionPtr, Store) != VariableOffset (Linear.InDeletedTransitionPtr, mTestContext.Reference)))) {
+    UT_LOG_ERROR (
+      "%s: indexed %r %x %x, linear %r %x %x\n",
+      Name,
+      IndexedStatus,
+      (UINT32) VariableOffset (Indexed.CurrPtr, Store),
+      (UINT32) VariableOffset (Indexed.InDeletedTransitionPtr, Store),
+      LinearStatus,
+      (UINT32) VariableOffset (Linear.CurrPtr, mTestContext.Reference),
+      (UINT32) VariableOffset (Linear.InDeletedTransitionPtr, mTestContext.Reference)
+      );
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+  Enumerates all variables with VariableServiceGetNextVariableInternal ().
+
+  @param[out] Variables  Receives the variable headers in enumeration order.
+                         Must hold TEST_VARIABLE_COUNT * 2 entries.
+
+  @return The number of variables enumerated.
+
+**/
+STATIC
+UINTN
+EnumerateVariables (
+  OUT VARIABLE_HEADER  **Variables
+  )
+{
+  EFI_STATUS       Status;
+  CHAR16           Name[TEST_NAME_LENGTH];
+  EFI_GUID         Guid;
+  VARIABLE_HEADER  *Variable;
+  UINTN            Count;
+
+  Name[0] = 0;
+  ZeroMem (&Guid, sizeof (Guid));
+  for (Count = 0; Count < TEST_VARIABLE_COUNT * 2; Count++) {
+    Status = VariableServiceGetNextVariableInternal (Name, &Guid, mTestContext.Stores, &Variable, TRUE);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Variables[Count] = Variable;
+    CopyMem (Name, GetVariableNamePtr (Variable, TRUE), NameSizeOfVariable (Variable, TRUE));
+    CopyGuid (&Guid, GetVendorGuidPtr (Variable, TRUE));
+  }
+
+  return Count;
+}
+
+/**
+  Registers or unregisters all the test stores with the index.
+
+  @param[in] Enable  TRUE to index the test stores.
+
+**/
+STATIC
+VOID
+IndexStores (
+  IN BOOLEAN  Enable
+  )
+{
+  VARIABLE_STORE_TYPE  StoreType;
+
+  for (StoreType = (VARIABLE_STORE_TYPE) 0; StoreType < VariableStoreTypeMax; StoreType++) {
+    VariableStoreIndexRegister (StoreType, Enable ? mTestContext.Stores[StoreType] : NULL);
+  }
+}
+
+///=== TEST CASES =================================================================================
+
+/**
+  Creates the volatile, HOB and NV test stores and fills the NV store.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED  The stores were created.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+VariableIndexTestSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_STORE_TYPE  StoreType;
+
+  mAtRuntime = FALSE;
+  for (StoreType = (VARIABLE_STORE_TYPE) 0; StoreType < VariableStoreTypeMax; StoreType++) {
+    mTestContext.Stores[StoreType]     = CreateStore ();
+    mTestContext.LastOffset[StoreType] = (UINTN) GetStartPointer (mTestContext.Stores[StoreType]) - (UINTN) mTestContext.Stores[StoreType];
+  }
+
+  mTestContext.Reference = CreateStore ();
+
+  PopulateNvStore ();
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Frees the test stores and drops their indexes.
+
+  @param[in]  Context    Unused.
+
+**/
+VOID
+EFIAPI
+VariableIndexTestCleanup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_STORE_TYPE  StoreType;
+
+  IndexStores (FALSE);
+  for (StoreType = (VARIABLE_STORE_TYPE) 0; StoreType < VariableStoreTypeMax; StoreType++) {
+    FreePool (mTestContext.Stores[StoreType]);
+  }
+  FreePool (mTestContext.Reference);
+  ZeroMem (&mTestContext, sizeof (mTestContext));
+}
+
+/**
+  Every name in the store, and names that are not in it, must be found at the
+  same location with and without the index, at boot time and at runtime.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The lookups agree.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A lookup differs.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexedLookupMatchesLinearSearch (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CHAR16   Name[TEST_NAME_LENGTH];
+  UINTN    Index;
+  UINTN    Pass;
+  BOOLEAN  IgnoreRtCheck;
+
+  IndexStores (TRUE);
+  SyncReferenceStore (VariableStoreTypeNv);
+
+  //
+  // Boot time, runtime, and runtime ignoring the runtime access attribute.
+  //
+  for (Pass = 0; Pass < 3; Pass++) {
+    mAtRuntime    = (BOOLEAN) (Pass != 0);
+    IgnoreRtCheck = (BOOLEAN) (Pass == 2);
+    for (Index = 0; Index < TEST_VARIABLE_COUNT + 16; Index++) {
+      UnicodeSPrint (Name, sizeof (Name), L"Var%04d", (UINT32) Index);
+      UT_ASSERT_TRUE (LookupsAgree (VariableStoreTypeNv, Name, &mTestGuids[Index % TEST_GUID_COUNT], IgnoreRtCheck));
+      UT_ASSERT_TRUE (LookupsAgree (VariableStoreTypeNv, Name, &mTestGuids[(Index + 1) % TEST_GUID_COUNT], IgnoreRtCheck));
+    }
+
+    UT_ASSERT_TRUE (LookupsAgree (VariableStoreTypeNv, L"Var", &mTestGuids[0], IgnoreRtCheck));
+    UT_ASSERT_TRUE (LookupsAgree (VariableStoreTypeNv, L"Var00000", &mTestGuids[0], IgnoreRtCheck));
+    UT_ASSERT_TRUE (LookupsAgree (VariableStoreTypeNv, L"", &mTestGuids[0], IgnoreRtCheck));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The index must pick up variables appended to the store and state changes of
+  indexed variables without being invalidated.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The index followed the store.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A lookup missed an update.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexFollowsStoreUpdates (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_POINTER_TRACK  PtrTrack;
+  VARIABLE_HEADER         *Variable;
+  VARIABLE_HEADER         *NewVariable;
+  UINT32                  Attributes;
+
+  Attributes = EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS;
+  VariableStoreIndexRegister (VariableStoreTypeNv, mTestContext.Stores[VariableStoreTypeNv]);
+
+  ZeroMem (&PtrTrack, sizeof (PtrTrack));
+  PtrTrack.StartPtr = GetStartPointer (mTestContext.Stores[VariableStoreTypeNv]);
+  PtrTrack.EndPtr   = GetEndPointer (mTestContext.Stores[VariableStoreTypeNv]);
+  UT_ASSERT_EQUAL (FindVariableEx (L"NewVar", &mTestGuids[1], FALSE, &PtrTrack, TRUE), EFI_NOT_FOUND);
+
+  //
+  // A variable whose write is still in progress is not visible, and becomes
+  // visible once it is added.
+  //
+  Variable = AppendVariable (VariableStoreTypeNv, L"NewVar", &mTestGuids[1], Attributes, VAR_HEADER_VALID_ONLY);
+  UT_ASSERT_EQUAL (FindVariableEx (L"NewVar", &mTestGuids[1], FALSE, &PtrTrack, TRUE), EFI_NOT_FOUND);
+  Variable->State = VAR_ADDED;
+  UT_ASSERT_NOT_EFI_ERROR (FindVariableEx (L"NewVar", &mTestGuids[1], FALSE, &PtrTrack, TRUE));
+  UT_ASSERT_TRUE (PtrTrack.CurrPtr == Variable);
+
+  //
+  // Update it the way UpdateVariable () does.
+  //
+  Variable->State &= VAR_IN_DELETED_TRANSITION;
+  NewVariable = AppendVariable (VariableStoreTypeNv, L"NewVar", &mTestGuids[1], Attributes, VAR_ADDED);
+  UT_ASSERT_NOT_EFI_ERROR (FindVariableEx (L"NewVar", &mTestGuids[1], FALSE, &PtrTrack, TRUE));
+  UT_ASSERT_TRUE (PtrTrack.CurrPtr == NewVariable);
+  UT_ASSERT_TRUE (PtrTrack.InDeletedTransitionPtr == Variable);
+  Variable->State &= VAR_DELETED;
+  UT_ASSERT_NOT_EFI_ERROR (FindVariableEx (L"NewVar", &mTestGuids[1], FALSE, &PtrTrack, TRUE));
+  UT_ASSERT_TRUE (PtrTrack.CurrPtr == NewVariable);
+  UT_ASSERT_TRUE (PtrTrack.InDeletedTransitionPtr == NULL);
+
+  //
+  // And delete it.
+  //
+  NewVariable->State &= VAR_DELETED;
+  UT_ASSERT_EQUAL (FindVariableEx (L"NewVar", &mTestGuids[1], FALSE, &PtrTrack, TRUE), EFI_NOT_FOUND);
+  SyncReferenceStore (VariableStoreTypeNv);
+  UT_ASSERT_TRUE (LookupsAgree (VariableStoreTypeNv, L"NewVar", &mTestGuids[1], FALSE));
+  UT_ASSERT_TRUE (LookupsAgree (VariableStoreTypeNv, L"Var0022", &mTestGuids[2], FALSE));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  After the store is rewritten, as Reclaim () does, an invalidated index must
+  return the new locations.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The rebuilt index matches the store.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A lookup returned a stale location.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexRebuiltAfterInvalidate (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_POINTER_TRACK  PtrTrack;
+  VARIABLE_STORE_HEADER   *Store;
+  VARIABLE_HEADER         *Variable;
+  VARIABLE_HEADER         *NextVariable;
+  UINT8                   *Compacted;
+  UINTN                   Size;
+
+  Store = mTestContext.Stores[VariableStoreTypeNv];
+  VariableStoreIndexRegister (VariableStoreTypeNv, Store);
+
+  ZeroMem (&PtrTrack, sizeof (PtrTrack));
+  PtrTrack.StartPtr = GetStartPointer (Store);
+  PtrTrack.EndPtr   = GetEndPointer (Store);
+  UT_ASSERT_NOT_EFI_ERROR (FindVariableEx (L"Var0100", &mTestGuids[0], FALSE, &PtrTrack, TRUE));
+
+  //
+  // Keep only the added variables, moving them to the start of the store.
+  //
+  Compacted = AllocatePool (TEST_STORE_SIZE);
+  UT_ASSERT_NOT_NULL (Compacted);
+  SetMem (Compacted, TEST_STORE_SIZE, 0xFF);
+  CopyMem (Compacted, Store, sizeof (VARIABLE_STORE_HEADER));
+  Size = (UINTN) GetStartPointer (Store) - (UINTN) Store;
+  for (Variable = GetStartPointer (Store); IsValidVariableHeader (Variable, GetEndPointer (Store)); Variable = NextVariable) {
+    NextVariable = GetNextVariablePtr (Variable, TRUE);
+    if (Variable->State == VAR_ADDED) {
+      CopyMem (Compacted + Size, Variable, (UINTN) NextVariable - (UINTN) Variable);
+      Size += (UINTN) NextVariable - (UINTN) Variable;
+    }
+  }
+  CopyMem (Store, Compacted, TEST_STORE_SIZE);
+  FreePool (Compacted);
+  mTestContext.LastOffset[VariableStoreTypeNv] = Size;
+
+  VariableStoreIndexInvalidate ();
+  SyncReferenceStore (VariableStoreTypeNv);
+  UT_ASSERT_TRUE (LookupsAgree (VariableStoreTypeNv, L"Var0100", &mTestGuids[0], FALSE));
+  UT_ASSERT_TRUE (LookupsAgree (VariableStoreTypeNv, L"Var0111", &mTestGuids[3], FALSE));
+  UT_ASSERT_TRUE (LookupsAgree (VariableStoreTypeNv, L"Var3999", &mTestGuids[3], FALSE));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  GetNextVariableName () must return the same variables in the same order with
+  and without the index, including HOB variables that override NV ones.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The enumerations agree.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  The enumerations differ.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexedEnumerationMatchesLinearEnumeration (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_HEADER  **Indexed;
+  VARIABLE_HEADER  **Linear;
+  UINTN            IndexedCount;
+  UINTN            LinearCount;
+  UINT32           Attributes;
+
+  Attributes = EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS;
+  AppendVariable (VariableStoreTypeVolatile, L"VolatileVar", &mTestGuids[0], Attributes, VAR_ADDED);
+  AppendVariable (VariableStoreTypeHob, L"Var0001", &mTestGuids[1], Attributes | EFI_VARIABLE_NON_VOLATILE, VAR_ADDED);
+  AppendVariable (VariableStoreTypeHob, L"HobVar", &mTestGuids[2], Attributes | EFI_VARIABLE_NON_VOLATILE, VAR_ADDED);
+
+  Indexed = AllocatePool (TEST_VARIABLE_COUNT * 2 * sizeof (VARIABLE_HEADER *));
+  Linear  = AllocatePool (TEST_VARIABLE_COUNT * 2 * sizeof (VARIABLE_HEADER *));
+  UT_ASSERT_NOT_NULL (Indexed);
+  UT_ASSERT_NOT_NULL (Linear);
+
+  for (mAtRuntime = FALSE; ; mAtRuntime = TRUE) {
+    IndexStores (TRUE);
+    IndexedCount = EnumerateVariables (Indexed);
+    IndexStores (FALSE);
+    LinearCount = EnumerateVariables (Linear);
+
+    UT_LOG_INFO ("Enumerated %u variables\n", (UINT32) LinearCount);
+    UT_ASSERT_TRUE (LinearCount > 2);
+    UT_ASSERT_EQUAL (IndexedCount, LinearCount);
+    UT_ASSERT_MEM_EQUAL (Indexed, Linear, LinearCount * sizeof (VARIABLE_HEADER *));
+    if (mAtRuntime) {
+      break;
+    }
+  }
+
+  FreePool (Indexed);
+  FreePool (Linear);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measures a full GetNextVariableName () enumeration of the test stores with
+  and without the index.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED  The benchmark completed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+EnumerationBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VARIABLE_HEADER  **Variables;
+  clock_t          Start;
+  clock_t          IndexedTime;
+  clock_t          LinearTime;
+  UINTN            Count;
+
+  Variables = AllocatePool (TEST_VARIABLE_COUNT * 2 * sizeof (VARIABLE_HEADER *));
+  UT_ASSERT_NOT_NULL (Variables);
+
+  IndexStores (TRUE);
+  Start       = clock ();
+  Count       = EnumerateVariables (Variables);
+  IndexedTime = clock () - Start;
+
+  IndexStores (FALSE);
+  Start      = clock ();
+  EnumerateVariables (Variables);
+  LinearTime = clock () - Start;
+
+  UT_LOG_INFO (
+    "Enumerating %u variables: %u us indexed, %u us linear\n",
+    (UINT32) Count,
+    (UINT32) ((UINT64) IndexedTime * 1000000 / CLOCKS_PER_SEC),
+    (UINT32) ((UINT64) LinearTime * 1000000 / CLOCKS_PER_SEC)
+    );
+
+  FreePool (Variables);
+  return UNIT_TEST_PASSED;
+}
+
+///=== TEST ENGINE ================================================================================
+
+/**
+  This is the main function for the variable store index unit test.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      IndexTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&IndexTests, Framework, "Variable Store Index Tests", "VarIndex", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for IndexTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+  AddTestCase (IndexTests, "Indexed lookups should match the linear search", "Lookup", IndexedLookupMatchesLinearSearch, VariableIndexTestSetup, VariableIndexTestCleanup, NULL);
+  AddTestCase (IndexTests, "The index should follow appends and state changes", "Update", IndexFollowsStoreUpdates, VariableIndexTestSetup, VariableIndexTestCleanup, NULL);
+  AddTestCase (IndexTests, "The index should be rebuilt after a reclaim", "Reclaim", IndexRebuiltAfterInvalidate, VariableIndexTestSetup, VariableIndexTestCleanup, NULL);
+  AddTestCase (IndexTests, "Indexed enumeration should match the linear enumeration", "Enumerate", IndexedEnumerationMatchesLinearEnumeration, VariableIndexTestSetup, VariableIndexTestCleanup, NULL);
+  AddTestCase (IndexTests, "GetNextVariableName enumeration throughput", "Benchmark", EnumerationBenchmark, VariableIndexTestSetup, VariableIndexTestCleanup, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define Main main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+Main (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
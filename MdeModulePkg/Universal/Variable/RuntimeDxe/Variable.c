@@ -538,8 +538,11 @@ Reclaim (
   VARIABLE_HEADER       *UpdatingVariable;
   VARIABLE_HEADER       *UpdatingInDeletedTransition;
   BOOLEAN               AuthFormat;
+  UINTN                 PreviousLastVariableOffset;
+  UINTN                 BytesWritten;
 
   AuthFormat = mVariableModuleGlobal->VariableGlobal.AuthFormat;
+  PreviousLastVariableOffset = *LastVariableOffset;
   UpdatingVariable = NULL;
   UpdatingInDeletedTransition = NULL;
   if (UpdatingPtrTrack != NULL) {
@@ -744,13 +747,29 @@ Reclaim (
     //
     Status = FtwVariableSpace (
               VariableBase,
-              (VARIABLE_STORE_HEADER *) ValidBuffer
+              (VARIABLE_STORE_HEADER *) ValidBuffer,
+              &BytesWritten
               );
     if (!EFI_ERROR (Status)) {
       *LastVariableOffset = (UINTN) CurrPtr - (UINTN) ValidBuffer;
       mVariableModuleGlobal->HwErrVariableTotalSize = HwErrVariableTotalSize;
       mVariableModuleGlobal->CommonVariableTotalSize = CommonVariableTotalSize;
       mVariableModuleGlobal->CommonUserVariableTotalSize = CommonUserVariableTotalSize;
+
+      mVariableModuleGlobal->ReclaimStatistics.ReclaimCount++;
+      mVariableModuleGlobal->ReclaimStatistics.BytesWritten += BytesWritten;
+      mVariableModuleGlobal->ReclaimStatistics.BytesSkipped += VariableStoreHeader->Size - BytesWritten;
+      if (PreviousLastVariableOffset > *LastVariableOffset) {
+        mVariableModuleGlobal->ReclaimStatistics.BytesReclaimed += PreviousLastVariableOffset - *LastVariableOffset;
+      }
+      DEBUG ((
+        DEBUG_INFO,
+        "Variable: Reclaim %u freed 0x%Lx bytes, wrote 0x%Lx of 0x%x bytes\n",
+        mVariableModuleGlobal->ReclaimStatistics.ReclaimCount,
+        (UINT64) (PreviousLastVariableOffset > *LastVariableOffset ? PreviousLastVariableOffset - *LastVariableOffset : 0),
+        (UINT64) BytesWritten,
+        VariableStoreHeader->Size
+        ));
     } else {
       mVariableModuleGlobal->HwErrVariableTotalSize = 0;
       mVariableModuleGlobal->CommonVariableTotalSize = 0;
@@ -775,6 +794,11 @@ Reclaim (
   }
 
 Done:
+  //
+  // The variables have moved, the indexes have to be rebuilt.
+  //
+  VariableStoreIndexInvalidate ();
+
   DoneStatus = EFI_SUCCESS;
   if (IsVolatile || mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
     DoneStatus = SynchronizeRuntimeVariableCache (
@@ -3074,7 +3098,44 @@ VariableServiceQueryVariableInfo (
 }
 
 /**
-  This function reclaims variable storage if free size is below the threshold.
+  Returns the number of bytes the non-volatile variable store would give back
+  if it was reclaimed.
+
+  @return The size of the deleted variables in the non-volatile variable store.
+
+**/
+UINTN
+GetReclaimableVariableSpace (
+  VOID
+  )
+{
+  VARIABLE_STORE_HEADER  *VariableStoreHeader;
+  VARIABLE_HEADER        *Variable;
+  VARIABLE_HEADER        *NextVariable;
+  UINTN                  ReclaimableSize;
+  BOOLEAN                AuthFormat;
+
+  AuthFormat          = mVariableModuleGlobal->VariableGlobal.AuthFormat;
+  VariableStoreHeader = (VARIABLE_STORE_HEADER *) (UINTN) mVariableModuleGlobal->VariableGlobal.NonVolatileVariableBase;
+  ReclaimableSize     = 0;
+
+  Variable = GetStartPointer (VariableStoreHeader);
+  while (IsValidVariableHeader (Variable, GetEndPointer (VariableStoreHeader))) {
+    NextVariable = GetNextVariablePtr (Variable, AuthFormat);
+    if ((Variable->State != VAR_ADDED) && (Variable->State != (VAR_IN_DELETED_TRANSITION & VAR_ADDED))) {
+      ReclaimableSize += (UINTN) NextVariable - (UINTN) Variable;
+    }
+
+    Variable = NextVariable;
+  }
+
+  return ReclaimableSize;
+}
+
+/**
+  This function reclaims variable storage if free size is below the threshold,
+  or if the deleted variables take up more than PcdReclaimVariableSpaceThreshold
+  percent of it.
 
   Caution: This function may be invoked at SMM mode.
   Care must be taken to make sure not security issue.
@@ -3088,6 +3149,8 @@ ReclaimForOS(
   EFI_STATUS                     Status;
   UINTN                          RemainingCommonRuntimeVariableSpace;
   UINTN                          RemainingHwErrVariableSpace;
+  UINTN                          ReclaimableSpace;
+  UINTN                          VariableStoreSize;
   STATIC BOOLEAN                 Reclaimed;
 
   //
@@ -3108,13 +3171,24 @@ ReclaimForOS(
 
   RemainingHwErrVariableSpace = PcdGet32 (PcdHwErrStorageSize) - mVariableModuleGlobal->HwErrVariableTotalSize;
 
+  ReclaimableSpace = 0;
+  VariableStoreSize = ((VARIABLE_STORE_HEADER *) (UINTN) mVariableModuleGlobal->VariableGlobal.NonVolatileVariableBase)->Size;
+  if (PcdGet8 (PcdReclaimVariableSpaceThreshold) != 0) {
+    ReclaimableSpace = GetReclaimableVariableSpace ();
+  }
+
   //
-  // Check if the free area is below a threshold.
+  // Check if the free area is below a threshold, or if enough of the store is
+  // taken up by deleted variables that reclaiming it now saves a full store
+  // rewrite in SetVariable() at runtime.
   //
   if (((RemainingCommonRuntimeVariableSpace < mVariableModuleGlobal->MaxVariableSize) ||
        (RemainingCommonRuntimeVariableSpace < mVariableModuleGlobal->MaxAuthVariableSize)) ||
       ((PcdGet32 (PcdHwErrStorageSize) != 0) &&
-       (RemainingHwErrVariableSpace < PcdGet32 (PcdMaxHardwareErrorVariableSize)))){
+       (RemainingHwErrVariableSpace < PcdGet32 (PcdMaxHardwareErrorVariableSize))) ||
+      ((PcdGet8 (PcdReclaimVariableSpaceThreshold) != 0) &&
+       (ReclaimableSpace != 0) &&
+       (ReclaimableSpace >= VariableStoreSize / 100 * PcdGet8 (PcdReclaimVariableSpaceThreshold)))) {
     Status = Reclaim (
             mVariableModuleGlobal->VariableGlobal.NonVolatileVariableBase,
             &mVariableModuleGlobal->NonVolatileLastVariableOffset,
@@ -3124,7 +3198,20 @@ ReclaimForOS(
             0
             );
     ASSERT_EFI_ERROR (Status);
+    if (!EFI_ERROR (Status)) {
+      mVariableModuleGlobal->ReclaimStatistics.BootReclaimCount++;
+    }
   }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "Variable: %u reclaims (%u at boot), 0x%Lx bytes reclaimed, 0x%Lx bytes written, 0x%Lx bytes left in place\n",
+    mVariableModuleGlobal->ReclaimStatistics.ReclaimCount,
+    mVariableModuleGlobal->ReclaimStatistics.BootReclaimCount,
+    mVariableModuleGlobal->ReclaimStatistics.BytesReclaimed,
+    mVariableModuleGlobal->ReclaimStatistics.BytesWritten,
+    mVariableModuleGlobal->ReclaimStatistics.BytesSkipped
+    ));
 }
 
 /**
@@ -3268,6 +3355,7 @@ FlushHobVariableToFlash (
       if (mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.HobFlushComplete != NULL) {
         *(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.HobFlushComplete) = TRUE;
       }
+      VariableStoreIndexRegister (VariableStoreTypeHob, NULL);
       if (!AtRuntime ()) {
         FreePool ((VOID *) VariableStoreHeader);
       }
@@ -3658,6 +3746,10 @@ VariableCommonInitialize (
   VolatileVariableStore->Reserved    = 0;
   VolatileVariableStore->Reserved1   = 0;
 
+  VariableStoreIndexRegister (VariableStoreTypeVolatile, VolatileVariableStore);
+  VariableStoreIndexRegister (VariableStoreTypeHob, (VARIABLE_STORE_HEADER *) (UINTN) mVariableModuleGlobal->VariableGlobal.HobVariableBase);
+  VariableStoreIndexRegister (VariableStoreTypeNv, mNvVariableCache);
+
   return EFI_SUCCESS;
 }
 
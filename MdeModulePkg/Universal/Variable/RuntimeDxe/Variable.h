@@ -74,6 +74,7 @@ typedef struct {
   BOOLEAN                 *ReadLock;
   BOOLEAN                 *PendingUpdate;
   BOOLEAN                 *HobFlushComplete;
+  UINT32                  *UpdateCount;
   VARIABLE_RUNTIME_CACHE  VariableRuntimeHobCache;
   VARIABLE_RUNTIME_CACHE  VariableRuntimeNvCache;
   VARIABLE_RUNTIME_CACHE  VariableRuntimeVolatileCache;
@@ -105,6 +106,17 @@ typedef struct {
   BOOLEAN                         EmuNvMode;
 } VARIABLE_GLOBAL;
 
+///
+/// Statistics of the non-volatile variable store reclaims, kept for diagnostics.
+///
+typedef struct {
+  UINT32          ReclaimCount;           ///< Number of completed reclaims.
+  UINT32          BootReclaimCount;       ///< Reclaims done at EndOfDxe or ReadyToBoot.
+  UINT64          BytesReclaimed;         ///< Store space given back by the reclaims.
+  UINT64          BytesWritten;           ///< Bytes written through FTW.
+  UINT64          BytesSkipped;           ///< Bytes left in place since they were unchanged.
+} VARIABLE_RECLAIM_STATISTICS;
+
 typedef struct {
   VARIABLE_GLOBAL VariableGlobal;
   UINTN           VolatileLastVariableOffset;
@@ -124,6 +136,7 @@ typedef struct {
   CHAR8           *PlatformLang;
   CHAR8           Lang[ISO_639_2_ENTRY_SIZE + 1];
   EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL *FvbInstance;
+  VARIABLE_RECLAIM_STATISTICS        ReclaimStatistics;
 } VARIABLE_MODULE_GLOBAL;
 
 /**
@@ -145,9 +158,13 @@ FlushHobVariableToFlash (
   This function writes a buffer to variable storage space into a firmware
   volume block device. The destination is specified by the parameter
   VariableBase. Fault Tolerant Write protocol is used for writing.
+  Only the range that differs from the current content of the variable
+  storage space is written.
 
   @param  VariableBase   Base address of the variable to write.
   @param  VariableBuffer Point to the variable data buffer.
+  @param  BytesWritten   Optional pointer to return the number of bytes
+                         written through FTW.
 
   @retval EFI_SUCCESS    The function completed successfully.
   @retval EFI_NOT_FOUND  Fail to locate Fault Tolerant Write protocol.
@@ -157,7 +174,8 @@ FlushHobVariableToFlash (
 EFI_STATUS
 FtwVariableSpace (
   IN EFI_PHYSICAL_ADDRESS   VariableBase,
-  IN VARIABLE_STORE_HEADER  *VariableBuffer
+  IN VARIABLE_STORE_HEADER  *VariableBuffer,
+  OUT UINTN                 *BytesWritten OPTIONAL
   );
 
 /**
@@ -375,7 +393,9 @@ VariableCommonInitialize (
   );
 
 /**
-  This function reclaims variable storage if free size is below the threshold.
+  This function reclaims variable storage if free size is below the threshold,
+  or if the deleted variables take up more than PcdReclaimVariableSpaceThreshold
+  percent of it.
 
 **/
 VOID
@@ -11,8 +11,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include "Variable.h"
+#include "VariableParsing.h"
 
 #include <Protocol/VariablePolicy.h>
+#include <Protocol/VariableBatch.h>
 #include <Library/VariablePolicyLib.h>
 
 EFI_STATUS
@@ -21,12 +23,21 @@ ProtocolIsVariablePolicyEnabled (
   OUT BOOLEAN *State
   );
 
+EFI_STATUS
+EFIAPI
+VariableBatchSetVariables (
+  IN CONST EDKII_VARIABLE_BATCH_PROTOCOL  *This,
+  IN       UINTN                          Count,
+  IN OUT   EDKII_VARIABLE_BATCH_ENTRY     *Entries
+  );
+
 EFI_HANDLE                          mHandle                    = NULL;
 EFI_EVENT                           mVirtualAddressChangeEvent = NULL;
 VOID                                *mFtwRegistration          = NULL;
 VOID                                ***mVarCheckAddressPointer = NULL;
 UINTN                               mVarCheckAddressPointerCount = 0;
 EDKII_VARIABLE_LOCK_PROTOCOL        mVariableLock              = { VariableLockRequestToLock };
+EDKII_VARIABLE_BATCH_PROTOCOL       mVariableBatch             = { VariableBatchSetVariables };
 EDKII_VARIABLE_POLICY_PROTOCOL      mVariablePolicyProtocol    = { EDKII_VARIABLE_POLICY_PROTOCOL_REVISION,
                                                                     DisableVariablePolicy,
                                                                     ProtocolIsVariablePolicyEnabled,
@@ -48,6 +59,72 @@ RecordSecureBootPolicyVarData(
   VOID
   );
 
+/**
+  Set a number of variables, in order.
+
+  All the entries are checked before any variable is set, so malformed input
+  does not leave the batch half applied. The variables are then set in order,
+  and processing stops at the first variable that cannot be set.
+
+  @param[in]      This          The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in]      Count         The number of entries in Entries.
+  @param[in, out] Entries       The variables to set. The Status field of each
+                                entry is updated on return.
+
+  @retval EFI_SUCCESS           All the variables were set.
+  @retval EFI_INVALID_PARAMETER Entries is NULL while Count is not 0, or one of
+                                the entries has parameters SetVariable() would
+                                reject. No variable was set.
+  @retval Others                The status of the first variable that could not
+                                be set.
+**/
+EFI_STATUS
+EFIAPI
+VariableBatchSetVariables (
+  IN CONST EDKII_VARIABLE_BATCH_PROTOCOL  *This,
+  IN       UINTN                          Count,
+  IN OUT   EDKII_VARIABLE_BATCH_ENTRY     *Entries
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  if (Count == 0) {
+    return EFI_SUCCESS;
+  }
+  if (Entries == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    Entries[Index].Status = EFI_NOT_STARTED;
+  }
+  for (Index = 0; Index < Count; Index++) {
+    if ((Entries[Index].VariableName == NULL) || (Entries[Index].VariableName[0] == 0) ||
+        (Entries[Index].VendorGuid == NULL) ||
+        ((Entries[Index].DataSize != 0) && (Entries[Index].Data == NULL))) {
+      Entries[Index].Status = EFI_INVALID_PARAMETER;
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    Status = VariableServiceSetVariable (
+               Entries[Index].VariableName,
+               Entries[Index].VendorGuid,
+               Entries[Index].Attributes,
+               Entries[Index].DataSize,
+               Entries[Index].Data
+               );
+    Entries[Index].Status = Status;
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Return TRUE if ExitBootServices () has been called.
 
@@ -265,6 +342,7 @@ VariableClassAddressChangeEvent (
   EfiConvertPointer (0x0, (VOID **) &mVariableModuleGlobal);
   EfiConvertPointer (0x0, (VOID **) &mNvVariableCache);
   EfiConvertPointer (0x0, (VOID **) &mNvFvHeaderCache);
+  VariableStoreIndexConvertPointers (EfiConvertPointer);
 
   if (mAuthContextOut.AddressPointer != NULL) {
     for (Index = 0; Index < mAuthContextOut.AddressPointerCount; Index++) {
@@ -547,6 +625,14 @@ VariableServiceInitialize (
                   );
   ASSERT_EFI_ERROR (Status);
 
+  Status = gBS->InstallMultipleProtocolInterfaces (
+                  &mHandle,
+                  &gEdkiiVariableBatchProtocolGuid,
+                  &mVariableBatch,
+                  NULL
+                  );
+  ASSERT_EFI_ERROR (Status);
+
   Status = gBS->InstallMultipleProtocolInterfaces (
                   &mHandle,
                   &gEdkiiVarCheckProtocolGuid,
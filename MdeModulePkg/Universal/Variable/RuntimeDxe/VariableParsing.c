@@ -9,6 +9,40 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "VariableParsing.h"
 
+//
+// Smallest average variable size the index is sized for. A store holding more
+// variables than its size allows for falls back to the linear search.
+//
+#define VARIABLE_INDEX_MIN_VARIABLE_SIZE  64
+#define VARIABLE_INDEX_MIN_BUCKET_COUNT   16
+#define VARIABLE_INDEX_NO_ENTRY           MAX_UINT32
+
+typedef struct {
+  UINT32                  Offset;       ///< Offset of the variable header from the store start.
+  UINT32                  Next;         ///< Next entry of the same bucket, in store order.
+} VARIABLE_INDEX_ENTRY;
+
+typedef struct {
+  VARIABLE_STORE_HEADER   *Store;
+  UINT32                  *BucketHead;
+  UINT32                  *BucketTail;
+  VARIABLE_INDEX_ENTRY    *Entries;
+  UINT32                  BucketCount;
+  UINT32                  MaxEntries;
+  UINT32                  EntryCount;
+  ///
+  /// Offset of the first variable header not yet indexed, or 0 if the index
+  /// has to be rebuilt.
+  ///
+  UINT32                  IndexedEnd;
+  ///
+  /// The store could not be indexed; lookups walk the store instead.
+  ///
+  BOOLEAN                 Disabled;
+} VARIABLE_STORE_INDEX;
+
+VARIABLE_STORE_INDEX  mVariableStoreIndex[VariableStoreTypeMax];
+
 /**
 
   This code checks if variable header is valid or not.
@@ -437,6 +471,229 @@ VariableCompareTimeStampInternal (
   return (BOOLEAN) (FirstTime->Second <= SecondTime->Second);
 }
 
+/**
+  Computes the index hash of a variable name and vendor GUID.
+
+  @param[in] VendorGuid  Vendor GUID of the variable.
+  @param[in] Name        Name of the variable.
+  @param[in] NameSize    Size of Name in bytes, including the null terminator.
+
+  @return The 32-bit FNV-1a hash of VendorGuid followed by Name.
+
+**/
+STATIC
+UINT32
+VariableIndexHash (
+  IN CONST EFI_GUID  *VendorGuid,
+  IN CONST VOID      *Name,
+  IN UINTN           NameSize
+  )
+{
+  CONST UINT8  *Bytes;
+  UINTN        Index;
+  UINT32       Hash;
+
+  Hash  = 0x811C9DC5;
+  Bytes = (CONST UINT8 *) VendorGuid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ Bytes[Index]) * 0x01000193;
+  }
+  Bytes = (CONST UINT8 *) Name;
+  for (Index = 0; Index < NameSize; Index++) {
+    Hash = (Hash ^ Bytes[Index]) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Brings the index of a variable store up to date with the store contents.
+
+  Variables appended since the last call are added to the index. If the index
+  was invalidated, it is rebuilt from the start of the store. Variables that
+  are already deleted are not indexed as they can never be found again.
+
+  @param[in, out] StoreIndex  The variable store index.
+  @param[in]      AuthFormat  TRUE indicates authenticated variables are used.
+                              FALSE indicates authenticated variables are not used.
+
+**/
+STATIC
+VOID
+UpdateVariableStoreIndex (
+  IN OUT VARIABLE_STORE_INDEX  *StoreIndex,
+  IN     BOOLEAN               AuthFormat
+  )
+{
+  VARIABLE_HEADER       *Variable;
+  VARIABLE_HEADER       *NextVariable;
+  VARIABLE_HEADER       *EndPtr;
+  CHAR16                *Name;
+  UINTN                 NameSize;
+  UINT32                Bucket;
+  VARIABLE_INDEX_ENTRY  *Entry;
+
+  if (StoreIndex->IndexedEnd == 0) {
+    SetMem (StoreIndex->BucketHead, StoreIndex->BucketCount * sizeof (UINT32), 0xFF);
+    SetMem (StoreIndex->BucketTail, StoreIndex->BucketCount * sizeof (UINT32), 0xFF);
+    StoreIndex->EntryCount = 0;
+    StoreIndex->Disabled   = FALSE;
+    StoreIndex->IndexedEnd = (UINT32) ((UINTN) GetStartPointer (StoreIndex->Store) - (UINTN) StoreIndex->Store);
+  }
+
+  if (StoreIndex->Disabled) {
+    return;
+  }
+
+  EndPtr   = GetEndPointer (StoreIndex->Store);
+  Variable = (VARIABLE_HEADER *) ((UINTN) StoreIndex->Store + StoreIndex->IndexedEnd);
+  while (IsValidVariableHeader (Variable, EndPtr)) {
+    NextVariable = GetNextVariablePtr (Variable, AuthFormat);
+    if ((Variable->State == VAR_HEADER_VALID_ONLY) && !IsValidVariableHeader (NextVariable, EndPtr)) {
+      //
+      // The last variable of the store may still be being written; index it
+      // once its state has been updated.
+      //
+      break;
+    }
+
+    if ((Variable->State & (UINT8) ~VAR_DELETED) != 0) {
+      Name     = GetVariableNamePtr (Variable, AuthFormat);
+      NameSize = NameSizeOfVariable (Variable, AuthFormat);
+      if ((NextVariable <= Variable) || (NextVariable > EndPtr) ||
+          (NameSize < sizeof (CHAR16)) || ((NameSize & 1) != 0) ||
+          (Name[NameSize / sizeof (CHAR16) - 1] != 0) ||
+          (StoreIndex->EntryCount == StoreIndex->MaxEntries)) {
+        //
+        // Leave malformed or overfull stores to the linear search so that the
+        // lookup results do not change.
+        //
+        StoreIndex->Disabled = TRUE;
+        return;
+      }
+
+      Bucket = VariableIndexHash (GetVendorGuidPtr (Variable, AuthFormat), Name, NameSize) & (StoreIndex->BucketCount - 1);
+      Entry  = &StoreIndex->Entries[StoreIndex->EntryCount];
+      Entry->Offset = (UINT32) ((UINTN) Variable - (UINTN) StoreIndex->Store);
+      Entry->Next   = VARIABLE_INDEX_NO_ENTRY;
+      if (StoreIndex->BucketTail[Bucket] == VARIABLE_INDEX_NO_ENTRY) {
+        StoreIndex->BucketHead[Bucket] = StoreIndex->EntryCount;
+      } else {
+        StoreIndex->Entries[StoreIndex->BucketTail[Bucket]].Next = StoreIndex->EntryCount;
+      }
+      StoreIndex->BucketTail[Bucket] = StoreIndex->EntryCount;
+      StoreIndex->EntryCount++;
+    }
+
+    Variable = NextVariable;
+  }
+
+  StoreIndex->IndexedEnd = (UINT32) ((UINTN) Variable - (UINTN) StoreIndex->Store);
+}
+
+/**
+  Returns the up to date index of the variable store starting at StartPtr.
+
+  @param[in] StartPtr    Pointer to the first variable header of the store.
+  @param[in] AuthFormat  TRUE indicates authenticated variables are used.
+                         FALSE indicates authenticated variables are not used.
+
+  @return The store index, or NULL if the store is not indexed.
+
+**/
+STATIC
+VARIABLE_STORE_INDEX *
+GetVariableStoreIndex (
+  IN VARIABLE_HEADER  *StartPtr,
+  IN BOOLEAN          AuthFormat
+  )
+{
+  VARIABLE_STORE_TYPE   StoreType;
+  VARIABLE_STORE_INDEX  *StoreIndex;
+
+  for (StoreType = (VARIABLE_STORE_TYPE) 0; StoreType < VariableStoreTypeMax; StoreType++) {
+    StoreIndex = &mVariableStoreIndex[StoreType];
+    if ((StoreIndex->Store != NULL) && (GetStartPointer (StoreIndex->Store) == StartPtr)) {
+      UpdateVariableStoreIndex (StoreIndex, AuthFormat);
+      return StoreIndex->Disabled ? NULL : StoreIndex;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Find the variable in the specified variable store using the store index.
+
+  The variables sharing the hash bucket of VariableName and VendorGuid are
+  visited in store order so the result is the same as the one of walking the
+  whole store.
+
+  @param[in]       StoreIndex          The index of the variable store.
+  @param[in]       VariableName        Name of the variable to be found, not empty.
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval          EFI_SUCCESS         Variable found successfully
+  @retval          EFI_NOT_FOUND       Variable not found
+**/
+STATIC
+EFI_STATUS
+FindVariableInStoreIndex (
+  IN     VARIABLE_STORE_INDEX    *StoreIndex,
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  )
+{
+  VARIABLE_HEADER  *Variable;
+  VARIABLE_HEADER  *InDeletedVariable;
+  UINTN            NameSize;
+  UINT32           EntryIndex;
+
+  InDeletedVariable = NULL;
+  NameSize          = StrSize (VariableName);
+
+  for ( EntryIndex = StoreIndex->BucketHead[VariableIndexHash (VendorGuid, VariableName, NameSize) & (StoreIndex->BucketCount - 1)]
+      ; EntryIndex != VARIABLE_INDEX_NO_ENTRY
+      ; EntryIndex = StoreIndex->Entries[EntryIndex].Next
+      ) {
+    Variable = (VARIABLE_HEADER *) ((UINTN) StoreIndex->Store + StoreIndex->Entries[EntryIndex].Offset);
+    if (Variable >= PtrTrack->EndPtr) {
+      break;
+    }
+
+    if (Variable->State != VAR_ADDED && Variable->State != (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) {
+      continue;
+    }
+    if (!IgnoreRtCheck && AtRuntime () && ((Variable->Attributes & EFI_VARIABLE_RUNTIME_ACCESS) == 0)) {
+      continue;
+    }
+    if ((NameSizeOfVariable (Variable, AuthFormat) != NameSize) ||
+        !CompareGuid (VendorGuid, GetVendorGuidPtr (Variable, AuthFormat)) ||
+        (CompareMem (VariableName, GetVariableNamePtr (Variable, AuthFormat), NameSize) != 0)) {
+      continue;
+    }
+
+    if (Variable->State == (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) {
+      InDeletedVariable = Variable;
+    } else {
+      PtrTrack->CurrPtr                = Variable;
+      PtrTrack->InDeletedTransitionPtr = InDeletedVariable;
+      return EFI_SUCCESS;
+    }
+  }
+
+  PtrTrack->CurrPtr = InDeletedVariable;
+  return (PtrTrack->CurrPtr == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
+
 /**
   Find the variable in the specified variable store.
 
@@ -462,9 +719,17 @@ FindVariableEx (
 {
   VARIABLE_HEADER                *InDeletedVariable;
   VOID                           *Point;
+  VARIABLE_STORE_INDEX           *StoreIndex;
 
   PtrTrack->InDeletedTransitionPtr = NULL;
 
+  if (VariableName[0] != 0) {
+    StoreIndex = GetVariableStoreIndex (PtrTrack->StartPtr, AuthFormat);
+    if (StoreIndex != NULL) {
+      return FindVariableInStoreIndex (StoreIndex, VariableName, VendorGuid, IgnoreRtCheck, PtrTrack, AuthFormat);
+    }
+  }
+
   //
   // Find the variable by walk through HOB, volatile and non-volatile variable store.
   //
@@ -786,3 +1051,104 @@ UpdateVariableInfo (
     }
   }
 }
+
+/**
+  Registers a variable store with the (name, GUID) hash index used by
+  FindVariableEx ().
+
+  The index is built lazily on the first lookup in the store and is then kept
+  up to date with variables appended to the store. Any other change to the
+  store contents, such as a reclaim, must be followed by a call to
+  VariableStoreIndexInvalidate ().
+
+  @param[in] StoreType      The type of the variable store.
+  @param[in] VariableStore  Pointer to the variable store to index, or NULL to
+                            drop the index of StoreType.
+
+**/
+VOID
+VariableStoreIndexRegister (
+  IN  VARIABLE_STORE_TYPE    StoreType,
+  IN  VARIABLE_STORE_HEADER  *VariableStore
+  )
+{
+  VARIABLE_STORE_INDEX  *StoreIndex;
+  UINT32                MaxEntries;
+  UINT32                BucketCount;
+  UINT32                *Buckets;
+
+  ASSERT (StoreType < VariableStoreTypeMax);
+  StoreIndex = &mVariableStoreIndex[StoreType];
+
+  if (StoreIndex->BucketHead != NULL && !AtRuntime ()) {
+    FreePool (StoreIndex->BucketHead);
+  }
+  ZeroMem (StoreIndex, sizeof (*StoreIndex));
+
+  if (!FeaturePcdGet (PcdEnableVariableStoreIndex) || VariableStore == NULL) {
+    return;
+  }
+
+  MaxEntries  = MAX (VariableStore->Size / VARIABLE_INDEX_MIN_VARIABLE_SIZE, VARIABLE_INDEX_MIN_BUCKET_COUNT);
+  BucketCount = GetPowerOfTwo32 (MaxEntries / 2);
+  Buckets     = AllocateRuntimePool (
+                  BucketCount * 2 * sizeof (UINT32) + MaxEntries * sizeof (VARIABLE_INDEX_ENTRY)
+                  );
+  if (Buckets == NULL) {
+    DEBUG ((DEBUG_WARN, "Variable driver: no memory to index variable store %d.\n", StoreType));
+    return;
+  }
+
+  StoreIndex->Store       = VariableStore;
+  StoreIndex->BucketHead  = Buckets;
+  StoreIndex->BucketTail  = Buckets + BucketCount;
+  StoreIndex->Entries     = (VARIABLE_INDEX_ENTRY *) (Buckets + BucketCount * 2);
+  StoreIndex->BucketCount = BucketCount;
+  StoreIndex->MaxEntries  = MaxEntries;
+}
+
+/**
+  Discards the contents of all variable store indexes.
+
+  The indexes are rebuilt by the next lookup in the stores.
+
+**/
+VOID
+VariableStoreIndexInvalidate (
+  VOID
+  )
+{
+  VARIABLE_STORE_TYPE   StoreType;
+
+  for (StoreType = (VARIABLE_STORE_TYPE) 0; StoreType < VariableStoreTypeMax; StoreType++) {
+    mVariableStoreIndex[StoreType].IndexedEnd = 0;
+  }
+}
+
+/**
+  Converts the pointers held by the variable store indexes to virtual
+  addresses.
+
+  @param[in] ConvertPointer  The function used to convert each pointer.
+
+**/
+VOID
+VariableStoreIndexConvertPointers (
+  IN  VARIABLE_INDEX_CONVERT_POINTER  ConvertPointer
+  )
+{
+  VARIABLE_STORE_TYPE   StoreType;
+  VARIABLE_STORE_INDEX  *StoreIndex;
+
+  for (StoreType = (VARIABLE_STORE_TYPE) 0; StoreType < VariableStoreTypeMax; StoreType++) {
+    StoreIndex = &mVariableStoreIndex[StoreType];
+    if (StoreIndex->Store == NULL) {
+      continue;
+    }
+
+    ConvertPointer (0x0, (VOID **) &StoreIndex->Store);
+    ConvertPointer (0x0, (VOID **) &StoreIndex->BucketHead);
+    ConvertPointer (0x0, (VOID **) &StoreIndex->BucketTail);
+    ConvertPointer (0x0, (VOID **) &StoreIndex->Entries);
+  }
+}
@@ -10,8 +10,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef _VARIABLE_PARSING_H_
 #define _VARIABLE_PARSING_H_
 
-#include <Guid/ImageAuthentication.h>
 #include "Variable.h"
+#include <Guid/ImageAuthentication.h>
 
 /**
 
@@ -344,4 +344,68 @@ UpdateVariableInfo (
   IN OUT VARIABLE_INFO_ENTRY  **VariableInfo
   );
 
+/**
+  Converts a pointer to a new virtual address.
+
+  This prototype matches EfiConvertPointer () so that it can be passed to
+  VariableStoreIndexConvertPointers () directly.
+
+  @param[in]      DebugDisposition  Supplies type information for the pointer being converted.
+  @param[in, out] Address           The pointer to a pointer that is to be fixed to be the
+                                    value needed for the new virtual address mapping being
+                                    applied.
+
+  @retval EFI_SUCCESS               The pointer was converted.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *VARIABLE_INDEX_CONVERT_POINTER) (
+  IN     UINTN  DebugDisposition,
+  IN OUT VOID   **Address
+  );
+
+/**
+  Registers a variable store with the (name, GUID) hash index used by
+  FindVariableEx ().
+
+  The index is built lazily on the first lookup in the store and is then kept
+  up to date with variables appended to the store. Any other change to the
+  store contents, such as a reclaim, must be followed by a call to
+  VariableStoreIndexInvalidate ().
+
+  @param[in] StoreType      The type of the variable store.
+  @param[in] VariableStore  Pointer to the variable store to index, or NULL to
+                            drop the index of StoreType.
+
+**/
+VOID
+VariableStoreIndexRegister (
+  IN  VARIABLE_STORE_TYPE    StoreType,
+  IN  VARIABLE_STORE_HEADER  *VariableStore
+  );
+
+/**
+  Discards the contents of all variable store indexes.
+
+  The indexes are rebuilt by the next lookup in the stores.
+
+**/
+VOID
+VariableStoreIndexInvalidate (
+  VOID
+  );
+
+/**
+  Converts the pointers held by the variable store indexes to virtual
+  addresses.
+
+  @param[in] ConvertPointer  The function used to convert each pointer.
+
+**/
+VOID
+VariableStoreIndexConvertPointers (
+  IN  VARIABLE_INDEX_CONVERT_POINTER  ConvertPointer
+  );
+
 #endif
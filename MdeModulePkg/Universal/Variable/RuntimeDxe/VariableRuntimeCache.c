@@ -85,6 +85,12 @@ FlushPendingRuntimeVariableCacheUpdates (
       );
     VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateLength = 0;
     VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateOffset = 0;
+    //
+    // Let the runtime DXE driver know that its variable store indexes are stale.
+    //
+    if (VariableRuntimeCacheContext->UpdateCount != NULL) {
+      (*(VariableRuntimeCacheContext->UpdateCount))++;
+    }
     *(VariableRuntimeCacheContext->PendingUpdate) = FALSE;
   }
 
@@ -12,7 +12,8 @@
 
   Each sub function VariableServiceGetVariable(), VariableServiceGetNextVariableName(),
   VariableServiceSetVariable(), VariableServiceQueryVariableInfo(), ReclaimForOS(),
-  SmmVariableGetStatistics() should also do validation based on its own knowledge.
+  SmmVariableGetStatistics(), SmmSetVariableBatch() should also do validation based
+  on its own knowledge.
 
 Copyright (c) 2010 - 2019, Intel Corporation. All rights reserved.<BR>
 Copyright (c) 2018, Linaro, Ltd. All rights reserved.<BR>
@@ -426,6 +427,95 @@ SmmVariableGetStatistics (
 }
 
 
+/**
+  Set the variables of a batched SetVariable request, in order.
+
+  Caution: This function may receive untrusted input.
+  The batch is external input, so this function will validate all the entries
+  before any of them is set.
+
+  @param[in, out]  Batch       The batch, copied out of the communicate buffer.
+                               Processed is updated with the number of variables
+                               that were set.
+  @param[in]       BatchSize   The size of the batch, including its header.
+
+  @retval EFI_SUCCESS          All the variables were set.
+  @retval EFI_ACCESS_DENIED    The batch is malformed. No variable was set.
+  @retval Others               The status of the first variable that could not be set.
+
+**/
+EFI_STATUS
+SmmSetVariableBatch (
+  IN OUT SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH  *Batch,
+  IN     UINTN                                        BatchSize
+  )
+{
+  EFI_STATUS                                Status;
+  SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE  *Entry;
+  UINTN                                     Offset;
+  UINTN                                     EntrySize;
+  UINTN                                     Index;
+
+  Batch->Processed = 0;
+
+  //
+  // Check all the entries first, so a malformed one cannot leave the batch half set.
+  //
+  Offset = sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH);
+  for (Index = 0; Index < Batch->Count; Index++) {
+    if (BatchSize - Offset < OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE, Name)) {
+      DEBUG ((DEBUG_ERROR, "SetVariableBatch: Entry %d exceeds communication buffer size limit!\n", Index));
+      return EFI_ACCESS_DENIED;
+    }
+    Entry     = (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE *) ((UINT8 *) Batch + Offset);
+    EntrySize = BatchSize - Offset - OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE, Name);
+    if ((Entry->NameSize > EntrySize) || (Entry->DataSize > EntrySize - Entry->NameSize)) {
+      DEBUG ((DEBUG_ERROR, "SetVariableBatch: Entry %d exceeds communication buffer size limit!\n", Index));
+      return EFI_ACCESS_DENIED;
+    }
+
+    //
+    // The VariableSpeculationBarrier() call here is to ensure the previous
+    // range checks for the entry have been completed before the subsequent
+    // consumption of its content.
+    //
+    VariableSpeculationBarrier ();
+    if ((Entry->NameSize < sizeof (CHAR16)) || (Entry->Name[Entry->NameSize / sizeof (CHAR16) - 1] != L'\0')) {
+      //
+      // Make sure VariableName is A Null-terminated string.
+      //
+      return EFI_ACCESS_DENIED;
+    }
+
+    //
+    // The padding of the last entry may be cut off.
+    //
+    EntrySize = MIN (SMM_VARIABLE_BATCH_ENTRY_SIZE (Entry->NameSize, Entry->DataSize), BatchSize - Offset);
+    Offset   += EntrySize;
+  }
+
+  Offset = sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH);
+  for (Index = 0; Index < Batch->Count; Index++) {
+    Entry  = (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE *) ((UINT8 *) Batch + Offset);
+    Status = VariableServiceSetVariable (
+               Entry->Name,
+               &Entry->Guid,
+               Entry->Attributes,
+               Entry->DataSize,
+               (UINT8 *) Entry->Name + Entry->NameSize
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Batch->Processed++;
+    Offset += SMM_VARIABLE_BATCH_ENTRY_SIZE (Entry->NameSize, Entry->DataSize);
+  }
+
+  return EFI_SUCCESS;
+}
+
+
 /**
   Communication service SMI Handler entry.
 
@@ -435,7 +525,8 @@ SmmVariableGetStatistics (
   This variable data and communicate buffer are external input, so this function will do basic validation.
   Each sub function VariableServiceGetVariable(), VariableServiceGetNextVariableName(),
   VariableServiceSetVariable(), VariableServiceQueryVariableInfo(), ReclaimForOS(),
-  SmmVariableGetStatistics() should also do validation based on its own knowledge.
+  SmmVariableGetStatistics(), SmmSetVariableBatch() should also do validation based
+  on its own knowledge.
 
   @param[in]     DispatchHandle  The unique handle assigned to this handler by SmiHandlerRegister().
   @param[in]     RegisterContext Points to an optional handler context which was specified when the
@@ -469,6 +560,7 @@ SmmVariableHandler (
   SMM_VARIABLE_COMMUNICATE_GET_PAYLOAD_SIZE               *GetPayloadSize;
   SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT *RuntimeVariableCacheContext;
   SMM_VARIABLE_COMMUNICATE_GET_RUNTIME_CACHE_INFO         *GetRuntimeCacheInfo;
+  SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH             *SetVariableBatch;
   SMM_VARIABLE_COMMUNICATE_LOCK_VARIABLE                  *VariableToLock;
   SMM_VARIABLE_COMMUNICATE_VAR_CHECK_VARIABLE_PROPERTY    *CommVariableProperty;
   VARIABLE_INFO_ENTRY                                     *VariableInfo;
@@ -658,6 +750,20 @@ SmmVariableHandler (
                  );
       break;
 
+    case SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH:
+      if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH)) {
+        DEBUG ((EFI_D_ERROR, "SetVariableBatch: SMM communication buffer size invalid!\n"));
+        return EFI_SUCCESS;
+      }
+      //
+      // Copy the input communicate buffer payload to pre-allocated SMM variable buffer payload.
+      //
+      CopyMem (mVariableBufferPayload, SmmVariableFunctionHeader->Data, CommBufferPayloadSize);
+      SetVariableBatch = (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH *) mVariableBufferPayload;
+      Status = SmmSetVariableBatch (SetVariableBatch, CommBufferPayloadSize);
+      ((SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH *) SmmVariableFunctionHeader->Data)->Processed = SetVariableBatch->Processed;
+      break;
+
     case SMM_VARIABLE_FUNCTION_QUERY_VARIABLE_INFO:
       if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_QUERY_VARIABLE_INFO)) {
         DEBUG ((EFI_D_ERROR, "QueryVariableInfo: SMM communication buffer size invalid!\n"));
@@ -800,7 +906,7 @@ SmmVariableHandler (
       CopyMem (SmmVariableFunctionHeader->Data, mVariableBufferPayload, CommBufferPayloadSize);
       break;
     case SMM_VARIABLE_FUNCTION_INIT_RUNTIME_VARIABLE_CACHE_CONTEXT:
-      if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT)) {
+      if (CommBufferPayloadSize < OFFSET_OF (SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT, UpdateCount)) {
         DEBUG ((DEBUG_ERROR, "InitRuntimeVariableCacheContext: SMM communication buffer size invalid!\n"));
         Status = EFI_ACCESS_DENIED;
         goto EXIT;
@@ -817,6 +923,13 @@ SmmVariableHandler (
       CopyMem (mVariableBufferPayload, SmmVariableFunctionHeader->Data, CommBufferPayloadSize);
       RuntimeVariableCacheContext = (SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT *) mVariableBufferPayload;
 
+      //
+      // The update count is optional and absent from the shorter context used by older callers.
+      //
+      if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT)) {
+        RuntimeVariableCacheContext->UpdateCount = NULL;
+      }
+
       //
       // Verify required runtime cache buffers are provided.
       //
@@ -888,6 +1001,14 @@ SmmVariableHandler (
         Status = EFI_ACCESS_DENIED;
         goto EXIT;
       }
+      if (RuntimeVariableCacheContext->UpdateCount != NULL &&
+          !VariableSmmIsBufferOutsideSmmValid (
+            (UINTN) RuntimeVariableCacheContext->UpdateCount,
+            sizeof (*(RuntimeVariableCacheContext->UpdateCount)))) {
+        DEBUG ((DEBUG_ERROR, "InitRuntimeVariableCacheContext: Runtime cache update count buffer in SMRAM or overflow!\n"));
+        Status = EFI_ACCESS_DENIED;
+        goto EXIT;
+      }
 
       VariableCacheContext = &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext;
       VariableCacheContext->VariableRuntimeHobCache.Store      = RuntimeVariableCacheContext->RuntimeHobCache;
@@ -896,6 +1017,7 @@ SmmVariableHandler (
       VariableCacheContext->PendingUpdate                      = RuntimeVariableCacheContext->PendingUpdate;
       VariableCacheContext->ReadLock                           = RuntimeVariableCacheContext->ReadLock;
       VariableCacheContext->HobFlushComplete                   = RuntimeVariableCacheContext->HobFlushComplete;
+      VariableCacheContext->UpdateCount                        = RuntimeVariableCacheContext->UpdateCount;
 
       // Set up the intial pending request since the RT cache needs to be in sync with SMM cache
       VariableCacheContext->VariableRuntimeHobCache.PendingUpdateOffset = 0;
@@ -24,6 +24,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/MmCommunication2.h>
 #include <Protocol/SmmVariable.h>
 #include <Protocol/VariableLock.h>
+#include <Protocol/VariableBatch.h>
 #include <Protocol/VarCheck.h>
 
 #include <Library/UefiBootServicesTableLib.h>
@@ -60,10 +61,13 @@ UINTN                            mVariableRuntimeVolatileCacheBufferSize;
 UINTN                            mVariableBufferPayloadSize;
 BOOLEAN                          mVariableRuntimeCachePendingUpdate;
 BOOLEAN                          mVariableRuntimeCacheReadLock;
+UINT32                           mVariableRuntimeCacheUpdateCount;
+UINT32                           mVariableRuntimeCacheIndexedUpdateCount;
 BOOLEAN                          mVariableAuthFormat;
 BOOLEAN                          mHobFlushComplete;
 EFI_LOCK                         mVariableServicesLock;
 EDKII_VARIABLE_LOCK_PROTOCOL     mVariableLock;
+EDKII_VARIABLE_BATCH_PROTOCOL    mVariableBatch;
 EDKII_VAR_CHECK_PROTOCOL         mVarCheck;
 
 /**
@@ -573,6 +577,7 @@ CheckForRuntimeCacheSync (
   // The HOB variable data may have finished being flushed in the runtime cache sync update
   //
   if (mHobFlushComplete && mVariableRuntimeHobCacheBuffer != NULL) {
+    VariableStoreIndexRegister (VariableStoreTypeHob, NULL);
     if (!EfiAtRuntime ()) {
       FreePages (mVariableRuntimeHobCacheBuffer, EFI_SIZE_TO_PAGES (mVariableRuntimeHobCacheBufferSize));
     }
@@ -580,6 +585,24 @@ CheckForRuntimeCacheSync (
   }
 }
 
+/**
+  Discards the runtime cache indexes if SMM updated the runtime caches since they were built.
+
+  Must be called with the runtime cache read lock held so that the caches do not change until
+  the lookup completes.
+
+**/
+VOID
+CheckForRuntimeCacheIndexUpdate (
+  VOID
+  )
+{
+  if (mVariableRuntimeCacheIndexedUpdateCount != mVariableRuntimeCacheUpdateCount) {
+    mVariableRuntimeCacheIndexedUpdateCount = mVariableRuntimeCacheUpdateCount;
+    VariableStoreIndexInvalidate ();
+  }
+}
+
 /**
   Finds the given variable in a runtime cache variable store.
 
@@ -633,6 +656,8 @@ FindVariableInRuntimeCache (
   CheckForRuntimeCacheSync ();
 
   if (!mVariableRuntimeCachePendingUpdate) {
+    CheckForRuntimeCacheIndexUpdate ();
+
     //
     // 0: Volatile, 1: HOB, 2: Non-Volatile.
     // The index and attributes mapping must be kept in this order as FindVariable
@@ -893,6 +918,8 @@ GetNextVariableNameInRuntimeCache (
 
   mVariableRuntimeCacheReadLock = TRUE;
   if (!mVariableRuntimeCachePendingUpdate) {
+    CheckForRuntimeCacheIndexUpdate ();
+
     //
     // 0: Volatile, 1: HOB, 2: Non-Volatile.
     // The index and attributes mapping must be kept in this order as FindVariable
@@ -1176,6 +1203,173 @@ Done:
 }
 
 
+/**
+  Set a number of variables, in order.
+
+  The variables are handed to SMM in as few SMIs as the communicate buffer
+  allows, instead of one SMI per variable.
+
+  All the entries are checked before any variable is set, so malformed input
+  does not leave the batch half applied. The variables are then set in order,
+  and processing stops at the first variable that cannot be set.
+
+  @param[in]      This          The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in]      Count         The number of entries in Entries.
+  @param[in, out] Entries       The variables to set. The Status field of each
+                                entry is updated on return.
+
+  @retval EFI_SUCCESS           All the variables were set.
+  @retval EFI_INVALID_PARAMETER Entries is NULL while Count is not 0, or one of
+                                the entries has parameters SetVariable() would
+                                reject. No variable was set.
+  @retval Others                The status of the first variable that could not
+                                be set.
+**/
+EFI_STATUS
+EFIAPI
+VariableBatchSetVariables (
+  IN CONST EDKII_VARIABLE_BATCH_PROTOCOL  *This,
+  IN       UINTN                          Count,
+  IN OUT   EDKII_VARIABLE_BATCH_ENTRY     *Entries
+  )
+{
+  EFI_STATUS                                   Status;
+  SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH  *SmmBatch;
+  SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE     *SmmVariableHeader;
+  UINTN                                        Index;
+  UINTN                                        First;
+  UINTN                                        Next;
+  UINTN                                        Processed;
+  UINTN                                        PayloadSize;
+  UINTN                                        EntrySize;
+  UINTN                                        VariableNameSize;
+  UINTN                                        SmiCount;
+
+  if (Count == 0) {
+    return EFI_SUCCESS;
+  }
+  if (Entries == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Check all the entries first, so a malformed one cannot leave the batch half set.
+  //
+  for (Index = 0; Index < Count; Index++) {
+    Entries[Index].Status = EFI_NOT_STARTED;
+  }
+  for (Index = 0; Index < Count; Index++) {
+    if ((Entries[Index].VariableName == NULL) || (Entries[Index].VariableName[0] == 0) ||
+        (Entries[Index].VendorGuid == NULL) ||
+        ((Entries[Index].DataSize != 0) && (Entries[Index].Data == NULL))) {
+      Entries[Index].Status = EFI_INVALID_PARAMETER;
+      return EFI_INVALID_PARAMETER;
+    }
+
+    VariableNameSize = StrSize (Entries[Index].VariableName);
+    if ((VariableNameSize > mVariableBufferPayloadSize - OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE, Name)) ||
+        (Entries[Index].DataSize > mVariableBufferPayloadSize - OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE, Name) - VariableNameSize)) {
+      Entries[Index].Status = EFI_INVALID_PARAMETER;
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  Status   = EFI_SUCCESS;
+  SmiCount = 0;
+  First    = 0;
+  while (First < Count) {
+    VariableNameSize = StrSize (Entries[First].VariableName);
+    EntrySize        = SMM_VARIABLE_BATCH_ENTRY_SIZE (VariableNameSize, Entries[First].DataSize);
+    if (EntrySize > mVariableBufferPayloadSize - sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH)) {
+      //
+      // The variable is too large to go along with the batch header, send it on its own.
+      //
+      Status = RuntimeServiceSetVariable (
+                 Entries[First].VariableName,
+                 Entries[First].VendorGuid,
+                 Entries[First].Attributes,
+                 Entries[First].DataSize,
+                 Entries[First].Data
+                 );
+      Entries[First].Status = Status;
+      SmiCount++;
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+      First++;
+      continue;
+    }
+
+    AcquireLockOnlyAtBootTime (&mVariableServicesLock);
+
+    //
+    // Pack as many variables as fit in the communicate buffer. The buffer data size is:
+    // SMM_COMMUNICATE_HEADER_SIZE + SMM_VARIABLE_COMMUNICATE_HEADER_SIZE + PayloadSize.
+    //
+    PayloadSize = sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH);
+    for (Next = First; Next < Count; Next++) {
+      EntrySize = SMM_VARIABLE_BATCH_ENTRY_SIZE (StrSize (Entries[Next].VariableName), Entries[Next].DataSize);
+      if (EntrySize > mVariableBufferPayloadSize - PayloadSize) {
+        break;
+      }
+      PayloadSize += EntrySize;
+    }
+
+    Status = InitCommunicateBuffer ((VOID **) &SmmBatch, PayloadSize, SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH);
+    if (EFI_ERROR (Status)) {
+      ReleaseLockOnlyAtBootTime (&mVariableServicesLock);
+      Entries[First].Status = Status;
+      break;
+    }
+    ASSERT (SmmBatch != NULL);
+
+    SmmBatch->Count     = Next - First;
+    SmmBatch->Processed = 0;
+    SmmVariableHeader   = (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE *) (SmmBatch + 1);
+    for (Index = First; Index < Next; Index++) {
+      VariableNameSize = StrSize (Entries[Index].VariableName);
+      CopyGuid (&SmmVariableHeader->Guid, Entries[Index].VendorGuid);
+      SmmVariableHeader->DataSize   = Entries[Index].DataSize;
+      SmmVariableHeader->NameSize   = VariableNameSize;
+      SmmVariableHeader->Attributes = Entries[Index].Attributes;
+      CopyMem (SmmVariableHeader->Name, Entries[Index].VariableName, VariableNameSize);
+      CopyMem ((UINT8 *) SmmVariableHeader->Name + VariableNameSize, Entries[Index].Data, Entries[Index].DataSize);
+      SmmVariableHeader = (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE *) ((UINT8 *) SmmVariableHeader +
+                            SMM_VARIABLE_BATCH_ENTRY_SIZE (VariableNameSize, Entries[Index].DataSize));
+    }
+
+    //
+    // Send data to SMM.
+    //
+    Status = SendCommunicateBuffer (PayloadSize);
+    SmiCount++;
+    if (EFI_ERROR (Status)) {
+      Processed = MIN (SmmBatch->Processed, Next - First);
+    } else {
+      Processed = Next - First;
+    }
+
+    ReleaseLockOnlyAtBootTime (&mVariableServicesLock);
+
+    for (Index = First; Index < First + Processed; Index++) {
+      Entries[Index].Status = EFI_SUCCESS;
+      SecureBootHook (Entries[Index].VariableName, Entries[Index].VendorGuid);
+    }
+    if (EFI_ERROR (Status)) {
+      if (First + Processed < Next) {
+        Entries[First + Processed].Status = Status;
+      }
+      break;
+    }
+
+    First = Next;
+  }
+
+  DEBUG ((DEBUG_VERBOSE, "%a: %d variables sent with %d SMIs\n", __FUNCTION__, Count, SmiCount));
+  return Status;
+}
+
+
 /**
   This code returns information about the EFI variables.
 
@@ -1341,6 +1535,7 @@ VariableAddressChangeEvent (
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **) &mVariableRuntimeHobCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **) &mVariableRuntimeNvCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **) &mVariableRuntimeVolatileCacheBuffer);
+  VariableStoreIndexConvertPointers (EfiConvertPointer);
 }
 
 /**
@@ -1549,6 +1744,7 @@ SendRuntimeVariableCacheContextToSmm (
   SmmRuntimeVarCacheContext->PendingUpdate = &mVariableRuntimeCachePendingUpdate;
   SmmRuntimeVarCacheContext->ReadLock = &mVariableRuntimeCacheReadLock;
   SmmRuntimeVarCacheContext->HobFlushComplete = &mHobFlushComplete;
+  SmmRuntimeVarCacheContext->UpdateCount = &mVariableRuntimeCacheUpdateCount;
 
   //
   // Request to unblock this region to be accessible from inside MM environment
@@ -1578,6 +1774,14 @@ SendRuntimeVariableCacheContextToSmm (
     goto Done;
   }
 
+  Status = MmUnblockMemoryRequest (
+            (EFI_PHYSICAL_ADDRESS) ALIGN_VALUE ((UINTN) SmmRuntimeVarCacheContext->UpdateCount - EFI_PAGE_SIZE + 1, EFI_PAGE_SIZE),
+            EFI_SIZE_TO_PAGES (sizeof(mVariableRuntimeCacheUpdateCount))
+            );
+  if (Status != EFI_UNSUPPORTED && EFI_ERROR (Status)) {
+    goto Done;
+  }
+
   //
   // Send data to SMM.
   //
@@ -1657,6 +1861,9 @@ SmmVariableReady (
             Status = SendRuntimeVariableCacheContextToSmm ();
             if (!EFI_ERROR (Status)) {
               SyncRuntimeCache ();
+              VariableStoreIndexRegister (VariableStoreTypeVolatile, mVariableRuntimeVolatileCacheBuffer);
+              VariableStoreIndexRegister (VariableStoreTypeHob, mVariableRuntimeHobCacheBuffer);
+              VariableStoreIndexRegister (VariableStoreTypeNv, mVariableRuntimeNvCacheBuffer);
             }
           }
         }
@@ -1697,6 +1904,15 @@ SmmVariableReady (
                   );
   ASSERT_EFI_ERROR (Status);
 
+  mVariableBatch.SetVariables = VariableBatchSetVariables;
+  Status = gBS->InstallMultipleProtocolInterfaces (
+                  &mHandle,
+                  &gEdkiiVariableBatchProtocolGuid,
+                  &mVariableBatch,
+                  NULL
+                  );
+  ASSERT_EFI_ERROR (Status);
+
   mVarCheck.RegisterSetVariableCheckHandler = VarCheckRegisterSetVariableCheckHandler;
   mVarCheck.VariablePropertySet = VarCheckVariablePropertySet;
   mVarCheck.VariablePropertyGet = VarCheckVariablePropertyGet;
@@ -75,6 +75,22 @@
 /// indicate its acceptance of range requests for a resource:
 ///
 #define HTTP_HEADER_ACCEPT_RANGES      "Accept-Ranges"
+#define HTTP_HEADER_ACCEPT_RANGES_BYTES "bytes"
+
+///
+/// Range Request Header
+/// The Range request-header field allows a client to request only one or
+/// more sub-ranges of the selected representation (RFC 7233):
+///
+#define HTTP_HEADER_RANGE              "Range"
+
+///
+/// Content-Range Response Header
+/// The Content-Range header field is sent in a 206 (Partial Content)
+/// response to indicate the partial range of the selected representation
+/// enclosed as the message payload (RFC 7233):
+///
+#define HTTP_HEADER_CONTENT_RANGE      "Content-Range"
 
 
 ///
@@ -0,0 +1,73 @@
+/** @file
+  CRC32 implementation for AArch64 using the ARMv8 CRC32 instructions.
+
+  The CRC32B/CRC32X instructions implement the bit-reflected ITU-T V.42
+  polynomial 0x04C11DB7 used by CalculateCrc32(). They are optional in ARMv8.0
+  so ID_AA64ISAR0_EL1 is checked before use.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseLibInternals.h"
+
+#define ID_AA64ISAR0_CRC32_SHIFT  16
+#define ID_AA64ISAR0_CRC32_MASK   0xF
+
+/**
+  Updates a running CRC32 value using CPU specific instructions.
+
+  @param[in, out]  Crc     On input, the running CRC value. On output, the
+                           CRC updated with the contents of Buffer. Only
+                           modified when TRUE is returned.
+  @param[in]       Buffer  A pointer to the data to fold into the CRC.
+  @param[in]       Length  The number of bytes in Buffer.
+
+  @retval TRUE   The CRC was updated.
+  @retval FALSE  The CPU does not provide the required instructions; the
+                 caller must fall back to InternalCrc32Update().
+
+**/
+BOOLEAN
+InternalCrc32Accelerated (
+  IN OUT UINT32       *Crc,
+  IN     CONST UINT8  *Buffer,
+  IN     UINTN        Length
+  )
+{
+  UINT64  IsaFeatures;
+  UINT32  Value;
+
+  __asm__ ("mrs %0, id_aa64isar0_el1" : "=r" (IsaFeatures));
+  if (((IsaFeatures >> ID_AA64ISAR0_CRC32_SHIFT) & ID_AA64ISAR0_CRC32_MASK) == 0) {
+    return FALSE;
+  }
+
+  Value = *Crc;
+
+  //
+  // Align Buffer to 64 bits so the main loop only issues aligned loads, which
+  // is required when running with strict alignment checking enabled.
+  //
+  while (Length > 0 && ((UINTN) Buffer & (sizeof (UINT64) - 1)) != 0) {
+    __asm__ (".arch_extension crc\n\tcrc32b %w0, %w0, %w1" : "+r" (Value) : "r" ((UINT32) *Buffer));
+    Buffer++;
+    Length--;
+  }
+
+  while (Length >= sizeof (UINT64)) {
+    __asm__ (".arch_extension crc\n\tcrc32x %w0, %w0, %x1" : "+r" (Value) : "r" (*(CONST UINT64 *) Buffer));
+    Buffer += sizeof (UINT64);
+    Length -= sizeof (UINT64);
+  }
+
+  while (Length > 0) {
+    __asm__ (".arch_extension crc\n\tcrc32b %w0, %w0, %w1" : "+r" (Value) : "r" ((UINT32) *Buffer));
+    Buffer++;
+    Length--;
+  }
+
+  *Crc = Value;
+  return TRUE;
+}
@@ -568,6 +568,59 @@ InternalAsciiHexCharToUintn (
 //
 // Ia32 and x64 specific functions
 //
+//
+// CRC32 functions
+//
+
+//
+// Buffers shorter than this are always handled by the table driven CRC32
+// code. Probing for CPU support is not free (CPUID traps to the hypervisor
+// when running virtualized), so it only pays off for larger buffers.
+//
+#define CRC32_ACCELERATED_MIN_LENGTH  4096
+
+/**
+  Updates a running CRC32 value with the contents of a buffer using the
+  slice-by-8 tables.
+
+  The CRC is neither pre- nor post-conditioned, so the caller is responsible
+  for the initial 0xFFFFFFFF value and the final inversion.
+
+  @param[in]  Crc          The running CRC value.
+  @param[in]  Buffer       A pointer to the data to fold into the CRC.
+  @param[in]  Length       The number of bytes in Buffer.
+
+  @return The updated CRC value.
+
+**/
+UINT32
+InternalCrc32Update (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  );
+
+/**
+  Updates a running CRC32 value using CPU specific instructions.
+
+  @param[in, out]  Crc     On input, the running CRC value. On output, the
+                           CRC updated with the contents of Buffer. Only
+                           modified when TRUE is returned.
+  @param[in]       Buffer  A pointer to the data to fold into the CRC.
+  @param[in]       Length  The number of bytes in Buffer.
+
+  @retval TRUE   The CRC was updated.
+  @retval FALSE  The CPU does not provide the required instructions; the
+                 caller must fall back to InternalCrc32Update().
+
+**/
+BOOLEAN
+InternalCrc32Accelerated (
+  IN OUT UINT32       *Crc,
+  IN     CONST UINT8  *Buffer,
+  IN     UINTN        Length
+  );
+
 #if defined (MDE_CPU_IA32) || defined (MDE_CPU_X64)
 
 /**
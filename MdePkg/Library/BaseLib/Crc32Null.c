@@ -0,0 +1,32 @@
+/** @file
+  CRC32 acceleration hook for architectures and toolchains without a CPU
+  specific implementation.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseLibInternals.h"
+
+/**
+  Updates a running CRC32 value using CPU specific instructions.
+
+  @param[in, out]  Crc     On input, the running CRC value. On output, the
+                           CRC updated with the contents of Buffer. Only
+                           modified when TRUE is returned.
+  @param[in]       Buffer  A pointer to the data to fold into the CRC.
+  @param[in]       Length  The number of bytes in Buffer.
+
+  @retval FALSE  Always; the table driven implementation is used.
+
+**/
+BOOLEAN
+InternalCrc32Accelerated (
+  IN OUT UINT32       *Crc,
+  IN     CONST UINT8  *Buffer,
+  IN     UINTN        Length
+  )
+{
+  return FALSE;
+}
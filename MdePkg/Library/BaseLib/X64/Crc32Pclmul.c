@@ -0,0 +1,189 @@
+/** @file
+  CRC32 implementation for x64 using carry-less multiplication (PCLMULQDQ).
+
+  The buffer is folded 64 bytes at a time into four 128-bit accumulators which
+  are then reduced to a single 32-bit value with a Barrett reduction, as
+  described in "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+  Instruction" (Intel, 2009). The constants below are for the bit-reflected
+  ITU-T V.42 polynomial 0x04C11DB7 used by CalculateCrc32().
+
+  CLANG toolchains build BaseLib with -mno-sse -msoft-float. LLVM cannot lower
+  PCLMULQDQ in soft-float code, even inside a function with a target attribute,
+  so those toolchains keep the table driven implementation.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseLibInternals.h"
+
+#if !defined (__clang__)
+
+#define CPUID_VERSION_INFO_ECX_PCLMULQDQ  BIT1
+
+typedef long long  CRC32_VECTOR __attribute__ ((vector_size (16)));
+typedef long long  CRC32_VECTOR_UNALIGNED __attribute__ ((vector_size (16), may_alias, aligned (1)));
+
+#define CRC32_LOAD(Pointer)             (*(CONST CRC32_VECTOR_UNALIGNED *) (Pointer))
+#define CRC32_CLMUL(A, B, Imm)          __builtin_ia32_pclmulqdq128 ((A), (B), (Imm))
+#define CRC32_FOLD(Acc, Keys, Data)     (CRC32_CLMUL ((Acc), (Keys), 0x00) ^ CRC32_CLMUL ((Acc), (Keys), 0x11) ^ (Data))
+
+/**
+  Folds a buffer into a running CRC32 value using PCLMULQDQ.
+
+  @param[in]  Crc          The running CRC value.
+  @param[in]  Buffer       A pointer to the data to fold into the CRC.
+  @param[in]  Length       The number of bytes in Buffer. Must be a multiple of
+                           16 and at least 64.
+
+  @return The updated CRC value.
+
+**/
+STATIC
+UINT32
+__attribute__ ((target ("sse2,pclmul")))
+Crc32Pclmul (
+  IN UINT32       Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  CRC32_VECTOR  K1K2;
+  CRC32_VECTOR  K3K4;
+  CRC32_VECTOR  K5;
+  CRC32_VECTOR  PolyMu;
+  CRC32_VECTOR  Mask32;
+  CRC32_VECTOR  X0;
+  CRC32_VECTOR  X1;
+  CRC32_VECTOR  X2;
+  CRC32_VECTOR  X3;
+  CRC32_VECTOR  Temp;
+
+  K1K2   = (CRC32_VECTOR) { 0x154442BD4LL, 0x1C6E41596LL };
+  K3K4   = (CRC32_VECTOR) { 0x1751997D0LL, 0x0CCAA009ELL };
+  K5     = (CRC32_VECTOR) { 0x163CD6124LL, 0 };
+  PolyMu = (CRC32_VECTOR) { 0x1DB710641LL, 0x1F7011641LL };
+  Mask32 = (CRC32_VECTOR) { 0xFFFFFFFFLL,  0 };
+
+  X0 = CRC32_LOAD (Buffer) ^ (CRC32_VECTOR) { Crc, 0 };
+  X1 = CRC32_LOAD (Buffer + 16);
+  X2 = CRC32_LOAD (Buffer + 32);
+  X3 = CRC32_LOAD (Buffer + 48);
+  Buffer += 64;
+  Length -= 64;
+
+  //
+  // Fold 512 bits at a time.
+  //
+  while (Length >= 64) {
+    X0 = CRC32_FOLD (X0, K1K2, CRC32_LOAD (Buffer));
+    X1 = CRC32_FOLD (X1, K1K2, CRC32_LOAD (Buffer + 16));
+    X2 = CRC32_FOLD (X2, K1K2, CRC32_LOAD (Buffer + 32));
+    X3 = CRC32_FOLD (X3, K1K2, CRC32_LOAD (Buffer + 48));
+    Buffer += 64;
+    Length -= 64;
+  }
+
+  //
+  // Fold the four accumulators into one, then any remaining 128-bit blocks.
+  //
+  X0 = CRC32_FOLD (X0, K3K4, X1);
+  X0 = CRC32_FOLD (X0, K3K4, X2);
+  X0 = CRC32_FOLD (X0, K3K4, X3);
+  while (Length >= 16) {
+    X0 = CRC32_FOLD (X0, K3K4, CRC32_LOAD (Buffer));
+    Buffer += 16;
+    Length -= 16;
+  }
+
+  //
+  // 128 -> 64 bits, appending the 32 zero bits the CRC definition implies.
+  //
+  Temp = CRC32_CLMUL (X0, K3K4, 0x10);
+  X0   = (CRC32_VECTOR) { X0[1], 0 } ^ Temp;
+
+  //
+  // 64 -> 32 bits.
+  //
+  Temp = (CRC32_VECTOR) {
+           (long long) (((UINT64) X0[0] >> 32) | ((UINT64) X0[1] << 32)),
+           (long long) ((UINT64) X0[1] >> 32)
+         };
+  X0 = CRC32_CLMUL (X0 & Mask32, K5, 0x00) ^ Temp;
+
+  //
+  // Barrett reduction to the final 32-bit remainder.
+  //
+  Temp = X0;
+  X0   = CRC32_CLMUL (X0 & Mask32, PolyMu, 0x10);
+  X0   = CRC32_CLMUL (X0 & Mask32, PolyMu, 0x00);
+  X0  ^= Temp;
+
+  return (UINT32) ((UINT64) X0[0] >> 32);
+}
+
+/**
+  Updates a running CRC32 value using CPU specific instructions.
+
+  @param[in, out]  Crc     On input, the running CRC value. On output, the
+                           CRC updated with the contents of Buffer. Only
+                           modified when TRUE is returned.
+  @param[in]       Buffer  A pointer to the data to fold into the CRC.
+  @param[in]       Length  The number of bytes in Buffer.
+
+  @retval TRUE   The CRC was updated.
+  @retval FALSE  The CPU does not provide the required instructions; the
+                 caller must fall back to InternalCrc32Update().
+
+**/
+BOOLEAN
+InternalCrc32Accelerated (
+  IN OUT UINT32       *Crc,
+  IN     CONST UINT8  *Buffer,
+  IN     UINTN        Length
+  )
+{
+  UINT32  RegEcx;
+  UINTN   BlockLength;
+
+  AsmCpuid (1, NULL, NULL, &RegEcx, NULL);
+  if ((RegEcx & CPUID_VERSION_INFO_ECX_PCLMULQDQ) == 0) {
+    return FALSE;
+  }
+
+  BlockLength = Length & ~(UINTN) 0xF;
+  if (BlockLength < 64) {
+    return FALSE;
+  }
+
+  *Crc = Crc32Pclmul (*Crc, Buffer, BlockLength);
+  *Crc = InternalCrc32Update (*Crc, Buffer + BlockLength, Length - BlockLength);
+  return TRUE;
+}
+
+#else
+
+/**
+  Updates a running CRC32 value using CPU specific instructions.
+
+  @param[in, out]  Crc     On input, the running CRC value. On output, the
+                           CRC updated with the contents of Buffer. Only
+                           modified when TRUE is returned.
+  @param[in]       Buffer  A pointer to the data to fold into the CRC.
+  @param[in]       Length  The number of bytes in Buffer.
+
+  @retval FALSE  Always; the table driven implementation is used.
+
+**/
+BOOLEAN
+InternalCrc32Accelerated (
+  IN OUT UINT32       *Crc,
+  IN     CONST UINT8  *Buffer,
+  IN     UINTN        Length
+  )
+{
+  return FALSE;
+}
+
+#endif
@@ -0,0 +1,475 @@
+/** @file
+  Unit tests of the CalculateCrc32() API in BaseLib.
+
+  Every length and alignment on both sides of the point where BaseLib switches
+  to the CPU specific implementation is checked against a straightforward
+  byte-at-a-time reference, and a throughput benchmark reports how fast the
+  implementation selected on the running CPU is. The CPU specific
+  implementation is also called directly, so it is checked even where
+  CalculateCrc32() would not select it.
+
+  Host builds replace the UnitTestHostBaseLib AsmCpuid() with one that
+  executes CPUID, so BaseLib makes the same choice it would on the target.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "Crc32UnitTest.h"
+
+#define UNIT_TEST_APP_NAME     "BaseLib CRC32 Unit Test Application"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+//
+// Exhaustively test every length up to this, which is well beyond the
+// smallest buffer BaseLib hands to the CPU specific implementation.
+//
+#define CRC32_TEST_EXHAUSTIVE_LENGTH  (SIZE_8KB + 256)
+#define CRC32_TEST_MAX_ALIGNMENT      16
+#define CRC32_TEST_LARGE_LENGTH       (SIZE_1MB + 7)
+#define CRC32_BENCHMARK_BYTES         (SIZE_64MB)
+
+#define CPUID_VERSION_INFO_ECX_PCLMULQDQ  BIT1
+
+STATIC UINT32  mReferenceCrcTable[256];
+STATIC UINT8   *mTestBuffer;
+
+/**
+  Folds one byte into a reference CRC.
+
+  @param[in]  Crc    The running CRC value.
+  @param[in]  Data   The byte to fold in.
+
+  @return The updated CRC value.
+
+**/
+STATIC
+UINT32
+ReferenceCrc32Byte (
+  IN UINT32  Crc,
+  IN UINT8   Data
+  )
+{
+  return (Crc >> 8) ^ mReferenceCrcTable[(UINT8) Crc ^ Data];
+}
+
+/**
+  Computes a reference CRC32 one byte at a time.
+
+  @param[in]  Buffer   The data to checksum.
+  @param[in]  Length   The number of bytes in Buffer.
+
+  @return The CRC32 of Buffer.
+
+**/
+STATIC
+UINT32
+ReferenceCrc32 (
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  UINT32  Crc;
+
+  Crc = 0xFFFFFFFF;
+  while (Length-- > 0) {
+    Crc = ReferenceCrc32Byte (Crc, *Buffer++);
+  }
+
+  return Crc ^ 0xFFFFFFFF;
+}
+
+/**
+  Builds the reference table and a pseudo random test buffer.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED                      The buffer was allocated.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  Out of memory.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc32TestSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32  Index;
+  UINT32  Bit;
+  UINT32  Value;
+  UINT32  Seed;
+
+  for (Index = 0; Index < ARRAY_SIZE (mReferenceCrcTable); Index++) {
+    Value = Index;
+    for (Bit = 0; Bit < 8; Bit++) {
+      Value = ((Value & 1) != 0) ? ((Value >> 1) ^ 0xEDB88320) : (Value >> 1);
+    }
+    mReferenceCrcTable[Index] = Value;
+  }
+
+  mTestBuffer = AllocatePool (CRC32_TEST_LARGE_LENGTH + CRC32_TEST_MAX_ALIGNMENT);
+  if (mTestBuffer == NULL) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  Seed = 0x12345678;
+  for (Index = 0; Index < CRC32_TEST_LARGE_LENGTH + CRC32_TEST_MAX_ALIGNMENT; Index++) {
+    Seed = Seed * 1103515245 + 12345;
+    mTestBuffer[Index] = (UINT8) (Seed >> 16);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Frees the test buffer.
+
+  @param[in]  Context    Unused.
+**/
+STATIC
+VOID
+EFIAPI
+Crc32TestCleanup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mTestBuffer != NULL) {
+    FreePool (mTestBuffer);
+    mTestBuffer = NULL;
+  }
+}
+
+/**
+  Checks CalculateCrc32() against published check values.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc32KnownVectorTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Buffer[32];
+  UINTN  Index;
+
+  UT_ASSERT_EQUAL (CalculateCrc32 ("123456789", 9), 0xCBF43926);
+  UT_ASSERT_EQUAL (CalculateCrc32 ("The quick brown fox jumps over the lazy dog", 43), 0x414FA339);
+  UT_ASSERT_EQUAL (CalculateCrc32 (Buffer, 0), 0);
+
+  ZeroMem (Buffer, sizeof (Buffer));
+  UT_ASSERT_EQUAL (CalculateCrc32 (Buffer, sizeof (Buffer)), 0x190A55AD);
+
+  SetMem (Buffer, sizeof (Buffer), 0xFF);
+  UT_ASSERT_EQUAL (CalculateCrc32 (Buffer, sizeof (Buffer)), 0xFF6CAB0B);
+
+  for (Index = 0; Index < sizeof (Buffer); Index++) {
+    Buffer[Index] = (UINT8) Index;
+  }
+  UT_ASSERT_EQUAL (CalculateCrc32 (Buffer, sizeof (Buffer)), 0x91267E8A);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Compares CalculateCrc32() with the reference for every length up to
+  CRC32_TEST_EXHAUSTIVE_LENGTH at every alignment up to
+  CRC32_TEST_MAX_ALIGNMENT.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc32ExhaustiveTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN   Alignment;
+  UINTN   Length;
+  UINT32  Reference;
+  UINT32  Crc;
+
+  for (Alignment = 0; Alignment < CRC32_TEST_MAX_ALIGNMENT; Alignment++) {
+    //
+    // The reference CRC of each prefix is extended one byte at a time.
+    //
+    Reference = 0xFFFFFFFF;
+    for (Length = 0; Length <= CRC32_TEST_EXHAUSTIVE_LENGTH; Length++) {
+      Crc = CalculateCrc32 (mTestBuffer + Alignment, Length);
+      if (Crc != (Reference ^ 0xFFFFFFFF)) {
+        UT_LOG_ERROR ("Alignment %u Length %u: %08x != %08x\n", (UINT32) Alignment, (UINT32) Length, Crc, Reference ^ 0xFFFFFFFF);
+      }
+      UT_ASSERT_EQUAL (Crc, Reference ^ 0xFFFFFFFF);
+      Reference = ReferenceCrc32Byte (Reference, mTestBuffer[Alignment + Length]);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Compares CalculateCrc32() with the reference for large buffers.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc32LargeBufferTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Alignment;
+  UINTN  Length;
+
+  for (Length = SIZE_64KB - 1; Length <= CRC32_TEST_LARGE_LENGTH; Length = Length * 2 + 3) {
+    for (Alignment = 0; Alignment < CRC32_TEST_MAX_ALIGNMENT; Alignment += 5) {
+      UT_ASSERT_EQUAL (
+        CalculateCrc32 (mTestBuffer + Alignment, Length),
+        ReferenceCrc32 (mTestBuffer + Alignment, Length)
+        );
+    }
+  }
+
+  UT_ASSERT_EQUAL (
+    CalculateCrc32 (mTestBuffer, CRC32_TEST_LARGE_LENGTH),
+    ReferenceCrc32 (mTestBuffer, CRC32_TEST_LARGE_LENGTH)
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Returns whether BaseLib is expected to provide a CPU specific CRC32
+  implementation on the running CPU.
+
+  @retval TRUE   InternalCrc32Accelerated() must handle large buffers.
+  @retval FALSE  InternalCrc32Accelerated() may decline every buffer.
+
+**/
+STATIC
+BOOLEAN
+Crc32AcceleratedExpected (
+  VOID
+  )
+{
+#if defined (MDE_CPU_X64) && defined (__GNUC__) && !defined (__clang__)
+  UINT32  RegEcx;
+
+  AsmCpuid (1, NULL, NULL, &RegEcx, NULL);
+  return (BOOLEAN) ((RegEcx & CPUID_VERSION_INFO_ECX_PCLMULQDQ) != 0);
+#else
+  return FALSE;
+#endif
+}
+
+/**
+  Calls the CPU specific CRC32 implementation directly and compares it with
+  the reference for every length from 64 bytes, the smallest block it folds,
+  up to twice CRC32_TEST_EXHAUSTIVE_LENGTH at several alignments, and for a
+  large buffer.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+  @retval  UNIT_TEST_SKIPPED            The CPU or toolchain has no CPU specific
+                                        implementation.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc32AcceleratedTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN    Alignment;
+  UINTN    Length;
+  UINT32   Crc;
+  BOOLEAN  Expected;
+
+  Expected = Crc32AcceleratedExpected ();
+  Crc      = 0xFFFFFFFF;
+  if (!InternalCrc32Accelerated (&Crc, mTestBuffer, CRC32_TEST_LARGE_LENGTH)) {
+    UT_ASSERT_FALSE (Expected);
+    UT_LOG_WARNING ("No CPU specific CRC32 implementation, skipping\n");
+    return UNIT_TEST_SKIPPED;
+  }
+
+  UT_ASSERT_EQUAL (Crc ^ 0xFFFFFFFF, ReferenceCrc32 (mTestBuffer, CRC32_TEST_LARGE_LENGTH));
+
+  for (Alignment = 0; Alignment < CRC32_TEST_MAX_ALIGNMENT; Alignment += 3) {
+    for (Length = 64; Length <= 2 * CRC32_TEST_EXHAUSTIVE_LENGTH; Length++) {
+      Crc = 0xFFFFFFFF;
+      UT_ASSERT_TRUE (InternalCrc32Accelerated (&Crc, mTestBuffer + Alignment, Length));
+      if ((Crc ^ 0xFFFFFFFF) != ReferenceCrc32 (mTestBuffer + Alignment, Length)) {
+        UT_LOG_ERROR ("Alignment %u Length %u: %08x != %08x\n", (UINT32) Alignment, (UINT32) Length, Crc ^ 0xFFFFFFFF, ReferenceCrc32 (mTestBuffer + Alignment, Length));
+      }
+      UT_ASSERT_EQUAL (Crc ^ 0xFFFFFFFF, ReferenceCrc32 (mTestBuffer + Alignment, Length));
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Reports the CalculateCrc32() throughput for a range of buffer sizes.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The benchmark ran.
+  @retval  UNIT_TEST_SKIPPED            No usable timer is available.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc32BenchmarkTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINTN  Sizes[] = { 64, 512, SIZE_4KB, SIZE_64KB, SIZE_1MB };
+  UINTN               Index;
+  UINTN               Iteration;
+  UINTN               Iterations;
+  UINT64              Start;
+  UINT64              Elapsed;
+  UINT32              Crc;
+
+  Crc = 0;
+  for (Index = 0; Index < ARRAY_SIZE (Sizes); Index++) {
+    Iterations = CRC32_BENCHMARK_BYTES / Sizes[Index];
+    Start      = Crc32BenchmarkStart ();
+    for (Iteration = 0; Iteration < Iterations; Iteration++) {
+      Crc ^= CalculateCrc32 (mTestBuffer, Sizes[Index]);
+    }
+    Elapsed = Crc32BenchmarkElapsedNanoSeconds (Start);
+    if (Elapsed == 0) {
+      UT_LOG_WARNING ("No usable timer, skipping the CRC32 benchmark\n");
+      return UNIT_TEST_SKIPPED;
+    }
+
+    UT_LOG_INFO (
+      "CalculateCrc32 %8u bytes: %5lu MB/s\n",
+      (UINT32) Sizes[Index],
+      DivU64x64Remainder (MultU64x32 (CRC32_BENCHMARK_BYTES, 1000), Elapsed, NULL)
+      );
+  }
+
+  //
+  // Keep the result live so the loop above cannot be optimized away.
+  //
+  UT_LOG_INFO ("Accumulated CRC %08x\n", Crc);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  CalculateCrc32() API in BaseLib and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Fw;
+  UNIT_TEST_SUITE_HANDLE      Crc32Tests;
+
+  Fw = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Crc32TestInitializeCpuid ();
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Fw, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the CRC32 Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&Crc32Tests, Fw, "CRC32", "BaseLib.Crc32", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Crc32Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  // --------------Suite-------Description-------------------------------Class Name-----Function-------------Pre------------Post-------------Context
+  AddTestCase (Crc32Tests, "Published check values",                   "KnownVectors", Crc32KnownVectorTest, NULL,           NULL,             NULL);
+  AddTestCase (Crc32Tests, "Every length and alignment vs reference",  "Exhaustive",   Crc32ExhaustiveTest,  Crc32TestSetup, Crc32TestCleanup, NULL);
+  AddTestCase (Crc32Tests, "Large buffers vs reference",               "LargeBuffer",  Crc32LargeBufferTest, Crc32TestSetup, Crc32TestCleanup, NULL);
+  AddTestCase (Crc32Tests, "CPU specific implementation vs reference", "Accelerated",  Crc32AcceleratedTest, Crc32TestSetup, Crc32TestCleanup, NULL);
+  AddTestCase (Crc32Tests, "Throughput",                               "Benchmark",    Crc32BenchmarkTest,   Crc32TestSetup, Crc32TestCleanup, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Fw);
+
+EXIT:
+  if (Fw) {
+    FreeUnitTestFramework (Fw);
+  }
+
+  return Status;
+}
+
+/**
+  Standard UEFI entry point for target based unit test execution from UEFI Shell.
+**/
+EFI_STATUS
+EFIAPI
+BaseLibCrc32UnitTestAppEntry (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  return UnitTestingEntry ();
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int argc,
+  char *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -0,0 +1,72 @@
+/** @file
+  Declarations shared between the CalculateCrc32() unit tests and their host or
+  target specific support code.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __CRC32_UNIT_TEST_H__
+#define __CRC32_UNIT_TEST_H__
+
+#include <Uefi.h>
+#include <Library/UnitTestLib.h>
+
+/**
+  Returns an opaque start timestamp for Crc32BenchmarkElapsedNanoSeconds().
+
+  @return The current timestamp.
+
+**/
+UINT64
+Crc32BenchmarkStart (
+  VOID
+  );
+
+/**
+  Returns the time elapsed since a timestamp returned by Crc32BenchmarkStart().
+
+  @param[in]  Start   The timestamp returned by Crc32BenchmarkStart().
+
+  @return The elapsed time in nanoseconds, or 0 if no usable timer is available.
+
+**/
+UINT64
+Crc32BenchmarkElapsedNanoSeconds (
+  IN UINT64  Start
+  );
+
+/**
+  Makes AsmCpuid() report the features of the CPU running the tests, so that
+  BaseLib selects the same CRC32 implementation it would on that CPU.
+
+**/
+VOID
+Crc32TestInitializeCpuid (
+  VOID
+  );
+
+/**
+  Updates a running CRC32 value using CPU specific instructions. Implemented
+  by BaseLib.
+
+  @param[in, out]  Crc     On input, the running CRC value. On output, the
+                           CRC updated with the contents of Buffer. Only
+                           modified when TRUE is returned.
+  @param[in]       Buffer  A pointer to the data to fold into the CRC.
+  @param[in]       Length  The number of bytes in Buffer.
+
+  @retval TRUE   Crc was updated.
+  @retval FALSE  The CPU or toolchain does not support an accelerated
+                 implementation; Crc is unchanged.
+
+**/
+BOOLEAN
+InternalCrc32Accelerated (
+  IN OUT UINT32       *Crc,
+  IN     CONST UINT8  *Buffer,
+  IN     UINTN        Length
+  );
+
+#endif
@@ -0,0 +1,124 @@
+/** @file
+  Support code for the CalculateCrc32() unit tests run from the host
+  environment. The benchmark timer is based on the C library clock() function.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <time.h>
+#if defined (MDE_CPU_IA32) || defined (MDE_CPU_X64)
+#if defined (_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/UnitTestHostBaseLib.h>
+
+#include "Crc32UnitTest.h"
+
+/**
+  Returns an opaque start timestamp for Crc32BenchmarkElapsedNanoSeconds().
+
+  @return The current timestamp.
+
+**/
+UINT64
+Crc32BenchmarkStart (
+  VOID
+  )
+{
+  return (UINT64) clock ();
+}
+
+/**
+  Returns the time elapsed since a timestamp returned by Crc32BenchmarkStart().
+
+  @param[in]  Start   The timestamp returned by Crc32BenchmarkStart().
+
+  @return The elapsed time in nanoseconds, or 0 if no usable timer is available.
+
+**/
+UINT64
+Crc32BenchmarkElapsedNanoSeconds (
+  IN UINT64  Start
+  )
+{
+  return ((UINT64) clock () - Start) * 1000000000ULL / CLOCKS_PER_SEC;
+}
+
+#if defined (MDE_CPU_IA32) || defined (MDE_CPU_X64)
+
+/**
+  Retrieves CPUID information by executing the CPUID instruction, replacing
+  the UnitTestHostBaseLib default that returns all zeroes.
+
+  @param  Index The 32-bit value to load into EAX prior to invoking the CPUID
+                instruction.
+  @param  Eax   The pointer to the 32-bit EAX value returned by the CPUID
+                instruction. This is an optional parameter that may be NULL.
+  @param  Ebx   The pointer to the 32-bit EBX value returned by the CPUID
+                instruction. This is an optional parameter that may be NULL.
+  @param  Ecx   The pointer to the 32-bit ECX value returned by the CPUID
+                instruction. This is an optional parameter that may be NULL.
+  @param  Edx   The pointer to the 32-bit EDX value returned by the CPUID
+                instruction. This is an optional parameter that may be NULL.
+
+  @return Index.
+
+**/
+STATIC
+UINT32
+EFIAPI
+Crc32TestHostAsmCpuid (
+  IN      UINT32                    Index,
+  OUT     UINT32                    *Eax,  OPTIONAL
+  OUT     UINT32                    *Ebx,  OPTIONAL
+  OUT     UINT32                    *Ecx,  OPTIONAL
+  OUT     UINT32                    *Edx   OPTIONAL
+  )
+{
+  UINT32  Registers[4];
+
+#if defined (_MSC_VER)
+  __cpuid ((int *) Registers, (int) Index);
+#else
+  __cpuid (Index, Registers[0], Registers[1], Registers[2], Registers[3]);
+#endif
+
+  if (Eax != NULL) {
+    *Eax = Registers[0];
+  }
+  if (Ebx != NULL) {
+    *Ebx = Registers[1];
+  }
+  if (Ecx != NULL) {
+    *Ecx = Registers[2];
+  }
+  if (Edx != NULL) {
+    *Edx = Registers[3];
+  }
+  return Index;
+}
+
+#endif
+
+/**
+  Makes AsmCpuid() report the features of the CPU running the tests, so that
+  BaseLib selects the same CRC32 implementation it would on that CPU.
+
+**/
+VOID
+Crc32TestInitializeCpuid (
+  VOID
+  )
+{
+#if defined (MDE_CPU_IA32) || defined (MDE_CPU_X64)
+  gUnitTestHostBaseLib.X86->AsmCpuid = Crc32TestHostAsmCpuid;
+#endif
+}
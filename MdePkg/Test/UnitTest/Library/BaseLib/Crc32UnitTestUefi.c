@@ -0,0 +1,72 @@
+/** @file
+  Support code for the CalculateCrc32() unit tests run from UEFI Shell. The
+  benchmark timer is based on the TimerLib performance counter.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/TimerLib.h>
+
+#include "Crc32UnitTest.h"
+
+/**
+  Returns an opaque start timestamp for Crc32BenchmarkElapsedNanoSeconds().
+
+  @return The current timestamp.
+
+**/
+UINT64
+Crc32BenchmarkStart (
+  VOID
+  )
+{
+  return GetPerformanceCounter ();
+}
+
+/**
+  Returns the time elapsed since a timestamp returned by Crc32BenchmarkStart().
+
+  @param[in]  Start   The timestamp returned by Crc32BenchmarkStart().
+
+  @return The elapsed time in nanoseconds, or 0 if no usable timer is available.
+
+**/
+UINT64
+Crc32BenchmarkElapsedNanoSeconds (
+  IN UINT64  Start
+  )
+{
+  UINT64  End;
+  UINT64  StartValue;
+  UINT64  EndValue;
+
+  End = GetPerformanceCounter ();
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+
+  //
+  // The counter may count down; the benchmark never runs long enough for it
+  // to wrap.
+  //
+  if (StartValue > EndValue) {
+    return GetTimeInNanoSecond (Start - End);
+  }
+
+  return GetTimeInNanoSecond (End - Start);
+}
+
+/**
+  Makes AsmCpuid() report the features of the CPU running the tests, so that
+  BaseLib selects the same CRC32 implementation it would on that CPU.
+
+  AsmCpuid() already executes CPUID in the UEFI Shell, so there is nothing to
+  do.
+
+**/
+VOID
+Crc32TestInitializeCpuid (
+  VOID
+  )
+{
+}
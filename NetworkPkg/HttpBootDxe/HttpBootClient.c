@@ -580,21 +580,25 @@ HttpBootHttpIoCallback (
 }
 
 /**
-  Create a HttpIo instance for the file download.
+  Create a HttpIo instance configured with the driver's station address.
 
   @param[in]    Private        The pointer to the driver's private data.
+  @param[in]    Callback       Callback function invoked on the HTTP request and
+                               response messages, or NULL.
+  @param[out]   HttpIo         The HttpIo instance to create.
 
   @retval EFI_SUCCESS          Successfully created.
   @retval Others               Failed to create HttpIo.
 
 **/
 EFI_STATUS
-HttpBootCreateHttpIo (
-  IN     HTTP_BOOT_PRIVATE_DATA       *Private
+HttpBootCreateHttpIoInstance (
+  IN     HTTP_BOOT_PRIVATE_DATA       *Private,
+  IN     HTTP_IO_CALLBACK             Callback,    OPTIONAL
+     OUT HTTP_IO                      *HttpIo
   )
 {
   HTTP_IO_CONFIG_DATA          ConfigData;
-  EFI_STATUS                   Status;
   EFI_HANDLE                   ImageHandle;
 
   ASSERT (Private != NULL);
@@ -613,15 +617,36 @@ HttpBootCreateHttpIo (
     ImageHandle = Private->Ip6Nic->ImageHandle;
   }
 
-  Status = HttpIoCreateIo (
-             ImageHandle,
-             Private->Controller,
-             Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
-             &ConfigData,
-             HttpBootHttpIoCallback,
-             (VOID *) Private,
-             &Private->HttpIo
-             );
+  return HttpIoCreateIo (
+           ImageHandle,
+           Private->Controller,
+           Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
+           &ConfigData,
+           Callback,
+           (VOID *) Private,
+           HttpIo
+           );
+}
+
+/**
+  Create a HttpIo instance for the file download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA       *Private
+  )
+{
+  EFI_STATUS                   Status;
+
+  ASSERT (Private != NULL);
+
+  Status = HttpBootCreateHttpIoInstance (Private, HttpBootHttpIoCallback, &Private->HttpIo);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -630,6 +655,23 @@ HttpBootCreateHttpIo (
   return EFI_SUCCESS;
 }
 
+/**
+  Destroy the extra HttpIo instances used by the parallel byte-range download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+**/
+VOID
+HttpBootDestroyRangeHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA       *Private
+  )
+{
+  while (Private->RangeHttpIoCount > 0) {
+    Private->RangeHttpIoCount--;
+    HttpIoDestroyIo (&Private->RangeHttpIo[Private->RangeHttpIoCount]);
+  }
+}
+
 /**
   Release all the resource of a cache item.
 
@@ -869,6 +911,345 @@ HttpBootGetBootFileCallback (
   }
   return EFI_SUCCESS;
 }
+/**
+  Check that the "Content-Range" header of a 206 response names exactly the
+  requested range, "bytes Offset-Last/FileSize" where Last is the offset of the
+  last byte of the range (RFC 7233). The complete length may also be "*".
+
+  @param[in]       HeaderCount     Number of HTTP header structures in Headers.
+  @param[in]       Headers         Array containing list of HTTP headers.
+  @param[in]       Offset          The offset of the requested range.
+  @param[in]       Length          The length of the requested range.
+  @param[in]       FileSize        The size of the whole file.
+
+  @retval TRUE                     The response carries the requested range.
+  @retval FALSE                    The header is missing, malformed or names
+                                   another range.
+
+**/
+BOOLEAN
+HttpBootCheckContentRange (
+  IN     UINTN                    HeaderCount,
+  IN     EFI_HTTP_HEADER          *Headers,
+  IN     UINTN                    Offset,
+  IN     UINTN                    Length,
+  IN     UINTN                    FileSize
+  )
+{
+  EFI_HTTP_HEADER            *Header;
+  CHAR8                      *Value;
+  CHAR8                      *End;
+  UINT64                     First;
+  UINT64                     Last;
+  UINT64                     Complete;
+
+  Header = HttpFindHeader (HeaderCount, Headers, HTTP_HEADER_CONTENT_RANGE);
+  if (Header == NULL || Header->FieldValue == NULL) {
+    return FALSE;
+  }
+
+  Value = Header->FieldValue;
+  if (AsciiStrnCmp (Value, "bytes ", 6) != 0) {
+    return FALSE;
+  }
+  Value += 6;
+
+  if (RETURN_ERROR (AsciiStrDecimalToUint64S (Value, &End, &First)) || End == Value || *End != '-') {
+    return FALSE;
+  }
+  Value = End + 1;
+
+  if (RETURN_ERROR (AsciiStrDecimalToUint64S (Value, &End, &Last)) || End == Value || *End != '/') {
+    return FALSE;
+  }
+  Value = End + 1;
+
+  if (*Value == '*') {
+    End = Value + 1;
+  } else if (RETURN_ERROR (AsciiStrDecimalToUint64S (Value, &End, &Complete)) || End == Value ||
+             Complete != FileSize) {
+    return FALSE;
+  }
+
+  while (*End == ' ' || *End == '\t') {
+    End++;
+  }
+
+  return (BOOLEAN) (*End == '\0' && First == Offset && Last == (UINT64) Offset + Length - 1);
+}
+
+/**
+  Download the boot file with parallel byte-range requests, one on each HttpIo
+  instance, and place every range directly at its offset in the caller provided
+  buffer.
+
+  The first range is requested on Private->HttpIo so the callback protocol sees
+  the download once; the others use the HttpIo instances in Private->RangeHttpIo,
+  which are created on demand and kept for the following downloads. The
+  responses are received on all the connections at once, each of them is
+  polled in turn without waiting for the others.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Url             The URL of the boot file.
+  @param[in]       RangeCount      The number of ranges to split the file into.
+  @param[out]      Buffer          The memory buffer to transfer the file to, it must
+                                   be at least Private->BootFileSize bytes.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          The server didn't respond with the requested range.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileByRange (
+  IN     HTTP_BOOT_PRIVATE_DATA   *Private,
+  IN     CHAR16                   *Url,
+  IN     UINTN                    RangeCount,
+     OUT UINT8                    *Buffer
+  )
+{
+  EFI_STATUS                 Status;
+  HTTP_IO                    *HttpIo[HTTP_BOOT_MAX_RANGE_CONNECTIONS];
+  UINTN                      Offset[HTTP_BOOT_MAX_RANGE_CONNECTIONS];
+  UINTN                      Length[HTTP_BOOT_MAX_RANGE_CONNECTIONS];
+  UINTN                      Received[HTTP_BOOT_MAX_RANGE_CONNECTIONS];
+  BOOLEAN                    Queued[HTTP_BOOT_MAX_RANGE_CONNECTIONS];
+  HTTP_IO_RESPONSE_DATA      ResponseData[HTTP_BOOT_MAX_RANGE_CONNECTIONS];
+  CHAR8                      RangeValue[HTTP_BOOT_RANGE_VALUE_SIZE];
+  CHAR8                      *HostName;
+  HTTP_IO_HEADER             *HttpIoHeader;
+  EFI_HTTP_REQUEST_DATA      RequestData;
+  UINTN                      ContentLength;
+  UINTN                      Pending;
+  UINTN                      Index;
+
+  ASSERT (RangeCount > 1 && RangeCount <= HTTP_BOOT_MAX_RANGE_CONNECTIONS);
+  ASSERT (Private->BootFileSize >= RangeCount);
+
+  //
+  // 1. Make sure there is one HTTP child per range.
+  //
+  while (Private->RangeHttpIoCount < RangeCount - 1) {
+    Status = HttpBootCreateHttpIoInstance (
+               Private,
+               NULL,
+               &Private->RangeHttpIo[Private->RangeHttpIoCount]
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+    Private->RangeHttpIoCount++;
+  }
+
+  for (Index = 0; Index < RangeCount; Index++) {
+    HttpIo[Index]   = (Index == 0) ? &Private->HttpIo : &Private->RangeHttpIo[Index - 1];
+    Offset[Index]   = (Private->BootFileSize / RangeCount) * Index;
+    Length[Index]   = (Index == RangeCount - 1) ?
+                      (Private->BootFileSize - Offset[Index]) :
+                      (Private->BootFileSize / RangeCount);
+    Received[Index] = 0;
+    Queued[Index]   = FALSE;
+  }
+
+  //
+  // 2. Build HTTP header for the request, the Range header is added to the
+  //    3 headers used to download a boot file:
+  //       Host
+  //       Accept
+  //       User-Agent
+  //       Range
+  //
+  HttpIoHeader = HttpIoCreateHeader (4);
+  if (HttpIoHeader == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  HostName = NULL;
+  Status = HttpUrlGetHostName (
+             Private->BootFileUri,
+             Private->BootFileUriParser,
+             &HostName
+             );
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+  Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_HOST, HostName);
+  FreePool (HostName);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_ACCEPT, "*/*");
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_USER_AGENT, HTTP_USER_AGENT_EFI_HTTP_BOOT);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  RequestData.Method = HttpMethodGet;
+  RequestData.Url    = Url;
+
+  //
+  // 3. Send out all the range requests before receiving any response, so the
+  //    server streams every range at the same time.
+  //
+  for (Index = 0; Index < RangeCount; Index++) {
+    AsciiSPrint (
+      RangeValue,
+      sizeof (RangeValue),
+      "bytes=%Lu-%Lu",
+      (UINT64) Offset[Index],
+      (UINT64) (Offset[Index] + Length[Index] - 1)
+      );
+    Status = HttpIoSetHeader (HttpIoHeader, HTTP_HEADER_RANGE, RangeValue);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    Status = HttpIoSendRequest (
+               HttpIo[Index],
+               &RequestData,
+               HttpIoHeader->HeaderCount,
+               HttpIoHeader->Headers,
+               0,
+               NULL
+               );
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+  }
+
+  //
+  // 4. Receive the response headers, each must be a 206 carrying exactly the
+  //    requested range.
+  //
+  for (Index = 0; Index < RangeCount; Index++) {
+    ZeroMem (&ResponseData[Index], sizeof (HTTP_IO_RESPONSE_DATA));
+    Status = HttpIoQueueResponse (HttpIo[Index], TRUE, &ResponseData[Index]);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+    Queued[Index] = TRUE;
+  }
+
+  Pending = RangeCount;
+  while (Pending > 0) {
+    for (Index = 0; Index < RangeCount; Index++) {
+      if (!Queued[Index]) {
+        continue;
+      }
+
+      Status = HttpIoPollResponse (HttpIo[Index], &ResponseData[Index]);
+      if (Status == EFI_NOT_READY) {
+        continue;
+      }
+      Queued[Index] = FALSE;
+      Pending--;
+
+      if (!EFI_ERROR (Status) && EFI_ERROR (ResponseData[Index].Status)) {
+        HttpBootPrintErrorMessage (ResponseData[Index].Response.StatusCode);
+        Status = ResponseData[Index].Status;
+      }
+      if (!EFI_ERROR (Status)) {
+        if (ResponseData[Index].Response.StatusCode != HTTP_STATUS_206_PARTIAL_CONTENT ||
+            EFI_ERROR (HttpIoGetContentLength (ResponseData[Index].HeaderCount, ResponseData[Index].Headers, &ContentLength)) ||
+            ContentLength != Length[Index] ||
+            !HttpBootCheckContentRange (
+               ResponseData[Index].HeaderCount,
+               ResponseData[Index].Headers,
+               Offset[Index],
+               Length[Index],
+               Private->BootFileSize
+               )) {
+          Status = EFI_UNSUPPORTED;
+        }
+      }
+      HttpFreeHeaderFields (ResponseData[Index].Headers, ResponseData[Index].HeaderCount);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+    }
+  }
+
+  //
+  // The default callback took the file size from the first range, restart
+  // its progress with the size of the whole file.
+  //
+  Private->FileSize     = Private->BootFileSize;
+  Private->ReceivedSize = 0;
+  Private->Percentage   = 0;
+
+  //
+  // 5. Receive the message-bodies directly into the caller's buffer. A new
+  //    receive is queued on a connection as soon as the previous one is done.
+  //
+  Pending = RangeCount;
+  Index   = 0;
+  while (Pending > 0) {
+    if (!Queued[Index] && Received[Index] < Length[Index]) {
+      ZeroMem (&ResponseData[Index], sizeof (HTTP_IO_RESPONSE_DATA));
+      ResponseData[Index].Body       = (CHAR8 *) Buffer + Offset[Index] + Received[Index];
+      ResponseData[Index].BodyLength = Length[Index] - Received[Index];
+      Status = HttpIoQueueResponse (HttpIo[Index], FALSE, &ResponseData[Index]);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+      Queued[Index] = TRUE;
+    }
+
+    if (Queued[Index]) {
+      Status = HttpIoPollResponse (HttpIo[Index], &ResponseData[Index]);
+      if (Status != EFI_NOT_READY) {
+        Queued[Index] = FALSE;
+        if (EFI_ERROR (Status) || EFI_ERROR (ResponseData[Index].Status)) {
+          if (EFI_ERROR (ResponseData[Index].Status)) {
+            Status = ResponseData[Index].Status;
+          }
+          goto ON_EXIT;
+        }
+
+        Received[Index] += ResponseData[Index].BodyLength;
+        if (Received[Index] == Length[Index]) {
+          Pending--;
+        }
+
+        if (Private->HttpBootCallback != NULL) {
+          Status = Private->HttpBootCallback->Callback (
+                     Private->HttpBootCallback,
+                     HttpBootHttpEntityBody,
+                     TRUE,
+                     (UINT32) ResponseData[Index].BodyLength,
+                     ResponseData[Index].Body
+                     );
+          if (EFI_ERROR (Status)) {
+            goto ON_EXIT;
+          }
+        }
+      }
+    }
+
+    Index = (Index + 1) % RangeCount;
+  }
+
+  Status = EFI_SUCCESS;
+
+ON_EXIT:
+  //
+  // Don't leave a receive pointing to ResponseData behind on an error.
+  //
+  for (Index = 0; Index < RangeCount; Index++) {
+    if (Queued[Index]) {
+      HttpIoCancelResponse (HttpIo[Index]);
+    }
+  }
+
+  HttpIoFreeHeader (HttpIoHeader);
+  return Status;
+}
 
 /**
   This function download the boot file by using UEFI HTTP protocol.
@@ -920,6 +1301,8 @@ HttpBootGetBootFile (
   CHAR16                     *Url;
   BOOLEAN                    IdentityMode;
   UINTN                      ReceivedSize;
+  UINTN                      RangeCount;
+  EFI_HTTP_HEADER            *Header;
 
   ASSERT (Private != NULL);
   ASSERT (Private->HttpCreated);
@@ -949,6 +1332,41 @@ HttpBootGetBootFile (
     }
   }
 
+  //
+  // Download the file with parallel byte-range requests if the server accepts
+  // them and the file is large enough to be split.
+  //
+  RangeCount = MIN (PcdGet8 (PcdHttpBootRangeConnections), HTTP_BOOT_MAX_RANGE_CONNECTIONS);
+  RangeCount = MIN (RangeCount, Private->BootFileSize / HTTP_BOOT_RANGE_MIN_SIZE);
+  if (!HeaderOnly && Buffer != NULL && Private->AcceptRanges &&
+      *BufferSize >= Private->BootFileSize && RangeCount > 1) {
+    Status = HttpBootGetBootFileByRange (Private, Url, RangeCount, Buffer);
+    if (!EFI_ERROR (Status)) {
+      *BufferSize = Private->BootFileSize;
+      *ImageType  = Private->ImageType;
+      FreePool (Url);
+      return EFI_SUCCESS;
+    }
+
+    DEBUG ((DEBUG_WARN, "HttpBootGetBootFileByRange: %r, fall back to a single request.\n", Status));
+
+    //
+    // The connections may still carry the rest of a response, so restart the
+    // download on a fresh HTTP child.
+    //
+    Private->AcceptRanges = FALSE;
+    HttpBootDestroyRangeHttpIo (Private);
+    HttpIoDestroyIo (&Private->HttpIo);
+    Private->HttpCreated = FALSE;
+    if (Status != EFI_ABORTED) {
+      Status = HttpBootCreateHttpIo (Private);
+    }
+    if (EFI_ERROR (Status)) {
+      FreePool (Url);
+      return Status;
+    }
+  }
+
   //
   // Not found in cache, try to download it through HTTP.
   //
@@ -1103,6 +1521,19 @@ HttpBootGetBootFile (
     goto ERROR_5;
   }
 
+  //
+  // Remember whether the server accepts byte-range requests for the file.
+  //
+  if (HeaderOnly) {
+    Header = HttpFindHeader (
+               ResponseData->HeaderCount,
+               ResponseData->Headers,
+               HTTP_HEADER_ACCEPT_RANGES
+               );
+    Private->AcceptRanges = (BOOLEAN) (Header != NULL &&
+                                       AsciiStriCmp (Header->FieldValue, HTTP_HEADER_ACCEPT_RANGES_BYTES) == 0);
+  }
+
   //
   // 3.2 Cache the response header.
   //
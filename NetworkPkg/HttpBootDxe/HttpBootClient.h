@@ -14,6 +14,15 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define HTTP_BOOT_RESPONSE_TIMEOUT           5000      // 5 seconds in uints of millisecond.
 #define HTTP_BOOT_BLOCK_SIZE                 1500
 
+//
+// Limits of the parallel byte-range download. A boot file is split into at most
+// HTTP_BOOT_MAX_RANGE_CONNECTIONS ranges, and no range is smaller than
+// HTTP_BOOT_RANGE_MIN_SIZE.
+//
+#define HTTP_BOOT_MAX_RANGE_CONNECTIONS      8
+#define HTTP_BOOT_RANGE_MIN_SIZE             SIZE_1MB
+#define HTTP_BOOT_RANGE_VALUE_SIZE           48      // "bytes=" and two 20-digit decimals.
+
 
 
 #define HTTP_USER_AGENT_EFI_HTTP_BOOT        "UefiHttpBoot/1.0"
@@ -90,6 +99,17 @@ HttpBootCreateHttpIo (
   IN     HTTP_BOOT_PRIVATE_DATA       *Private
   );
 
+/**
+  Destroy the extra HttpIo instances used by the parallel byte-range download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+**/
+VOID
+HttpBootDestroyRangeHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA       *Private
+  );
+
 /**
   This function download the boot file by using UEFI HTTP protocol.
 
@@ -156,6 +156,7 @@ HttpBootDestroyIp4Children (
   }
 
   if (Private->Ip6Nic == NULL && Private->HttpCreated) {
+    HttpBootDestroyRangeHttpIo (Private);
     HttpIoDestroyIo (&Private->HttpIo);
     Private->HttpCreated = FALSE;
   }
@@ -232,6 +233,7 @@ HttpBootDestroyIp6Children (
   }
 
   if (Private->Ip4Nic == NULL && Private->HttpCreated) {
+    HttpBootDestroyRangeHttpIo (Private);
     HttpIoDestroyIo(&Private->HttpIo);
     Private->HttpCreated = FALSE;
   }
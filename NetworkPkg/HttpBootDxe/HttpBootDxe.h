@@ -155,6 +155,12 @@ struct _HTTP_BOOT_PRIVATE_DATA {
   EFI_HANDLE                                Dhcp6Child;
   HTTP_IO                                   HttpIo;
   BOOLEAN                                   HttpCreated;
+  //
+  // Extra HTTP children for the parallel byte-range download. They're kept
+  // with HttpIo until HttpBootStop() so the connections are reused.
+  //
+  HTTP_IO                                   RangeHttpIo[HTTP_BOOT_MAX_RANGE_CONNECTIONS - 1];
+  UINTN                                     RangeHttpIoCount;
 
   //
   // Consumed protocol
@@ -209,6 +215,7 @@ struct _HTTP_BOOT_PRIVATE_DATA {
   CHAR8                                     *BootFileUri;
   VOID                                      *BootFileUriParser;
   UINTN                                     BootFileSize;
+  BOOLEAN                                   AcceptRanges;
   BOOLEAN                                   NoGateway;
   HTTP_BOOT_IMAGE_TYPE                      ImageType;
 
@@ -443,6 +443,7 @@ HttpBootStop (
   }
 
   if (Private->HttpCreated) {
+    HttpBootDestroyRangeHttpIo (Private);
     HttpIoDestroyIo (&Private->HttpIo);
     Private->HttpCreated = FALSE;
   }
@@ -455,6 +456,7 @@ HttpBootStop (
   Private->BootFileUri = NULL;
   Private->BootFileUriParser = NULL;
   Private->BootFileSize = 0;
+  Private->AcceptRanges = FALSE;
   Private->SelectIndex = 0;
   Private->SelectProxyType = HttpOfferTypeMax;
 
@@ -67,6 +67,7 @@ HttpCreateService (
   HttpService->ControllerHandle = Controller;
   HttpService->ChildrenNumber = 0;
   InitializeListHead (&HttpService->ChildrenList);
+  InitializeListHead (&HttpService->TlsSessionList);
 
   *ServiceData = HttpService;
   return EFI_SUCCESS;
@@ -128,6 +129,18 @@ HttpCleanService (
     }
   }
 
+  if (HttpService->Tcp4ChildHandle == NULL && HttpService->Tcp6ChildHandle == NULL) {
+    if (HttpService->TlsHandshakes != 0) {
+      DEBUG ((
+        DEBUG_INFO,
+        "HttpCleanService: %Lu TLS handshakes, %Lu resumed.\n",
+        HttpService->TlsHandshakes,
+        HttpService->TlsResumedHandshakes
+        ));
+    }
+
+    TlsFlushSessionCache (HttpService);
+  }
 }
 
 /**
@@ -26,6 +26,7 @@
 #include <Library/NetLib.h>
 #include <Library/HttpLib.h>
 #include <Library/DpcLib.h>
+#include <Library/PerformanceLib.h>
 
 //
 // UEFI Driver Model Protocols
@@ -47,6 +48,7 @@
 #include <Protocol/Ip6Config.h>
 #include <Protocol/Tls.h>
 #include <Protocol/TlsConfig.h>
+#include <Protocol/EdkiiTlsSessionData.h>
 
 #include <Guid/ImageAuthentication.h>
 //
@@ -835,6 +835,15 @@ HttpCleanProtocol (
   IN  HTTP_PROTOCOL          *HttpInstance
   )
 {
+  if (HttpInstance->UseHttps && HttpInstance->State == HTTP_STATE_TCP_CONNECTED &&
+      HttpInstance->TlsSessionState == EfiTlsSessionDataTransferring) {
+    //
+    // Close the TLS session gracefully, the TLS driver doesn't resume a
+    // session that was torn down without the close notification.
+    //
+    TlsCloseSession (HttpInstance);
+  }
+
   HttpCloseConnection (HttpInstance);
 
   HttpCloseTcpConnCloseEvent (HttpInstance);
@@ -1103,6 +1112,7 @@ HttpConfigureTcp4 (
   Tcp4Option->KeepAliveTime          = HTTP_KEEP_ALIVE_TIME;
   Tcp4Option->KeepAliveInterval      = HTTP_KEEP_ALIVE_INTERVAL;
   Tcp4Option->EnableNagle            = TRUE;
+  Tcp4Option->EnableSelectiveAck     = TRUE;
   Tcp4CfgData->ControlOption         = Tcp4Option;
 
   Status = HttpInstance->Tcp4->Configure (HttpInstance->Tcp4, Tcp4CfgData);
@@ -1174,6 +1184,7 @@ HttpConfigureTcp6 (
   Tcp6Option->KeepAliveTime      = HTTP_KEEP_ALIVE_TIME;
   Tcp6Option->KeepAliveInterval  = HTTP_KEEP_ALIVE_INTERVAL;
   Tcp6Option->EnableNagle        = TRUE;
+  Tcp6Option->EnableSelectiveAck = TRUE;
 
   Status = HttpInstance->Tcp6->Configure (HttpInstance->Tcp6, Tcp6CfgData);
   if (EFI_ERROR (Status)) {
@@ -1276,7 +1287,9 @@ HttpConnectTcp4 (
       return Status;
     }
 
+    PERF_INMODULE_BEGIN ("TlsHandshake");
     Status = TlsConnectSession (HttpInstance, HttpInstance->TimeoutEvent);
+    PERF_INMODULE_END ("TlsHandshake");
 
     gBS->SetTimer (HttpInstance->TimeoutEvent, TimerCancel, 0);
 
@@ -1368,7 +1381,9 @@ HttpConnectTcp6 (
       return Status;
     }
 
+    PERF_INMODULE_BEGIN ("TlsHandshake");
     Status = TlsConnectSession (HttpInstance, HttpInstance->TimeoutEvent);
+    PERF_INMODULE_END ("TlsHandshake");
 
     gBS->SetTimer (HttpInstance->TimeoutEvent, TimerCancel, 0);
 
@@ -50,6 +50,21 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define HTTP_URL_BUFFER_LEN          4096
 
+//
+// Maximum number of TLS sessions cached per HTTP service for resumption.
+//
+#define HTTP_TLS_SESSION_CACHE_MAX   8
+
+//
+// The ID of the last TLS session established with a remote host and port.
+//
+typedef struct {
+  LIST_ENTRY                    Link;
+  CHAR8                         *RemoteHost;
+  UINT16                        RemotePort;
+  EFI_TLS_SESSION_ID            SessionId;
+} HTTP_TLS_SESSION;
+
 typedef struct _HTTP_SERVICE {
   UINT32                        Signature;
   EFI_SERVICE_BINDING_PROTOCOL  ServiceBinding;
@@ -61,6 +76,15 @@ typedef struct _HTTP_SERVICE {
   LIST_ENTRY                    ChildrenList;
   UINTN                         ChildrenNumber;
   INTN                          State;
+
+  //
+  // Cached TLS sessions, most recently used first, and TLS handshake
+  // statistics of all the children.
+  //
+  LIST_ENTRY                    TlsSessionList;
+  UINTN                         TlsSessionCount;
+  UINT64                        TlsHandshakes;
+  UINT64                        TlsResumedHandshakes;
 } HTTP_SERVICE;
 
 typedef struct {
@@ -1107,6 +1107,176 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Find the cached TLS session of the remote host and port of the HTTP instance.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @return  The cached session, or NULL if there is none.
+
+**/
+HTTP_TLS_SESSION *
+TlsFindCachedSession (
+  IN  HTTP_PROTOCOL            *HttpInstance
+  )
+{
+  LIST_ENTRY              *Entry;
+  HTTP_TLS_SESSION        *Session;
+
+  if (HttpInstance->RemoteHost == NULL) {
+    return NULL;
+  }
+
+  NET_LIST_FOR_EACH (Entry, &HttpInstance->Service->TlsSessionList) {
+    Session = NET_LIST_USER_STRUCT (Entry, HTTP_TLS_SESSION, Link);
+    if (Session->RemotePort == HttpInstance->RemotePort &&
+        AsciiStrCmp (Session->RemoteHost, HttpInstance->RemoteHost) == 0) {
+      return Session;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Offer the cached TLS session of the remote host for resumption, before the
+  TLS handshake starts.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+**/
+VOID
+EFIAPI
+TlsOfferCachedSession (
+  IN  HTTP_PROTOCOL            *HttpInstance
+  )
+{
+  EFI_STATUS              Status;
+  HTTP_TLS_SESSION        *Session;
+
+  Session = TlsFindCachedSession (HttpInstance);
+  if (Session == NULL) {
+    return;
+  }
+
+  Status = HttpInstance->Tls->SetSessionData (
+                                HttpInstance->Tls,
+                                EfiTlsSessionID,
+                                &Session->SessionId,
+                                sizeof (EFI_TLS_SESSION_ID)
+                                );
+  if (EFI_ERROR (Status)) {
+    //
+    // The TLS driver doesn't have the session any more.
+    //
+    RemoveEntryList (&Session->Link);
+    HttpInstance->Service->TlsSessionCount--;
+    FreePool (Session->RemoteHost);
+    FreePool (Session);
+  }
+}
+
+/**
+  Cache the ID of the established TLS session for the remote host, so that
+  later connections to the same host and port can resume it.
+
+  @param[in]   HttpInstance       The HTTP instance private data.
+  @param[out]  SessionId          The ID of the established session.
+
+  @retval EFI_SUCCESS            The session ID is cached.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsCacheSession (
+  IN  HTTP_PROTOCOL            *HttpInstance,
+  OUT EFI_TLS_SESSION_ID       *SessionId
+  )
+{
+  EFI_STATUS              Status;
+  HTTP_SERVICE            *Service;
+  HTTP_TLS_SESSION        *Session;
+  UINTN                   SessionIdSize;
+
+  Service = HttpInstance->Service;
+
+  SessionIdSize = sizeof (EFI_TLS_SESSION_ID);
+  Status = HttpInstance->Tls->GetSessionData (
+                                HttpInstance->Tls,
+                                EfiTlsSessionID,
+                                SessionId,
+                                &SessionIdSize
+                                );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (SessionId->Length == 0 || HttpInstance->RemoteHost == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Session = TlsFindCachedSession (HttpInstance);
+  if (Session == NULL) {
+    if (Service->TlsSessionCount < HTTP_TLS_SESSION_CACHE_MAX) {
+      Session = AllocateZeroPool (sizeof (HTTP_TLS_SESSION));
+      if (Session == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+      Service->TlsSessionCount++;
+    } else {
+      //
+      // Reuse the least recently used entry.
+      //
+      Session = NET_LIST_TAIL (&Service->TlsSessionList, HTTP_TLS_SESSION, Link);
+      RemoveEntryList (&Session->Link);
+      FreePool (Session->RemoteHost);
+    }
+
+    Session->RemoteHost = AllocateCopyPool (AsciiStrSize (HttpInstance->RemoteHost), HttpInstance->RemoteHost);
+    if (Session->RemoteHost == NULL) {
+      Service->TlsSessionCount--;
+      FreePool (Session);
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Session->RemotePort = HttpInstance->RemotePort;
+  } else {
+    RemoveEntryList (&Session->Link);
+  }
+
+  CopyMem (&Session->SessionId, SessionId, sizeof (EFI_TLS_SESSION_ID));
+  InsertHeadList (&Service->TlsSessionList, &Session->Link);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Remove all the cached TLS sessions of the HTTP service.
+
+  @param[in]  HttpService        The HTTP service private data.
+
+**/
+VOID
+EFIAPI
+TlsFlushSessionCache (
+  IN  HTTP_SERVICE             *HttpService
+  )
+{
+  LIST_ENTRY              *Entry;
+  LIST_ENTRY              *Next;
+  HTTP_TLS_SESSION        *Session;
+
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, &HttpService->TlsSessionList) {
+    Session = NET_LIST_USER_STRUCT (Entry, HTTP_TLS_SESSION, Link);
+    RemoveEntryList (&Session->Link);
+    FreePool (Session->RemoteHost);
+    FreePool (Session);
+  }
+
+  HttpService->TlsSessionCount = 0;
+}
+
 /**
   Connect one TLS session by finishing the TLS handshake process.
 
@@ -1136,6 +1306,9 @@ TlsConnectSession (
   UINTN                   BufferInSize;
   UINT8                   *GetSessionDataBuffer;
   UINTN                   GetSessionDataBufferSize;
+  EFI_TLS_SESSION_ID      SessionId;
+  BOOLEAN                 Resumed;
+  UINTN                   ResumedSize;
 
   BufferOut    = NULL;
   PacketOut    = NULL;
@@ -1157,6 +1330,11 @@ TlsConnectSession (
     return Status;
   }
 
+  //
+  // Offer the last session with this server for an abbreviated handshake.
+  //
+  TlsOfferCachedSession (HttpInstance);
+
   //
   // Create ClientHello
   //
@@ -1352,8 +1530,36 @@ TlsConnectSession (
 
   if (HttpInstance->TlsSessionState != EfiTlsSessionDataTransferring) {
     Status = EFI_ABORTED;
+    return Status;
   }
 
+  TlsCacheSession (HttpInstance, &SessionId);
+
+  //
+  // Count the handshakes in which the server accepted the offered session.
+  //
+  Resumed     = FALSE;
+  ResumedSize = sizeof (BOOLEAN);
+  HttpInstance->Tls->GetSessionData (
+                       HttpInstance->Tls,
+                       EdkiiTlsSessionReused,
+                       &Resumed,
+                       &ResumedSize
+                       );
+
+  HttpInstance->Service->TlsHandshakes++;
+  if (Resumed) {
+    HttpInstance->Service->TlsResumedHandshakes++;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "TlsConnectSession: %a handshake with %a:%d.\n",
+    Resumed ? "Resumed" : "Full",
+    HttpInstance->RemoteHost,
+    HttpInstance->RemotePort
+    ));
+
   return Status;
 }
 
@@ -1374,13 +1580,15 @@ TlsCloseSession (
   IN  HTTP_PROTOCOL            *HttpInstance
   )
 {
-  EFI_STATUS      Status;
+  EFI_STATUS          Status;
+
+  UINT8               *BufferOut;
+  UINTN               BufferOutSize;
 
-  UINT8           *BufferOut;
-  UINTN           BufferOutSize;
+  NET_BUF             *PacketOut;
+  UINT8               *DataOut;
 
-  NET_BUF         *PacketOut;
-  UINT8           *DataOut;
+  EFI_TLS_SESSION_ID  SessionId;
 
   Status    = EFI_SUCCESS;
   BufferOut = NULL;
@@ -1391,6 +1599,14 @@ TlsCloseSession (
     return EFI_INVALID_PARAMETER;
   }
 
+  //
+  // Update the cached session ID, the server may have issued a new session
+  // ticket after the handshake.
+  //
+  if (HttpInstance->TlsSessionState == EfiTlsSessionDataTransferring) {
+    TlsCacheSession (HttpInstance, &SessionId);
+  }
+
   HttpInstance->TlsSessionState = EfiTlsSessionClosing;
 
   Status = HttpInstance->Tls->SetSessionData (
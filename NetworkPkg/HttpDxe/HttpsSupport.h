@@ -171,6 +171,50 @@ TlsReceiveOnePdu (
   IN     EFI_EVENT          Timeout
   );
 
+/**
+  Offer the cached TLS session of the remote host for resumption, before the
+  TLS handshake starts.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+**/
+VOID
+EFIAPI
+TlsOfferCachedSession (
+  IN  HTTP_PROTOCOL            *HttpInstance
+  );
+
+/**
+  Cache the ID of the established TLS session for the remote host, so that
+  later connections to the same host and port can resume it.
+
+  @param[in]   HttpInstance       The HTTP instance private data.
+  @param[out]  SessionId          The ID of the established session.
+
+  @retval EFI_SUCCESS            The session ID is cached.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsCacheSession (
+  IN  HTTP_PROTOCOL            *HttpInstance,
+  OUT EFI_TLS_SESSION_ID       *SessionId
+  );
+
+/**
+  Remove all the cached TLS sessions of the HTTP service.
+
+  @param[in]  HttpService        The HTTP service private data.
+
+**/
+VOID
+EFIAPI
+TlsFlushSessionCache (
+  IN  HTTP_SERVICE             *HttpService
+  );
+
 /**
   Connect one TLS session by finishing the TLS handshake process.
 
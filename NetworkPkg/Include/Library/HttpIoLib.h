@@ -263,6 +263,61 @@ HttpIoRecvResponse (
   OUT     HTTP_IO_RESPONSE_DATA    *ResponseData
   );
 
+/**
+  Start to receive a HTTP RESPONSE message from the server, without waiting
+  for it. HttpIoPollResponse() must then be called until it doesn't return
+  EFI_NOT_READY, or HttpIoCancelResponse() to give up.
+
+  @param[in]   HttpIo           The HttpIo wrapping the HTTP service.
+  @param[in]   RecvMsgHeader    TRUE to receive a new HTTP response (from message header).
+                                FALSE to continue receive the previous response message.
+  @param[in]   ResponseData     Point to a wrapper of the response data to receive. It
+                                must stay valid until the response is received or canceled.
+
+  @retval EFI_SUCCESS            The receive is started.
+  @retval EFI_INVALID_PARAMETER  One or more parameters are invalid.
+  @retval Others                 Other errors as indicated.
+
+**/
+EFI_STATUS
+HttpIoQueueResponse (
+  IN      HTTP_IO                  *HttpIo,
+  IN      BOOLEAN                  RecvMsgHeader,
+  IN      HTTP_IO_RESPONSE_DATA    *ResponseData
+  );
+
+/**
+  Poll the HTTP service once for the response started by HttpIoQueueResponse(),
+  and complete it if it has been received.
+
+  @param[in]   HttpIo           The HttpIo wrapping the HTTP service.
+  @param[out]  ResponseData     The wrapper passed to HttpIoQueueResponse(), which
+                                receives the response data.
+
+  @retval EFI_SUCCESS            The HTTP response is received.
+  @retval EFI_NOT_READY          The HTTP response is not received yet.
+  @retval EFI_TIMEOUT            The HTTP response wasn't received in time, and
+                                 the receive is canceled.
+  @retval Others                 Other errors as indicated.
+
+**/
+EFI_STATUS
+HttpIoPollResponse (
+  IN      HTTP_IO                  *HttpIo,
+  OUT     HTTP_IO_RESPONSE_DATA    *ResponseData
+  );
+
+/**
+  Cancel the response started by HttpIoQueueResponse().
+
+  @param[in]   HttpIo           The HttpIo wrapping the HTTP service.
+
+**/
+VOID
+HttpIoCancelResponse (
+  IN      HTTP_IO                  *HttpIo
+  );
+
 /**
   Get the value of the content length if there is a "Content-Length" header.
 
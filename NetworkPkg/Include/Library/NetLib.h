@@ -1667,6 +1667,17 @@ typedef struct {
   UINT8               *Bulk;
 } NET_FRAGMENT;
 
+//
+// Counters of the NET_BUF operations that allocate packet memory or copy
+// packet data. Each module linking the library keeps its own counters.
+//
+typedef struct {
+  UINT64              Alloc;      // NET_BUFs allocated with their own data block
+  UINT64              Wrap;       // NET_BUFs built over external or shared data
+  UINT64              Duplicate;  // NET_BUFs duplicated together with their data
+  UINT64              CopyBytes;  // Bytes of packet data copied out of NET_BUFs
+} NET_BUF_STATISTICS;
+
 #define NET_GET_REF(PData)      ((PData)->RefCnt++)
 #define NET_PUT_REF(PData)      ((PData)->RefCnt--)
 #define NETBUF_FROM_PROTODATA(Info) BASE_CR((Info), NET_BUF, ProtoData)
@@ -2117,6 +2128,33 @@ NetbufQueFlush (
   IN OUT NET_BUF_QUEUE          *NbufQue
   );
 
+/**
+  Get the NET_BUF allocation and copy counters of the calling module.
+
+  @param[out]  Statistics            The pointer to the buffer to receive the
+                                     counters.
+
+**/
+VOID
+EFIAPI
+NetbufGetStatistics (
+  OUT NET_BUF_STATISTICS        *Statistics
+  );
+
+/**
+  Print the NET_BUF allocation and copy counters of the calling module
+  to the debug output. Does nothing in release builds.
+
+  @param[in]  Caller                 The name of the calling function, used
+                                     to prefix the message.
+
+**/
+VOID
+EFIAPI
+NetbufDumpStatistics (
+  IN CONST CHAR8                *Caller
+  );
+
 /**
   Compute the checksum for a bulk of data.
 
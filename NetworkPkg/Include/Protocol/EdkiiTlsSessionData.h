@@ -0,0 +1,26 @@
+/** @file
+  EDK II specific session data types of the EFI TLS Protocol.
+
+  TlsDxe accepts these values as the DataType of GetSessionData(), in addition
+  to the ones defined in the UEFI Specification. They are chosen far above
+  EfiTlsSessionDataTypeMaximum, so that new types of the specification do not
+  collide with them.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_TLS_SESSION_DATA_H__
+#define __EDKII_TLS_SESSION_DATA_H__
+
+#include <Protocol/Tls.h>
+
+///
+/// Whether the last handshake resumed the session offered with EfiTlsSessionID,
+/// as a BOOLEAN. It can be read once the session state is not
+/// EfiTlsSessionNotStarted anymore, and can't be set.
+///
+#define EdkiiTlsSessionReused  ((EFI_TLS_SESSION_DATA_TYPE) 0x70000000)
+
+#endif
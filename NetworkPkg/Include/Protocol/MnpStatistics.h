@@ -0,0 +1,102 @@
+/** @file
+  EDK II Managed Network Statistics Protocol.
+
+  MnpDxe installs this protocol on every controller it manages, next to the
+  Managed Network Service Binding Protocol, to report the frames it exchanged
+  with the Simple Network Protocol instance of the controller.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_MNP_STATISTICS_H__
+#define __EDKII_MNP_STATISTICS_H__
+
+//
+// Managed Network Statistics Protocol GUID value
+//
+#define EDKII_MNP_STATISTICS_PROTOCOL_GUID \
+    { \
+      0xff4fa9cb, 0xc99f, 0x4c39, { 0x8e, 0xe7, 0xfe, 0x64, 0x64, 0xfb, 0xc9, 0x14 } \
+    }
+
+//
+// Forward reference for pure ANSI compatibility
+//
+typedef struct _EDKII_MNP_STATISTICS_PROTOCOL  EDKII_MNP_STATISTICS_PROTOCOL;
+
+///
+/// The counters of a network interface. New counters are only appended, so
+/// that the StatisticsSize passed to GetStatistics() tells which of them the
+/// caller knows of.
+///
+typedef struct {
+  ///
+  /// Frames received from the Simple Network Protocol instance.
+  ///
+  UINT64  RxPackets;
+  ///
+  /// Received frames that no MNP child took, or that were evicted from the
+  /// receive queue of a child by overflow or timeout.
+  ///
+  UINT64  RxDropped;
+  ///
+  /// Frames handed to the Simple Network Protocol instance.
+  ///
+  UINT64  TxPackets;
+  ///
+  /// Frames not sent because of missing media or transmit errors.
+  ///
+  UINT64  TxDropped;
+} EDKII_MNP_STATISTICS;
+
+/**
+  Resets or collects the statistics of the Managed Network driver on a
+  network interface.
+
+  @param  This                  A pointer to the EDKII_MNP_STATISTICS_PROTOCOL
+                                instance.
+  @param  Reset                 Set to TRUE to reset the statistics, after they
+                                are collected.
+  @param  StatisticsSize        On input the size, in bytes, of
+                                StatisticsTable. On output the size, in bytes,
+                                of the resulting table of statistics. May be
+                                NULL if Reset is TRUE.
+  @param  StatisticsTable       A pointer to the EDKII_MNP_STATISTICS structure
+                                that receives the statistics.
+
+  @retval EFI_SUCCESS           The statistics were collected or reset.
+  @retval EFI_BUFFER_TOO_SMALL  StatisticsSize is not big enough. Only the
+                                first StatisticsSize bytes of the statistics
+                                were returned, and the size needed is returned
+                                in StatisticsSize.
+  @retval EFI_INVALID_PARAMETER This is NULL, StatisticsSize is NULL and Reset
+                                is FALSE, or StatisticsSize is not NULL and
+                                StatisticsTable is NULL.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MNP_GET_STATISTICS)(
+  IN     EDKII_MNP_STATISTICS_PROTOCOL  *This,
+  IN     BOOLEAN                        Reset,
+  IN OUT UINTN                          *StatisticsSize   OPTIONAL,
+  OUT    EDKII_MNP_STATISTICS           *StatisticsTable  OPTIONAL
+  );
+
+///
+/// The EDKII_MNP_STATISTICS_PROTOCOL reports the packet counters of the
+/// Managed Network driver, which the Simple Network Protocol statistics
+/// don't cover when the network driver doesn't implement them.
+///
+struct _EDKII_MNP_STATISTICS_PROTOCOL {
+  EDKII_MNP_GET_STATISTICS  GetStatistics;
+};
+
+///
+/// Managed Network Statistics Protocol GUID variable.
+///
+extern EFI_GUID gEdkiiMnpStatisticsProtocolGuid;
+
+#endif
@@ -410,6 +410,8 @@ Ip4CleanService (
 
   IpSb->State     = IP4_SERVICE_DESTROY;
 
+  NetbufDumpStatistics ("Ip4CleanService");
+
   if (IpSb->Timer != NULL) {
     gBS->SetTimer (IpSb->Timer, TimerCancel, 0);
     gBS->CloseEvent (IpSb->Timer);
@@ -367,6 +367,46 @@ HttpIoRecvResponse (
   )
 {
   EFI_STATUS                 Status;
+
+  Status = HttpIoQueueResponse (HttpIo, RecvMsgHeader, ResponseData);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Poll the network until receive finish.
+  //
+  do {
+    Status = HttpIoPollResponse (HttpIo, ResponseData);
+  } while (Status == EFI_NOT_READY);
+
+  return Status;
+}
+
+/**
+  Start to receive a HTTP RESPONSE message from the server, without waiting
+  for it. HttpIoPollResponse() must then be called until it doesn't return
+  EFI_NOT_READY, or HttpIoCancelResponse() to give up.
+
+  @param[in]   HttpIo           The HttpIo wrapping the HTTP service.
+  @param[in]   RecvMsgHeader    TRUE to receive a new HTTP response (from message header).
+                                FALSE to continue receive the previous response message.
+  @param[in]   ResponseData     Point to a wrapper of the response data to receive. It
+                                must stay valid until the response is received or canceled.
+
+  @retval EFI_SUCCESS            The receive is started.
+  @retval EFI_INVALID_PARAMETER  One or more parameters are invalid.
+  @retval Others                 Other errors as indicated.
+
+**/
+EFI_STATUS
+HttpIoQueueResponse (
+  IN      HTTP_IO                  *HttpIo,
+  IN      BOOLEAN                  RecvMsgHeader,
+  IN      HTTP_IO_RESPONSE_DATA    *ResponseData
+  )
+{
+  EFI_STATUS                 Status;
   EFI_HTTP_PROTOCOL          *Http;
 
   if (HttpIo == NULL || HttpIo->Http == NULL || ResponseData == NULL) {
@@ -411,31 +451,58 @@ HttpIoRecvResponse (
     return Status;
   }
 
-  //
-  // Poll the network until receive finish.
-  //
-  while (!HttpIo->IsRxDone && EFI_ERROR (gBS->CheckEvent (HttpIo->TimeoutEvent))) {
-    Http->Poll (Http);
+  return EFI_SUCCESS;
+}
+
+/**
+  Poll the HTTP service once for the response started by HttpIoQueueResponse(),
+  and complete it if it has been received.
+
+  @param[in]   HttpIo           The HttpIo wrapping the HTTP service.
+  @param[out]  ResponseData     The wrapper passed to HttpIoQueueResponse(), which
+                                receives the response data.
+
+  @retval EFI_SUCCESS            The HTTP response is received.
+  @retval EFI_NOT_READY          The HTTP response is not received yet.
+  @retval EFI_TIMEOUT            The HTTP response wasn't received in time, and
+                                 the receive is canceled.
+  @retval Others                 Other errors as indicated.
+
+**/
+EFI_STATUS
+HttpIoPollResponse (
+  IN      HTTP_IO                  *HttpIo,
+  OUT     HTTP_IO_RESPONSE_DATA    *ResponseData
+  )
+{
+  EFI_STATUS                 Status;
+
+  if (HttpIo == NULL || HttpIo->Http == NULL || ResponseData == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (!HttpIo->IsRxDone) {
+    if (EFI_ERROR (gBS->CheckEvent (HttpIo->TimeoutEvent))) {
+      HttpIo->Http->Poll (HttpIo->Http);
+      if (!HttpIo->IsRxDone) {
+        return EFI_NOT_READY;
+      }
+    } else {
+      //
+      // Timeout occurs, cancel the response token.
+      //
+      HttpIoCancelResponse (HttpIo);
+      return EFI_TIMEOUT;
+    }
   }
 
   //
   // Remove timeout timer from the event list.
   //
   gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+  HttpIo->IsRxDone = FALSE;
 
-  if (!HttpIo->IsRxDone) {
-    //
-    // Timeout occurs, cancel the response token.
-    //
-    Http->Cancel (Http, &HttpIo->RspToken);
-
-    Status = EFI_TIMEOUT;
-
-    return Status;
-  } else {
-    HttpIo->IsRxDone = FALSE;
-  }
-
+  Status = EFI_SUCCESS;
   if ((HttpIo->Callback != NULL) &&
       (HttpIo->RspToken.Status == EFI_SUCCESS || HttpIo->RspToken.Status == EFI_HTTP_ERROR)) {
     Status = HttpIo->Callback (
@@ -459,6 +526,26 @@ HttpIoRecvResponse (
   return Status;
 }
 
+/**
+  Cancel the response started by HttpIoQueueResponse().
+
+  @param[in]   HttpIo           The HttpIo wrapping the HTTP service.
+
+**/
+VOID
+HttpIoCancelResponse (
+  IN      HTTP_IO                  *HttpIo
+  )
+{
+  if (HttpIo == NULL || HttpIo->Http == NULL) {
+    return;
+  }
+
+  gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+  HttpIo->Http->Cancel (HttpIo->Http, &HttpIo->RspToken);
+  HttpIo->IsRxDone = FALSE;
+}
+
 /**
   Get the value of the content length if there is a "Content-Length" header.
 
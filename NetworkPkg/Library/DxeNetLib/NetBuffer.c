@@ -14,6 +14,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/MemoryAllocationLib.h>
 
+GLOBAL_REMOVE_IF_UNREFERENCED NET_BUF_STATISTICS  mNetbufStatistics;
+
 
 /**
   Allocate and build up the sketch for a NET_BUF.
@@ -123,6 +125,7 @@ NetbufAlloc (
   Nbuf->BlockOp[0].Tail       = Bulk;
   Nbuf->BlockOp[0].Size       = 0;
 
+  mNetbufStatistics.Alloc++;
   return Nbuf;
 
 FreeNBuf:
@@ -261,6 +264,7 @@ NetbufClone (
   Clone->TotalSize  = Nbuf->TotalSize;
   CopyMem (Clone->BlockOp, Nbuf->BlockOp, sizeof (NET_BLOCK_OP) * Nbuf->BlockOpNum);
 
+  mNetbufStatistics.Wrap++;
   return Clone;
 }
 
@@ -311,6 +315,7 @@ NetbufDuplicate (
   Dst = NetbufAllocSpace (Duplicate, Nbuf->TotalSize, NET_BUF_TAIL);
   NetbufCopy (Nbuf, 0, Nbuf->TotalSize, Dst);
 
+  mNetbufStatistics.Duplicate++;
   return Duplicate;
 }
 
@@ -675,6 +680,8 @@ NetbufGetFragment (
   }
 
   CopyMem (Child->ProtoData, Nbuf->ProtoData, NET_PROTO_DATA);
+
+  mNetbufStatistics.Wrap++;
   return Child;
 
 FreeChild:
@@ -858,6 +865,8 @@ NetbufFromExt (
     ExtFragment[SavedIndex] = SavedFragment;
   }
 
+  mNetbufStatistics.Wrap++;
+  mNetbufStatistics.CopyBytes += Copied;
   return Nbuf;
 
 FreeFirstBlock:
@@ -1288,6 +1297,7 @@ NetbufCopy (
 
   if (Len <= Left) {
     CopyMem (Dest, BlockOp[Index].Head + Skip, Len);
+    mNetbufStatistics.CopyBytes += Len;
     return Len;
   }
 
@@ -1313,6 +1323,7 @@ NetbufCopy (
     }
   }
 
+  mNetbufStatistics.CopyBytes += Copied;
   return Copied;
 }
 
@@ -1639,6 +1650,53 @@ NetbufQueFlush (
 }
 
 
+/**
+  Get the NET_BUF allocation and copy counters of the calling module.
+
+  @param[out]  Statistics            Pointer to the buffer to receive the
+                                     counters.
+
+**/
+VOID
+EFIAPI
+NetbufGetStatistics (
+  OUT NET_BUF_STATISTICS        *Statistics
+  )
+{
+  ASSERT (Statistics != NULL);
+
+  CopyMem (Statistics, &mNetbufStatistics, sizeof (NET_BUF_STATISTICS));
+}
+
+
+/**
+  Print the NET_BUF allocation and copy counters of the calling module
+  to the debug output. Does nothing in release builds.
+
+  @param[in]  Caller                 The name of the calling function, used
+                                     to prefix the message.
+
+**/
+VOID
+EFIAPI
+NetbufDumpStatistics (
+  IN CONST CHAR8                *Caller
+  )
+{
+  DEBUG_CODE (
+    DEBUG ((
+      EFI_D_INFO,
+      "%a: NET_BUF %Lu allocated, %Lu wrapped, %Lu duplicated, %Lu bytes copied.\n",
+      Caller,
+      mNetbufStatistics.Alloc,
+      mNetbufStatistics.Wrap,
+      mNetbufStatistics.Duplicate,
+      mNetbufStatistics.CopyBytes
+      ));
+  );
+}
+
+
 /**
   Compute the checksum for a bulk of data.
 
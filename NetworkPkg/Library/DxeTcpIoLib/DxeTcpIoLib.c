@@ -218,7 +218,7 @@ TcpIoCreateSocket (
   ControlOption.EnableNagle             = FALSE;
   ControlOption.EnableTimeStamp         = FALSE;
   ControlOption.EnableWindowScaling     = TRUE;
-  ControlOption.EnableSelectiveAck      = FALSE;
+  ControlOption.EnableSelectiveAck      = TRUE;
   ControlOption.EnablePathMtuDiscovery  = FALSE;
 
   if (TcpVersion == TCP_VERSION_4) {
@@ -436,6 +436,7 @@ MnpInitializeDeviceData (
   // Copy the MNP Protocol interfaces from the template.
   //
   CopyMem (&MnpDeviceData->VlanConfig, &mVlanConfigProtocolTemplate, sizeof (EFI_VLAN_CONFIG_PROTOCOL));
+  MnpDeviceData->Statistics.GetStatistics = MnpGetStatistics;
 
   //
   // Open the Simple Network protocol.
@@ -513,6 +514,9 @@ MnpInitializeDeviceData (
   InitializeListHead (&MnpDeviceData->AllTxBufList);
   MnpDeviceData->TxBufCount = 0;
 
+  InitializeListHead (&MnpDeviceData->FreeRxDataWrapList);
+  MnpDeviceData->FreeRxDataWrapCount = 0;
+
   //
   // Create the system poll timer.
   //
@@ -621,6 +625,7 @@ MnpDestroyDeviceData (
   LIST_ENTRY         *Entry;
   LIST_ENTRY         *NextEntry;
   MNP_TX_BUF_WRAP    *TxBufWrap;
+  MNP_RXDATA_WRAP    *RxDataWrap;
 
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
@@ -655,6 +660,18 @@ MnpDestroyDeviceData (
   ASSERT (IsListEmpty (&MnpDeviceData->AllTxBufList));
   ASSERT (MnpDeviceData->TxBufCount == 0);
 
+  //
+  // Free the recycled RxDataWraps.
+  //
+  NET_LIST_FOR_EACH_SAFE (Entry, NextEntry, &MnpDeviceData->FreeRxDataWrapList) {
+    RxDataWrap = NET_LIST_USER_STRUCT (Entry, MNP_RXDATA_WRAP, WrapEntry);
+    RemoveEntryList (Entry);
+    gBS->CloseEvent (RxDataWrap->RxData.RecycleEvent);
+    FreePool (RxDataWrap);
+    MnpDeviceData->FreeRxDataWrapCount--;
+  }
+  ASSERT (MnpDeviceData->FreeRxDataWrapCount == 0);
+
   //
   // Free the RxNbufCache.
   //
@@ -1272,6 +1289,8 @@ MnpStart (
     //
     TimerOpType = EnableSystemPoll ? TimerPeriodic : TimerCancel;
 
+    MnpDeviceData->PollInterval  = MNP_SYS_POLL_INTERVAL;
+    MnpDeviceData->PollIdleCount = 0;
     Status      = gBS->SetTimer (MnpDeviceData->PollTimer, TimerOpType, MNP_SYS_POLL_INTERVAL);
     if (EFI_ERROR (Status)) {
       DEBUG ((EFI_D_ERROR, "MnpStart: gBS->SetTimer for PollTimer failed, %r.\n", Status));
@@ -1306,8 +1325,8 @@ MnpStop (
   IN OUT MNP_SERVICE_DATA    *MnpServiceData
   )
 {
-  EFI_STATUS      Status;
-  MNP_DEVICE_DATA *MnpDeviceData;
+  EFI_STATUS         Status;
+  MNP_DEVICE_DATA    *MnpDeviceData;
 
   NET_CHECK_SIGNATURE (MnpServiceData, MNP_SERVICE_DATA_SIGNATURE);
   MnpDeviceData = MnpServiceData->MnpDeviceData;
@@ -1352,6 +1371,18 @@ MnpStop (
   //
   Status = gBS->SetTimer (MnpDeviceData->MediaDetectTimer, TimerCancel, 0);
 
+  DEBUG ((
+    EFI_D_INFO,
+    "MnpStop: %s RX %Lu packets, %Lu dropped; TX %Lu packets, %Lu dropped.\n",
+    MnpDeviceData->MacString,
+    MnpDeviceData->RxPackets,
+    MnpDeviceData->RxDropped,
+    MnpDeviceData->TxPackets,
+    MnpDeviceData->TxDropped
+    ));
+
+  NetbufDumpStatistics ("MnpStop");
+
   //
   // Stop the simple network.
   //
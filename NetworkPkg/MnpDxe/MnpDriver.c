@@ -177,6 +177,21 @@ MnpDriverBindingStart (
     return Status;
   }
 
+  //
+  // Install the MNP Statistics Protocol
+  //
+  Status = gBS->InstallMultipleProtocolInterfaces (
+                  &ControllerHandle,
+                  &gEdkiiMnpStatisticsProtocolGuid,
+                  &MnpDeviceData->Statistics,
+                  NULL
+                  );
+  if (EFI_ERROR (Status)) {
+    MnpDestroyDeviceData (MnpDeviceData, This->DriverBindingHandle);
+    FreePool (MnpDeviceData);
+    return Status;
+  }
+
   //
   // Check whether NIC driver has already produced VlanConfig protocol
   //
@@ -273,6 +288,16 @@ Exit:
              );
     }
 
+    //
+    // Uninstall the MNP Statistics Protocol
+    //
+    gBS->UninstallMultipleProtocolInterfaces (
+           MnpDeviceData->ControllerHandle,
+           &gEdkiiMnpStatisticsProtocolGuid,
+           &MnpDeviceData->Statistics,
+           NULL
+           );
+
     //
     // Destroy Mnp Device Data
     //
@@ -379,6 +404,16 @@ MnpDriverBindingStop (
              );
     }
 
+    //
+    // Uninstall the MNP Statistics Protocol
+    //
+    gBS->UninstallMultipleProtocolInterfaces (
+           MnpDeviceData->ControllerHandle,
+           &gEdkiiMnpStatisticsProtocolGuid,
+           &MnpDeviceData->Statistics,
+           NULL
+           );
+
     //
     // Destroy Mnp Device Data
     //
@@ -15,6 +15,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/SimpleNetwork.h>
 #include <Protocol/ServiceBinding.h>
 #include <Protocol/VlanConfig.h>
+#include <Protocol/MnpStatistics.h>
 
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -44,6 +45,7 @@ typedef struct {
   EFI_HANDLE                    ImageHandle;
 
   EFI_VLAN_CONFIG_PROTOCOL      VlanConfig;
+  EDKII_MNP_STATISTICS_PROTOCOL Statistics;
   UINTN                         NumberOfVlan;
   CHAR16                        *MacString;
   EFI_SIMPLE_NETWORK_PROTOCOL   *Snp;
@@ -64,11 +66,24 @@ typedef struct {
   LIST_ENTRY                    AllTxBufList;
   UINT32                        TxBufCount;
 
+  //
+  // Recycled MNP_RXDATA_WRAPs kept with their recycle events, so that a
+  // received packet doesn't cost a pool allocation and an event creation.
+  //
+  LIST_ENTRY                    FreeRxDataWrapList;
+  UINT32                        FreeRxDataWrapCount;
+
   NET_BUF_QUEUE                 FreeNbufQue;
   INTN                          NbufCnt;
 
   EFI_EVENT                     PollTimer;
   BOOLEAN                       EnableSystemPoll;
+  //
+  // Current period of the PollTimer, adapted to the receive load, and
+  // the number of consecutive system polls that found no packet.
+  //
+  UINT64                        PollInterval;
+  UINT32                        PollIdleCount;
 
   EFI_EVENT                     TimeoutCheckTimer;
   EFI_EVENT                     MediaDetectTimer;
@@ -85,6 +100,18 @@ typedef struct {
   UINT32                        BufferLength;
   UINT32                        PaddingSize;
   NET_BUF                       *RxNbufCache;
+
+  //
+  // Per interface packet counters. RxDropped counts the frames received
+  // from Snp that no instance took, plus those evicted from an instance's
+  // receive queue by overflow or timeout. TxDropped counts the frames not
+  // handed to Snp because of missing media or transmit errors. They are
+  // reported through the Statistics protocol.
+  //
+  UINT64                        RxPackets;
+  UINT64                        RxDropped;
+  UINT64                        TxPackets;
+  UINT64                        TxDropped;
 } MNP_DEVICE_DATA;
 
 #define MNP_DEVICE_DATA_FROM_THIS(a) \
@@ -95,6 +122,14 @@ typedef struct {
   MNP_DEVICE_DATA_SIGNATURE \
   )
 
+#define MNP_DEVICE_DATA_FROM_STATISTICS(a) \
+  CR ( \
+  (a), \
+  MNP_DEVICE_DATA, \
+  Statistics, \
+  MNP_DEVICE_DATA_SIGNATURE \
+  )
+
 #define MNP_SERVICE_DATA_SIGNATURE  SIGNATURE_32 ('M', 'n', 'p', 'S')
 
 typedef struct {
@@ -14,6 +14,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define NET_ETHER_FCS_SIZE            4
 
 #define MNP_SYS_POLL_INTERVAL         (10 * TICKS_PER_MS)   // 10 milliseconds
+#define MNP_SYS_POLL_INTERVAL_MIN     (1 * TICKS_PER_MS)    // 1 millisecond
+#define MNP_SYS_POLL_BATCH            32    // Max packets drained from Snp per system poll.
+#define MNP_SYS_POLL_IDLE_COUNT       4     // Idle polls before the poll interval is doubled.
 #define MNP_TIMEOUT_CHECK_INTERVAL    (50 * TICKS_PER_MS)   // 50 milliseconds
 #define MNP_MEDIA_DETECT_INTERVAL     (500 * TICKS_PER_MS)  // 500 milliseconds
 #define MNP_TX_TIMEOUT_TIME           (500 * TICKS_PER_MS)  // 500 milliseconds
@@ -24,6 +27,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define MNP_MAX_TX_BUFFER_NUM         65536
 
 #define MNP_MAX_RCVD_PACKET_QUE_SIZE  256
+#define MNP_MAX_FREE_RX_DATA_WRAP     64
 
 #define MNP_RECEIVE_UNICAST           0x01
 #define MNP_RECEIVE_BROADCAST         0x02
@@ -879,6 +883,34 @@ MnpPoll (
   IN EFI_MANAGED_NETWORK_PROTOCOL    *This
   );
 
+/**
+  Resets or collects the packet counters of the network interface.
+
+  @param[in]       This             Pointer to the EDKII_MNP_STATISTICS_PROTOCOL
+                                    instance.
+  @param[in]       Reset            Set to TRUE to reset the counters, after
+                                    they are collected.
+  @param[in, out]  StatisticsSize   On input the size, in bytes, of
+                                    StatisticsTable. On output the size, in
+                                    bytes, of the counters.
+  @param[out]      StatisticsTable  Pointer to the buffer to receive the
+                                    counters.
+
+  @retval EFI_SUCCESS               The counters were collected or reset.
+  @retval EFI_BUFFER_TOO_SMALL      StatisticsSize is not big enough, only
+                                    part of the counters were returned.
+  @retval EFI_INVALID_PARAMETER     One or more parameters are invalid.
+
+**/
+EFI_STATUS
+EFIAPI
+MnpGetStatistics (
+  IN     EDKII_MNP_STATISTICS_PROTOCOL  *This,
+  IN     BOOLEAN                        Reset,
+  IN OUT UINTN                          *StatisticsSize   OPTIONAL,
+  OUT    EDKII_MNP_STATISTICS           *StatisticsTable  OPTIONAL
+  );
+
 /**
   Configure the Snp receive filters according to the instances' receive filter
   settings.
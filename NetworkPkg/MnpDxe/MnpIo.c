@@ -235,6 +235,7 @@ MnpSyncSendPacket (
     //
     DEBUG ((EFI_D_WARN, "MnpSyncSendPacket: No network cable detected.\n"));
     Token->Status = EFI_NO_MEDIA;
+    MnpDeviceData->TxDropped++;
     goto SIGNAL_TOKEN;
   }
 
@@ -264,6 +265,7 @@ MnpSyncSendPacket (
     Status = MnpRecycleTxBuf (MnpDeviceData);
     if (EFI_ERROR (Status)) {
       Token->Status = EFI_DEVICE_ERROR;
+      MnpDeviceData->TxDropped++;
       goto SIGNAL_TOKEN;
     }
 
@@ -280,6 +282,9 @@ MnpSyncSendPacket (
 
   if (EFI_ERROR (Status)) {
     Token->Status = EFI_DEVICE_ERROR;
+    MnpDeviceData->TxDropped++;
+  } else {
+    MnpDeviceData->TxPackets++;
   }
 
 SIGNAL_TOKEN:
@@ -434,6 +439,7 @@ MnpRecycleRxData (
 {
   MNP_RXDATA_WRAP *RxDataWrap;
   MNP_DEVICE_DATA *MnpDeviceData;
+  EFI_TPL         OldTpl;
 
   ASSERT (Context != NULL);
 
@@ -452,16 +458,29 @@ MnpRecycleRxData (
   RxDataWrap->Nbuf = NULL;
 
   //
-  // Close the recycle event.
+  // Remove this Wrap entry from the list.
   //
-  gBS->CloseEvent (RxDataWrap->RxData.RecycleEvent);
+  RemoveEntryList (&RxDataWrap->WrapEntry);
 
   //
-  // Remove this Wrap entry from the list.
+  // Keep the Wrap and its recycle event for the next received packet.
   //
-  RemoveEntryList (&RxDataWrap->WrapEntry);
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (MnpDeviceData->FreeRxDataWrapCount < MNP_MAX_FREE_RX_DATA_WRAP) {
+    InsertTailList (&MnpDeviceData->FreeRxDataWrapList, &RxDataWrap->WrapEntry);
+    MnpDeviceData->FreeRxDataWrapCount++;
+    RxDataWrap = NULL;
+  }
+  gBS->RestoreTPL (OldTpl);
+
+  if (RxDataWrap != NULL) {
+    //
+    // Close the recycle event.
+    //
+    gBS->CloseEvent (RxDataWrap->RxData.RecycleEvent);
 
-  FreePool (RxDataWrap);
+    FreePool (RxDataWrap);
+  }
 }
 
 
@@ -504,6 +523,7 @@ MnpQueueRcvdPacket (
     //
     MnpRecycleRxData (NULL, (VOID *) OldRxDataWrap);
     Instance->RcvdPacketQueueSize--;
+    Instance->MnpServiceData->MnpDeviceData->RxDropped++;
   }
 
   //
@@ -717,7 +737,34 @@ MnpWrapRxData (
   )
 {
   EFI_STATUS      Status;
+  MNP_DEVICE_DATA *MnpDeviceData;
   MNP_RXDATA_WRAP *RxDataWrap;
+  EFI_EVENT       RecycleEvent;
+  EFI_TPL         OldTpl;
+
+  //
+  // Reuse a recycled Wrap if any, its recycle event is kept.
+  //
+  MnpDeviceData = Instance->MnpServiceData->MnpDeviceData;
+  RxDataWrap    = NULL;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (!IsListEmpty (&MnpDeviceData->FreeRxDataWrapList)) {
+    RxDataWrap = NET_LIST_HEAD (&MnpDeviceData->FreeRxDataWrapList, MNP_RXDATA_WRAP, WrapEntry);
+    RemoveEntryList (&RxDataWrap->WrapEntry);
+    MnpDeviceData->FreeRxDataWrapCount--;
+  }
+  gBS->RestoreTPL (OldTpl);
+
+  if (RxDataWrap != NULL) {
+    RxDataWrap->Instance = Instance;
+
+    RecycleEvent = RxDataWrap->RxData.RecycleEvent;
+    CopyMem (&RxDataWrap->RxData, RxData, sizeof (RxDataWrap->RxData));
+    RxDataWrap->RxData.RecycleEvent = RecycleEvent;
+
+    return RxDataWrap;
+  }
 
   //
   // Allocate memory.
@@ -907,6 +954,8 @@ MnpReceivePacket (
     return Status;
   }
 
+  MnpDeviceData->RxPackets++;
+
   //
   // Sanity check.
   //
@@ -917,6 +966,7 @@ MnpReceivePacket (
       HeaderSize,
       BufLen)
       );
+    MnpDeviceData->RxDropped++;
     return EFI_DEVICE_ERROR;
   }
 
@@ -952,6 +1002,7 @@ MnpReceivePacket (
       NetbufAllocSpace (Nbuf, NET_VLAN_TAG_LEN, NET_BUF_HEAD);
     }
 
+    MnpDeviceData->RxDropped++;
     goto EXIT;
   }
 
@@ -986,6 +1037,7 @@ MnpReceivePacket (
       NetbufAllocSpace (Nbuf, NET_VLAN_TAG_LEN, NET_BUF_HEAD);
     }
 
+    MnpDeviceData->RxDropped++;
     goto EXIT;
   }
   //
@@ -1062,6 +1114,7 @@ MnpCheckPacketTimeout (
           DEBUG ((EFI_D_WARN, "MnpCheckPacketTimeout: Received packet timeout.\n"));
           MnpRecycleRxData (NULL, RxDataWrap);
           Instance->RcvdPacketQueueSize--;
+          MnpDeviceData->RxDropped++;
         }
       }
 
@@ -1105,6 +1158,11 @@ MnpCheckMediaStatus (
   Poll to receive the packets from Snp. This function is either called by upperlayer
   protocols/applications or the system poll timer notify mechanism.
 
+  Up to MNP_SYS_POLL_BATCH packets are drained from Snp per call. The period of
+  the poll timer is halved down to MNP_SYS_POLL_INTERVAL_MIN while packets keep
+  arriving, and doubled back up to MNP_SYS_POLL_INTERVAL once MNP_SYS_POLL_IDLE_COUNT
+  consecutive polls found the interface idle.
+
   @param[in]  Event        The event this notify function registered to.
   @param[in]  Context      Pointer to the context data registered to the event.
 
@@ -1117,17 +1175,52 @@ MnpSystemPoll (
   )
 {
   MNP_DEVICE_DATA  *MnpDeviceData;
+  UINT64           RxPackets;
+  UINT64           Received;
+  UINT64           Interval;
 
   MnpDeviceData = (MNP_DEVICE_DATA *) Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
   //
-  // Try to receive packets from Snp.
+  // Try to receive packets from Snp until it runs dry or the batch is full.
   //
-  MnpReceivePacket (MnpDeviceData);
+  RxPackets = MnpDeviceData->RxPackets;
+  do {
+    if (EFI_ERROR (MnpReceivePacket (MnpDeviceData))) {
+      break;
+    }
+
+    //
+    // Dispatch the DPC queued by the NotifyFunction of rx token's events, so
+    // that the receivers can renew their rx tokens before the next packet.
+    //
+    DispatchDpc ();
+  } while (MnpDeviceData->RxPackets - RxPackets < MNP_SYS_POLL_BATCH);
+
+  if (!MnpDeviceData->EnableSystemPoll) {
+    return;
+  }
 
   //
-  // Dispatch the DPC queued by the NotifyFunction of rx token's events.
+  // Adapt the poll interval to the receive load.
   //
-  DispatchDpc ();
+  Received = MnpDeviceData->RxPackets - RxPackets;
+  Interval = MnpDeviceData->PollInterval;
+  if (Received >= MNP_SYS_POLL_BATCH) {
+    MnpDeviceData->PollIdleCount = 0;
+    Interval                     = MNP_SYS_POLL_INTERVAL_MIN;
+  } else if (Received != 0) {
+    MnpDeviceData->PollIdleCount = 0;
+    Interval                     = MAX (Interval / 2, MNP_SYS_POLL_INTERVAL_MIN);
+  } else if (++MnpDeviceData->PollIdleCount >= MNP_SYS_POLL_IDLE_COUNT) {
+    MnpDeviceData->PollIdleCount = 0;
+    Interval                     = MIN (Interval * 2, MNP_SYS_POLL_INTERVAL);
+  }
+
+  if (Interval != MnpDeviceData->PollInterval) {
+    if (!EFI_ERROR (gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, Interval))) {
+      MnpDeviceData->PollInterval = Interval;
+    }
+  }
 }
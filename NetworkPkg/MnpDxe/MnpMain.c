@@ -787,3 +787,80 @@ ON_EXIT:
 
   return Status;
 }
+
+/**
+  Resets or collects the packet counters of the network interface.
+
+  @param[in]       This             Pointer to the EDKII_MNP_STATISTICS_PROTOCOL
+                                    instance.
+  @param[in]       Reset            Set to TRUE to reset the counters, after
+                                    they are collected.
+  @param[in, out]  StatisticsSize   On input the size, in bytes, of
+                                    StatisticsTable. On output the size, in
+                                    bytes, of the counters.
+  @param[out]      StatisticsTable  Pointer to the buffer to receive the
+                                    counters.
+
+  @retval EFI_SUCCESS               The counters were collected or reset.
+  @retval EFI_BUFFER_TOO_SMALL      StatisticsSize is not big enough, only
+                                    part of the counters were returned.
+  @retval EFI_INVALID_PARAMETER     One or more parameters are invalid.
+
+**/
+EFI_STATUS
+EFIAPI
+MnpGetStatistics (
+  IN     EDKII_MNP_STATISTICS_PROTOCOL  *This,
+  IN     BOOLEAN                        Reset,
+  IN OUT UINTN                          *StatisticsSize   OPTIONAL,
+  OUT    EDKII_MNP_STATISTICS           *StatisticsTable  OPTIONAL
+  )
+{
+  EFI_STATUS            Status;
+  MNP_DEVICE_DATA       *MnpDeviceData;
+  EDKII_MNP_STATISTICS  Statistics;
+  EFI_TPL               OldTpl;
+
+  if ((This == NULL) ||
+      ((StatisticsSize == NULL) && !Reset) ||
+      ((StatisticsSize != NULL) && (StatisticsTable == NULL))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  MnpDeviceData = MNP_DEVICE_DATA_FROM_STATISTICS (This);
+
+  //
+  // The counters are updated at TPL_CALLBACK, by the system poll and by
+  // the MNP children.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  Statistics.RxPackets = MnpDeviceData->RxPackets;
+  Statistics.RxDropped = MnpDeviceData->RxDropped;
+  Statistics.TxPackets = MnpDeviceData->TxPackets;
+  Statistics.TxDropped = MnpDeviceData->TxDropped;
+
+  if (Reset) {
+    MnpDeviceData->RxPackets = 0;
+    MnpDeviceData->RxDropped = 0;
+    MnpDeviceData->TxPackets = 0;
+    MnpDeviceData->TxDropped = 0;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  Status = EFI_SUCCESS;
+
+  if (StatisticsSize != NULL) {
+    if (*StatisticsSize < sizeof (EDKII_MNP_STATISTICS)) {
+      CopyMem (StatisticsTable, &Statistics, *StatisticsSize);
+      Status = EFI_BUFFER_TOO_SMALL;
+    } else {
+      CopyMem (StatisticsTable, &Statistics, sizeof (EDKII_MNP_STATISTICS));
+    }
+
+    *StatisticsSize = sizeof (EDKII_MNP_STATISTICS);
+  }
+
+  return Status;
+}
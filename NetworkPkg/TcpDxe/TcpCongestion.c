@@ -0,0 +1,342 @@
+/** @file
+  Pluggable TCP congestion control: NewReno and CUBIC.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+//
+// CUBIC constants (RFC9438). C is 0.4 segment/s^3 and beta is 0.7. The
+// cubic curve is evaluated with time in milliseconds, so the scale factor
+// for K^3 is 1 / C * 10^9 ms^3/s^3, and that for W_cubic is C / 10^9.
+//
+#define TCP_CUBIC_K_SCALE         2500000000U  ///< 1 / C in ms^3/segment.
+#define TCP_CUBIC_BETA_NUM        7            ///< beta_cubic numerator.
+#define TCP_CUBIC_BETA_DEN        10           ///< beta_cubic denominator.
+#define TCP_CUBIC_ALPHA_NUM       9            ///< 3 * (1 - beta) / (1 + beta) numerator.
+#define TCP_CUBIC_ALPHA_DEN       17           ///< 3 * (1 - beta) / (1 + beta) denominator.
+#define TCP_CUBIC_MAX_DELTA       60000        ///< Clamp of |t - K|, in ms.
+
+/**
+  Initialize the NewReno congestion control state.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpNewRenoInit (
+  IN OUT TCP_CB *Tcb
+  )
+{
+}
+
+/**
+  Grow the congestion window as RFC5681: slow start below Ssthresh,
+  and one SMSS per RTT in congestion avoidance.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked   The number of bytes newly acknowledged.
+
+**/
+VOID
+TcpNewRenoOnAck (
+  IN OUT TCP_CB *Tcb,
+  IN     UINT32 Acked
+  )
+{
+  if (Tcb->CWnd < Tcb->Ssthresh) {
+
+    Tcb->CWnd += Tcb->SndMss;
+  } else {
+
+    Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+  }
+}
+
+/**
+  Compute the NewReno slow start threshold on a congestion event.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @return Half of the flight size, but at least two segments.
+
+**/
+UINT32
+TcpNewRenoSsthresh (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  UINT32  FlightSize;
+
+  FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
+
+  return MAX (FlightSize >> 1, (UINT32) (2 * Tcb->SndMss));
+}
+
+/**
+  Compute the integer cube root of a 64-bit value.
+
+  @param[in]  Value    The value to compute the cube root of.
+
+  @return The largest integer whose cube doesn't exceed Value.
+
+**/
+UINT32
+TcpCubicRoot (
+  IN UINT64 Value
+  )
+{
+  UINT32  Root;
+  UINT64  Trial;
+  INTN    Shift;
+
+  Root = 0;
+
+  for (Shift = 63; Shift >= 0; Shift -= 3) {
+    Root  = Root << 1;
+    Trial = MultU64x32 (MultU64x32 (Root, Root + 1), 3) + 1;
+
+    if (RShiftU64 (Value, Shift) >= Trial) {
+      Value -= LShiftU64 (Trial, Shift);
+      Root++;
+    }
+  }
+
+  return Root;
+}
+
+/**
+  Evaluate the cubic window function W_cubic(t) of RFC9438.
+
+  @param[in]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Time     Time elapsed since the epoch start, in ms.
+
+  @return The window at Time, in bytes.
+
+**/
+UINT32
+TcpCubicWindow (
+  IN TCP_CB *Tcb,
+  IN UINT32 Time
+  )
+{
+  TCP_CUBIC *Cubic;
+  UINT32    Delta;
+  UINT64    Offset;
+  BOOLEAN   Before;
+
+  Cubic  = &Tcb->Cubic;
+  Before = (BOOLEAN) (Time < Cubic->K);
+  Delta  = Before ? (Cubic->K - Time) : (Time - Cubic->K);
+  Delta  = MIN (Delta, TCP_CUBIC_MAX_DELTA);
+
+  Offset = MultU64x32 (MultU64x32 (Delta, Delta), Delta);
+  Offset = DivU64x32 (MultU64x32 (Offset, Tcb->SndMss), TCP_CUBIC_K_SCALE);
+
+  if (Before) {
+    return (Offset >= Cubic->Origin) ? 0 : (Cubic->Origin - (UINT32) Offset);
+  }
+
+  return (UINT32) MIN (Cubic->Origin + Offset, MAX_UINT32);
+}
+
+/**
+  Initialize the CUBIC congestion control state.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCubicInit (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  ZeroMem (&Tcb->Cubic, sizeof (TCP_CUBIC));
+}
+
+/**
+  Grow the congestion window as RFC9438: slow start below Ssthresh,
+  then follow the cubic curve, but never grow slower than the
+  Reno-friendly estimate.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked   The number of bytes newly acknowledged.
+
+**/
+VOID
+TcpCubicOnAck (
+  IN OUT TCP_CB *Tcb,
+  IN     UINT32 Acked
+  )
+{
+  TCP_CUBIC *Cubic;
+  UINT32    Time;
+  UINT32    Target;
+
+  if (Tcb->CWnd < Tcb->Ssthresh) {
+    Tcb->CWnd += Tcb->SndMss;
+    return;
+  }
+
+  Cubic = &Tcb->Cubic;
+
+  if (!Cubic->EpochValid) {
+    Cubic->EpochValid = TRUE;
+    Cubic->EpochStart = mTcpTick;
+    Cubic->WEst       = Tcb->CWnd;
+
+    if (Tcb->CWnd < Cubic->WMax) {
+      Cubic->K = TcpCubicRoot (
+                   DivU64x32 (
+                     MultU64x32 (Cubic->WMax - Tcb->CWnd, TCP_CUBIC_K_SCALE),
+                     Tcb->SndMss
+                     )
+                   );
+      Cubic->Origin = Cubic->WMax;
+    } else {
+      Cubic->K      = 0;
+      Cubic->Origin = Tcb->CWnd;
+    }
+  }
+
+  //
+  // Reno-friendly estimate, grows by alpha_cubic segments per RTT.
+  //
+  Cubic->WEst += (UINT32) DivU64x32 (
+                            DivU64x32 (
+                              MultU64x32 (MultU64x32 (Acked, Tcb->SndMss), TCP_CUBIC_ALPHA_NUM),
+                              Tcb->CWnd
+                              ),
+                            TCP_CUBIC_ALPHA_DEN
+                            );
+
+  //
+  // Aim at the window one RTT ahead.
+  //
+  Time   = (TCP_SUB_TIME (mTcpTick, Cubic->EpochStart) + (Tcb->SRtt >> TCP_RTT_SHIFT)) * TCP_TICK;
+  Target = TcpCubicWindow (Tcb, Time);
+
+  if (Target < Cubic->WEst) {
+    Tcb->CWnd = MAX (Tcb->CWnd, Cubic->WEst);
+    return;
+  }
+
+  Target = MIN (Target, Tcb->CWnd + (Tcb->CWnd >> 1));
+  if (Target > Tcb->CWnd) {
+    Tcb->CWnd += MAX (
+                   (UINT32) DivU64x32 (MultU64x32 (Target - Tcb->CWnd, Acked), Tcb->CWnd),
+                   1
+                   );
+  }
+}
+
+/**
+  Compute the CUBIC slow start threshold on a congestion event, and
+  remember the window for the next epoch.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @return beta_cubic times the congestion window, but at least two segments.
+
+**/
+UINT32
+TcpCubicSsthresh (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  TCP_CUBIC *Cubic;
+
+  Cubic             = &Tcb->Cubic;
+  Cubic->EpochValid = FALSE;
+
+  //
+  // Fast convergence: release bandwidth to newer flows if the window
+  // didn't get back to where it was at the last congestion event.
+  //
+  if (Tcb->CWnd < Cubic->WMax) {
+    Cubic->WMax = (UINT32) DivU64x32 (
+                             MultU64x32 (Tcb->CWnd, TCP_CUBIC_BETA_DEN + TCP_CUBIC_BETA_NUM),
+                             2 * TCP_CUBIC_BETA_DEN
+                             );
+  } else {
+    Cubic->WMax = Tcb->CWnd;
+  }
+
+  return MAX (
+           (UINT32) DivU64x32 (MultU64x32 (Tcb->CWnd, TCP_CUBIC_BETA_NUM), TCP_CUBIC_BETA_DEN),
+           (UINT32) (2 * Tcb->SndMss)
+           );
+}
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST TCP_CONGESTION_OPS  mTcpNewReno = {
+  "NewReno",
+  TcpNewRenoInit,
+  TcpNewRenoOnAck,
+  TcpNewRenoSsthresh
+};
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST TCP_CONGESTION_OPS  mTcpCubic = {
+  "CUBIC",
+  TcpCubicInit,
+  TcpCubicOnAck,
+  TcpCubicSsthresh
+};
+
+/**
+  Select the congestion control algorithm of the connection by
+  PcdTcpCongestionControl, and initialize its state.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCongestionInit (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  if (PcdGet8 (PcdTcpCongestionControl) == TCP_CC_CUBIC) {
+    Tcb->CongestCtrl = &mTcpCubic;
+  } else {
+    Tcb->CongestCtrl = &mTcpNewReno;
+  }
+
+  Tcb->CongestCtrl->Init (Tcb);
+}
+
+/**
+  Grow the congestion window when new data is acknowledged outside
+  of fast recovery.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked   The number of bytes newly acknowledged.
+
+**/
+VOID
+TcpCongestionOnAck (
+  IN OUT TCP_CB *Tcb,
+  IN     UINT32 Acked
+  )
+{
+  Tcb->CongestCtrl->OnAck (Tcb, Acked);
+  Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
+}
+
+/**
+  Compute the new slow start threshold on a congestion event.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold, in bytes.
+
+**/
+UINT32
+TcpCongestionSsthresh (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  return Tcb->CongestCtrl->Ssthresh (Tcb);
+}
@@ -120,7 +120,7 @@ Tcp4GetMode (
       Option->EnableTimeStamp        = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling    = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -198,7 +198,7 @@ Tcp6GetMode (
       Option->EnableTimeStamp        = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling    = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN) (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -568,6 +568,7 @@ TcpConfigurePcb (
   Tcb->Ssthresh         = 0xffffffff;
 
   Tcb->CongestState     = TCP_CONGEST_OPEN;
+  TcpCongestionInit (Tcb);
 
   Tcb->KeepAliveIdle    = TCP_KEEPALIVE_IDLE_MIN;
   Tcb->KeepAlivePeriod  = TCP_KEEPALIVE_PERIOD;
@@ -708,6 +709,17 @@ TcpConfigurePcb (
     if (!Option->EnableWindowScaling) {
       TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_WS);
     }
+
+    if (!Option->EnableSelectiveAck) {
+      TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
+    }
+  }
+
+  //
+  // SACK is only negotiated when the platform opts in.
+  //
+  if (!PcdGetBool (PcdTcpSelectiveAck)) {
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
   }
 
   //
@@ -465,6 +465,8 @@ TcpDestroyService (
                NULL
                );
   } else if (IsListEmpty (&TcpServiceData->SocketList)) {
+    NetbufDumpStatistics ("TcpDestroyService");
+
     //
     // Uninstall TCP servicebinding protocol
     //
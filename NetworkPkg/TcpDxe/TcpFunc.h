@@ -499,6 +499,161 @@ TcpInput (
   IN UINT8           Version
   );
 
+//
+// Functions in TcpSack.c
+//
+
+/**
+  Build the SACK blocks describing the out-of-order data in the
+  reassemble queue.
+
+  @param[in]   Tcb         Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block       The buffer to return the SACK blocks.
+  @param[in]   MaxBlock    The maximum number of blocks to return.
+
+  @return The number of blocks returned in Block.
+
+**/
+UINT8
+TcpSackBuildBlocks (
+  IN  TCP_CB         *Tcb,
+  OUT TCP_SACK_BLOCK *Block,
+  IN  UINT8          MaxBlock
+  );
+
+/**
+  Reset the SACK scoreboard and the RACK state for a new connection.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackInit (
+  IN OUT TCP_CB *Tcb
+  );
+
+/**
+  Update the SACK scoreboard with the cumulative ACK and the SACK
+  blocks of an incoming segment.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seg     The incoming segment.
+  @param[in]       Option  The options parsed from the incoming segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEG    *Seg,
+  IN     TCP_OPTION *Option
+  );
+
+/**
+  Estimate the number of bytes outstanding in the network.
+
+  @param[in]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @return The number of bytes in flight.
+
+**/
+UINT32
+TcpSackPipe (
+  IN TCP_CB *Tcb
+  );
+
+/**
+  Record a retransmission in the SACK scoreboard.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seq     The first sequence retransmitted.
+  @param[in]       End     The sequence after the last one retransmitted.
+
+**/
+VOID
+TcpSackOnRetransmit (
+  IN OUT TCP_CB    *Tcb,
+  IN     TCP_SEQNO Seq,
+  IN     TCP_SEQNO End
+  );
+
+/**
+  Update the scoreboard on a retransmission timeout.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackOnTimeout (
+  IN OUT TCP_CB *Tcb
+  );
+
+/**
+  Congestion control and loss recovery for a connection using SACK.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked   The number of bytes newly acknowledged.
+
+**/
+VOID
+TcpSackRecover (
+  IN OUT TCP_CB *Tcb,
+  IN     UINT32 Acked
+  );
+
+/**
+  Heartbeat of the RACK loss detection.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackTick (
+  IN OUT TCP_CB *Tcb
+  );
+
+//
+// Functions in TcpCongestion.c
+//
+
+/**
+  Select the congestion control algorithm of the connection, and
+  initialize its state.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCongestionInit (
+  IN OUT TCP_CB *Tcb
+  );
+
+/**
+  Grow the congestion window when new data is acknowledged outside
+  of fast recovery.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked   The number of bytes newly acknowledged.
+
+**/
+VOID
+TcpCongestionOnAck (
+  IN OUT TCP_CB *Tcb,
+  IN     UINT32 Acked
+  );
+
+/**
+  Compute the new slow start threshold on a congestion event.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold, in bytes.
+
+**/
+UINT32
+TcpCongestionSsthresh (
+  IN OUT TCP_CB *Tcb
+  );
+
 //
 // Functions in TcpTimer.c
 //
@@ -53,9 +53,7 @@ TcpFastRecover (
     //
     // Step 1A: Invoking fast retransmission.
     //
-    FlightSize        = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-
-    Tcb->Ssthresh     = MAX (FlightSize >> 1, (UINT32) (2 * Tcb->SndMss));
+    Tcb->Ssthresh     = TcpCongestionSsthresh (Tcb);
     Tcb->Recover      = Tcb->SndNxt;
 
     Tcb->CongestState = TCP_CONGEST_RECOVER;
@@ -759,6 +757,8 @@ TcpInput (
   TCP_SEQNO   Urg;
   UINT16      Checksum;
   INT32       Usable;
+  UINT32      Acked;
+  BOOLEAN     SackRecovery;
 
   ASSERT ((Version == IP_VERSION_4) || (Version == IP_VERSION_6));
 
@@ -1262,6 +1262,14 @@ TcpInput (
     TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
   }
 
+  //
+  // Update the SACK scoreboard and the RACK state before
+  // the acknowledged segments are released.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK)) {
+    TcpSackUpdate (Tcb, Seg, &Option);
+  }
+
   //
   // Count duplicate acks.
   //
@@ -1280,21 +1288,20 @@ TcpInput (
   //
   // Congestion avoidance, fast recovery and fast retransmission.
   //
-  if (((Tcb->CongestState == TCP_CONGEST_OPEN) && (Tcb->DupAck < 3)) ||
+  Acked        = TCP_SEQ_GT (Seg->Ack, Tcb->SndUna) ? TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna) : 0;
+  SackRecovery = TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK);
+
+  if (SackRecovery) {
+    //
+    // The SACK scoreboard drives the loss recovery, once the
+    // acknowledged segments are released. See TcpSackRecover().
+    //
+  } else if (((Tcb->CongestState == TCP_CONGEST_OPEN) && (Tcb->DupAck < 3)) ||
       (Tcb->CongestState == TCP_CONGEST_LOSS))
   {
 
-    if (TCP_SEQ_GT (Seg->Ack, Tcb->SndUna)) {
-
-      if (Tcb->CWnd < Tcb->Ssthresh) {
-
-        Tcb->CWnd += Tcb->SndMss;
-      } else {
-
-        Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
-      }
-
-      Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
+    if (Acked != 0) {
+      TcpCongestionOnAck (Tcb, Acked);
     }
 
     if (Tcb->CongestState == TCP_CONGEST_LOSS) {
@@ -1327,6 +1334,10 @@ TcpInput (
     }
   }
 
+  if (SackRecovery) {
+    TcpSackRecover (Tcb, Acked);
+  }
+
   //
   // Update window info
   //
@@ -1549,6 +1560,10 @@ StepSix:
       goto RESET_THEN_DROP;
     }
 
+    if (TCP_SEQ_GT (Seg->Seq, Tcb->RcvNxt)) {
+      Tcb->RcvSackRecent = Seg->Seq;
+    }
+
     if (TcpQueueData (Tcb, Nbuf) == 0) {
       DEBUG (
         (EFI_D_ERROR,
@@ -11,11 +11,14 @@
 #ifndef _TCP_MAIN_H_
 #define _TCP_MAIN_H_
 
+#include <Uefi.h>
+
 #include <Protocol/ServiceBinding.h>
 #include <Protocol/DriverBinding.h>
 #include <Library/IpIoLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/PrintLib.h>
+#include <Library/PcdLib.h>
 
 #include "Socket.h"
 #include "TcpProto.h"
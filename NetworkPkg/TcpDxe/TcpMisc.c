@@ -165,6 +165,18 @@ TcpInitTcbPeer (
     //
     Tcb->SndMss -= TCP_OPTION_TS_ALIGNED_LEN;
   }
+
+  if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_SACK_PERM) && !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK)) {
+
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_SND_SACK);
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK);
+  } else {
+
+    TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_SND_SACK | TCP_CTRL_RCVD_SACK);
+  }
+
+  TcpSackInit (Tcb);
+  TcpCongestionInit (Tcb);
 }
 
 /**
@@ -159,6 +159,28 @@ TcpSynBuildOption (
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build the SACK permitted option, only when SACK is
+  // enabled, and either we are doing active open or we
+  // have received SACK permitted option from peer.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+        TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK))
+      ) {
+
+    Data = NetbufAllocSpace (
+             Nbuf,
+             TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+             NET_BUF_HEAD
+             );
+
+    ASSERT (Data != NULL);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build the MSS option.
   //
@@ -186,11 +208,18 @@ TcpBuildOption (
   IN NET_BUF *Nbuf
   )
 {
-  UINT8   *Data;
-  UINT16  Len;
+  UINT8           *Data;
+  UINT16          Len;
+  UINT32          DataLen;
+  UINT32          Room;
+  UINT8           MaxBlock;
+  UINT8           BlockNum;
+  UINT8           Index;
+  TCP_SACK_BLOCK  Block[TCP_OPTION_SACK_MAX_BLOCK];
 
   ASSERT ((Tcb != NULL) && (Nbuf != NULL) && (Nbuf->Tcp == NULL));
-  Len = 0;
+  Len     = 0;
+  DataLen = Nbuf->TotalSize;
 
   //
   // Build the Timestamp option.
@@ -213,6 +242,59 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Build the SACK option if there is out-of-order data in
+  // the reassemble queue. The option must not push a data
+  // segment beyond the send MSS, so data segments may carry
+  // fewer blocks than pure ACKs do.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) &&
+      !TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST) &&
+      !IsListEmpty (&Tcb->RcvQue)
+      ) {
+
+    Room = TCP_OPTION_MAX_LEN - Len;
+    if (DataLen != 0) {
+      Room = MIN (Room, (Tcb->SndMss > DataLen) ? (Tcb->SndMss - DataLen) : 0);
+    }
+
+    MaxBlock = 0;
+    if (Room >= TCP_OPTION_SACK_ALIGNED_LEN + TCP_OPTION_SACK_BLOCK_LEN) {
+      MaxBlock = (UINT8) MIN (
+                           (Room - TCP_OPTION_SACK_ALIGNED_LEN) / TCP_OPTION_SACK_BLOCK_LEN,
+                           TCP_OPTION_SACK_MAX_BLOCK
+                           );
+    }
+
+    BlockNum = 0;
+    if (MaxBlock != 0) {
+      BlockNum = TcpSackBuildBlocks (Tcb, Block, MaxBlock);
+    }
+
+    if (BlockNum != 0) {
+      Data = NetbufAllocSpace (
+               Nbuf,
+               TCP_OPTION_SACK_ALIGNED_LEN + BlockNum * TCP_OPTION_SACK_BLOCK_LEN,
+               NET_BUF_HEAD
+               );
+
+      ASSERT (Data != NULL);
+      Len = (UINT16) (Len + TCP_OPTION_SACK_ALIGNED_LEN + BlockNum * TCP_OPTION_SACK_BLOCK_LEN);
+
+      TcpPutUint32 (
+        Data,
+        TCP_OPTION_SACK_FAST | (2 + BlockNum * TCP_OPTION_SACK_BLOCK_LEN)
+        );
+
+      Data += TCP_OPTION_SACK_ALIGNED_LEN;
+      for (Index = 0; Index < BlockNum; Index++) {
+        TcpPutUint32 (Data, Block[Index].Left);
+        TcpPutUint32 (Data + 4, Block[Index].Right);
+        Data += TCP_OPTION_SACK_BLOCK_LEN;
+      }
+    }
+  }
+
   return Len;
 }
 
@@ -238,10 +320,12 @@ TcpParseOption (
   UINT8 Cur;
   UINT8 Type;
   UINT8 Len;
+  UINT8 Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
-  Option->Flag  = 0;
+  Option->Flag    = 0;
+  Option->SackNum = 0;
 
   TotalLen      = (UINT8) ((Tcp->HeadLen << 2) - sizeof (TCP_HEAD));
   if (TotalLen <= 0) {
@@ -313,6 +397,44 @@ TcpParseOption (
       Cur += TCP_OPTION_TS_LEN;
       break;
 
+    case TCP_OPTION_SACK_PERM:
+      Len = Head[Cur + 1];
+
+      if ((Len != TCP_OPTION_SACK_PERM_LEN) || (TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN)) {
+
+        return -1;
+      }
+
+      TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+      Cur += TCP_OPTION_SACK_PERM_LEN;
+      break;
+
+    case TCP_OPTION_SACK:
+      Len = Head[Cur + 1];
+
+      if ((Len < 2 + TCP_OPTION_SACK_BLOCK_LEN) ||
+          ((Len - 2) % TCP_OPTION_SACK_BLOCK_LEN != 0) ||
+          (TotalLen - Cur < Len)) {
+
+        return -1;
+      }
+
+      Option->SackNum = (UINT8) MIN (
+                                  (Len - 2) / TCP_OPTION_SACK_BLOCK_LEN,
+                                  TCP_OPTION_SACK_MAX_BLOCK
+                                  );
+
+      for (Index = 0; Index < Option->SackNum; Index++) {
+        Option->SackBlock[Index].Left  = TcpGetUint32 (&Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+        Option->SackBlock[Index].Right = TcpGetUint32 (&Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+      }
+
+      TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+
+      Cur = (UINT8) (Cur + Len);
+      break;
+
     case TCP_OPTION_NOP:
       Cur++;
       break;
@@ -177,6 +177,7 @@ TcpDataToSend (
   UINT32  Len;
   UINT32  Left;
   UINT32  Limit;
+  UINT32  Pipe;
 
   Sk = Tcb->Sk;
   ASSERT (Sk != NULL);
@@ -196,6 +197,24 @@ TcpDataToSend (
     Limit = Tcb->SndUna + Tcb->CWnd;
   }
 
+  //
+  // During SACK recovery, the congestion window limits the
+  // data in flight instead, which excludes the SACKed and
+  // the lost segments (RFC6675).
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) &&
+      (Tcb->CongestState == TCP_CONGEST_RECOVER)) {
+
+    Pipe  = TcpSackPipe (Tcb);
+    Limit = Tcb->SndWl2 + Tcb->SndWnd;
+
+    if (Pipe >= Tcb->CWnd) {
+      Limit = Tcb->SndNxt;
+    } else if (TCP_SEQ_GT (Limit, Tcb->SndNxt + (Tcb->CWnd - Pipe))) {
+      Limit = Tcb->SndNxt + (Tcb->CWnd - Pipe);
+    }
+  }
+
   if (TCP_SEQ_GT (Limit, Tcb->SndNxt)) {
     Win = TCP_SUB_SEQ (Limit, Tcb->SndNxt);
   }
@@ -586,8 +605,10 @@ TcpGetSegmentSock (
 
   NET_GET_REF (Nbuf);
 
-  TCPSEG_NETBUF (Nbuf)->Seq = Seq;
-  TCPSEG_NETBUF (Nbuf)->End = Seq + Len;
+  TCPSEG_NETBUF (Nbuf)->Seq       = Seq;
+  TCPSEG_NETBUF (Nbuf)->End       = Seq + Len;
+  TCPSEG_NETBUF (Nbuf)->SackFlag  = 0;
+  TCPSEG_NETBUF (Nbuf)->XmitTime  = mTcpTick;
 
   InsertTailList (&(Tcb->SndQue), &(Nbuf->List));
 
@@ -715,6 +736,10 @@ TcpRetransmit (
     Tcb->RetxmitSeqMax = Seq;
   }
 
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK)) {
+    TcpSackOnRetransmit (Tcb, Seq, TCPSEG_NETBUF (Nbuf)->End);
+  }
+
   //
   // The retransmitted buffer may be on the SndQue,
   // trim TCP head because all the buffers on SndQue
@@ -886,9 +911,10 @@ TcpToSendData (
       }
     }
 
-    Seg->Seq  = Seq;
-    Seg->End  = End;
-    Seg->Flag = Flag;
+    Seg->Seq      = Seq;
+    Seg->End      = End;
+    Seg->Flag     = Flag;
+    Seg->XmitTime = mTcpTick;
 
     if (TcpVerifySegment (Nbuf) == 0 || TcpCheckSndQue (&Tcb->SndQue) == 0) {
       DEBUG (
@@ -72,6 +72,28 @@
 #define TCP_CTRL_TIMER_ON        0x1000 ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON          0x2000 ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW         0x4000 ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK         0x00010000 ///< Disable SACK option.
+#define TCP_CTRL_RCVD_SACK       0x00020000 ///< Received a SACK permitted option in syn.
+#define TCP_CTRL_SND_SACK        0x00040000 ///< SACK is in use on the connection.
+
+//
+// Scoreboard flags of the segments in the retransmission queue (RFC6675).
+//
+#define TCP_SACK_SACKED          0x01 ///< The segment has been SACKed by the peer.
+#define TCP_SACK_LOST            0x02 ///< The segment is considered lost.
+#define TCP_SACK_RETRANS         0x04 ///< The segment has been retransmitted.
+
+//
+// Loss detection thresholds (RFC6675 and RFC8985).
+//
+#define TCP_SACK_DUP_THRESH      3  ///< SACKed segments above a hole to declare it lost.
+#define TCP_RACK_REO_WND_MIN     1  ///< Minimum RACK reordering window, in ticks.
+
+//
+// Congestion control algorithms, selected by PcdTcpCongestionControl.
+//
+#define TCP_CC_NEWRENO           0
+#define TCP_CC_CUBIC             1
 
 //
 // Timer related values
@@ -217,6 +239,8 @@ typedef struct _TCP_SEG {
   UINT8     Flag; ///< TCP header flags.
   UINT16    Urg;  ///< Valid if URG flag is set.
   UINT32    Wnd;  ///< TCP window size field.
+  UINT8     SackFlag; ///< Scoreboard flags, such as TCP_SACK_SACKED.
+  UINT32    XmitTime; ///< The tick this segment was last transmitted.
 } TCP_SEG;
 
 ///
@@ -229,6 +253,69 @@ typedef struct _TCP_PEER {
 
 typedef struct _TCP_CONTROL_BLOCK  TCP_CB;
 
+/**
+  Initialize the congestion control state of a new connection.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+typedef
+VOID
+(*TCP_CC_INIT) (
+  IN OUT TCP_CB *Tcb
+  );
+
+/**
+  Grow the congestion window when new data is acknowledged outside
+  of loss recovery.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked   The number of bytes newly acknowledged.
+
+**/
+typedef
+VOID
+(*TCP_CC_ON_ACK) (
+  IN OUT TCP_CB *Tcb,
+  IN     UINT32 Acked
+  );
+
+/**
+  Compute the new slow start threshold on a congestion event.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold, in bytes.
+
+**/
+typedef
+UINT32
+(*TCP_CC_SSTHRESH) (
+  IN OUT TCP_CB *Tcb
+  );
+
+///
+/// Congestion control algorithm.
+///
+typedef struct _TCP_CONGESTION_OPS {
+  CHAR8           *Name;
+  TCP_CC_INIT     Init;
+  TCP_CC_ON_ACK   OnAck;
+  TCP_CC_SSTHRESH Ssthresh;
+} TCP_CONGESTION_OPS;
+
+///
+/// CUBIC state (RFC9438).
+///
+typedef struct _TCP_CUBIC {
+  BOOLEAN   EpochValid; ///< TRUE if a congestion avoidance epoch is running.
+  UINT32    EpochStart; ///< The tick the current epoch started.
+  UINT32    K;          ///< Time to reach WMax from the epoch start, in ms.
+  UINT32    Origin;     ///< The window at the plateau of the cubic curve.
+  UINT32    WMax;       ///< Window before the last reduction.
+  UINT32    WEst;       ///< Reno-friendly window estimate.
+} TCP_CUBIC;
+
 ///
 /// TCP control block: it includes various states.
 ///
@@ -308,6 +395,19 @@ struct _TCP_CONTROL_BLOCK {
   UINT8             CongestState; ///< The current congestion state(RFC3782).
   UINT8             LossTimes;    ///< Number of retxmit timeouts in a row.
   TCP_SEQNO         LossRecover;  ///< Recover point for retxmit.
+  CONST TCP_CONGESTION_OPS  *CongestCtrl; ///< The congestion control algorithm.
+  TCP_CUBIC         Cubic;        ///< CUBIC state.
+
+  //
+  // RFC2018, RFC6675 and RFC8985 variables.
+  // SACK scoreboard and RACK loss detection.
+  //
+  TCP_SEQNO         RcvSackRecent; ///< Start of the latest out-of-order segment received.
+  TCP_SEQNO         HighSacked;    ///< Highest sequence SACKed by the peer.
+  UINT32            RackXmitTime;  ///< Transmit tick of the latest sent segment delivered.
+  TCP_SEQNO         RackEndSeq;    ///< End of the latest sent segment delivered.
+  UINT32            RackRtt;       ///< RTT of that segment, in ticks.
+  UINT32            RackMinRtt;    ///< Minimum RTT observed, in ticks.
 
   //
   // RFC7323
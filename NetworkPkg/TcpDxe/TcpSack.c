@@ -0,0 +1,682 @@
+/** @file
+  TCP selective acknowledgment (RFC2018), SACK based loss recovery (RFC6675)
+  and RACK loss detection (RFC8985).
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+/**
+  Build the SACK blocks describing the out-of-order data in the
+  reassemble queue. The block holding the most recently received
+  segment is reported first, followed by the highest other blocks,
+  as suggested by RFC2018 section 4.
+
+  @param[in]   Tcb         Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block       The buffer to return the SACK blocks.
+  @param[in]   MaxBlock    The maximum number of blocks to return.
+
+  @return The number of blocks returned in Block.
+
+**/
+UINT8
+TcpSackBuildBlocks (
+  IN  TCP_CB         *Tcb,
+  OUT TCP_SACK_BLOCK *Block,
+  IN  UINT8          MaxBlock
+  )
+{
+  LIST_ENTRY      *Entry;
+  NET_BUF         *Node;
+  TCP_SEG         *Seg;
+  TCP_SACK_BLOCK  Cur;
+  TCP_SACK_BLOCK  Other[TCP_OPTION_SACK_MAX_BLOCK];
+  UINT8           OtherNum;
+  UINT8           Num;
+  BOOLEAN         Valid;
+  BOOLEAN         HasRecent;
+
+  ASSERT ((MaxBlock > 0) && (MaxBlock <= TCP_OPTION_SACK_MAX_BLOCK));
+
+  OtherNum  = 0;
+  HasRecent = FALSE;
+  Valid     = FALSE;
+  Cur.Left  = 0;
+  Cur.Right = 0;
+
+  //
+  // The reassemble queue is sorted by sequence, so coalesce
+  // the adjacent segments and keep the MaxBlock - 1 highest
+  // blocks besides the one holding the latest segment.
+  //
+  Entry = Tcb->RcvQue.ForwardLink;
+
+  for (;;) {
+    Seg = NULL;
+
+    if (Entry != &Tcb->RcvQue) {
+      Node  = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+      Seg   = TCPSEG_NETBUF (Node);
+      Entry = Entry->ForwardLink;
+
+      if (TCP_SEQ_LEQ (Seg->End, Tcb->RcvNxt)) {
+        continue;
+      }
+
+      if (Valid && TCP_SEQ_LEQ (Seg->Seq, Cur.Right)) {
+        if (TCP_SEQ_GT (Seg->End, Cur.Right)) {
+          Cur.Right = Seg->End;
+        }
+
+        continue;
+      }
+    }
+
+    if (Valid) {
+      if (!HasRecent && TCP_SEQ_LEQ (Cur.Left, Tcb->RcvSackRecent) &&
+          TCP_SEQ_LT (Tcb->RcvSackRecent, Cur.Right)) {
+
+        HasRecent = TRUE;
+        Block[0]  = Cur;
+      } else if (MaxBlock > 1) {
+        if (OtherNum == MaxBlock - 1) {
+          CopyMem (&Other[0], &Other[1], (OtherNum - 1) * sizeof (TCP_SACK_BLOCK));
+          OtherNum--;
+        }
+
+        Other[OtherNum++] = Cur;
+      }
+    }
+
+    if (Seg == NULL) {
+      break;
+    }
+
+    Cur.Left  = Seg->Seq;
+    Cur.Right = Seg->End;
+    Valid     = TRUE;
+  }
+
+  Num = HasRecent ? 1 : 0;
+
+  while ((OtherNum > 0) && (Num < MaxBlock)) {
+    Block[Num++] = Other[--OtherNum];
+  }
+
+  return Num;
+}
+
+/**
+  Check whether segment A was sent after segment B, with the end
+  sequence as the tie breaker (RFC8985 section 6.2).
+
+  @param[in]  TimeA    The transmit tick of segment A.
+  @param[in]  EndA     The end sequence of segment A.
+  @param[in]  TimeB    The transmit tick of segment B.
+  @param[in]  EndB     The end sequence of segment B.
+
+  @retval TRUE         Segment A was sent after segment B.
+  @retval FALSE        Otherwise.
+
+**/
+BOOLEAN
+TcpRackSentAfter (
+  IN UINT32    TimeA,
+  IN TCP_SEQNO EndA,
+  IN UINT32    TimeB,
+  IN TCP_SEQNO EndB
+  )
+{
+  return (BOOLEAN) (TCP_TIME_LT (TimeB, TimeA) ||
+                    ((TimeA == TimeB) && TCP_SEQ_GT (EndA, EndB)));
+}
+
+/**
+  Update the RACK state with a segment that has just been delivered,
+  either cumulatively acknowledged or SACKed.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seg     The delivered segment.
+
+**/
+VOID
+TcpRackUpdate (
+  IN OUT TCP_CB  *Tcb,
+  IN     TCP_SEG *Seg
+  )
+{
+  UINT32  Rtt;
+
+  Rtt = TCP_SUB_TIME (mTcpTick, Seg->XmitTime);
+
+  //
+  // The RTT of a retransmitted segment is ambiguous. Ignore it
+  // if the ACK may be for the original transmission.
+  //
+  if (TCP_FLG_ON (Seg->SackFlag, TCP_SACK_RETRANS) && (Rtt < Tcb->RackMinRtt)) {
+    return;
+  }
+
+  if (!TCP_FLG_ON (Seg->SackFlag, TCP_SACK_RETRANS)) {
+    Tcb->RackMinRtt = MIN (Tcb->RackMinRtt, Rtt);
+  }
+
+  if (TcpRackSentAfter (Seg->XmitTime, Seg->End, Tcb->RackXmitTime, Tcb->RackEndSeq)) {
+    Tcb->RackXmitTime = Seg->XmitTime;
+    Tcb->RackEndSeq   = Seg->End;
+    Tcb->RackRtt      = Rtt;
+  }
+}
+
+/**
+  Reset the SACK scoreboard and the RACK state for a new connection.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackInit (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  Tcb->RcvSackRecent  = Tcb->Irs;
+  Tcb->HighSacked     = Tcb->Iss;
+  Tcb->RackXmitTime   = mTcpTick;
+  Tcb->RackEndSeq     = Tcb->Iss;
+  Tcb->RackRtt        = 0;
+  Tcb->RackMinRtt     = MAX_UINT32;
+}
+
+/**
+  Update the SACK scoreboard with the cumulative ACK and the SACK
+  blocks of an incoming segment. Must be called before the newly
+  acknowledged segments are removed from the retransmission queue.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seg     The incoming segment.
+  @param[in]       Option  The options parsed from the incoming segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEG    *Seg,
+  IN     TCP_OPTION *Option
+  )
+{
+  TCP_SACK_BLOCK  Block[TCP_OPTION_SACK_MAX_BLOCK];
+  UINT8           BlockNum;
+  UINT8           Index;
+  TCP_SEQNO       Limit;
+  LIST_ENTRY      *Entry;
+  NET_BUF         *Node;
+  TCP_SEG         *Cur;
+  BOOLEAN         Sacked;
+
+  //
+  // Drop the D-SACK blocks and those out of the outstanding data.
+  //
+  BlockNum = 0;
+  Limit    = Seg->Ack;
+
+  if (TCP_FLG_ON (Option->Flag, TCP_OPTION_RCVD_SACK)) {
+    for (Index = 0; Index < Option->SackNum; Index++) {
+      if (TCP_SEQ_GEQ (Option->SackBlock[Index].Left, Option->SackBlock[Index].Right) ||
+          TCP_SEQ_LEQ (Option->SackBlock[Index].Right, Seg->Ack) ||
+          TCP_SEQ_LT (Option->SackBlock[Index].Left, Tcb->SndUna) ||
+          TCP_SEQ_GT (Option->SackBlock[Index].Right, Tcb->SndNxt)) {
+        continue;
+      }
+
+      Block[BlockNum++] = Option->SackBlock[Index];
+
+      if (TCP_SEQ_GT (Option->SackBlock[Index].Right, Limit)) {
+        Limit = Option->SackBlock[Index].Right;
+      }
+    }
+  }
+
+  if ((BlockNum == 0) && TCP_SEQ_LEQ (Seg->Ack, Tcb->SndUna)) {
+    return;
+  }
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    Node = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+    Cur  = TCPSEG_NETBUF (Node);
+
+    if (TCP_SEQ_GEQ (Cur->Seq, Limit)) {
+      break;
+    }
+
+    //
+    // A segment SACKed before has already updated RACK.
+    //
+    if (TCP_FLG_ON (Cur->SackFlag, TCP_SACK_SACKED)) {
+      continue;
+    }
+
+    if (TCP_SEQ_GT (Cur->End, Seg->Ack)) {
+      Sacked = FALSE;
+
+      for (Index = 0; Index < BlockNum; Index++) {
+        if (TCP_SEQ_LEQ (Block[Index].Left, Cur->Seq) &&
+            TCP_SEQ_LEQ (Cur->End, Block[Index].Right)) {
+
+          Sacked = TRUE;
+          break;
+        }
+      }
+
+      if (!Sacked) {
+        continue;
+      }
+
+      TCP_SET_FLG (Cur->SackFlag, TCP_SACK_SACKED);
+
+      if (TCP_SEQ_GT (Cur->End, Tcb->HighSacked)) {
+        Tcb->HighSacked = Cur->End;
+      }
+    }
+
+    TcpRackUpdate (Tcb, Cur);
+  }
+
+  if (TCP_SEQ_LT (Tcb->HighSacked, Seg->Ack)) {
+    Tcb->HighSacked = Seg->Ack;
+  }
+}
+
+/**
+  Mark the lost segments in the retransmission queue. A segment is
+  lost if TCP_SACK_DUP_THRESH segments above it are SACKed (RFC6675),
+  or if a segment sent after it has been delivered, and it is not
+  acknowledged a reordering window after that (RFC8985). A lost
+  retransmission is detected by the latter and sent again.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @retval TRUE         There are lost segments waiting for retransmission.
+  @retval FALSE        Otherwise.
+
+**/
+BOOLEAN
+TcpSackDetectLoss (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  LIST_ENTRY  *Entry;
+  NET_BUF     *Node;
+  TCP_SEG     *Seg;
+  UINT32      SackedAbove;
+  UINT32      ReoWnd;
+  BOOLEAN     Lost;
+  BOOLEAN     Pending;
+
+  if (TCP_SEQ_LEQ (Tcb->HighSacked, Tcb->SndUna)) {
+    return FALSE;
+  }
+
+  ReoWnd = TCP_RACK_REO_WND_MIN;
+  if (Tcb->RackMinRtt != MAX_UINT32) {
+    ReoWnd = MAX (Tcb->RackMinRtt >> 2, TCP_RACK_REO_WND_MIN);
+  }
+
+  SackedAbove = 0;
+  Pending     = FALSE;
+
+  //
+  // Walk backward to count the SACKed segments above each hole.
+  //
+  for (Entry = Tcb->SndQue.BackLink; Entry != &Tcb->SndQue; Entry = Entry->BackLink) {
+    Node = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+    Seg  = TCPSEG_NETBUF (Node);
+
+    if (TCP_SEQ_GEQ (Seg->Seq, Tcb->SndNxt)) {
+      continue;
+    }
+
+    if (TCP_FLG_ON (Seg->SackFlag, TCP_SACK_SACKED)) {
+      SackedAbove++;
+      continue;
+    }
+
+    Lost = FALSE;
+
+    if (!TCP_FLG_ON (Seg->SackFlag, TCP_SACK_RETRANS | TCP_SACK_LOST) &&
+        (SackedAbove >= TCP_SACK_DUP_THRESH)) {
+
+      Lost = TRUE;
+    } else if (TcpRackSentAfter (Tcb->RackXmitTime, Tcb->RackEndSeq, Seg->XmitTime, Seg->End) &&
+               (TCP_SUB_TIME (mTcpTick, Seg->XmitTime) >= Tcb->RackRtt + ReoWnd)) {
+
+      Lost = TRUE;
+    }
+
+    if (Lost) {
+      if (TCP_FLG_ON (Seg->SackFlag, TCP_SACK_RETRANS)) {
+        DEBUG (
+          (EFI_D_NET,
+          "TcpSackDetectLoss: retransmission of %d is lost for TCB %p\n",
+          Seg->Seq,
+          Tcb)
+          );
+      }
+
+      TCP_CLEAR_FLG (Seg->SackFlag, TCP_SACK_RETRANS);
+      TCP_SET_FLG (Seg->SackFlag, TCP_SACK_LOST);
+    }
+
+    if ((Seg->SackFlag & (TCP_SACK_LOST | TCP_SACK_RETRANS)) == TCP_SACK_LOST) {
+      Pending = TRUE;
+    }
+  }
+
+  return Pending;
+}
+
+/**
+  Estimate the number of bytes outstanding in the network, the "pipe"
+  of RFC6675 section 4.
+
+  @param[in]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @return The number of bytes in flight.
+
+**/
+UINT32
+TcpSackPipe (
+  IN TCP_CB *Tcb
+  )
+{
+  LIST_ENTRY  *Entry;
+  NET_BUF     *Node;
+  TCP_SEG     *Seg;
+  UINT32      Pipe;
+  UINT32      Len;
+
+  Pipe = 0;
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    Node = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+    Seg  = TCPSEG_NETBUF (Node);
+
+    if (TCP_SEQ_GEQ (Seg->Seq, Tcb->SndNxt)) {
+      break;
+    }
+
+    if (TCP_FLG_ON (Seg->SackFlag, TCP_SACK_SACKED)) {
+      continue;
+    }
+
+    Len = TCP_SUB_SEQ (Seg->End, Seg->Seq);
+
+    if (!TCP_FLG_ON (Seg->SackFlag, TCP_SACK_LOST)) {
+      Pipe += Len;
+    }
+
+    if (TCP_FLG_ON (Seg->SackFlag, TCP_SACK_RETRANS)) {
+      Pipe += Len;
+    }
+  }
+
+  return Pipe;
+}
+
+/**
+  Retransmit the lost segments while the pipe is below the congestion
+  window.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Force   If TRUE, send the first lost segment even if
+                           the congestion window is full.
+
+**/
+VOID
+TcpSackRetransmit (
+  IN OUT TCP_CB  *Tcb,
+  IN     BOOLEAN Force
+  )
+{
+  LIST_ENTRY  *Entry;
+  NET_BUF     *Node;
+  TCP_SEG     *Seg;
+  UINT32      Pipe;
+
+  Pipe = TcpSackPipe (Tcb);
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    Node = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+    Seg  = TCPSEG_NETBUF (Node);
+
+    if (TCP_SEQ_GEQ (Seg->Seq, Tcb->SndNxt)) {
+      break;
+    }
+
+    if ((Seg->SackFlag & (TCP_SACK_SACKED | TCP_SACK_LOST | TCP_SACK_RETRANS)) != TCP_SACK_LOST) {
+      continue;
+    }
+
+    if (!Force && (Pipe >= Tcb->CWnd)) {
+      break;
+    }
+
+    Force = FALSE;
+
+    if ((TcpRetransmit (Tcb, Seg->Seq) != 0) ||
+        !TCP_FLG_ON (Seg->SackFlag, TCP_SACK_RETRANS)) {
+      break;
+    }
+
+    Pipe += TCP_SUB_SEQ (Seg->End, Seg->Seq);
+  }
+}
+
+/**
+  Record a retransmission in the SACK scoreboard.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seq     The first sequence retransmitted.
+  @param[in]       End     The sequence after the last one retransmitted.
+
+**/
+VOID
+TcpSackOnRetransmit (
+  IN OUT TCP_CB    *Tcb,
+  IN     TCP_SEQNO Seq,
+  IN     TCP_SEQNO End
+  )
+{
+  LIST_ENTRY  *Entry;
+  NET_BUF     *Node;
+  TCP_SEG     *Seg;
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    Node = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+    Seg  = TCPSEG_NETBUF (Node);
+
+    if (TCP_SEQ_GEQ (Seg->Seq, End)) {
+      break;
+    }
+
+    if (TCP_SEQ_GT (Seg->End, Seq)) {
+      TCP_SET_FLG (Seg->SackFlag, TCP_SACK_RETRANS);
+      Seg->XmitTime = mTcpTick;
+    }
+  }
+}
+
+/**
+  Update the scoreboard on a retransmission timeout: all the outstanding
+  segments not SACKed are considered lost, and retransmitted as the
+  congestion window reopens.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackOnTimeout (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  LIST_ENTRY  *Entry;
+  NET_BUF     *Node;
+  TCP_SEG     *Seg;
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    Node = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+    Seg  = TCPSEG_NETBUF (Node);
+
+    if (TCP_SEQ_GEQ (Seg->Seq, Tcb->SndNxt)) {
+      break;
+    }
+
+    if (!TCP_FLG_ON (Seg->SackFlag, TCP_SACK_SACKED)) {
+      Seg->SackFlag = TCP_SACK_LOST;
+    }
+  }
+}
+
+/**
+  Enter the SACK based loss recovery, and retransmit the first lost
+  segment.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackEnterRecovery (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  Tcb->Ssthresh     = TcpCongestionSsthresh (Tcb);
+  Tcb->CWnd         = Tcb->Ssthresh;
+  Tcb->Recover      = Tcb->SndNxt;
+  Tcb->CongestState = TCP_CONGEST_RECOVER;
+  TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RTT_ON);
+
+  DEBUG (
+    (EFI_D_NET,
+    "TcpSackEnterRecovery: enter %a SACK recovery for TCB %p, recover point is %d\n",
+    Tcb->CongestCtrl->Name,
+    Tcb,
+    Tcb->Recover)
+    );
+
+  TcpSackRetransmit (Tcb, TRUE);
+}
+
+/**
+  Congestion control and loss recovery for a connection using SACK.
+  It replaces the NewReno fast recovery, and is called once the
+  retransmission queue and SND.UNA have been updated by the ACK.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked   The number of bytes newly acknowledged.
+
+**/
+VOID
+TcpSackRecover (
+  IN OUT TCP_CB *Tcb,
+  IN     UINT32 Acked
+  )
+{
+  LIST_ENTRY  *Entry;
+  NET_BUF     *Node;
+  BOOLEAN     LostPending;
+
+  LostPending = TcpSackDetectLoss (Tcb);
+
+  switch (Tcb->CongestState) {
+  case TCP_CONGEST_LOSS:
+    if (Acked != 0) {
+      TcpCongestionOnAck (Tcb, Acked);
+    }
+
+    if (TCP_SEQ_GEQ (Tcb->SndUna, Tcb->LossRecover)) {
+      Tcb->LossTimes    = 0;
+      Tcb->CongestState = TCP_CONGEST_OPEN;
+
+      DEBUG (
+        (EFI_D_NET,
+        "TcpSackRecover: received a full ACK(%d) for TCB %p, exit loss recovery\n",
+        Tcb->SndUna,
+        Tcb)
+        );
+    } else {
+      TcpSackRetransmit (Tcb, FALSE);
+    }
+
+    break;
+
+  case TCP_CONGEST_RECOVER:
+    if (TCP_SEQ_GEQ (Tcb->SndUna, Tcb->Recover)) {
+      Tcb->CWnd         = MIN (Tcb->Ssthresh, TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna) + Tcb->SndMss);
+      Tcb->CongestState = TCP_CONGEST_OPEN;
+
+      DEBUG (
+        (EFI_D_NET,
+        "TcpSackRecover: received a full ACK(%d) for TCB %p, exit SACK recovery\n",
+        Tcb->SndUna,
+        Tcb)
+        );
+    } else {
+      TcpSackRetransmit (Tcb, FALSE);
+    }
+
+    break;
+
+  default:
+    if (!LostPending && (Tcb->DupAck < TCP_SACK_DUP_THRESH)) {
+      if (Acked != 0) {
+        TcpCongestionOnAck (Tcb, Acked);
+      }
+
+      break;
+    }
+
+    //
+    // The peer keeps sending duplicate ACKs without SACK blocks,
+    // fall back to retransmit the first unacknowledged segment.
+    //
+    if (!LostPending && !IsListEmpty (&Tcb->SndQue)) {
+      Entry = Tcb->SndQue.ForwardLink;
+      Node  = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+      TCP_SET_FLG (TCPSEG_NETBUF (Node)->SackFlag, TCP_SACK_LOST);
+      TCP_CLEAR_FLG (TCPSEG_NETBUF (Node)->SackFlag, TCP_SACK_RETRANS);
+    }
+
+    TcpSackEnterRecovery (Tcb);
+    break;
+  }
+}
+
+/**
+  Heartbeat of the RACK loss detection. Segments can only be declared
+  lost by the reordering window once some time has passed, which may
+  happen without any ACK arriving.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackTick (
+  IN OUT TCP_CB *Tcb
+  )
+{
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) ||
+      !TCP_CONNECTED (Tcb->State) ||
+      !TcpSackDetectLoss (Tcb)) {
+
+    return;
+  }
+
+  if (Tcb->CongestState == TCP_CONGEST_OPEN) {
+    TcpSackEnterRecovery (Tcb);
+  } else {
+    TcpSackRetransmit (Tcb, FALSE);
+  }
+}
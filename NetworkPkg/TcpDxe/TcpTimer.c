@@ -184,8 +184,6 @@ TcpRexmitTimeout (
   IN OUT TCP_CB *Tcb
   )
 {
-  UINT32  FlightSize;
-
   DEBUG (
     (EFI_D_WARN,
     "TcpRexmitTimeout: transmission timeout for TCB %p\n",
@@ -193,12 +191,11 @@ TcpRexmitTimeout (
     );
 
   //
-  // Set the congestion window. FlightSize is the
-  // amount of data that has been sent but not
-  // yet ACKed.
+  // Set the congestion window. The slow start threshold
+  // is computed by the congestion control algorithm, from
+  // the amount of data that has been sent but not yet ACKed.
   //
-  FlightSize        = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-  Tcb->Ssthresh     = MAX ((UINT32) (2 * Tcb->SndMss), FlightSize / 2);
+  Tcb->Ssthresh     = TcpCongestionSsthresh (Tcb);
 
   Tcb->CWnd         = Tcb->SndMss;
   Tcb->LossRecover  = Tcb->SndNxt;
@@ -220,6 +217,10 @@ TcpRexmitTimeout (
     return ;
   }
 
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK)) {
+    TcpSackOnTimeout (Tcb);
+  }
+
   TcpBackoffRto (Tcb);
   TcpRetransmit (Tcb, Tcb->SndUna);
   TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
@@ -524,6 +525,8 @@ TcpTickingDpc (
       TcpSendAck (Tcb);
     }
 
+    TcpSackTick (Tcb);
+
     if (Tcb->IpInfo->IpVersion == IP_VERSION_6 && Tcb->Tick > 0) {
       Tcb->Tick--;
     }
@@ -0,0 +1,607 @@
+/** @file
+  Host-based unit tests of the TCP SACK scoreboard and CUBIC.
+
+  The SACK and congestion control routines run on a TCP_CB whose reassemble
+  and retransmission queues hold hand made segments. The tests check the order
+  of the SACK blocks sent, the scoreboard built from the SACK blocks received,
+  the loss detection by the duplicate threshold and by RACK, the integer cube
+  root, and the shape of the CUBIC window curve.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "../TcpMain.h"
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME      "TCP SACK and CUBIC Unit Tests"
+#define UNIT_TEST_APP_VERSION   "1.0"
+
+#define TCP_TEST_SEGMENTS       10
+#define TCP_TEST_MSS            1000
+#define TCP_TEST_WMAX           (100 * TCP_TEST_MSS)
+
+//
+// The routines below are internal to TcpSack.c and TcpCongestion.c.
+//
+BOOLEAN
+TcpSackDetectLoss (
+  IN OUT TCP_CB *Tcb
+  );
+
+UINT32
+TcpCubicRoot (
+  IN UINT64 Value
+  );
+
+UINT32
+TcpCubicWindow (
+  IN TCP_CB *Tcb,
+  IN UINT32 Time
+  );
+
+VOID
+TcpCubicInit (
+  IN OUT TCP_CB *Tcb
+  );
+
+VOID
+TcpCubicOnAck (
+  IN OUT TCP_CB *Tcb,
+  IN     UINT32 Acked
+  );
+
+UINT32
+TcpCubicSsthresh (
+  IN OUT TCP_CB *Tcb
+  );
+
+UINT32  mTcpTick;
+
+STATIC TCP_CB   mTcb;
+STATIC NET_BUF  mSegBuf[TCP_TEST_SEGMENTS];
+
+/**
+  Stands in for the retransmission of TcpOutput.c, which the tested routines
+  don't reach. TcpTraceUnitTest.c runs the real one.
+
+  @param[in]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Seq     The sequence number of the segment to be retransmitted.
+
+  @retval -1      Always.
+
+**/
+INTN
+TcpRetransmit (
+  IN TCP_CB    *Tcb,
+  IN TCP_SEQNO Seq
+  )
+{
+  return -1;
+}
+
+/**
+  Append a segment to one of the queues of the test TCP_CB.
+
+  @param[in]  Queue     The reassemble or the retransmission queue.
+  @param[in]  Index     The index of the segment buffer to use.
+  @param[in]  Seq       The sequence number of the segment.
+  @param[in]  End       The end sequence number of the segment.
+  @param[in]  XmitTime  The tick the segment was sent.
+
+  @return The segment appended.
+
+**/
+STATIC
+TCP_SEG *
+TcpTestQueueSegment (
+  IN LIST_ENTRY *Queue,
+  IN UINTN      Index,
+  IN TCP_SEQNO  Seq,
+  IN TCP_SEQNO  End,
+  IN UINT32     XmitTime
+  )
+{
+  TCP_SEG  *Seg;
+
+  Seg           = TCPSEG_NETBUF (&mSegBuf[Index]);
+  Seg->Seq      = Seq;
+  Seg->End      = End;
+  Seg->XmitTime = XmitTime;
+  InsertTailList (Queue, &mSegBuf[Index].List);
+
+  return Seg;
+}
+
+/**
+  Reset the test TCP_CB and its queues.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED     Always.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TcpTestReset (
+  IN UNIT_TEST_CONTEXT Context
+  )
+{
+  ZeroMem (&mTcb, sizeof (mTcb));
+  ZeroMem (mSegBuf, sizeof (mSegBuf));
+  InitializeListHead (&mTcb.SndQue);
+  InitializeListHead (&mTcb.RcvQue);
+  mTcb.SndMss = TCP_TEST_MSS;
+  mTcpTick    = 0;
+
+  TcpSackInit (&mTcb);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Send ten segments, and receive a duplicate ACK whose SACK blocks cover the
+  segments 3, 4 and 7, besides an empty block and a block beyond SndNxt.
+
+  @param[out]  Seg     The segments sent.
+
+**/
+STATIC
+VOID
+TcpTestSackSegments (
+  OUT TCP_SEG **Seg
+  )
+{
+  TCP_SEG     Ack;
+  TCP_OPTION  Option;
+  UINTN       Index;
+
+  for (Index = 0; Index < TCP_TEST_SEGMENTS; Index++) {
+    Seg[Index] = TcpTestQueueSegment (
+                   &mTcb.SndQue,
+                   Index,
+                   (TCP_SEQNO) (Index * TCP_TEST_MSS),
+                   (TCP_SEQNO) ((Index + 1) * TCP_TEST_MSS),
+                   (UINT32) Index
+                   );
+  }
+
+  mTcb.SndUna = 0;
+  mTcb.SndNxt = TCP_TEST_SEGMENTS * TCP_TEST_MSS;
+  mTcpTick    = 20;
+
+  ZeroMem (&Ack, sizeof (Ack));
+  ZeroMem (&Option, sizeof (Option));
+  Ack.Ack                   = 0;
+  Option.Flag               = TCP_OPTION_RCVD_SACK;
+  Option.SackNum            = 4;
+  Option.SackBlock[0].Left  = 7000;
+  Option.SackBlock[0].Right = 8000;
+  Option.SackBlock[1].Left  = 6000;
+  Option.SackBlock[1].Right = 5000;
+  Option.SackBlock[2].Left  = 3000;
+  Option.SackBlock[2].Right = 5000;
+  Option.SackBlock[3].Left  = 9000;
+  Option.SackBlock[3].Right = 11000;
+
+  TcpSackUpdate (&mTcb, &Ack, &Option);
+}
+
+/**
+  The block holding the latest segment is reported first, then the highest
+  blocks, and adjacent segments are coalesced.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The blocks are in the expected order.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  Otherwise.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TcpTestSackBlocks (
+  IN UNIT_TEST_CONTEXT Context
+  )
+{
+  TCP_SACK_BLOCK  Block[TCP_OPTION_SACK_MAX_BLOCK];
+  UINT8           Num;
+
+  mTcb.RcvNxt = 1000;
+
+  TcpTestQueueSegment (&mTcb.RcvQue, 0, 500, 1000, 0);
+  TcpTestQueueSegment (&mTcb.RcvQue, 1, 2000, 3000, 0);
+  TcpTestQueueSegment (&mTcb.RcvQue, 2, 3000, 4000, 0);
+  TcpTestQueueSegment (&mTcb.RcvQue, 3, 5000, 6000, 0);
+  TcpTestQueueSegment (&mTcb.RcvQue, 4, 7000, 8000, 0);
+  TcpTestQueueSegment (&mTcb.RcvQue, 5, 9000, 10000, 0);
+  TcpTestQueueSegment (&mTcb.RcvQue, 6, 11000, 12000, 0);
+
+  mTcb.RcvSackRecent = 5500;
+
+  Num = TcpSackBuildBlocks (&mTcb, Block, TCP_OPTION_SACK_MAX_BLOCK);
+  UT_ASSERT_EQUAL (Num, 4);
+  UT_ASSERT_EQUAL (Block[0].Left, 5000);
+  UT_ASSERT_EQUAL (Block[0].Right, 6000);
+  UT_ASSERT_EQUAL (Block[1].Left, 11000);
+  UT_ASSERT_EQUAL (Block[2].Left, 9000);
+  UT_ASSERT_EQUAL (Block[3].Left, 7000);
+
+  //
+  // With room for three blocks only, the lowest ones are left out.
+  //
+  Num = TcpSackBuildBlocks (&mTcb, Block, 3);
+  UT_ASSERT_EQUAL (Num, 3);
+  UT_ASSERT_EQUAL (Block[0].Left, 5000);
+  UT_ASSERT_EQUAL (Block[1].Left, 11000);
+  UT_ASSERT_EQUAL (Block[2].Left, 9000);
+
+  //
+  // The latest segment filled the gap between the first two blocks.
+  //
+  mTcb.RcvSackRecent = 3000;
+
+  Num = TcpSackBuildBlocks (&mTcb, Block, TCP_OPTION_SACK_MAX_BLOCK);
+  UT_ASSERT_EQUAL (Num, 4);
+  UT_ASSERT_EQUAL (Block[0].Left, 2000);
+  UT_ASSERT_EQUAL (Block[0].Right, 4000);
+  UT_ASSERT_EQUAL (Block[1].Left, 11000);
+  UT_ASSERT_EQUAL (Block[2].Left, 9000);
+  UT_ASSERT_EQUAL (Block[3].Left, 7000);
+
+  //
+  // Once the data is in order, there is nothing to report.
+  //
+  mTcb.RcvNxt = 12000;
+
+  Num = TcpSackBuildBlocks (&mTcb, Block, TCP_OPTION_SACK_MAX_BLOCK);
+  UT_ASSERT_EQUAL (Num, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The segments covered by the valid SACK blocks are marked, and the RACK
+  state follows the latest segment sent among them.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The scoreboard is as expected.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  Otherwise.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TcpTestSackUpdate (
+  IN UNIT_TEST_CONTEXT Context
+  )
+{
+  TCP_SEG  *Seg[TCP_TEST_SEGMENTS];
+  UINTN    Index;
+  BOOLEAN  Sacked;
+
+  TcpTestSackSegments (Seg);
+
+  for (Index = 0; Index < TCP_TEST_SEGMENTS; Index++) {
+    Sacked = (BOOLEAN) ((Index == 3) || (Index == 4) || (Index == 7));
+    UT_ASSERT_EQUAL (TCP_FLG_ON (Seg[Index]->SackFlag, TCP_SACK_SACKED), Sacked);
+  }
+
+  UT_ASSERT_EQUAL (mTcb.HighSacked, 8000);
+  UT_ASSERT_EQUAL (mTcb.RackXmitTime, 7);
+  UT_ASSERT_EQUAL (mTcb.RackEndSeq, 8000);
+  UT_ASSERT_EQUAL (mTcb.RackRtt, 13);
+  UT_ASSERT_EQUAL (mTcb.RackMinRtt, 13);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The holes below three SACKed segments are lost at once, those below fewer
+  when the RACK reordering window has passed, and a lost retransmission is
+  detected by RACK.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The expected segments are lost.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  Otherwise.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TcpTestSackDetectLoss (
+  IN UNIT_TEST_CONTEXT Context
+  )
+{
+  TCP_SEG     *Seg[TCP_TEST_SEGMENTS];
+  TCP_SEG     Ack;
+  TCP_OPTION  Option;
+  UINTN       Index;
+  BOOLEAN     Lost;
+
+  TcpTestSackSegments (Seg);
+
+  //
+  // RackRtt is 13 ticks, and the reordering window a quarter of the
+  // minimum RTT, 3 ticks. Only the segments below 3000 have three
+  // SACKed segments above them.
+  //
+  UT_ASSERT_TRUE (TcpSackDetectLoss (&mTcb));
+
+  for (Index = 0; Index < TCP_TEST_SEGMENTS; Index++) {
+    Lost = (BOOLEAN) (Index < 3);
+    UT_ASSERT_EQUAL (TCP_FLG_ON (Seg[Index]->SackFlag, TCP_SACK_LOST), Lost);
+  }
+
+  //
+  // The segments 5 and 6 were sent before segment 7 and are lost once
+  // they are outstanding for 16 ticks. The segments 8 and 9 were sent
+  // after it and are never lost by RACK.
+  //
+  mTcpTick = 21;
+  TcpSackDetectLoss (&mTcb);
+  UT_ASSERT_EQUAL (TCP_FLG_ON (Seg[5]->SackFlag, TCP_SACK_LOST), TRUE);
+  UT_ASSERT_EQUAL (TCP_FLG_ON (Seg[6]->SackFlag, TCP_SACK_LOST), FALSE);
+
+  mTcpTick = 40;
+  TcpSackDetectLoss (&mTcb);
+  UT_ASSERT_EQUAL (TCP_FLG_ON (Seg[6]->SackFlag, TCP_SACK_LOST), TRUE);
+  UT_ASSERT_EQUAL (TCP_FLG_ON (Seg[8]->SackFlag, TCP_SACK_LOST), FALSE);
+  UT_ASSERT_EQUAL (TCP_FLG_ON (Seg[9]->SackFlag, TCP_SACK_LOST), FALSE);
+
+  //
+  // Retransmit all the lost segments, then SACK the retransmission of
+  // segment 1 with the segments 8 and 9. Segment 0 is retransmitted
+  // before segment 1 and lost again once the reordering window passed.
+  //
+  for (Index = 0; Index < TCP_TEST_SEGMENTS; Index++) {
+    if (TCP_FLG_ON (Seg[Index]->SackFlag, TCP_SACK_LOST)) {
+      TCP_SET_FLG (Seg[Index]->SackFlag, TCP_SACK_RETRANS);
+      Seg[Index]->XmitTime = 40 + (UINT32) Index;
+    }
+  }
+
+  UT_ASSERT_FALSE (TcpSackDetectLoss (&mTcb));
+
+  ZeroMem (&Ack, sizeof (Ack));
+  ZeroMem (&Option, sizeof (Option));
+  Option.Flag               = TCP_OPTION_RCVD_SACK;
+  Option.SackNum            = 2;
+  Option.SackBlock[0].Left  = 1000;
+  Option.SackBlock[0].Right = 2000;
+  Option.SackBlock[1].Left  = 8000;
+  Option.SackBlock[1].Right = 10000;
+
+  mTcpTick = 60;
+  TcpSackUpdate (&mTcb, &Ack, &Option);
+  UT_ASSERT_EQUAL (mTcb.HighSacked, 10000);
+  UT_ASSERT_EQUAL (mTcb.RackXmitTime, 41);
+  UT_ASSERT_EQUAL (mTcb.RackRtt, 19);
+
+  UT_ASSERT_FALSE (TcpSackDetectLoss (&mTcb));
+
+  mTcpTick = 62;
+  UT_ASSERT_TRUE (TcpSackDetectLoss (&mTcb));
+  UT_ASSERT_EQUAL (Seg[0]->SackFlag & (TCP_SACK_LOST | TCP_SACK_RETRANS), TCP_SACK_LOST);
+  UT_ASSERT_EQUAL (Seg[2]->SackFlag & (TCP_SACK_LOST | TCP_SACK_RETRANS), TCP_SACK_LOST | TCP_SACK_RETRANS);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The integer cube root is exact at and around perfect cubes.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             All the roots are right.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  Otherwise.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TcpTestCubicRoot (
+  IN UNIT_TEST_CONTEXT Context
+  )
+{
+  UINT64  Root;
+  UINT64  Cube;
+
+  UT_ASSERT_EQUAL (TcpCubicRoot (0), 0);
+  UT_ASSERT_EQUAL (TcpCubicRoot (1), 1);
+  UT_ASSERT_EQUAL (TcpCubicRoot (7), 1);
+  UT_ASSERT_EQUAL (TcpCubicRoot (8), 2);
+
+  for (Root = 2; Root < 2642245; Root += Root / 7 + 1) {
+    Cube = Root * Root * Root;
+    UT_ASSERT_EQUAL (TcpCubicRoot (Cube), Root);
+    UT_ASSERT_EQUAL (TcpCubicRoot (Cube - 1), Root - 1);
+    UT_ASSERT_EQUAL (TcpCubicRoot (Cube + 3 * Root * Root), Root);
+  }
+
+  UT_ASSERT_EQUAL (TcpCubicRoot (MAX_UINT64), 2642245);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  After a reduction from TCP_TEST_WMAX, the window follows a cubic curve
+  symmetric around WMax at time K, and the congestion window acknowledged
+  once per RTT follows it.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The window follows the curve.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  Otherwise.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TcpTestCubicCurve (
+  IN UNIT_TEST_CONTEXT Context
+  )
+{
+  TCP_CUBIC  *Cubic;
+  UINT32     Time;
+  UINT32     Window;
+  UINT32     Last;
+  UINT32     Tick;
+  UINT32     Acked;
+
+  Cubic = &mTcb.Cubic;
+
+  TcpCubicInit (&mTcb);
+  mTcb.CWnd     = TCP_TEST_WMAX;
+  mTcb.Ssthresh = TcpCubicSsthresh (&mTcb);
+  UT_ASSERT_EQUAL (mTcb.Ssthresh, TCP_TEST_WMAX / 10 * 7);
+  UT_ASSERT_EQUAL (Cubic->WMax, TCP_TEST_WMAX);
+
+  //
+  // One tick RTT. The first ACK starts the epoch: K is the cube root of
+  // 30 segments / C = 75s^3, 4.217s.
+  //
+  mTcb.CWnd = mTcb.Ssthresh;
+  mTcb.SRtt = 1 << TCP_RTT_SHIFT;
+  mTcpTick  = 100;
+
+  TcpCubicOnAck (&mTcb, TCP_TEST_MSS);
+  UT_ASSERT_TRUE (Cubic->EpochValid);
+  UT_ASSERT_EQUAL (Cubic->EpochStart, 100);
+  UT_ASSERT_EQUAL (Cubic->K, 4217);
+  UT_ASSERT_EQUAL (Cubic->Origin, TCP_TEST_WMAX);
+
+  UT_ASSERT_EQUAL (TcpCubicWindow (&mTcb, Cubic->K), TCP_TEST_WMAX);
+  UT_ASSERT_TRUE (TcpCubicWindow (&mTcb, 0) >= mTcb.Ssthresh);
+  UT_ASSERT_TRUE (TcpCubicWindow (&mTcb, 0) < mTcb.Ssthresh + TCP_TEST_MSS);
+
+  Last = 0;
+  for (Time = 0; Time < 3 * Cubic->K; Time += 50) {
+    Window = TcpCubicWindow (&mTcb, Time);
+    UT_ASSERT_TRUE (Window >= Last);
+    Last = Window;
+
+    if (Time <= Cubic->K) {
+      UT_ASSERT_EQUAL (
+        TcpCubicWindow (&mTcb, Cubic->K + Time) - TCP_TEST_WMAX,
+        TCP_TEST_WMAX - TcpCubicWindow (&mTcb, Cubic->K - Time)
+        );
+    }
+  }
+
+  //
+  // Acknowledge a congestion window every tick: the window is concave
+  // below WMax, reaches it close to K, and probes above it afterwards.
+  //
+  Last = mTcb.CWnd;
+  for (Tick = 1; Tick <= 40; Tick++) {
+    mTcpTick = 100 + Tick;
+
+    for (Acked = 0; Acked < Last; Acked += TCP_TEST_MSS) {
+      TcpCubicOnAck (&mTcb, TCP_TEST_MSS);
+    }
+
+    UT_ASSERT_TRUE (mTcb.CWnd >= Last);
+    Last = mTcb.CWnd;
+
+    if ((Tick + 1) * TCP_TICK < Cubic->K) {
+      UT_ASSERT_TRUE (mTcb.CWnd <= TCP_TEST_WMAX);
+    }
+
+    if ((Tick + 1) * TCP_TICK == (Cubic->K / TCP_TICK) * TCP_TICK) {
+      UT_ASSERT_TRUE (mTcb.CWnd >= TCP_TEST_WMAX - 2 * TCP_TEST_MSS);
+    }
+  }
+
+  UT_ASSERT_TRUE (mTcb.CWnd > TCP_TEST_WMAX + 10 * TCP_TEST_MSS);
+
+  //
+  // A loss below the previous WMax releases bandwidth.
+  //
+  mTcb.CWnd     = TCP_TEST_WMAX / 2;
+  mTcb.Ssthresh = TcpCubicSsthresh (&mTcb);
+  UT_ASSERT_FALSE (Cubic->EpochValid);
+  UT_ASSERT_EQUAL (Cubic->WMax, TCP_TEST_WMAX / 2 * 17 / 20);
+  UT_ASSERT_EQUAL (mTcb.Ssthresh, TCP_TEST_WMAX / 2 / 10 * 7);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialze the unit test framework, suite, and unit tests for the SACK
+  scoreboard and CUBIC and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      SackTests;
+  UNIT_TEST_SUITE_HANDLE      CubicTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&SackTests, Framework, "TCP SACK Tests", "Tcp.Sack", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for SackTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&CubicTests, Framework, "TCP CUBIC Tests", "Tcp.Cubic", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for CubicTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-------Description------------------------------------------------Name---------Function---------------Pre-----------Post--Context-----------
+  //
+  AddTestCase (SackTests,  "The latest block is sent first, then the highest ones",      "Blocks",     TcpTestSackBlocks,     TcpTestReset, NULL, NULL);
+  AddTestCase (SackTests,  "The received SACK blocks update the scoreboard and RACK",    "Update",     TcpTestSackUpdate,     TcpTestReset, NULL, NULL);
+  AddTestCase (SackTests,  "Losses are detected by the duplicate threshold and RACK",    "DetectLoss", TcpTestSackDetectLoss, TcpTestReset, NULL, NULL);
+  AddTestCase (CubicTests, "The integer cube root is exact",                             "Root",       TcpTestCubicRoot,      TcpTestReset, NULL, NULL);
+  AddTestCase (CubicTests, "The window follows the cubic curve around WMax",             "Curve",      TcpTestCubicCurve,     TcpTestReset, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int argc,
+  char *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -0,0 +1,1141 @@
+/** @file
+  Host-based unit tests replaying lossy traces through the TCP input and
+  output paths.
+
+  A client opened by TcpOnAppConnect and a server cloned by the SYN from a
+  listening TCB run on the real TcpInput.c, TcpOutput.c and TcpTimer.c. The
+  IP layer below them is a wire in this file: it records every segment sent,
+  drops the transmissions a trace selects, and hands the others to TcpInput.
+  The socket layer above them only moves the data between the socket buffers.
+  The tests check that the SACK loss recovery retransmits only the lost
+  segments, keeps the data in flight within the congestion window, and
+  delivers the stream intact.
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "../TcpMain.h"
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME      "TCP Lossy Trace Unit Tests"
+#define UNIT_TEST_APP_VERSION   "1.0"
+
+#define TCP_TEST_SEGMENTS       64
+#define TCP_TEST_BUF_SIZE       (256 * 1024)
+#define TCP_TEST_MAX_PACKET     1480
+#define TCP_TEST_CLIENT_PORT    49152
+#define TCP_TEST_SERVER_PORT    80
+#define TCP_TEST_MAX_ROUNDS     200
+
+///
+/// A segment on the wire.
+///
+typedef struct {
+  LIST_ENTRY      Link;
+  NET_BUF         *Nbuf;
+  EFI_IP_ADDRESS  Src;
+  EFI_IP_ADDRESS  Dst;
+} TCP_TEST_PACKET;
+
+///
+/// What a trace drops, and what the wire saw of it.
+///
+typedef struct {
+  UINT8     Drop[TCP_TEST_SEGMENTS];     ///< Transmissions of each data segment to drop.
+  UINT8     Xmit[TCP_TEST_SEGMENTS];     ///< Transmissions of each data segment.
+  BOOLEAN   Received[TCP_TEST_SEGMENTS]; ///< TRUE once a copy got through.
+  TCP_SEQNO HighSent;                    ///< The sequence after the last data sent.
+  UINT32    Retransmits;                 ///< Data segments sent again.
+  UINT32    Spurious;                    ///< Retransmissions of data already received.
+  UINT32    RecoverySends;               ///< New data sent in SACK recovery.
+  UINT32    PipeOverflows;               ///< New data sent in SACK recovery beyond CWnd.
+  UINT32    SackAcks;                    ///< Server segments carrying SACK blocks.
+  BOOLEAN   Recovery;                    ///< TRUE if the client entered fast recovery.
+  BOOLEAN   Timeout;                     ///< TRUE if the retransmission timer expired.
+} TCP_TEST_TRACE;
+
+/**
+  The heartbeat of TcpTimer.c, queued as a DPC by the TCP driver.
+
+  @param[in]  Context   Context of the timer event, ignored.
+
+**/
+VOID
+EFIAPI
+TcpTickingDpc (
+  IN VOID       *Context
+  );
+
+//
+// NetBuffer.c frees the data blocks through the boot services, which only
+// provide FreePool here: the accepted connection fails to build its device
+// path before installing it.
+//
+EFI_BOOT_SERVICES  *gBS;
+
+STATIC EFI_BOOT_SERVICES  mTestBootServices;
+
+STATIC EFI_IPv4_ADDRESS  mClientIp = {{ 192, 168, 0, 1 }};
+STATIC EFI_IPv4_ADDRESS  mServerIp = {{ 192, 168, 0, 2 }};
+
+STATIC EFI_IP4_PROTOCOL  mTestIp4;
+STATIC IP_IO             mTestIpIo;
+STATIC IP_IO_IP_INFO     mTestIpInfo;
+STATIC TCP_SERVICE_DATA  mTestService;
+STATIC LIST_ENTRY        mTestWire;
+STATIC TCP_TEST_TRACE    mTrace;
+
+STATIC TCP_CB            *mClient;
+STATIC TCP_CB            *mListen;
+STATIC TCP_CB            *mServer;
+STATIC SOCKET            *mServerSock;
+STATIC UINT32            mStreamSize;
+
+/**
+  Free the data blocks of a NET_BUF.
+
+  @param[in]  Buffer    The pool to free.
+
+  @retval EFI_SUCCESS    Always.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TcpTestFreePool (
+  IN VOID  *Buffer
+  )
+{
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+/**
+  Report the IP packet size to TcpGetRcvMss.
+
+  @param[in]   This          Pointer to the EFI_IP4_PROTOCOL instance.
+  @param[out]  Ip4ModeData   Pointer to the EFI IPv4 Protocol mode data structure.
+  @param[out]  MnpConfigData Pointer to the managed network configuration data structure.
+  @param[out]  SnpModeData   Pointer to the simple network mode data structure.
+
+  @retval EFI_SUCCESS    Always.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TcpTestIp4GetModeData (
+  IN CONST  EFI_IP4_PROTOCOL                *This,
+  OUT       EFI_IP4_MODE_DATA               *Ip4ModeData     OPTIONAL,
+  OUT       EFI_MANAGED_NETWORK_CONFIG_DATA *MnpConfigData   OPTIONAL,
+  OUT       EFI_SIMPLE_NETWORK_MODE         *SnpModeData     OPTIONAL
+  )
+{
+  if (Ip4ModeData != NULL) {
+    Ip4ModeData->MaxPacketSize = TCP_TEST_MAX_PACKET;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Record a data segment sent by the client, and decide whether the wire
+  drops it.
+
+  @param[in]  Head     The TCP head of the segment.
+  @param[in]  Len      The length of the data in the segment.
+
+  @retval TRUE     The trace drops the segment.
+  @retval FALSE    The segment goes through.
+
+**/
+STATIC
+BOOLEAN
+TcpTestClientData (
+  IN TCP_HEAD  *Head,
+  IN UINT32    Len
+  )
+{
+  TCP_SEQNO  Seq;
+  UINT32     Index;
+
+  Seq   = NTOHL (Head->Seq);
+  Index = TCP_SUB_SEQ (Seq, mClient->Iss + 1) / mClient->SndMss;
+  ASSERT (Index < TCP_TEST_SEGMENTS);
+
+  if (TCP_SEQ_LT (Seq, mTrace.HighSent)) {
+    mTrace.Retransmits++;
+    if (mTrace.Received[Index]) {
+      mTrace.Spurious++;
+    }
+  } else {
+    //
+    // TcpToSendData hasn't moved SndNxt past this segment yet.
+    //
+    if (TCP_FLG_ON (mClient->CtrlFlag, TCP_CTRL_SND_SACK) &&
+        (mClient->CongestState == TCP_CONGEST_RECOVER)) {
+      mTrace.RecoverySends++;
+      if (TcpSackPipe (mClient) + Len > mClient->CWnd) {
+        mTrace.PipeOverflows++;
+      }
+    }
+
+    mTrace.HighSent = Seq + Len;
+  }
+
+  mTrace.Xmit[Index]++;
+  if (mTrace.Xmit[Index] <= mTrace.Drop[Index]) {
+    return TRUE;
+  }
+
+  mTrace.Received[Index] = TRUE;
+  return FALSE;
+}
+
+/**
+  Put a segment sent by TcpSendIpPacket on the wire, unless the trace
+  drops it. The caller keeps the packet, so the wire holds a copy.
+
+  @param[in, out]  IpIo          Pointer to an IP_IO instance used for sending IP
+                                 packet.
+  @param[in, out]  Pkt           Pointer to the IP packet to be sent.
+  @param[in]       Sender        The IP protocol instance used for sending.
+  @param[in]       Context       Optional context data.
+  @param[in]       NotifyData    Optional notify data.
+  @param[in]       Dest          The destination IP address to send this packet to.
+  @param[in]       OverrideData  The data to override some configuration of the IP
+                                 instance used for sending.
+
+  @retval EFI_SUCCESS    Always.
+
+**/
+EFI_STATUS
+EFIAPI
+IpIoSend (
+  IN OUT IP_IO          *IpIo,
+  IN OUT NET_BUF        *Pkt,
+  IN     IP_IO_IP_INFO  *Sender        OPTIONAL,
+  IN     VOID           *Context       OPTIONAL,
+  IN     VOID           *NotifyData    OPTIONAL,
+  IN     EFI_IP_ADDRESS *Dest          OPTIONAL,
+  IN     IP_IO_OVERRIDE *OverrideData  OPTIONAL
+  )
+{
+  TCP_TEST_PACKET  *Packet;
+  TCP_HEAD         *Head;
+  TCP_OPTION       Option;
+  UINT8            *Data;
+  UINT32           Len;
+
+  ASSERT ((Dest != NULL) && (OverrideData != NULL));
+
+  Packet = AllocateZeroPool (sizeof (TCP_TEST_PACKET));
+  ASSERT (Packet != NULL);
+
+  Packet->Nbuf = NetbufAlloc (Pkt->TotalSize);
+  ASSERT (Packet->Nbuf != NULL);
+
+  Data = NetbufAllocSpace (Packet->Nbuf, Pkt->TotalSize, NET_BUF_TAIL);
+  NetbufCopy (Pkt, 0, Pkt->TotalSize, Data);
+  CopyMem (&Packet->Src, &OverrideData->Ip4OverrideData.SourceAddress, sizeof (EFI_IPv4_ADDRESS));
+  CopyMem (&Packet->Dst, Dest, sizeof (EFI_IPv4_ADDRESS));
+
+  Head = (TCP_HEAD *) Data;
+  Len  = Pkt->TotalSize - (Head->HeadLen << 2);
+
+  if (EFI_IP4_EQUAL (&Packet->Src.v4, &mClientIp)) {
+    if ((Len != 0) && TcpTestClientData (Head, Len)) {
+      NetbufFree (Packet->Nbuf);
+      FreePool (Packet);
+      return EFI_SUCCESS;
+    }
+  } else if ((TcpParseOption (Head, &Option) == 0) && (Option.SackNum != 0)) {
+    mTrace.SackAcks++;
+  }
+
+  InsertTailList (&mTestWire, &Packet->Link);
+  return EFI_SUCCESS;
+}
+
+/**
+  Find the IP instance to send a segment of no TCB, such as a reset.
+
+  @param[in, out]  IpIo         Pointer to the IP_IO found.
+  @param[in]       IpVersion    The version of the IP protocol.
+  @param[in]       Src          The source IP address.
+
+  @return The test IP instance.
+
+**/
+IP_IO_IP_INFO *
+EFIAPI
+IpIoFindSender (
+  IN OUT IP_IO           **IpIo,
+  IN     UINT8           IpVersion,
+  IN     EFI_IP_ADDRESS  *Src
+  )
+{
+  *IpIo = &mTestIpIo;
+  return &mTestIpInfo;
+}
+
+/**
+  Map an ICMP error, which the wire never carries.
+
+  @param[in]   IcmpError             IcmpError Type.
+  @param[in]   IpVersion             The version of the IP protocol.
+  @param[out]  IsHard                If TRUE, indicates that it is a hard error.
+  @param[out]  Notify                If TRUE, SockError needs to be notified.
+
+  @retval EFI_UNSUPPORTED    Always.
+
+**/
+EFI_STATUS
+EFIAPI
+IpIoGetIcmpErrStatus (
+  IN  UINT8       IcmpError,
+  IN  UINT8       IpVersion,
+  OUT BOOLEAN     *IsHard  OPTIONAL,
+  OUT BOOLEAN     *Notify  OPTIONAL
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Refresh the IPv6 neighbor cache, which the IPv4 wire doesn't have.
+
+  @param[in]  IpIo            Pointer to an IP_IO instance.
+  @param[in]  Neighbor        The IP address of the neighbor.
+  @param[in]  Timeout         Time in 100-ns units that this entry will remain
+                              in the neighbor cache.
+
+  @retval EFI_UNSUPPORTED    Always.
+
+**/
+EFI_STATUS
+EFIAPI
+IpIoRefreshNeighbor (
+  IN IP_IO           *IpIo,
+  IN EFI_IP_ADDRESS  *Neighbor,
+  IN UINT32          Timeout
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Queue a DPC. The tests call TcpTickingDpc themselves.
+
+  @param[in]  DpcTpl        The EFI_TPL that the DPC should be invoked.
+  @param[in]  DpcProcedure  Pointer to the DPC's function.
+  @param[in]  DpcContext    Pointer to the DPC's context.
+
+  @retval EFI_SUCCESS    Always.
+
+**/
+EFI_STATUS
+EFIAPI
+QueueDpc (
+  IN EFI_TPL            DpcTpl,
+  IN EFI_DPC_PROCEDURE  DpcProcedure,
+  IN VOID               *DpcContext    OPTIONAL
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Build the IPv4 device path node of an accepted connection.
+
+  @param[in, out]  Node                  The pointer to the IPv4 device path node.
+  @param[in]       Controller            The controller handle.
+  @param[in]       LocalIp               The local IPv4 address.
+  @param[in]       LocalPort             The local port.
+  @param[in]       RemoteIp              The remote IPv4 address.
+  @param[in]       RemotePort            The remote port.
+  @param[in]       Protocol              The protocol type in the IP header.
+  @param[in]       UseDefaultAddress     Whether this instance is using default address or not.
+
+**/
+VOID
+EFIAPI
+NetLibCreateIPv4DPathNode (
+  IN OUT IPv4_DEVICE_PATH  *Node,
+  IN EFI_HANDLE            Controller,
+  IN IP4_ADDR              LocalIp,
+  IN UINT16                LocalPort,
+  IN IP4_ADDR              RemoteIp,
+  IN UINT16                RemotePort,
+  IN UINT16                Protocol,
+  IN BOOLEAN               UseDefaultAddress
+  )
+{
+  ZeroMem (Node, sizeof (IPv4_DEVICE_PATH));
+}
+
+/**
+  Build the IPv6 device path node of an accepted connection.
+
+  @param[in, out]  Node                  The pointer to the IPv6 device path node.
+  @param[in]       Controller            The controller handle.
+  @param[in]       LocalIp               The local IPv6 address.
+  @param[in]       LocalPort             The local port.
+  @param[in]       RemoteIp              The remote IPv6 address.
+  @param[in]       RemotePort            The remote port.
+  @param[in]       Protocol              The protocol type in the IP header.
+
+**/
+VOID
+EFIAPI
+NetLibCreateIPv6DPathNode (
+  IN OUT IPv6_DEVICE_PATH  *Node,
+  IN EFI_HANDLE            Controller,
+  IN EFI_IPv6_ADDRESS      *LocalIp,
+  IN UINT16                LocalPort,
+  IN EFI_IPv6_ADDRESS      *RemoteIp,
+  IN UINT16                RemotePort,
+  IN UINT16                Protocol
+  )
+{
+  ZeroMem (Node, sizeof (IPv6_DEVICE_PATH));
+}
+
+/**
+  Append a device path node. The sockets have no parent device path, so the
+  accepted connection goes without one.
+
+  @param[in]  DevicePath       A pointer to a device path data structure.
+  @param[in]  DevicePathNode   A pointer to a single device path node.
+
+  @retval NULL    Always.
+
+**/
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+AppendDevicePathNode (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath,     OPTIONAL
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePathNode  OPTIONAL
+  )
+{
+  return NULL;
+}
+
+/**
+  Remove the first node entry on the list, for NetBuffer.c. The rest of
+  DxeNetLib.c isn't linked.
+
+  @param[in, out]  Head                  The list header.
+
+  @return The first node entry that is removed from the list, NULL if the list is empty.
+
+**/
+LIST_ENTRY *
+EFIAPI
+NetListRemoveHead (
+  IN OUT LIST_ENTRY            *Head
+  )
+{
+  LIST_ENTRY  *First;
+
+  if (IsListEmpty (Head)) {
+    return NULL;
+  }
+
+  First = Head->ForwardLink;
+  RemoveEntryList (First);
+
+  return First;
+}
+
+/**
+  Create a socket of the test, with empty buffers.
+
+  @param[in]  Parent    The listening socket, or NULL.
+
+  @return The socket created.
+
+**/
+STATIC
+SOCKET *
+TcpTestCreateSocket (
+  IN SOCKET  *Parent
+  )
+{
+  SOCKET          *Sock;
+  TCP_PROTO_DATA  *ProtoData;
+
+  Sock = AllocateZeroPool (sizeof (SOCKET));
+  ASSERT (Sock != NULL);
+
+  Sock->Type                 = SockStream;
+  Sock->State                = SO_CLOSED;
+  Sock->IpVersion            = IP_VERSION_4;
+  Sock->Parent               = Parent;
+  Sock->SndBuffer.HighWater  = TCP_TEST_BUF_SIZE;
+  Sock->RcvBuffer.HighWater  = TCP_TEST_BUF_SIZE;
+  Sock->SndBuffer.DataQueue  = NetbufQueAlloc ();
+  Sock->RcvBuffer.DataQueue  = NetbufQueAlloc ();
+  ASSERT ((Sock->SndBuffer.DataQueue != NULL) && (Sock->RcvBuffer.DataQueue != NULL));
+
+  InitializeListHead (&Sock->Link);
+  InitializeListHead (&Sock->ConnectionList);
+  InitializeListHead (&Sock->ListenTokenList);
+  InitializeListHead (&Sock->RcvTokenList);
+  InitializeListHead (&Sock->SndTokenList);
+  InitializeListHead (&Sock->ProcessingSndTokenList);
+
+  ProtoData             = (TCP_PROTO_DATA *) Sock->ProtoReserved;
+  ProtoData->TcpService = &mTestService;
+
+  return Sock;
+}
+
+/**
+  Clone the listening socket for a connection request.
+
+  @param[in]  Sock                  Pointer to the socket to be cloned.
+
+  @return Pointer to the newly cloned socket.
+
+**/
+SOCKET *
+SockClone (
+  IN SOCKET *Sock
+  )
+{
+  mServerSock        = TcpTestCreateSocket (Sock);
+  mServerSock->State = SO_CONNECTING;
+
+  return mServerSock;
+}
+
+/**
+  Called by the low layer protocol to indicate the socket a connection is
+  established.
+
+  @param[in, out]  Sock         Pointer to the socket associated with the
+                                established connection.
+
+**/
+VOID
+SockConnEstablished (
+  IN OUT SOCKET *Sock
+  )
+{
+  Sock->State = SO_CONNECTED;
+}
+
+/**
+  Called by the low layer protocol to indicate that the connection is closed.
+
+  @param[in, out]  Sock         Pointer to the socket associated with the closed
+                                connection.
+
+**/
+VOID
+SockConnClosed (
+  IN OUT SOCKET *Sock
+  )
+{
+  Sock->State = SO_CLOSED;
+}
+
+/**
+  Trim the data moved from the socket send buffer to the TCB.
+
+  @param[in, out]  Sock          Pointer to the socket.
+  @param[in]       Count         The length of the data processed or sent, in bytes.
+
+**/
+VOID
+SockDataSent (
+  IN OUT SOCKET     *Sock,
+  IN     UINT32     Count
+  )
+{
+  ASSERT (Count <= Sock->SndBuffer.DataQueue->BufSize);
+
+  NetbufQueTrim (Sock->SndBuffer.DataQueue, Count);
+}
+
+/**
+  Copy the data to send from the socket send buffer.
+
+  @param[in]  Sock           Pointer to the socket.
+  @param[in]  Offset         The start point of the data to be copied.
+  @param[in]  Len            The length of the data to be copied.
+  @param[out] Dest           Pointer to the destination to copy the data.
+
+  @return The data size copied.
+
+**/
+UINT32
+SockGetDataToSend (
+  IN  SOCKET      *Sock,
+  IN  UINT32      Offset,
+  IN  UINT32      Len,
+  OUT UINT8       *Dest
+  )
+{
+  return NetbufQueCopy (Sock->SndBuffer.DataQueue, Offset, Len, Dest);
+}
+
+/**
+  Append the data delivered by TCP to the socket receive buffer.
+
+  @param[in, out]  Sock         Pointer to the socket.
+  @param[in, out]  NetBuffer    Pointer to the buffer that contains the received data.
+  @param[in]       UrgLen       The length of the urgent data in the received data.
+
+**/
+VOID
+SockDataRcvd (
+  IN OUT SOCKET    *Sock,
+  IN OUT NET_BUF   *NetBuffer,
+  IN     UINT32    UrgLen
+  )
+{
+  NET_GET_REF (NetBuffer);
+  ((TCP_RSV_DATA *) (NetBuffer->ProtoData))->UrgLen = UrgLen;
+  NetbufQueAppend (Sock->RcvBuffer.DataQueue, NetBuffer);
+}
+
+/**
+  Get the length of the free space of the specific socket buffer.
+
+  @param[in]  Sock              Pointer to the socket.
+  @param[in]  Which             Flag to indicate which socket buffer to check:
+                                either send buffer or receive buffer.
+
+  @return The length of the free space, in bytes.
+
+**/
+UINT32
+SockGetFreeSpace (
+  IN SOCKET  *Sock,
+  IN UINT32  Which
+  )
+{
+  SOCK_BUFFER  *SockBuffer;
+
+  SockBuffer = (Which == SOCK_SND_BUF) ? &Sock->SndBuffer : &Sock->RcvBuffer;
+  if (SockBuffer->DataQueue->BufSize >= SockBuffer->HighWater) {
+    return 0;
+  }
+
+  return SockBuffer->HighWater - SockBuffer->DataQueue->BufSize;
+}
+
+/**
+  Called by the low layer protocol to indicate that there will be no more data
+  from the communication peer.
+
+  @param[in, out]  Sock             Pointer to the socket.
+
+**/
+VOID
+SockNoMoreData (
+  IN OUT SOCKET *Sock
+  )
+{
+  SOCK_NO_MORE_DATA (Sock);
+}
+
+/**
+  Create a TCB bound to an address, configured as TcpConfigurePcb does by
+  default, but without Nagle and keep alive.
+
+  @param[in]  Ip        The local address.
+  @param[in]  Port      The local port.
+  @param[in]  Sack      If FALSE, the TCB doesn't negotiate SACK.
+
+  @return The TCB created.
+
+**/
+STATIC
+TCP_CB *
+TcpTestCreateTcb (
+  IN EFI_IPv4_ADDRESS  *Ip,
+  IN UINT16            Port,
+  IN BOOLEAN           Sack
+  )
+{
+  TCP_CB  *Tcb;
+
+  Tcb = AllocateZeroPool (sizeof (TCP_CB));
+  ASSERT (Tcb != NULL);
+
+  InitializeListHead (&Tcb->List);
+  InitializeListHead (&Tcb->SndQue);
+  InitializeListHead (&Tcb->RcvQue);
+
+  Tcb->Sk     = TcpTestCreateSocket (NULL);
+  Tcb->IpInfo = &mTestIpInfo;
+  NET_GET_REF (Tcb->IpInfo);
+  ((TCP_PROTO_DATA *) Tcb->Sk->ProtoReserved)->TcpPcb = Tcb;
+
+  TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_KEEPALIVE | TCP_CTRL_NO_NAGLE);
+  if (!Sack) {
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
+  }
+
+  Tcb->State           = TCP_CLOSED;
+  Tcb->SndMss          = 536;
+  Tcb->RcvMss          = TcpGetRcvMss (Tcb->Sk);
+  Tcb->Rto             = 3 * TCP_TICK_HZ;
+  Tcb->CWnd            = Tcb->SndMss;
+  Tcb->Ssthresh        = 0xffffffff;
+  Tcb->CongestState    = TCP_CONGEST_OPEN;
+  TcpCongestionInit (Tcb);
+
+  Tcb->KeepAliveIdle   = TCP_KEEPALIVE_IDLE_MIN;
+  Tcb->KeepAlivePeriod = TCP_KEEPALIVE_PERIOD;
+  Tcb->MaxKeepAlive    = TCP_MAX_KEEPALIVE;
+  Tcb->MaxRexmit       = TCP_MAX_LOSS;
+  Tcb->FinWait2Timeout = TCP_FIN_WAIT2_TIME;
+  Tcb->TimeWaitTimeout = TCP_TIME_WAIT_TIME;
+  Tcb->ConnectTimeout  = TCP_CONNECT_TIME;
+  Tcb->Ttl             = 64;
+
+  IP4_COPY_ADDRESS (&Tcb->LocalEnd.Ip.v4, Ip);
+  Tcb->LocalEnd.Port = HTONS (Port);
+
+  return Tcb;
+}
+
+/**
+  Free a TCB, its socket and the data they hold.
+
+  @param[in]  Tcb       The TCB to free, or NULL.
+
+**/
+STATIC
+VOID
+TcpTestFreeTcb (
+  IN TCP_CB  *Tcb
+  )
+{
+  if (Tcb == NULL) {
+    return;
+  }
+
+  RemoveEntryList (&Tcb->List);
+  NetbufFreeList (&Tcb->SndQue);
+  NetbufFreeList (&Tcb->RcvQue);
+  NetbufQueFree (Tcb->Sk->SndBuffer.DataQueue);
+  NetbufQueFree (Tcb->Sk->RcvBuffer.DataQueue);
+  FreePool (Tcb->Sk);
+  FreePool (Tcb);
+}
+
+/**
+  Note the congestion state of the client.
+
+**/
+STATIC
+VOID
+TcpTestObserve (
+  VOID
+  )
+{
+  if (mClient->CongestState == TCP_CONGEST_RECOVER) {
+    mTrace.Recovery = TRUE;
+  } else if (mClient->CongestState == TCP_CONGEST_LOSS) {
+    mTrace.Timeout = TRUE;
+  }
+}
+
+/**
+  Hand the segments on the wire to TcpInput, in the order they were sent,
+  until the wire is idle.
+
+**/
+STATIC
+VOID
+TcpTestDeliver (
+  VOID
+  )
+{
+  TCP_TEST_PACKET  *Packet;
+
+  while (!IsListEmpty (&mTestWire)) {
+    Packet = NET_LIST_HEAD (&mTestWire, TCP_TEST_PACKET, Link);
+    RemoveEntryList (&Packet->Link);
+
+    TcpInput (Packet->Nbuf, &Packet->Src, &Packet->Dst, IP_VERSION_4);
+    FreePool (Packet);
+
+    TcpTestObserve ();
+  }
+}
+
+/**
+  Reset the wire, the trace and the TCP queues.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED     Always.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TcpTestReset (
+  IN UNIT_TEST_CONTEXT Context
+  )
+{
+  ZeroMem (&mTrace, sizeof (mTrace));
+  InitializeListHead (&mTestWire);
+  InitializeListHead (&mTcpRunQue);
+  InitializeListHead (&mTcpListenQue);
+
+  ZeroMem (&mTestBootServices, sizeof (mTestBootServices));
+  mTestBootServices.FreePool = TcpTestFreePool;
+  gBS                        = &mTestBootServices;
+
+  ZeroMem (&mTestIp4, sizeof (mTestIp4));
+  mTestIp4.GetModeData = TcpTestIp4GetModeData;
+
+  ZeroMem (&mTestIpIo, sizeof (mTestIpIo));
+  mTestIpIo.IpVersion = IP_VERSION_4;
+  mTestIpIo.Ip.Ip4    = &mTestIp4;
+
+  ZeroMem (&mTestIpInfo, sizeof (mTestIpInfo));
+  mTestIpInfo.IpVersion = IP_VERSION_4;
+  mTestIpInfo.RefCnt    = 1;
+
+  ZeroMem (&mTestService, sizeof (mTestService));
+  mTestService.IpVersion = IP_VERSION_4;
+  mTestService.IpIo      = &mTestIpIo;
+
+  mClient     = NULL;
+  mListen     = NULL;
+  mServer     = NULL;
+  mServerSock = NULL;
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the connections and the segments left on the wire.
+
+  @param[in]  Context    Unused.
+
+**/
+STATIC
+VOID
+EFIAPI
+TcpTestCleanup (
+  IN UNIT_TEST_CONTEXT Context
+  )
+{
+  TCP_TEST_PACKET  *Packet;
+
+  while (!IsListEmpty (&mTestWire)) {
+    Packet = NET_LIST_HEAD (&mTestWire, TCP_TEST_PACKET, Link);
+    RemoveEntryList (&Packet->Link);
+    NetbufFree (Packet->Nbuf);
+    FreePool (Packet);
+  }
+
+  TcpTestFreeTcb (mClient);
+  TcpTestFreeTcb (mServer);
+  TcpTestFreeTcb (mListen);
+}
+
+/**
+  Open a connection from the client to a listening server, through the
+  three way handshake.
+
+  @param[in]  Sack      If FALSE, the client doesn't negotiate SACK.
+
+  @retval TRUE     Both ends are established.
+  @retval FALSE    Otherwise.
+
+**/
+STATIC
+BOOLEAN
+TcpTestConnect (
+  IN BOOLEAN  Sack
+  )
+{
+  mListen = TcpTestCreateTcb (&mServerIp, TCP_TEST_SERVER_PORT, TRUE);
+  TcpSetState (mListen, TCP_LISTEN);
+  mListen->Sk->State = SO_LISTENING;
+  TcpInsertTcb (mListen);
+
+  mClient = TcpTestCreateTcb (&mClientIp, TCP_TEST_CLIENT_PORT, Sack);
+  IP4_COPY_ADDRESS (&mClient->RemoteEnd.Ip.v4, &mServerIp);
+  mClient->RemoteEnd.Port = HTONS (TCP_TEST_SERVER_PORT);
+  TcpInsertTcb (mClient);
+
+  TcpOnAppConnect (mClient);
+  TcpTestDeliver ();
+
+  if (mServerSock == NULL) {
+    return FALSE;
+  }
+
+  mServer = ((TCP_PROTO_DATA *) mServerSock->ProtoReserved)->TcpPcb;
+
+  return (BOOLEAN) ((mClient->State == TCP_ESTABLISHED) && (mServer->State == TCP_ESTABLISHED));
+}
+
+/**
+  Send TCP_TEST_SEGMENTS full segments from the client, and run the wire
+  and the heartbeat until the server has them all and the client has
+  seen them acknowledged.
+
+  @retval TRUE     The transfer completed.
+  @retval FALSE    It didn't within TCP_TEST_MAX_ROUNDS heartbeats.
+
+**/
+STATIC
+BOOLEAN
+TcpTestTransfer (
+  VOID
+  )
+{
+  NET_BUF  *Nbuf;
+  UINT8    *Data;
+  UINT32   Index;
+  UINT32   Round;
+
+  mStreamSize = TCP_TEST_SEGMENTS * mClient->SndMss;
+
+  Nbuf = NetbufAlloc (mStreamSize);
+  ASSERT (Nbuf != NULL);
+
+  Data = NetbufAllocSpace (Nbuf, mStreamSize, NET_BUF_TAIL);
+  for (Index = 0; Index < mStreamSize; Index++) {
+    Data[Index] = (UINT8) (Index % 251);
+  }
+
+  NetbufQueAppend (mClient->Sk->SndBuffer.DataQueue, Nbuf);
+  TcpOnAppSend (mClient);
+
+  for (Round = 0; Round < TCP_TEST_MAX_ROUNDS; Round++) {
+    TcpTestDeliver ();
+
+    if ((mServer->Sk->RcvBuffer.DataQueue->BufSize == mStreamSize) &&
+        (mClient->SndUna == mClient->SndNxt)) {
+      return TRUE;
+    }
+
+    TcpTickingDpc (NULL);
+    TcpTestObserve ();
+  }
+
+  return FALSE;
+}
+
+/**
+  Check the server received the stream sent in order.
+
+  @retval TRUE     The stream is intact.
+  @retval FALSE    Otherwise.
+
+**/
+STATIC
+BOOLEAN
+TcpTestStreamIntact (
+  VOID
+  )
+{
+  UINT8    *Data;
+  UINT32   Index;
+  BOOLEAN  Intact;
+
+  Data = AllocatePool (mStreamSize);
+  ASSERT (Data != NULL);
+
+  Intact = (BOOLEAN) (NetbufQueCopy (mServer->Sk->RcvBuffer.DataQueue, 0, mStreamSize, Data) == mStreamSize);
+  for (Index = 0; Intact && (Index < mStreamSize); Index++) {
+    Intact = (BOOLEAN) (Data[Index] == (UINT8) (Index % 251));
+  }
+
+  FreePool (Data);
+  return Intact;
+}
+
+/**
+  Two adjacent segments are lost. The server SACKs the segments above them,
+  the client enters SACK recovery on the duplicate threshold, and sends the
+  two segments again, and nothing else.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The recovery is as expected.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  Otherwise.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TcpTestTraceSackRecovery (
+  IN UNIT_TEST_CONTEXT Context
+  )
+{
+  mTrace.Drop[20] = 1;
+  mTrace.Drop[21] = 1;
+
+  UT_ASSERT_TRUE (TcpTestConnect (TRUE));
+  UT_ASSERT_TRUE (TCP_FLG_ON (mClient->CtrlFlag, TCP_CTRL_SND_SACK));
+  UT_ASSERT_TRUE (TCP_FLG_ON (mServer->CtrlFlag, TCP_CTRL_SND_SACK));
+
+  UT_ASSERT_TRUE (TcpTestTransfer ());
+  UT_ASSERT_TRUE (TcpTestStreamIntact ());
+
+  UT_ASSERT_NOT_EQUAL (mTrace.SackAcks, 0);
+  UT_ASSERT_TRUE (mTrace.Recovery);
+  UT_ASSERT_FALSE (mTrace.Timeout);
+  UT_ASSERT_EQUAL (mTrace.Retransmits, 2);
+  UT_ASSERT_EQUAL (mTrace.Xmit[20], 2);
+  UT_ASSERT_EQUAL (mTrace.Xmit[21], 2);
+  UT_ASSERT_EQUAL (mTrace.Spurious, 0);
+  UT_ASSERT_NOT_EQUAL (mTrace.RecoverySends, 0);
+  UT_ASSERT_EQUAL (mTrace.PipeOverflows, 0);
+  UT_ASSERT_EQUAL (mClient->CongestState, TCP_CONGEST_OPEN);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Scattered segments are lost, one of them twice. RACK finds the lost
+  retransmission before the retransmission timer expires, and no segment
+  the server has is sent again.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The recovery is as expected.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  Otherwise.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TcpTestTraceLostRetransmit (
+  IN UNIT_TEST_CONTEXT Context
+  )
+{
+  mTrace.Drop[20] = 2;
+  mTrace.Drop[24] = 1;
+  mTrace.Drop[40] = 1;
+
+  UT_ASSERT_TRUE (TcpTestConnect (TRUE));
+
+  UT_ASSERT_TRUE (TcpTestTransfer ());
+  UT_ASSERT_TRUE (TcpTestStreamIntact ());
+
+  UT_ASSERT_TRUE (mTrace.Recovery);
+  UT_ASSERT_FALSE (mTrace.Timeout);
+  UT_ASSERT_EQUAL (mTrace.Xmit[20], 3);
+  UT_ASSERT_EQUAL (mTrace.Xmit[24], 2);
+  UT_ASSERT_EQUAL (mTrace.Xmit[40], 2);
+  UT_ASSERT_EQUAL (mTrace.Retransmits, 4);
+  UT_ASSERT_EQUAL (mTrace.Spurious, 0);
+  UT_ASSERT_EQUAL (mTrace.PipeOverflows, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Without SACK negotiated, the server sends no SACK blocks and the NewReno
+  recovery still repairs the stream.
+
+  @param[in]  Context    Unused.
+
+  @retval UNIT_TEST_PASSED             The recovery is as expected.
+  @retval UNIT_TEST_ERROR_TEST_FAILED  Otherwise.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TcpTestTraceNoSack (
+  IN UNIT_TEST_CONTEXT Context
+  )
+{
+  mTrace.Drop[20] = 1;
+
+  UT_ASSERT_TRUE (TcpTestConnect (FALSE));
+  UT_ASSERT_FALSE (TCP_FLG_ON (mClient->CtrlFlag, TCP_CTRL_SND_SACK));
+  UT_ASSERT_FALSE (TCP_FLG_ON (mServer->CtrlFlag, TCP_CTRL_SND_SACK));
+
+  UT_ASSERT_TRUE (TcpTestTransfer ());
+  UT_ASSERT_TRUE (TcpTestStreamIntact ());
+
+  UT_ASSERT_EQUAL (mTrace.SackAcks, 0);
+  UT_ASSERT_TRUE (mTrace.Recovery);
+  UT_ASSERT_EQUAL (mTrace.Xmit[20], 2);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialze the unit test framework, suite, and unit tests for the lossy
+  traces and run them.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      TraceTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&TraceTests, Framework, "TCP Lossy Trace Tests", "Tcp.Trace", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for TraceTests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-------Description----------------------------------------------------Name--------------Function--------------------Pre-----------Post------------Context-----------
+  //
+  AddTestCase (TraceTests, "SACK recovery retransmits only the lost segments",              "SackRecovery",   TcpTestTraceSackRecovery,   TcpTestReset, TcpTestCleanup, NULL);
+  AddTestCase (TraceTests, "A lost retransmission is recovered without spurious ones",      "LostRetransmit", TcpTestTraceLostRetransmit, TcpTestReset, TcpTestCleanup, NULL);
+  AddTestCase (TraceTests, "Without SACK the NewReno recovery repairs the stream",          "NoSack",         TcpTestTraceNoSack,         TcpTestReset, TcpTestCleanup, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int argc,
+  char *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -280,11 +280,27 @@ TlsGetSessionData (
 
   if (Instance->TlsSessionState == EfiTlsSessionNotStarted &&
     (DataType == EfiTlsSessionID || DataType == EfiTlsClientRandom ||
-    DataType == EfiTlsServerRandom || DataType == EfiTlsKeyMaterial)) {
+    DataType == EfiTlsServerRandom || DataType == EfiTlsKeyMaterial ||
+    DataType == EdkiiTlsSessionReused)) {
     Status = EFI_NOT_READY;
     goto ON_EXIT;
   }
 
+  //
+  // The EDK II specific type is outside of the enumeration, so it's not a
+  // case of the switch below.
+  //
+  if (DataType == EdkiiTlsSessionReused) {
+    if (*DataSize < sizeof (BOOLEAN)) {
+      *DataSize = sizeof (BOOLEAN);
+      Status = EFI_BUFFER_TOO_SMALL;
+      goto ON_EXIT;
+    }
+    *DataSize = sizeof (BOOLEAN);
+    *((BOOLEAN *) Data) = TlsSessionReused (Instance->TlsConn);
+    goto ON_EXIT;
+  }
+
   switch (DataType) {
   case EfiTlsVersion:
     if (*DataSize < sizeof (EFI_TLS_VERSION)) {
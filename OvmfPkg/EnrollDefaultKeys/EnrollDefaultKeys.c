@@ -21,6 +21,7 @@
 #include <Library/UefiLib.h>                     // AsciiPrint()
 #include <Library/UefiRuntimeServicesTableLib.h> // gRT
 #include <Protocol/Smbios.h>                     // EFI_SMBIOS_PROTOCOL
+#include <Protocol/VariableBatch.h>              // EDKII_VARIABLE_BATCH_PROTOCOL
 
 #include "EnrollDefaultKeys.h"
 
@@ -189,9 +190,15 @@ GetPkKek1 (
 
 
 /**
-  Enroll a set of certificates in a global variable, overwriting it.
+  Format a set of certificates for enrollment in a global variable, overwriting
+  it.
 
-  The variable will be rewritten with NV+BS+RT+AT attributes.
+  The variable is to be rewritten with NV+BS+RT+AT attributes.
+
+  @param[out] Entry        The variable to set, filled in with VariableName,
+                           VendorGuid, the attributes and the formatted
+                           payload. On success, the caller is responsible for
+                           releasing Entry->Data with FreePool().
 
   @param[in] VariableName  The name of the variable to overwrite.
 
@@ -225,16 +232,15 @@ GetPkKek1 (
   @retval EFI_OUT_OF_RESOURCES   Out of memory while formatting variable
                                  payload.
 
-  @retval EFI_SUCCESS            Enrollment successful; the variable has been
-                                 overwritten (or created).
+  @retval EFI_SUCCESS            Entry has been filled in.
 
-  @return                        Error codes from gRT->GetTime() and
-                                 gRT->SetVariable().
+  @return                        Error codes from gRT->GetTime().
 **/
 STATIC
 EFI_STATUS
 EFIAPI
-EnrollListOfCerts (
+FormatListOfCerts (
+  OUT EDKII_VARIABLE_BATCH_ENTRY *Entry,
   IN CHAR16   *VariableName,
   IN EFI_GUID *VendorGuid,
   IN EFI_GUID *CertType,
@@ -344,12 +350,15 @@ EnrollListOfCerts (
 
   ASSERT (Data + DataSize == Position);
 
-  Status = gRT->SetVariable (VariableName, VendorGuid,
-                  (EFI_VARIABLE_NON_VOLATILE |
-                   EFI_VARIABLE_BOOTSERVICE_ACCESS |
-                   EFI_VARIABLE_RUNTIME_ACCESS |
-                   EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS),
-                  DataSize, Data);
+  Entry->VariableName = VariableName;
+  Entry->VendorGuid   = VendorGuid;
+  Entry->Attributes   = (EFI_VARIABLE_NON_VOLATILE |
+                         EFI_VARIABLE_BOOTSERVICE_ACCESS |
+                         EFI_VARIABLE_RUNTIME_ACCESS |
+                         EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS);
+  Entry->DataSize     = DataSize;
+  Entry->Data         = Data;
+  return EFI_SUCCESS;
 
 FreeData:
   FreePool (Data);
@@ -363,6 +372,66 @@ Out:
 }
 
 
+/**
+  Set a number of variables, in order, stopping at the first failure.
+
+  When the variable driver provides EDKII_VARIABLE_BATCH_PROTOCOL, the
+  variables are set with a single call to it, so that an SMM based variable
+  driver is entered once per communicate buffer rather than once per variable.
+  Otherwise they are set one at a time with gRT->SetVariable().
+
+  @param[in] Count         The number of entries in Entries.
+
+  @param[in,out] Entries   The variables to set. The Status field of each
+                           entry is updated on return.
+
+  @retval EFI_SUCCESS      All the variables have been set.
+
+  @return                  Error codes from the batch protocol or from
+                           gRT->SetVariable(), for the first variable that
+                           could not be set.
+**/
+STATIC
+EFI_STATUS
+SetVariables (
+  IN     UINTN                      Count,
+  IN OUT EDKII_VARIABLE_BATCH_ENTRY *Entries
+  )
+{
+  EFI_STATUS                    Status;
+  EDKII_VARIABLE_BATCH_PROTOCOL *VariableBatch;
+  UINTN                         Index;
+
+  Status = gBS->LocateProtocol (&gEdkiiVariableBatchProtocolGuid, NULL,
+                  (VOID **)&VariableBatch);
+  if (!EFI_ERROR (Status)) {
+    Status = VariableBatch->SetVariables (VariableBatch, Count, Entries);
+  } else {
+    Status = EFI_SUCCESS;
+    for (Index = 0; Index < Count; Index++) {
+      if (EFI_ERROR (Status)) {
+        Entries[Index].Status = EFI_NOT_STARTED;
+        continue;
+      }
+      Status = gRT->SetVariable (Entries[Index].VariableName,
+                      Entries[Index].VendorGuid, Entries[Index].Attributes,
+                      Entries[Index].DataSize, Entries[Index].Data);
+      Entries[Index].Status = Status;
+    }
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    if (EFI_ERROR (Entries[Index].Status) &&
+        Entries[Index].Status != EFI_NOT_STARTED) {
+      AsciiPrint ("error: SetVariable(\"%s\", %g): %r\n",
+        Entries[Index].VariableName, Entries[Index].VendorGuid,
+        Entries[Index].Status);
+    }
+  }
+  return Status;
+}
+
+
 /**
   Read a UEFI variable into a caller-allocated buffer, enforcing an exact size.
 
@@ -533,6 +602,13 @@ ShellAppMain (
   UINT8      *PkKek1;
   UINTN      SizeOfPkKek1;
   BOOLEAN    NoDefault;
+  UINT8      EnterCustomMode;
+  UINT8      LeaveCustomMode;
+  UINTN      Count;
+  UINTN      FirstCert;
+  UINTN      Index;
+
+  EDKII_VARIABLE_BATCH_ENTRY Entries[6];
 
   if (Argc == 2 && StrCmp (Argv[1], L"--no-default") == 0) {
     NoDefault = TRUE;
@@ -575,35 +651,43 @@ ShellAppMain (
     return RetVal;
   }
 
+  //
+  // The variable writes below are collected in Entries, and set in order by
+  // one call to SetVariables().
+  //
+  ZeroMem (Entries, sizeof Entries);
+  Count = 0;
+
   //
   // Enter Custom Mode so we can enroll PK, KEK, db, and dbx without signature
   // checks on those variable writes.
   //
   if (Settings.CustomMode != CUSTOM_SECURE_BOOT_MODE) {
-    Settings.CustomMode = CUSTOM_SECURE_BOOT_MODE;
-    Status = gRT->SetVariable (EFI_CUSTOM_MODE_NAME, &gEfiCustomModeEnableGuid,
-                    (EFI_VARIABLE_NON_VOLATILE |
-                     EFI_VARIABLE_BOOTSERVICE_ACCESS),
-                    sizeof Settings.CustomMode, &Settings.CustomMode);
-    if (EFI_ERROR (Status)) {
-      AsciiPrint ("error: SetVariable(\"%s\", %g): %r\n", EFI_CUSTOM_MODE_NAME,
-        &gEfiCustomModeEnableGuid, Status);
-      goto FreePkKek1;
-    }
+    EnterCustomMode = CUSTOM_SECURE_BOOT_MODE;
+    Entries[Count].VariableName = EFI_CUSTOM_MODE_NAME;
+    Entries[Count].VendorGuid   = &gEfiCustomModeEnableGuid;
+    Entries[Count].Attributes   = (EFI_VARIABLE_NON_VOLATILE |
+                                   EFI_VARIABLE_BOOTSERVICE_ACCESS);
+    Entries[Count].DataSize     = sizeof EnterCustomMode;
+    Entries[Count].Data         = &EnterCustomMode;
+    Count++;
   }
+  FirstCert = Count;
 
   //
   // Enroll db.
   //
   if (NoDefault) {
-    Status = EnrollListOfCerts (
+    Status = FormatListOfCerts (
+               &Entries[Count],
                EFI_IMAGE_SECURITY_DATABASE,
                &gEfiImageSecurityDatabaseGuid,
                &gEfiCertX509Guid,
                PkKek1, SizeOfPkKek1, &gEfiCallerIdGuid,
                NULL);
   } else {
-    Status = EnrollListOfCerts (
+    Status = FormatListOfCerts (
+               &Entries[Count],
                EFI_IMAGE_SECURITY_DATABASE,
                &gEfiImageSecurityDatabaseGuid,
                &gEfiCertX509Guid,
@@ -612,34 +696,39 @@ ShellAppMain (
                NULL);
   }
   if (EFI_ERROR (Status)) {
-    goto FreePkKek1;
+    goto FreeEntries;
   }
+  Count++;
 
   //
   // Enroll dbx.
   //
-  Status = EnrollListOfCerts (
+  Status = FormatListOfCerts (
+             &Entries[Count],
              EFI_IMAGE_SECURITY_DATABASE1,
              &gEfiImageSecurityDatabaseGuid,
              &gEfiCertSha256Guid,
              mSha256OfDevNull, mSizeOfSha256OfDevNull, &gEfiCallerIdGuid,
              NULL);
   if (EFI_ERROR (Status)) {
-    goto FreePkKek1;
+    goto FreeEntries;
   }
+  Count++;
 
   //
   // Enroll KEK.
   //
   if (NoDefault) {
-    Status = EnrollListOfCerts (
+    Status = FormatListOfCerts (
+               &Entries[Count],
                EFI_KEY_EXCHANGE_KEY_NAME,
                &gEfiGlobalVariableGuid,
                &gEfiCertX509Guid,
                PkKek1, SizeOfPkKek1, &gEfiCallerIdGuid,
                NULL);
   } else {
-    Status = EnrollListOfCerts (
+    Status = FormatListOfCerts (
+               &Entries[Count],
                EFI_KEY_EXCHANGE_KEY_NAME,
                &gEfiGlobalVariableGuid,
                &gEfiCertX509Guid,
@@ -648,34 +737,42 @@ ShellAppMain (
                NULL);
   }
   if (EFI_ERROR (Status)) {
-    goto FreePkKek1;
+    goto FreeEntries;
   }
+  Count++;
 
   //
   // Enroll PK, leaving Setup Mode (entering User Mode) at once.
   //
-  Status = EnrollListOfCerts (
+  Status = FormatListOfCerts (
+             &Entries[Count],
              EFI_PLATFORM_KEY_NAME,
              &gEfiGlobalVariableGuid,
              &gEfiCertX509Guid,
              PkKek1, SizeOfPkKek1, &gEfiGlobalVariableGuid,
              NULL);
   if (EFI_ERROR (Status)) {
-    goto FreePkKek1;
+    goto FreeEntries;
   }
+  Count++;
 
   //
   // Leave Custom Mode, so that updates to PK, KEK, db, and dbx require valid
   // signatures.
   //
-  Settings.CustomMode = STANDARD_SECURE_BOOT_MODE;
-  Status = gRT->SetVariable (EFI_CUSTOM_MODE_NAME, &gEfiCustomModeEnableGuid,
-                  EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS,
-                  sizeof Settings.CustomMode, &Settings.CustomMode);
+  LeaveCustomMode = STANDARD_SECURE_BOOT_MODE;
+  Entries[Count].VariableName = EFI_CUSTOM_MODE_NAME;
+  Entries[Count].VendorGuid   = &gEfiCustomModeEnableGuid;
+  Entries[Count].Attributes   = (EFI_VARIABLE_NON_VOLATILE |
+                                 EFI_VARIABLE_BOOTSERVICE_ACCESS);
+  Entries[Count].DataSize     = sizeof LeaveCustomMode;
+  Entries[Count].Data         = &LeaveCustomMode;
+  Count++;
+  ASSERT (Count <= ARRAY_SIZE (Entries));
+
+  Status = SetVariables (Count, Entries);
   if (EFI_ERROR (Status)) {
-    AsciiPrint ("error: SetVariable(\"%s\", %g): %r\n", EFI_CUSTOM_MODE_NAME,
-      &gEfiCustomModeEnableGuid, Status);
-    goto FreePkKek1;
+    goto FreeEntries;
   }
 
   //
@@ -711,7 +808,7 @@ ShellAppMain (
   //
   Status = GetSettings (&Settings);
   if (EFI_ERROR (Status)) {
-    goto FreePkKek1;
+    goto FreeEntries;
   }
   PrintSettings (&Settings);
 
@@ -719,13 +816,18 @@ ShellAppMain (
       Settings.SecureBootEnable != 1 || Settings.CustomMode != 0 ||
       Settings.VendorKeys != 0) {
     AsciiPrint ("error: unexpected\n");
-    goto FreePkKek1;
+    goto FreeEntries;
   }
 
   AsciiPrint ("info: success\n");
   RetVal = 0;
 
-FreePkKek1:
+FreeEntries:
+  for (Index = FirstCert; Index < Count; Index++) {
+    if (Entries[Index].Data != &LeaveCustomMode) {
+      FreePool (Entries[Index].Data);
+    }
+  }
   FreePool (PkKek1);
 
   return RetVal;
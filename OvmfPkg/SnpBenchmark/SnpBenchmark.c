@@ -0,0 +1,309 @@
+/** @file
+  Measure the raw frame throughput of a Simple Network Protocol instance.
+
+  In transmit mode, full size broadcast frames of a local experimental
+  EtherType are sent for the given number of seconds, keeping as many of them
+  outstanding as the driver accepts. In receive mode, the frames arriving in
+  the given number of seconds are counted; a peer has to send them, for
+  example with a packet generator on the host side of the link.
+
+  The TPL is raised to TPL_CALLBACK while measuring, so that the Managed
+  Network driver does not poll the SNP instance concurrently.
+
+  Usage: SnpBenchmark [tx | rx] [Seconds] [Index]
+
+  Copyright (c) 2026, EDK II contributors. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/BaseLib.h>                     // StrDecimalToUintn()
+#include <Library/BaseMemoryLib.h>               // CopyMem()
+#include <Library/MemoryAllocationLib.h>         // AllocatePool()
+#include <Library/ShellCEntryLib.h>              // ShellAppMain()
+#include <Library/UefiBootServicesTableLib.h>    // gBS
+#include <Library/UefiLib.h>                     // Print()
+#include <Protocol/SimpleNetwork.h>              // EFI_SIMPLE_NETWORK_PROTOCOL
+
+//
+// Size of the frames sent, without the CRC, and number of frames the transmit
+// mode keeps outstanding at most.
+//
+#define SNP_BENCHMARK_FRAME_SIZE      1514
+#define SNP_BENCHMARK_TX_FRAMES       64
+#define SNP_BENCHMARK_ETHER_TYPE      0x88B5
+#define SNP_BENCHMARK_DEFAULT_SECONDS 5
+
+typedef struct {
+  UINT64 Frames;
+  UINT64 Bytes;
+  UINT64 Errors;
+} SNP_BENCHMARK_RESULT;
+
+/**
+  Send full size frames until the timer event is signaled.
+
+  @param[in]  Snp     The started and initialized SNP instance.
+  @param[in]  Timer   Signaled when the measurement ends.
+  @param[out] Result  The frames and bytes sent.
+
+  @retval EFI_SUCCESS           The measurement completed.
+  @retval EFI_OUT_OF_RESOURCES  The frame buffers could not be allocated.
+**/
+STATIC
+EFI_STATUS
+SnpBenchmarkTransmit (
+  IN  EFI_SIMPLE_NETWORK_PROTOCOL *Snp,
+  IN  EFI_EVENT                   Timer,
+  OUT SNP_BENCHMARK_RESULT        *Result
+  )
+{
+  UINT8      *Frames;
+  BOOLEAN    InUse[SNP_BENCHMARK_TX_FRAMES];
+  UINTN      Outstanding;
+  UINTN      Index;
+  UINT8      *Frame;
+  VOID       *TxBuf;
+  UINTN      Retry;
+  EFI_STATUS Status;
+
+  Frames = AllocatePool (SNP_BENCHMARK_TX_FRAMES * SNP_BENCHMARK_FRAME_SIZE);
+  if (Frames == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < SNP_BENCHMARK_TX_FRAMES; Index++) {
+    Frame = Frames + Index * SNP_BENCHMARK_FRAME_SIZE;
+    SetMem (Frame, Snp->Mode->HwAddressSize, 0xFF);
+    CopyMem (Frame + Snp->Mode->HwAddressSize, &Snp->Mode->CurrentAddress,
+      Snp->Mode->HwAddressSize);
+    Frame[2 * Snp->Mode->HwAddressSize]     = (UINT8)(SNP_BENCHMARK_ETHER_TYPE >> 8);
+    Frame[2 * Snp->Mode->HwAddressSize + 1] = (UINT8)SNP_BENCHMARK_ETHER_TYPE;
+    SetMem (Frame + Snp->Mode->MediaHeaderSize,
+      SNP_BENCHMARK_FRAME_SIZE - Snp->Mode->MediaHeaderSize, (UINT8)Index);
+    InUse[Index] = FALSE;
+  }
+
+  ZeroMem (Result, sizeof *Result);
+  Outstanding = 0;
+  Index = 0;
+  while (gBS->CheckEvent (Timer) == EFI_NOT_READY) {
+    if (!InUse[Index]) {
+      Frame = Frames + Index * SNP_BENCHMARK_FRAME_SIZE;
+      Status = Snp->Transmit (Snp, 0, SNP_BENCHMARK_FRAME_SIZE, Frame, NULL,
+                      NULL, NULL);
+      if (!EFI_ERROR (Status)) {
+        InUse[Index] = TRUE;
+        Outstanding++;
+        Result->Frames++;
+        Result->Bytes += SNP_BENCHMARK_FRAME_SIZE;
+        Index = (Index + 1) % SNP_BENCHMARK_TX_FRAMES;
+        continue;
+      }
+      if (Status != EFI_NOT_READY) {
+        Result->Errors++;
+      }
+    }
+
+    //
+    // Recycle the frames the driver is done with.
+    //
+    do {
+      TxBuf = NULL;
+      Status = Snp->GetStatus (Snp, NULL, &TxBuf);
+      if (EFI_ERROR (Status) || TxBuf == NULL) {
+        break;
+      }
+      //
+      // Frames queued by the network stack before the measurement started
+      // may be returned too.
+      //
+      if ((UINT8 *)TxBuf >= Frames &&
+          (UINT8 *)TxBuf < Frames + SNP_BENCHMARK_TX_FRAMES * SNP_BENCHMARK_FRAME_SIZE) {
+        InUse[((UINT8 *)TxBuf - Frames) / SNP_BENCHMARK_FRAME_SIZE] = FALSE;
+        Outstanding--;
+      }
+    } while (Outstanding > 0);
+  }
+
+  //
+  // Wait up to a second for the outstanding frames before releasing their
+  // buffers; they are leaked if the driver does not return them.
+  //
+  for (Retry = 0; Outstanding > 0 && Retry < 100000; Retry++) {
+    gBS->Stall (10);
+    TxBuf = NULL;
+    Status = Snp->GetStatus (Snp, NULL, &TxBuf);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+    if ((UINT8 *)TxBuf >= Frames &&
+        (UINT8 *)TxBuf < Frames + SNP_BENCHMARK_TX_FRAMES * SNP_BENCHMARK_FRAME_SIZE) {
+      Outstanding--;
+    }
+  }
+
+  if (Outstanding == 0) {
+    FreePool (Frames);
+  }
+  return EFI_SUCCESS;
+}
+
+/**
+  Count the frames received until the timer event is signaled.
+
+  @param[in]  Snp     The started and initialized SNP instance.
+  @param[in]  Timer   Signaled when the measurement ends.
+  @param[out] Result  The frames and bytes received.
+
+  @retval EFI_SUCCESS           The measurement completed.
+  @retval EFI_OUT_OF_RESOURCES  The receive buffer could not be allocated.
+**/
+STATIC
+EFI_STATUS
+SnpBenchmarkReceive (
+  IN  EFI_SIMPLE_NETWORK_PROTOCOL *Snp,
+  IN  EFI_EVENT                   Timer,
+  OUT SNP_BENCHMARK_RESULT        *Result
+  )
+{
+  UINT8      *Buffer;
+  UINTN      BufferSize;
+  UINTN      Size;
+  EFI_STATUS Status;
+
+  BufferSize = Snp->Mode->MediaHeaderSize + Snp->Mode->MaxPacketSize;
+  Buffer = AllocatePool (BufferSize);
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (Result, sizeof *Result);
+  while (gBS->CheckEvent (Timer) == EFI_NOT_READY) {
+    Size = BufferSize;
+    Status = Snp->Receive (Snp, NULL, &Size, Buffer, NULL, NULL, NULL);
+    if (!EFI_ERROR (Status)) {
+      Result->Frames++;
+      Result->Bytes += Size;
+    } else if (Status != EFI_NOT_READY) {
+      Result->Errors++;
+    }
+  }
+
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+/**
+  Entry point function of this shell application.
+**/
+INTN
+EFIAPI
+ShellAppMain (
+  IN UINTN  Argc,
+  IN CHAR16 **Argv
+  )
+{
+  BOOLEAN                     Transmit;
+  UINTN                       Seconds;
+  UINTN                       SnpIndex;
+  UINTN                       HandleCount;
+  EFI_HANDLE                  *Handles;
+  EFI_SIMPLE_NETWORK_PROTOCOL *Snp;
+  EFI_EVENT                   Timer;
+  EFI_TPL                     OldTpl;
+  SNP_BENCHMARK_RESULT        Result;
+  UINT64                      KbitPerSecond;
+  EFI_STATUS                  Status;
+
+  Transmit = TRUE;
+  Seconds  = SNP_BENCHMARK_DEFAULT_SECONDS;
+  SnpIndex = 0;
+  if (Argc > 1) {
+    if (StrCmp (Argv[1], L"rx") == 0) {
+      Transmit = FALSE;
+    } else if (StrCmp (Argv[1], L"tx") != 0) {
+      Print (L"Usage: %s [tx | rx] [Seconds] [Index]\n", Argv[0]);
+      return 1;
+    }
+  }
+  if (Argc > 2) {
+    Seconds = StrDecimalToUintn (Argv[2]);
+  }
+  if (Argc > 3) {
+    SnpIndex = StrDecimalToUintn (Argv[3]);
+  }
+  if (Seconds == 0) {
+    Seconds = SNP_BENCHMARK_DEFAULT_SECONDS;
+  }
+
+  Status = gBS->LocateHandleBuffer (ByProtocol, &gEfiSimpleNetworkProtocolGuid,
+                  NULL, &HandleCount, &Handles);
+  if (EFI_ERROR (Status)) {
+    Print (L"%s: no network interface: %r\n", Argv[0], Status);
+    return 1;
+  }
+  if (SnpIndex >= HandleCount) {
+    Print (L"%s: only %u network interfaces\n", Argv[0], (UINT32)HandleCount);
+    FreePool (Handles);
+    return 1;
+  }
+
+  Status = gBS->HandleProtocol (Handles[SnpIndex],
+                  &gEfiSimpleNetworkProtocolGuid, (VOID **)&Snp);
+  FreePool (Handles);
+  if (EFI_ERROR (Status)) {
+    return 1;
+  }
+
+  if (Snp->Mode->State == EfiSimpleNetworkStopped) {
+    Status = Snp->Start (Snp);
+    if (EFI_ERROR (Status)) {
+      Print (L"%s: Start: %r\n", Argv[0], Status);
+      return 1;
+    }
+  }
+  if (Snp->Mode->State == EfiSimpleNetworkStarted) {
+    Status = Snp->Initialize (Snp, 0, 0);
+    if (EFI_ERROR (Status)) {
+      Print (L"%s: Initialize: %r\n", Argv[0], Status);
+      return 1;
+    }
+  }
+  if (!Transmit) {
+    Snp->ReceiveFilters (Snp, EFI_SIMPLE_NETWORK_RECEIVE_UNICAST |
+           EFI_SIMPLE_NETWORK_RECEIVE_BROADCAST, 0, FALSE, 0, NULL);
+  }
+
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &Timer);
+  if (EFI_ERROR (Status)) {
+    return 1;
+  }
+  Status = gBS->SetTimer (Timer, TimerRelative,
+                  MultU64x32 (Seconds, 10 * 1000 * 1000));
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (Timer);
+    return 1;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  if (Transmit) {
+    Status = SnpBenchmarkTransmit (Snp, Timer, &Result);
+  } else {
+    Status = SnpBenchmarkReceive (Snp, Timer, &Result);
+  }
+  gBS->RestoreTPL (OldTpl);
+  gBS->CloseEvent (Timer);
+
+  if (EFI_ERROR (Status)) {
+    Print (L"%s: %r\n", Argv[0], Status);
+    return 1;
+  }
+
+  KbitPerSecond = DivU64x64Remainder (MultU64x32 (Result.Bytes, 8),
+                    MultU64x32 (Seconds, 1000), NULL);
+  Print (L"%s %u s: %lu frames, %lu bytes, %lu errors, %lu kbit/s, %lu frames/s\n",
+    Transmit ? L"tx" : L"rx", (UINT32)Seconds, Result.Frames, Result.Bytes,
+    Result.Errors, KbitPerSecond, DivU64x64Remainder (Result.Frames, Seconds,
+    NULL));
+  return 0;
+}
@@ -6,9 +6,10 @@
 
   - No attach/detach (ie. removable media).
 
-  - Although the non-blocking interfaces of EFI_BLOCK_IO2_PROTOCOL could be a
-    good match for multiple in-flight virtio-blk requests, we stick to
-    synchronous requests and EFI_BLOCK_IO_PROTOCOL for now.
+  - Transfers are split into requests of at most 1 MB, and up to 64 requests
+    are kept in flight. Completions are polled: blocking transfers poll until
+    done, non-blocking EFI_BLOCK_IO2_PROTOCOL transfers are completed from a
+    periodic timer event.
 
   Copyright (C) 2012, Red Hat, Inc.
   Copyright (c) 2012 - 2018, Intel Corporation. All rights reserved.<BR>
@@ -107,9 +108,9 @@ VirtioBlkReset (
     - 24.2.2. ReadBlocks() and ReadBlocksEx() Implementation
     - 24.2.3 WriteBlocks() and WriteBlockEx() Implementation
 
-  Request sizes are limited to 1 GB (checked). This is not a practical
-  limitation, just conformance to virtio-0.9.5, 2.3.2 Descriptor Table: "no
-  descriptor chain may be more than 2^32 bytes long in total".
+  Request sizes are not limited here; transfers are split into requests that
+  conform to virtio-0.9.5, 2.3.2 Descriptor Table: "no descriptor chain may be
+  more than 2^32 bytes long in total".
 
   Some Media characteristics are hardcoded in VirtioBlkInit() below (like
   non-removable media, no restriction on buffer alignment etc); we rely on
@@ -153,8 +154,7 @@ VerifyReadWriteRequest (
 
   ASSERT (PositiveBufferSize > 0);
 
-  if (PositiveBufferSize > SIZE_1GB ||
-      PositiveBufferSize % Media->BlockSize > 0) {
+  if (PositiveBufferSize % Media->BlockSize > 0) {
     return EFI_BAD_BUFFER_SIZE;
   }
   BlockCount = PositiveBufferSize / Media->BlockSize;
@@ -178,230 +178,131 @@ VerifyReadWriteRequest (
 
 /**
 
-  Format a read / write / flush request as three consecutive virtio
-  descriptors, push them to the host, and poll for the response.
+  Format one request of a transfer in a free request slot, as two or three
+  consecutive virtio descriptors, and make it available to the host.
 
-  This is the main workhorse function. Two use cases are supported, read/write
-  and flush. The function may only be called after the request parameters have
-  been verified by
-  - specific checks in ReadBlocks() / WriteBlocks() / FlushBlocks(), and
-  - VerifyReadWriteRequest() (for read/write only).
-
-  Parameters handled commonly:
-
-    @param[in] Dev             The virtio-blk device the request is targeted
-                               at.
-
-  Flush request:
-
-    @param[in] Lba             Must be zero.
-
-    @param[in] BufferSize      Must be zero.
-
-    @param[in out] Buffer      Ignored by the function.
+  The host is not notified; VirtioBlkStartIo() does that once for all the
+  requests it submits.
 
-    @param[in] RequestIsWrite  Must be TRUE.
+  Must be called at TPL_NOTIFY.
 
-  Read/Write request:
+  @param[in] Dev        The virtio-blk device the request is targeted at.
 
-    @param[in] Lba             Logical Block Address: number of logical blocks
-                               to skip from the beginning of the device.
+  @param[in] SlotIndex  The free request slot to use.
 
-    @param[in] BufferSize      Size of buffer to transfer, in bytes. The caller
-                               is responsible to ensure this parameter is
-                               positive.
+  @param[in] Io         The transfer the request belongs to. Io->Lba and
+                        Io->Buffer describe the start of the request.
 
-    @param[in out] Buffer      The guest side area to read data from the device
-                               into, or write data to the device from.
+  @param[in] Size       For reads and writes, the number of bytes to transfer.
+                        For discard and write zeroes, the number of bytes to
+                        erase. Zero for flush.
 
-    @param[in] RequestIsWrite  TRUE iff data transfer goes from guest to
-                               device.
 
-  Return values are common to both use cases, and are appropriate to be
-  forwarded by the EFI_BLOCK_IO_PROTOCOL functions (ReadBlocks(),
-  WriteBlocks(), FlushBlocks()).
+  @retval EFI_SUCCESS       The request is available to the host.
 
-
-  @retval EFI_SUCCESS          Transfer complete.
-
-  @retval EFI_DEVICE_ERROR     Failed to notify host side via VirtIo write, or
-                               unable to parse host response, or host response
-                               is not VIRTIO_BLK_S_OK or failed to map Buffer
-                               for a bus master operation.
+  @retval EFI_DEVICE_ERROR  Failed to map the data buffer for a bus master
+                            operation.
 
 **/
-
 STATIC
 EFI_STATUS
-EFIAPI
-SynchronousRequest (
-  IN              VBLK_DEV *Dev,
-  IN              EFI_LBA  Lba,
-  IN              UINTN    BufferSize,
-  IN OUT volatile VOID     *Buffer,
-  IN              BOOLEAN  RequestIsWrite
+VirtioBlkSubmitRequest (
+  IN VBLK_DEV *Dev,
+  IN UINTN    SlotIndex,
+  IN VBLK_IO  *Io,
+  IN UINTN    Size
   )
 {
-  UINT32                  BlockSize;
-  volatile VIRTIO_BLK_REQ Request;
-  volatile UINT8          *HostStatus;
-  VOID                    *HostStatusBuffer;
-  DESC_INDICES            Indices;
-  VOID                    *RequestMapping;
-  VOID                    *StatusMapping;
-  VOID                    *BufferMapping;
-  EFI_PHYSICAL_ADDRESS    BufferDeviceAddress;
-  EFI_PHYSICAL_ADDRESS    HostStatusDeviceAddress;
-  EFI_PHYSICAL_ADDRESS    RequestDeviceAddress;
-  EFI_STATUS              Status;
-  EFI_STATUS              UnmapStatus;
-
-  BlockSize = Dev->BlockIoMedia.BlockSize;
-
-  //
-  // Set BufferMapping and BufferDeviceAddress to suppress incorrect
-  // compiler/analyzer warnings.
-  //
-  BufferMapping       = NULL;
-  BufferDeviceAddress = 0;
-
-  //
-  // ensured by VirtioBlkInit()
-  //
-  ASSERT (BlockSize > 0);
-  ASSERT (BlockSize % 512 == 0);
-
-  //
-  // ensured by contract above, plus VerifyReadWriteRequest()
-  //
-  ASSERT (BufferSize % BlockSize == 0);
-
-  //
-  // Prepare virtio-blk request header, setting zero size for flush.
-  // IO Priority is homogeneously 0.
-  //
-  Request.Type   = RequestIsWrite ?
-                   (BufferSize == 0 ? VIRTIO_BLK_T_FLUSH : VIRTIO_BLK_T_OUT) :
-                   VIRTIO_BLK_T_IN;
-  Request.IoPrio = 0;
-  Request.Sector = MultU64x32(Lba, BlockSize / 512);
-
-  //
-  // Host status is bi-directional (we preset with a value and expect the
-  // device to update it). Allocate a host status buffer which can be mapped
-  // to access equally by both processor and the device.
-  //
-  Status = Dev->VirtIo->AllocateSharedPages (
-                          Dev->VirtIo,
-                          EFI_SIZE_TO_PAGES (sizeof *HostStatus),
-                          &HostStatusBuffer
-                          );
-  if (EFI_ERROR (Status)) {
-    return EFI_DEVICE_ERROR;
-  }
-
-  HostStatus = HostStatusBuffer;
+  VBLK_REQ_SLOT         *Slot;
+  VBLK_SHARED_REQ       *SharedReq;
+  EFI_PHYSICAL_ADDRESS  SharedReqDeviceAddress;
+  EFI_PHYSICAL_ADDRESS  BufferDeviceAddress;
+  DESC_INDICES          Indices;
+  UINT32                BlockSize;
+  UINT16                AvailIdx;
+  EFI_STATUS            Status;
 
-  //
-  // Map virtio-blk request header (must be done after request header is
-  // populated)
-  //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterRead,
-             (VOID *) &Request,
-             sizeof Request,
-             &RequestDeviceAddress,
-             &RequestMapping
-             );
-  if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto FreeHostStatusBuffer;
-  }
+  Slot                   = &Dev->Slots[SlotIndex];
+  SharedReq              = &Dev->SharedReqs[SlotIndex];
+  SharedReqDeviceAddress = Dev->SharedReqsDeviceAddress +
+                           SlotIndex * sizeof (VBLK_SHARED_REQ);
+  BlockSize              = Dev->BlockIoMedia.BlockSize;
 
   //
-  // Map data buffer
+  // Map the data buffer of reads and writes
   //
-  if (BufferSize > 0) {
+  Slot->DataMapping = NULL;
+  if (Io->Type == VIRTIO_BLK_T_IN || Io->Type == VIRTIO_BLK_T_OUT) {
     Status = VirtioMapAllBytesInSharedBuffer (
                Dev->VirtIo,
-               (RequestIsWrite ?
+               (Io->Type == VIRTIO_BLK_T_OUT ?
                 VirtioOperationBusMasterRead :
                 VirtioOperationBusMasterWrite),
-               (VOID *) Buffer,
-               BufferSize,
+               Io->Buffer,
+               Size,
                &BufferDeviceAddress,
-               &BufferMapping
+               &Slot->DataMapping
                );
     if (EFI_ERROR (Status)) {
-      Status = EFI_DEVICE_ERROR;
-      goto UnmapRequestBuffer;
+      return EFI_DEVICE_ERROR;
     }
+  } else {
+    BufferDeviceAddress = SharedReqDeviceAddress +
+                          OFFSET_OF (VBLK_SHARED_REQ, Range);
   }
 
   //
-  // preset a host status for ourselves that we do not accept as success
-  //
-  *HostStatus = VIRTIO_BLK_S_IOERR;
-
-  //
-  // Map the Status Buffer with VirtioOperationBusMasterCommonBuffer so that
-  // both processor and device can access it.
+  // Prepare virtio-blk request header. IO Priority is homogeneously 0. Preset
+  // a host status for ourselves that we do not accept as success.
   //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterCommonBuffer,
-             HostStatusBuffer,
-             sizeof *HostStatus,
-             &HostStatusDeviceAddress,
-             &StatusMapping
-             );
-  if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto UnmapDataBuffer;
+  SharedReq->Request.Type   = Io->Type;
+  SharedReq->Request.IoPrio = 0;
+  SharedReq->Request.Sector = MultU64x32 (Io->Lba, BlockSize / 512);
+  SharedReq->HostStatus     = VIRTIO_BLK_S_IOERR;
+  if (Io->Type == VIRTIO_BLK_T_DISCARD || Io->Type == VIRTIO_BLK_T_WRITE_ZEROES) {
+    SharedReq->Request.Sector  = 0;
+    SharedReq->Range.Sector    = MultU64x32 (Io->Lba, BlockSize / 512);
+    SharedReq->Range.NumSectors = (UINT32) (Size / 512);
+    SharedReq->Range.Flags     = 0;
   }
 
-  VirtioPrepare (&Dev->Ring, &Indices);
-
   //
-  // ensured by VirtioBlkInit() -- this predicate, in combination with the
-  // lock-step progress, ensures we don't have to track free descriptors.
+  // The slot owns descriptors [SlotIndex * 3, SlotIndex * 3 + 2].
   //
-  ASSERT (Dev->Ring.QueueSize >= 3);
+  Indices.HeadDescIdx = (UINT16) (SlotIndex * VBLK_DESC_PER_REQUEST);
+  Indices.NextDescIdx = Indices.HeadDescIdx;
 
   //
   // virtio-blk header in first desc
   //
   VirtioAppendDesc (
     &Dev->Ring,
-    RequestDeviceAddress,
-    sizeof Request,
+    SharedReqDeviceAddress + OFFSET_OF (VBLK_SHARED_REQ, Request),
+    sizeof SharedReq->Request,
     VRING_DESC_F_NEXT,
     &Indices
     );
 
   //
-  // data buffer for read/write in second desc
+  // data buffer in second desc, except for flush. VRING_DESC_F_WRITE is
+  // interpreted from the host's point of view. The request size is bounded
+  // by Dev->MaxRequestSize or Dev->MaxEraseSize, so converting it to UINT32
+  // will not truncate it.
   //
-  if (BufferSize > 0) {
-    //
-    // From virtio-0.9.5, 2.3.2 Descriptor Table:
-    // "no descriptor chain may be more than 2^32 bytes long in total".
-    //
-    // The predicate is ensured by the call contract above (for flush), or
-    // VerifyReadWriteRequest() (for read/write). It also implies that
-    // converting BufferSize to UINT32 will not truncate it.
-    //
-    ASSERT (BufferSize <= SIZE_1GB);
-
-    //
-    // VRING_DESC_F_WRITE is interpreted from the host's point of view.
-    //
+  if (Io->Type == VIRTIO_BLK_T_IN || Io->Type == VIRTIO_BLK_T_OUT) {
+    VirtioAppendDesc (
+      &Dev->Ring,
+      BufferDeviceAddress,
+      (UINT32) Size,
+      VRING_DESC_F_NEXT | (Io->Type == VIRTIO_BLK_T_IN ? VRING_DESC_F_WRITE : 0),
+      &Indices
+      );
+  } else if (Io->Type != VIRTIO_BLK_T_FLUSH) {
     VirtioAppendDesc (
       &Dev->Ring,
       BufferDeviceAddress,
-      (UINT32) BufferSize,
-      VRING_DESC_F_NEXT | (RequestIsWrite ? 0 : VRING_DESC_F_WRITE),
+      sizeof SharedReq->Range,
+      VRING_DESC_F_NEXT,
       &Indices
       );
   }
@@ -411,47 +312,412 @@ SynchronousRequest (
   //
   VirtioAppendDesc (
     &Dev->Ring,
-    HostStatusDeviceAddress,
-    sizeof *HostStatus,
+    SharedReqDeviceAddress + OFFSET_OF (VBLK_SHARED_REQ, HostStatus),
+    sizeof SharedReq->HostStatus,
     VRING_DESC_F_WRITE,
     &Indices
     );
 
   //
-  // virtio-blk's only virtqueue is #0, called "requestq" (see Appendix D).
+  // virtio-0.9.5, 2.4.1.2 Updating the Available Ring, and 2.4.1.3 Updating
+  // the Index Field
   //
-  if (VirtioFlush (Dev->VirtIo, 0, &Dev->Ring, &Indices,
-        NULL) == EFI_SUCCESS &&
-      *HostStatus == VIRTIO_BLK_S_OK) {
-    Status = EFI_SUCCESS;
-  } else {
-    Status = EFI_DEVICE_ERROR;
+  AvailIdx = *Dev->Ring.Avail.Idx;
+  Dev->Ring.Avail.Ring[AvailIdx++ % Dev->Ring.QueueSize] = Indices.HeadDescIdx;
+  MemoryFence ();
+  *Dev->Ring.Avail.Idx = AvailIdx;
+
+  Slot->Io = Io;
+  Io->InFlight++;
+  Dev->InFlight++;
+  return EFI_SUCCESS;
+}
+
+
+/**
+
+  Report the completion of a transfer: signal the event of a non-blocking
+  transfer and free it, or mark a blocking transfer done.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in] Dev  The virtio-blk device.
+
+  @param[in] Io   The transfer that has no requests left to submit or wait
+                  for.
+
+**/
+STATIC
+VOID
+VirtioBlkCompleteIo (
+  IN VBLK_DEV *Dev,
+  IN VBLK_IO  *Io
+  )
+{
+  ASSERT (Io->Remaining == 0 && Io->InFlight == 0);
+
+  if (Io->Event == NULL) {
+    Io->Done = TRUE;
+    return;
   }
 
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, StatusMapping);
+  *Io->TransactionStatus = Io->Status;
+  gBS->SignalEvent (Io->Event);
+  FreePool (Io);
+  Dev->AsyncCount--;
+}
 
-UnmapDataBuffer:
-  if (BufferSize > 0) {
-    UnmapStatus = Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, BufferMapping);
-    if (EFI_ERROR (UnmapStatus) && !RequestIsWrite && !EFI_ERROR (Status)) {
-      //
-      // Data from the bus master may not reach the caller; fail the request.
-      //
-      Status = EFI_DEVICE_ERROR;
+
+/**
+
+  Submit requests for the queued transfers, in order, while request slots are
+  free, and notify the host about them.
+
+  A flush is a barrier: it is submitted only when no request is in flight,
+  and no transfer queued after it is submitted before it.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in] Dev  The virtio-blk device.
+
+**/
+STATIC
+VOID
+VirtioBlkStartIo (
+  IN VBLK_DEV *Dev
+  )
+{
+  VBLK_IO    *Io;
+  UINTN      SlotIndex;
+  UINTN      Size;
+  UINTN      Submitted;
+  EFI_STATUS Status;
+
+  Submitted = 0;
+  SlotIndex = 0;
+  while (!IsListEmpty (&Dev->IoQueue)) {
+    Io = BASE_CR (GetFirstNode (&Dev->IoQueue), VBLK_IO, Link);
+    if (Io->Type == VIRTIO_BLK_T_FLUSH && Dev->InFlight > 0) {
+      break;
+    }
+
+    while (Io->Remaining > 0) {
+      while (SlotIndex < Dev->SlotCount && Dev->Slots[SlotIndex].Io != NULL) {
+        SlotIndex++;
+      }
+      if (SlotIndex == Dev->SlotCount) {
+        break;
+      }
+
+      switch (Io->Type) {
+      case VIRTIO_BLK_T_FLUSH:
+        Size = 0;
+        break;
+      case VIRTIO_BLK_T_DISCARD:
+      case VIRTIO_BLK_T_WRITE_ZEROES:
+        Size = MIN (Io->Remaining, Dev->MaxEraseSize);
+        break;
+      default:
+        Size = MIN (Io->Remaining, Dev->MaxRequestSize);
+        break;
+      }
+
+      Status = VirtioBlkSubmitRequest (Dev, SlotIndex, Io, Size);
+      if (EFI_ERROR (Status)) {
+        //
+        // Fail the transfer, once its submitted requests complete.
+        //
+        Io->Status    = Status;
+        Io->Remaining = 0;
+        break;
+      }
+
+      Submitted++;
+      Io->Remaining -= (Io->Type == VIRTIO_BLK_T_FLUSH) ? 1 : Size;
+      Io->Lba       += Size / Dev->BlockIoMedia.BlockSize;
+      if (Io->Buffer != NULL) {
+        Io->Buffer += Size;
+      }
+    }
+
+    if (Io->Remaining > 0) {
+      break;
+    }
+
+    RemoveEntryList (&Io->Link);
+    if (Io->InFlight == 0) {
+      VirtioBlkCompleteIo (Dev, Io);
+    }
+  }
+
+  if (Submitted > 0) {
+    //
+    // virtio-0.9.5, 2.4.1.4 Notifying the Device. virtio-blk's only virtqueue
+    // is #0, called "requestq" (see Appendix D).
+    //
+    MemoryFence ();
+    Dev->VirtIo->SetQueueNotify (Dev->VirtIo, 0);
+  }
+}
+
+
+/**
+
+  Process the requests the host has completed, and complete the transfers
+  that have no requests left.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in] Dev  The virtio-blk device.
+
+**/
+STATIC
+VOID
+VirtioBlkReapIo (
+  IN VBLK_DEV *Dev
+  )
+{
+  volatile CONST VRING_USED_ELEM *UsedElem;
+  VBLK_REQ_SLOT                  *Slot;
+  VBLK_IO                        *Io;
+  UINTN                          SlotIndex;
+  EFI_STATUS                     Status;
+  EFI_STATUS                     UnmapStatus;
+
+  //
+  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
+  //
+  MemoryFence ();
+  while (Dev->LastUsedIdx != *Dev->Ring.Used.Idx) {
+    MemoryFence ();
+    UsedElem  = &Dev->Ring.Used.UsedElem[Dev->LastUsedIdx++ % Dev->Ring.QueueSize];
+    SlotIndex = UsedElem->Id / VBLK_DESC_PER_REQUEST;
+    ASSERT (SlotIndex < Dev->SlotCount);
+    Slot      = &Dev->Slots[SlotIndex];
+    Io        = Slot->Io;
+    ASSERT (Io != NULL);
+
+    Status = (Dev->SharedReqs[SlotIndex].HostStatus == VIRTIO_BLK_S_OK) ?
+             EFI_SUCCESS : EFI_DEVICE_ERROR;
+    if (Slot->DataMapping != NULL) {
+      UnmapStatus = Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Slot->DataMapping);
+      if (EFI_ERROR (UnmapStatus) && Io->Type == VIRTIO_BLK_T_IN) {
+        //
+        // Data from the bus master may not reach the caller; fail the request.
+        //
+        Status = EFI_DEVICE_ERROR;
+      }
+      Slot->DataMapping = NULL;
+    }
+
+    if (EFI_ERROR (Status) && !EFI_ERROR (Io->Status)) {
+      Io->Status = Status;
     }
+
+    Slot->Io = NULL;
+    Dev->InFlight--;
+    Io->InFlight--;
+    if (Io->Remaining == 0 && Io->InFlight == 0) {
+      VirtioBlkCompleteIo (Dev, Io);
+    }
+    MemoryFence ();
   }
+}
 
-UnmapRequestBuffer:
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, RequestMapping);
 
-FreeHostStatusBuffer:
-  Dev->VirtIo->FreeSharedPages (
-                 Dev->VirtIo,
-                 EFI_SIZE_TO_PAGES (sizeof *HostStatus),
-                 HostStatusBuffer
-                 );
+/**
 
-  return Status;
+  Timer notification function that completes non-blocking transfers and
+  submits the queued ones.
+
+  @param[in] Event    Event whose notification function is being invoked.
+
+  @param[in] Context  Pointer to the VBLK_DEV structure.
+
+**/
+STATIC
+VOID
+EFIAPI
+VirtioBlkPollIo (
+  IN EFI_EVENT Event,
+  IN VOID      *Context
+  )
+{
+  VBLK_DEV *Dev;
+
+  Dev = Context;
+  VirtioBlkReapIo (Dev);
+  VirtioBlkStartIo (Dev);
+  if (Dev->AsyncCount == 0) {
+    gBS->SetTimer (Dev->PollTimer, TimerCancel, 0);
+  }
+}
+
+
+/**
+
+  Queue a transfer, and for a blocking transfer, poll until it completes.
+
+  This is the main workhorse function. The function may only be called after
+  the request parameters have been verified by
+  - specific checks in the protocol member functions, and
+  - VerifyReadWriteRequest() (for read/write only).
+
+  @param[in] Dev  The virtio-blk device the transfer is targeted at.
+
+  @param[in] Io   The transfer. Io->Event is NULL for a blocking transfer; a
+                  non-blocking transfer must be allocated from pool, and is
+                  freed when it completes.
+
+
+  @retval EFI_SUCCESS          Transfer complete (blocking), or queued
+                               (non-blocking).
+
+  @retval EFI_DEVICE_ERROR     Failed to notify host side via VirtIo write, or
+                               unable to parse host response, or host response
+                               is not VIRTIO_BLK_S_OK or failed to map Buffer
+                               for a bus master operation.
+
+**/
+STATIC
+EFI_STATUS
+VirtioBlkRunIo (
+  IN VBLK_DEV *Dev,
+  IN VBLK_IO  *Io
+  )
+{
+  EFI_TPL OldTpl;
+  UINTN   PollPeriodUsecs;
+
+  Io->InFlight = 0;
+  Io->Status   = EFI_SUCCESS;
+  Io->Done     = FALSE;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  InsertTailList (&Dev->IoQueue, &Io->Link);
+  if (Io->Event != NULL) {
+    if (Dev->AsyncCount++ == 0) {
+      gBS->SetTimer (Dev->PollTimer, TimerPeriodic, VBLK_POLL_PERIOD);
+    }
+  }
+  VirtioBlkStartIo (Dev);
+  gBS->RestoreTPL (OldTpl);
+
+  if (Io->Event != NULL) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Keep slowing down until we reach a poll period of slightly above 1 ms.
+  //
+  PollPeriodUsecs = 1;
+  for (;;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    VirtioBlkReapIo (Dev);
+    VirtioBlkStartIo (Dev);
+    gBS->RestoreTPL (OldTpl);
+    if (Io->Done) {
+      break;
+    }
+
+    gBS->Stall (PollPeriodUsecs); // calls AcpiTimerLib::MicroSecondDelay
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+  }
+
+  return Io->Status;
+}
+
+
+/**
+
+  Fill in a transfer and run it, blocking or non-blocking.
+
+  @param[in] Dev                 The virtio-blk device.
+
+  @param[in] Type                VIRTIO_BLK_T_* request type.
+
+  @param[in] Lba                 The first block of the transfer.
+
+  @param[in] Size                The size of the transfer in bytes.
+
+  @param[in] Buffer              The data of reads and writes.
+
+  @param[in] Event               NULL for a blocking transfer, otherwise the
+                                 event to signal on completion.
+
+  @param[out] TransactionStatus  The status to set on completion of a
+                                 non-blocking transfer.
+
+
+  @retval EFI_OUT_OF_RESOURCES   A non-blocking transfer could not be
+                                 allocated.
+
+  @return                        Return values of VirtioBlkRunIo().
+
+**/
+STATIC
+EFI_STATUS
+VirtioBlkTransfer (
+  IN  VBLK_DEV   *Dev,
+  IN  UINT32     Type,
+  IN  EFI_LBA    Lba,
+  IN  UINTN      Size,
+  IN  VOID       *Buffer,
+  IN  EFI_EVENT  Event,
+  OUT EFI_STATUS *TransactionStatus
+  )
+{
+  VBLK_IO BlockingIo;
+  VBLK_IO *Io;
+
+  Io = &BlockingIo;
+  if (Event != NULL) {
+    Io = AllocatePool (sizeof *Io);
+    if (Io == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  Io->Type              = Type;
+  Io->Lba               = Lba;
+  Io->Buffer            = Buffer;
+  Io->Remaining         = (Type == VIRTIO_BLK_T_FLUSH) ? 1 : Size;
+  Io->Event             = Event;
+  Io->TransactionStatus = TransactionStatus;
+  return VirtioBlkRunIo (Dev, Io);
+}
+
+
+/**
+
+  Wait until all the non-blocking transfers have completed.
+
+  @param[in] Dev  The virtio-blk device.
+
+**/
+STATIC
+VOID
+VirtioBlkDrainIo (
+  IN VBLK_DEV *Dev
+  )
+{
+  EFI_TPL OldTpl;
+  UINTN   AsyncCount;
+
+  for (;;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    VirtioBlkReapIo (Dev);
+    VirtioBlkStartIo (Dev);
+    AsyncCount = Dev->AsyncCount;
+    gBS->RestoreTPL (OldTpl);
+    if (AsyncCount == 0) {
+      break;
+    }
+
+    gBS->Stall (100);
+  }
 }
 
 
@@ -466,7 +732,7 @@ FreeHostStatusBuffer:
     ReadBlocksEx() Implementation.
 
   Parameter checks and conformant return values are implemented in
-  VerifyReadWriteRequest() and SynchronousRequest().
+  VerifyReadWriteRequest() and VirtioBlkRunIo().
 
   A zero BufferSize doesn't seem to be prohibited, so do nothing in that case,
   successfully.
@@ -501,12 +767,14 @@ VirtioBlkReadBlocks (
     return Status;
   }
 
-  return SynchronousRequest (
+  return VirtioBlkTransfer (
            Dev,
+           VIRTIO_BLK_T_IN,
            Lba,
            BufferSize,
            Buffer,
-           FALSE       // RequestIsWrite
+           NULL,       // Event
+           NULL        // TransactionStatus
            );
 }
 
@@ -521,7 +789,7 @@ VirtioBlkReadBlocks (
     WriteBlockEx() Implementation.
 
   Parameter checks and conformant return values are implemented in
-  VerifyReadWriteRequest() and SynchronousRequest().
+  VerifyReadWriteRequest() and VirtioBlkRunIo().
 
   A zero BufferSize doesn't seem to be prohibited, so do nothing in that case,
   successfully.
@@ -556,12 +824,14 @@ VirtioBlkWriteBlocks (
     return Status;
   }
 
-  return SynchronousRequest (
+  return VirtioBlkTransfer (
            Dev,
+           VIRTIO_BLK_T_OUT,
            Lba,
            BufferSize,
            Buffer,
-           TRUE        // RequestIsWrite
+           NULL,       // Event
+           NULL        // TransactionStatus
            );
 }
 
@@ -593,17 +863,265 @@ VirtioBlkFlushBlocks (
 
   Dev = VIRTIO_BLK_FROM_BLOCK_IO (This);
   return Dev->BlockIoMedia.WriteCaching ?
-           SynchronousRequest (
+           VirtioBlkTransfer (
              Dev,
+             VIRTIO_BLK_T_FLUSH,
              0,    // Lba
-             0,    // BufferSize
+             0,    // Size
              NULL, // Buffer
-             TRUE  // RequestIsWrite
+             NULL, // Event
+             NULL  // TransactionStatus
              ) :
            EFI_SUCCESS;
 }
 
 
+//
+// UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol. Outstanding
+// non-blocking transfers are completed rather than aborted.
+//
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL *This,
+  IN BOOLEAN                ExtendedVerification
+  )
+{
+  VirtioBlkDrainIo (VIRTIO_BLK_FROM_BLOCK_IO2 (This));
+  return EFI_SUCCESS;
+}
+
+
+/**
+
+  ReadBlocksEx() operation for virtio-blk.
+
+  See UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol,
+  EFI_BLOCK_IO2_PROTOCOL.ReadBlocksEx().
+
+  If Token is NULL or Token->Event is NULL, the read is blocking, like
+  ReadBlocks(). Otherwise the read is queued, and Token->Event is signaled
+  when it completes.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL *This,
+  IN     UINT32                 MediaId,
+  IN     EFI_LBA                Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN    *Token,
+  IN     UINTN                  BufferSize,
+  OUT    VOID                   *Buffer
+  )
+{
+  VBLK_DEV   *Dev;
+  EFI_STATUS Status;
+
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  if (Token == NULL || Token->Event == NULL) {
+    return VirtioBlkReadBlocks (&Dev->BlockIo, MediaId, Lba, BufferSize,
+             Buffer);
+  }
+
+  if (BufferSize == 0) {
+    Token->TransactionStatus = EFI_SUCCESS;
+    gBS->SignalEvent (Token->Event);
+    return EFI_SUCCESS;
+  }
+
+  Status = VerifyReadWriteRequest (
+             &Dev->BlockIoMedia,
+             Lba,
+             BufferSize,
+             FALSE               // RequestIsWrite
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return VirtioBlkTransfer (
+           Dev,
+           VIRTIO_BLK_T_IN,
+           Lba,
+           BufferSize,
+           Buffer,
+           Token->Event,
+           &Token->TransactionStatus
+           );
+}
+
+
+/**
+
+  WriteBlocksEx() operation for virtio-blk.
+
+  See UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol,
+  EFI_BLOCK_IO2_PROTOCOL.WriteBlocksEx().
+
+  If Token is NULL or Token->Event is NULL, the write is blocking, like
+  WriteBlocks(). Otherwise the write is queued, and Token->Event is signaled
+  when it completes.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL *This,
+  IN     UINT32                 MediaId,
+  IN     EFI_LBA                Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN    *Token,
+  IN     UINTN                  BufferSize,
+  IN     VOID                   *Buffer
+  )
+{
+  VBLK_DEV   *Dev;
+  EFI_STATUS Status;
+
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  if (Token == NULL || Token->Event == NULL) {
+    return VirtioBlkWriteBlocks (&Dev->BlockIo, MediaId, Lba, BufferSize,
+             Buffer);
+  }
+
+  if (BufferSize == 0) {
+    Token->TransactionStatus = EFI_SUCCESS;
+    gBS->SignalEvent (Token->Event);
+    return EFI_SUCCESS;
+  }
+
+  Status = VerifyReadWriteRequest (
+             &Dev->BlockIoMedia,
+             Lba,
+             BufferSize,
+             TRUE                // RequestIsWrite
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return VirtioBlkTransfer (
+           Dev,
+           VIRTIO_BLK_T_OUT,
+           Lba,
+           BufferSize,
+           Buffer,
+           Token->Event,
+           &Token->TransactionStatus
+           );
+}
+
+
+/**
+
+  FlushBlocksEx() operation for virtio-blk.
+
+  See UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol,
+  EFI_BLOCK_IO2_PROTOCOL.FlushBlocksEx().
+
+  The flush is submitted only after all the transfers queued before it have
+  completed.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN    *Token
+  )
+{
+  VBLK_DEV *Dev;
+
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  if (Token == NULL || Token->Event == NULL) {
+    return VirtioBlkFlushBlocks (&Dev->BlockIo);
+  }
+
+  if (!Dev->BlockIoMedia.WriteCaching) {
+    Token->TransactionStatus = EFI_SUCCESS;
+    gBS->SignalEvent (Token->Event);
+    return EFI_SUCCESS;
+  }
+
+  return VirtioBlkTransfer (
+           Dev,
+           VIRTIO_BLK_T_FLUSH,
+           0,    // Lba
+           0,    // Size
+           NULL, // Buffer
+           Token->Event,
+           &Token->TransactionStatus
+           );
+}
+
+
+/**
+
+  EraseBlocks() operation for virtio-blk.
+
+  See UEFI Spec 2.6, 13.14 Erase Block Protocol. The blocks are erased with
+  write zeroes requests if the device supports them, and with discard
+  requests otherwise.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkEraseBlocks (
+  IN     EFI_ERASE_BLOCK_PROTOCOL *This,
+  IN     UINT32                   MediaId,
+  IN     EFI_LBA                  Lba,
+  IN OUT EFI_ERASE_BLOCK_TOKEN    *Token,
+  IN     UINTN                    Size
+  )
+{
+  VBLK_DEV   *Dev;
+  EFI_STATUS Status;
+
+  Dev = VIRTIO_BLK_FROM_ERASE_BLOCK (This);
+  if (Size == 0) {
+    if (Token != NULL && Token->Event != NULL) {
+      Token->TransactionStatus = EFI_SUCCESS;
+      gBS->SignalEvent (Token->Event);
+    }
+    return EFI_SUCCESS;
+  }
+
+  if (Size % (Dev->EraseBlock.EraseLengthGranularity *
+              Dev->BlockIoMedia.BlockSize) != 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = VerifyReadWriteRequest (
+             &Dev->BlockIoMedia,
+             Lba,
+             Size,
+             TRUE                // RequestIsWrite
+             );
+  if (EFI_ERROR (Status)) {
+    return Status == EFI_BAD_BUFFER_SIZE ? EFI_INVALID_PARAMETER : Status;
+  }
+
+  if (Token == NULL || Token->Event == NULL) {
+    return VirtioBlkTransfer (Dev, Dev->EraseType, Lba, Size, NULL, NULL,
+             NULL);
+  }
+
+  return VirtioBlkTransfer (
+           Dev,
+           Dev->EraseType,
+           Lba,
+           Size,
+           NULL, // Buffer
+           Token->Event,
+           &Token->TransactionStatus
+           );
+}
+
+
 /**
 
   Device probe function for this driver.
@@ -723,10 +1241,18 @@ VirtioBlkInit (
   UINT32     OptIoSize;
   UINT16     QueueSize;
   UINT64     RingBaseShift;
+  UINT32     SizeMax;
+  UINT32     MaxEraseSectors;
+  UINT32     EraseAlignment;
+  VOID       *SharedReqsBuffer;
+  UINTN      SlotIndex;
 
   PhysicalBlockExp = 0;
   AlignmentOffset = 0;
   OptIoSize = 0;
+  SizeMax = 0;
+  MaxEraseSectors = 0;
+  EraseAlignment = 0;
 
   //
   // Execute virtio-0.9.5, 2.2.1 Device Initialization Sequence.
@@ -815,9 +1341,41 @@ VirtioBlkInit (
     }
   }
 
+  if (Features & VIRTIO_BLK_F_SIZE_MAX) {
+    Status = VIRTIO_CFG_READ (Dev, SizeMax, &SizeMax);
+    if (EFI_ERROR (Status)) {
+      goto Failed;
+    }
+  }
+
+  //
+  // Prefer write zeroes to discard for EraseBlocks(): the former guarantees
+  // that the erased blocks read back as zeroes.
+  //
+  if (Features & VIRTIO_BLK_F_WRITE_ZEROES) {
+    Features &= ~(UINT64)VIRTIO_BLK_F_DISCARD;
+    Status = VIRTIO_CFG_READ (Dev, MaxWriteZeroesSectors, &MaxEraseSectors);
+    if (EFI_ERROR (Status)) {
+      goto Failed;
+    }
+  } else if (Features & VIRTIO_BLK_F_DISCARD) {
+    Status = VIRTIO_CFG_READ (Dev, MaxDiscardSectors, &MaxEraseSectors);
+    if (EFI_ERROR (Status)) {
+      goto Failed;
+    }
+    Status = VIRTIO_CFG_READ (Dev, DiscardSectorAlignment, &EraseAlignment);
+    if (EFI_ERROR (Status)) {
+      goto Failed;
+    }
+  }
+  if (MaxEraseSectors < BlockSize / 512) {
+    Features &= ~(UINT64)(VIRTIO_BLK_F_DISCARD | VIRTIO_BLK_F_WRITE_ZEROES);
+  }
+
   Features &= VIRTIO_BLK_F_BLK_SIZE | VIRTIO_BLK_F_TOPOLOGY | VIRTIO_BLK_F_RO |
-              VIRTIO_BLK_F_FLUSH | VIRTIO_F_VERSION_1 |
-              VIRTIO_F_IOMMU_PLATFORM;
+              VIRTIO_BLK_F_FLUSH | VIRTIO_BLK_F_SIZE_MAX |
+              VIRTIO_BLK_F_DISCARD | VIRTIO_BLK_F_WRITE_ZEROES |
+              VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM;
 
   //
   // In virtio-1.0, feature negotiation is expected to complete before queue
@@ -841,7 +1399,7 @@ VirtioBlkInit (
   if (EFI_ERROR (Status)) {
     goto Failed;
   }
-  if (QueueSize < 3) { // SynchronousRequest() uses at most three descriptors
+  if (QueueSize < VBLK_DESC_PER_REQUEST) {
     Status = EFI_UNSUPPORTED;
     goto Failed;
   }
@@ -890,6 +1448,57 @@ VirtioBlkInit (
     goto UnmapQueue;
   }
 
+  //
+  // Each request slot owns VBLK_DESC_PER_REQUEST consecutive descriptors, so
+  // that the requests in flight never compete for descriptors.
+  //
+  Dev->SlotCount = MIN (QueueSize / VBLK_DESC_PER_REQUEST, VBLK_MAX_REQUESTS);
+
+  //
+  // Allocate the request headers and host statuses of all slots, and map
+  // them with BusMasterCommonBuffer so that they can be accessed equally by
+  // both processor and device.
+  //
+  Dev->SharedReqsPages = EFI_SIZE_TO_PAGES (
+                           Dev->SlotCount * sizeof (VBLK_SHARED_REQ)
+                           );
+  Status = Dev->VirtIo->AllocateSharedPages (
+                          Dev->VirtIo,
+                          Dev->SharedReqsPages,
+                          &SharedReqsBuffer
+                          );
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
+  ZeroMem (SharedReqsBuffer, EFI_PAGES_TO_SIZE (Dev->SharedReqsPages));
+
+  Status = VirtioMapAllBytesInSharedBuffer (
+             Dev->VirtIo,
+             VirtioOperationBusMasterCommonBuffer,
+             SharedReqsBuffer,
+             EFI_PAGES_TO_SIZE (Dev->SharedReqsPages),
+             &Dev->SharedReqsDeviceAddress,
+             &Dev->SharedReqsMap
+             );
+  if (EFI_ERROR (Status)) {
+    goto FreeSharedReqs;
+  }
+
+  Dev->SharedReqs = SharedReqsBuffer;
+  for (SlotIndex = 0; SlotIndex < Dev->SlotCount; ++SlotIndex) {
+    Dev->Slots[SlotIndex].Io          = NULL;
+    Dev->Slots[SlotIndex].DataMapping = NULL;
+  }
+  Dev->LastUsedIdx = 0;
+  Dev->InFlight    = 0;
+  Dev->AsyncCount  = 0;
+  InitializeListHead (&Dev->IoQueue);
+
+  //
+  // Completions are polled; the host should not send interrupts.
+  //
+  *Dev->Ring.Avail.Flags = (UINT16) VRING_AVAIL_F_NO_INTERRUPT;
 
   //
   // step 5 -- Report understood features.
@@ -898,7 +1507,7 @@ VirtioBlkInit (
     Features &= ~(UINT64)(VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM);
     Status = Dev->VirtIo->SetGuestFeatures (Dev->VirtIo, Features);
     if (EFI_ERROR (Status)) {
-      goto UnmapQueue;
+      goto UnmapSharedReqs;
     }
   }
 
@@ -908,7 +1517,7 @@ VirtioBlkInit (
   NextDevStat |= VSTAT_DRIVER_OK;
   Status = Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, NextDevStat);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto UnmapSharedReqs;
   }
 
   //
@@ -949,8 +1558,53 @@ VirtioBlkInit (
     DEBUG ((DEBUG_INFO, "%a: OptimalTransferLengthGranularity=0x%x[Lba]\n",
       __FUNCTION__, Dev->BlockIoMedia.OptimalTransferLengthGranularity));
   }
+
+  //
+  // Split transfers into requests of at most 1 MB, honoring the largest
+  // segment the device accepts (each request has a single data segment).
+  //
+  Dev->MaxRequestSize = VBLK_MAX_REQUEST_SIZE;
+  if (SizeMax >= BlockSize && SizeMax < Dev->MaxRequestSize) {
+    Dev->MaxRequestSize = SizeMax;
+  }
+  Dev->MaxRequestSize -= Dev->MaxRequestSize % BlockSize;
+
+  Dev->BlockIo2.Media                = &Dev->BlockIoMedia;
+  Dev->BlockIo2.Reset                = &VirtioBlkResetEx;
+  Dev->BlockIo2.ReadBlocksEx         = &VirtioBlkReadBlocksEx;
+  Dev->BlockIo2.WriteBlocksEx        = &VirtioBlkWriteBlocksEx;
+  Dev->BlockIo2.FlushBlocksEx        = &VirtioBlkFlushBlocksEx;
+
+  Dev->EraseType = 0;
+  if (Features & (VIRTIO_BLK_F_DISCARD | VIRTIO_BLK_F_WRITE_ZEROES)) {
+    Dev->EraseType = (Features & VIRTIO_BLK_F_WRITE_ZEROES) ?
+                     VIRTIO_BLK_T_WRITE_ZEROES : VIRTIO_BLK_T_DISCARD;
+    Dev->MaxEraseSize = (UINTN) MIN (MultU64x32 (MaxEraseSectors, 512),
+                                     SIZE_1GB);
+    Dev->MaxEraseSize -= Dev->MaxEraseSize % BlockSize;
+
+    Dev->EraseBlock.Revision               = EFI_ERASE_BLOCK_PROTOCOL_REVISION;
+    Dev->EraseBlock.EraseLengthGranularity = MAX (
+                                               EraseAlignment / (BlockSize / 512),
+                                               1
+                                               );
+    Dev->EraseBlock.EraseBlocks            = &VirtioBlkEraseBlocks;
+
+    DEBUG ((DEBUG_INFO, "%a: EraseType=0x%x MaxEraseSize=0x%Lx[B]\n",
+      __FUNCTION__, Dev->EraseType, (UINT64) Dev->MaxEraseSize));
+  }
   return EFI_SUCCESS;
 
+UnmapSharedReqs:
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->SharedReqsMap);
+
+FreeSharedReqs:
+  Dev->VirtIo->FreeSharedPages (
+                 Dev->VirtIo,
+                 Dev->SharedReqsPages,
+                 SharedReqsBuffer
+                 );
+
 UnmapQueue:
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
 
@@ -992,10 +1646,19 @@ VirtioBlkUninit (
   //
   Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, 0);
 
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->SharedReqsMap);
+  Dev->VirtIo->FreeSharedPages (
+                 Dev->VirtIo,
+                 Dev->SharedReqsPages,
+                 (VOID *) Dev->SharedReqs
+                 );
+
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
   VirtioRingUninit (Dev->VirtIo, &Dev->Ring);
 
   SetMem (&Dev->BlockIo,      sizeof Dev->BlockIo,      0x00);
+  SetMem (&Dev->BlockIo2,     sizeof Dev->BlockIo2,     0x00);
+  SetMem (&Dev->EraseBlock,   sizeof Dev->EraseBlock,   0x00);
   SetMem (&Dev->BlockIoMedia, sizeof Dev->BlockIoMedia, 0x00);
 }
 
@@ -1099,18 +1762,41 @@ VirtioBlkDriverBindingStart (
   }
 
   //
-  // Setup complete, attempt to export the driver instance's BlockIo interface.
+  // The timer completes non-blocking transfers; it runs only while some are
+  // outstanding.
   //
-  Dev->Signature = VBLK_SIG;
-  Status = gBS->InstallProtocolInterface (&DeviceHandle,
-                  &gEfiBlockIoProtocolGuid, EFI_NATIVE_INTERFACE,
-                  &Dev->BlockIo);
+  Status = gBS->CreateEvent (EVT_TIMER | EVT_NOTIFY_SIGNAL, TPL_NOTIFY,
+                  &VirtioBlkPollIo, Dev, &Dev->PollTimer);
   if (EFI_ERROR (Status)) {
     goto CloseExitBoot;
   }
 
+  //
+  // Setup complete, attempt to export the driver instance's BlockIo,
+  // BlockIo2, and (if the device can erase) EraseBlock interfaces.
+  //
+  Dev->Signature = VBLK_SIG;
+  if (Dev->EraseType != 0) {
+    Status = gBS->InstallMultipleProtocolInterfaces (&DeviceHandle,
+                    &gEfiBlockIoProtocolGuid, &Dev->BlockIo,
+                    &gEfiBlockIo2ProtocolGuid, &Dev->BlockIo2,
+                    &gEfiEraseBlockProtocolGuid, &Dev->EraseBlock,
+                    NULL);
+  } else {
+    Status = gBS->InstallMultipleProtocolInterfaces (&DeviceHandle,
+                    &gEfiBlockIoProtocolGuid, &Dev->BlockIo,
+                    &gEfiBlockIo2ProtocolGuid, &Dev->BlockIo2,
+                    NULL);
+  }
+  if (EFI_ERROR (Status)) {
+    goto ClosePollTimer;
+  }
+
   return EFI_SUCCESS;
 
+ClosePollTimer:
+  gBS->CloseEvent (Dev->PollTimer);
+
 CloseExitBoot:
   gBS->CloseEvent (Dev->ExitBoot);
 
@@ -1181,12 +1867,28 @@ VirtioBlkDriverBindingStop (
   //
   // Handle Stop() requests for in-use driver instances gracefully.
   //
-  Status = gBS->UninstallProtocolInterface (DeviceHandle,
-                  &gEfiBlockIoProtocolGuid, &Dev->BlockIo);
+  if (Dev->EraseType != 0) {
+    Status = gBS->UninstallMultipleProtocolInterfaces (DeviceHandle,
+                    &gEfiBlockIoProtocolGuid, &Dev->BlockIo,
+                    &gEfiBlockIo2ProtocolGuid, &Dev->BlockIo2,
+                    &gEfiEraseBlockProtocolGuid, &Dev->EraseBlock,
+                    NULL);
+  } else {
+    Status = gBS->UninstallMultipleProtocolInterfaces (DeviceHandle,
+                    &gEfiBlockIoProtocolGuid, &Dev->BlockIo,
+                    &gEfiBlockIo2ProtocolGuid, &Dev->BlockIo2,
+                    NULL);
+  }
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
+  //
+  // Complete the non-blocking transfers that are still outstanding.
+  //
+  VirtioBlkDrainIo (Dev);
+  gBS->CloseEvent (Dev->PollTimer);
+
   gBS->CloseEvent (Dev->ExitBoot);
 
   VirtioBlkUninit (Dev);
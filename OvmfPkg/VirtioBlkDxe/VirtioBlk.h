@@ -13,14 +13,78 @@
 #define _VIRTIO_BLK_DXE_H_
 
 #include <Protocol/BlockIo.h>
+#include <Protocol/BlockIo2.h>
 #include <Protocol/ComponentName.h>
 #include <Protocol/DriverBinding.h>
+#include <Protocol/EraseBlock.h>
 
-#include <IndustryStandard/Virtio.h>
+#include <IndustryStandard/VirtioBlk.h>
 
 
 #define VBLK_SIG SIGNATURE_32 ('V', 'B', 'L', 'K')
 
+//
+// Every in-flight request owns three consecutive descriptors of the ring:
+// header, data and status. The number of in-flight requests is bounded by the
+// ring size and by VBLK_MAX_REQUESTS.
+//
+#define VBLK_DESC_PER_REQUEST 3
+#define VBLK_MAX_REQUESTS     64
+
+//
+// Read and write transfers are split into requests of at most this size (or
+// the SizeMax the device reports, if smaller), so that the host can work on
+// the parts of a large transfer in parallel.
+//
+#define VBLK_MAX_REQUEST_SIZE SIZE_1MB
+
+//
+// Period of the timer that completes non-blocking requests, in 100ns units.
+//
+#define VBLK_POLL_PERIOD      EFI_TIMER_PERIOD_MICROSECONDS (100)
+
+//
+// The parts of a request that the device accesses besides the data buffer.
+// They live in one common buffer, mapped at initialization, with one element
+// per request slot.
+//
+typedef struct {
+  VIRTIO_BLK_REQ                  Request;
+  VIRTIO_BLK_DISCARD_WRITE_ZEROES Range;      // data of discard / write zeroes
+  UINT8                           HostStatus;
+  UINT8                           Reserved[31];
+} VBLK_SHARED_REQ;
+
+//
+// A transfer requested through one of the protocol interfaces. It is split
+// into requests, which are submitted as request slots become free.
+//
+typedef struct {
+  LIST_ENTRY          Link;              // in VBLK_DEV.IoQueue until submitted
+  UINT32              Type;              // VIRTIO_BLK_T_*
+  EFI_LBA             Lba;               // start of the next request
+  UINT8               *Buffer;           // data of the next request
+  //
+  // Bytes left to submit. A flush request has no data, and counts as one
+  // byte until it is submitted.
+  //
+  UINTN               Remaining;
+  UINTN               InFlight;          // submitted requests not completed
+  EFI_STATUS          Status;
+  volatile BOOLEAN    Done;
+  //
+  // For non-blocking transfers: the event to signal and the status to set
+  // on completion. The VBLK_IO is freed on completion.
+  //
+  EFI_EVENT           Event;
+  EFI_STATUS          *TransactionStatus;
+} VBLK_IO;
+
+typedef struct {
+  VBLK_IO             *Io;               // NULL if the slot is free
+  VOID                *DataMapping;      // NULL if no data buffer is mapped
+} VBLK_REQ_SLOT;
+
 typedef struct {
   //
   // Parts of this structure are initialized / torn down in various functions
@@ -36,11 +100,33 @@ typedef struct {
   EFI_BLOCK_IO_PROTOCOL  BlockIo;              // VirtioBlkInit       1
   EFI_BLOCK_IO_MEDIA     BlockIoMedia;         // VirtioBlkInit       1
   VOID                   *RingMap;             // VirtioRingMap       2
+  EFI_BLOCK_IO2_PROTOCOL BlockIo2;             // VirtioBlkInit       1
+  EFI_ERASE_BLOCK_PROTOCOL EraseBlock;         // VirtioBlkInit       1
+  UINT32                 EraseType;            // VirtioBlkInit       1
+  UINTN                  MaxEraseSize;         // VirtioBlkInit       1
+  UINTN                  MaxRequestSize;       // VirtioBlkInit       1
+  UINTN                  SlotCount;            // VirtioBlkInit       1
+  VBLK_SHARED_REQ        *SharedReqs;          // VirtioBlkInit       1
+  UINTN                  SharedReqsPages;      // VirtioBlkInit       1
+  VOID                   *SharedReqsMap;       // VirtioBlkInit       1
+  EFI_PHYSICAL_ADDRESS   SharedReqsDeviceAddress; // VirtioBlkInit    1
+  UINT16                 LastUsedIdx;          // VirtioBlkInit       1
+  UINTN                  InFlight;             // VirtioBlkInit       1
+  UINTN                  AsyncCount;           // VirtioBlkInit       1
+  LIST_ENTRY             IoQueue;              // VirtioBlkInit       1
+  EFI_EVENT              PollTimer;            // DriverBindingStart  0
+  VBLK_REQ_SLOT          Slots[VBLK_MAX_REQUESTS]; // VirtioBlkInit   1
 } VBLK_DEV;
 
 #define VIRTIO_BLK_FROM_BLOCK_IO(BlockIoPointer) \
         CR (BlockIoPointer, VBLK_DEV, BlockIo, VBLK_SIG)
 
+#define VIRTIO_BLK_FROM_BLOCK_IO2(BlockIo2Pointer) \
+        CR (BlockIo2Pointer, VBLK_DEV, BlockIo2, VBLK_SIG)
+
+#define VIRTIO_BLK_FROM_ERASE_BLOCK(EraseBlockPointer) \
+        CR (EraseBlockPointer, VBLK_DEV, EraseBlock, VBLK_SIG)
+
 
 /**
 
@@ -106,13 +192,15 @@ VirtioBlkDriverBindingSupported (
 
   @retval EFI_SUCCESS           Driver instance has been created and
                                 initialized  for the virtio-blk device, it
-                                is now accessible via EFI_BLOCK_IO_PROTOCOL.
+                                is now accessible via EFI_BLOCK_IO_PROTOCOL
+                                and EFI_BLOCK_IO2_PROTOCOL.
 
   @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
 
   @return                       Error codes from the OpenProtocol() boot
                                 service, VirtioBlkInit(), or the
-                                InstallProtocolInterface() boot service.
+                                InstallMultipleProtocolInterfaces() boot
+                                service.
 
 **/
 
@@ -127,7 +215,7 @@ VirtioBlkDriverBindingStart (
 
 /**
 
-  Stop driving a virtio-blk device and remove its BlockIo interface.
+  Stop driving a virtio-blk device and remove its BlockIo interfaces.
 
   This function replays the success path of DriverBindingStart() in reverse.
   The host side virtio-blk device is reset, so that the OS boot loader or the
@@ -253,6 +341,108 @@ VirtioBlkFlushBlocks (
   );
 
 
+//
+// UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol
+//
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL *This,
+  IN BOOLEAN                ExtendedVerification
+  );
+
+
+/**
+
+  ReadBlocksEx() operation for virtio-blk.
+
+  See UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol,
+  EFI_BLOCK_IO2_PROTOCOL.ReadBlocksEx().
+
+  If Token is NULL or Token->Event is NULL, the read is blocking, like
+  ReadBlocks(). Otherwise the read is queued, and Token->Event is signaled
+  when it completes.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL *This,
+  IN     UINT32                 MediaId,
+  IN     EFI_LBA                Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN    *Token,
+  IN     UINTN                  BufferSize,
+  OUT    VOID                   *Buffer
+  );
+
+
+/**
+
+  WriteBlocksEx() operation for virtio-blk.
+
+  See UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol,
+  EFI_BLOCK_IO2_PROTOCOL.WriteBlocksEx().
+
+  If Token is NULL or Token->Event is NULL, the write is blocking, like
+  WriteBlocks(). Otherwise the write is queued, and Token->Event is signaled
+  when it completes.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL *This,
+  IN     UINT32                 MediaId,
+  IN     EFI_LBA                Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN    *Token,
+  IN     UINTN                  BufferSize,
+  IN     VOID                   *Buffer
+  );
+
+
+/**
+
+  FlushBlocksEx() operation for virtio-blk.
+
+  See UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol,
+  EFI_BLOCK_IO2_PROTOCOL.FlushBlocksEx().
+
+  The flush is submitted only after all the transfers queued before it have
+  completed.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN    *Token
+  );
+
+
+/**
+
+  EraseBlocks() operation for virtio-blk.
+
+  See UEFI Spec 2.6, 13.14 Erase Block Protocol. The blocks are erased with
+  write zeroes requests if the device supports them, and with discard
+  requests otherwise.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkEraseBlocks (
+  IN     EFI_ERASE_BLOCK_PROTOCOL *This,
+  IN     UINT32                   MediaId,
+  IN     EFI_LBA                  Lba,
+  IN OUT EFI_ERASE_BLOCK_TOKEN    *Token,
+  IN     UINTN                    Size
+  );
+
+
 //
 // The purpose of the following scaffolding (EFI_COMPONENT_NAME_PROTOCOL and
 // EFI_COMPONENT_NAME2_PROTOCOL implementation) is to format the driver's name
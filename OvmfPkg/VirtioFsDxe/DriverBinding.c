@@ -7,6 +7,7 @@
 **/
 
 #include <Library/BaseLib.h>                  // AsciiStrCmp()
+#include <Library/BaseMemoryLib.h>            // ZeroMem()
 #include <Library/MemoryAllocationLib.h>      // AllocatePool()
 #include <Library/UefiBootServicesTableLib.h> // gBS
 #include <Protocol/ComponentName2.h>          // EFI_COMPONENT_NAME2_PROTOCOL
@@ -89,10 +90,20 @@ VirtioFsBindingStart (
     goto UninitVirtioFs;
   }
 
+  Status = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL,
+                  &VirtioFs->LookupCacheTimer);
+  if (EFI_ERROR (Status)) {
+    goto UninitVirtioFs;
+  }
+  VirtioFs->LookupCacheTimeout = 0;
+  VirtioFs->LookupCacheCount   = 0;
+  VirtioFs->LookupCacheVictim  = 0;
+  ZeroMem (VirtioFs->LookupCache, sizeof VirtioFs->LookupCache);
+
   Status = gBS->CreateEvent (EVT_SIGNAL_EXIT_BOOT_SERVICES, TPL_CALLBACK,
                   VirtioFsExitBoot, VirtioFs, &VirtioFs->ExitBoot);
   if (EFI_ERROR (Status)) {
-    goto UninitVirtioFs;
+    goto CloseLookupCacheTimer;
   }
 
   InitializeListHead (&VirtioFs->OpenFiles);
@@ -112,6 +123,10 @@ CloseExitBoot:
   CloseStatus = gBS->CloseEvent (VirtioFs->ExitBoot);
   ASSERT_EFI_ERROR (CloseStatus);
 
+CloseLookupCacheTimer:
+  CloseStatus = gBS->CloseEvent (VirtioFs->LookupCacheTimer);
+  ASSERT_EFI_ERROR (CloseStatus);
+
 UninitVirtioFs:
   VirtioFsUninit (VirtioFs);
 
@@ -163,6 +178,10 @@ VirtioFsBindingStop (
   Status = gBS->CloseEvent (VirtioFs->ExitBoot);
   ASSERT_EFI_ERROR (Status);
 
+  VirtioFsLookupCacheFlush (VirtioFs);
+  Status = gBS->CloseEvent (VirtioFs->LookupCacheTimer);
+  ASSERT_EFI_ERROR (Status);
+
   VirtioFsUninit (VirtioFs);
 
   Status = gBS->CloseProtocol (ControllerHandle, &gVirtioDeviceProtocolGuid,
@@ -0,0 +1,134 @@
+/** @file
+  FUSE_BATCH_FORGET wrapper for the Virtio Filesystem device.
+
+  Copyright (C) 2020, Red Hat, Inc.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Library/MemoryAllocationLib.h> // AllocatePool()
+
+#include "VirtioFsDxe.h"
+
+/**
+  Make the Virtio Filesysem device drop one reference count from each NodeId in
+  a list of NodeIds that the driver looked up by filename.
+
+  Send the FUSE_BATCH_FORGET request to the Virtio Filesysem device for this,
+  so that a single virtio request replaces a series of FUSE_FORGET requests.
+  Like FUSE_FORGET, FUSE_BATCH_FORGET doesn't elicit a response, not even the
+  common VIRTIO_FS_FUSE_RESPONSE header.
+
+  If the temporary array for the request cannot be allocated, the function
+  falls back to sending one FUSE_FORGET request per NodeId.
+
+  The function may only be called after VirtioFsFuseInitSession() returns
+  successfully and before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device to send the
+                           FUSE_BATCH_FORGET request to. On output, the FUSE
+                           request counter "VirtioFs->RequestId" will have been
+                           incremented.
+
+  @param[in] NumNodeIds    The number of elements in NodeIds. If zero, the
+                           function does nothing.
+
+  @param[in] NodeIds       The inode numbers that the client learned by way of
+                           lookup, and that the server should now un-reference
+                           exactly once each.
+
+  @retval EFI_SUCCESS  The FUSE_BATCH_FORGET request has been submitted, or
+                       NumNodeIds is zero.
+
+  @return              Error codes propagated from VirtioFsSgListsValidate(),
+                       VirtioFsFuseNewRequest(), VirtioFsSgListsSubmit(),
+                       VirtioFsFuseForget().
+**/
+EFI_STATUS
+VirtioFsFuseBatchForget (
+  IN OUT VIRTIO_FS *VirtioFs,
+  IN     UINTN     NumNodeIds,
+  IN     UINT64    *NodeIds
+  )
+{
+  VIRTIO_FS_FUSE_REQUEST              CommonReq;
+  VIRTIO_FS_FUSE_BATCH_FORGET_REQUEST BatchForgetReq;
+  VIRTIO_FS_FUSE_FORGET_ONE           *ForgetOne;
+  VIRTIO_FS_IO_VECTOR                 ReqIoVec[3];
+  VIRTIO_FS_SCATTER_GATHER_LIST       ReqSgList;
+  UINTN                               Idx;
+  EFI_STATUS                          Status;
+
+  if (NumNodeIds == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if (NumNodeIds > MAX_UINT32 ||
+      NumNodeIds > MAX_UINTN / sizeof *ForgetOne) {
+    ForgetOne = NULL;
+  } else {
+    ForgetOne = AllocatePool (NumNodeIds * sizeof *ForgetOne);
+  }
+  if (ForgetOne == NULL) {
+    Status = EFI_SUCCESS;
+    for (Idx = 0; Idx < NumNodeIds; Idx++) {
+      EFI_STATUS ForgetStatus;
+
+      ForgetStatus = VirtioFsFuseForget (VirtioFs, NodeIds[Idx]);
+      if (EFI_ERROR (ForgetStatus) && !EFI_ERROR (Status)) {
+        Status = ForgetStatus;
+      }
+    }
+    return Status;
+  }
+
+  //
+  // Set up the scatter-gather list (note: only request).
+  //
+  ReqIoVec[0].Buffer = &CommonReq;
+  ReqIoVec[0].Size   = sizeof CommonReq;
+  ReqIoVec[1].Buffer = &BatchForgetReq;
+  ReqIoVec[1].Size   = sizeof BatchForgetReq;
+  ReqIoVec[2].Buffer = ForgetOne;
+  ReqIoVec[2].Size   = NumNodeIds * sizeof *ForgetOne;
+  ReqSgList.IoVec    = ReqIoVec;
+  ReqSgList.NumVec   = ARRAY_SIZE (ReqIoVec);
+
+  //
+  // Validate the scatter-gather list (request only); calculate the total
+  // transfer size.
+  //
+  Status = VirtioFsSgListsValidate (VirtioFs, &ReqSgList, NULL);
+  if (EFI_ERROR (Status)) {
+    goto FreeForgetOne;
+  }
+
+  //
+  // Populate the common request header. FUSE_BATCH_FORGET doesn't refer to
+  // any particular inode.
+  //
+  Status = VirtioFsFuseNewRequest (VirtioFs, &CommonReq, ReqSgList.TotalSize,
+             VirtioFsFuseOpBatchForget, 0);
+  if (EFI_ERROR (Status)) {
+    goto FreeForgetOne;
+  }
+
+  //
+  // Populate the FUSE_BATCH_FORGET-specific fields.
+  //
+  BatchForgetReq.Count = (UINT32)NumNodeIds;
+  BatchForgetReq.Dummy = 0;
+  for (Idx = 0; Idx < NumNodeIds; Idx++) {
+    ForgetOne[Idx].NodeId          = NodeIds[Idx];
+    ForgetOne[Idx].NumberOfLookups = 1;
+  }
+
+  //
+  // Submit the request. There's not going to be a response.
+  //
+  Status = VirtioFsSgListsSubmit (VirtioFs, &ReqSgList, NULL);
+
+FreeForgetOne:
+  FreePool (ForgetOne);
+  return Status;
+}
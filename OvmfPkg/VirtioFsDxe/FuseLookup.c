@@ -17,6 +17,11 @@
   The function returns EFI_NOT_FOUND exclusively if the Virtio Filesystem
   device explicitly responds with ENOENT -- "No such file or directory".
 
+  If the lookup cache (populated from FUSE_READDIRPLUS responses) has a valid
+  entry for Name in DirNodeId, then the function takes the inode and its
+  reference from the cache, and sends no request to the Virtio Filesystem
+  device.
+
   The function may only be called after VirtioFsFuseInitSession() returns
   successfully and before VirtioFsUninit() is called.
 
@@ -68,6 +73,10 @@ VirtioFsFuseLookup (
   VIRTIO_FS_SCATTER_GATHER_LIST RespSgList;
   EFI_STATUS                    Status;
 
+  if (VirtioFsLookupCacheTake (VirtioFs, DirNodeId, Name, NodeId, FuseAttr)) {
+    return EFI_SUCCESS;
+  }
+
   //
   // Set up the scatter-gather lists.
   //
@@ -189,3 +189,229 @@ VirtioFsFuseReadFileOrDir (
   *Size = (UINT32)TailBufferFill;
   return EFI_SUCCESS;
 }
+
+//
+// The buffers of one FUSE_READ request-response exchange, in a pipelined read.
+//
+typedef struct {
+  VIRTIO_FS_FUSE_REQUEST        CommonReq;
+  VIRTIO_FS_FUSE_READ_REQUEST   ReadReq;
+  VIRTIO_FS_IO_VECTOR           ReqIoVec[2];
+  VIRTIO_FS_SCATTER_GATHER_LIST ReqSgList;
+  VIRTIO_FS_FUSE_RESPONSE       CommonResp;
+  VIRTIO_FS_IO_VECTOR           RespIoVec[2];
+  VIRTIO_FS_SCATTER_GATHER_LIST RespSgList;
+} VIRTIO_FS_READ_CHUNK;
+
+/**
+  Set up the scatter-gather lists and the request headers of one FUSE_READ
+  exchange in a pipelined read.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device to send the FUSE_READ
+                           request to. On output, the FUSE request counter
+                           "VirtioFs->RequestId" will have been incremented.
+
+  @param[in] NodeId        The inode number of the regular file to read from.
+
+  @param[in] FuseHandle    The open handle to the regular file to read from.
+
+  @param[in] Offset        The absolute file position at which to start
+                           reading.
+
+  @param[in] Size          The number of bytes to read.
+
+  @param[out] Data         The buffer to read the bytes into.
+
+  @param[out] Chunk        The VIRTIO_FS_READ_CHUNK object to populate.
+
+  @retval EFI_SUCCESS  Chunk is ready for VirtioFsSgListsSubmitMultiple().
+
+  @return              Error codes propagated from VirtioFsSgListsValidate(),
+                       VirtioFsFuseNewRequest().
+**/
+STATIC
+EFI_STATUS
+VirtioFsFuseReadChunkSetup (
+  IN OUT VIRTIO_FS            *VirtioFs,
+  IN     UINT64               NodeId,
+  IN     UINT64               FuseHandle,
+  IN     UINT64               Offset,
+  IN     UINT32               Size,
+     OUT VOID                 *Data,
+     OUT VIRTIO_FS_READ_CHUNK *Chunk
+  )
+{
+  EFI_STATUS Status;
+
+  Chunk->ReqIoVec[0].Buffer = &Chunk->CommonReq;
+  Chunk->ReqIoVec[0].Size   = sizeof Chunk->CommonReq;
+  Chunk->ReqIoVec[1].Buffer = &Chunk->ReadReq;
+  Chunk->ReqIoVec[1].Size   = sizeof Chunk->ReadReq;
+  Chunk->ReqSgList.IoVec    = Chunk->ReqIoVec;
+  Chunk->ReqSgList.NumVec   = ARRAY_SIZE (Chunk->ReqIoVec);
+
+  Chunk->RespIoVec[0].Buffer = &Chunk->CommonResp;
+  Chunk->RespIoVec[0].Size   = sizeof Chunk->CommonResp;
+  Chunk->RespIoVec[1].Buffer = Data;
+  Chunk->RespIoVec[1].Size   = Size;
+  Chunk->RespSgList.IoVec    = Chunk->RespIoVec;
+  Chunk->RespSgList.NumVec   = ARRAY_SIZE (Chunk->RespIoVec);
+
+  Status = VirtioFsSgListsValidate (VirtioFs, &Chunk->ReqSgList,
+             &Chunk->RespSgList);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = VirtioFsFuseNewRequest (VirtioFs, &Chunk->CommonReq,
+             Chunk->ReqSgList.TotalSize, VirtioFsFuseOpRead, NodeId);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Chunk->ReadReq.FileHandle = FuseHandle;
+  Chunk->ReadReq.Offset     = Offset;
+  Chunk->ReadReq.Size       = Size;
+  Chunk->ReadReq.ReadFlags  = 0;
+  Chunk->ReadReq.LockOwner  = 0;
+  Chunk->ReadReq.Flags      = 0;
+  Chunk->ReadReq.Padding    = 0;
+  return EFI_SUCCESS;
+}
+
+/**
+  Read a range of bytes from a regular file, by keeping multiple FUSE_READ
+  requests in flight to the Virtio Filesystem device.
+
+  The range is split into chunks of at most "VirtioFs->MaxWrite" bytes, and up
+  to VIRTIO_FS_MAX_PIPELINE_DEPTH chunks are submitted to the Virtio Filesystem
+  device at once, so that the device can work on them while it completes
+  earlier ones. If the device returns fewer bytes for a chunk than requested,
+  then the data of the subsequent chunks in the same batch is discarded, and
+  reading continues at the file position right after the short chunk.
+
+  The function may only be called after VirtioFsFuseInitSession() returns
+  successfully and before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device to send the FUSE_READ
+                           requests to. On output, the FUSE request counter
+                           "VirtioFs->RequestId" will have been incremented
+                           once per request.
+
+  @param[in] NodeId        The inode number of the regular file to read from.
+
+  @param[in] FuseHandle    The open handle to the regular file to read from.
+
+  @param[in] Offset        The absolute file position at which to start
+                           reading.
+
+  @param[in,out] Size      On input, the number of bytes to read. On output,
+                           the number of bytes actually read, which may be
+                           smaller than the value on input, due to EOF or
+                           due to an error. The output value is meaningful
+                           even if the function fails.
+
+  @param[out] Data         Buffer to read the bytes from the regular file into.
+                           The caller is responsible for providing room for (at
+                           least) as many bytes in Data as Size is on input.
+
+  @retval EFI_SUCCESS  Read successful, up to EOF or up to Size on input.
+
+  @return              The "errno" value mapped to an EFI_STATUS code, if the
+                       Virtio Filesystem device explicitly reported an error.
+
+  @return              Error codes propagated from VirtioFsSgListsValidate(),
+                       VirtioFsFuseNewRequest(),
+                       VirtioFsSgListsSubmitMultiple(),
+                       VirtioFsFuseCheckResponse().
+**/
+EFI_STATUS
+VirtioFsFuseReadFilePipelined (
+  IN OUT VIRTIO_FS *VirtioFs,
+  IN     UINT64    NodeId,
+  IN     UINT64    FuseHandle,
+  IN     UINT64    Offset,
+  IN OUT UINTN     *Size,
+     OUT VOID      *Data
+  )
+{
+  VIRTIO_FS_READ_CHUNK Chunk[VIRTIO_FS_MAX_PIPELINE_DEPTH];
+  VIRTIO_FS_EXCHANGE   Exchange[VIRTIO_FS_MAX_PIPELINE_DEPTH];
+  UINTN                Depth;
+  UINTN                NumChunks;
+  UINTN                Idx;
+  UINTN                Transferred;
+  UINTN                Carved;
+  UINTN                BatchTransferred;
+  UINTN                TailBufferFill;
+  UINT32               ChunkSize;
+  EFI_STATUS           Status;
+
+  //
+  // Each FUSE_READ exchange takes four descriptors.
+  //
+  Depth = MIN (VIRTIO_FS_MAX_PIPELINE_DEPTH, VirtioFs->QueueSize / 4);
+  Depth = MAX (Depth, 1);
+
+  Status      = EFI_SUCCESS;
+  Transferred = 0;
+  while (Transferred < *Size) {
+    //
+    // Carve the next batch of chunks out of the remaining range.
+    //
+    Carved = Transferred;
+    for (NumChunks = 0; NumChunks < Depth && Carved < *Size; NumChunks++) {
+      ChunkSize = (UINT32)MIN ((UINTN)VirtioFs->MaxWrite, *Size - Carved);
+      Status = VirtioFsFuseReadChunkSetup (VirtioFs, NodeId, FuseHandle,
+                 Offset + Carved, ChunkSize, (UINT8 *)Data + Carved,
+                 &Chunk[NumChunks]);
+      if (EFI_ERROR (Status)) {
+        goto Exit;
+      }
+      Exchange[NumChunks].RequestSgList  = &Chunk[NumChunks].ReqSgList;
+      Exchange[NumChunks].ResponseSgList = &Chunk[NumChunks].RespSgList;
+      Carved += ChunkSize;
+    }
+
+    Status = VirtioFsSgListsSubmitMultiple (VirtioFs, NumChunks, Exchange);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
+
+    //
+    // Collect the chunks in file order, up to and including the first error,
+    // or the first short chunk.
+    //
+    BatchTransferred = 0;
+    for (Idx = 0; Idx < NumChunks; Idx++) {
+      Status = VirtioFsFuseCheckResponse (&Chunk[Idx].RespSgList,
+                 Chunk[Idx].CommonReq.Unique, &TailBufferFill);
+      if (EFI_ERROR (Status)) {
+        if (Status == EFI_DEVICE_ERROR) {
+          DEBUG ((DEBUG_ERROR, "%a: Label=\"%s\" NodeId=%Lu FuseHandle=%Lu "
+            "Offset=0x%Lx Size=0x%x Errno=%d\n", __FUNCTION__,
+            VirtioFs->Label, NodeId, FuseHandle, Chunk[Idx].ReadReq.Offset,
+            Chunk[Idx].ReadReq.Size, Chunk[Idx].CommonResp.Error));
+          Status = VirtioFsErrnoToEfiStatus (Chunk[Idx].CommonResp.Error);
+        }
+        break;
+      }
+      BatchTransferred += TailBufferFill;
+      if (TailBufferFill < Chunk[Idx].ReadReq.Size) {
+        break;
+      }
+    }
+    Transferred += BatchTransferred;
+
+    if (EFI_ERROR (Status) || BatchTransferred == 0) {
+      //
+      // Error, or EOF.
+      //
+      break;
+    }
+  }
+
+Exit:
+  *Size = Transferred;
+  return Status;
+}
@@ -55,6 +55,11 @@ VirtioFsFuseRemoveFileOrDir (
   VIRTIO_FS_SCATTER_GATHER_LIST RespSgList;
   EFI_STATUS                    Status;
 
+  //
+  // Drop the cached lookups; they might not reflect the modified filesystem.
+  //
+  VirtioFsLookupCacheFlush (VirtioFs);
+
   //
   // Set up the scatter-gather lists.
   //
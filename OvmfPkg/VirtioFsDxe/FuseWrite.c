@@ -8,16 +8,134 @@
 
 #include "VirtioFsDxe.h"
 
+//
+// The buffers of one FUSE_WRITE request-response exchange, in a pipelined
+// write.
+//
+typedef struct {
+  VIRTIO_FS_FUSE_REQUEST        CommonReq;
+  VIRTIO_FS_FUSE_WRITE_REQUEST  WriteReq;
+  VIRTIO_FS_IO_VECTOR           ReqIoVec[3];
+  VIRTIO_FS_SCATTER_GATHER_LIST ReqSgList;
+  VIRTIO_FS_FUSE_RESPONSE       CommonResp;
+  VIRTIO_FS_FUSE_WRITE_RESPONSE WriteResp;
+  VIRTIO_FS_IO_VECTOR           RespIoVec[2];
+  VIRTIO_FS_SCATTER_GATHER_LIST RespSgList;
+} VIRTIO_FS_WRITE_CHUNK;
+
+/**
+  Set up the scatter-gather lists and the request headers of one FUSE_WRITE
+  exchange in a pipelined write.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device to send the FUSE_WRITE
+                           request to. On output, the FUSE request counter
+                           "VirtioFs->RequestId" will have been incremented.
+
+  @param[in] NodeId        The inode number of the regular file to write to.
+
+  @param[in] FuseHandle    The open handle to the regular file to write to.
+
+  @param[in] Offset        The absolute file position at which to start
+                           writing.
+
+  @param[in] Size          The number of bytes to write. The caller is
+                           responsible for ensuring that Size not exceed
+                           "VirtioFs->MaxWrite".
+
+  @param[in] Data          The buffer to write to the regular file.
+
+  @param[out] Chunk        The VIRTIO_FS_WRITE_CHUNK object to populate.
+
+  @retval EFI_SUCCESS  Chunk is ready for VirtioFsSgListsSubmitMultiple().
+
+  @return              Error codes propagated from VirtioFsSgListsValidate(),
+                       VirtioFsFuseNewRequest().
+**/
+STATIC
+EFI_STATUS
+VirtioFsFuseWriteChunkSetup (
+  IN OUT VIRTIO_FS             *VirtioFs,
+  IN     UINT64                NodeId,
+  IN     UINT64                FuseHandle,
+  IN     UINT64                Offset,
+  IN     UINT32                Size,
+  IN     VOID                  *Data,
+     OUT VIRTIO_FS_WRITE_CHUNK *Chunk
+  )
+{
+  EFI_STATUS Status;
+
+  ASSERT (Size <= VirtioFs->MaxWrite);
+
+  Chunk->ReqIoVec[0].Buffer = &Chunk->CommonReq;
+  Chunk->ReqIoVec[0].Size   = sizeof Chunk->CommonReq;
+  Chunk->ReqIoVec[1].Buffer = &Chunk->WriteReq;
+  Chunk->ReqIoVec[1].Size   = sizeof Chunk->WriteReq;
+  Chunk->ReqIoVec[2].Buffer = Data;
+  Chunk->ReqIoVec[2].Size   = Size;
+  Chunk->ReqSgList.IoVec    = Chunk->ReqIoVec;
+  Chunk->ReqSgList.NumVec   = ARRAY_SIZE (Chunk->ReqIoVec);
+
+  Chunk->RespIoVec[0].Buffer = &Chunk->CommonResp;
+  Chunk->RespIoVec[0].Size   = sizeof Chunk->CommonResp;
+  Chunk->RespIoVec[1].Buffer = &Chunk->WriteResp;
+  Chunk->RespIoVec[1].Size   = sizeof Chunk->WriteResp;
+  Chunk->RespSgList.IoVec    = Chunk->RespIoVec;
+  Chunk->RespSgList.NumVec   = ARRAY_SIZE (Chunk->RespIoVec);
+
+  Status = VirtioFsSgListsValidate (VirtioFs, &Chunk->ReqSgList,
+             &Chunk->RespSgList);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = VirtioFsFuseNewRequest (VirtioFs, &Chunk->CommonReq,
+             Chunk->ReqSgList.TotalSize, VirtioFsFuseOpWrite, NodeId);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Chunk->WriteReq.FileHandle = FuseHandle;
+  Chunk->WriteReq.Offset     = Offset;
+  Chunk->WriteReq.Size       = Size;
+  Chunk->WriteReq.WriteFlags = 0;
+  Chunk->WriteReq.LockOwner  = 0;
+  Chunk->WriteReq.Flags      = 0;
+  Chunk->WriteReq.Padding    = 0;
+  return EFI_SUCCESS;
+}
+
 /**
-  Write a chunk to a regular file, by sending the FUSE_WRITE request to the
-  Virtio Filesystem device.
+  Write a range of bytes to a regular file, by keeping multiple FUSE_WRITE
+  requests in flight to the Virtio Filesystem device.
+
+  The range is split into chunks of at most "VirtioFs->MaxWrite" bytes (the
+  write buffer size limit of the Virtio Filesystem device), and up to
+  VIRTIO_FS_MAX_PIPELINE_DEPTH chunks are submitted to the Virtio Filesystem
+  device at once. If the device writes fewer bytes for a chunk than requested,
+  then the subsequent chunks in the same batch are not accounted for, and
+  writing continues at the file position right after the short chunk,
+  rewriting whatever the device may have stored for those chunks.
+
+  If a chunk fails, the chunks after it in the same batch may have been written
+  nonetheless. To keep such chunks from extending the file past the bytes
+  reported as written, the file size is fetched before a range of more than
+  one chunk is written, and on failure the file is truncated to the larger of
+  that size and the end of the bytes reported as written. Within the original
+  size of the file, the bytes after the ones reported as written may have been
+  overwritten. If the file size cannot be fetched, the chunks are written one
+  at a time.
+
+  The lookup cache is flushed before the first request is sent, as the
+  attributes cached for the file are about to change.
 
   The function may only be called after VirtioFsFuseInitSession() returns
   successfully and before VirtioFsUninit() is called.
 
   @param[in,out] VirtioFs  The Virtio Filesystem device to send the FUSE_WRITE
-                           request to. On output, the FUSE request counter
-                           "VirtioFs->RequestId" will have been incremented.
+                           requests to. On output, the FUSE request counter
+                           "VirtioFs->RequestId" will have been incremented
+                           once per request.
 
   @param[in] NodeId        The inode number of the regular file to write to.
 
@@ -26,130 +144,149 @@
   @param[in] Offset        The absolute file position at which to start
                            writing.
 
-  @param[in,out] Size      On input, the number of bytes to write. On
-                           successful return, the number of bytes actually
-                           written, which may be smaller than the value on
-                           input.
+  @param[in,out] Size      On input, the number of bytes to write. On output,
+                           the number of bytes actually written. The output
+                           value is meaningful even if the function fails.
 
   @param[in] Data          The buffer to write to the regular file.
 
-  @retval EFI_SUCCESS          Write successful. The caller is responsible for
-                               checking Size to learn the actual byte count
-                               transferred.
+  @retval EFI_SUCCESS       All bytes have been written.
 
-  @retval EFI_BAD_BUFFER_SIZE  On input, Size is larger than
-                               "VirtioFs->MaxWrite".
+  @retval EFI_DEVICE_ERROR  The Virtio Filesystem device made no progress on
+                            a chunk, or reported more bytes written than
+                            requested.
 
-  @return                      The "errno" value mapped to an EFI_STATUS code,
-                               if the Virtio Filesystem device explicitly
-                               reported an error.
+  @return                   The "errno" value mapped to an EFI_STATUS code, if
+                            the Virtio Filesystem device explicitly reported an
+                            error.
 
-  @return                      Error codes propagated from
-                               VirtioFsSgListsValidate(),
-                               VirtioFsFuseNewRequest(),
-                               VirtioFsSgListsSubmit(),
-                               VirtioFsFuseCheckResponse().
+  @return                   Error codes propagated from
+                            VirtioFsSgListsValidate(),
+                            VirtioFsFuseNewRequest(),
+                            VirtioFsSgListsSubmitMultiple(),
+                            VirtioFsFuseCheckResponse().
 **/
 EFI_STATUS
-VirtioFsFuseWrite (
+VirtioFsFuseWritePipelined (
   IN OUT VIRTIO_FS *VirtioFs,
   IN     UINT64    NodeId,
   IN     UINT64    FuseHandle,
   IN     UINT64    Offset,
-  IN OUT UINT32    *Size,
+  IN OUT UINTN     *Size,
   IN     VOID      *Data
   )
 {
-  VIRTIO_FS_FUSE_REQUEST        CommonReq;
-  VIRTIO_FS_FUSE_WRITE_REQUEST  WriteReq;
-  VIRTIO_FS_IO_VECTOR           ReqIoVec[3];
-  VIRTIO_FS_SCATTER_GATHER_LIST ReqSgList;
-  VIRTIO_FS_FUSE_RESPONSE       CommonResp;
-  VIRTIO_FS_FUSE_WRITE_RESPONSE WriteResp;
-  VIRTIO_FS_IO_VECTOR           RespIoVec[2];
-  VIRTIO_FS_SCATTER_GATHER_LIST RespSgList;
-  EFI_STATUS                    Status;
+  VIRTIO_FS_WRITE_CHUNK Chunk[VIRTIO_FS_MAX_PIPELINE_DEPTH];
+  VIRTIO_FS_EXCHANGE    Exchange[VIRTIO_FS_MAX_PIPELINE_DEPTH];
+  UINTN                 Depth;
+  UINTN                 NumChunks;
+  UINTN                 Idx;
+  UINTN                 Transferred;
+  UINTN                 Carved;
+  UINTN                 BatchTransferred;
+  UINT32                ChunkSize;
+  BOOLEAN               SizeKnown;
+  UINT64                FileSize;
+  EFI_STATUS            Status;
+  EFI_STATUS            TruncateStatus;
 
-  //
-  // Honor the write buffer size limit of the Virtio Filesystem device.
-  //
-  if (*Size > VirtioFs->MaxWrite) {
-    return EFI_BAD_BUFFER_SIZE;
-  }
+  VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE FuseAttr;
 
-  //
-  // Set up the scatter-gather lists.
-  //
-  ReqIoVec[0].Buffer = &CommonReq;
-  ReqIoVec[0].Size   = sizeof CommonReq;
-  ReqIoVec[1].Buffer = &WriteReq;
-  ReqIoVec[1].Size   = sizeof WriteReq;
-  ReqIoVec[2].Buffer = Data;
-  ReqIoVec[2].Size   = *Size;
-  ReqSgList.IoVec    = ReqIoVec;
-  ReqSgList.NumVec   = ARRAY_SIZE (ReqIoVec);
-
-  RespIoVec[0].Buffer = &CommonResp;
-  RespIoVec[0].Size   = sizeof CommonResp;
-  RespIoVec[1].Buffer = &WriteResp;
-  RespIoVec[1].Size   = sizeof WriteResp;
-  RespSgList.IoVec    = RespIoVec;
-  RespSgList.NumVec   = ARRAY_SIZE (RespIoVec);
+  VirtioFsLookupCacheFlush (VirtioFs);
 
   //
-  // Validate the scatter-gather lists; calculate the total transfer sizes.
+  // Each FUSE_WRITE exchange takes five descriptors.
   //
-  Status = VirtioFsSgListsValidate (VirtioFs, &ReqSgList, &RespSgList);
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
+  Depth = MIN (VIRTIO_FS_MAX_PIPELINE_DEPTH, VirtioFs->QueueSize / 5);
+  Depth = MAX (Depth, 1);
 
-  //
-  // Populate the common request header.
-  //
-  Status = VirtioFsFuseNewRequest (VirtioFs, &CommonReq, ReqSgList.TotalSize,
-             VirtioFsFuseOpWrite, NodeId);
-  if (EFI_ERROR (Status)) {
-    return Status;
+  SizeKnown = FALSE;
+  FileSize  = 0;
+  if (Depth > 1 && *Size > VirtioFs->MaxWrite) {
+    Status = VirtioFsFuseGetAttr (VirtioFs, NodeId, &FuseAttr);
+    if (EFI_ERROR (Status)) {
+      Depth = 1;
+    } else {
+      SizeKnown = TRUE;
+      FileSize  = FuseAttr.Size;
+    }
   }
 
-  //
-  // Populate the FUSE_WRITE-specific fields.
-  //
-  WriteReq.FileHandle = FuseHandle;
-  WriteReq.Offset     = Offset;
-  WriteReq.Size       = *Size;
-  WriteReq.WriteFlags = 0;
-  WriteReq.LockOwner  = 0;
-  WriteReq.Flags      = 0;
-  WriteReq.Padding    = 0;
+  Status      = EFI_SUCCESS;
+  Transferred = 0;
+  while (Transferred < *Size) {
+    //
+    // Carve the next batch of chunks out of the remaining range.
+    //
+    Carved = Transferred;
+    for (NumChunks = 0; NumChunks < Depth && Carved < *Size; NumChunks++) {
+      ChunkSize = (UINT32)MIN ((UINTN)VirtioFs->MaxWrite, *Size - Carved);
+      Status = VirtioFsFuseWriteChunkSetup (VirtioFs, NodeId, FuseHandle,
+                 Offset + Carved, ChunkSize, (UINT8 *)Data + Carved,
+                 &Chunk[NumChunks]);
+      if (EFI_ERROR (Status)) {
+        goto Exit;
+      }
+      Exchange[NumChunks].RequestSgList  = &Chunk[NumChunks].ReqSgList;
+      Exchange[NumChunks].ResponseSgList = &Chunk[NumChunks].RespSgList;
+      Carved += ChunkSize;
+    }
 
-  //
-  // Submit the request.
-  //
-  Status = VirtioFsSgListsSubmit (VirtioFs, &ReqSgList, &RespSgList);
-  if (EFI_ERROR (Status)) {
-    return Status;
+    Status = VirtioFsSgListsSubmitMultiple (VirtioFs, NumChunks, Exchange);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
+
+    //
+    // Collect the chunks in file order, up to and including the first error,
+    // or the first short chunk.
+    //
+    BatchTransferred = 0;
+    for (Idx = 0; Idx < NumChunks; Idx++) {
+      Status = VirtioFsFuseCheckResponse (&Chunk[Idx].RespSgList,
+                 Chunk[Idx].CommonReq.Unique, NULL);
+      if (EFI_ERROR (Status)) {
+        if (Status == EFI_DEVICE_ERROR) {
+          DEBUG ((DEBUG_ERROR, "%a: Label=\"%s\" NodeId=%Lu FuseHandle=%Lu "
+            "Offset=0x%Lx Size=0x%x Errno=%d\n", __FUNCTION__,
+            VirtioFs->Label, NodeId, FuseHandle, Chunk[Idx].WriteReq.Offset,
+            Chunk[Idx].WriteReq.Size, Chunk[Idx].CommonResp.Error));
+          Status = VirtioFsErrnoToEfiStatus (Chunk[Idx].CommonResp.Error);
+        }
+        break;
+      }
+      if (Chunk[Idx].WriteResp.Size == 0 ||
+          Chunk[Idx].WriteResp.Size > Chunk[Idx].WriteReq.Size) {
+        //
+        // Progress should have been made, within the chunk.
+        //
+        Status = EFI_DEVICE_ERROR;
+        break;
+      }
+      BatchTransferred += Chunk[Idx].WriteResp.Size;
+      if (Chunk[Idx].WriteResp.Size < Chunk[Idx].WriteReq.Size) {
+        break;
+      }
+    }
+    Transferred += BatchTransferred;
+
+    if (EFI_ERROR (Status)) {
+      break;
+    }
   }
 
-  //
-  // Verify the response (all response buffers are fixed size).
-  //
-  Status = VirtioFsFuseCheckResponse (&RespSgList, CommonReq.Unique, NULL);
-  if (EFI_ERROR (Status)) {
-    if (Status == EFI_DEVICE_ERROR) {
-      DEBUG ((DEBUG_ERROR, "%a: Label=\"%s\" NodeId=%Lu FuseHandle=%Lu "
-        "Offset=0x%Lx Size=0x%x Data@%p Errno=%d\n", __FUNCTION__,
-        VirtioFs->Label, NodeId, FuseHandle, Offset, *Size, Data,
-        CommonResp.Error));
-      Status = VirtioFsErrnoToEfiStatus (CommonResp.Error);
+Exit:
+  if (EFI_ERROR (Status) && SizeKnown) {
+    FileSize = MAX (FileSize, Offset + Transferred);
+    TruncateStatus = VirtioFsFuseSetAttr (VirtioFs, NodeId, &FileSize, NULL,
+                       NULL, NULL);
+    if (EFI_ERROR (TruncateStatus)) {
+      DEBUG ((DEBUG_ERROR, "%a: Label=\"%s\" NodeId=%Lu FileSize=0x%Lx: "
+        "failed to truncate: %r\n", __FUNCTION__, VirtioFs->Label, NodeId,
+        FileSize, TruncateStatus));
     }
-    return Status;
   }
 
-  //
-  // Report the actual transfer size.
-  //
-  *Size = WriteResp.Size;
-  return EFI_SUCCESS;
+  *Size = Transferred;
+  return Status;
 }
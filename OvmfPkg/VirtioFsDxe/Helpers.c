@@ -10,6 +10,7 @@
 #include <Library/BaseMemoryLib.h>       // CopyMem()
 #include <Library/MemoryAllocationLib.h> // AllocatePool()
 #include <Library/TimeBaseLib.h>         // EpochToEfiTime()
+#include <Library/UefiBootServicesTableLib.h> // gBS
 #include <Library/VirtioLib.h>           // Virtio10WriteFeatures()
 
 #include "VirtioFsDxe.h"
@@ -454,6 +455,87 @@ VirtioFsSgListsValidate (
   return EFI_SUCCESS;
 }
 
+/**
+  Unmap the IO Vectors of a pair of (request buffer list, response buffer
+  list) that VirtioFsSgListsSubmitMultiple() has mapped, in reverse order of
+  mapping, in an attempt to avoid memory fragmentation.
+
+  The following fields are re-set to the values they initially got from
+  VirtioFsSgListsValidate(), even if unmapping fails:
+  - VIRTIO_FS_IO_VECTOR.Mapped,
+  - VIRTIO_FS_IO_VECTOR.MappedAddress,
+  - VIRTIO_FS_IO_VECTOR.Mapping.
+
+  @param[in] VirtioFs            The Virtio Filesystem device that the
+                                 exchange was submitted to.
+
+  @param[in,out] RequestSgList   The request part of the exchange.
+
+  @param[in,out] ResponseSgList  The response part of the exchange. May be
+                                 NULL.
+
+  @param[in] Status              The status of the exchange so far.
+
+  @return  Status if Status is an error code, or if all IO Vectors have been
+           unmapped successfully. Otherwise, the first error code returned by
+           VirtioFs->Virtio->UnmapSharedBuffer().
+**/
+STATIC
+EFI_STATUS
+VirtioFsSgListsUnmap (
+  IN     VIRTIO_FS                     *VirtioFs,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST *RequestSgList,
+  IN OUT VIRTIO_FS_SCATTER_GATHER_LIST *ResponseSgList OPTIONAL,
+  IN     EFI_STATUS                    Status
+  )
+{
+  VIRTIO_FS_SCATTER_GATHER_LIST *SgListParam[2];
+  UINTN                         ListId;
+  VIRTIO_FS_SCATTER_GATHER_LIST *SgList;
+  UINTN                         IoVecIdx;
+  VIRTIO_FS_IO_VECTOR           *IoVec;
+  EFI_STATUS                    UnmapStatus;
+
+  SgListParam[0] = RequestSgList;
+  SgListParam[1] = ResponseSgList;
+
+  ListId = ARRAY_SIZE (SgListParam);
+  while (ListId > 0) {
+    --ListId;
+    SgList = SgListParam[ListId];
+    if (SgList == NULL) {
+      continue;
+    }
+    IoVecIdx = SgList->NumVec;
+    while (IoVecIdx > 0) {
+      --IoVecIdx;
+      IoVec = &SgList->IoVec[IoVecIdx];
+      //
+      // Unmap this IO Vector, if it has been mapped.
+      //
+      if (!IoVec->Mapped) {
+        continue;
+      }
+      UnmapStatus = VirtioFs->Virtio->UnmapSharedBuffer (VirtioFs->Virtio,
+                                        IoVec->Mapping);
+      IoVec->Mapped        = FALSE;
+      IoVec->MappedAddress = 0;
+      IoVec->Mapping       = NULL;
+
+      //
+      // If we are on the success path, but the unmapping failed, we need to
+      // transparently flip to the failure path -- the caller must learn they
+      // should not consult the response buffers.
+      //
+      if (!EFI_ERROR (Status) && EFI_ERROR (UnmapStatus)) {
+        Status = UnmapStatus;
+      }
+    }
+  }
+
+  return Status;
+}
+
 /**
   Submit a validated pair of (request buffer list, response buffer list) to the
   Virtio Filesystem device.
@@ -500,8 +582,7 @@ VirtioFsSgListsValidate (
                             more response bytes than ResponseSgList->TotalSize.
 
   @return                   Error codes propagated from
-                            VirtioMapAllBytesInSharedBuffer(), VirtioFlush(),
-                            or VirtioFs->Virtio->UnmapSharedBuffer().
+                            VirtioFsSgListsSubmitMultiple().
 **/
 EFI_STATUS
 VirtioFsSgListsSubmit (
@@ -509,195 +590,308 @@ VirtioFsSgListsSubmit (
   IN OUT VIRTIO_FS_SCATTER_GATHER_LIST *RequestSgList,
   IN OUT VIRTIO_FS_SCATTER_GATHER_LIST *ResponseSgList OPTIONAL
   )
+{
+  VIRTIO_FS_EXCHANGE Exchange;
+
+  Exchange.RequestSgList  = RequestSgList;
+  Exchange.ResponseSgList = ResponseSgList;
+  return VirtioFsSgListsSubmitMultiple (VirtioFs, 1, &Exchange);
+}
+
+/**
+  Submit a number of validated request-response exchanges to the Virtio
+  Filesystem device at once, and wait until the device completes all of them.
+
+  Each exchange gets its own descriptor chain, all chains are made available
+  to the device together, and the device is notified once. This lets the
+  Virtio Filesystem device work on the exchanges in parallel.
+
+  On input, the pair of VIRTIO_FS_SCATTER_GATHER_LIST objects in each exchange
+  must have been validated together, using the VirtioFsSgListsValidate()
+  function.
+
+  On output, the fields listed at VirtioFsSgListsSubmit() are updated in each
+  exchange.
+
+  The function may only be called after VirtioFsInit() returns successfully and
+  before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs   The Virtio Filesystem device that the exchanges
+                            should now be submitted to.
+
+  @param[in] NumExchanges   The number of elements in Exchanges. Must be
+                            nonzero, and at most VIRTIO_FS_MAX_PIPELINE_DEPTH.
+
+  @param[in,out] Exchanges  The request-response exchanges to submit.
+
+  @retval EFI_SUCCESS            All exchanges complete. The caller should
+                                 investigate the response buffers of each
+                                 exchange like described at
+                                 VirtioFsSgListsSubmit().
+
+  @retval EFI_INVALID_PARAMETER  NumExchanges is zero or larger than
+                                 VIRTIO_FS_MAX_PIPELINE_DEPTH.
+
+  @retval EFI_UNSUPPORTED        The exchanges need more descriptors together
+                                 than VirtioFs->QueueSize.
+
+  @retval EFI_DEVICE_ERROR       The Virtio Filesystem device reported
+                                 populating more response bytes than
+                                 ResponseSgList->TotalSize for an exchange, or
+                                 completed a descriptor chain that it had not
+                                 been given.
+
+  @return                        Error codes propagated from
+                                 VirtioMapAllBytesInSharedBuffer(),
+                                 VirtioFs->Virtio->SetQueueNotify(), or
+                                 VirtioFs->Virtio->UnmapSharedBuffer().
+**/
+EFI_STATUS
+VirtioFsSgListsSubmitMultiple (
+  IN OUT VIRTIO_FS          *VirtioFs,
+  IN     UINTN              NumExchanges,
+  IN OUT VIRTIO_FS_EXCHANGE *Exchanges
+  )
 {
   VIRTIO_FS_SCATTER_GATHER_LIST *SgListParam[2];
   VIRTIO_MAP_OPERATION          SgListVirtioMapOp[ARRAY_SIZE (SgListParam)];
   UINT16                        SgListDescriptorFlag[ARRAY_SIZE (SgListParam)];
+  UINT16                        HeadDescIdx[VIRTIO_FS_MAX_PIPELINE_DEPTH];
+  UINT32                        BytesWritten[VIRTIO_FS_MAX_PIPELINE_DEPTH];
+  UINTN                         ExchangeIdx;
   UINTN                         ListId;
   VIRTIO_FS_SCATTER_GATHER_LIST *SgList;
   UINTN                         IoVecIdx;
   VIRTIO_FS_IO_VECTOR           *IoVec;
   EFI_STATUS                    Status;
   DESC_INDICES                  Indices;
+  UINTN                         DescriptorsNeeded;
+  UINT16                        AvailIdx;
+  UINT16                        LastUsedIdx;
+  UINTN                         PollPeriodUsecs;
   UINT32                        TotalBytesWrittenByDevice;
   UINT32                        BytesPermittedForWrite;
 
-  SgListParam[0]          = RequestSgList;
+  if (NumExchanges == 0 || NumExchanges > VIRTIO_FS_MAX_PIPELINE_DEPTH) {
+    return EFI_INVALID_PARAMETER;
+  }
+
   SgListVirtioMapOp[0]    = VirtioOperationBusMasterRead;
   SgListDescriptorFlag[0] = 0;
-
-  SgListParam[1]          = ResponseSgList;
   SgListVirtioMapOp[1]    = VirtioOperationBusMasterWrite;
   SgListDescriptorFlag[1] = VRING_DESC_F_WRITE;
 
   //
-  // Map all IO Vectors.
+  // VirtioFsSgListsValidate() has ensured that each exchange fits in the queue
+  // in isolation; make sure they fit together, too.
   //
-  for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
+  DescriptorsNeeded = 0;
+  for (ExchangeIdx = 0; ExchangeIdx < NumExchanges; ExchangeIdx++) {
+    DescriptorsNeeded += Exchanges[ExchangeIdx].RequestSgList->NumVec;
+    if (Exchanges[ExchangeIdx].ResponseSgList != NULL) {
+      DescriptorsNeeded += Exchanges[ExchangeIdx].ResponseSgList->NumVec;
     }
-    for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
-      IoVec = &SgList->IoVec[IoVecIdx];
-      //
-      // Map this IO Vector.
-      //
-      Status = VirtioMapAllBytesInSharedBuffer (
-                 VirtioFs->Virtio,
-                 SgListVirtioMapOp[ListId],
-                 IoVec->Buffer,
-                 IoVec->Size,
-                 &IoVec->MappedAddress,
-                 &IoVec->Mapping
-                 );
-      if (EFI_ERROR (Status)) {
-        goto Unmap;
+  }
+  if (DescriptorsNeeded > VirtioFs->QueueSize) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Map all IO Vectors.
+  //
+  Status = EFI_SUCCESS;
+  for (ExchangeIdx = 0; ExchangeIdx < NumExchanges; ExchangeIdx++) {
+    SgListParam[0] = Exchanges[ExchangeIdx].RequestSgList;
+    SgListParam[1] = Exchanges[ExchangeIdx].ResponseSgList;
+    for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
+      SgList = SgListParam[ListId];
+      if (SgList == NULL) {
+        continue;
+      }
+      for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+        IoVec = &SgList->IoVec[IoVecIdx];
+        Status = VirtioMapAllBytesInSharedBuffer (
+                   VirtioFs->Virtio,
+                   SgListVirtioMapOp[ListId],
+                   IoVec->Buffer,
+                   IoVec->Size,
+                   &IoVec->MappedAddress,
+                   &IoVec->Mapping
+                   );
+        if (EFI_ERROR (Status)) {
+          goto Unmap;
+        }
+        IoVec->Mapped = TRUE;
       }
-      IoVec->Mapped = TRUE;
     }
   }
 
   //
-  // Compose the descriptor chain.
+  // Compose the descriptor chains back to back. The queue is idle between
+  // calls, so the descriptor table is ours in its entirety.
   //
-  VirtioPrepare (&VirtioFs->Ring, &Indices);
-  for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
-    }
-    for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
-      UINT16 NextFlag;
+  *VirtioFs->Ring.Avail.Flags = (UINT16)VRING_AVAIL_F_NO_INTERRUPT;
+  Indices.HeadDescIdx = 0;
+  Indices.NextDescIdx = 0;
+  for (ExchangeIdx = 0; ExchangeIdx < NumExchanges; ExchangeIdx++) {
+    SgListParam[0] = Exchanges[ExchangeIdx].RequestSgList;
+    SgListParam[1] = Exchanges[ExchangeIdx].ResponseSgList;
 
-      IoVec = &SgList->IoVec[IoVecIdx];
-      //
-      // Set VRING_DESC_F_NEXT on all except the very last descriptor.
-      //
-      NextFlag = VRING_DESC_F_NEXT;
-      if (ListId == ARRAY_SIZE (SgListParam) - 1 &&
-          IoVecIdx == SgList->NumVec - 1) {
-        NextFlag = 0;
+    Indices.HeadDescIdx      = Indices.NextDescIdx;
+    HeadDescIdx[ExchangeIdx] = Indices.HeadDescIdx;
+    BytesWritten[ExchangeIdx] = MAX_UINT32;
+    for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
+      SgList = SgListParam[ListId];
+      if (SgList == NULL) {
+        continue;
+      }
+      for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+        UINT16 NextFlag;
+
+        IoVec = &SgList->IoVec[IoVecIdx];
+        //
+        // Set VRING_DESC_F_NEXT on all except the very last descriptor of the
+        // chain.
+        //
+        NextFlag = VRING_DESC_F_NEXT;
+        if ((ListId == ARRAY_SIZE (SgListParam) - 1 ||
+             SgListParam[1] == NULL) &&
+            IoVecIdx == SgList->NumVec - 1) {
+          NextFlag = 0;
+        }
+        VirtioAppendDesc (
+          &VirtioFs->Ring,
+          IoVec->MappedAddress,
+          (UINT32)IoVec->Size,
+          SgListDescriptorFlag[ListId] | NextFlag,
+          &Indices
+          );
       }
-      VirtioAppendDesc (
-        &VirtioFs->Ring,
-        IoVec->MappedAddress,
-        (UINT32)IoVec->Size,
-        SgListDescriptorFlag[ListId] | NextFlag,
-        &Indices
-        );
     }
   }
 
   //
-  // Submit the descriptor chain.
+  // virtio-0.9.5, 2.4.1.2 Updating the Available Ring; 2.4.1.3 Updating the
+  // Index Field; 2.4.1.4 Notifying the Device.
   //
-  Status = VirtioFlush (VirtioFs->Virtio, VIRTIO_FS_REQUEST_QUEUE,
-             &VirtioFs->Ring, &Indices, &TotalBytesWrittenByDevice);
+  AvailIdx    = *VirtioFs->Ring.Avail.Idx;
+  LastUsedIdx = AvailIdx;
+  for (ExchangeIdx = 0; ExchangeIdx < NumExchanges; ExchangeIdx++) {
+    VirtioFs->Ring.Avail.Ring[AvailIdx++ % VirtioFs->QueueSize] =
+      HeadDescIdx[ExchangeIdx];
+  }
+  MemoryFence ();
+  *VirtioFs->Ring.Avail.Idx = AvailIdx;
+
+  MemoryFence ();
+  Status = VirtioFs->Virtio->SetQueueNotify (VirtioFs->Virtio,
+                               VIRTIO_FS_REQUEST_QUEUE);
   if (EFI_ERROR (Status)) {
     goto Unmap;
   }
 
   //
-  // Sanity-check: the Virtio Filesystem device should not have written more
-  // bytes than what we offered buffers for.
+  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device. Wait until the
+  // device completes all chains, in whatever order; keep slowing down until we
+  // reach a poll period of slightly above 1 ms, like VirtioFlush() does.
   //
-  if (ResponseSgList == NULL) {
-    BytesPermittedForWrite = 0;
-  } else {
-    BytesPermittedForWrite = ResponseSgList->TotalSize;
+  PollPeriodUsecs = 1;
+  MemoryFence ();
+  while (*VirtioFs->Ring.Used.Idx != AvailIdx) {
+    gBS->Stall (PollPeriodUsecs);
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+    MemoryFence ();
   }
-  if (TotalBytesWrittenByDevice > BytesPermittedForWrite) {
-    Status = EFI_DEVICE_ERROR;
-    goto Unmap;
+  MemoryFence ();
+
+  while (LastUsedIdx != AvailIdx) {
+    volatile CONST VRING_USED_ELEM *UsedElem;
+
+    UsedElem = &VirtioFs->Ring.Used.UsedElem[LastUsedIdx++ %
+                                             VirtioFs->QueueSize];
+    for (ExchangeIdx = 0; ExchangeIdx < NumExchanges; ExchangeIdx++) {
+      if (UsedElem->Id == HeadDescIdx[ExchangeIdx]) {
+        break;
+      }
+    }
+    if (ExchangeIdx == NumExchanges ||
+        BytesWritten[ExchangeIdx] != MAX_UINT32) {
+      Status = EFI_DEVICE_ERROR;
+      goto Unmap;
+    }
+    BytesWritten[ExchangeIdx] = UsedElem->Len;
   }
 
-  //
-  // Update the transfer sizes in the IO Vectors.
-  //
-  for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
+  for (ExchangeIdx = 0; ExchangeIdx < NumExchanges; ExchangeIdx++) {
+    SgListParam[0] = Exchanges[ExchangeIdx].RequestSgList;
+    SgListParam[1] = Exchanges[ExchangeIdx].ResponseSgList;
+    TotalBytesWrittenByDevice = BytesWritten[ExchangeIdx];
+
+    //
+    // Sanity-check: the Virtio Filesystem device should not have written more
+    // bytes than what we offered buffers for.
+    //
+    if (SgListParam[1] == NULL) {
+      BytesPermittedForWrite = 0;
+    } else {
+      BytesPermittedForWrite = SgListParam[1]->TotalSize;
     }
-    for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
-      IoVec = &SgList->IoVec[IoVecIdx];
-      if (SgListVirtioMapOp[ListId] == VirtioOperationBusMasterRead) {
-        //
-        // We report that the Virtio Filesystem device has read all buffers in
-        // the request.
-        //
-        IoVec->Transferred = IoVec->Size;
-      } else {
-        //
-        // Regarding the response, calculate how much of the current IO Vector
-        // has been populated by the Virtio Filesystem device. In
-        // "TotalBytesWrittenByDevice", VirtioFlush() reported the total count
-        // across all device-writeable descriptors, in the order they were
-        // chained on the ring.
-        //
-        IoVec->Transferred = MIN ((UINTN)TotalBytesWrittenByDevice,
-                               IoVec->Size);
-        TotalBytesWrittenByDevice -= (UINT32)IoVec->Transferred;
+    if (TotalBytesWrittenByDevice > BytesPermittedForWrite) {
+      Status = EFI_DEVICE_ERROR;
+      goto Unmap;
+    }
+
+    //
+    // Update the transfer sizes in the IO Vectors.
+    //
+    for (ListId = 0; ListId < ARRAY_SIZE (SgListParam); ListId++) {
+      SgList = SgListParam[ListId];
+      if (SgList == NULL) {
+        continue;
+      }
+      for (IoVecIdx = 0; IoVecIdx < SgList->NumVec; IoVecIdx++) {
+        IoVec = &SgList->IoVec[IoVecIdx];
+        if (SgListVirtioMapOp[ListId] == VirtioOperationBusMasterRead) {
+          //
+          // We report that the Virtio Filesystem device has read all buffers
+          // in the request.
+          //
+          IoVec->Transferred = IoVec->Size;
+        } else {
+          //
+          // Regarding the response, calculate how much of the current IO
+          // Vector has been populated by the Virtio Filesystem device. The
+          // used element reported the total count across all device-writeable
+          // descriptors, in the order they were chained on the ring.
+          //
+          IoVec->Transferred = MIN ((UINTN)TotalBytesWrittenByDevice,
+                                 IoVec->Size);
+          TotalBytesWrittenByDevice -= (UINT32)IoVec->Transferred;
+        }
       }
     }
-  }
 
-  //
-  // By now, "TotalBytesWrittenByDevice" has been exhausted.
-  //
-  ASSERT (TotalBytesWrittenByDevice == 0);
+    //
+    // By now, "TotalBytesWrittenByDevice" has been exhausted.
+    //
+    ASSERT (TotalBytesWrittenByDevice == 0);
+  }
 
   //
   // We've succeeded; fall through.
   //
 Unmap:
   //
-  // Unmap all mapped IO Vectors on both the success and the error paths. The
-  // unmapping occurs in reverse order of mapping, in an attempt to avoid
-  // memory fragmentation.
+  // Unmap all mapped IO Vectors on both the success and the error paths.
   //
-  ListId = ARRAY_SIZE (SgListParam);
-  while (ListId > 0) {
-    --ListId;
-    SgList = SgListParam[ListId];
-    if (SgList == NULL) {
-      continue;
-    }
-    IoVecIdx = SgList->NumVec;
-    while (IoVecIdx > 0) {
-      EFI_STATUS UnmapStatus;
-
-      --IoVecIdx;
-      IoVec = &SgList->IoVec[IoVecIdx];
-      //
-      // Unmap this IO Vector, if it has been mapped.
-      //
-      if (!IoVec->Mapped) {
-        continue;
-      }
-      UnmapStatus = VirtioFs->Virtio->UnmapSharedBuffer (VirtioFs->Virtio,
-                                        IoVec->Mapping);
-      //
-      // Re-set the following fields to the values they initially got from
-      // VirtioFsSgListsValidate() -- the above unmapping attempt is considered
-      // final, even if it fails.
-      //
-      IoVec->Mapped        = FALSE;
-      IoVec->MappedAddress = 0;
-      IoVec->Mapping       = NULL;
-
-      //
-      // If we are on the success path, but the unmapping failed, we need to
-      // transparently flip to the failure path -- the caller must learn they
-      // should not consult the response buffers.
-      //
-      // The branch below can be taken at most once.
-      //
-      if (!EFI_ERROR (Status) && EFI_ERROR (UnmapStatus)) {
-        Status = UnmapStatus;
-      }
-    }
+  ExchangeIdx = NumExchanges;
+  while (ExchangeIdx > 0) {
+    --ExchangeIdx;
+    Status = VirtioFsSgListsUnmap (VirtioFs,
+               Exchanges[ExchangeIdx].RequestSgList,
+               Exchanges[ExchangeIdx].ResponseSgList, Status);
   }
 
   return Status;
@@ -1977,6 +2171,304 @@ FreeDestSuffix16:
   return Status;
 }
 
+/**
+  Cancel the expiry timer of the lookup cache, and clear its signaled state.
+
+  @param[in] VirtioFs  The Virtio Filesystem device whose lookup cache has
+                       become empty.
+**/
+STATIC
+VOID
+VirtioFsLookupCacheDisarm (
+  IN VIRTIO_FS *VirtioFs
+  )
+{
+  gBS->SetTimer (VirtioFs->LookupCacheTimer, TimerCancel, 0);
+  gBS->CheckEvent (VirtioFs->LookupCacheTimer);
+}
+
+/**
+  Offer a directory entry, returned by FUSE_READDIRPLUS, to the lookup cache.
+
+  FUSE_READDIRPLUS takes a lookup reference on each NodeId that it returns
+  (except for "." and ".."), just like FUSE_LOOKUP does. Rather than dropping
+  those references at once, this function keeps them around for serving later
+  VirtioFsFuseLookup() calls for the same directory entries locally.
+
+  The entry is not cached, and its NodeId is appended to ForgetList instead,
+  if the Virtio Filesystem device permits no caching for it, or if it would
+  outlive the other entries in the cache. When caching the entry pushes
+  another entry (with the same name, or the least recently inserted one) out
+  of the cache, the NodeId of that entry is appended to ForgetList.
+
+  The function may only be called after VirtioFsFuseInitSession() returns
+  successfully and before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs    The Virtio Filesystem device that returned
+                             Dirent.
+
+  @param[in] DirNodeId       The inode number of the directory that Dirent
+                             has been read from.
+
+  @param[in] Dirent          The directory entry. The caller is responsible for
+                             ensuring that Dirent->Namelen describe valid
+                             storage, and that Dirent->NodeResp.NodeId be
+                             nonzero.
+
+  @param[in,out] ForgetList  The NodeIds that the caller is supposed to drop
+                             with VirtioFsFuseBatchForget(). On output, at most
+                             one element will have been appended.
+
+  @param[in,out] NumForget   The number of elements in ForgetList. Incremented
+                             by the function if it appends an element.
+**/
+VOID
+VirtioFsLookupCacheInsert (
+  IN OUT VIRTIO_FS                          *VirtioFs,
+  IN     UINT64                             DirNodeId,
+  IN     VIRTIO_FS_FUSE_DIRENTPLUS_RESPONSE *Dirent,
+  IN OUT UINT64                             *ForgetList,
+  IN OUT UINTN                              *NumForget
+  )
+{
+  VIRTIO_FS_FUSE_NODE_RESPONSE *NodeResp;
+  UINT64                       TimeoutSec;
+  UINT32                       TimeoutNsec;
+  UINT64                       Timeout;
+  CHAR8                        *DirentName;
+  CHAR8                        *Name;
+  VIRTIO_FS_LOOKUP_CACHE_ENTRY *Entry;
+  UINTN                        Idx;
+  EFI_STATUS                   Status;
+
+  NodeResp = &Dirent->NodeResp;
+  ASSERT (NodeResp->NodeId != 0);
+
+  //
+  // Both the name-to-inode mapping and the attributes will be reported to
+  // VirtioFsFuseLookup() callers, so the entry is valid for the shorter of the
+  // two timeouts. Convert it to 100ns units.
+  //
+  if (NodeResp->EntryValid < NodeResp->AttrValid ||
+      (NodeResp->EntryValid == NodeResp->AttrValid &&
+       NodeResp->EntryValidNsec < NodeResp->AttrValidNsec)) {
+    TimeoutSec  = NodeResp->EntryValid;
+    TimeoutNsec = NodeResp->EntryValidNsec;
+  } else {
+    TimeoutSec  = NodeResp->AttrValid;
+    TimeoutNsec = NodeResp->AttrValidNsec;
+  }
+  if (TimeoutSec >= VIRTIO_FS_LOOKUP_CACHE_MAX_TIMEOUT) {
+    Timeout = MultU64x32 (VIRTIO_FS_LOOKUP_CACHE_MAX_TIMEOUT, 10000000);
+  } else {
+    Timeout = MultU64x32 (TimeoutSec, 10000000) + TimeoutNsec / 100;
+  }
+
+  //
+  // Start a new generation if the current one has expired.
+  //
+  if (VirtioFs->LookupCacheCount > 0 &&
+      !EFI_ERROR (gBS->CheckEvent (VirtioFs->LookupCacheTimer))) {
+    VirtioFsLookupCacheFlush (VirtioFs);
+  }
+
+  //
+  // All entries expire together, when the timer armed for the first entry of
+  // the generation fires. Therefore an entry with a shorter timeout than the
+  // first entry's cannot be cached.
+  //
+  if (Timeout == 0 ||
+      (VirtioFs->LookupCacheCount > 0 &&
+       Timeout < VirtioFs->LookupCacheTimeout)) {
+    goto Forget;
+  }
+
+  DirentName = (CHAR8 *)(Dirent + 1);
+  Name       = AllocateCopyPool (Dirent->Namelen, DirentName);
+  if (Name == NULL) {
+    goto Forget;
+  }
+
+  if (VirtioFs->LookupCacheCount == 0) {
+    Status = gBS->SetTimer (VirtioFs->LookupCacheTimer, TimerRelative,
+                    Timeout);
+    if (EFI_ERROR (Status)) {
+      FreePool (Name);
+      goto Forget;
+    }
+    VirtioFs->LookupCacheTimeout = Timeout;
+  }
+
+  //
+  // Look for an entry with the same name in the same directory, for a free
+  // entry, and fall back to evicting an entry.
+  //
+  Entry = NULL;
+  for (Idx = 0; Idx < VIRTIO_FS_LOOKUP_CACHE_SIZE; Idx++) {
+    VIRTIO_FS_LOOKUP_CACHE_ENTRY *Candidate;
+
+    Candidate = &VirtioFs->LookupCache[Idx];
+    if (Candidate->NodeId == 0) {
+      if (Entry == NULL) {
+        Entry = Candidate;
+      }
+      continue;
+    }
+    if (Candidate->DirNodeId == DirNodeId &&
+        Candidate->Namelen == Dirent->Namelen &&
+        CompareMem (Candidate->Name, DirentName, Dirent->Namelen) == 0) {
+      Entry = Candidate;
+      break;
+    }
+  }
+  if (Entry == NULL) {
+    Entry = &VirtioFs->LookupCache[VirtioFs->LookupCacheVictim];
+    VirtioFs->LookupCacheVictim = (VirtioFs->LookupCacheVictim + 1) %
+                                  VIRTIO_FS_LOOKUP_CACHE_SIZE;
+  }
+
+  if (Entry->NodeId == 0) {
+    VirtioFs->LookupCacheCount++;
+  } else {
+    //
+    // Drop the reference held by the entry being replaced.
+    //
+    ForgetList[(*NumForget)++] = Entry->NodeId;
+    FreePool (Entry->Name);
+  }
+
+  Entry->DirNodeId = DirNodeId;
+  Entry->NodeId    = NodeResp->NodeId;
+  Entry->Namelen   = Dirent->Namelen;
+  Entry->Name      = Name;
+  CopyMem (&Entry->FuseAttr, &Dirent->AttrResp, sizeof Entry->FuseAttr);
+  return;
+
+Forget:
+  ForgetList[(*NumForget)++] = NodeResp->NodeId;
+}
+
+/**
+  Resolve a filename to an inode from the lookup cache.
+
+  On success, the lookup reference held by the cache entry is transferred to
+  the caller, and the entry is removed from the cache. The caller is
+  responsible for dropping the reference with VirtioFsFuseForget(), exactly as
+  if it had been returned by FUSE_LOOKUP.
+
+  The function may only be called after VirtioFsFuseInitSession() returns
+  successfully and before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device whose lookup cache
+                           should be consulted.
+
+  @param[in] DirNodeId     The inode number of the directory in which Name
+                           should be resolved to an inode.
+
+  @param[in] Name          The single-component filename to resolve in the
+                           directory identified by DirNodeId.
+
+  @param[out] NodeId       The inode number which Name has been resolved to.
+
+  @param[out] FuseAttr     The VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE object
+                           describing the properties of the resolved inode.
+
+  @retval TRUE   Name has been resolved to an inode from the lookup cache.
+
+  @retval FALSE  The lookup cache has no valid entry for Name in DirNodeId.
+**/
+BOOLEAN
+VirtioFsLookupCacheTake (
+  IN OUT VIRTIO_FS                          *VirtioFs,
+  IN     UINT64                             DirNodeId,
+  IN     CHAR8                              *Name,
+     OUT UINT64                             *NodeId,
+     OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE *FuseAttr
+  )
+{
+  UINTN                        Namelen;
+  UINTN                        Idx;
+  VIRTIO_FS_LOOKUP_CACHE_ENTRY *Entry;
+
+  if (VirtioFs->LookupCacheCount == 0) {
+    return FALSE;
+  }
+  if (!EFI_ERROR (gBS->CheckEvent (VirtioFs->LookupCacheTimer))) {
+    VirtioFsLookupCacheFlush (VirtioFs);
+    return FALSE;
+  }
+
+  Namelen = AsciiStrLen (Name);
+  for (Idx = 0; Idx < VIRTIO_FS_LOOKUP_CACHE_SIZE; Idx++) {
+    Entry = &VirtioFs->LookupCache[Idx];
+    if (Entry->NodeId != 0 &&
+        Entry->DirNodeId == DirNodeId &&
+        Entry->Namelen == Namelen &&
+        CompareMem (Entry->Name, Name, Namelen) == 0) {
+      *NodeId = Entry->NodeId;
+      CopyMem (FuseAttr, &Entry->FuseAttr, sizeof *FuseAttr);
+
+      FreePool (Entry->Name);
+      Entry->NodeId = 0;
+      Entry->Name   = NULL;
+      VirtioFs->LookupCacheCount--;
+      if (VirtioFs->LookupCacheCount == 0) {
+        VirtioFsLookupCacheDisarm (VirtioFs);
+      }
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/**
+  Empty the lookup cache, dropping the lookup references held by its entries
+  with a single FUSE_BATCH_FORGET request.
+
+  The wrappers of those FUSE requests that modify the filesystem call this
+  function before sending their requests, so that no cached name-to-inode
+  mapping or attributes outlive a modification made by the driver.
+
+  The function may only be called after VirtioFsFuseInitSession() returns
+  successfully and before VirtioFsUninit() is called.
+
+  @param[in,out] VirtioFs  The Virtio Filesystem device whose lookup cache
+                           should be emptied.
+**/
+VOID
+VirtioFsLookupCacheFlush (
+  IN OUT VIRTIO_FS *VirtioFs
+  )
+{
+  UINT64                       NodeIds[VIRTIO_FS_LOOKUP_CACHE_SIZE];
+  UINTN                        NumNodeIds;
+  UINTN                        Idx;
+  VIRTIO_FS_LOOKUP_CACHE_ENTRY *Entry;
+
+  if (VirtioFs->LookupCacheCount == 0) {
+    return;
+  }
+
+  NumNodeIds = 0;
+  for (Idx = 0; Idx < VIRTIO_FS_LOOKUP_CACHE_SIZE; Idx++) {
+    Entry = &VirtioFs->LookupCache[Idx];
+    if (Entry->NodeId == 0) {
+      continue;
+    }
+    NodeIds[NumNodeIds++] = Entry->NodeId;
+    FreePool (Entry->Name);
+    Entry->NodeId = 0;
+    Entry->Name   = NULL;
+  }
+  ASSERT (NumNodeIds == VirtioFs->LookupCacheCount);
+
+  VirtioFs->LookupCacheCount  = 0;
+  VirtioFs->LookupCacheVictim = 0;
+  VirtioFsLookupCacheDisarm (VirtioFs);
+
+  VirtioFsFuseBatchForget (VirtioFs, NumNodeIds, NodeIds);
+}
+
 /**
   Convert select fields of a VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE object to
   corresponding fields in EFI_FILE_INFO.
@@ -78,6 +78,8 @@ RefillFileInfoCache (
   UINT64                         DirStreamCookie;
   UINT64                         CacheEndsAtCookie;
   UINTN                          NumFileInfo;
+  UINT64                         *ForgetList;
+  UINTN                          NumForget;
 
   //
   // Allocate a DirentBuf that can receive at least
@@ -121,6 +123,22 @@ RefillFileInfoCache (
     goto FreeDirentBuf;
   }
 
+  //
+  // Allocate the list of NodeIds that the Virtio Filesystem device should
+  // forget after each chunk of the directory stream. Every directory entry is
+  // larger than VIRTIO_FS_FUSE_DIRENTPLUS_RESPONSE, so this is enough room for
+  // a full DirentBuf.
+  //
+  ForgetList = AllocatePool (
+                 (DirentBufSize / sizeof (VIRTIO_FS_FUSE_DIRENTPLUS_RESPONSE)) *
+                 sizeof (UINT64)
+                 );
+  if (ForgetList == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto FreeFileInfoArray;
+  }
+  NumForget = 0;
+
   //
   // Pick up reading the directory stream where the previous cache ended.
   //
@@ -148,7 +166,7 @@ RefillFileInfoCache (
                DirentBuf                 // Data
                );
     if (EFI_ERROR (Status)) {
-      goto FreeFileInfoArray;
+      goto FreeForgetList;
     }
 
     if (Remaining == 0) {
@@ -159,9 +177,10 @@ RefillFileInfoCache (
     }
 
     //
-    // Iterate over all records in DirentBuf. Primarily, forget them all.
-    // Secondarily, if a record proves transformable to EFI_FILE_INFO, add it
-    // to the EFI_FILE_INFO cache (unless the cache is full).
+    // Iterate over all records in DirentBuf. Primarily, offer them all to the
+    // lookup cache (or forget them). Secondarily, if a record proves
+    // transformable to EFI_FILE_INFO, add it to the EFI_FILE_INFO cache
+    // (unless the cache is full).
     //
     Consumed = 0;
     while (Remaining >= sizeof (VIRTIO_FS_FUSE_DIRENTPLUS_RESPONSE)) {
@@ -180,7 +199,7 @@ RefillFileInfoCache (
         // supported by the filesystem -- proved acceptable above.
         //
         Status = EFI_PROTOCOL_ERROR;
-        goto FreeFileInfoArray;
+        goto ForgetNodeIds;
       }
       if (DirentSize > Remaining) {
         //
@@ -189,7 +208,7 @@ RefillFileInfoCache (
         // Filesystem device is supposed to send complete entries only.
         //
         Status = EFI_PROTOCOL_ERROR;
-        goto FreeFileInfoArray;
+        goto ForgetNodeIds;
       }
       if (Dirent->Namelen > FilesysAttr.Namelen) {
         //
@@ -199,7 +218,7 @@ RefillFileInfoCache (
         // the next alignment bucket. Should never happen.
         //
         Status = EFI_PROTOCOL_ERROR;
-        goto FreeFileInfoArray;
+        goto ForgetNodeIds;
       }
 
       //
@@ -231,13 +250,16 @@ RefillFileInfoCache (
       }
 
       //
-      // Make the Virtio Filesystem device forget the NodeId in this directory
-      // entry, as we'll need it no more. (The "." and ".." entries need no
-      // FUSE_FORGET requests, when returned by FUSE_READDIRPLUS -- and so the
-      // Virtio Filesystem device reports their NodeId fields as zero.)
+      // The NodeId in this directory entry carries a lookup reference. Stash
+      // it in the lookup cache, so that opening the file right after listing
+      // the directory need not send a FUSE_LOOKUP request; otherwise, have the
+      // Virtio Filesystem device forget the NodeId. (The "." and ".." entries
+      // need no FUSE_FORGET requests, when returned by FUSE_READDIRPLUS -- and
+      // so the Virtio Filesystem device reports their NodeId fields as zero.)
       //
       if (Dirent->NodeResp.NodeId != 0) {
-        VirtioFsFuseForget (VirtioFs, Dirent->NodeResp.NodeId);
+        VirtioFsLookupCacheInsert (VirtioFs, VirtioFsFile->NodeId, Dirent,
+          ForgetList, &NumForget);
       }
 
       //
@@ -255,8 +277,15 @@ RefillFileInfoCache (
       // supposed to send complete entries only.
       //
       Status = EFI_PROTOCOL_ERROR;
-      goto FreeFileInfoArray;
+      goto ForgetNodeIds;
     }
+
+    //
+    // Drop the references that the lookup cache didn't take, in one request.
+    //
+    VirtioFsFuseBatchForget (VirtioFs, NumForget, ForgetList);
+    NumForget = 0;
+
     //
     // Fetch another DirentBuf from the directory stream, unless we've filled
     // the EFI_FILE_INFO cache.
@@ -275,9 +304,16 @@ RefillFileInfoCache (
   VirtioFsFile->NextFileInfo       = 0;
   VirtioFsFile->FilePosition       = CacheEndsAtCookie;
 
+  FreePool (ForgetList);
   FreePool (DirentBuf);
   return EFI_SUCCESS;
 
+ForgetNodeIds:
+  VirtioFsFuseBatchForget (VirtioFs, NumForget, ForgetList);
+
+FreeForgetList:
+  FreePool (ForgetList);
+
 FreeFileInfoArray:
   FreePool (FileInfoArray);
 
@@ -364,7 +400,6 @@ ReadRegularFile (
   EFI_STATUS                         Status;
   VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE FuseAttr;
   UINTN                              Transferred;
-  UINTN                              Left;
 
   VirtioFs = VirtioFsFile->OwnerFs;
   //
@@ -375,31 +410,19 @@ ReadRegularFile (
     return EFI_DEVICE_ERROR;
   }
 
-  Status      = EFI_SUCCESS;
-  Transferred = 0;
-  Left        = *BufferSize;
-  while (Left > 0) {
-    UINT32 ReadSize;
-
-    //
-    // FUSE_READ cannot express a >=4GB buffer size.
-    //
-    ReadSize = (UINT32)MIN ((UINTN)MAX_UINT32, Left);
-    Status = VirtioFsFuseReadFileOrDir (
-               VirtioFs,
-               VirtioFsFile->NodeId,
-               VirtioFsFile->FuseHandle,
-               FALSE,                                    // IsDir
-               VirtioFsFile->FilePosition + Transferred,
-               &ReadSize,
-               (UINT8 *)Buffer + Transferred
-               );
-    if (EFI_ERROR (Status) || ReadSize == 0) {
-      break;
-    }
-    Transferred += ReadSize;
-    Left        -= ReadSize;
-  }
+  //
+  // Large reads are split into FUSE_READ requests that the device processes
+  // in parallel.
+  //
+  Transferred = *BufferSize;
+  Status = VirtioFsFuseReadFilePipelined (
+             VirtioFs,
+             VirtioFsFile->NodeId,
+             VirtioFsFile->FuseHandle,
+             VirtioFsFile->FilePosition,
+             &Transferred,
+             Buffer
+             );
 
   *BufferSize = Transferred;
   VirtioFsFile->FilePosition += Transferred;
@@ -20,7 +20,6 @@ VirtioFsSimpleFileWrite (
   VIRTIO_FS      *VirtioFs;
   EFI_STATUS     Status;
   UINTN          Transferred;
-  UINTN          Left;
 
   VirtioFsFile = VIRTIO_FS_FILE_FROM_SIMPLE_FILE (This);
   VirtioFs     = VirtioFsFile->OwnerFs;
@@ -32,36 +31,19 @@ VirtioFsSimpleFileWrite (
     return EFI_ACCESS_DENIED;
   }
 
-  Status      = EFI_SUCCESS;
-  Transferred = 0;
-  Left        = *BufferSize;
-  while (Left > 0) {
-    UINT32 WriteSize;
-
-    //
-    // Honor the write buffer size limit.
-    //
-    WriteSize = (UINT32)MIN ((UINTN)VirtioFs->MaxWrite, Left);
-    Status = VirtioFsFuseWrite (
-               VirtioFs,
-               VirtioFsFile->NodeId,
-               VirtioFsFile->FuseHandle,
-               VirtioFsFile->FilePosition + Transferred,
-               &WriteSize,
-               (UINT8 *)Buffer + Transferred
-               );
-    if (!EFI_ERROR (Status) && WriteSize == 0) {
-      //
-      // Progress should have been made.
-      //
-      Status = EFI_DEVICE_ERROR;
-    }
-    if (EFI_ERROR (Status)) {
-      break;
-    }
-    Transferred += WriteSize;
-    Left        -= WriteSize;
-  }
+  //
+  // Large writes are split into FUSE_WRITE requests (honoring the write buffer
+  // size limit) that the device processes in parallel.
+  //
+  Transferred = *BufferSize;
+  Status = VirtioFsFuseWritePipelined (
+             VirtioFs,
+             VirtioFsFile->NodeId,
+             VirtioFsFile->FuseHandle,
+             VirtioFsFile->FilePosition,
+             &Transferred,
+             Buffer
+             );
 
   *BufferSize = Transferred;
   VirtioFsFile->FilePosition += Transferred;
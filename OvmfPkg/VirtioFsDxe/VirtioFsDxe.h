@@ -52,6 +52,26 @@
 //
 #define VIRTIO_FS_FILE_MAX_FILE_INFO 256
 
+//
+// Maximum number of FUSE_READ or FUSE_WRITE requests that a single
+// EFI_FILE_PROTOCOL.Read() or EFI_FILE_PROTOCOL.Write() call keeps
+// outstanding on the request queue at once.
+//
+#define VIRTIO_FS_MAX_PIPELINE_DEPTH 8
+
+//
+// Maximum number of directory entries, learned from FUSE_READDIRPLUS, that are
+// kept for answering later FUSE_LOOKUP requests locally.
+//
+#define VIRTIO_FS_LOOKUP_CACHE_SIZE 64
+
+//
+// Upper limit for the validity period of a VIRTIO_FS_LOOKUP_CACHE_ENTRY, in
+// seconds, regardless of the entry and attribute timeouts that the Virtio
+// Filesystem device reports.
+//
+#define VIRTIO_FS_LOOKUP_CACHE_MAX_TIMEOUT 60
+
 //
 // Filesystem label encoded in UCS-2, transformed from the UTF-8 representation
 // in "VIRTIO_FS_CONFIG.Tag", and NUL-terminated. Only the printable ASCII code
@@ -59,6 +79,20 @@
 //
 typedef CHAR16 VIRTIO_FS_LABEL[VIRTIO_FS_TAG_BYTES + 1];
 
+//
+// A directory entry that FUSE_READDIRPLUS returned, together with the lookup
+// reference that the Virtio Filesystem device took for NodeId at the same
+// time. The reference is either handed out to the first VirtioFsFuseLookup()
+// call that asks for Name in DirNodeId, or dropped with FUSE_BATCH_FORGET.
+//
+typedef struct {
+  UINT64                             DirNodeId;
+  UINT64                             NodeId;    // zero if the entry is free
+  VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE FuseAttr;
+  UINT32                             Namelen;
+  CHAR8                              *Name;     // not NUL-terminated
+} VIRTIO_FS_LOOKUP_CACHE_ENTRY;
+
 //
 // Main context structure, expressing an EFI_SIMPLE_FILE_SYSTEM_PROTOCOL
 // interface on top of the Virtio Filesystem device.
@@ -82,6 +116,16 @@ typedef struct {
   EFI_EVENT                       ExitBoot;  // DriverBindingStart  0
   LIST_ENTRY                      OpenFiles; // DriverBindingStart  0
   EFI_SIMPLE_FILE_SYSTEM_PROTOCOL SimpleFs;  // DriverBindingStart  0
+  //
+  // The lookup cache. All entries expire together, when LookupCacheTimer,
+  // armed at the first insertion for LookupCacheTimeout, fires.
+  //
+  EFI_EVENT                       LookupCacheTimer;   // DriverBindingStart  0
+  UINT64                          LookupCacheTimeout; // DriverBindingStart  0
+  UINTN                           LookupCacheCount;   // DriverBindingStart  0
+  UINTN                           LookupCacheVictim;  // DriverBindingStart  0
+  VIRTIO_FS_LOOKUP_CACHE_ENTRY    LookupCache[VIRTIO_FS_LOOKUP_CACHE_SIZE];
+                                                      // DriverBindingStart  0
 } VIRTIO_FS;
 
 #define VIRTIO_FS_FROM_SIMPLE_FS(SimpleFsReference) \
@@ -133,6 +177,15 @@ typedef struct {
   UINT32 TotalSize;
 } VIRTIO_FS_SCATTER_GATHER_LIST;
 
+//
+// A pair of scatter-gather lists -- request buffers, response buffers -- that
+// describe one request-response exchange with the Virtio Filesystem device.
+//
+typedef struct {
+  VIRTIO_FS_SCATTER_GATHER_LIST *RequestSgList;
+  VIRTIO_FS_SCATTER_GATHER_LIST *ResponseSgList;
+} VIRTIO_FS_EXCHANGE;
+
 //
 // Private context structure that exposes EFI_FILE_PROTOCOL on top of an open
 // FUSE file reference.
@@ -218,6 +271,13 @@ VirtioFsSgListsSubmit (
   IN OUT VIRTIO_FS_SCATTER_GATHER_LIST *ResponseSgList OPTIONAL
   );
 
+EFI_STATUS
+VirtioFsSgListsSubmitMultiple (
+  IN OUT VIRTIO_FS          *VirtioFs,
+  IN     UINTN              NumExchanges,
+  IN OUT VIRTIO_FS_EXCHANGE *Exchanges
+  );
+
 EFI_STATUS
 VirtioFsFuseNewRequest (
   IN OUT VIRTIO_FS              *VirtioFs,
@@ -270,6 +330,29 @@ VirtioFsComposeRenameDestination (
      OUT BOOLEAN *RootEscape
   );
 
+VOID
+VirtioFsLookupCacheInsert (
+  IN OUT VIRTIO_FS                          *VirtioFs,
+  IN     UINT64                             DirNodeId,
+  IN     VIRTIO_FS_FUSE_DIRENTPLUS_RESPONSE *Dirent,
+  IN OUT UINT64                             *ForgetList,
+  IN OUT UINTN                              *NumForget
+  );
+
+BOOLEAN
+VirtioFsLookupCacheTake (
+  IN OUT VIRTIO_FS                          *VirtioFs,
+  IN     UINT64                             DirNodeId,
+  IN     CHAR8                              *Name,
+     OUT UINT64                             *NodeId,
+     OUT VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE *FuseAttr
+  );
+
+VOID
+VirtioFsLookupCacheFlush (
+  IN OUT VIRTIO_FS *VirtioFs
+  );
+
 EFI_STATUS
 VirtioFsFuseAttrToEfiFileInfo (
   IN     VIRTIO_FS_FUSE_ATTRIBUTES_RESPONSE *FuseAttr,
@@ -327,6 +410,13 @@ VirtioFsFuseForget (
   IN     UINT64    NodeId
   );
 
+EFI_STATUS
+VirtioFsFuseBatchForget (
+  IN OUT VIRTIO_FS *VirtioFs,
+  IN     UINTN     NumNodeIds,
+  IN     UINT64    *NodeIds
+  );
+
 EFI_STATUS
 VirtioFsFuseGetAttr (
   IN OUT VIRTIO_FS                          *VirtioFs,
@@ -380,12 +470,22 @@ VirtioFsFuseReadFileOrDir (
   );
 
 EFI_STATUS
-VirtioFsFuseWrite (
+VirtioFsFuseReadFilePipelined (
   IN OUT VIRTIO_FS *VirtioFs,
   IN     UINT64    NodeId,
   IN     UINT64    FuseHandle,
   IN     UINT64    Offset,
-  IN OUT UINT32    *Size,
+  IN OUT UINTN     *Size,
+     OUT VOID      *Data
+  );
+
+EFI_STATUS
+VirtioFsFuseWritePipelined (
+  IN OUT VIRTIO_FS *VirtioFs,
+  IN     UINT64    NodeId,
+  IN     UINT64    FuseHandle,
+  IN     UINT64    Offset,
+  IN OUT UINTN     *Size,
   IN     VOID      *Data
   );
 
@@ -135,14 +135,16 @@ ReleaseQueue:
   - tracking of heads of free descriptor chains from the above,
   - one common virtio-net request header (never modified by the host) for all
     pending TX packets,
+  - a pool of packet buffers, one per possibly pending TX packet, mapped once
+    for the lifetime of the EfiSimpleNetworkInitialized state,
   - select polling over TX interrupt.
 
   @param[in,out] Dev       The VNET_DEV driver instance about to enter the
                            EfiSimpleNetworkInitialized state.
 
   @retval EFI_OUT_OF_RESOURCES  Failed to allocate the stack to track the heads
-                                of free descriptor chains or failed to init
-                                TxBufCollection.
+                                of free descriptor chains, or the array
+                                tracking the caller buffers.
   @return                       Status codes from VIRTIO_DEVICE_PROTOCOL.
                                 AllocateSharedPages() or
                                 VirtioMapAllBytesInSharedBuffer()
@@ -161,6 +163,8 @@ VirtioNetInitTx (
   EFI_STATUS            Status;
   EFI_PHYSICAL_ADDRESS  DeviceAddress;
   VOID                  *TxSharedReqBuffer;
+  EFI_PHYSICAL_ADDRESS  TxBufPoolDeviceBase;
+  VOID                  *TxBufPoolBuffer;
 
   Dev->TxMaxPending = (UINT16) MIN (Dev->TxRing.QueueSize / 2,
                                  VNET_MAX_PENDING);
@@ -171,11 +175,9 @@ VirtioNetInitTx (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  Dev->TxBufCollection = OrderedCollectionInit (
-                           VirtioNetTxBufMapInfoCompare,
-                           VirtioNetTxBufDeviceAddressCompare
-                           );
-  if (Dev->TxBufCollection == NULL) {
+  Dev->TxCallerBuf = AllocateZeroPool (Dev->TxMaxPending *
+                       sizeof *Dev->TxCallerBuf);
+  if (Dev->TxCallerBuf == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
     goto FreeTxFreeStack;
   }
@@ -190,7 +192,7 @@ VirtioNetInitTx (
                           &TxSharedReqBuffer
                           );
   if (EFI_ERROR (Status)) {
-    goto UninitTxBufCollection;
+    goto FreeTxCallerBuf;
   }
 
   ZeroMem (TxSharedReqBuffer, sizeof *Dev->TxSharedReq);
@@ -209,6 +211,38 @@ VirtioNetInitTx (
 
   Dev->TxSharedReq = TxSharedReqBuffer;
 
+  //
+  // Allocate the TX packet pool: VirtioNetTransmit() copies each outgoing
+  // frame into the slot that belongs to its descriptor chain, rather than
+  // mapping (and later unmapping) the caller's buffer for every packet. With
+  // an IOMMU or with SEV, mapping involves bounce buffers and page table
+  // updates anyway, so the copy is cheaper than the map/unmap round trip.
+  //
+  Dev->TxBufSlotSize    = Dev->Snm.MediaHeaderSize + Dev->Snm.MaxPacketSize;
+  Dev->TxBufPoolNrPages = EFI_SIZE_TO_PAGES (Dev->TxMaxPending *
+                                             Dev->TxBufSlotSize);
+  Status = Dev->VirtIo->AllocateSharedPages (
+                          Dev->VirtIo,
+                          Dev->TxBufPoolNrPages,
+                          &TxBufPoolBuffer
+                          );
+  if (EFI_ERROR (Status)) {
+    goto UnmapTxSharedReq;
+  }
+
+  Status = VirtioMapAllBytesInSharedBuffer (
+             Dev->VirtIo,
+             VirtioOperationBusMasterCommonBuffer,
+             TxBufPoolBuffer,
+             EFI_PAGES_TO_SIZE (Dev->TxBufPoolNrPages),
+             &TxBufPoolDeviceBase,
+             &Dev->TxBufPoolMap
+             );
+  if (EFI_ERROR (Status)) {
+    goto FreeTxBufPool;
+  }
+
+  Dev->TxBufPool = TxBufPoolBuffer;
 
   //
   // In VirtIo 1.0, the NumBuffers field is mandatory. In 0.9.5, it depends on
@@ -234,9 +268,12 @@ VirtioNetInitTx (
     Dev->TxRing.Desc[DescIdx].Next  = (UINT16) (DescIdx + 1);
 
     //
-    // The second descriptor of each pending TX packet is updated on the fly,
-    // but it always terminates the descriptor chain of the packet.
+    // The second descriptor of each pending TX packet always points to the
+    // packet's own slot in the TX pool, and it terminates the descriptor
+    // chain of the packet. Only its length is updated on the fly.
     //
+    Dev->TxRing.Desc[DescIdx + 1].Addr  = TxBufPoolDeviceBase +
+                                          PktIdx * Dev->TxBufSlotSize;
     Dev->TxRing.Desc[DescIdx + 1].Flags = 0;
   }
 
@@ -265,6 +302,16 @@ VirtioNetInitTx (
 
   return EFI_SUCCESS;
 
+FreeTxBufPool:
+  Dev->VirtIo->FreeSharedPages (
+                 Dev->VirtIo,
+                 Dev->TxBufPoolNrPages,
+                 TxBufPoolBuffer
+                 );
+
+UnmapTxSharedReq:
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->TxSharedReqMap);
+
 FreeTxSharedReqBuffer:
   Dev->VirtIo->FreeSharedPages (
                  Dev->VirtIo,
@@ -272,8 +319,8 @@ FreeTxSharedReqBuffer:
                  TxSharedReqBuffer
                  );
 
-UninitTxBufCollection:
-  OrderedCollectionUninit (Dev->TxBufCollection);
+FreeTxCallerBuf:
+  FreePool (Dev->TxCallerBuf);
 
 FreeTxFreeStack:
   FreePool (Dev->TxFreeStack);
@@ -384,6 +431,7 @@ VirtioNetInitRx (
   MemoryFence ();
   Dev->RxLastUsed = *Dev->RxRing.Used.Idx;
   ASSERT (Dev->RxLastUsed == 0);
+  Dev->RxAvailPending = 0;
 
   //
   // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device:
@@ -556,6 +604,15 @@ VirtioNetInitialize (
   ASSERT (Dev->Snm.MediaPresentSupported ==
     !!(Features & VIRTIO_NET_F_STATUS));
 
+  //
+  // The offload features are deliberately not negotiated:
+  // - VIRTIO_NET_F_MRG_RXBUF only lets the device spread a frame over several
+  //   RX buffers, and each of ours holds a full frame already.
+  // - VIRTIO_NET_F_CSUM and VIRTIO_NET_F_GUEST_CSUM pass partial or validated
+  //   checksums along with the frames. SNP cannot carry those to or from the
+  //   network stack, so the checksums would have to be completed here anyway.
+  // - VIRTIO_NET_F_MQ adds queue pairs, while SNP is a single queue interface.
+  //
   Features &= VIRTIO_NET_F_MAC | VIRTIO_NET_F_STATUS | VIRTIO_F_VERSION_1 |
               VIRTIO_F_IOMMU_PLATFORM;
 
@@ -15,6 +15,45 @@
 
 #include "VirtioNet.h"
 
+/**
+  Expose the RX descriptor chains recycled by VirtioNetReceive() to the host,
+  and kick the RX queue unless the host asked us not to.
+
+  @param[in,out] Dev  The VNET_DEV driver instance in the
+                      EfiSimpleNetworkInitialized state.
+
+  @retval EFI_SUCCESS  There were no recycled chains to expose, or they have
+                       been exposed and the host has been notified if needed.
+  @return              Status codes from VIRTIO_DEVICE_PROTOCOL.SetQueueNotify().
+**/
+STATIC
+EFI_STATUS
+VirtioNetFlushRx (
+  IN OUT VNET_DEV *Dev
+  )
+{
+  if (Dev->RxAvailPending == 0) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.1.3 Updating the Index Field
+  //
+  MemoryFence ();
+  *Dev->RxRing.Avail.Idx = (UINT16) (*Dev->RxRing.Avail.Idx +
+                                     Dev->RxAvailPending);
+  Dev->RxAvailPending = 0;
+
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device
+  //
+  MemoryFence ();
+  if ((*Dev->RxRing.Used.Flags & VRING_USED_F_NO_NOTIFY) != 0) {
+    return EFI_SUCCESS;
+  }
+  return Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
+}
+
 /**
   Receives a packet from a network interface.
 
@@ -74,7 +113,6 @@ VirtioNetReceive (
   UINT32     RxLen;
   UINTN      OrigBufferSize;
   UINT8      *RxPtr;
-  UINT16     AvailIdx;
   EFI_STATUS NotifyStatus;
   UINTN      RxBufOffset;
 
@@ -103,7 +141,14 @@ VirtioNetReceive (
   MemoryFence ();
 
   if (Dev->RxLastUsed == RxCurUsed) {
+    //
+    // the host may be waiting for the buffers we have not exposed yet
+    //
     Status = EFI_NOT_READY;
+    NotifyStatus = VirtioNetFlushRx (Dev);
+    if (EFI_ERROR (NotifyStatus)) {
+      Status = NotifyStatus;
+    }
     goto Exit;
   }
 
@@ -166,17 +211,22 @@ RecycleDesc:
   //
   // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
   //
-  AvailIdx = *Dev->RxRing.Avail.Idx;
-  Dev->RxRing.Avail.Ring[AvailIdx++ % Dev->RxRing.QueueSize] =
-    (UINT16) DescIdx;
-
-  MemoryFence ();
-  *Dev->RxRing.Avail.Idx = AvailIdx;
-
-  MemoryFence ();
-  NotifyStatus = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
-  if (!EFI_ERROR (Status)) { // earlier error takes precedence
-    Status = NotifyStatus;
+  // Collect the recycled chain behind the published available index, and
+  // expose the batch to the host only once it is large enough, or when we
+  // have caught up with the host. This saves most of the VM exits that a
+  // notification per received packet would cost.
+  //
+  Dev->RxRing.Avail.Ring[(UINT16) (*Dev->RxRing.Avail.Idx +
+                                   Dev->RxAvailPending) %
+                         Dev->RxRing.QueueSize] = (UINT16) DescIdx;
+  ++Dev->RxAvailPending;
+
+  if (Dev->RxAvailPending >= VNET_RX_REFILL_BATCH ||
+      Dev->RxLastUsed == RxCurUsed) {
+    NotifyStatus = VirtioNetFlushRx (Dev);
+    if (!EFI_ERROR (Status)) { // earlier error takes precedence
+      Status = NotifyStatus;
+    }
   }
 
 Exit:
@@ -72,7 +72,6 @@ VirtioNetTransmit (
   EFI_STATUS            Status;
   UINT16                DescIdx;
   UINT16                AvailIdx;
-  EFI_PHYSICAL_ADDRESS  DeviceAddress;
 
   if (This == NULL || BufferSize == 0 || Buffer == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -138,26 +137,17 @@ VirtioNetTransmit (
     ASSERT ((UINTN) (Ptr - (UINT8 *) Buffer) == Dev->Snm.MediaHeaderSize);
   }
 
-  //
-  // Map the transmit buffer system physical address to device address.
-  //
-  Status = VirtioNetMapTxBuf (
-             Dev,
-             Buffer,
-             BufferSize,
-             &DeviceAddress
-             );
-  if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto Exit;
-  }
-
   //
   // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
   //
+  // Copy the frame into the pre-mapped TX pool slot that belongs to the
+  // descriptor chain, and remember the caller's buffer for GetStatus().
+  //
   DescIdx = Dev->TxFreeStack[Dev->TxCurPending++];
-  Dev->TxRing.Desc[DescIdx + 1].Addr  = DeviceAddress;
-  Dev->TxRing.Desc[DescIdx + 1].Len   = (UINT32) BufferSize;
+  CopyMem (Dev->TxBufPool + (DescIdx / 2) * Dev->TxBufSlotSize, Buffer,
+    BufferSize);
+  Dev->TxCallerBuf[DescIdx / 2]      = Buffer;
+  Dev->TxRing.Desc[DescIdx + 1].Len  = (UINT32) BufferSize;
 
   //
   // the available index is never written by the host, we can read it back
@@ -169,8 +159,16 @@ VirtioNetTransmit (
   MemoryFence ();
   *Dev->TxRing.Avail.Idx = AvailIdx;
 
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device: if the host is still busy
+  // processing the TX queue, it has asked us not to kick it.
+  //
   MemoryFence ();
-  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_TX);
+  if ((*Dev->TxRing.Used.Flags & VRING_USED_F_NO_NOTIFY) != 0) {
+    Status = EFI_SUCCESS;
+  } else {
+    Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_TX);
+  }
 
 Exit:
   gBS->RestoreTPL (OldTpl);
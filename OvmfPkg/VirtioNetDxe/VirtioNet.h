@@ -20,7 +20,6 @@
 #include <Protocol/DevicePath.h>
 #include <Protocol/DriverBinding.h>
 #include <Protocol/SimpleNetwork.h>
-#include <Library/OrderedCollectionLib.h>
 
 #define VNET_SIG SIGNATURE_32 ('V', 'N', 'E', 'T')
 
@@ -29,6 +28,12 @@
 //
 #define VNET_MAX_PENDING 64
 
+//
+// number of recycled RX descriptor chains that VirtioNetReceive() collects
+// before it exposes them to the host and kicks the RX queue
+//
+#define VNET_RX_REFILL_BATCH 16
+
 //
 // State diagram:
 //
@@ -82,6 +87,7 @@ typedef struct {
                                                  // VirtioNetInitRing
   UINT8                       *RxBuf;            // VirtioNetInitRx
   UINT16                      RxLastUsed;        // VirtioNetInitRx
+  UINT16                      RxAvailPending;    // VirtioNetInitRx
   UINTN                       RxBufNrPages;      // VirtioNetInitRx
   EFI_PHYSICAL_ADDRESS        RxBufDeviceBase;   // VirtioNetInitRx
   VOID                        *RxBufMap;         // VirtioNetInitRx
@@ -95,7 +101,11 @@ typedef struct {
   VIRTIO_1_0_NET_REQ          *TxSharedReq;      // VirtioNetInitTx
   VOID                        *TxSharedReqMap;   // VirtioNetInitTx
   UINT16                      TxLastUsed;        // VirtioNetInitTx
-  ORDERED_COLLECTION          *TxBufCollection;  // VirtioNetInitTx
+  UINT8                       *TxBufPool;        // VirtioNetInitTx
+  UINTN                       TxBufPoolNrPages;  // VirtioNetInitTx
+  UINTN                       TxBufSlotSize;     // VirtioNetInitTx
+  VOID                        *TxBufPoolMap;     // VirtioNetInitTx
+  VOID                        **TxCallerBuf;     // VirtioNetInitTx
 } VNET_DEV;
 
 
@@ -276,42 +286,6 @@ VirtioNetUninitRing (
   IN     VOID     *RingMap
   );
 
-//
-// utility functions to map caller-supplied Tx buffer system physical address
-// to a device address and vice versa
-//
-EFI_STATUS
-EFIAPI
-VirtioNetMapTxBuf (
-  IN  VNET_DEV              *Dev,
-  IN  VOID                  *Buffer,
-  IN  UINTN                 NumberOfBytes,
-  OUT EFI_PHYSICAL_ADDRESS  *DeviceAddress
-  );
-
-EFI_STATUS
-EFIAPI
-VirtioNetUnmapTxBuf (
-  IN  VNET_DEV              *Dev,
-  OUT VOID                  **Buffer,
-  IN  EFI_PHYSICAL_ADDRESS  DeviceAddress
-  );
-
-INTN
-EFIAPI
-VirtioNetTxBufMapInfoCompare (
-  IN CONST VOID *UserStruct1,
-  IN CONST VOID *UserStruct2
-  );
-
-INTN
-EFIAPI
-VirtioNetTxBufDeviceAddressCompare (
-  IN CONST VOID *StandaloneKey,
-  IN CONST VOID *UserStruct
-  );
-
-
 //
 // event callbacks
 //